@@ -6,49 +6,184 @@
  */
 
 #include "AdvancedAudioProcessor.h"
+#include "PolyphaseResampler.h"
 #include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <cstdlib>
+#include <new>
 
 static constexpr float M_PI_F = 3.14159265358979323846f;
 
 namespace VeniceDAW {
 
+// Resampler quality is chosen by casting a ProcessingQuality
+static_assert(static_cast<int>(DSP::PolyphaseResampler::QUALITY_REALTIME) == kRealtime &&
+              static_cast<int>(DSP::PolyphaseResampler::QUALITY_BALANCED) == kBalanced &&
+              static_cast<int>(DSP::PolyphaseResampler::QUALITY_HIGHEST) == kHighest,
+              "PolyphaseResampler::Quality must follow ProcessingQuality");
+
 // AdvancedAudioBuffer implementation
+const size_t AdvancedAudioBuffer::kAlignment;
+const size_t AdvancedAudioBuffer::kStrideAlignment;
+
 AdvancedAudioBuffer::AdvancedAudioBuffer(ChannelConfiguration config, size_t frames, float sr)
-    : frameCount(frames), sampleRate(sr), channelConfig(config) {
-    size_t channelCount = static_cast<size_t>(config);
-    channels.resize(channelCount);
-    for (auto& channel : channels) {
-        channel.resize(frames, 0.0f);
+    : frameCount(frames), sampleRate(sr), channelConfig(config),
+      fData(nullptr), fStride(0), fChannelCount(static_cast<size_t>(config)),
+      fStorage(kHeapStorage) {
+    Allocate(StrideFor(frames));
+}
+
+AdvancedAudioBuffer::AdvancedAudioBuffer(ChannelConfiguration config, size_t frames, float sr,
+                                         AudioBufferPool& pool)
+    : frameCount(frames), sampleRate(sr), channelConfig(config),
+      fData(nullptr), fStride(StrideFor(frames)), fChannelCount(static_cast<size_t>(config)),
+      fStorage(kPoolStorage),
+      fPoolBuffer(pool.GetBuffer(fStride, static_cast<uint32>(fChannelCount))) {
+    // Pool blocks are cache-line aligned and cleared
+    if (fPoolBuffer.IsValid()) {
+        fData = fPoolBuffer.Data();
+    } else {
+        fStorage = kHeapStorage;
+        Allocate(fStride);
+    }
+}
+
+AdvancedAudioBuffer::AdvancedAudioBuffer(const AdvancedAudioBuffer& parent, size_t offset,
+                                         size_t frames)
+    : frameCount(frames), sampleRate(parent.sampleRate), channelConfig(parent.channelConfig),
+      fData(parent.fData + offset), fStride(parent.fStride), fChannelCount(parent.fChannelCount),
+      fStorage(kViewStorage) {
+}
+
+AdvancedAudioBuffer::AdvancedAudioBuffer(const AdvancedAudioBuffer& other)
+    : frameCount(other.frameCount), sampleRate(other.sampleRate),
+      channelConfig(other.channelConfig), fData(nullptr), fStride(0),
+      fChannelCount(other.fChannelCount), fStorage(kHeapStorage) {
+    Allocate(StrideFor(frameCount));
+    for (size_t channel = 0; channel < fChannelCount; ++channel) {
+        std::memcpy(GetChannelData(channel), other.GetChannelData(channel),
+                    frameCount * sizeof(float));
+    }
+}
+
+AdvancedAudioBuffer::AdvancedAudioBuffer(AdvancedAudioBuffer&& other) noexcept
+    : frameCount(other.frameCount), sampleRate(other.sampleRate),
+      channelConfig(other.channelConfig), fData(other.fData), fStride(other.fStride),
+      fChannelCount(other.fChannelCount), fStorage(other.fStorage),
+      fPoolBuffer(std::move(other.fPoolBuffer)) {
+    other.frameCount = 0;
+    other.fData = nullptr;
+    other.fStorage = kViewStorage;
+}
+
+AdvancedAudioBuffer::~AdvancedAudioBuffer() {
+    Release();
+}
+
+AdvancedAudioBuffer& AdvancedAudioBuffer::operator=(const AdvancedAudioBuffer& other) {
+    if (this != &other) {
+        AdvancedAudioBuffer copy(other);
+        *this = std::move(copy);
     }
+    return *this;
+}
+
+AdvancedAudioBuffer& AdvancedAudioBuffer::operator=(AdvancedAudioBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        frameCount = other.frameCount;
+        sampleRate = other.sampleRate;
+        channelConfig = other.channelConfig;
+        fData = other.fData;
+        fStride = other.fStride;
+        fChannelCount = other.fChannelCount;
+        fStorage = other.fStorage;
+        fPoolBuffer = std::move(other.fPoolBuffer);
+        other.frameCount = 0;
+        other.fData = nullptr;
+        other.fStorage = kViewStorage;
+    }
+    return *this;
+}
+
+AdvancedAudioBuffer AdvancedAudioBuffer::View(size_t offset, size_t frames) {
+    offset = std::min(offset, frameCount);
+    return AdvancedAudioBuffer(*this, offset, std::min(frames, frameCount - offset));
+}
+
+size_t AdvancedAudioBuffer::StrideFor(size_t frames) {
+    return std::max(kStrideAlignment, (frames + kStrideAlignment - 1) & ~(kStrideAlignment - 1));
+}
+
+void AdvancedAudioBuffer::Allocate(size_t stride) {
+    void* block = nullptr;
+    if (posix_memalign(&block, kAlignment, stride * fChannelCount * sizeof(float)) != 0) {
+        throw std::bad_alloc();
+    }
+    fData = static_cast<float*>(block);
+    fStride = stride;
+    std::memset(fData, 0, stride * fChannelCount * sizeof(float));
+}
+
+void AdvancedAudioBuffer::Release() {
+    if (fStorage == kHeapStorage) {
+        free(fData);
+    }
+    // A pool buffer goes back when fPoolBuffer is reset or destroyed
+    fPoolBuffer = AudioBuffer();
+    fData = nullptr;
 }
 
 void AdvancedAudioBuffer::Clear() {
-    for (auto& channel : channels) {
-        std::fill(channel.begin(), channel.end(), 0.0f);
+    for (size_t channel = 0; channel < fChannelCount; ++channel) {
+        std::memset(GetChannelData(channel), 0, frameCount * sizeof(float));
     }
 }
 
 void AdvancedAudioBuffer::Resize(size_t frames) {
-    frameCount = frames;
-    for (auto& channel : channels) {
-        channel.resize(frames, 0.0f);
+    if (fStorage == kViewStorage) {
+        frameCount = std::min(frames, frameCount);
+        return;
     }
+
+    if (frames > fStride) {
+        float* oldData = fData;
+        size_t oldStride = fStride;
+        Storage oldStorage = fStorage;
+        AudioBuffer oldPoolBuffer(std::move(fPoolBuffer));
+
+        fStorage = kHeapStorage;
+        Allocate(StrideFor(frames));
+        for (size_t channel = 0; channel < fChannelCount; ++channel) {
+            std::memcpy(fData + channel * fStride, oldData + channel * oldStride,
+                        frameCount * sizeof(float));
+        }
+        if (oldStorage == kHeapStorage) {
+            free(oldData);
+        }
+    } else if (frames > frameCount) {
+        // Frames dropped by an earlier shrink may still hold samples
+        for (size_t channel = 0; channel < fChannelCount; ++channel) {
+            std::memset(GetChannelData(channel) + frameCount, 0,
+                        (frames - frameCount) * sizeof(float));
+        }
+    }
+    frameCount = frames;
 }
 
 float* AdvancedAudioBuffer::GetChannelData(size_t channel) {
-    if (channel >= channels.size()) return nullptr;
-    return channels[channel].data();
+    if (channel >= fChannelCount) return nullptr;
+    return fData + channel * fStride;
 }
 
 const float* AdvancedAudioBuffer::GetChannelData(size_t channel) const {
-    if (channel >= channels.size()) return nullptr;
-    return channels[channel].data();
+    if (channel >= fChannelCount) return nullptr;
+    return fData + channel * fStride;
 }
 
 size_t AdvancedAudioBuffer::GetChannelCount() const {
-    return channels.size();
+    return fChannelCount;
 }
 
 // AudioEffect base class implementation
@@ -70,7 +205,8 @@ ProfessionalEQ::ProfessionalEQ() : AudioEffect("ProfessionalEQ") {
 void ProfessionalEQ::Initialize(float sampleRate) {
     fSampleRate = sampleRate;
     fInitialized = true;
-    fNeedsUpdate.store(true);
+    UpdateFilters();
+    fSnapToTarget.store(true);
 }
 
 void ProfessionalEQ::Process(AdvancedAudioBuffer& buffer) {
@@ -78,31 +214,32 @@ void ProfessionalEQ::Process(AdvancedAudioBuffer& buffer) {
         return;
     }
     
-    InitializeChannels(buffer.GetChannelCount());
+    const size_t channelCount = buffer.GetChannelCount();
+    InitializeChannels(channelCount);
+    AcquireCascade();
     
-    if (fNeedsUpdate.load()) {
-        UpdateFilters();
-        fNeedsUpdate.store(false);
-    }
-    
-    for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
+    // DC blocking, then all channels through the enabled bands at once
+    for (size_t channel = 0; channel < channelCount; ++channel) {
         float* channelData = buffer.GetChannelData(channel);
+        fDCBlockers[channel].ProcessBlock(channelData, channelData, buffer.frameCount);
+        fChannelPointers[channel] = channelData;
+    }
+    
+    // While a coefficient ramp is running, step it every kSmoothingStepFrames;
+    // the rest of the block runs with fixed coefficients in one pass.
+    size_t offset = 0;
+    while (offset < buffer.frameCount) {
+        size_t frames = buffer.frameCount - offset;
+        if (fRampStepsRemaining > 0) {
+            AdvanceRamp();
+            frames = std::min(frames, kSmoothingStepFrames);
+        }
         
-        for (size_t frame = 0; frame < buffer.frameCount; ++frame) {
-            float sample = channelData[frame];
-            
-            // DC blocking
-            sample = fDCBlockers[channel].ProcessSample(sample);
-            
-            // Process through all enabled EQ bands
-            for (size_t band = 0; band < MAX_BANDS; ++band) {
-                if (fBands[band].enabled) {
-                    sample = fFilters[channel][band].ProcessSample(sample);
-                }
-            }
-            
-            channelData[frame] = sample;
+        for (size_t channel = 0; channel < channelCount; ++channel) {
+            fStepPointers[channel] = fChannelPointers[channel] + offset;
         }
+        fFilterBank.Process(fStepPointers.data(), frames);
+        offset += frames;
     }
 }
 
@@ -111,13 +248,15 @@ void ProfessionalEQ::ProcessRealtime(AdvancedAudioBuffer& buffer) {
 }
 
 float ProfessionalEQ::ProcessSample(float input, size_t channel) {
-    if (fBypassed.load() || !fInitialized || channel >= fFilters.size()) {
+    if (fBypassed.load() || !fInitialized || channel >= fFilterBank.GetLaneCount()) {
         return input;
     }
     
-    if (fNeedsUpdate.load()) {
-        UpdateFilters();
-        fNeedsUpdate.store(false);
+    // The per-sample path applies parameter changes without smoothing
+    AcquireCascade();
+    if (fRampStepsRemaining > 0) {
+        fRampStepsRemaining = 1;
+        AdvanceRamp();
     }
     
     float sample = input;
@@ -126,13 +265,7 @@ float ProfessionalEQ::ProcessSample(float input, size_t channel) {
     sample = fDCBlockers[channel].ProcessSample(sample);
     
     // Process through all enabled EQ bands
-    for (size_t band = 0; band < MAX_BANDS; ++band) {
-        if (fBands[band].enabled) {
-            sample = fFilters[channel][band].ProcessSample(sample);
-        }
-    }
-    
-    return sample;
+    return fFilterBank.ProcessSample(channel, sample);
 }
 
 void ProfessionalEQ::SetParameter(const std::string& param, float value) {
@@ -197,15 +330,15 @@ std::vector<std::string> ProfessionalEQ::GetParameterList() const {
 }
 
 void ProfessionalEQ::Reset() {
-    for (auto& channelFilters : fFilters) {
-        for (auto& filter : channelFilters) {
-            filter.Reset();
-        }
-    }
+    fFilterBank.Reset();
     
     for (auto& dcBlocker : fDCBlockers) {
         dcBlocker.Reset();
     }
+    
+    // Filters restart from silence, so the next block can jump straight
+    // to the current settings
+    fSnapToTarget.store(true);
 }
 
 void ProfessionalEQ::SetBand(size_t band, float freq, float gain, float Q) {
@@ -214,42 +347,48 @@ void ProfessionalEQ::SetBand(size_t band, float freq, float gain, float Q) {
         fBands[band].gain = std::max(-24.0f, std::min(24.0f, gain));
         fBands[band].Q = std::max(0.1f, std::min(20.0f, Q));
         fBands[band].enabled = true;
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
 void ProfessionalEQ::SetBandFrequency(size_t band, float freq) {
     if (band < MAX_BANDS) {
         fBands[band].frequency = std::max(20.0f, std::min(20000.0f, freq));
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
 void ProfessionalEQ::SetBandGain(size_t band, float gain) {
     if (band < MAX_BANDS) {
         fBands[band].gain = std::max(-24.0f, std::min(24.0f, gain));
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
 void ProfessionalEQ::SetBandQ(size_t band, float Q) {
     if (band < MAX_BANDS) {
         fBands[band].Q = std::max(0.1f, std::min(20.0f, Q));
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
 void ProfessionalEQ::SetBandType(size_t band, FilterType type) {
     if (band < MAX_BANDS) {
         fBands[band].type = type;
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
 void ProfessionalEQ::SetBandEnabled(size_t band, bool enabled) {
     if (band < MAX_BANDS) {
         fBands[band].enabled = enabled;
-        fNeedsUpdate.store(true);
+        UpdateBandFilter(band);
+        PublishCascade();
     }
 }
 
@@ -269,7 +408,7 @@ void ProfessionalEQ::EnableBand(size_t band, bool enabled) {
 }
 
 float ProfessionalEQ::GetFrequencyResponse(float frequency) const {
-    if (!fInitialized || fFilters.empty()) {
+    if (!fInitialized || fFilterBank.GetLaneCount() == 0) {
         return 1.0f;
     }
     
@@ -277,7 +416,7 @@ float ProfessionalEQ::GetFrequencyResponse(float frequency) const {
     
     for (size_t band = 0; band < MAX_BANDS; ++band) {
         if (fBands[band].enabled) {
-            magnitude *= fFilters[0][band].GetMagnitudeResponse(frequency, fSampleRate);
+            magnitude *= fBandDesigns[band].GetMagnitudeResponse(frequency, fSampleRate);
         }
     }
     
@@ -285,15 +424,18 @@ float ProfessionalEQ::GetFrequencyResponse(float frequency) const {
 }
 
 void ProfessionalEQ::InitializeChannels(size_t channelCount) {
-    if (fFilters.size() != channelCount) {
-        fFilters.resize(channelCount);
+    if (fFilterBank.GetLaneCount() != channelCount) {
+        fFilterBank.Resize(channelCount, MAX_BANDS);
+        fChannelPointers.resize(channelCount);
+        fStepPointers.resize(channelCount);
         fDCBlockers.resize(channelCount);
         
         for (size_t channel = 0; channel < channelCount; ++channel) {
             fDCBlockers[channel].SetCutoff(20.0f, fSampleRate);
         }
         
-        fNeedsUpdate.store(true);
+        // The resized bank starts with identity stages
+        fSnapToTarget.store(true);
     }
 }
 
@@ -301,6 +443,7 @@ void ProfessionalEQ::UpdateFilters() {
     for (size_t band = 0; band < MAX_BANDS; ++band) {
         UpdateBandFilter(band);
     }
+    PublishCascade();
 }
 
 void ProfessionalEQ::UpdateBandFilter(size_t band) {
@@ -309,23 +452,107 @@ void ProfessionalEQ::UpdateBandFilter(size_t band) {
     const EQBand& bandData = fBands[band];
     DSP::BiquadFilter::FilterType dspType = ConvertFilterType(bandData.type);
     
-    for (auto& channelFilters : fFilters) {
-        channelFilters[band].CalculateCoefficients(
-            dspType, 
-            fSampleRate, 
-            bandData.frequency, 
-            bandData.Q, 
-            bandData.gain
-        );
+    fBandDesigns[band].CalculateCoefficients(
+        dspType, 
+        fSampleRate, 
+        bandData.frequency, 
+        bandData.Q, 
+        bandData.gain
+    );
+}
+
+// Control thread: compile every band into the free slot and hand it over
+void ProfessionalEQ::PublishCascade() {
+    CompiledCascade& cascade = fCascades[fControlSlot];
+    
+    for (size_t band = 0; band < MAX_BANDS; ++band) {
+        BandCoefficients& c = cascade.coefficients[band];
+        float a0;
+        fBandDesigns[band].GetCoefficients(a0, c.a1, c.a2, c.b0, c.b1, c.b2);
+        cascade.enabled[band] = fBands[band].enabled;
+    }
+    
+    fControlSlot = fPendingSlot.exchange(fControlSlot | kCascadeDirty,
+                                         std::memory_order_acq_rel) & kCascadeSlotMask;
+}
+
+// Audio thread: pick up the newest compiled cascade, if any, and start
+// ramping towards it
+void ProfessionalEQ::AcquireCascade() {
+    bool updated = false;
+    if (fPendingSlot.load(std::memory_order_acquire) & kCascadeDirty) {
+        fAudioSlot = fPendingSlot.exchange(fAudioSlot, std::memory_order_acq_rel) & kCascadeSlotMask;
+        updated = true;
+    }
+    
+    const CompiledCascade& target = fCascades[fAudioSlot];
+    
+    if (fSnapToTarget.exchange(false)) {
+        fCurrent = target.coefficients;
+        fRampStepsRemaining = 0;
+        ApplyCurrentCoefficients(true);
+        return;
+    }
+    
+    if (!updated) {
+        return;
+    }
+    
+    // Newly enabled bands fade in from a clean identity stage
+    for (size_t band = 0; band < MAX_BANDS; ++band) {
+        if (target.enabled[band] && !fFilterBank.IsStageEnabled(band)) {
+            fCurrent[band] = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+            fFilterBank.ResetStage(band);
+            fFilterBank.SetStageEnabled(band, true);
+        }
+    }
+    fRampStepsRemaining = kSmoothingSteps;
+}
+
+// Moves every running band one step towards its target; bands being
+// disabled ramp to identity and drop out of the cascade at the end.
+void ProfessionalEQ::AdvanceRamp() {
+    const CompiledCascade& target = fCascades[fAudioSlot];
+    const BandCoefficients identity = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    const float t = 1.0f / static_cast<float>(fRampStepsRemaining);
+    
+    for (size_t band = 0; band < MAX_BANDS; ++band) {
+        if (!fFilterBank.IsStageEnabled(band)) continue;
+        
+        const BandCoefficients& goal = target.enabled[band] ? target.coefficients[band] : identity;
+        BandCoefficients& c = fCurrent[band];
+        c.b0 += (goal.b0 - c.b0) * t;
+        c.b1 += (goal.b1 - c.b1) * t;
+        c.b2 += (goal.b2 - c.b2) * t;
+        c.a1 += (goal.a1 - c.a1) * t;
+        c.a2 += (goal.a2 - c.a2) * t;
+    }
+    
+    --fRampStepsRemaining;
+    ApplyCurrentCoefficients(fRampStepsRemaining == 0);
+}
+
+void ProfessionalEQ::ApplyCurrentCoefficients(bool rampFinished) {
+    const CompiledCascade& target = fCascades[fAudioSlot];
+    
+    for (size_t band = 0; band < MAX_BANDS; ++band) {
+        if (!fFilterBank.IsStageEnabled(band) && !target.enabled[band]) continue;
+        
+        const BandCoefficients& c = fCurrent[band];
+        fFilterBank.SetStageCoefficients(band, c.b0, c.b1, c.b2, c.a1, c.a2);
+        if (rampFinished) {
+            fFilterBank.SetStageEnabled(band, target.enabled[band]);
+        }
     }
 }
 
 float ProfessionalEQ::ProcessBandFilter(size_t band, size_t channel, float input) {
-    if (band >= MAX_BANDS || channel >= fFilters.size()) {
+    if (band >= MAX_BANDS || channel >= fFilterBank.GetLaneCount()) {
         return input;
     }
     
-    return fFilters[channel][band].ProcessSample(input);
+    // Single-band tap for diagnostics; bypasses the bank's cascade state
+    return fBandDesigns[band].ProcessSample(input);
 }
 
 DSP::BiquadFilter::FilterType ProfessionalEQ::ConvertFilterType(FilterType type) const {
@@ -378,45 +605,49 @@ void DynamicsProcessor::Process(AdvancedAudioBuffer& buffer) {
     fOutputLevel = 0.0f;
     float maxGainReduction = 0.0f;
     
+    const bool useLookahead = fLookaheadEnabled && fMode == Mode::LIMITER && !fLookaheadBuffers.empty();
+    
     for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
         float* channelData = buffer.GetChannelData(channel);
         
-        for (size_t frame = 0; frame < buffer.frameCount; ++frame) {
-            float input = channelData[frame];
-            float output;
+        // Lookahead limiting runs block-wise per channel
+        if (useLookahead) {
+            ProcessLookaheadBlock(channel, channelData, buffer.frameCount);
+            continue;
+        }
+        
+        // Gain computer runs a chunk at a time: envelope, dB conversion,
+        // static curve and dB-to-gain each over the whole chunk
+        float envelope[kGainChunkFrames];
+        float gain[kGainChunkFrames];
+        
+        for (size_t offset = 0; offset < buffer.frameCount; offset += kGainChunkFrames) {
+            const size_t frames = std::min(kGainChunkFrames, buffer.frameCount - offset);
+            float* data = channelData + offset;
             
-            // Track input level
-            float inputLevel = std::abs(input);
-            fInputLevel = std::max(fInputLevel, inputLevel);
+            ProcessEnvelopeBlock(channel, data, envelope, frames);
+            DSP::FastApprox::LinearTodB(envelope, gain, frames);
+            CalculateGainReductionBlock(envelope, gain, frames);
             
-            // Use lookahead processing for limiters when enabled
-            if (fLookaheadEnabled && fMode == Mode::LIMITER && !fLookaheadBuffers.empty()) {
-                output = ProcessLookaheadSample(channel, input);
-            } else {
-                // Standard processing path
-                // Process envelope
-                float envelope = ProcessEnvelope(channel, input);
-                
-                // Calculate gain reduction
-                float gainReduction = CalculateGainReduction(envelope);
-                maxGainReduction = std::max(maxGainReduction, gainReduction);
-                
-                // Apply gain reduction (gainReduction is positive for reduction)
-                float gain = std::pow(10.0f, -gainReduction / 20.0f); // Convert dB to linear
-                output = input * gain;
-                
-                // Apply makeup gain
-                if (fMakeupGain != 0.0f || fAutoMakeup) {
-                    float makeupLinear = std::pow(10.0f, fMakeupGain / 20.0f);
-                    output *= makeupLinear;
-                }
+            // Gain reduction is positive for reduction; fold in makeup gain
+            // so one dB-to-linear pass covers both
+            for (size_t i = 0; i < frames; ++i) {
+                maxGainReduction = std::max(maxGainReduction, gain[i]);
+                gain[i] = fMakeupGain - gain[i];
             }
+            DSP::FastApprox::dBToLinear(gain, gain, frames);
             
-            // Track output level
-            float outputLevel = std::abs(output);
-            fOutputLevel = std::max(fOutputLevel, outputLevel);
-            
-            channelData[frame] = output;
+            float inputLevel = fInputLevel;
+            float outputLevel = fOutputLevel;
+            for (size_t i = 0; i < frames; ++i) {
+                const float input = data[i];
+                const float output = input * gain[i];
+                inputLevel = std::max(inputLevel, std::abs(input));
+                outputLevel = std::max(outputLevel, std::abs(output));
+                data[i] = output;
+            }
+            fInputLevel = inputLevel;
+            fOutputLevel = outputLevel;
         }
     }
     
@@ -488,7 +719,9 @@ void DynamicsProcessor::Reset() {
         }
         std::fill(fBufferWritePos.begin(), fBufferWritePos.end(), 0);
         std::fill(fBufferReadPos.begin(), fBufferReadPos.end(), 0);
-        std::fill(fPeakBuffer.begin(), fPeakBuffer.end(), 0.0f);
+        for (auto& detector : fPeakDetectors) {
+            detector.Reset();
+        }
     }
 }
 
@@ -533,33 +766,46 @@ void DynamicsProcessor::UpdateEnvelopeFollowers() {
     }
 }
 
-float DynamicsProcessor::ProcessEnvelope(size_t channel, float input) {
+void DynamicsProcessor::ProcessEnvelopeBlock(size_t channel, const float* input,
+                                             float* envelope, size_t frameCount) {
     if (channel >= fEnvelopeFollowers.size()) {
-        return std::abs(input);
+        for (size_t i = 0; i < frameCount; ++i) {
+            envelope[i] = std::abs(input[i]);
+        }
+        return;
     }
     
-    return fEnvelopeFollowers[channel].ProcessSample(input);
+    fEnvelopeFollowers[channel].ProcessBlock(input, envelope, frameCount);
 }
 
-float DynamicsProcessor::CalculateGainReduction(float envelope) {
-    if (envelope <= 0.0f) {
-        return 0.0f;
-    }
-    
-    // Convert envelope to dB
-    float envelopedB = 20.0f * std::log10(envelope);
-    
+// levels holds the envelope in dB on entry and the gain reduction in dB
+// on return; a silent envelope gets no reduction
+void DynamicsProcessor::CalculateGainReductionBlock(const float* envelope, float* levels,
+                                                    size_t frameCount) {
     switch (fMode) {
         case Mode::COMPRESSOR:
-            return CalculateCompressorGain(envelopedB);
+            for (size_t i = 0; i < frameCount; ++i) {
+                levels[i] = envelope[i] > 0.0f ? CalculateCompressorGain(levels[i]) : 0.0f;
+            }
+            break;
         case Mode::LIMITER:
-            return CalculateLimiterGain(envelopedB);
+            for (size_t i = 0; i < frameCount; ++i) {
+                levels[i] = envelope[i] > 0.0f ? CalculateLimiterGain(levels[i]) : 0.0f;
+            }
+            break;
         case Mode::GATE:
-            return CalculateGateGain(envelopedB);
+            for (size_t i = 0; i < frameCount; ++i) {
+                levels[i] = envelope[i] > 0.0f ? CalculateGateGain(levels[i]) : 0.0f;
+            }
+            break;
         case Mode::EXPANDER:
-            return CalculateExpanderGain(envelopedB);
+            for (size_t i = 0; i < frameCount; ++i) {
+                levels[i] = envelope[i] > 0.0f ? CalculateExpanderGain(levels[i]) : 0.0f;
+            }
+            break;
         default:
-            return 0.0f;
+            std::fill(levels, levels + frameCount, 0.0f);
+            break;
     }
 }
 
@@ -659,20 +905,24 @@ void DynamicsProcessor::InitializeLookaheadBuffers(size_t channelCount) {
     fLookaheadBuffers.clear();
     fBufferWritePos.clear();
     fBufferReadPos.clear();
-    fPeakBuffer.clear();
+    fPeakDetectors.clear();
     
     fLookaheadBuffers.resize(channelCount);
     fBufferWritePos.resize(channelCount, 0);
     fBufferReadPos.resize(channelCount, 0);
-    fPeakBuffer.resize(fLookaheadSamples, 0.0f);
+    fPeakDetectors.resize(channelCount, DSP::SlidingPeakDetector(fLookaheadSamples));
     
     for (size_t i = 0; i < channelCount; ++i) {
         fLookaheadBuffers[i].resize(fLookaheadSamples, 0.0f);
     }
+    
+    // Scratch for the block path, which splits larger blocks to fit
+    fLookaheadPeaks.resize(kLookaheadChunkFrames);
 }
 
 void DynamicsProcessor::UpdateLookaheadParameters() {
-    fLookaheadSamples = static_cast<size_t>(fLookaheadTime * fSampleRate / 1000.0f);
+    // At least one sample so the circular buffers never wrap modulo zero
+    fLookaheadSamples = std::max<size_t>(1, static_cast<size_t>(fLookaheadTime * fSampleRate / 1000.0f));
     
     if (fLookaheadEnabled && !fLookaheadBuffers.empty()) {
         // Reinitialize buffers with new size
@@ -689,41 +939,73 @@ float DynamicsProcessor::ProcessLookaheadSample(size_t channel, float input) {
     // Write input sample to circular buffer
     WriteLookaheadSample(channel, input);
     
-    // Analyze peak in lookahead window
-    float lookaheadPeak = AnalyzeLookaheadPeak(channel);
+    // Running peak of the lookahead window, O(1) amortised per sample
+    float lookaheadPeak = fPeakDetectors[channel].ProcessSample(input);
     
-    // Read delayed sample from buffer
+    // Read delayed sample from buffer and apply the window's gain
     float delayedSample = ReadLookaheadSample(channel);
+    return delayedSample * CalculateLookaheadGain(lookaheadPeak);
+}
+
+void DynamicsProcessor::ProcessLookaheadBlock(size_t channel, float* data, size_t frameCount) {
+    if (channel >= fLookaheadBuffers.size()) return;
     
-    // Calculate gain reduction based on lookahead peak
-    float peakdB = 20.0f * std::log10(std::max(lookaheadPeak, 1e-6f));
-    float gainReduction = 0.0f;
-    
-    if (fMode == Mode::LIMITER && peakdB > fThreshold) {
-        // Apply immediate limiting for zero-latency response
-        gainReduction = fThreshold - peakdB;
-        gainReduction = std::max(gainReduction, -60.0f); // Limit maximum reduction
+    // Blocks larger than the scratch go through in chunks; the detector
+    // and delay line carry over, so the result is the same
+    while (frameCount > kLookaheadChunkFrames) {
+        ProcessLookaheadBlock(channel, data, kLookaheadChunkFrames);
+        data += kLookaheadChunkFrames;
+        frameCount -= kLookaheadChunkFrames;
     }
     
-    // Apply gain reduction to delayed sample
-    float gainLinear = std::pow(10.0f, gainReduction / 20.0f);
-    return delayedSample * gainLinear;
-}
-
-float DynamicsProcessor::AnalyzeLookaheadPeak(size_t channel) {
-    if (channel >= fLookaheadBuffers.size()) return 0.0f;
+    // Window peak -> dB -> limiting gain, each over the whole block
+    float* gains = fLookaheadPeaks.data();
+    fPeakDetectors[channel].ProcessBlock(data, gains, frameCount);
+    DSP::FastApprox::LinearTodB(gains, gains, frameCount);
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        const float peakdB = gains[frame];
+        gains[frame] = peakdB > fThreshold ? std::max(fThreshold - peakdB, -60.0f) : 0.0f;
+    }
+    DSP::FastApprox::dBToLinear(gains, gains, frameCount);
     
-    float peak = 0.0f;
+    std::vector<float>& delayBuffer = fLookaheadBuffers[channel];
+    size_t writePos = fBufferWritePos[channel];
     size_t readPos = fBufferReadPos[channel];
     
-    // Analyze peak in the lookahead window
-    for (size_t i = 0; i < fLookaheadSamples; ++i) {
-        size_t pos = (readPos + i) % fLookaheadSamples;
-        float sample = std::abs(fLookaheadBuffers[channel][pos]);
-        peak = std::max(peak, sample);
+    float inputLevel = fInputLevel;
+    float outputLevel = fOutputLevel;
+    
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        const float input = data[frame];
+        inputLevel = std::max(inputLevel, std::abs(input));
+        
+        delayBuffer[writePos] = input;
+        if (++writePos == fLookaheadSamples) writePos = 0;
+        
+        const float delayedSample = delayBuffer[readPos];
+        if (++readPos == fLookaheadSamples) readPos = 0;
+        
+        const float output = delayedSample * gains[frame];
+        outputLevel = std::max(outputLevel, std::abs(output));
+        data[frame] = output;
+    }
+    
+    fBufferWritePos[channel] = writePos;
+    fBufferReadPos[channel] = readPos;
+    fInputLevel = inputLevel;
+    fOutputLevel = outputLevel;
+}
+
+float DynamicsProcessor::CalculateLookaheadGain(float peak) const {
+    // Immediate limiting for zero-latency response: bring the window peak
+    // down to the threshold, by at most 60 dB
+    float peakdB = 20.0f * std::log10(std::max(peak, 1e-6f));
+    if (fMode != Mode::LIMITER || peakdB <= fThreshold) {
+        return 1.0f;
     }
     
-    return peak;
+    float gainReduction = std::max(fThreshold - peakdB, -60.0f);
+    return std::pow(10.0f, gainReduction / 20.0f);
 }
 
 void DynamicsProcessor::WriteLookaheadSample(size_t channel, float sample) {
@@ -742,6 +1024,123 @@ float DynamicsProcessor::ReadLookaheadSample(size_t channel) {
     return sample;
 }
 
+// PitchTimeShifter implementation
+PitchTimeShifter::PitchTimeShifter() : AudioEffect("PitchTimeShifter") {
+    Configure(2, DSP::PhaseVocoder::kDefaultFrameSize);
+}
+
+void PitchTimeShifter::Initialize(float sampleRate) {
+    fSampleRate = sampleRate;
+    fInitialized = true;
+    Configure(fVocoder.GetChannelCount(),
+              sampleRate > 48000.0f ? 2 * DSP::PhaseVocoder::kDefaultFrameSize
+                                    : DSP::PhaseVocoder::kDefaultFrameSize);
+}
+
+void PitchTimeShifter::Configure(size_t channels, size_t frameSize) {
+    float tempo = fTempo.load();
+    fVocoder.Configure(channels, frameSize);
+    fVocoder.SetTempo(tempo);
+    fBlockInput.assign(fVocoder.GetHopSize() * fVocoder.GetChannelCount(), 0.0f);
+    fBlockOutput.assign(fBlockInput.size(), 0.0f);
+    fLatencySamples = fVocoder.GetLatencyFrames();
+}
+
+void PitchTimeShifter::SetChannelCount(size_t channels) {
+    if (channels != fVocoder.GetChannelCount()) {
+        Configure(channels, fVocoder.GetFrameSize());
+    }
+}
+
+void PitchTimeShifter::Process(AdvancedAudioBuffer& buffer) {
+    if (fBypassed.load() || !fInitialized || buffer.GetChannelCount() == 0) {
+        return;
+    }
+    
+    SetChannelCount(buffer.GetChannelCount());
+    
+    // Input and output run in step, a hop at a time
+    fVocoder.SetTempo(1.0f);
+    const size_t channels = fVocoder.GetChannelCount();
+    const size_t hop = fVocoder.GetHopSize();
+    for (size_t offset = 0; offset < buffer.frameCount; offset += hop) {
+        const size_t frames = std::min(hop, buffer.frameCount - offset);
+        for (size_t channel = 0; channel < channels; ++channel) {
+            const float* data = buffer.GetChannelData(channel) + offset;
+            for (size_t i = 0; i < frames; ++i) {
+                fBlockInput[i * channels + channel] = data[i];
+            }
+        }
+        
+        size_t inputFrames = frames;
+        fVocoder.Process(fBlockInput.data(), inputFrames, fBlockOutput.data(), frames);
+        
+        for (size_t channel = 0; channel < channels; ++channel) {
+            float* data = buffer.GetChannelData(channel) + offset;
+            for (size_t i = 0; i < frames; ++i) {
+                data[i] = fBlockOutput[i * channels + channel];
+            }
+        }
+    }
+}
+
+void PitchTimeShifter::ProcessRealtime(AdvancedAudioBuffer& buffer) {
+    Process(buffer);
+}
+
+size_t PitchTimeShifter::ProcessStream(const float* input, size_t& inputFrames, float* output,
+                                       size_t outputFrames) {
+    if (fBypassed.load() || !fInitialized) {
+        // Straight through, at tempo 1
+        size_t frames = std::min(inputFrames, outputFrames);
+        std::memcpy(output, input, frames * fVocoder.GetChannelCount() * sizeof(float));
+        inputFrames = frames;
+        return frames;
+    }
+    
+    fVocoder.SetTempo(fTempo.load());
+    return fVocoder.Process(input, inputFrames, output, outputFrames);
+}
+
+size_t PitchTimeShifter::GetInputFramesNeeded(size_t outputFrames) const {
+    if (fBypassed.load() || !fInitialized) {
+        return outputFrames;
+    }
+    return fVocoder.GetInputFramesNeeded(outputFrames);
+}
+
+void PitchTimeShifter::SetPitch(float semitones) {
+    fVocoder.SetPitch(semitones);
+    fLatencySamples = fVocoder.GetLatencyFrames();
+}
+
+void PitchTimeShifter::SetTempo(float tempo) {
+    fTempo.store(std::max(DSP::PhaseVocoder::kMinTempo,
+                          std::min(DSP::PhaseVocoder::kMaxTempo, tempo)));
+}
+
+void PitchTimeShifter::SetParameter(const std::string& param, float value) {
+    if (param == "pitch") {
+        SetPitch(value);
+    } else if (param == "tempo") {
+        SetTempo(value);
+    }
+}
+
+float PitchTimeShifter::GetParameter(const std::string& param) const {
+    if (param == "pitch") return GetPitch();
+    else if (param == "tempo") return GetTempo();
+    return 0.0f;
+}
+
+std::vector<std::string> PitchTimeShifter::GetParameterList() const {
+    return {"pitch", "tempo"};
+}
+
+void PitchTimeShifter::Reset() {
+    fVocoder.Reset();
+}
+
 // Professional SurroundProcessor implementation with 3D spatial audio
 SurroundProcessor::SurroundProcessor(ChannelConfiguration config) : fChannelConfig(config) {
     InitializeChannelMixing();
@@ -788,24 +1187,30 @@ void SurroundProcessor::ProcessStereoToSurround(const AdvancedAudioBuffer& stere
     } else {
         // Advanced 3D upmixing
         size_t frames = std::min(stereo.frameCount, surround.frameCount);
+        const float* inLeft = stereo.GetChannelData(0);
+        const float* inRight = stereo.GetChannelData(1);
+        float* out[6];
+        for (size_t channel = 0; channel < 6; ++channel) {
+            out[channel] = surround.GetChannelData(channel);
+        }
         
         for (size_t frame = 0; frame < frames; ++frame) {
-            float left = stereo.channels[0][frame];
-            float right = stereo.channels[1][frame];
+            float left = inLeft[frame];
+            float right = inRight[frame];
             float center = (left + right) * 0.5f;
             float surround_signal = (left - right) * 0.3f;
             
-            if (surround.channels.size() >= 6) { // 5.1 surround
+            if (surround.GetChannelCount() >= 6) { // 5.1 surround
                 // Apply spatial positioning
                 float distance_atten = CalculateDistanceAttenuation();
                 float doppler_factor = CalculateDopplerFactor();
                 
-                surround.channels[0][frame] = left * distance_atten * doppler_factor;     // Front left
-                surround.channels[1][frame] = right * distance_atten * doppler_factor;   // Front right
-                surround.channels[2][frame] = center * distance_atten * doppler_factor;  // Center
-                surround.channels[3][frame] = center * 0.1f * distance_atten;           // LFE (low freq only)
-                surround.channels[4][frame] = surround_signal * distance_atten;         // Rear left
-                surround.channels[5][frame] = -surround_signal * distance_atten;        // Rear right
+                out[0][frame] = left * distance_atten * doppler_factor;     // Front left
+                out[1][frame] = right * distance_atten * doppler_factor;   // Front right
+                out[2][frame] = center * distance_atten * doppler_factor;  // Center
+                out[3][frame] = center * 0.1f * distance_atten;           // LFE (low freq only)
+                out[4][frame] = surround_signal * distance_atten;         // Rear left
+                out[5][frame] = -surround_signal * distance_atten;        // Rear right
             }
         }
         
@@ -816,25 +1221,31 @@ void SurroundProcessor::ProcessStereoToSurround(const AdvancedAudioBuffer& stere
 
 void SurroundProcessor::ProcessSurroundToStereo(const AdvancedAudioBuffer& surround, AdvancedAudioBuffer& stereo) {
     size_t frames = std::min(surround.frameCount, stereo.frameCount);
+    const float* in[6];
+    for (size_t channel = 0; channel < 6; ++channel) {
+        in[channel] = surround.GetChannelData(channel);
+    }
+    float* outLeft = stereo.GetChannelData(0);
+    float* outRight = stereo.GetChannelData(1);
     
     for (size_t frame = 0; frame < frames; ++frame) {
         float left = 0.0f, right = 0.0f;
         
-        if (surround.channels.size() >= 6) { // 5.1 downmix with proper coefficients
+        if (surround.GetChannelCount() >= 6) { // 5.1 downmix with proper coefficients
             // ITU-R BS.775 downmix coefficients
-            left = surround.channels[0][frame] +                           // Front left
-                   surround.channels[2][frame] * 0.707f +                  // Center (−3 dB)
-                   surround.channels[3][frame] * 0.707f +                  // LFE (−3 dB)
-                   surround.channels[4][frame] * 0.707f;                   // Rear left (−3 dB)
+            left = in[0][frame] +                           // Front left
+                   in[2][frame] * 0.707f +                  // Center (−3 dB)
+                   in[3][frame] * 0.707f +                  // LFE (−3 dB)
+                   in[4][frame] * 0.707f;                   // Rear left (−3 dB)
                    
-            right = surround.channels[1][frame] +                          // Front right
-                    surround.channels[2][frame] * 0.707f +                 // Center (−3 dB)
-                    surround.channels[3][frame] * 0.707f +                 // LFE (−3 dB)
-                    surround.channels[5][frame] * 0.707f;                  // Rear right (−3 dB)
+            right = in[1][frame] +                          // Front right
+                    in[2][frame] * 0.707f +                 // Center (−3 dB)
+                    in[3][frame] * 0.707f +                 // LFE (−3 dB)
+                    in[5][frame] * 0.707f;                  // Rear right (−3 dB)
         }
         
-        stereo.channels[0][frame] = left;
-        stereo.channels[1][frame] = right;
+        outLeft[frame] = left;
+        outRight[frame] = right;
     }
     
     // Apply crossfeed if enabled
@@ -914,10 +1325,9 @@ void SurroundProcessor::SetDopplerEffect(bool enabled, float speedOfSound) {
 // HRTF processing
 void SurroundProcessor::SetHRTFDatabase(const float* leftHRTF, const float* rightHRTF, 
                                        size_t impulseLength, float azimuth, float elevation) {
-    // Store current latency before HRTF
-    size_t previousLatency = fLatencySamples;
-    
-    if (!fLeftHRTF) {
+    // Partition spectra are sized for the longest IR, so only rebuild the
+    // engines when the new response does not fit
+    if (!fLeftHRTF || fLeftHRTF->GetMaxImpulseLength() < impulseLength) {
         fLeftHRTF.reset(new DSP::ConvolutionEngine(impulseLength));
         fRightHRTF.reset(new DSP::ConvolutionEngine(impulseLength));
     }
@@ -926,9 +1336,8 @@ void SurroundProcessor::SetHRTFDatabase(const float* leftHRTF, const float* righ
     fRightHRTF->SetImpulseResponse(rightHRTF, impulseLength);
     fHRTFEnabled = true;
     
-    // HRTF adds convolution latency on top of base latency
-    size_t hrtfLatency = impulseLength / 2; // Typical HRTF latency
-    fLatencySamples = previousLatency + hrtfLatency;
+    // HRTF adds the partitioned convolver's block latency on top of base latency
+    fLatencySamples = fBaseLatencySamples + fLeftHRTF->GetLatencySamples();
     
     // Update processing load estimates with HRTF enabled
     UpdateSpatialParameters();
@@ -1058,7 +1467,11 @@ void SurroundProcessor::InitializeSpatialProcessing() {
 void SurroundProcessor::InitializeHRTFProcessing() {
     // HRTF engines are created when HRTF database is loaded
     if (fSampleRate > 0) {
-        fLatencySamples = static_cast<size_t>(fSampleRate * 0.005f); // 5ms default latency
+        fBaseLatencySamples = static_cast<size_t>(fSampleRate * 0.005f); // 5ms default latency
+        fLatencySamples = fBaseLatencySamples;
+        if (fLeftHRTF) {
+            fLatencySamples += fLeftHRTF->GetLatencySamples();
+        }
     }
 }
 
@@ -1193,20 +1606,26 @@ void SurroundProcessor::UpdateHRTFParameters(float azimuth, float elevation) {
 
 void SurroundProcessor::ProcessIntelligentUpmix(const AdvancedAudioBuffer& stereo, AdvancedAudioBuffer& surround) {
     size_t frames = std::min(stereo.frameCount, surround.frameCount);
+    const float* inLeft = stereo.GetChannelData(0);
+    const float* inRight = stereo.GetChannelData(1);
+    float* out[6];
+    for (size_t channel = 0; channel < 6; ++channel) {
+        out[channel] = surround.GetChannelData(channel);
+    }
     
     for (size_t frame = 0; frame < frames; ++frame) {
-        float left = stereo.channels[0][frame];
-        float right = stereo.channels[1][frame];
+        float left = inLeft[frame];
+        float right = inRight[frame];
         float center = (left + right) * 0.5f;
         float side = (left - right) * 0.5f;
         
-        if (surround.channels.size() >= 6) { // 5.1 intelligent upmix
-            surround.channels[0][frame] = left;                    // Front left
-            surround.channels[1][frame] = right;                   // Front right
-            surround.channels[2][frame] = center * 0.7f;           // Center (attenuated)
-            surround.channels[3][frame] = center * 0.1f;           // LFE (bass only)
-            surround.channels[4][frame] = side * 0.5f;             // Rear left
-            surround.channels[5][frame] = -side * 0.5f;            // Rear right
+        if (surround.GetChannelCount() >= 6) { // 5.1 intelligent upmix
+            out[0][frame] = left;                    // Front left
+            out[1][frame] = right;                   // Front right
+            out[2][frame] = center * 0.7f;           // Center (attenuated)
+            out[3][frame] = center * 0.1f;           // LFE (bass only)
+            out[4][frame] = side * 0.5f;             // Rear left
+            out[5][frame] = -side * 0.5f;            // Rear right
         }
     }
 }
@@ -1222,16 +1641,17 @@ void SurroundProcessor::ProcessBassManagement(AdvancedAudioBuffer& buffer) {
         for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
             if (channel == 3) continue; // Skip LFE channel itself
             
-            float sample = buffer.channels[channel][frame];
+            float* data = buffer.GetChannelData(channel);
+            float sample = data[frame];
             // Simple high-pass filtering (remove bass from main channels)
             // In practice, this would use proper filter implementation
             bassSum += sample * 0.1f; // Collect 10% for LFE
-            buffer.channels[channel][frame] *= 0.9f; // Attenuate bass in main channel
+            data[frame] *= 0.9f; // Attenuate bass in main channel
         }
         
         // Add collected bass to LFE
         if (buffer.GetChannelCount() > 3) {
-            buffer.channels[3][frame] += bassSum;
+            buffer.GetChannelData(3)[frame] += bassSum;
         }
     }
 }
@@ -1239,16 +1659,18 @@ void SurroundProcessor::ProcessBassManagement(AdvancedAudioBuffer& buffer) {
 void SurroundProcessor::ProcessCrossfeed(AdvancedAudioBuffer& stereo) {
     if (!fCrossfeedEnabled || stereo.GetChannelCount() < 2 || fCrossfeedFilters.size() != 2) return;
     
+    float* leftData = stereo.GetChannelData(0);
+    float* rightData = stereo.GetChannelData(1);
     for (size_t frame = 0; frame < stereo.frameCount; ++frame) {
-        float left = stereo.channels[0][frame];
-        float right = stereo.channels[1][frame];
+        float left = leftData[frame];
+        float right = rightData[frame];
         
         // Apply crossfeed
         float crossfeedL = fCrossfeedFilters[0].ProcessSample(right) * fCrossfeedAmount;
         float crossfeedR = fCrossfeedFilters[1].ProcessSample(left) * fCrossfeedAmount;
         
-        stereo.channels[0][frame] = left + crossfeedL;
-        stereo.channels[1][frame] = right + crossfeedR;
+        leftData[frame] = left + crossfeedL;
+        rightData[frame] = right + crossfeedR;
     }
 }
 
@@ -1264,6 +1686,10 @@ void AdvancedAudioProcessor::Initialize(float sampleRate, size_t bufferSize, Cha
     fSurroundProcessor.SetChannelConfiguration(config);
     fSurroundProcessor.Initialize(sampleRate);
     
+    // Pool-backed buffers of the callback size then never allocate
+    AudioBufferPool::GetGlobalPool().Reserve(AdvancedAudioBuffer::StrideFor(bufferSize),
+                                             static_cast<uint32>(config), kReservedCallbackBuffers);
+    
     ValidateConfiguration();
     fInitialized = true;
 }
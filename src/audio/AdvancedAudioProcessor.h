@@ -21,6 +21,10 @@
 #include <array>
 #include <string>
 #include "DSPAlgorithms.h"
+#include "BiquadBank.h"
+#include "FastApprox.h"
+#include "PhaseVocoder.h"
+#include "AudioBufferPool.h"
 
 namespace VeniceDAW {
 
@@ -49,18 +53,68 @@ enum ProcessingQuality {
 };
 
 // Advanced audio buffer for multi-channel processing
+//
+// Planar: all channels live in one 64-byte-aligned block, channel c
+// starting GetChannelStride() * c floats in. The stride is frameCount
+// rounded up to whole cache lines, so every channel starts on a cache line
+// and a 16-channel bed is a single slab. Storage comes from the heap, or
+// from an AudioBufferPool, which makes a buffer per callback
+// allocation-free once the pool holds buffers of that size. Views share
+// another buffer's storage instead of owning one.
 struct AdvancedAudioBuffer {
-    std::vector<std::vector<float>> channels;  // Multi-channel audio data
     size_t frameCount;
     float sampleRate;
     ChannelConfiguration channelConfig;
-    
+
+    static const size_t kAlignment = 64;
+    static const size_t kStrideAlignment = kAlignment / sizeof(float);
+
     AdvancedAudioBuffer(ChannelConfiguration config, size_t frames, float sr);
+    // Storage from the pool; from the heap when the pool cannot serve it
+    AdvancedAudioBuffer(ChannelConfiguration config, size_t frames, float sr,
+                        AudioBufferPool& pool);
+    AdvancedAudioBuffer(const AdvancedAudioBuffer& other);  // Owning copy
+    AdvancedAudioBuffer(AdvancedAudioBuffer&& other) noexcept;
+    ~AdvancedAudioBuffer();
+
+    AdvancedAudioBuffer& operator=(const AdvancedAudioBuffer& other);
+    AdvancedAudioBuffer& operator=(AdvancedAudioBuffer&& other) noexcept;
+
+    // Frames offset..offset + frames of every channel, sharing this
+    // buffer's storage (clamped to frameCount). The view must not outlive
+    // the buffer or a Resize() of it; its channels are 64-byte aligned
+    // when offset is a multiple of kStrideAlignment.
+    AdvancedAudioBuffer View(size_t offset, size_t frames);
+
     void Clear();
+    // Keeps the samples both sizes share and clears new frames; only
+    // reallocates when frames exceeds the stride. A view can only shrink.
     void Resize(size_t frames);
     float* GetChannelData(size_t channel);
     const float* GetChannelData(size_t channel) const;
     size_t GetChannelCount() const;
+    size_t GetChannelStride() const { return fStride; }
+    static size_t StrideFor(size_t frames);  // Stride of a buffer of frames
+    bool IsView() const { return fStorage == kViewStorage; }
+    bool IsPoolBacked() const { return fStorage == kPoolStorage; }
+
+private:
+    enum Storage {
+        kHeapStorage,
+        kPoolStorage,
+        kViewStorage
+    };
+
+    AdvancedAudioBuffer(const AdvancedAudioBuffer& parent, size_t offset, size_t frames);
+
+    void Allocate(size_t stride);
+    void Release();
+
+    float* fData;
+    size_t fStride;
+    size_t fChannelCount;
+    Storage fStorage;
+    AudioBuffer fPoolBuffer;
 };
 
 // Base class for all audio effects and processors
@@ -145,17 +199,57 @@ public:
 
 private:
     static const size_t MAX_BANDS = 8;
+    
+    // Coefficient changes are ramped linearly over kSmoothingSteps steps of
+    // kSmoothingStepFrames frames (~6 ms at 44.1 kHz). Interpolating
+    // between two stable biquads stays stable: the (a1, a2) stability
+    // triangle is convex.
+    static const size_t kSmoothingStepFrames = 32;
+    static const size_t kSmoothingSteps = 8;
+    
+    // Normalized coefficients of one band (a0 == 1)
+    struct BandCoefficients {
+        float b0, b1, b2, a1, a2;
+    };
+    
+    // Band designs compiled on the control thread for the audio thread
+    struct CompiledCascade {
+        std::array<BandCoefficients, MAX_BANDS> coefficients;
+        std::array<bool, MAX_BANDS> enabled;
+    };
+    
     std::array<EQBand, MAX_BANDS> fBands;
-    std::vector<std::array<DSP::BiquadFilter, MAX_BANDS>> fFilters;  // Per-channel filters
+    std::array<DSP::BiquadFilter, MAX_BANDS> fBandDesigns;  // Coefficients per band
+    DSP::BiquadBank fFilterBank;       // Lanes = channels, stages = bands
+    std::vector<float*> fChannelPointers;
+    std::vector<float*> fStepPointers;
     std::vector<DSP::DCBlocker> fDCBlockers;  // Per-channel DC blockers
     
+    // Triple buffer: the control thread fills fCascades[fControlSlot] and
+    // swaps it into fPendingSlot; the audio thread swaps that with its own
+    // fAudioSlot when kCascadeDirty is set. Neither side ever blocks.
+    static const int kCascadeSlotMask = 0x3;
+    static const int kCascadeDirty = 0x4;
+    std::array<CompiledCascade, 3> fCascades{};
+    int fControlSlot{0};
+    int fAudioSlot{1};
+    std::atomic<int> fPendingSlot{2};
+    
+    // Audio thread smoothing state
+    std::array<BandCoefficients, MAX_BANDS> fCurrent{};
+    size_t fRampStepsRemaining{0};
+    std::atomic<bool> fSnapToTarget{true};
+    
     float fSampleRate{44100.0f};
     bool fInitialized{false};
-    std::atomic<bool> fNeedsUpdate{true};
     
     void InitializeChannels(size_t channelCount);
     void UpdateFilters();
     void UpdateBandFilter(size_t band);
+    void PublishCascade();
+    void AcquireCascade();
+    void ApplyCurrentCoefficients(bool rampFinished);
+    void AdvanceRamp();
     float ProcessBandFilter(size_t band, size_t channel, float input);
     DSP::BiquadFilter::FilterType ConvertFilterType(FilterType type) const;
 };
@@ -220,6 +314,8 @@ private:
     bool fInitialized{false};
     std::atomic<bool> fNeedsUpdate{true};
     
+    static constexpr size_t kGainChunkFrames = 256;  // Stack scratch for the block gain computer
+    
     // Lookahead buffer system for zero-latency limiting
     bool fLookaheadEnabled{false};
     float fLookaheadTime{5.0f};  // Default 5ms lookahead
@@ -227,12 +323,14 @@ private:
     std::vector<std::vector<float>> fLookaheadBuffers;  // Per-channel circular buffers
     std::vector<size_t> fBufferWritePos;  // Write position for each channel
     std::vector<size_t> fBufferReadPos;   // Read position for each channel
-    std::vector<float> fPeakBuffer;       // Peak analysis buffer for lookahead
+    std::vector<DSP::SlidingPeakDetector> fPeakDetectors;  // Running peak over the lookahead window
+    std::vector<float> fLookaheadPeaks;   // Block scratch for detector output
+    static constexpr size_t kLookaheadChunkFrames = 4096;  // Size of fLookaheadPeaks
     
     void InitializeChannels(size_t channelCount);
     void UpdateEnvelopeFollowers();
-    float ProcessEnvelope(size_t channel, float input);
-    float CalculateGainReduction(float envelope);
+    void ProcessEnvelopeBlock(size_t channel, const float* input, float* envelope, size_t frameCount);
+    void CalculateGainReductionBlock(const float* envelope, float* levels, size_t frameCount);
     float ApplyKnee(float input, float threshold, float knee);
     float CalculateCompressorGain(float input);
     float CalculateLimiterGain(float input);
@@ -243,11 +341,62 @@ private:
     void InitializeLookaheadBuffers(size_t channelCount);
     void UpdateLookaheadParameters();
     float ProcessLookaheadSample(size_t channel, float input);
-    float AnalyzeLookaheadPeak(size_t channel);
+    void ProcessLookaheadBlock(size_t channel, float* data, size_t frameCount);
+    float CalculateLookaheadGain(float peak) const;
     void WriteLookaheadSample(size_t channel, float sample);
     float ReadLookaheadSample(size_t channel);
 };
 
+// Live pitch and tempo change (phase vocoder), so edits can be auditioned
+// without recomputing the sample cache.
+//
+// In an effect chain the buffer is all the input there is, so Process()
+// changes pitch only and keeps time. A track player that pulls its own
+// source calls ProcessStream() instead to change tempo as well. Either way
+// the output is GetLatencySamples() frames late; the latency grows with
+// the pitch, so SetPitch() updates it.
+class PitchTimeShifter : public AudioEffect {
+public:
+    PitchTimeShifter();
+    
+    // Picks the analysis frame size for the rate (about 46 ms)
+    void Initialize(float sampleRate);
+    void Process(AdvancedAudioBuffer& buffer) override;
+    void ProcessRealtime(AdvancedAudioBuffer& buffer) override;
+    
+    // Interleaved frames of GetChannelCount() channels, as
+    // DSP::PhaseVocoder::Process(); tempo applies here
+    size_t ProcessStream(const float* input, size_t& inputFrames, float* output, size_t outputFrames);
+    size_t GetInputFramesNeeded(size_t outputFrames) const;
+    
+    void SetParameter(const std::string& param, float value) override;
+    float GetParameter(const std::string& param) const override;
+    std::vector<std::string> GetParameterList() const override;
+    void Reset() override;
+    
+    // -24..+24 semitones and 0.25..4x, clamped
+    void SetPitch(float semitones);
+    float GetPitch() const { return fVocoder.GetPitch(); }
+    void SetTempo(float tempo);
+    float GetTempo() const { return fTempo.load(); }
+    
+    // Allocates; Process() calls it when the buffer's channel count changes
+    void SetChannelCount(size_t channels);
+    size_t GetChannelCount() const { return fVocoder.GetChannelCount(); }
+
+private:
+    DSP::PhaseVocoder fVocoder;
+    std::atomic<float> fTempo{1.0f};
+    float fSampleRate{44100.0f};
+    bool fInitialized{false};
+    
+    // Interleaved hop-sized blocks for Process()
+    std::vector<float> fBlockInput;
+    std::vector<float> fBlockOutput;
+    
+    void Configure(size_t channels, size_t frameSize);
+};
+
 // Professional spatial audio processor for multi-channel and 3D audio
 class SurroundProcessor {
 public:
@@ -346,7 +495,7 @@ private:
     // Delay lines for spatial processing
     std::vector<std::unique_ptr<DSP::DelayLine>> fSpatialDelays;
     
-    // HRTF convolution engines
+    // HRTF convolution engines (partitioned FFT, one block of latency)
     std::unique_ptr<DSP::ConvolutionEngine> fLeftHRTF;
     std::unique_ptr<DSP::ConvolutionEngine> fRightHRTF;
     bool fHRTFEnabled{false};
@@ -358,6 +507,7 @@ private:
     
     // Performance monitoring
     mutable std::atomic<float> fProcessingLoad{0.0f};
+    size_t fBaseLatencySamples{0};
     size_t fLatencySamples{0};
     
     // Internal processing methods
@@ -428,6 +578,10 @@ public:
     // Surround sound processing
     SurroundProcessor& GetSurroundProcessor() { return fSurroundProcessor; }
 
+    // Buffers of the configured size Initialize() reserves in the global
+    // AudioBufferPool, for pool-backed AdvancedAudioBuffers per callback
+    static const uint32 kReservedCallbackBuffers = 4;
+
 private:
     bool fInitialized{false};
     float fSampleRate{44100.0f};
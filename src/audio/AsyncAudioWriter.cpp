@@ -3,62 +3,154 @@
  */
 
 #include "AsyncAudioWriter.h"
+#ifdef __HAIKU__
 #include <media/MediaFile.h>
 #include <media/MediaTrack.h>
 #include <media/MediaFormats.h>
 #include <storage/Path.h>
+#endif
+#include "SampleConversion.h"
 #include <string.h>
+#ifndef __HAIKU__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include <algorithm>
+#include <new>
 
 namespace VeniceDAW {
 
+namespace {
+
+#ifndef __HAIKU__
+// RIFF header of the portable writer: "RIFF", "WAVE", a 16-byte "fmt "
+// chunk and the "data" chunk header
+const size_t kWavHeaderSize = 44;
+const uint16 kWavFormatPCM = 1;
+const uint16 kWavFormatFloat = 3;
+
+void PutLE16(uint8* out, uint16 value)
+{
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+}
+
+void PutLE32(uint8* out, uint32 value)
+{
+    PutLE16(out, value & 0xffff);
+    PutLE16(out + 2, value >> 16);
+}
+
+// Allocates the file's blocks up to size bytes without writing them;
+// false where the platform or the file system can't
+bool ReserveFileSpace(FILE* file, uint64 size)
+{
+#if defined(__linux__)
+    return posix_fallocate(fileno(file), 0, (off_t)size) == 0;
+#else
+    (void)file;
+    (void)size;
+    return false;
+#endif
+}
+
+int SyncDescriptor(int descriptor)
+{
+#if defined(__linux__)
+    return fdatasync(descriptor);   // The size is updated by the header write anyway
+#else
+    return fsync(descriptor);
+#endif
+}
+#endif
+
+uint32 BytesPerSample(const media_format& format)
+{
+    switch (format.u.raw_audio.format) {
+        case media_raw_audio_format::B_AUDIO_CHAR:
+        case media_raw_audio_format::B_AUDIO_UCHAR: return 1;
+        case media_raw_audio_format::B_AUDIO_SHORT: return 2;
+        default:                                    return 4;   // B_AUDIO_INT, B_AUDIO_FLOAT
+    }
+}
+
+} // namespace
+
 // =====================================
 // AsyncAudioWriter Implementation
 // =====================================
 
+const size_t AsyncAudioWriter::kMinRingBytes;
+
 AsyncAudioWriter::AsyncAudioWriter()
     : fWriterThread(-1)
-    , fQueueSemaphore(-1)
-    , fQueueMutex(-1)
+    , fDataSemaphore(-1)
+    , fSpaceSemaphore(-1)
+    , fWriterSleeping(false)
+    , fProducerWaiting(false)
     , fShouldStop(false)
+    , fWakeSemaphore(-1)
+    , fSleepFlag(&fWriterSleeping)
+    , fService(nullptr)
+    , fServiceAttached(false)
+    , fFileOpen(false)
+    , fClosedSemaphore(-1)
+    , fCloseStatus(B_OK)
+    , fErrorsAtStart(0)
+    , fLastFlush(0)
     , fWriting(false)
+#ifdef __HAIKU__
     , fMediaFile(nullptr)
     , fMediaTrack(nullptr)
-    , fMaxQueueSize(kDefaultMaxQueueSize)
-    , fQueueHead(0)
-    , fQueueTail(0)
-    , fQueueCount(0)
+#else
+    , fFile(nullptr)
+    , fDataBytes(0)
+    , fAllocatedBytes(0)
+#endif
+    , fRingCapacity(0)
+    , fFrameBytes(0)
+    , fHighWater(0)
+    , fWriteIndex(0)
+    , fReadIndex(0)
     , fQueuedRequests(0)
     , fProcessedRequests(0)
     , fDroppedRequests(0)
     , fWriteErrors(0)
     , fTotalBytesWritten(0)
     , fAverageWriteTimeUs(0)
+    , fPreallocatedBytes(0)
+    , fSyncs(0)
+    , fBufferDuration(kDefaultBufferDuration)
+    , fBlockWhenFull(false)
     , fWriterThreadPriority(kDefaultWriterPriority)
+    , fPreallocationStep(0)
+    , fSyncPolicy(kSyncNever)
+    , fSyncInterval(0)
+    , fLastSync(0)
 {
     // Create synchronization primitives
-    fQueueSemaphore = create_sem(0, "AsyncAudioWriter_Queue");
-    fQueueMutex = create_sem(1, "AsyncAudioWriter_Mutex");
-
-    // Pre-allocate queue
-    fWriteQueue.resize(fMaxQueueSize);
+    fDataSemaphore = create_sem(0, "AsyncAudioWriter_Data");
+    fSpaceSemaphore = create_sem(0, "AsyncAudioWriter_Space");
+    fClosedSemaphore = create_sem(0, "AsyncAudioWriter_Closed");
+    fWakeSemaphore = fDataSemaphore;
 
-    AUDIO_LOG_DEBUG("AsyncAudioWriter", "Created with queue size %u", fMaxQueueSize);
+    AUDIO_LOG_DEBUG("AsyncAudioWriter", "Created with %.1fs buffer", fBufferDuration / 1000000.0);
 }
 
 AsyncAudioWriter::~AsyncAudioWriter()
 {
     StopWriting();
 
-    if (fQueueSemaphore >= 0) delete_sem(fQueueSemaphore);
-    if (fQueueMutex >= 0) delete_sem(fQueueMutex);
+    if (fDataSemaphore >= 0) delete_sem(fDataSemaphore);
+    if (fSpaceSemaphore >= 0) delete_sem(fSpaceSemaphore);
+    if (fClosedSemaphore >= 0) delete_sem(fClosedSemaphore);
 
     AUDIO_LOG_DEBUG("AsyncAudioWriter", "Destroyed");
 }
 
 status_t AsyncAudioWriter::StartWriting(const char* filename, const media_format& format)
 {
-    if (fWriting.load()) {
+    if (fWriting.load() || IsRunning()) {
         AUDIO_LOG_WARNING("AsyncAudioWriter", "Already writing to a file");
         return B_ERROR;
     }
@@ -74,34 +166,67 @@ status_t AsyncAudioWriter::StartWriting(const char* filename, const media_format
     fOutputPath.SetTo(filename);
     fFileFormat = format;
 
-    // Start writer thread
-    status_t status = StartWriterThread();
+    status_t status = AllocateRing(format);
     if (status != B_OK) {
-        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to start writer thread: %s", strerror(status));
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to allocate ring buffer: %s", strerror(status));
         return status;
     }
 
+    // Recording writers are drained by the pool's service threads
     fWriting = true;
+    if (fService) {
+        fShouldStop = false;
+        status = fService->AttachWriter(this);
+        if (status != B_OK) {
+            fWriting = false;
+            AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to attach to writer service: %s", strerror(status));
+            return status;
+        }
+        AUDIO_LOG_INFO("AsyncAudioWriter", "Async writing started on the writer service");
+        return B_OK;
+    }
+
+    // Start writer thread; it clears fWriting if the file cannot be opened
+    status = StartWriterThread();
+    if (status != B_OK) {
+        fWriting = false;
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to start writer thread: %s", strerror(status));
+        return status;
+    }
+
     AUDIO_LOG_INFO("AsyncAudioWriter", "Async writing started successfully");
     return B_OK;
 }
 
 status_t AsyncAudioWriter::StopWriting()
 {
-    if (!fWriting.load()) {
+    // The thread outlives fWriting when the file could not be opened
+    if (!IsRunning()) {
         return B_OK;
     }
 
     AUDIO_LOG_INFO("AsyncAudioWriter", "Stopping async writing");
 
     fWriting = false;
-    StopWriterThread();
+    status_t status;
+    if (fServiceAttached) {
+        // The service thread writes the rest, closes the file and detaches
+        fShouldStop = true;
+        release_sem(fWakeSemaphore);
+        acquire_sem(fClosedSemaphore);
+        fServiceAttached = false;
+        fWakeSemaphore = fDataSemaphore;
+        fSleepFlag = &fWriterSleeping;
+        status = fCloseStatus;
+    } else {
+        status = StopWriterThread();
+    }
 
-    // Drain any remaining queue items
+    // Only left over if the file never opened
     DrainQueue();
 
     AUDIO_LOG_INFO("AsyncAudioWriter", "Async writing stopped");
-    return B_OK;
+    return status;
 }
 
 status_t AsyncAudioWriter::QueueAudioData(const void* data, size_t size, const media_format& format)
@@ -109,26 +234,43 @@ status_t AsyncAudioWriter::QueueAudioData(const void* data, size_t size, const m
     if (!fWriting.load() || !data || size == 0) {
         return B_BAD_VALUE;
     }
+    (void)format;  // The ring holds frames of the file format
 
     AUDIO_PERF_TIMER("AsyncAudioWriter", "QueueAudioData");
 
-    // Calculate frame count
-    uint32 channels = format.u.raw_audio.channel_count;
-    int64 frameCount = size / (channels * sizeof(float));
-
-    // Get buffer from pool and copy data
-    AudioBuffer buffer = AudioBufferPool::GetGlobalPool().GetBuffer(frameCount, channels);
-    if (!buffer.IsValid()) {
-        fDroppedRequests++;
-        AUDIO_RT_LOG_WARNING("AsyncAudioWriter", "Failed to get buffer from pool");
-        return B_NO_MEMORY;
+    const uint8* bytes = static_cast<const uint8*>(data);
+    size = size / fFrameBytes * fFrameBytes;
+    if (size == 0) {
+        return B_BAD_VALUE;
     }
 
-    // Copy audio data to buffer
-    memcpy(buffer.Data(), data, size);
+    if (!fBlockWhenFull) {
+        // All or nothing, so the file never holds half a buffer
+        uint64 used = fWriteIndex.load(std::memory_order_relaxed)
+                      - fReadIndex.load(std::memory_order_acquire);
+        if (size > fRingCapacity - used) {
+            fDroppedRequests++;
+            AUDIO_RT_LOG_WARNING("AsyncAudioWriter", "Ring buffer full, dropping %zu bytes", size);
+            return B_WOULD_BLOCK;
+        }
+        WriteToRing(bytes, size);
+        fQueuedRequests++;
+        return B_OK;
+    }
 
-    // Queue the buffer
-    return QueueAudioBuffer(std::move(buffer), format);
+    // Offline producers hand over what fits and wait for the writer
+    // thread to free the rest
+    while (size > 0) {
+        size_t written = WriteToRing(bytes, size);
+        bytes += written;
+        size -= written;
+        if (size > 0 && WaitForSpace() != B_OK) {
+            fDroppedRequests++;
+            return B_ERROR;
+        }
+    }
+    fQueuedRequests++;
+    return B_OK;
 }
 
 status_t AsyncAudioWriter::QueueAudioBuffer(AudioBuffer&& buffer, const media_format& format)
@@ -137,17 +279,12 @@ status_t AsyncAudioWriter::QueueAudioBuffer(AudioBuffer&& buffer, const media_fo
         return B_BAD_VALUE;
     }
 
-    // Create write request
-    AudioWriteRequest request(std::move(buffer), format, buffer.Frames());
-
-    // Enqueue (non-blocking from audio thread perspective)
-    status_t status = EnqueueRequest(std::move(request));
-    if (status == B_OK) {
-        fQueuedRequests++;
-    } else {
-        fDroppedRequests++;
-    }
+    // Pool buffers hold float frames; the file may use narrower samples
+    size_t bytes = std::min(buffer.SizeInBytes(), (size_t)buffer.Frames() * fFrameBytes);
+    status_t status = QueueAudioData(buffer.Data(), bytes, format);
 
+    // The samples are in the ring now: hand the buffer back right away
+    AudioBuffer released(std::move(buffer));
     return status;
 }
 
@@ -161,17 +298,45 @@ AsyncAudioWriter::WriterStats AsyncAudioWriter::GetStats() const
     stats.totalBytesWritten = fTotalBytesWritten.load();
     stats.averageWriteTimeMs = fAverageWriteTimeUs.load() / 1000.0f;
 
-    // Check queue status
-    if (acquire_sem_etc(fQueueMutex, 1, B_TIMEOUT, 1000) == B_OK) {
-        stats.queueOverflow = (fQueueCount >= fMaxQueueSize * 0.9f);  // 90% full
-        release_sem(fQueueMutex);
-    } else {
-        stats.queueOverflow = true;  // Assume overflow if can't get mutex
-    }
+    // Ring fill level, read without stopping either side (read index
+    // first: it never passes the write index)
+    uint64 read = fReadIndex.load();
+    uint64 used = fWriteIndex.load() - read;
+    stats.queueOverflow = fRingCapacity > 0 && used >= fRingCapacity * 0.9f;  // 90% full
+    stats.preallocatedBytes = fPreallocatedBytes.load();
+    stats.syncs = fSyncs.load();
 
     return stats;
 }
 
+void AsyncAudioWriter::SetBufferDuration(bigtime_t duration)
+{
+    if (IsRunning() || duration <= 0) {
+        return;
+    }
+
+    fBufferDuration = duration;
+}
+
+void AsyncAudioWriter::SetPreallocationStep(size_t bytes)
+{
+    if (IsRunning()) {
+        return;
+    }
+
+    fPreallocationStep = bytes;
+}
+
+void AsyncAudioWriter::SetSyncPolicy(SyncPolicy policy, bigtime_t interval)
+{
+    if (IsRunning()) {
+        return;
+    }
+
+    fSyncPolicy = policy;
+    fSyncInterval = std::max<bigtime_t>(interval, 0);
+}
+
 void AsyncAudioWriter::SetWriteThreadPriority(int32 priority)
 {
     fWriterThreadPriority = priority;
@@ -193,6 +358,7 @@ int32 AsyncAudioWriter::WriterThreadEntry(void* data)
 int32 AsyncAudioWriter::WriterThreadLoop()
 {
     AUDIO_LOG_DEBUG("AsyncAudioWriter", "Writer thread started");
+    uint32 errorsAtStart = fWriteErrors.load();
 
     // Initialize file
     status_t status = InitializeFile(fOutputPath.String(), fFileFormat);
@@ -202,49 +368,71 @@ int32 AsyncAudioWriter::WriterThreadLoop()
         return status;
     }
 
-    // Main processing loop
-    while (!fShouldStop) {
-        AudioWriteRequest request;
-
-        // Wait for data or timeout
-        if (acquire_sem_etc(fQueueSemaphore, 1, B_TIMEOUT, kQueueTimeoutUs) != B_OK) {
-            continue;  // Timeout or error, check stop condition
+    // Main processing loop; once asked to stop, write what is still queued
+    while (true) {
+        bool stopping = fShouldStop.load();
+        size_t queued = WaitForData();
+        if (queued > 0) {
+            WriteQueuedData(queued);
+        } else if (stopping) {
+            break;
         }
+    }
 
-        // Get request from queue
-        if (!DequeueRequest(request)) {
-            continue;  // Queue empty
-        }
+    // Cleanup
+    CloseFile();
 
-        // Write to file
-        bigtime_t writeStart = system_time();
-        status = WriteBufferToFile(request);
-        bigtime_t writeTime = system_time() - writeStart;
+    AUDIO_LOG_DEBUG("AsyncAudioWriter", "Writer thread finished");
+    return fWriteErrors.load() != errorsAtStart ? B_IO_ERROR : B_OK;
+}
 
-        if (status == B_OK) {
-            fProcessedRequests++;
-            fTotalBytesWritten += request.buffer.SizeInBytes();
+bool AsyncAudioWriter::NeedsService() const
+{
+    return !fFileOpen || fShouldStop.load() || QueuedBytes() >= fHighWater;
+}
 
-            // Update average write time (simple moving average)
-            uint32 oldAvg = fAverageWriteTimeUs.load();
-            uint32 newAvg = (oldAvg * 7 + writeTime) / 8;  // 7/8 weight to old value
-            fAverageWriteTimeUs = newAvg;
-        } else {
-            fWriteErrors++;
-            AUDIO_LOG_ERROR("AsyncAudioWriter", "Write error: %s", strerror(status));
+bool AsyncAudioWriter::ServicePass(bigtime_t now)
+{
+    if (!fFileOpen) {
+        fErrorsAtStart = fWriteErrors.load();
+        status_t status = InitializeFile(fOutputPath.String(), fFileFormat);
+        if (status != B_OK) {
+            AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to initialize file: %s", strerror(status));
+            fWriting = false;
+            fCloseStatus = status;
+            release_sem(fClosedSemaphore);
+            return true;
         }
+        fFileOpen = true;
+        fLastFlush = now;
+    }
 
-        // Check if this was the last request
-        if (request.isLast) {
-            break;
-        }
+    // The writer thread's policy: the high-water mark, a stop, or the
+    // flush interval for a trickle
+    bool stopping = fShouldStop.load();
+    size_t queued = QueuedBytes();
+    if (queued == 0) {
+        fLastFlush = now;
+    } else if (queued >= fHighWater || stopping || now - fLastFlush >= kFlushIntervalUs) {
+        WriteQueuedData(queued);
+        fLastFlush = now;
+    }
+    if (!stopping) {
+        return false;
     }
 
-    // Cleanup
+    // The producer stopped before asking: write what it queued since
+    queued = QueuedBytes();
+    if (queued > 0) {
+        WriteQueuedData(queued);
+    }
     CloseFile();
+    fFileOpen = false;
+    fCloseStatus = fWriteErrors.load() != fErrorsAtStart ? B_IO_ERROR : B_OK;
 
-    AUDIO_LOG_DEBUG("AsyncAudioWriter", "Writer thread finished");
-    return B_OK;
+    // StopWriting() may reuse or delete the writer from here on
+    release_sem(fClosedSemaphore);
+    return true;
 }
 
 status_t AsyncAudioWriter::StartWriterThread()
@@ -274,85 +462,173 @@ status_t AsyncAudioWriter::StartWriterThread()
     return B_OK;
 }
 
-void AsyncAudioWriter::StopWriterThread()
+status_t AsyncAudioWriter::StopWriterThread()
 {
     if (fWriterThread < 0) {
-        return;
+        return B_OK;
     }
 
     // Signal thread to stop
     fShouldStop = true;
 
     // Wake up thread if it's waiting
-    release_sem(fQueueSemaphore);
+    release_sem(fDataSemaphore);
 
-    // Wait for thread to finish (with timeout)
-    status_t exitValue;
+    // Wait for thread to finish
+    status_t exitValue = B_OK;
     wait_for_thread(fWriterThread, &exitValue);
 
     fWriterThread = -1;
+    return exitValue;
 }
 
 // =====================================
-// Queue Management
+// Ring Management
 // =====================================
 
-status_t AsyncAudioWriter::EnqueueRequest(AudioWriteRequest&& request)
+status_t AsyncAudioWriter::AllocateRing(const media_format& format)
 {
-    if (acquire_sem_etc(fQueueMutex, 1, B_TIMEOUT, 10000) != B_OK) {
-        return B_TIMED_OUT;  // Don't block audio thread
+    uint32 channels = std::max<uint32>(format.u.raw_audio.channel_count, 1);
+    fFrameBytes = channels * BytesPerSample(format);
+
+    // Whole frames, so every contiguous run the writer sees is too
+    double frameRate = format.u.raw_audio.frame_rate > 0 ? format.u.raw_audio.frame_rate : 44100.0;
+    size_t frames = (size_t)(frameRate * fBufferDuration / 1000000.0);
+    frames = std::max(frames, (kMinRingBytes + fFrameBytes - 1) / fFrameBytes);
+    fRingCapacity = frames * fFrameBytes;
+    fHighWater = std::max<size_t>(fRingCapacity / kHighWaterDivisor / fFrameBytes, 1) * fFrameBytes;
+
+    try {
+        fRing.assign(fRingCapacity, 0);
+    } catch (const std::bad_alloc&) {
+        fRingCapacity = 0;
+        return B_NO_MEMORY;
     }
 
-    status_t result = B_OK;
+    fWriteIndex = 0;
+    fReadIndex = 0;
+    fWriterSleeping = false;
+    fProducerWaiting = false;
+    return B_OK;
+}
 
-    if (fQueueCount >= fMaxQueueSize) {
-        // Queue full - drop oldest request to make room
-        // First, properly destroy the old request to free its AudioBuffer
-        fWriteQueue[fQueueHead] = AudioWriteRequest(); // Clear old request (calls AudioBuffer destructor)
-        fDroppedRequests++;
-        fQueueHead = (fQueueHead + 1) % fMaxQueueSize;
-        fQueueCount--;
-        AUDIO_RT_LOG_WARNING("AsyncAudioWriter", "Queue overflow, dropping old request");
+size_t AsyncAudioWriter::WriteToRing(const uint8* data, size_t size)
+{
+    uint64 write = fWriteIndex.load(std::memory_order_relaxed);
+    uint64 used = write - fReadIndex.load(std::memory_order_acquire);
+    size_t space = (fRingCapacity - (size_t)used) / fFrameBytes * fFrameBytes;
+    size = std::min(size, space);
+    if (size == 0) {
+        return 0;
     }
 
-    // Add new request
-    fWriteQueue[fQueueTail] = std::move(request);
-    fQueueTail = (fQueueTail + 1) % fMaxQueueSize;
-    fQueueCount++;
-
-    release_sem(fQueueMutex);
+    DSP::SampleConversion::WriteRing(fRing.data(), fRingCapacity, (size_t)(write % fRingCapacity),
+                                     data, size, 1);
 
-    // Signal writer thread
-    release_sem(fQueueSemaphore);
+    // Publish, then wake the writer if it sleeps and enough is queued
+    // (sequentially consistent against its sleep announcement)
+    fWriteIndex.store(write + size);
+    if (write + size - fReadIndex.load() >= fHighWater && fSleepFlag->exchange(false)) {
+        release_sem_etc(fWakeSemaphore, 1, B_DO_NOT_RESCHEDULE);
+    }
+    return size;
+}
 
-    return result;
+status_t AsyncAudioWriter::WaitForSpace()
+{
+    // The timeout only rechecks that the writer is still alive
+    while (fWriting.load()) {
+        fProducerWaiting = true;
+        uint64 write = fWriteIndex.load(std::memory_order_relaxed);
+        if (fRingCapacity - (write - fReadIndex.load()) >= fFrameBytes) {
+            fProducerWaiting = false;
+            return B_OK;
+        }
+        acquire_sem_etc(fSpaceSemaphore, 1, B_TIMEOUT, kQueueTimeoutUs);
+    }
+    fProducerWaiting = false;
+    return B_ERROR;
 }
 
-bool AsyncAudioWriter::DequeueRequest(AudioWriteRequest& request)
+size_t AsyncAudioWriter::WaitForData()
 {
-    if (acquire_sem_etc(fQueueMutex, 1, B_TIMEOUT, 10000) != B_OK) {
-        return false;
+    uint64 read = fReadIndex.load(std::memory_order_relaxed);
+    uint64 queued = fWriteIndex.load(std::memory_order_acquire) - read;
+    if (queued >= fHighWater || fShouldStop.load()) {
+        return (size_t)queued;
+    }
+
+    // Announce the sleep, recheck, then sleep until the producer crosses
+    // the high-water mark, a stop, or the flush interval
+    fWriterSleeping = true;
+    if (fWriteIndex.load() - read < fHighWater && !fShouldStop.load()) {
+        acquire_sem_etc(fDataSemaphore, 1, B_TIMEOUT, kFlushIntervalUs);
     }
+    fWriterSleeping = false;
+
+    return (size_t)(fWriteIndex.load(std::memory_order_acquire) - read);
+}
+
+size_t AsyncAudioWriter::QueuedBytes() const
+{
+    uint64 read = fReadIndex.load(std::memory_order_relaxed);
+    return (size_t)(fWriteIndex.load() - read);
+}
+
+void AsyncAudioWriter::WriteQueuedData(size_t bytes)
+{
+    uint64 read = fReadIndex.load(std::memory_order_relaxed);
+    size_t position = (size_t)(read % fRingCapacity);
+
+    // At most two runs, straight out of the ring
+    size_t firstRun = std::min(bytes, fRingCapacity - position);
+    const size_t runs[2] = { firstRun, bytes - firstRun };
+    const uint8* starts[2] = { fRing.data() + position, fRing.data() };
+
+    for (int i = 0; i < 2; i++) {
+        if (runs[i] == 0) {
+            continue;
+        }
+
+        bigtime_t writeStart = system_time();
+        status_t status = WriteChunkToFile(starts[i], runs[i]);
+        bigtime_t writeTime = system_time() - writeStart;
+
+        if (status == B_OK) {
+            fProcessedRequests++;
+            fTotalBytesWritten += runs[i];
 
-    bool hasData = false;
+            // Update average write time (simple moving average)
+            uint32 oldAvg = fAverageWriteTimeUs.load();
+            uint32 newAvg = (oldAvg * 7 + writeTime) / 8;  // 7/8 weight to old value
+            fAverageWriteTimeUs = newAvg;
+        } else {
+            fWriteErrors++;
+            AUDIO_LOG_ERROR("AsyncAudioWriter", "Write error: %s", strerror(status));
+        }
+    }
 
-    if (fQueueCount > 0) {
-        request = std::move(fWriteQueue[fQueueHead]);
-        fQueueHead = (fQueueHead + 1) % fMaxQueueSize;
-        fQueueCount--;
-        hasData = true;
+    // Free the space even after an error, so the producer never stalls on
+    // a broken disk, and wake a producer that waits for it
+    fReadIndex.store(read + bytes);
+    if (fProducerWaiting.exchange(false)) {
+        release_sem(fSpaceSemaphore);
     }
 
-    release_sem(fQueueMutex);
-    return hasData;
+    if (fSyncPolicy == kSyncPeriodic && system_time() - fLastSync >= fSyncInterval) {
+        SyncFile();
+    }
 }
 
 void AsyncAudioWriter::DrainQueue()
 {
-    AudioWriteRequest request;
-    while (DequeueRequest(request)) {
-        // Just discard remaining requests
-        fDroppedRequests++;
+    // Just discard what the writer thread never wrote
+    uint64 read = fReadIndex.load();
+    uint64 queued = fWriteIndex.load() - read;
+    if (queued > 0) {
+        AUDIO_LOG_WARNING("AsyncAudioWriter", "Discarding %llu unwritten bytes",
+                          (unsigned long long)queued);
+        fReadIndex = fWriteIndex.load();
     }
 }
 
@@ -364,6 +640,29 @@ status_t AsyncAudioWriter::InitializeFile(const char* filename, const media_form
 {
     AUDIO_LOG_DEBUG("AsyncAudioWriter", "Initializing file: %s", filename);
 
+#ifndef __HAIKU__
+    (void)format;  // Kept in fFileFormat for the header
+
+    fFile = fopen(filename, "wb");
+    if (!fFile) {
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to create '%s'", filename);
+        return B_IO_ERROR;
+    }
+
+    // Placeholder sizes, patched by CloseFile()
+    fDataBytes = 0;
+    fAllocatedBytes = 0;
+    fLastSync = system_time();
+    status_t status = WriteWavHeader();
+    if (status != B_OK) {
+        CloseFile();
+        return status;
+    }
+
+    AUDIO_LOG_INFO("AsyncAudioWriter", "File initialized successfully");
+    return B_OK;
+#else
+
     // Create entry ref
     entry_ref ref;
     status_t status = get_ref_for_path(filename, &ref);
@@ -417,26 +716,140 @@ status_t AsyncAudioWriter::InitializeFile(const char* filename, const media_form
 
     AUDIO_LOG_INFO("AsyncAudioWriter", "File initialized successfully");
     return B_OK;
+#endif
 }
 
-status_t AsyncAudioWriter::WriteBufferToFile(const AudioWriteRequest& request)
+status_t AsyncAudioWriter::WriteChunkToFile(const uint8* data, size_t bytes)
 {
-    if (!fMediaTrack || !request.buffer.IsValid()) {
+#ifndef __HAIKU__
+    if (!fFile) {
+        return B_BAD_VALUE;
+    }
+
+    if (fPreallocationStep > 0) {
+        PreallocateFile(kWavHeaderSize + fDataBytes + bytes);
+    }
+
+    // Same contract as BMediaTrack::WriteFrames(): whole frames in the
+    // file format. Little-endian hosts only, like the header.
+    if (fwrite(data, 1, bytes, fFile) != bytes) {
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "fwrite failed on '%s'", fOutputPath.String());
+        return B_IO_ERROR;
+    }
+
+    fDataBytes += bytes;
+    return B_OK;
+#else
+    if (!fMediaTrack) {
         return B_BAD_VALUE;
     }
 
     // Write frames to file
-    status_t status = fMediaTrack->WriteFrames(request.buffer.Data(), request.frameCount);
+    status_t status = fMediaTrack->WriteFrames(data, bytes / fFrameBytes);
     if (status != B_OK) {
         AUDIO_LOG_ERROR("AsyncAudioWriter", "WriteFrames failed: %s", strerror(status));
         return status;
     }
 
+    return B_OK;
+#endif
+}
+
+#ifndef __HAIKU__
+status_t AsyncAudioWriter::WriteWavHeader()
+{
+    const media_format& format = fFileFormat;
+    uint16 channels = (uint16)format.u.raw_audio.channel_count;
+    uint32 sampleRate = (uint32)format.u.raw_audio.frame_rate;
+    uint32 sampleBytes = BytesPerSample(format);
+    uint32 blockAlign = channels * sampleBytes;
+
+    // RIFF sizes are 32-bit; longer files keep their data but cap the header
+    uint32 dataBytes = (uint32)std::min<uint64>(fDataBytes, 0xffffffffu - kWavHeaderSize);
+
+    uint8 header[kWavHeaderSize];
+    memcpy(header, "RIFF", 4);
+    PutLE32(header + 4, (uint32)(kWavHeaderSize - 8) + dataBytes);
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "fmt ", 4);
+    PutLE32(header + 16, 16);
+    PutLE16(header + 20, format.u.raw_audio.format == media_raw_audio_format::B_AUDIO_FLOAT ? kWavFormatFloat : kWavFormatPCM);
+    PutLE16(header + 22, channels);
+    PutLE32(header + 24, sampleRate);
+    PutLE32(header + 28, sampleRate * blockAlign);
+    PutLE16(header + 32, (uint16)blockAlign);
+    PutLE16(header + 34, (uint16)(sampleBytes * 8));
+    memcpy(header + 36, "data", 4);
+    PutLE32(header + 40, dataBytes);
+
+    if (fseek(fFile, 0, SEEK_SET) != 0 || fwrite(header, 1, kWavHeaderSize, fFile) != kWavHeaderSize) {
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to write WAV header to '%s'", fOutputPath.String());
+        return B_IO_ERROR;
+    }
     return B_OK;
 }
 
+void AsyncAudioWriter::PreallocateFile(uint64 needed)
+{
+    if (needed <= fAllocatedBytes) {
+        return;
+    }
+
+    // A whole step past the data, so the next writes land in blocks the
+    // file system already placed next to each other
+    uint64 size = (needed / fPreallocationStep + 1) * fPreallocationStep;
+    if (!ReserveFileSpace(fFile, size)) {
+        AUDIO_LOG_DEBUG("AsyncAudioWriter", "No preallocation on '%s'", fOutputPath.String());
+        fPreallocationStep = 0;  // Grow as written from now on
+        return;
+    }
+
+    fPreallocatedBytes += size - fAllocatedBytes;
+    fAllocatedBytes = size;
+}
+#endif
+
+void AsyncAudioWriter::SyncFile()
+{
+#ifndef __HAIKU__
+    if (!fFile) {
+        return;
+    }
+    if (fflush(fFile) != 0 || SyncDescriptor(fileno(fFile)) != 0) {
+        fWriteErrors++;
+        AUDIO_LOG_ERROR("AsyncAudioWriter", "Failed to sync '%s'", fOutputPath.String());
+    } else {
+        fSyncs++;
+    }
+#endif
+    fLastSync = system_time();
+}
+
 void AsyncAudioWriter::CloseFile()
 {
+#ifndef __HAIKU__
+    if (fFile) {
+        if (WriteWavHeader() != B_OK) {
+            fWriteErrors++;
+        }
+
+        // Give back the preallocated space past the data
+        uint64 fileBytes = kWavHeaderSize + fDataBytes;
+        if (fAllocatedBytes > fileBytes
+            && (fflush(fFile) != 0 || ftruncate(fileno(fFile), (off_t)fileBytes) != 0)) {
+            fWriteErrors++;
+        }
+        fAllocatedBytes = 0;
+
+        if (fSyncPolicy != kSyncNever) {
+            SyncFile();
+        }
+        if (fclose(fFile) != 0) {
+            fWriteErrors++;
+        }
+        fFile = nullptr;
+    }
+#else
     if (fMediaTrack && fMediaFile) {
         fMediaFile->ReleaseTrack(fMediaTrack);
         fMediaTrack = nullptr;
@@ -447,6 +860,7 @@ void AsyncAudioWriter::CloseFile()
         delete fMediaFile;
         fMediaFile = nullptr;
     }
+#endif
 
     AUDIO_LOG_DEBUG("AsyncAudioWriter", "File closed");
 }
@@ -485,6 +899,10 @@ AsyncWriterPool& AsyncWriterPool::Instance()
 
 AsyncWriterPool::AsyncWriterPool()
     : fPoolMutex(-1)
+    , fServiceThreadCount(kDefaultServiceThreads)
+    , fRecordingPreallocationStep(kDefaultPreallocationStep)
+    , fRecordingSyncPolicy(AsyncAudioWriter::kSyncPeriodic)
+    , fRecordingSyncInterval(kDefaultSyncInterval)
 {
     fPoolMutex = create_sem(1, "AsyncWriterPool");
 
@@ -497,12 +915,14 @@ AsyncWriterPool::AsyncWriterPool()
 
 AsyncWriterPool::~AsyncWriterPool()
 {
+    // Recording writers close their files through the service threads
     for (auto* writer : fAvailableWriters) {
         delete writer;
     }
     for (auto* writer : fActiveWriters) {
         delete writer;
     }
+    StopServiceThreads();
 
     if (fPoolMutex >= 0) {
         delete_sem(fPoolMutex);
@@ -510,6 +930,27 @@ AsyncWriterPool::~AsyncWriterPool()
 }
 
 AsyncAudioWriter* AsyncWriterPool::GetWriter()
+{
+    AsyncAudioWriter* writer = AcquireWriter(kMaxPoolSize);
+    if (writer) {
+        writer->SetPreallocationStep(0);
+        writer->SetSyncPolicy(AsyncAudioWriter::kSyncNever);
+    }
+    return writer;
+}
+
+AsyncAudioWriter* AsyncWriterPool::GetRecordingWriter()
+{
+    AsyncAudioWriter* writer = AcquireWriter(kMaxRecordingWriters);
+    if (writer) {
+        writer->fService = this;
+        writer->SetPreallocationStep(fRecordingPreallocationStep);
+        writer->SetSyncPolicy(fRecordingSyncPolicy, fRecordingSyncInterval);
+    }
+    return writer;
+}
+
+AsyncAudioWriter* AsyncWriterPool::AcquireWriter(uint32 limit)
 {
     if (acquire_sem(fPoolMutex) != B_OK) {
         return nullptr;
@@ -521,7 +962,7 @@ AsyncAudioWriter* AsyncWriterPool::GetWriter()
         writer = fAvailableWriters.back();
         fAvailableWriters.pop_back();
         fActiveWriters.push_back(writer);
-    } else if (fActiveWriters.size() < kMaxPoolSize) {
+    } else if (fActiveWriters.size() < limit) {
         writer = new AsyncAudioWriter();
         fActiveWriters.push_back(writer);
     }
@@ -543,6 +984,7 @@ void AsyncWriterPool::ReturnWriter(AsyncAudioWriter* writer)
 
         // Stop any ongoing writing
         writer->StopWriting();
+        writer->fService = nullptr;
 
         // Return to available pool
         fAvailableWriters.push_back(writer);
@@ -551,6 +993,22 @@ void AsyncWriterPool::ReturnWriter(AsyncAudioWriter* writer)
     release_sem(fPoolMutex);
 }
 
+void AsyncWriterPool::SetServiceThreadCount(uint32 count)
+{
+    fServiceThreadCount = std::max<uint32>(count, 1);
+}
+
+void AsyncWriterPool::SetRecordingPreallocationStep(size_t bytes)
+{
+    fRecordingPreallocationStep = bytes;
+}
+
+void AsyncWriterPool::SetRecordingSyncPolicy(AsyncAudioWriter::SyncPolicy policy, bigtime_t interval)
+{
+    fRecordingSyncPolicy = policy;
+    fRecordingSyncInterval = interval;
+}
+
 uint32 AsyncWriterPool::GetAvailableWriters() const
 {
     return fAvailableWriters.size();
@@ -561,4 +1019,139 @@ uint32 AsyncWriterPool::GetActiveWriters() const
     return fActiveWriters.size();
 }
 
-} // namespace VeniceDAW
\ No newline at end of file
+uint32 AsyncWriterPool::GetServiceThreads() const
+{
+    return fServiceThreads.size();
+}
+
+uint32 AsyncWriterPool::GetServiceWriters() const
+{
+    uint32 writers = 0;
+    for (const ServiceThread* service : fServiceThreads) {
+        writers += service->writerCount.load();
+    }
+    return writers;
+}
+
+// =====================================
+// Writer Service
+// =====================================
+
+status_t AsyncWriterPool::AttachWriter(AsyncAudioWriter* writer)
+{
+    if (acquire_sem(fPoolMutex) != B_OK) {
+        return B_ERROR;
+    }
+
+    // Service threads start with the first recording
+    while (fServiceThreads.size() < fServiceThreadCount) {
+        ServiceThread* service = new ServiceThread();
+        service->wake = create_sem(0, "AsyncWriterService_Wake");
+        service->lock = create_sem(1, "AsyncWriterService_Lock");
+        service->writerCount = 0;
+        service->sleeping = false;
+        service->quit = false;
+        service->thread = spawn_thread(ServiceThreadEntry, "AsyncWriterService",
+                                       AsyncAudioWriter::kDefaultWriterPriority, service);
+        if (service->wake < 0 || service->lock < 0 || service->thread < 0
+            || resume_thread(service->thread) != B_OK) {
+            AUDIO_LOG_ERROR("AsyncWriterPool", "Failed to start writer service thread");
+            if (service->thread >= 0) kill_thread(service->thread);
+            if (service->wake >= 0) delete_sem(service->wake);
+            if (service->lock >= 0) delete_sem(service->lock);
+            delete service;
+            break;
+        }
+        fServiceThreads.push_back(service);
+    }
+
+    // The least loaded thread
+    ServiceThread* target = nullptr;
+    for (ServiceThread* service : fServiceThreads) {
+        if (!target || service->writerCount.load() < target->writerCount.load()) {
+            target = service;
+        }
+    }
+    if (target) {
+        target->writerCount++;
+    }
+    release_sem(fPoolMutex);
+
+    if (!target) {
+        return B_ERROR;
+    }
+
+    writer->fWakeSemaphore = target->wake;
+    writer->fSleepFlag = &target->sleeping;
+    writer->fFileOpen = false;
+    writer->fServiceAttached = true;
+
+    acquire_sem(target->lock);
+    target->writers.push_back(writer);
+    release_sem(target->lock);
+
+    // Opens the file on its next pass
+    release_sem(target->wake);
+    return B_OK;
+}
+
+void AsyncWriterPool::StopServiceThreads()
+{
+    for (ServiceThread* service : fServiceThreads) {
+        service->quit = true;
+        release_sem(service->wake);
+
+        status_t exitValue;
+        wait_for_thread(service->thread, &exitValue);
+
+        delete_sem(service->wake);
+        delete_sem(service->lock);
+        delete service;
+    }
+    fServiceThreads.clear();
+}
+
+int32 AsyncWriterPool::ServiceThreadEntry(void* data)
+{
+    ServiceThreadLoop(static_cast<ServiceThread*>(data));
+    return B_OK;
+}
+
+void AsyncWriterPool::ServiceThreadLoop(ServiceThread* service)
+{
+    AUDIO_LOG_DEBUG("AsyncWriterPool", "Writer service thread started");
+
+    while (!service->quit.load()) {
+        acquire_sem(service->lock);
+
+        // One pass over every file: each writes its whole backlog at once
+        bigtime_t now = system_time();
+        for (size_t i = 0; i < service->writers.size(); ) {
+            if (service->writers[i]->ServicePass(now)) {
+                service->writers.erase(service->writers.begin() + i);
+                service->writerCount--;
+            } else {
+                i++;
+            }
+        }
+
+        // Announce the sleep, recheck, then sleep until a producer crosses
+        // its high-water mark, a writer attaches or stops, or the flush
+        // interval
+        service->sleeping = true;
+        bool ready = false;
+        for (AsyncAudioWriter* writer : service->writers) {
+            ready = ready || writer->NeedsService();
+        }
+        release_sem(service->lock);
+
+        if (!ready && !service->quit.load()) {
+            acquire_sem_etc(service->wake, 1, B_TIMEOUT, AsyncAudioWriter::kFlushIntervalUs);
+        }
+        service->sleeping = false;
+    }
+
+    AUDIO_LOG_DEBUG("AsyncWriterPool", "Writer service thread finished");
+}
+
+} // namespace VeniceDAW
@@ -1,114 +1,189 @@
 /*
  * AsyncAudioWriter.h - Non-blocking file writing for real-time audio
  * Separates audio I/O from file I/O to prevent dropouts
+ *
+ * Writes WAV through BMediaFile on Haiku and through a plain RIFF writer
+ * elsewhere, so offline renders also run with the mock headers.
  */
 
 #ifndef ASYNC_AUDIO_WRITER_H
 #define ASYNC_AUDIO_WRITER_H
 
+#ifdef __HAIKU__
 #include <OS.h>
 #include <support/String.h>
 #include <media/MediaDefs.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#include <stdio.h>
+#endif
 #include <vector>
 #include <atomic>
 #include "AudioBufferPool.h"
 #include "AudioLogging.h"
 
+#ifdef __HAIKU__
 // Forward declarations
 class BMediaFile;
 class BMediaTrack;
+#endif
 
 namespace VeniceDAW {
 
-/*
- * Audio data queue entry for async writing
- */
-struct AudioWriteRequest {
-    AudioBuffer buffer;      // Audio data to write (RAII managed)
-    media_format format;     // Audio format information
-    bigtime_t timestamp;     // When this data was recorded
-    bool isLast;             // True if this is the final chunk
-    int64 frameCount;        // Number of frames to write
-
-    AudioWriteRequest() : timestamp(0), isLast(false), frameCount(0) {}
-
-    AudioWriteRequest(AudioBuffer&& buf, const media_format& fmt, int64 frames)
-        : buffer(std::move(buf)), format(fmt), isLast(false), frameCount(frames)
-    {
-        timestamp = system_time();
-    }
-};
+class AsyncWriterPool;
 
 /*
  * High-performance async audio file writer
  * Queues audio data from real-time thread and writes in background
+ *
+ * Queued samples go straight into a single-producer/single-consumer byte
+ * ring, sized from the file format by StartWriting(). The producer never
+ * takes a lock: it copies, publishes its write index and only wakes the
+ * writer thread when the ring crosses a high-water mark. The writer then
+ * writes everything queued, in at most two contiguous runs straight out
+ * of the ring, and otherwise flushes on a timer so quiet takes still
+ * reach the disk. One thread at a time may queue data.
+ *
+ * By default data that doesn't fit is dropped whole (the newest call;
+ * only the writer may move the read index), so the audio thread never
+ * waits. Offline renders produce faster than the disk and must not lose
+ * data: SetBlockWhenFull(true) makes the queue calls wait for the writer
+ * thread instead.
  */
 class AsyncAudioWriter {
 public:
     AsyncAudioWriter();
     ~AsyncAudioWriter();
 
-    // File management
+    // File management. StopWriting() writes everything still queued,
+    // closes the file and returns the writer thread's status (the file
+    // is only opened by the writer thread).
     status_t StartWriting(const char* filename, const media_format& format);
     status_t StopWriting();
     bool IsWriting() const { return fWriting.load(); }
 
-    // Non-blocking audio data submission (called from audio thread)
+    // Non-blocking audio data submission (called from audio thread). Data
+    // is whole frames in the format passed to StartWriting(); a trailing
+    // partial frame is ignored. Returns B_WOULD_BLOCK when the ring has no
+    // room for all of it.
     status_t QueueAudioData(const void* data, size_t size, const media_format& format);
     status_t QueueAudioBuffer(AudioBuffer&& buffer, const media_format& format);
 
     // Statistics and monitoring
     struct WriterStats {
-        uint32 queuedRequests;
-        uint32 processedRequests;
-        uint32 droppedRequests;    // Due to queue overflow
+        uint32 queuedRequests;     // Queue calls accepted
+        uint32 processedRequests;  // Contiguous chunks written
+        uint32 droppedRequests;    // Queue calls rejected by a full ring
         uint32 writeErrors;
         uint64 totalBytesWritten;
-        float averageWriteTimeMs;
-        bool queueOverflow;
+        float averageWriteTimeMs;  // Per chunk
+        bool queueOverflow;        // Ring at least 90% full
+        uint64 preallocatedBytes;  // File space reserved ahead of the data
+        uint32 syncs;              // Data flushed to the device
     };
     WriterStats GetStats() const;
 
-    // Configuration
-    void SetMaxQueueSize(uint32 maxSize) { fMaxQueueSize = maxSize; }
+    // Configuration (buffer length and blocking only while not writing).
+    // The ring holds duration worth of audio; the writer wakes once a
+    // quarter of it is queued.
+    void SetBufferDuration(bigtime_t duration);
+    bigtime_t BufferDuration() const { return fBufferDuration; }
+    void SetBlockWhenFull(bool block) { fBlockWhenFull = block; }
+    bool IsBlockingWhenFull() const { return fBlockWhenFull; }
     void SetWriteThreadPriority(int32 priority);
 
+    // File space is reserved in steps of this many bytes ahead of the
+    // data, so long takes stay in few, contiguous extents (0: grow as
+    // written). The file is trimmed to its data when it closes.
+    void SetPreallocationStep(size_t bytes);
+
+    // When written data is forced to the device. Preallocation and
+    // syncing apply to the portable RIFF writer; BMediaFile manages its
+    // own file.
+    enum SyncPolicy {
+        kSyncNever,        // Leave it to the OS
+        kSyncOnClose,      // Once, when the file closes
+        kSyncPeriodic      // Every sync interval, and on close
+    };
+    void SetSyncPolicy(SyncPolicy policy, bigtime_t interval = 0);
+
 private:
+    friend class AsyncWriterPool;
+
     // Writer thread management
     static int32 WriterThreadEntry(void* data);
     int32 WriterThreadLoop();
     status_t StartWriterThread();
-    void StopWriterThread();
-
-    // Queue management
-    status_t EnqueueRequest(AudioWriteRequest&& request);
-    bool DequeueRequest(AudioWriteRequest& request);
+    status_t StopWriterThread();
+    bool IsRunning() const { return fWriterThread >= 0 || fServiceAttached; }
+
+    // Writer service: an AsyncWriterPool thread does the writer thread's
+    // work for many writers, one pass at a time. ServicePass() returns
+    // true once the file is closed and the writer can be detached.
+    bool NeedsService() const;
+    bool ServicePass(bigtime_t now);
+
+    // Ring management
+    status_t AllocateRing(const media_format& format);
+    size_t WriteToRing(const uint8* data, size_t size);
+    status_t WaitForSpace();
+    size_t WaitForData();
+    size_t QueuedBytes() const;
+    void WriteQueuedData(size_t bytes);
     void DrainQueue();
 
     // File operations (called from writer thread only)
     status_t InitializeFile(const char* filename, const media_format& format);
-    status_t WriteBufferToFile(const AudioWriteRequest& request);
+    status_t WriteChunkToFile(const uint8* data, size_t bytes);
+    void SyncFile();
     void CloseFile();
-
-    // Thread synchronization
+#ifndef __HAIKU__
+    status_t WriteWavHeader();
+    void PreallocateFile(uint64 needed);
+#endif
+
+    // Thread synchronization. Each side only sleeps after announcing it
+    // and rechecking the indices, so a wakeup is never lost. A service
+    // thread points the wakeup semaphore and flag at its own.
     thread_id fWriterThread;
-    sem_id fQueueSemaphore;     // Signals data available
-    sem_id fQueueMutex;         // Protects queue access
+    sem_id fDataSemaphore;      // Wakes the writer: high-water mark or stop
+    sem_id fSpaceSemaphore;     // Wakes a blocked producer: space freed
+    std::atomic<bool> fWriterSleeping;
+    std::atomic<bool> fProducerWaiting;
     std::atomic<bool> fShouldStop;
+    sem_id fWakeSemaphore;
+    std::atomic<bool>* fSleepFlag;
+
+    // Writer service state
+    AsyncWriterPool* fService;  // Set while handed out as a recording writer
+    bool fServiceAttached;
+    bool fFileOpen;             // Service thread only
+    sem_id fClosedSemaphore;    // Service closed the file
+    status_t fCloseStatus;
+    uint32 fErrorsAtStart;
+    bigtime_t fLastFlush;
 
     // File writing state
     std::atomic<bool> fWriting;
+#ifdef __HAIKU__
     BMediaFile* fMediaFile;
     BMediaTrack* fMediaTrack;
+#else
+    FILE* fFile;
+    uint64 fDataBytes;
+    uint64 fAllocatedBytes;
+#endif
     BString fOutputPath;
     media_format fFileFormat;
 
-    // Audio data queue
-    std::vector<AudioWriteRequest> fWriteQueue;
-    uint32 fMaxQueueSize;
-    uint32 fQueueHead;          // Next position to read
-    uint32 fQueueTail;          // Next position to write
-    uint32 fQueueCount;         // Current number of items
+    // Sample ring: a whole number of frames, indexed by running byte
+    // counts (position = index % capacity)
+    std::vector<uint8> fRing;
+    size_t fRingCapacity;
+    size_t fFrameBytes;
+    size_t fHighWater;
+    std::atomic<uint64> fWriteIndex;   // Producer only
+    std::atomic<uint64> fReadIndex;    // Writer thread only
 
     // Performance statistics (atomic for lock-free access)
     mutable std::atomic<uint32> fQueuedRequests;
@@ -117,12 +192,23 @@ private:
     mutable std::atomic<uint32> fWriteErrors;
     mutable std::atomic<uint64> fTotalBytesWritten;
     mutable std::atomic<uint32> fAverageWriteTimeUs;
+    mutable std::atomic<uint64> fPreallocatedBytes;
+    mutable std::atomic<uint32> fSyncs;
 
     // Configuration
+    bigtime_t fBufferDuration;
+    bool fBlockWhenFull;
     int32 fWriterThreadPriority;
-    static const uint32 kDefaultMaxQueueSize = 256;
+    size_t fPreallocationStep;
+    SyncPolicy fSyncPolicy;
+    bigtime_t fSyncInterval;
+    bigtime_t fLastSync;
+    static const bigtime_t kDefaultBufferDuration = 2000000;  // 2s of disk stall
+    static const size_t kMinRingBytes = 65536;
+    static const uint32 kHighWaterDivisor = 4;
     static const int32 kDefaultWriterPriority = B_LOW_PRIORITY;
-    static const bigtime_t kQueueTimeoutUs = 10000;  // 10ms timeout
+    static const bigtime_t kFlushIntervalUs = 100000;  // Writes a slow trickle every 100ms
+    static const bigtime_t kQueueTimeoutUs = 10000;    // Blocking producers recheck every 10ms
 };
 
 /*
@@ -155,6 +241,14 @@ private:
 
 /*
  * Global async writer pool for shared usage
+ *
+ * Also the session's recording writer service: writers handed out by
+ * GetRecordingWriter() have no thread of their own. A bounded set of
+ * service threads drains all their rings, so 16-32 inputs recording at
+ * once cost a couple of threads, and each pass writes every file's
+ * backlog as one large sequential write (the ring coalesces the
+ * producer's small chunks). Recording files are preallocated in large
+ * steps and synced by the configured policy.
  */
 class AsyncWriterPool {
 public:
@@ -164,19 +258,61 @@ public:
     AsyncAudioWriter* GetWriter();
     void ReturnWriter(AsyncAudioWriter* writer);
 
+    // Get a writer served by the service threads; return it with
+    // ReturnWriter() like any other
+    AsyncAudioWriter* GetRecordingWriter();
+
+    // Service configuration, applied to recording writers handed out
+    // afterwards (thread count only before the first one starts)
+    void SetServiceThreadCount(uint32 count);
+    void SetRecordingPreallocationStep(size_t bytes);
+    void SetRecordingSyncPolicy(AsyncAudioWriter::SyncPolicy policy, bigtime_t interval);
+
     // Pool statistics
     uint32 GetAvailableWriters() const;
     uint32 GetActiveWriters() const;
+    uint32 GetServiceThreads() const;
+    uint32 GetServiceWriters() const;
 
 private:
+    friend class AsyncAudioWriter;
+
     AsyncWriterPool();
     ~AsyncWriterPool();
 
+    AsyncAudioWriter* AcquireWriter(uint32 limit);
+
+    // One service thread and the writers it drains
+    struct ServiceThread {
+        thread_id thread;
+        sem_id wake;                    // Producers, attach and stop
+        sem_id lock;                    // Protects writers
+        std::vector<AsyncAudioWriter*> writers;
+        std::atomic<uint32> writerCount;
+        std::atomic<bool> sleeping;
+        std::atomic<bool> quit;
+    };
+
+    status_t AttachWriter(AsyncAudioWriter* writer);
+    void StopServiceThreads();
+    static int32 ServiceThreadEntry(void* data);
+    static void ServiceThreadLoop(ServiceThread* service);
+
     std::vector<AsyncAudioWriter*> fAvailableWriters;
     std::vector<AsyncAudioWriter*> fActiveWriters;
     sem_id fPoolMutex;
 
+    std::vector<ServiceThread*> fServiceThreads;
+    uint32 fServiceThreadCount;
+    size_t fRecordingPreallocationStep;
+    AsyncAudioWriter::SyncPolicy fRecordingSyncPolicy;
+    bigtime_t fRecordingSyncInterval;
+
     static const uint32 kMaxPoolSize = 8;
+    static const uint32 kMaxRecordingWriters = 64;
+    static const uint32 kDefaultServiceThreads = 2;
+    static const size_t kDefaultPreallocationStep = 16 * 1024 * 1024;
+    static const bigtime_t kDefaultSyncInterval = 2000000;
 };
 
 // Convenience macros
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm>
+#include <new>
 
 namespace VeniceDAW {
 
@@ -81,187 +82,301 @@ const size_t AudioBufferPool::kCommonSizes[] = {
 };
 const size_t AudioBufferPool::kCommonSizeCount = sizeof(kCommonSizes) / sizeof(kCommonSizes[0]);
 
+const size_t AudioBufferPool::kMinClassSamples;
+const uint32 AudioBufferPool::kSizeClassCount;
+const uint32 AudioBufferPool::kMaxBuffersPerClass;
+const size_t AudioBufferPool::kBlockAlignment;
+
 // Global pool singleton
 AudioBufferPool* AudioBufferPool::sGlobalPool = nullptr;
 sem_id AudioBufferPool::sGlobalPoolSemaphore = -1;
 
+namespace {
+
+// Sits in the kBlockAlignment bytes in front of every block
+struct BlockHeader {
+    uint32 sizeClass;
+    uint32 index;
+};
+
+const uint32 kOversizeClass = 0xffffffff;
+const uint64 kIndexMask = 0xffffffffULL;
+
+static_assert(sizeof(BlockHeader) <= AudioBufferPool::kBlockAlignment,
+              "block header must fit in the alignment padding");
+
+inline BlockHeader* HeaderOf(float* data)
+{
+    return reinterpret_cast<BlockHeader*>(
+        reinterpret_cast<char*>(data) - AudioBufferPool::kBlockAlignment);
+}
+
+}
+
 AudioBufferPool::AudioBufferPool()
-    : fPoolSemaphore(-1)
-    , fTotalBuffers(0)
-    , fAllocatedBuffers(0)
+    : fOversizeLive(0)
+    , fOversizeCount(0)
     , fAllocationCount(0)
-    , fHitCount(0)
-    , fMissCount(0)
 {
-    // Create semaphore for thread safety
-    fPoolSemaphore = create_sem(1, "AudioBufferPool");
-    if (fPoolSemaphore < B_OK) {
-        POOL_LOG_ERROR("Failed to create semaphore");
+    for (uint32 c = 0; c < kSizeClassCount; c++) {
+        SizeClass& sizeClass = fClasses[c];
+        sizeClass.freeHead.store(0);
+        sizeClass.spareHead.store(0);
+        sizeClass.created.store(0);
+        sizeClass.liveBuffers.store(0);
+        sizeClass.inUse.store(0);
+        sizeClass.hitCount.store(0);
+        sizeClass.missCount.store(0);
+        for (uint32 i = 0; i < kMaxBuffersPerClass; i++) {
+            sizeClass.nodes[i].data = nullptr;
+            sizeClass.nodes[i].next.store(0);
+        }
     }
 
-    POOL_LOG_INFO("Created with %zu common buffer sizes", kCommonSizeCount);
+    POOL_LOG_INFO("Created with %u size classes of up to %zu samples",
+                  kSizeClassCount, ClassSamples(kSizeClassCount - 1));
 }
 
 AudioBufferPool::~AudioBufferPool()
 {
     Cleanup();
 
-    if (fPoolSemaphore >= 0) {
-        delete_sem(fPoolSemaphore);
-    }
-
     POOL_LOG_INFO("Destroyed");
 }
 
-AudioBuffer AudioBufferPool::GetBuffer(size_t frames, uint32 channels)
+int32 AudioBufferPool::ClassForSamples(size_t samples)
 {
-    if (fPoolSemaphore < 0) {
-        // Emergency fallback - direct allocation
-        float* data = (float*)malloc(frames * channels * sizeof(float));
-        if (data) {
-            fMissCount++;
-            memset(data, 0, frames * channels * sizeof(float));
-            return AudioBuffer(data, frames, channels, nullptr); // No pool cleanup
+    int32 sizeClass = 0;
+    size_t classSamples = kMinClassSamples;
+    while (classSamples < samples) {
+        classSamples <<= 1;
+        if (++sizeClass >= (int32)kSizeClassCount) {
+            return -1;
         }
-        return AudioBuffer(); // Invalid buffer
     }
+    return sizeClass;
+}
 
-    // Thread-safe buffer search
-    if (acquire_sem(fPoolSemaphore) != B_OK) {
-        fMissCount++;
-        return AudioBuffer(); // Invalid buffer
-    }
+bool AudioBufferPool::Pop(std::atomic<uint64>& head, Node* nodes, uint32& index)
+{
+    uint64 top = head.load(std::memory_order_acquire);
+    for (;;) {
+        uint32 slot = (uint32)(top & kIndexMask);
+        if (slot == 0) {
+            return false;
+        }
 
-    BufferEntry* entry = FindAvailableBuffer(frames, channels);
+        // The tag moves on with every change, so a node popped and pushed
+        // back between the load and the swap fails the swap
+        uint64 next = nodes[slot - 1].next.load(std::memory_order_relaxed);
+        uint64 replacement = (((top >> 32) + 1) << 32) | next;
+        if (head.compare_exchange_weak(top, replacement, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            index = slot - 1;
+            return true;
+        }
+    }
+}
 
-    if (!entry) {
-        // No suitable buffer found, create new one
-        entry = CreateNewBuffer(frames, channels);
-        if (entry) {
-            fMissCount++;
+void AudioBufferPool::Push(std::atomic<uint64>& head, Node* nodes, uint32 index)
+{
+    uint64 top = head.load(std::memory_order_relaxed);
+    for (;;) {
+        nodes[index].next.store((uint32)(top & kIndexMask), std::memory_order_relaxed);
+        uint64 replacement = (((top >> 32) + 1) << 32) | (index + 1);
+        if (head.compare_exchange_weak(top, replacement, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+            return;
         }
-    } else {
-        fHitCount++;
     }
+}
 
-    AudioBuffer result;
-    if (entry) {
-        entry->inUse = true;
-        entry->lastUsed = system_time();
-        fAllocatedBuffers++;
+float* AudioBufferPool::AllocateBlock(size_t samples, uint32 sizeClass, uint32 index)
+{
+    // Whole cache lines, with the header in a line of its own in front
+    size_t bytes = (samples * sizeof(float) + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+    void* block = nullptr;
+    if (posix_memalign(&block, kBlockAlignment, kBlockAlignment + bytes) != 0) {
+        POOL_LOG_ERROR("Failed to allocate %zu bytes for %zu samples", bytes, samples);
+        return nullptr;
+    }
+    fAllocationCount.fetch_add(1, std::memory_order_relaxed);
 
-        // Clear buffer before returning
-        memset(entry->data, 0, frames * channels * sizeof(float));
+    float* data = reinterpret_cast<float*>(static_cast<char*>(block) + kBlockAlignment);
+    BlockHeader* header = HeaderOf(data);
+    header->sizeClass = sizeClass;
+    header->index = index;
+    return data;
+}
 
-        result = AudioBuffer(entry->data, frames, channels, this);
-    }
+void AudioBufferPool::FreeBlock(float* data)
+{
+    free(reinterpret_cast<char*>(data) - kBlockAlignment);
+}
 
-    release_sem(fPoolSemaphore);
+bool AudioBufferPool::CreateBuffer(uint32 sizeClass, uint32& index)
+{
+    SizeClass& entry = fClasses[sizeClass];
+
+    // A node Cleanup() emptied, or a new one
+    if (!Pop(entry.spareHead, entry.nodes, index)) {
+        uint32 created = entry.created.load(std::memory_order_relaxed);
+        do {
+            if (created >= kMaxBuffersPerClass) {
+                return false;
+            }
+        } while (!entry.created.compare_exchange_weak(created, created + 1,
+                                                      std::memory_order_relaxed));
+        index = created;
+    }
 
-    if (!result.IsValid()) {
-        fMissCount++;
+    float* data = AllocateBlock(ClassSamples(sizeClass), sizeClass, index);
+    if (!data) {
+        Push(entry.spareHead, entry.nodes, index);
+        return false;
     }
 
-    return result;
+    entry.nodes[index].data = data;
+    entry.liveBuffers.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-void AudioBufferPool::ReturnBuffer(float* data, size_t frames, uint32 channels)
+AudioBuffer AudioBufferPool::GetBuffer(size_t frames, uint32 channels)
 {
-    if (!data || fPoolSemaphore < 0) {
-        // Direct free for emergency allocations
-        if (data) {
-            free(data);
+    size_t samples = frames * channels;
+    int32 sizeClass = ClassForSamples(samples);
+
+    float* data = nullptr;
+    if (sizeClass < 0) {
+        // Larger than any class: allocated for this request only
+        data = AllocateBlock(samples, kOversizeClass, 0);
+        if (!data) {
+            return AudioBuffer();
         }
-        return;
+        fOversizeLive.fetch_add(1, std::memory_order_relaxed);
+        fOversizeCount.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        SizeClass& entry = fClasses[sizeClass];
+        uint32 index;
+        if (Pop(entry.freeHead, entry.nodes, index)) {
+            entry.hitCount.fetch_add(1, std::memory_order_relaxed);
+        } else if (CreateBuffer(sizeClass, index)) {
+            entry.missCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // Class full: the caller waits for buffers to come back
+            entry.missCount.fetch_add(1, std::memory_order_relaxed);
+            return AudioBuffer();
+        }
+        entry.inUse.fetch_add(1, std::memory_order_relaxed);
+        data = entry.nodes[index].data;
     }
 
-    if (acquire_sem(fPoolSemaphore) != B_OK) {
-        return;
-    }
+    // Clear buffer before returning
+    memset(data, 0, samples * sizeof(float));
 
-    // Find buffer entry and mark as available
-    for (auto& entry : fBuffers) {
-        if (entry.data == data && entry.frames == frames && entry.channels == channels) {
-            if (entry.inUse) {
-                entry.inUse = false;
-                entry.lastUsed = system_time();
-                fAllocatedBuffers--;
-            }
-            break;
-        }
+    return AudioBuffer(data, frames, channels, this);
+}
+
+void AudioBufferPool::ReturnBuffer(float* data, size_t, uint32)
+{
+    if (!data) {
+        return;
     }
 
-    // Periodically clean up old buffers
-    static bigtime_t lastCleanup = 0;
-    bigtime_t now = system_time();
-    if (now - lastCleanup > 5000000) { // Every 5 seconds
-        CleanupOldBuffers();
-        lastCleanup = now;
+    // The header names the buffer's class and node, whatever size was
+    // asked for
+    BlockHeader* header = HeaderOf(data);
+    if (header->sizeClass == kOversizeClass) {
+        FreeBlock(data);
+        fOversizeLive.fetch_sub(1, std::memory_order_relaxed);
+        return;
     }
 
-    release_sem(fPoolSemaphore);
+    SizeClass& entry = fClasses[header->sizeClass];
+    entry.inUse.fetch_sub(1, std::memory_order_relaxed);
+    Push(entry.freeHead, entry.nodes, header->index);
 }
 
 void AudioBufferPool::Warmup()
 {
     POOL_LOG_INFO("Warming up with common buffer sizes...");
 
-    if (acquire_sem(fPoolSemaphore) != B_OK) {
-        return;
-    }
-
-    // Pre-allocate common buffer sizes
+    // Mono and stereo buffers of each common size; sizes that share a
+    // class add up
     for (size_t i = 0; i < kCommonSizeCount; i++) {
-        size_t frames = kCommonSizes[i];
-
-        // Create buffers for mono and stereo
         for (uint32 channels = 1; channels <= 2; channels++) {
-            for (uint32 j = 0; j < kMaxBuffersPerSize; j++) {
-                CreateNewBuffer(frames, channels);
+            int32 sizeClass = ClassForSamples(kCommonSizes[i] * channels);
+            for (uint32 j = 0; j < kWarmupBuffersPerSize; j++) {
+                uint32 index;
+                if (!CreateBuffer(sizeClass, index)) {
+                    break;
+                }
+                Push(fClasses[sizeClass].freeHead, fClasses[sizeClass].nodes, index);
             }
         }
     }
 
-    release_sem(fPoolSemaphore);
-
     PoolStats stats = GetStats();
     POOL_LOG_INFO("Warmed up with %u buffers", stats.totalBuffers);
 }
 
-void AudioBufferPool::Cleanup()
+void AudioBufferPool::Reserve(size_t frames, uint32 channels, uint32 count)
 {
-    if (fPoolSemaphore < 0) {
+    int32 sizeClass = ClassForSamples(frames * channels);
+    if (sizeClass < 0) {
+        POOL_LOG_WARNING("Cannot reserve %zu frames, %u channels: larger than any size class",
+                         frames, channels);
         return;
     }
 
-    if (acquire_sem(fPoolSemaphore) != B_OK) {
-        return;
+    SizeClass& entry = fClasses[sizeClass];
+    while (entry.liveBuffers.load(std::memory_order_relaxed) < count) {
+        uint32 index;
+        if (!CreateBuffer(sizeClass, index)) {
+            break;
+        }
+        Push(entry.freeHead, entry.nodes, index);
     }
+}
 
-    POOL_LOG_INFO("Cleaning up %zu buffers", fBuffers.size());
-
-    for (auto& entry : fBuffers) {
-        if (entry.data) {
-            free(entry.data);
+void AudioBufferPool::Cleanup()
+{
+    // Only free buffers are released; buffers in use come back to their
+    // class as usual and are freed by a later Cleanup()
+    uint32 freed = 0;
+    for (uint32 c = 0; c < kSizeClassCount; c++) {
+        SizeClass& entry = fClasses[c];
+        uint32 index;
+        while (Pop(entry.freeHead, entry.nodes, index)) {
+            FreeBlock(entry.nodes[index].data);
+            entry.nodes[index].data = nullptr;
+            entry.liveBuffers.fetch_sub(1, std::memory_order_relaxed);
+            Push(entry.spareHead, entry.nodes, index);
+            freed++;
         }
     }
-    fBuffers.clear();
-
-    fTotalBuffers = 0;
-    fAllocatedBuffers = 0;
 
-    release_sem(fPoolSemaphore);
+    POOL_LOG_INFO("Cleaned up %u buffers", freed);
 }
 
 AudioBufferPool::PoolStats AudioBufferPool::GetStats() const
 {
-    PoolStats stats;
-    stats.totalBuffers = fTotalBuffers.load();
-    stats.allocatedBuffers = fAllocatedBuffers.load();
-    stats.availableBuffers = stats.totalBuffers - stats.allocatedBuffers;
-    stats.allocationCount = fAllocationCount.load();
-    stats.hitCount = fHitCount.load();
-    stats.missCount = fMissCount.load();
+    PoolStats stats = {};
+    for (uint32 c = 0; c < kSizeClassCount; c++) {
+        const SizeClass& entry = fClasses[c];
+        stats.totalBuffers += entry.liveBuffers.load(std::memory_order_relaxed);
+        stats.allocatedBuffers += entry.inUse.load(std::memory_order_relaxed);
+        stats.hitCount += entry.hitCount.load(std::memory_order_relaxed);
+        stats.missCount += entry.missCount.load(std::memory_order_relaxed);
+    }
+
+    uint32 oversize = fOversizeLive.load(std::memory_order_relaxed);
+    stats.totalBuffers += oversize;
+    stats.allocatedBuffers += oversize;
+    stats.missCount += fOversizeCount.load(std::memory_order_relaxed);
+    stats.availableBuffers = stats.totalBuffers > stats.allocatedBuffers
+        ? stats.totalBuffers - stats.allocatedBuffers : 0;
+    stats.allocationCount = fAllocationCount.load(std::memory_order_relaxed);
     return stats;
 }
 
@@ -275,8 +390,14 @@ AudioBufferPool& AudioBufferPool::GetGlobalPool()
 
         if (sGlobalPoolSemaphore >= 0 && acquire_sem(sGlobalPoolSemaphore) == B_OK) {
             if (!sGlobalPool) {
-                sGlobalPool = new AudioBufferPool();
-                sGlobalPool->Warmup();
+                // Plain new only guarantees 16 bytes before C++17; the
+                // size classes must start on their own cache lines. The
+                // pool lives as long as the process and is never deleted.
+                void* memory = nullptr;
+                if (posix_memalign(&memory, alignof(AudioBufferPool), sizeof(AudioBufferPool)) == 0) {
+                    sGlobalPool = new (memory) AudioBufferPool();
+                    sGlobalPool->Warmup();
+                }
             }
             release_sem(sGlobalPoolSemaphore);
         }
@@ -285,70 +406,4 @@ AudioBufferPool& AudioBufferPool::GetGlobalPool()
     return *sGlobalPool;
 }
 
-AudioBufferPool::BufferEntry* AudioBufferPool::FindAvailableBuffer(size_t frames, uint32 channels)
-{
-    // Look for exact match first
-    for (auto& entry : fBuffers) {
-        if (!entry.inUse && entry.frames == frames && entry.channels == channels) {
-            return &entry;
-        }
-    }
-
-    // Look for larger buffer that can be used
-    for (auto& entry : fBuffers) {
-        if (!entry.inUse && entry.frames >= frames && entry.channels == channels) {
-            return &entry;
-        }
-    }
-
-    return nullptr;
-}
-
-AudioBufferPool::BufferEntry* AudioBufferPool::CreateNewBuffer(size_t frames, uint32 channels)
-{
-    // Check if we have too many buffers
-    if (fBuffers.size() >= kMaxBuffersPerSize * kCommonSizeCount * 2) {
-        return nullptr;
-    }
-
-    size_t sizeInBytes = frames * channels * sizeof(float);
-    float* data = (float*)malloc(sizeInBytes);
-
-    if (!data) {
-        POOL_LOG_ERROR("Failed to allocate %zu bytes for %zu frames, %u channels",
-               sizeInBytes, frames, channels);
-        return nullptr;
-    }
-
-    BufferEntry entry;
-    entry.data = data;
-    entry.frames = frames;
-    entry.channels = channels;
-    entry.inUse = false;
-    entry.lastUsed = system_time();
-
-    fBuffers.push_back(entry);
-    fTotalBuffers++;
-    fAllocationCount++;
-
-    return &fBuffers.back();
-}
-
-void AudioBufferPool::CleanupOldBuffers()
-{
-    bigtime_t now = system_time();
-    const bigtime_t maxAge = 30000000; // 30 seconds
-
-    auto it = fBuffers.begin();
-    while (it != fBuffers.end()) {
-        if (!it->inUse && (now - it->lastUsed) > maxAge) {
-            free(it->data);
-            it = fBuffers.erase(it);
-            fTotalBuffers--;
-        } else {
-            ++it;
-        }
-    }
-}
-
-} // namespace VeniceDAW
\ No newline at end of file
+} // namespace VeniceDAW
@@ -6,7 +6,11 @@
 #ifndef AUDIO_BUFFER_POOL_H
 #define AUDIO_BUFFER_POOL_H
 
+#ifdef __HAIKU__
 #include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
 #include <vector>
 #include <atomic>
 #include <string.h>
@@ -59,7 +63,20 @@ private:
 };
 
 /*
- * Thread-safe buffer pool for real-time audio processing
+ * Lock-free buffer pool for real-time audio processing
+ *
+ * Buffers come in power-of-two size classes of kMinClassSamples and up;
+ * each class keeps its free buffers on a Treiber stack whose head carries
+ * an ABA tag next to the node index, so GetBuffer() and ReturnBuffer() are
+ * a compare-and-swap each and safe on the audio thread. Blocks are 64-byte
+ * aligned, with a small header in front that names their class and node.
+ *
+ * Once a class has been warmed up (Warmup(), Reserve()) requests it can
+ * serve never allocate. A request that finds its class empty allocates a
+ * new buffer (a miss), up to kMaxBuffersPerClass per class; beyond that
+ * GetBuffer() returns an invalid buffer, which lets producers wait for
+ * consumers to hand buffers back. Requests larger than the largest class
+ * are allocated and freed directly.
  */
 class AudioBufferPool {
 public:
@@ -74,7 +91,8 @@ public:
 
     // Pool management
     void Warmup(); // Pre-allocate common buffer sizes
-    void Cleanup(); // Free all buffers
+    void Reserve(size_t frames, uint32 channels, uint32 count); // At least count buffers of a size
+    void Cleanup(); // Free all buffers not in use
 
     // Statistics
     struct PoolStats {
@@ -90,35 +108,49 @@ public:
     // Singleton access for global pool
     static AudioBufferPool& GetGlobalPool();
 
+    static const size_t kMinClassSamples = 256;
+    static const uint32 kSizeClassCount = 10;       // Up to 128K samples
+    static const uint32 kMaxBuffersPerClass = 64;
+    static const size_t kBlockAlignment = 64;
+
 private:
-    struct BufferEntry {
+    struct Node {
         float* data;
-        size_t frames;
-        uint32 channels;
-        bool inUse;
-        bigtime_t lastUsed;
+        std::atomic<uint32> next;   // Index + 1 of the node below, 0 at the bottom
+    };
+
+    // Stack heads: tag in the high 32 bits, top node index + 1 in the low
+    struct alignas(64) SizeClass {
+        std::atomic<uint64> freeHead;     // Buffers ready to hand out
+        std::atomic<uint64> spareHead;    // Nodes whose buffer Cleanup() freed
+        std::atomic<uint32> created;      // Nodes claimed so far
+        std::atomic<uint32> liveBuffers;
+        std::atomic<uint32> inUse;
+        std::atomic<uint32> hitCount;
+        std::atomic<uint32> missCount;
+        Node nodes[kMaxBuffersPerClass];
     };
 
-    // Thread-safe buffer management
-    mutable sem_id fPoolSemaphore;
-    std::vector<BufferEntry> fBuffers;
+    SizeClass fClasses[kSizeClassCount];
 
-    // Statistics (atomic for lock-free access)
-    mutable std::atomic<uint32> fTotalBuffers;
-    mutable std::atomic<uint32> fAllocatedBuffers;
-    mutable std::atomic<uint32> fAllocationCount;
-    mutable std::atomic<uint32> fHitCount;
-    mutable std::atomic<uint32> fMissCount;
+    // Requests above the largest class
+    std::atomic<uint32> fOversizeLive;
+    std::atomic<uint32> fOversizeCount;
+    std::atomic<uint32> fAllocationCount;
 
     // Common buffer sizes for pre-allocation
     static const size_t kCommonSizes[];
     static const size_t kCommonSizeCount;
-    static const uint32 kMaxBuffersPerSize = 8;
+    static const uint32 kWarmupBuffersPerSize = 8;
 
     // Internal methods
-    BufferEntry* FindAvailableBuffer(size_t frames, uint32 channels);
-    BufferEntry* CreateNewBuffer(size_t frames, uint32 channels);
-    void CleanupOldBuffers();
+    static int32 ClassForSamples(size_t samples);
+    static size_t ClassSamples(uint32 sizeClass) { return kMinClassSamples << sizeClass; }
+    static bool Pop(std::atomic<uint64>& head, Node* nodes, uint32& index);
+    static void Push(std::atomic<uint64>& head, Node* nodes, uint32 index);
+    float* AllocateBlock(size_t samples, uint32 sizeClass, uint32 index);
+    static void FreeBlock(float* data);
+    bool CreateBuffer(uint32 sizeClass, uint32& index);
 
     // Static instance for singleton
     static AudioBufferPool* sGlobalPool;
@@ -5,6 +5,10 @@
 #include "AudioFileStreamer.h"
 #include "AudioBufferPool.h"
 #include "MemoryMonitor.h"
+#include "PolyphaseResampler.h"
+#include "SampleConversion.h"
+#include <algorithm>
+#include <thread>
 #include <stdio.h>
 #include <string.h>
 #include <Path.h>
@@ -21,19 +25,36 @@ AudioFileStreamer::AudioFileStreamer()
     , fReadPos(0)
     , fWritePos(0)
     , fPlaybackFrame(0)
-    , fIOThread(-1)
-    , fIOThreadRunning(false)
-    , fWakeupSemaphore(-1)
+    , fService(&::VeniceDAW::StreamingService::GetInstance())
+    , fChunkFrames(READ_CHUNK_FRAMES)
+    , fPendingSeek(-1)
+    , fReaderActive(false)
+    , fTrackFrame(0)
+    , fSkipFrames(0)
+    , fAnchors(nullptr)
+    , fPrerollRequest(-1)
+    , fPrerollPos(0)
+    , fAnchorBytes(0)
     , fUnderrunOccurred(false)
+    , fUnderrunCount(0)
     , fLoopEnabled(true)
     , fBufferPool(nullptr)
+    , fResampler(nullptr)
+    , fResampleInput(nullptr)
+    , fOutputSampleRate(0.0f)
 {
     // Allocate ring buffer (4 seconds @ 44.1kHz stereo = ~353KB)
     fRingBuffer = new float[RING_BUFFER_SAMPLES];
     memset(fRingBuffer, 0, RING_BUFFER_SAMPLES * sizeof(float));
 
-    // Create semaphore for I/O thread wakeup
-    fWakeupSemaphore = create_sem(0, "AudioFileStreamer wakeup");
+    // Resampler for files whose rate differs from the output rate
+    fResampler = new ::VeniceDAW::DSP::PolyphaseResampler(RING_BUFFER_CHANNELS,
+        ::VeniceDAW::DSP::PolyphaseResampler::QUALITY_BALANCED, RESAMPLE_BLOCK_FRAMES);
+    fResampleInput = new float[RESAMPLE_BLOCK_FRAMES * RING_BUFFER_CHANNELS];
+
+    // Pre-roll blocks for instant locates, decoded by the service's readers
+    fAnchors = new ::VeniceDAW::SeekAnchorCache(RING_BUFFER_CHANNELS);
+    fPreroll.anchor = -1;
 
     // Get shared buffer pool instance
     fBufferPool = &::VeniceDAW::AudioBufferPool::GetGlobalPool();
@@ -55,17 +76,22 @@ AudioFileStreamer::~AudioFileStreamer()
     // Unregister from memory monitor
     size_t ringBufferBytes = RING_BUFFER_SAMPLES * sizeof(float);
     MemoryMonitor::GetInstance().UnregisterComponent("AudioFileStreamer RingBuffer", ringBufferBytes);
-
-    // Cleanup semaphore
-    if (fWakeupSemaphore >= 0) {
-        delete_sem(fWakeupSemaphore);
-        fWakeupSemaphore = -1;
+    if (fAnchorBytes > 0) {
+        MemoryMonitor::GetInstance().UnregisterComponent("AudioFileStreamer AnchorCache", fAnchorBytes);
     }
 
     // Free ring buffer
     delete[] fRingBuffer;
     fRingBuffer = nullptr;
 
+    delete fResampler;
+    fResampler = nullptr;
+    delete[] fResampleInput;
+    fResampleInput = nullptr;
+
+    delete fAnchors;
+    fAnchors = nullptr;
+
     printf("AudioFileStreamer: Destroyed\n");
 }
 
@@ -131,6 +157,13 @@ status_t AudioFileStreamer::OpenFile(const entry_ref& ref)
     // Store file info
     fFileSampleRate = rawFormat.frame_rate;
     fFileDuration = fMediaTrack->CountFrames();
+    fChunkFrames = std::max((size_t)READ_CHUNK_FRAMES,
+                            rawFormat.buffer_size / (sizeof(float) * RING_BUFFER_CHANNELS));
+
+    if (fOutputSampleRate > 0.0f) {
+        fResampler->SetRates(fFileSampleRate, fOutputSampleRate);
+    }
+    fResampler->Reset();
 
     BPath filePath(&ref);
     fFilePath.SetTo(filePath.Path());
@@ -140,23 +173,16 @@ status_t AudioFileStreamer::OpenFile(const entry_ref& ref)
     fWritePos = 0;
     fPlaybackFrame = 0;
     fUnderrunOccurred = false;
+    fUnderrunCount = 0;
 
-    // Start I/O thread
-    fIOThreadRunning = true;
-    fIOThread = spawn_thread(_IOThreadEntry, "AudioFileStreamer I/O",
-                             IO_THREAD_PRIORITY, this);
-    if (fIOThread < 0) {
-        printf("AudioFileStreamer: Failed to spawn I/O thread\n");
-        fIOThreadRunning = false;
-        fMediaFile->ReleaseTrack(fMediaTrack);
-        fMediaTrack = nullptr;
-        delete fMediaFile;
-        fMediaFile = nullptr;
-        return B_ERROR;
-    }
+    // Start as a locate to frame 0, which also decodes the start anchor
+    fAnchors->Reset(fFileDuration);
+    fPendingSeek = 0;
+    _PostPreroll(0);
 
-    resume_thread(fIOThread);
+    // The service's readers start filling the ring right away
     fFileOpen = true;
+    fService->Register(this);
 
     printf("AudioFileStreamer: File opened successfully\n");
     printf("  Duration: %lld frames (%.2f sec)\n", fFileDuration,
@@ -172,17 +198,9 @@ void AudioFileStreamer::CloseFile()
 
     printf("AudioFileStreamer: Closing file\n");
 
-    // Stop I/O thread
-    fIOThreadRunning = false;
-    if (fIOThread >= 0) {
-        // Wake up thread if sleeping
-        release_sem(fWakeupSemaphore);
-
-        // Wait for thread to finish
-        status_t exitValue;
-        wait_for_thread(fIOThread, &exitValue);
-        fIOThread = -1;
-    }
+    // Returns once no reader is using the track anymore
+    fService->Unregister(this);
+    _PostPreroll(-1);
 
     // Release media resources
     if (fMediaFile && fMediaTrack) {
@@ -200,6 +218,7 @@ void AudioFileStreamer::CloseFile()
     fReadPos = 0;
     fWritePos = 0;
     fPlaybackFrame = 0;
+    fPendingSeek = -1;
 }
 
 void AudioFileStreamer::SetPlaybackPosition(int64 frame)
@@ -210,14 +229,56 @@ void AudioFileStreamer::SetPlaybackPosition(int64 frame)
     if (frame < 0) frame = 0;
     if (frame >= fFileDuration) frame = fFileDuration - 1;
 
+    // Served from a cached anchor if there is one: the RT thread plays the
+    // anchor and the reader refills the ring from where the anchor ends.
+    // Otherwise GetAudioData() plays silence until the reader has sought
+    // and refilled the ring; it never touches the ring meanwhile.
+    ::VeniceDAW::SeekAnchorCache::Preroll preroll;
+    int64 request = 0;
+    int64 resumeFrame = frame;
+    if (fAnchors->Acquire(frame, &preroll)) {
+        request = ((int64)(preroll.anchor + 1) << 32) | preroll.offset;
+        resumeFrame = preroll.resumeFrame;
+    }
+
     fPlaybackFrame = frame;
 
-    // Invalidate ring buffer (force I/O thread to re-fill from new position)
-    fReadPos = 0;
-    fWritePos = 0;
+    // The seek is posted before the pre-roll, so an RT thread that sees the
+    // pre-roll also stays out of the ring
+    fPendingSeek = resumeFrame;
+    _PostPreroll(request);
+    fService->Wake();
+}
+
+status_t AudioFileStreamer::AddLocateAnchor(int64 frame)
+{
+    if (!fFileOpen) return B_NO_INIT;
+
+    status_t status = fAnchors->AddAnchor(frame);
+    if (status == B_OK) {
+        fService->Wake();
+    }
+    return status;
+}
+
+void AudioFileStreamer::RemoveLocateAnchor(int64 frame)
+{
+    fAnchors->RemoveAnchor(frame);
+}
+
+void AudioFileStreamer::ClearLocateAnchors()
+{
+    fAnchors->ClearPinnedAnchors();
+}
 
-    // Wake up I/O thread to start filling from new position
-    release_sem(fWakeupSemaphore);
+::VeniceDAW::SeekAnchorCache::Stats AudioFileStreamer::GetAnchorStats() const
+{
+    return fAnchors->GetStats();
+}
+
+bool AudioFileStreamer::GetStreamTelemetry(::VeniceDAW::StreamTelemetry* telemetry) const
+{
+    return fService->GetTelemetry(this, telemetry);
 }
 
 int32 AudioFileStreamer::GetBufferFillPercent() const
@@ -226,50 +287,103 @@ int32 AudioFileStreamer::GetBufferFillPercent() const
     return (int32)((available * 100) / RING_BUFFER_FRAMES);
 }
 
+void AudioFileStreamer::SetOutputSampleRate(float sampleRate)
+{
+    if (sampleRate == fOutputSampleRate) return;
+
+    fOutputSampleRate = sampleRate;
+    if (sampleRate > 0.0f) {
+        fResampler->SetRates(fFileSampleRate, sampleRate);
+    }
+}
+
 status_t AudioFileStreamer::GetAudioData(float* buffer, int32 frameCount)
 {
-    if (!fFileOpen || !buffer) {
-        // Fill with silence if file not open
+    if (!buffer) {
+        return B_BAD_VALUE;
+    }
+
+    // Tells a reader that is about to reset the ring for a seek to wait
+    fReaderActive = true;
+    if (!fFileOpen) {
+        fReaderActive = false;
+        memset(buffer, 0, frameCount * RING_BUFFER_CHANNELS * sizeof(float));
+        return B_OK;
+    }
+
+    // Pick up a locate; the resampler history belongs to the old position
+    int64 request = fPrerollRequest.exchange(-1);
+    if (request >= 0) {
+        _AdoptPreroll(request);
+    }
+
+    // While a seek is pending only the pre-roll is playable
+    bool seeking = fPendingSeek.load() >= 0;
+    int64 prerollFrames = fPreroll.anchor >= 0 ? fPreroll.frames - fPrerollPos : 0;
+    if (seeking && prerollFrames == 0) {
+        // Silence while a seek without pre-roll is being served
+        fReaderActive = false;
         memset(buffer, 0, frameCount * RING_BUFFER_CHANNELS * sizeof(float));
         return B_OK;
     }
 
-    int64 availableFrames = _GetAvailableFrames();
+    // File frames this call consumes
+    bool resample = _NeedsResampling();
+    int64 framesNeeded = resample
+        ? (int64)fResampler->GetInputFramesNeeded(frameCount) : frameCount;
+    int64 availableFrames = prerollFrames + (seeking ? 0 : _GetAvailableFrames());
 
     // Check for underrun
-    if (availableFrames < frameCount) {
+    if (availableFrames < framesNeeded) {
         if (!fUnderrunOccurred) {
-            printf("AudioFileStreamer: WARNING - Buffer underrun! Available: %lld, Requested: %d\n",
-                   availableFrames, (int)frameCount);
+            printf("AudioFileStreamer: WARNING - Buffer underrun! Available: %lld, Requested: %lld\n",
+                   availableFrames, framesNeeded);
             fUnderrunOccurred = true;
         }
+        fUnderrunCount++;
+        fReaderActive = false;
 
         // Fill with silence for underrun
         memset(buffer, 0, frameCount * RING_BUFFER_CHANNELS * sizeof(float));
 
-        // Wake up I/O thread to refill buffer urgently
-        release_sem(fWakeupSemaphore);
+        // This stream is now the most urgent one
+        fService->Wake();
         return B_OK;
     }
 
-    // RT-safe read from ring buffer (lock-free)
-    int64 readPos = fReadPos.load();
-
-    for (int32 i = 0; i < frameCount; i++) {
-        int64 ringPos = (readPos + i) % RING_BUFFER_FRAMES;
-        int64 sampleIndex = ringPos * RING_BUFFER_CHANNELS;
-
-        buffer[i * RING_BUFFER_CHANNELS] = fRingBuffer[sampleIndex];
-        buffer[i * RING_BUFFER_CHANNELS + 1] = fRingBuffer[sampleIndex + 1];
+    if (!resample) {
+        // RT-safe read from pre-roll and ring buffer (lock-free)
+        _ReadPlayable(buffer, frameCount);
+    } else {
+        // Pull file frames through the resampler in bounded blocks
+        int32 produced = 0;
+        while (produced < frameCount) {
+            size_t wanted = frameCount - produced;
+            int64 needed = std::min(fResampler->GetInputFramesNeeded(wanted),
+                                    std::min(fResampler->GetInputCapacity(), RESAMPLE_BLOCK_FRAMES));
+            needed = std::min(needed, availableFrames);
+            _ReadPlayable(fResampleInput, needed);
+            availableFrames -= needed;
+
+            size_t taken = needed;
+            size_t count = fResampler->Process(fResampleInput, taken,
+                buffer + produced * RING_BUFFER_CHANNELS, wanted);
+            if (count == 0 && needed == 0) {
+                // Ring ran dry mid-block
+                memset(buffer + produced * RING_BUFFER_CHANNELS, 0,
+                       wanted * RING_BUFFER_CHANNELS * sizeof(float));
+                break;
+            }
+            produced += count;
+        }
     }
 
-    // Update read position atomically
-    fReadPos = (readPos + frameCount) % RING_BUFFER_FRAMES;
+    fReaderActive = false;
 
-    // Wake up I/O thread if buffer is getting low (<25% full)
+    // Wake up the readers if the buffer is getting low (<25% full)
     int64 newAvailable = _GetAvailableFrames();
     if (newAvailable < (RING_BUFFER_FRAMES / 4)) {
-        release_sem(fWakeupSemaphore);
+        fService->Wake();
     }
 
     return B_OK;
@@ -277,31 +391,86 @@ status_t AudioFileStreamer::GetAudioData(float* buffer, int32 frameCount)
 
 // Private methods
 
-int32 AudioFileStreamer::_IOThreadEntry(void* data)
+double AudioFileStreamer::BufferedSeconds() const
 {
-    AudioFileStreamer* streamer = static_cast<AudioFileStreamer*>(data);
-    streamer->_IOThreadFunc();
-    return 0;
+    // A pending seek needs the reader before anything can play
+    if (fPendingSeek.load() >= 0) {
+        return 0.0;
+    }
+    return _GetAvailableFrames() / (double)fFileSampleRate;
 }
 
-void AudioFileStreamer::_IOThreadFunc()
+int64 AudioFileStreamer::FreeFrames() const
 {
-    printf("AudioFileStreamer: I/O thread started\n");
+    // The whole ring is flushed when a seek is served
+    if (fPendingSeek.load() >= 0) {
+        return RING_BUFFER_FRAMES - 1;
+    }
+    return _GetFreeFrames();
+}
 
-    while (fIOThreadRunning) {
-        // Check if buffer needs filling
-        int64 freeFrames = _GetFreeFrames();
+int64 AudioFileStreamer::ServiceRead(int64 maxFrames)
+{
+    if (!fMediaTrack) return 0;
 
-        if (freeFrames >= READ_CHUNK_FRAMES) {
-            // Buffer has space - fill it
-            _FillRingBuffer();
-        } else {
-            // Buffer is full - sleep until woken up or timeout
-            acquire_sem_etc(fWakeupSemaphore, 1, B_RELATIVE_TIMEOUT, 100000);  // 100ms timeout
+    int64 framesRead = 0;
+    int64 seekFrame = fPendingSeek.load();
+    if (seekFrame >= 0) {
+        // GetAudioData() stays out of the ring while a seek is pending;
+        // wait for a call that started before the seek to finish
+        while (fReaderActive.load()) {
+            std::this_thread::yield();
+        }
+        fReadPos = 0;
+        fWritePos = 0;
+
+        // A pre-roll that runs to the end of the file resumes at the start
+        int64 frame = seekFrame;
+        if (frame >= fFileDuration && fLoopEnabled) {
+            frame = 0;
         }
+
+        if (frame < fFileDuration && _SeekTrack(frame)) {
+            // A locate that missed the cache, or a pending anchor, is kept
+            // as it streams by
+            int32 capture = fAnchors->BeginCapture(frame);
+            framesRead = _FillRingBuffer(std::max(maxFrames,
+                ::VeniceDAW::SeekAnchorCache::kAnchorFrames), capture);
+            if (capture >= 0) {
+                fAnchors->EndCapture(capture);
+            }
+        }
+
+        // Release playback, unless a newer seek came in meanwhile
+        fPendingSeek.compare_exchange_strong(seekFrame, -1);
+    } else {
+        framesRead = _FillRingBuffer(maxFrames, -1);
     }
 
-    printf("AudioFileStreamer: I/O thread stopped\n");
+    // Loop points and markers are decoded once the stream is safe
+    int64 anchorFrame;
+    if (BufferedSeconds() >= ::VeniceDAW::StreamingService::kUrgentSeconds
+        && fAnchors->NextPending(&anchorFrame)) {
+        framesRead += _DecodeAnchor(anchorFrame);
+    }
+
+    size_t anchorBytes = fAnchors->GetStats().memoryBytes;
+    if (anchorBytes != fAnchorBytes) {
+        MemoryMonitor& monitor = MemoryMonitor::GetInstance();
+        if (fAnchorBytes > 0) {
+            monitor.UnregisterComponent("AudioFileStreamer AnchorCache", fAnchorBytes);
+        }
+        monitor.RegisterComponent("AudioFileStreamer AnchorCache", anchorBytes);
+        fAnchorBytes = anchorBytes;
+    }
+
+    return framesRead;
+}
+
+bool AudioFileStreamer::HasPendingWork() const
+{
+    return fFileOpen && BufferedSeconds() >= ::VeniceDAW::StreamingService::kUrgentSeconds
+           && fAnchors->HasPending();
 }
 
 int64 AudioFileStreamer::_GetAvailableFrames() const
@@ -322,62 +491,191 @@ int64 AudioFileStreamer::_GetFreeFrames() const
     return RING_BUFFER_FRAMES - _GetAvailableFrames() - 1;  // -1 to avoid read==write ambiguity
 }
 
-void AudioFileStreamer::_FillRingBuffer()
+void AudioFileStreamer::_ReadRingBuffer(float* dest, int64 frameCount)
 {
-    if (!fMediaTrack || !fBufferPool) return;
+    int64 readPos = fReadPos.load();
+
+    // At most two contiguous runs: up to the end of the ring, then from its
+    // start. Update read position atomically
+    fReadPos = (int64)::VeniceDAW::DSP::SampleConversion::ReadRing(fRingBuffer,
+        RING_BUFFER_FRAMES, readPos, dest, frameCount, RING_BUFFER_CHANNELS * sizeof(float));
+}
 
-    // Calculate how many frames to read
-    int64 freeFrames = _GetFreeFrames();
-    if (freeFrames < READ_CHUNK_FRAMES) return;
+bool AudioFileStreamer::_NeedsResampling() const
+{
+    return fOutputSampleRate > 0.0f && fOutputSampleRate != fFileSampleRate;
+}
 
-    int32 framesToRead = READ_CHUNK_FRAMES;
+void AudioFileStreamer::_WriteRingBuffer(const float* source, int64 frameCount)
+{
     int64 writePos = fWritePos.load();
 
-    // Get buffer from shared pool (eliminates allocation)
-    ::VeniceDAW::AudioBuffer buffer = fBufferPool->GetBuffer(framesToRead, RING_BUFFER_CHANNELS);
+    // At most two contiguous runs, like _ReadRingBuffer(). Publish the
+    // frames atomically
+    fWritePos = (int64)::VeniceDAW::DSP::SampleConversion::WriteRing(fRingBuffer,
+        RING_BUFFER_FRAMES, writePos, source, frameCount, RING_BUFFER_CHANNELS * sizeof(float));
+}
+
+int64 AudioFileStreamer::_FillRingBuffer(int64 maxFrames, int32 captureAnchor)
+{
+    if (!fMediaTrack || !fBufferPool) return 0;
+
+    // One decoded chunk at a time, as many as fit: a single coalesced
+    // read instead of a wakeup per chunk
+    ::VeniceDAW::AudioBuffer buffer = fBufferPool->GetBuffer(fChunkFrames, RING_BUFFER_CHANNELS);
     if (!buffer.IsValid()) {
         printf("AudioFileStreamer: WARNING - Failed to acquire buffer from pool\n");
-        return;
+        return 0;
     }
 
     float* tempBuffer = buffer.Data();
+    int64 totalRead = 0;
+    bool rewound = false;
+    bool capturing = captureAnchor >= 0;
+
+    while (totalRead < maxFrames && _GetFreeFrames() >= (int64)fChunkFrames) {
+        // The track position is only trusted up to the end of the file
+        // (an anchor decode cannot always seek back to it)
+        int64 framesRead = 0;
+        status_t status = B_ERROR;
+        if (fTrackFrame < fFileDuration) {
+            media_header mh;
+            status = fMediaTrack->ReadFrames(tempBuffer, &framesRead, &mh);
+        }
 
-    // Read from BMediaTrack
-    int64 framesRead = 0;
-    media_header mh;
-    status_t status = fMediaTrack->ReadFrames(tempBuffer, &framesRead, &mh);
+        if (status != B_OK || framesRead <= 0) {
+            // End of file - loop back if enabled, once per call so an
+            // unreadable track cannot spin. An anchor ends here.
+            capturing = false;
+            if (!fLoopEnabled || rewound || !_SeekTrack(0)) {
+                break;
+            }
+            fPlaybackFrame = 0;
+            rewound = true;
+            continue;
+        }
 
-    if (status != B_OK || framesRead == 0) {
-        // End of file - loop back if enabled
-        if (fLoopEnabled) {
-            int64 newFrame = 0;
-            fMediaTrack->SeekToFrame(&newFrame);
-            fPlaybackFrame = newFrame;
+        framesRead = std::min(framesRead, (int64)fChunkFrames);
+        const float* chunk = _SkipFrames(tempBuffer, &framesRead);
+        if (framesRead == 0) {
+            continue;
+        }
 
-            // Try reading again from beginning
-            status = fMediaTrack->ReadFrames(tempBuffer, &framesRead, &mh);
+        _WriteRingBuffer(chunk, framesRead);
+        if (capturing) {
+            capturing = fAnchors->Capture(captureAnchor, chunk, framesRead);
         }
 
-        if (status != B_OK || framesRead == 0) {
-            // Buffer automatically returned to pool via RAII
-            return;
+        fTrackFrame += framesRead;
+        fPlaybackFrame = fTrackFrame;
+        totalRead += framesRead;
+        rewound = false;
+    }
+
+    // Buffer automatically returned to pool when 'buffer' goes out of scope (RAII)
+    return totalRead;
+}
+
+int64 AudioFileStreamer::_DecodeAnchor(int64 frame)
+{
+    int32 anchor = fAnchors->BeginCapture(frame);
+    if (anchor < 0) return 0;
+
+    ::VeniceDAW::AudioBuffer buffer = fBufferPool->GetBuffer(fChunkFrames, RING_BUFFER_CHANNELS);
+    int64 resumeFrame = fTrackFrame;
+    int64 decoded = 0;
+
+    // Decode away from the stream position, then return to it
+    if (buffer.IsValid() && _SeekTrack(frame)) {
+        float* tempBuffer = buffer.Data();
+        bool capturing = true;
+        while (capturing) {
+            int64 framesRead = 0;
+            media_header mh;
+            if (fMediaTrack->ReadFrames(tempBuffer, &framesRead, &mh) != B_OK || framesRead <= 0) {
+                break;
+            }
+            framesRead = std::min(framesRead, (int64)fChunkFrames);
+            const float* chunk = _SkipFrames(tempBuffer, &framesRead);
+            capturing = fAnchors->Capture(anchor, chunk, framesRead);
+            decoded += framesRead;
         }
     }
+    fAnchors->EndCapture(anchor);
 
-    // Copy data to ring buffer
-    for (int64 i = 0; i < framesRead; i++) {
-        int64 ringPos = (writePos + i) % RING_BUFFER_FRAMES;
-        int64 sampleIndex = ringPos * RING_BUFFER_CHANNELS;
+    _SeekTrack(resumeFrame);
+    return decoded;
+}
 
-        fRingBuffer[sampleIndex] = tempBuffer[i * RING_BUFFER_CHANNELS];
-        fRingBuffer[sampleIndex + 1] = tempBuffer[i * RING_BUFFER_CHANNELS + 1];
+bool AudioFileStreamer::_SeekTrack(int64 frame)
+{
+    // Codecs may only seek to a key frame before the target; the decoded
+    // frames up to the target are dropped again
+    int64 actual = frame;
+    if (fMediaTrack->SeekToFrame(&actual, B_MEDIA_SEEK_CLOSEST_BACKWARD) != B_OK) {
+        return false;
     }
 
-    // Update write position atomically
-    fWritePos = (writePos + framesRead) % RING_BUFFER_FRAMES;
-    fPlaybackFrame = fPlaybackFrame + framesRead;
+    fSkipFrames = actual < frame ? frame - actual : 0;
+    fTrackFrame = actual + fSkipFrames;
+    return true;
+}
 
-    // Buffer automatically returned to pool when 'buffer' goes out of scope (RAII)
+const float* AudioFileStreamer::_SkipFrames(const float* chunk, int64* frameCount)
+{
+    int64 skip = std::min(fSkipFrames, *frameCount);
+    fSkipFrames -= skip;
+    *frameCount -= skip;
+    return chunk + skip * RING_BUFFER_CHANNELS;
+}
+
+void AudioFileStreamer::_PostPreroll(int64 request)
+{
+    _ReleasePreroll(fPrerollRequest.exchange(request));
+}
+
+void AudioFileStreamer::_ReleasePreroll(int64 request)
+{
+    // Requests the RT thread never picked up still hold their anchor
+    if (request > 0) {
+        fAnchors->Release((int32)(request >> 32) - 1);
+    }
+}
+
+void AudioFileStreamer::_AdoptPreroll(int64 request)
+{
+    if (fPreroll.anchor >= 0) {
+        fAnchors->Release(fPreroll.anchor);
+        fPreroll.anchor = -1;
+    }
+
+    if (request > 0) {
+        fAnchors->GetHeld((int32)(request >> 32) - 1, request & 0xffffffff, &fPreroll);
+        fPrerollPos = 0;
+    }
+
+    fResampler->Reset();
+}
+
+void AudioFileStreamer::_ReadPlayable(float* dest, int64 frameCount)
+{
+    int64 fromPreroll = 0;
+    if (fPreroll.anchor >= 0) {
+        fromPreroll = std::min(frameCount, fPreroll.frames - fPrerollPos);
+        memcpy(dest, fPreroll.data + fPrerollPos * RING_BUFFER_CHANNELS,
+               fromPreroll * RING_BUFFER_CHANNELS * sizeof(float));
+        fPrerollPos += fromPreroll;
+
+        // Played out: the ring continues where the anchor ends
+        if (fPrerollPos >= fPreroll.frames) {
+            fAnchors->Release(fPreroll.anchor);
+            fPreroll.anchor = -1;
+        }
+    }
+
+    if (frameCount > fromPreroll) {
+        _ReadRingBuffer(dest + fromPreroll * RING_BUFFER_CHANNELS, frameCount - fromPreroll);
+    }
 }
 
 } // namespace HaikuDAW
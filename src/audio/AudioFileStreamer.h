@@ -12,10 +12,15 @@
 #include <support/String.h>
 #include <kernel/OS.h>
 #include <atomic>
+#include "SeekAnchorCache.h"
+#include "StreamingService.h"
 
 // Forward declarations to avoid circular includes
 namespace VeniceDAW {
     class AudioBufferPool;
+    namespace DSP {
+        class PolyphaseResampler;
+    }
 }
 
 namespace HaikuDAW {
@@ -25,13 +30,21 @@ namespace HaikuDAW {
  *
  * Architecture:
  * - Ring buffer holds 4 seconds of pre-loaded audio data
- * - Background I/O thread continuously reads ahead from BMediaTrack
+ * - The shared StreamingService reads ahead from BMediaTrack, serving the
+ *   stream with the least audio left first, in coalesced chunks
  * - RT audio thread reads from ring buffer (lock-free, <100μs latency)
  * - Atomic read/write pointers for thread synchronization
+ * - Ring holds frames at the file's own rate; GetAudioData() converts to
+ *   the output rate with a polyphase resampler when the two differ
+ * - Locates to the file start, a loop point or marker, or a recently used
+ *   position play at once from a cached pre-roll block (SeekAnchorCache)
+ *   while the ring is refilled from the end of that block
  *
- * Memory usage: ~350KB per track (4 sec @ 44.1kHz stereo float)
+ * Memory usage: ~350KB per track (4 sec @ 44.1kHz stereo float, less
+ * time for higher-rate files) plus ~40KB of resampler tables and 256KB
+ * per decoded anchor (at most 8)
  */
-class AudioFileStreamer {
+class AudioFileStreamer : public ::VeniceDAW::StreamClient {
 public:
     AudioFileStreamer();
     ~AudioFileStreamer();
@@ -50,24 +63,53 @@ public:
     void SetPlaybackPosition(int64 frame);
     int64 GetPlaybackPosition() const { return fPlaybackFrame.load(); }
 
-    // RT-safe audio data access
+    // Locate targets to keep decoded (loop points, markers); the start of
+    // the file always is. Decoded in the background.
+    status_t AddLocateAnchor(int64 frame);
+    void RemoveLocateAnchor(int64 frame);
+    void ClearLocateAnchors();
+    ::VeniceDAW::SeekAnchorCache::Stats GetAnchorStats() const;
+
+    // Rate GetAudioData() delivers; 0 (the default) means the file rate.
+    // Cheap when unchanged; a new rate redesigns the resampler filter
+    // in place without allocating.
+    void SetOutputSampleRate(float sampleRate);
+    float GetOutputSampleRate() const { return fOutputSampleRate; }
+
+    // RT-safe audio data access, frameCount frames at the output rate
     status_t GetAudioData(float* buffer, int32 frameCount);
 
     // Ring buffer status (for monitoring/debugging)
     int32 GetBufferFillPercent() const;
     bool IsUnderrun() const { return fUnderrunOccurred.load(); }
+    uint32 GetUnderrunCount() const { return fUnderrunCount.load(); }
+
+    // Fill, underruns and reads of this stream; false while no file is open
+    bool GetStreamTelemetry(::VeniceDAW::StreamTelemetry* telemetry) const;
+
+    // StreamClient, called by the streaming service
+    virtual double BufferedSeconds() const;
+    virtual int64 FreeFrames() const;
+    virtual int64 ServiceRead(int64 maxFrames);
+    virtual bool HasPendingWork() const;
+    virtual int32 FillPercent() const { return GetBufferFillPercent(); }
+    virtual uint32 Underruns() const { return GetUnderrunCount(); }
 
 private:
-    // Ring buffer configuration
+    // Ring buffer configuration (capacity in file frames; the sample rate
+    // only sizes it, frames are stored at whatever rate the file has)
     static constexpr size_t RING_BUFFER_SECONDS = 4;
     static constexpr size_t RING_BUFFER_SAMPLE_RATE = 44100;
     static constexpr size_t RING_BUFFER_CHANNELS = 2;
     static constexpr size_t RING_BUFFER_FRAMES = RING_BUFFER_SAMPLE_RATE * RING_BUFFER_SECONDS;
     static constexpr size_t RING_BUFFER_SAMPLES = RING_BUFFER_FRAMES * RING_BUFFER_CHANNELS;
 
-    // I/O thread configuration
-    static constexpr int32 IO_THREAD_PRIORITY = B_LOW_PRIORITY;  // Lower than RT audio
-    static constexpr size_t READ_CHUNK_FRAMES = 2048;  // Read 2048 frames at a time
+    // Smallest decode buffer; BMediaTrack may hand out larger chunks
+    static constexpr size_t READ_CHUNK_FRAMES = 2048;
+
+    // Sample rate conversion: file frames are pulled from the ring in
+    // blocks of at most this many
+    static constexpr size_t RESAMPLE_BLOCK_FRAMES = 512;
 
     // File state
     BMediaFile* fMediaFile;
@@ -84,24 +126,50 @@ private:
     std::atomic<int64> fWritePos;  // IO thread write position
     std::atomic<int64> fPlaybackFrame;  // Current playback position in file
 
-    // I/O thread
-    thread_id fIOThread;
-    std::atomic<bool> fIOThreadRunning;
-    sem_id fWakeupSemaphore;  // Wake up IO thread when buffer low
+    // Disk reads happen on the shared service's reader threads
+    ::VeniceDAW::StreamingService* fService;
+    size_t fChunkFrames;            // Largest chunk one ReadFrames() returns
+    std::atomic<int64> fPendingSeek;  // Frame to seek to, -1 if none
+    std::atomic<bool> fReaderActive;  // RT thread is inside GetAudioData()
+    int64 fTrackFrame;              // Reader only: next frame ReadFrames() returns
+    int64 fSkipFrames;              // Reader only: decoded frames to drop after a seek
+
+    // Seek pre-roll: a locate hands the RT thread a held anchor through
+    // fPrerollRequest (anchor + 1 in the high word, offset in the low one;
+    // 0 = locate without anchor, -1 = none)
+    ::VeniceDAW::SeekAnchorCache* fAnchors;
+    std::atomic<int64> fPrerollRequest;
+    ::VeniceDAW::SeekAnchorCache::Preroll fPreroll;  // RT thread only
+    int64 fPrerollPos;              // RT thread only
+    size_t fAnchorBytes;            // Registered with MemoryMonitor
 
     // Status tracking
     std::atomic<bool> fUnderrunOccurred;
+    std::atomic<uint32> fUnderrunCount;
     std::atomic<bool> fLoopEnabled;
 
     // Shared buffer pool (eliminates per-thread allocations)
     ::VeniceDAW::AudioBufferPool* fBufferPool;
 
+    // Output rate conversion (RT thread only, except OpenFile)
+    ::VeniceDAW::DSP::PolyphaseResampler* fResampler;
+    float* fResampleInput;
+    float fOutputSampleRate;
+
     // Private methods
-    static int32 _IOThreadEntry(void* data);
-    void _IOThreadFunc();
     int64 _GetAvailableFrames() const;
     int64 _GetFreeFrames() const;
-    void _FillRingBuffer();
+    int64 _FillRingBuffer(int64 maxFrames, int32 captureAnchor);
+    int64 _DecodeAnchor(int64 frame);
+    bool _SeekTrack(int64 frame);
+    const float* _SkipFrames(const float* chunk, int64* frameCount);
+    void _PostPreroll(int64 request);
+    void _ReleasePreroll(int64 request);
+    void _AdoptPreroll(int64 request);
+    void _ReadPlayable(float* dest, int64 frameCount);
+    void _WriteRingBuffer(const float* source, int64 frameCount);
+    void _ReadRingBuffer(float* dest, int64 frameCount);
+    bool _NeedsResampling() const;
 
     // Non-copyable
     AudioFileStreamer(const AudioFileStreamer&) = delete;
@@ -0,0 +1,549 @@
+/*
+ * AudioLoaderService.cpp - Background loading of audio files for playback and waveforms
+ */
+
+#include "AudioLoaderService.h"
+#include "CompressedSampleStore.h"
+#include "MappedPCMSource.h"
+#include "3dmix/3DMixFormat.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#ifdef __HAIKU__
+#include <Entry.h>
+#include <MediaFile.h>
+#include <MediaTrack.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace VeniceDAW {
+
+const int32 AudioLoaderService::kDefaultLoaderCount;
+const int32 AudioLoaderService::kMaxLoaderCount;
+const int64 AudioLoaderService::kChunkFrames;
+const int32 AudioLoaderService::kBackgroundPriority;
+const int32 AudioLoaderService::kVisiblePriority;
+const int32 AudioLoaderService::kPlayingPriority;
+
+namespace {
+
+void LowerCurrentThread(int32 index)
+{
+#ifdef __HAIKU__
+    char name[B_OS_NAME_LENGTH];
+    snprintf(name, sizeof(name), "VeniceDAW audio loader %d", (int)index);
+    rename_thread(find_thread(NULL), name);
+    set_thread_priority(find_thread(NULL), B_LOW_PRIORITY);
+#else
+    (void)index;
+    sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+#endif
+}
+
+#ifdef __HAIKU__
+
+// First audio track of a BMediaFile, decoded to stereo int16
+class MediaFileDecoder : public AudioDecoder {
+public:
+    MediaFileDecoder()
+        : fFile(nullptr), fTrack(nullptr), fBufferFrames(0), fBufferPosition(0)
+    {
+    }
+
+    ~MediaFileDecoder() override
+    {
+        if (fTrack) {
+            fFile->ReleaseTrack(fTrack);
+        }
+        delete fFile;
+    }
+
+    status_t Open(const char* path, float* sampleRate, int64* frames) override
+    {
+        entry_ref ref;
+        status_t status = get_ref_for_path(path, &ref);
+        if (status != B_OK) {
+            return status;
+        }
+
+        fFile = new BMediaFile(&ref);
+        status = fFile->InitCheck();
+        if (status != B_OK) {
+            return status;
+        }
+
+        for (int32 i = 0; i < fFile->CountTracks() && !fTrack; i++) {
+            BMediaTrack* track = fFile->TrackAt(i);
+            media_format format;
+            if (track && track->EncodedFormat(&format) == B_OK
+                && (format.type == B_MEDIA_RAW_AUDIO || format.type == B_MEDIA_ENCODED_AUDIO)) {
+                fTrack = track;
+            } else if (track) {
+                fFile->ReleaseTrack(track);
+            }
+        }
+        if (!fTrack) {
+            return B_BAD_TYPE;
+        }
+
+        media_format format;
+        format.type = B_MEDIA_RAW_AUDIO;
+        format.u.raw_audio = media_raw_audio_format::wildcard;
+        format.u.raw_audio.format = media_raw_audio_format::B_AUDIO_SHORT;
+        format.u.raw_audio.channel_count = 2;
+        status = fTrack->DecodedFormat(&format);
+        if (status != B_OK) {
+            return status;
+        }
+
+        *sampleRate = format.u.raw_audio.frame_rate;
+        *frames = fTrack->CountFrames();
+        if (*frames <= 0) {
+            return B_BAD_TYPE;
+        }
+
+        // ReadFrames() fills up to one decoder buffer
+        size_t bufferFrames = std::max<size_t>(8192, format.u.raw_audio.buffer_size / (2 * sizeof(int16_t)));
+        fBuffer.resize(bufferFrames * 2);
+        return B_OK;
+    }
+
+    int64 Decode(int16_t* frames, int64 maxFrames) override
+    {
+        int64 decoded = 0;
+        while (decoded < maxFrames) {
+            if (fBufferPosition == fBufferFrames) {
+                int64 count = 0;
+                if (fTrack->ReadFrames(fBuffer.data(), &count) != B_OK || count <= 0) {
+                    break;
+                }
+                fBufferFrames = count;
+                fBufferPosition = 0;
+            }
+
+            int64 take = std::min(maxFrames - decoded, fBufferFrames - fBufferPosition);
+            memcpy(frames + decoded * 2, fBuffer.data() + fBufferPosition * 2,
+                   take * 2 * sizeof(int16_t));
+            fBufferPosition += take;
+            decoded += take;
+        }
+        return decoded;
+    }
+
+private:
+    BMediaFile* fFile;
+    BMediaTrack* fTrack;
+    std::vector<int16_t> fBuffer;
+    int64 fBufferFrames;
+    int64 fBufferPosition;
+};
+
+#endif // __HAIKU__
+
+} // namespace
+
+// #pragma mark - AudioLoadHandle
+
+AudioLoadHandle::AudioLoadHandle(const char* path, const AudioFormat3DMix* rawFormat,
+                                 int32 priority, uint64 sequence)
+    : fPath(path),
+      fRawFormat(rawFormat ? new AudioFormat3DMix(*rawFormat) : nullptr),
+      fSequence(sequence),
+      fState(kQueued),
+      fPriority(priority),
+      fCancel(false),
+      fSampleRate(0.0f),
+      fFrames(0),
+      fFramesLoaded(0)
+{
+}
+
+AudioLoadHandle::~AudioLoadHandle()
+{
+}
+
+float AudioLoadHandle::GetProgress() const
+{
+    if (IsReady()) {
+        return 1.0f;
+    }
+    int64 frames = CountFrames();
+    return frames > 0 ? std::min(1.0f, (float)CountFramesLoaded() / frames) : 0.0f;
+}
+
+bool AudioLoadHandle::GetPeaks(int64 startFrame, int64 endFrame, float* outMin, float* outMax,
+                               float* outRMS) const
+{
+    // The pyramid no longer changes once the load is complete
+    if (IsReady()) {
+        return fPeaks.GetPeaks(startFrame, endFrame, outMin, outMax, outRMS);
+    }
+
+    std::lock_guard<std::mutex> lock(fPeakLock);
+    return fPeaks.GetPeaks(startFrame, endFrame, outMin, outMax, outRMS);
+}
+
+void AudioLoadHandle::Cancel()
+{
+    fCancel.store(true, std::memory_order_release);
+
+    int32 expected = kQueued;
+    fState.compare_exchange_strong(expected, kCancelled, std::memory_order_acq_rel);
+}
+
+// #pragma mark - AudioLoaderService
+
+AudioLoaderService& AudioLoaderService::GetInstance()
+{
+    static AudioLoaderService sInstance;
+    static bool sStarted = (sInstance.Start(), true);
+    (void)sStarted;
+    return sInstance;
+}
+
+AudioLoaderService::AudioLoaderService(int32 loaderCount)
+    : fLoaderCount(std::max(1, std::min(loaderCount, kMaxLoaderCount))),
+      fNextSequence(0),
+      fStopping(false),
+      fLoading(0),
+      fCompleted(0),
+      fFailed(0),
+      fCancelled(0),
+      fFramesLoaded(0)
+{
+#ifdef __HAIKU__
+    fDecoderFactory = []() { return std::unique_ptr<AudioDecoder>(new MediaFileDecoder()); };
+#endif
+}
+
+AudioLoaderService::~AudioLoaderService()
+{
+    Stop();
+}
+
+status_t AudioLoaderService::Start()
+{
+    if (!fThreads.empty()) {
+        return B_OK;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        fStopping = false;
+    }
+
+    try {
+        for (int32 i = 0; i < fLoaderCount; i++) {
+            fThreads.emplace_back(&AudioLoaderService::_LoaderLoop, this, i);
+        }
+    } catch (const std::system_error& error) {
+        printf("AudioLoaderService: Could not spawn loader %d: %s\n", (int)fThreads.size(),
+               error.what());
+        if (fThreads.empty()) {
+            return B_NO_MEMORY;
+        }
+    }
+
+    printf("AudioLoaderService: %d audio loaders started\n", (int)fThreads.size());
+    return B_OK;
+}
+
+void AudioLoaderService::Stop()
+{
+    CancelAll();
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        fStopping = true;
+    }
+    fCondition.notify_all();
+
+    for (std::thread& thread : fThreads) {
+        thread.join();
+    }
+    fThreads.clear();
+}
+
+void AudioLoaderService::SetDecoderFactory(const DecoderFactory& factory)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+    fDecoderFactory = factory;
+}
+
+std::shared_ptr<AudioLoadHandle> AudioLoaderService::Load(const char* path,
+                                                          const AudioFormat3DMix* rawFormat,
+                                                          int32 priority)
+{
+    if (!path) {
+        return nullptr;
+    }
+
+    std::shared_ptr<AudioLoadHandle> handle;
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+
+        std::weak_ptr<AudioLoadHandle>& known = fHandles[path];
+        handle = known.lock();
+        if (handle && handle->GetState() <= AudioLoadHandle::kReady
+            && !handle->IsCancelRequested()) {
+            if (priority > handle->GetPriority()) {
+                handle->SetPriority(priority);
+            }
+            return handle;
+        }
+
+        // New, or an earlier attempt failed or was cancelled: try again
+        handle.reset(new AudioLoadHandle(path, rawFormat, priority, fNextSequence++));
+        known = handle;
+        fQueue.push_back(handle);
+    }
+    fCondition.notify_one();
+    return handle;
+}
+
+void AudioLoaderService::CancelAll()
+{
+    std::lock_guard<std::mutex> lock(fLock);
+    for (auto& entry : fHandles) {
+        std::shared_ptr<AudioLoadHandle> handle = entry.second.lock();
+        if (handle && !handle->IsDone()) {
+            handle->Cancel();
+        }
+    }
+}
+
+AudioLoaderService::Stats AudioLoaderService::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    Stats stats;
+    stats.queued = 0;
+    for (const std::shared_ptr<AudioLoadHandle>& handle : fQueue) {
+        if (handle->GetState() == AudioLoadHandle::kQueued) {
+            stats.queued++;
+        }
+    }
+    stats.loading = fLoading;
+    stats.completed = fCompleted;
+    stats.failed = fFailed;
+    stats.cancelled = fCancelled;
+    stats.framesLoaded = fFramesLoaded.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Called with fLock held
+std::shared_ptr<AudioLoadHandle> AudioLoaderService::_PickNext()
+{
+    // Drop what was cancelled while queued, or what nobody waits for any more
+    for (size_t i = 0; i < fQueue.size();) {
+        AudioLoadHandle& handle = *fQueue[i];
+        if (handle.GetState() != AudioLoadHandle::kQueued || fQueue[i].use_count() == 1) {
+            handle.fState.store(AudioLoadHandle::kCancelled, std::memory_order_release);
+            fCancelled++;
+            fQueue.erase(fQueue.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    // Highest priority, then oldest request
+    size_t best = fQueue.size();
+    for (size_t i = 0; i < fQueue.size(); i++) {
+        if (best == fQueue.size()) {
+            best = i;
+            continue;
+        }
+        int32 priority = fQueue[i]->GetPriority();
+        int32 bestPriority = fQueue[best]->GetPriority();
+        if (priority > bestPriority
+            || (priority == bestPriority && fQueue[i]->fSequence < fQueue[best]->fSequence)) {
+            best = i;
+        }
+    }
+    if (best == fQueue.size()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<AudioLoadHandle> handle = fQueue[best];
+    fQueue.erase(fQueue.begin() + best);
+
+    int32 expected = AudioLoadHandle::kQueued;
+    if (!handle->fState.compare_exchange_strong(expected, AudioLoadHandle::kLoading,
+                                                std::memory_order_acq_rel)) {
+        fCancelled++;
+        return _PickNext();
+    }
+    return handle;
+}
+
+void AudioLoaderService::_LoaderLoop(int32 index)
+{
+    LowerCurrentThread(index);
+
+    std::unique_lock<std::mutex> lock(fLock);
+
+    while (!fStopping) {
+        std::shared_ptr<AudioLoadHandle> handle = _PickNext();
+        if (!handle) {
+            fCondition.wait(lock, [this]() { return fStopping || !fQueue.empty(); });
+            continue;
+        }
+
+        fLoading++;
+        lock.unlock();
+
+        AudioLoadHandle::State state = _Load(*handle);
+
+        // Publishes the source, store and finished pyramid
+        handle->fState.store(state, std::memory_order_release);
+
+        if (state == AudioLoadHandle::kReady) {
+            printf("AudioLoaderService: Loaded '%s' (%lld frames at %.0f Hz)\n",
+                   handle->GetPath(), (long long)handle->CountFrames(),
+                   handle->GetSampleRate());
+        } else if (state == AudioLoadHandle::kFailed) {
+            printf("AudioLoaderService: Could not load '%s'\n", handle->GetPath());
+        }
+
+        lock.lock();
+        fLoading--;
+        if (state == AudioLoadHandle::kReady) {
+            fCompleted++;
+        } else if (state == AudioLoadHandle::kFailed) {
+            fFailed++;
+        } else {
+            fCancelled++;
+        }
+    }
+}
+
+AudioLoadHandle::State AudioLoaderService::_Load(AudioLoadHandle& handle)
+{
+    // Uncompressed WAV/AIFF is mapped, not decoded
+    std::shared_ptr<MappedPCMSource> source = std::make_shared<MappedPCMSource>();
+    if (source->Open(handle.GetPath(), nullptr) == B_OK) {
+        return _LoadMapped(handle, source);
+    }
+
+    DecoderFactory factory;
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        factory = fDecoderFactory;
+    }
+    if (factory) {
+        std::unique_ptr<AudioDecoder> decoder = factory();
+        float sampleRate = 0.0f;
+        int64 frames = 0;
+        if (decoder && decoder->Open(handle.GetPath(), &sampleRate, &frames) == B_OK) {
+            return _LoadDecoded(handle, *decoder, sampleRate, frames);
+        }
+    }
+
+    // Headerless RAW (BeOS !TRK and plain big-endian PCM), as the track
+    // describes it
+    if (handle.fRawFormat && handle.fRawFormat->isRawFormat) {
+        source = std::make_shared<MappedPCMSource>();
+        if (source->Open(handle.GetPath(), handle.fRawFormat.get()) == B_OK) {
+            return _LoadMapped(handle, source);
+        }
+    }
+
+    return AudioLoadHandle::kFailed;
+}
+
+AudioLoadHandle::State AudioLoaderService::_LoadMapped(AudioLoadHandle& handle,
+                                                       const std::shared_ptr<MappedPCMSource>& source)
+{
+    handle.fSampleRate.store(source->GetSampleRate(), std::memory_order_release);
+    handle.fFrames.store(source->CountFrames(), std::memory_order_release);
+
+    // One sequential pass for the waveform peaks, moving the read-ahead
+    // window along so the mapping does not stay resident
+    std::vector<int16_t> chunk(kChunkFrames * 2);
+    for (int64 frame = 0; frame < source->CountFrames(); frame += kChunkFrames) {
+        if (handle.IsCancelRequested()) {
+            return AudioLoadHandle::kCancelled;
+        }
+
+        source->AdvisePlayback(frame);
+        int64 count = source->ReadFrames(frame, chunk.data(), kChunkFrames);
+        if (count <= 0) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(handle.fPeakLock);
+            handle.fPeaks.Append(chunk.data(), count);
+        }
+        handle.fFramesLoaded.store(frame + count, std::memory_order_release);
+        fFramesLoaded.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(handle.fPeakLock);
+        handle.fPeaks.Finish();
+    }
+    handle.fSource = source;
+    return AudioLoadHandle::kReady;
+}
+
+AudioLoadHandle::State AudioLoaderService::_LoadDecoded(AudioLoadHandle& handle,
+                                                        AudioDecoder& decoder, float sampleRate,
+                                                        int64 frames)
+{
+    handle.fSampleRate.store(sampleRate, std::memory_order_release);
+    handle.fFrames.store(frames, std::memory_order_release);
+
+    // Compressed chunk by chunk as it is decoded, so the file is never
+    // held as int16
+    std::shared_ptr<CompressedSampleStore> store = std::make_shared<CompressedSampleStore>();
+    std::vector<int16_t> chunk(kChunkFrames * 2);
+    int64 loaded = 0;
+
+    for (;;) {
+        if (handle.IsCancelRequested()) {
+            return AudioLoadHandle::kCancelled;
+        }
+
+        int64 count = decoder.Decode(chunk.data(), kChunkFrames);
+        if (count < 0) {
+            return AudioLoadHandle::kFailed;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        store->Append(chunk.data(), count);
+        {
+            std::lock_guard<std::mutex> lock(handle.fPeakLock);
+            handle.fPeaks.Append(chunk.data(), count);
+        }
+        loaded += count;
+        handle.fFramesLoaded.store(loaded, std::memory_order_release);
+        if (loaded > handle.CountFrames()) {
+            handle.fFrames.store(loaded, std::memory_order_release);
+        }
+        fFramesLoaded.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    if (loaded == 0) {
+        return AudioLoadHandle::kFailed;
+    }
+
+    store->Finish();
+    {
+        std::lock_guard<std::mutex> lock(handle.fPeakLock);
+        handle.fPeaks.Finish();
+    }
+    handle.fFrames.store(store->CountFrames(), std::memory_order_release);
+    handle.fCompressed = store;
+    return AudioLoadHandle::kReady;
+}
+
+} // namespace VeniceDAW
@@ -0,0 +1,214 @@
+/*
+ * AudioLoaderService.h - Background loading of audio files for playback and waveforms
+ *
+ * Opening a file no longer happens on the thread that first needs it: a
+ * request queues a job and returns a handle at once. A small pool of
+ * loader threads works through the queue highest priority first (tracks
+ * that are playing, then tracks on screen, then the rest), maps
+ * uncompressed files and decodes everything else into a
+ * CompressedSampleStore, building the waveform peak pyramid as it goes.
+ * Callers poll the handle: the waveform of what has been loaded so far is
+ * available while the rest is still loading, and the audio once it is
+ * complete.
+ */
+
+#ifndef AUDIO_LOADER_SERVICE_H
+#define AUDIO_LOADER_SERVICE_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WaveformPeakPyramid.h"
+
+namespace VeniceDAW {
+
+struct AudioFormat3DMix;
+class CompressedSampleStore;
+class MappedPCMSource;
+
+// Decodes a compressed file from start to end. Used for everything that
+// cannot be mapped; on Haiku the service decodes through BMediaFile by
+// default.
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() {}
+
+    // Opens path for stereo int16 frames at the file's own rate; frames
+    // is the expected length, 0 when unknown
+    virtual status_t Open(const char* path, float* sampleRate, int64* frames) = 0;
+
+    // Decodes the next frames (up to maxFrames, interleaved stereo);
+    // returns 0 at the end and a negative value on a read error
+    virtual int64 Decode(int16_t* frames, int64 maxFrames) = 0;
+};
+
+/*
+ * Everything but GetPeaks() before the load is complete is lock-free and
+ * never blocks. Once IsReady(), the loaded audio never changes again and
+ * may be used from any thread, the audio thread included.
+ */
+class AudioLoadHandle {
+public:
+    enum State {
+        kQueued,
+        kLoading,
+        kReady,
+        kFailed,
+        kCancelled
+    };
+
+    ~AudioLoadHandle();
+
+    State GetState() const { return (State)fState.load(std::memory_order_acquire); }
+    bool IsReady() const { return GetState() == kReady; }
+    bool IsDone() const { return GetState() >= kReady; }
+    const char* GetPath() const { return fPath.c_str(); }
+
+    // Higher loads first; takes effect the next time a loader picks a job
+    int32 GetPriority() const { return fPriority.load(std::memory_order_relaxed); }
+    void SetPriority(int32 priority) { fPriority.store(priority, std::memory_order_relaxed); }
+
+    float GetSampleRate() const { return fSampleRate.load(std::memory_order_acquire); }  // 0 until open
+    int64 CountFrames() const { return fFrames.load(std::memory_order_acquire); }  // Exact once ready
+    int64 CountFramesLoaded() const { return fFramesLoaded.load(std::memory_order_acquire); }
+    float GetProgress() const;
+
+    // Waveform of the frames loaded so far, as WaveformPeakPyramid::GetPeaks().
+    // Briefly takes a lock while the load is running (UI threads only).
+    bool GetPeaks(int64 startFrame, int64 endFrame, float* outMin, float* outMax,
+                  float* outRMS = nullptr) const;
+
+    // The loaded audio once ready, null before: a mapping for WAV, AIFF and
+    // RAW files, a compressed store for everything that was decoded
+    const std::shared_ptr<const MappedPCMSource>& GetSource() const { return fSource; }
+    const std::shared_ptr<const CompressedSampleStore>& GetCompressed() const { return fCompressed; }
+
+    // Drops a queued job, or stops a running one at its next chunk
+    void Cancel();
+    bool IsCancelRequested() const { return fCancel.load(std::memory_order_acquire); }
+
+private:
+    friend class AudioLoaderService;
+
+    AudioLoadHandle(const char* path, const AudioFormat3DMix* rawFormat, int32 priority,
+                    uint64 sequence);
+
+    std::string fPath;
+    std::unique_ptr<AudioFormat3DMix> fRawFormat;
+    uint64 fSequence;           // Request order, for equal priorities
+
+    std::atomic<int32> fState;
+    std::atomic<int32> fPriority;
+    std::atomic<bool> fCancel;
+    std::atomic<float> fSampleRate;
+    std::atomic<int64> fFrames;
+    std::atomic<int64> fFramesLoaded;
+
+    mutable std::mutex fPeakLock;
+    WaveformPeakPyramid fPeaks;
+
+    std::shared_ptr<const MappedPCMSource> fSource;
+    std::shared_ptr<const CompressedSampleStore> fCompressed;
+
+    AudioLoadHandle(const AudioLoadHandle&) = delete;
+    AudioLoadHandle& operator=(const AudioLoadHandle&) = delete;
+};
+
+class AudioLoaderService {
+public:
+    static const int32 kDefaultLoaderCount = 2;
+    static const int32 kMaxLoaderCount = 8;
+
+    // Frames loaded between progress updates and cancellation checks
+    static const int64 kChunkFrames = 16384;
+
+    static const int32 kBackgroundPriority = 0;
+    static const int32 kVisiblePriority = 10;
+    static const int32 kPlayingPriority = 20;
+
+    typedef std::function<std::unique_ptr<AudioDecoder>()> DecoderFactory;
+
+    // Started, with kDefaultLoaderCount loaders
+    static AudioLoaderService& GetInstance();
+
+    explicit AudioLoaderService(int32 loaderCount = kDefaultLoaderCount);
+    ~AudioLoaderService();
+
+    // Loaders run at low priority, below the audio threads. Stop()
+    // cancels whatever is still queued or loading.
+    status_t Start();
+    void Stop();
+    bool IsRunning() const { return !fThreads.empty(); }
+    int32 CountLoaders() const { return fLoaderCount; }
+
+    // Decoder for files that cannot be mapped (the default decodes through
+    // BMediaFile on Haiku and nothing elsewhere)
+    void SetDecoderFactory(const DecoderFactory& factory);
+
+    // Queues path and returns its handle without waiting. Asking again for
+    // a path that is queued, loading or loaded returns the same handle,
+    // with its priority raised to priority if that is higher. rawFormat
+    // describes headerless RAW files, as for MappedPCMSource::Open().
+    // A request still queued when every handle to it has been released is
+    // dropped.
+    std::shared_ptr<AudioLoadHandle> Load(const char* path,
+                                          const AudioFormat3DMix* rawFormat = nullptr,
+                                          int32 priority = kBackgroundPriority);
+
+    void CancelAll();
+
+    struct Stats {
+        int32 queued;
+        int32 loading;
+        uint64 completed;
+        uint64 failed;
+        uint64 cancelled;
+        uint64 framesLoaded;
+    };
+    Stats GetStats() const;
+
+private:
+    void _LoaderLoop(int32 index);
+    std::shared_ptr<AudioLoadHandle> _PickNext();
+    AudioLoadHandle::State _Load(AudioLoadHandle& handle);
+    AudioLoadHandle::State _LoadMapped(AudioLoadHandle& handle,
+                                       const std::shared_ptr<MappedPCMSource>& source);
+    AudioLoadHandle::State _LoadDecoded(AudioLoadHandle& handle, AudioDecoder& decoder,
+                                        float sampleRate, int64 frames);
+
+    int32 fLoaderCount;
+    std::vector<std::thread> fThreads;
+
+    mutable std::mutex fLock;
+    std::condition_variable fCondition;
+    std::vector<std::shared_ptr<AudioLoadHandle> > fQueue;
+    std::map<std::string, std::weak_ptr<AudioLoadHandle> > fHandles;
+    DecoderFactory fDecoderFactory;
+    uint64 fNextSequence;
+    bool fStopping;
+
+    int32 fLoading;
+    uint64 fCompleted;
+    uint64 fFailed;
+    uint64 fCancelled;
+    std::atomic<uint64> fFramesLoaded;
+
+    AudioLoaderService(const AudioLoaderService&) = delete;
+    AudioLoaderService& operator=(const AudioLoaderService&) = delete;
+};
+
+} // namespace VeniceDAW
+
+#endif // AUDIO_LOADER_SERVICE_H
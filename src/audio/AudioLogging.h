@@ -10,8 +10,7 @@
 #ifdef __HAIKU__
     #include <OS.h>
 #else
-    // Mock definitions for cross-platform compilation
-    // These types are defined in HaikuMockHeaders.h when not on Haiku
+    #include "../testing/HaikuMockHeaders.h"
 #endif
 
 namespace VeniceDAW {
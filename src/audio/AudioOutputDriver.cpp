@@ -0,0 +1,461 @@
+/*
+ * AudioOutputDriver.cpp - BSoundPlayer, null and file output drivers
+ */
+
+#include "AudioOutputDriver.h"
+#include "AsyncAudioWriter.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <system_error>
+
+#ifdef __HAIKU__
+#include <media/SoundPlayer.h>
+#endif
+
+namespace VeniceDAW {
+
+namespace {
+
+const float kDefaultSampleRate = 44100.0f;
+const size_t kDefaultBufferFrames = 512;
+
+// The writer ring only has to absorb disk hiccups: the producer blocks
+const bigtime_t kFileWriterBufferDuration = 250000;
+
+} // namespace
+
+// =====================================
+// AudioOutputDriver
+// =====================================
+
+size_t AudioOutputDriver::FrameSize(const media_raw_audio_format& format)
+{
+    return (format.format & media_raw_audio_format::B_AUDIO_SIZE_MASK) * format.channel_count;
+}
+
+size_t AudioOutputDriver::BufferFrames(const media_raw_audio_format& format)
+{
+    size_t frameSize = FrameSize(format);
+    return frameSize > 0 ? format.buffer_size / frameSize : 0;
+}
+
+AudioOutputDriver* CreateAudioOutputDriver(const char* name, const char* path)
+{
+    if (name == nullptr || name[0] == '\0') {
+#ifdef __HAIKU__
+        name = "soundplayer";
+#else
+        name = "null";
+#endif
+    }
+
+#ifdef __HAIKU__
+    if (strcasecmp(name, "soundplayer") == 0) {
+        return new SoundPlayerOutputDriver();
+    }
+#endif
+    if (strcasecmp(name, "null") == 0) {
+        return new NullOutputDriver();
+    }
+    if (strcasecmp(name, "file") == 0) {
+        return new FileOutputDriver(path ? path : "output.wav");
+    }
+    return nullptr;
+}
+
+// =====================================
+// SoundPlayerOutputDriver
+// =====================================
+
+#ifdef __HAIKU__
+
+SoundPlayerOutputDriver::SoundPlayerOutputDriver()
+    : fSoundPlayer(nullptr),
+      fRunning(false)
+{
+}
+
+SoundPlayerOutputDriver::~SoundPlayerOutputDriver()
+{
+    Close();
+}
+
+status_t SoundPlayerOutputDriver::Open(const media_raw_audio_format& format,
+                                       AudioOutputCallback callback, void* cookie)
+{
+    if (fRunning) {
+        return B_NOT_ALLOWED;
+    }
+    Close();
+
+    fSoundPlayer = new BSoundPlayer(&format, "VeniceDAW", callback, nullptr, cookie);
+    status_t status = fSoundPlayer->InitCheck();
+    if (status != B_OK) {
+        delete fSoundPlayer;
+        fSoundPlayer = nullptr;
+    }
+    return status;
+}
+
+void SoundPlayerOutputDriver::Close()
+{
+    Stop();
+    delete fSoundPlayer;
+    fSoundPlayer = nullptr;
+}
+
+status_t SoundPlayerOutputDriver::Start()
+{
+    if (!fSoundPlayer) {
+        return B_NO_INIT;
+    }
+    if (fRunning) {
+        return B_OK;
+    }
+
+    status_t status = fSoundPlayer->Start();
+    fRunning = (status == B_OK);
+    return status;
+}
+
+void SoundPlayerOutputDriver::Stop()
+{
+    if (fSoundPlayer && fRunning) {
+        fSoundPlayer->Stop();
+    }
+    fRunning = false;
+}
+
+media_raw_audio_format SoundPlayerOutputDriver::Format() const
+{
+    return fSoundPlayer ? fSoundPlayer->Format() : media_raw_audio_format::wildcard;
+}
+
+bigtime_t SoundPlayerOutputDriver::Latency() const
+{
+    return fSoundPlayer ? fSoundPlayer->Latency() : 0;
+}
+
+#endif // __HAIKU__
+
+// =====================================
+// NullOutputDriver
+// =====================================
+
+NullOutputDriver::NullOutputDriver()
+    : fCallback(nullptr),
+      fCookie(nullptr),
+      fClockMode(kFreeRunning),
+      fFrameLimit(0),
+      fBufferFrames(kDefaultBufferFrames),
+      fRunning(false),
+      fFramesPlayed(0),
+      fCallbacks(0),
+      fLateCallbacks(0),
+      fFailedWrites(0),
+      fTotalCallbackTime(0),
+      fMaxCallbackTime(0)
+{
+    fDefaultFormat = media_raw_audio_format::wildcard;
+    fDefaultFormat.frame_rate = kDefaultSampleRate;
+    fDefaultFormat.channel_count = 2;
+    fDefaultFormat.format = media_raw_audio_format::B_AUDIO_FLOAT;
+    fDefaultFormat.byte_order = B_MEDIA_LITTLE_ENDIAN;
+    fFormat = fDefaultFormat;
+}
+
+NullOutputDriver::~NullOutputDriver()
+{
+    Close();
+}
+
+status_t NullOutputDriver::Open(const media_raw_audio_format& format,
+                                AudioOutputCallback callback, void* cookie)
+{
+    if (callback == nullptr) {
+        return B_BAD_VALUE;
+    }
+    if (IsRunning()) {
+        return B_NOT_ALLOWED;
+    }
+
+    media_raw_audio_format negotiated = format;
+    if (negotiated.frame_rate <= 0.0f) {
+        negotiated.frame_rate = fDefaultFormat.frame_rate;
+    }
+    if (negotiated.channel_count == 0) {
+        negotiated.channel_count = fDefaultFormat.channel_count;
+    }
+    if (negotiated.format == 0) {
+        negotiated.format = fDefaultFormat.format;
+    }
+    if (negotiated.byte_order == 0) {
+        negotiated.byte_order = fDefaultFormat.byte_order;
+    }
+
+    size_t frameSize = FrameSize(negotiated);
+    if (frameSize == 0) {
+        return B_BAD_VALUE;
+    }
+    if (negotiated.buffer_size == 0) {
+        negotiated.buffer_size = fBufferFrames * frameSize;
+    }
+    // Whole frames only
+    negotiated.buffer_size -= negotiated.buffer_size % frameSize;
+    if (negotiated.buffer_size == 0) {
+        return B_BAD_VALUE;
+    }
+
+    fFormat = negotiated;
+    fBuffer.assign(fFormat.buffer_size, 0);
+    fCallback = callback;
+    fCookie = cookie;
+    fFramesPlayed.store(0, std::memory_order_relaxed);
+    ResetStats();
+    return B_OK;
+}
+
+void NullOutputDriver::Close()
+{
+    Stop();
+    fCallback = nullptr;
+    fCookie = nullptr;
+}
+
+status_t NullOutputDriver::Start()
+{
+    if (!_IsOpen()) {
+        return B_NO_INIT;
+    }
+    if (IsRunning()) {
+        return B_OK;
+    }
+    // A thread that stopped at its frame limit still needs joining
+    if (fThread.joinable()) {
+        fThread.join();
+    }
+
+    fRunning.store(true, std::memory_order_release);
+    if (fClockMode == kManual) {
+        return B_OK;
+    }
+
+    try {
+        fThread = std::thread(&NullOutputDriver::_RunLoop, this);
+    } catch (const std::system_error& error) {
+        printf("NullOutputDriver: Could not spawn the driver thread: %s\n", error.what());
+        fRunning.store(false, std::memory_order_release);
+        return B_NO_MEMORY;
+    }
+    return B_OK;
+}
+
+void NullOutputDriver::Stop()
+{
+    fRunning.store(false, std::memory_order_release);
+    if (fThread.joinable()) {
+        fThread.join();
+    }
+}
+
+void NullOutputDriver::WaitForCompletion()
+{
+    if (fThread.joinable()) {
+        fThread.join();
+    }
+}
+
+bigtime_t NullOutputDriver::Latency() const
+{
+    return (bigtime_t)(BufferFrames(fFormat) * 1000000.0 / fFormat.frame_rate);
+}
+
+status_t NullOutputDriver::Pump(uint32 buffers)
+{
+    if (!_IsOpen()) {
+        return B_NO_INIT;
+    }
+    if (fThread.joinable() && IsRunning()) {
+        return B_NOT_ALLOWED;
+    }
+
+    status_t result = B_OK;
+    for (uint32 i = 0; i < buffers; i++) {
+        status_t status = _RenderBuffer();
+        if (status != B_OK && result == B_OK) {
+            result = status;
+        }
+    }
+    return result;
+}
+
+NullOutputDriver::Stats NullOutputDriver::GetStats() const
+{
+    Stats stats;
+    stats.callbacks = fCallbacks.load(std::memory_order_relaxed);
+    stats.frames = fFramesPlayed.load(std::memory_order_relaxed);
+    stats.lateCallbacks = fLateCallbacks.load(std::memory_order_relaxed);
+    stats.failedWrites = fFailedWrites.load(std::memory_order_relaxed);
+    stats.totalCallbackTime = fTotalCallbackTime.load(std::memory_order_relaxed);
+    stats.maxCallbackTime = fMaxCallbackTime.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void NullOutputDriver::ResetStats()
+{
+    fCallbacks.store(0, std::memory_order_relaxed);
+    fLateCallbacks.store(0, std::memory_order_relaxed);
+    fFailedWrites.store(0, std::memory_order_relaxed);
+    fTotalCallbackTime.store(0, std::memory_order_relaxed);
+    fMaxCallbackTime.store(0, std::memory_order_relaxed);
+}
+
+bigtime_t NullOutputDriver::SimulatedTime() const
+{
+    return (bigtime_t)(FramesPlayed() * 1000000.0 / fFormat.frame_rate);
+}
+
+status_t NullOutputDriver::_BufferRendered(const void* buffer, size_t size)
+{
+    (void)buffer;
+    (void)size;
+    return B_OK;
+}
+
+status_t NullOutputDriver::_RenderBuffer()
+{
+    bigtime_t start = system_time();
+    fCallback(fCookie, fBuffer.data(), fBuffer.size(), fFormat);
+    bigtime_t elapsed = system_time() - start;
+
+    fCallbacks.fetch_add(1, std::memory_order_relaxed);
+    fTotalCallbackTime.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > fMaxCallbackTime.load(std::memory_order_relaxed)) {
+        fMaxCallbackTime.store(elapsed, std::memory_order_relaxed);
+    }
+
+    // A full disk or an overflowing writer: the device still played the
+    // buffer, the recording lost it
+    status_t status = _BufferRendered(fBuffer.data(), fBuffer.size());
+    if (status != B_OK) {
+        fFailedWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+    fFramesPlayed.fetch_add(BufferFrames(fFormat), std::memory_order_relaxed);
+    return status;
+}
+
+void NullOutputDriver::_RunLoop()
+{
+    const bigtime_t period = Latency();
+    const uint64 bufferFrames = BufferFrames(fFormat);
+    bigtime_t requestTime = system_time();
+
+    while (fRunning.load(std::memory_order_acquire)) {
+        if (fFrameLimit > 0 && FramesPlayed() + bufferFrames > fFrameLimit) {
+            break;
+        }
+
+        if (fClockMode == kSimulatedClock) {
+            bigtime_t now = system_time();
+            if (requestTime > now) {
+                snooze(requestTime - now);
+            }
+        }
+
+        _RenderBuffer();
+
+        if (fClockMode == kSimulatedClock) {
+            // The device asks for the next buffer once this one starts
+            // playing, so the callback has one period to deliver it
+            bigtime_t deadline = requestTime + period;
+            bigtime_t now = system_time();
+            if (now > deadline) {
+                fLateCallbacks.fetch_add(1, std::memory_order_relaxed);
+                // Like a device after an underrun: resume from now
+                requestTime = now;
+            } else {
+                requestTime = deadline;
+            }
+        }
+    }
+
+    fRunning.store(false, std::memory_order_release);
+}
+
+// =====================================
+// FileOutputDriver
+// =====================================
+
+FileOutputDriver::FileOutputDriver(const char* path)
+    : fPath(path ? path : ""),
+      fWriter(nullptr),
+      fWriteStatus(B_OK)
+{
+}
+
+FileOutputDriver::~FileOutputDriver()
+{
+    Close();
+}
+
+status_t FileOutputDriver::Open(const media_raw_audio_format& format,
+                                AudioOutputCallback callback, void* cookie)
+{
+    if (IsRunning()) {
+        return B_NOT_ALLOWED;
+    }
+    _Finish();
+
+    status_t status = NullOutputDriver::Open(format, callback, cookie);
+    if (status != B_OK) {
+        return status;
+    }
+
+    media_raw_audio_format negotiated = Format();
+    fFileFormat.type = B_MEDIA_RAW_AUDIO;
+    fFileFormat.u.raw_audio = negotiated;
+
+    fWriter = new AsyncAudioWriter();
+    fWriter->SetBufferDuration(kFileWriterBufferDuration);
+    fWriter->SetBlockWhenFull(true);
+    status = fWriter->StartWriting(fPath.c_str(), fFileFormat);
+    if (status != B_OK) {
+        printf("FileOutputDriver: Cannot write '%s'\n", fPath.c_str());
+        delete fWriter;
+        fWriter = nullptr;
+        NullOutputDriver::Close();
+    }
+    return status;
+}
+
+void FileOutputDriver::Close()
+{
+    // Stop the thread first: it is the one feeding the writer
+    NullOutputDriver::Stop();
+    _Finish();
+    NullOutputDriver::Close();
+}
+
+status_t FileOutputDriver::_BufferRendered(const void* buffer, size_t size)
+{
+    if (!fWriter) {
+        return B_NO_INIT;
+    }
+    return fWriter->QueueAudioData(buffer, size, fFileFormat);
+}
+
+status_t FileOutputDriver::_Finish()
+{
+    if (!fWriter) {
+        return B_OK;
+    }
+
+    fWriteStatus = fWriter->StopWriting();
+    delete fWriter;
+    fWriter = nullptr;
+    return fWriteStatus;
+}
+
+} // namespace VeniceDAW
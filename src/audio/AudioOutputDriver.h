@@ -0,0 +1,243 @@
+/*
+ * AudioOutputDriver.h - Pluggable audio output for the engine callback
+ *
+ * The engine's processing callback has the BSoundPlayer signature; a
+ * driver decides who calls it and where the audio goes:
+ *
+ *   SoundPlayerOutputDriver  BSoundPlayer, the production driver (Haiku)
+ *   NullOutputDriver         no device: as fast as possible, paced by a
+ *                            simulated clock, or stepped by the caller
+ *   FileOutputDriver         a NullOutputDriver that writes a WAV file
+ *
+ * The null and file drivers only need the mock headers, so everything
+ * behind the callback can be benchmarked and regression tested headless.
+ */
+
+#ifndef AUDIO_OUTPUT_DRIVER_H
+#define AUDIO_OUTPUT_DRIVER_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#include <media/MediaDefs.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __HAIKU__
+class BSoundPlayer;
+#endif
+
+namespace VeniceDAW {
+
+class AsyncAudioWriter;
+
+typedef void (*AudioOutputCallback)(void* cookie, void* buffer, size_t size,
+                                    const media_raw_audio_format& format);
+
+class AudioOutputDriver {
+public:
+    virtual ~AudioOutputDriver() {}
+
+    virtual const char* Name() const = 0;
+
+    // Negotiates the output format; wildcard (zero) fields in the request
+    // are filled in by the driver. Only valid while stopped.
+    virtual status_t Open(const media_raw_audio_format& format, AudioOutputCallback callback,
+                          void* cookie) = 0;
+    virtual void Close() = 0;
+
+    virtual status_t Start() = 0;
+    virtual void Stop() = 0;
+    virtual bool IsRunning() const = 0;
+
+    // Valid after a successful Open()
+    virtual media_raw_audio_format Format() const = 0;
+    virtual bigtime_t Latency() const = 0;
+
+    // Frames per callback and bytes per frame of a negotiated format
+    static size_t FrameSize(const media_raw_audio_format& format);
+    static size_t BufferFrames(const media_raw_audio_format& format);
+};
+
+// Creates a driver by name: "soundplayer", "null" or "file" (writing to
+// path, default "output.wav"). Null or empty picks the platform default,
+// BSoundPlayer on Haiku and the null driver elsewhere. Returns nullptr
+// for unknown names.
+AudioOutputDriver* CreateAudioOutputDriver(const char* name, const char* path = nullptr);
+
+#ifdef __HAIKU__
+class SoundPlayerOutputDriver : public AudioOutputDriver {
+public:
+    SoundPlayerOutputDriver();
+    virtual ~SoundPlayerOutputDriver();
+
+    virtual const char* Name() const { return "soundplayer"; }
+
+    virtual status_t Open(const media_raw_audio_format& format, AudioOutputCallback callback,
+                          void* cookie);
+    virtual void Close();
+
+    virtual status_t Start();
+    virtual void Stop();
+    virtual bool IsRunning() const { return fRunning; }
+
+    virtual media_raw_audio_format Format() const;
+    virtual bigtime_t Latency() const;
+
+private:
+    BSoundPlayer* fSoundPlayer;
+    bool fRunning;
+};
+#endif
+
+/**
+ * NullOutputDriver - Drives the callback without an audio device
+ *
+ * kFreeRunning calls the callback back to back on a driver thread,
+ * kSimulatedClock waits for each buffer's deadline like a sound card
+ * would and counts the callbacks that missed it, and kManual never calls
+ * it on its own: Pump() renders buffers on the calling thread, which
+ * makes runs fully deterministic.
+ *
+ * Defaults: 44100 Hz, stereo float, 512-frame buffers.
+ */
+class NullOutputDriver : public AudioOutputDriver {
+public:
+    enum ClockMode {
+        kFreeRunning,
+        kSimulatedClock,
+        kManual
+    };
+
+    struct Stats {
+        uint64 callbacks;
+        uint64 frames;
+        uint64 lateCallbacks;       // Simulated clock: finished past the deadline
+        uint64 failedWrites;        // Buffers _BufferRendered() could not take
+        bigtime_t totalCallbackTime;
+        bigtime_t maxCallbackTime;
+    };
+
+    NullOutputDriver();
+    virtual ~NullOutputDriver();
+
+    virtual const char* Name() const { return "null"; }
+
+    // Configuration, used when Open() is asked for a wildcard value
+    void SetSampleRate(float sampleRate) { fDefaultFormat.frame_rate = sampleRate; }
+    void SetChannelCount(uint32 channels) { fDefaultFormat.channel_count = channels; }
+    void SetSampleFormat(uint32 format) { fDefaultFormat.format = format; }
+    void SetBufferFrames(size_t frames) { fBufferFrames = frames; }
+
+    void SetClockMode(ClockMode mode) { fClockMode = mode; }
+    ClockMode GetClockMode() const { return fClockMode; }
+
+    // Stops the driver thread by itself after this many frames (0: never)
+    void SetFrameLimit(uint64 frames) { fFrameLimit = frames; }
+
+    virtual status_t Open(const media_raw_audio_format& format, AudioOutputCallback callback,
+                          void* cookie);
+    virtual void Close();
+
+    virtual status_t Start();
+    virtual void Stop();
+    virtual bool IsRunning() const { return fRunning.load(std::memory_order_acquire); }
+
+    virtual media_raw_audio_format Format() const { return fFormat; }
+    virtual bigtime_t Latency() const;
+
+    // Renders buffers on the calling thread. Only in kManual mode, or
+    // while the driver thread is not running. Returns the first error of
+    // a buffer that was rendered but could not be written.
+    status_t Pump(uint32 buffers = 1);
+
+    // Blocks until the frame limit stops the driver thread
+    void WaitForCompletion();
+
+    Stats GetStats() const;
+    void ResetStats();
+
+    // Position of the simulated device, in frames and microseconds
+    uint64 FramesPlayed() const { return fFramesPlayed.load(std::memory_order_relaxed); }
+    bigtime_t SimulatedTime() const;
+
+    // The last rendered buffer
+    const void* LastBuffer() const { return fBuffer.data(); }
+
+protected:
+    // Called with each rendered buffer, on the rendering thread. Errors
+    // are counted in Stats::failedWrites.
+    virtual status_t _BufferRendered(const void* buffer, size_t size);
+
+    bool _IsOpen() const { return fCallback != nullptr; }
+
+private:
+    void _RunLoop();
+    status_t _RenderBuffer();
+
+    media_raw_audio_format fDefaultFormat;
+    media_raw_audio_format fFormat;
+    AudioOutputCallback fCallback;
+    void* fCookie;
+
+    ClockMode fClockMode;
+    uint64 fFrameLimit;
+    size_t fBufferFrames;
+
+    std::vector<uint8> fBuffer;
+    std::thread fThread;
+    std::atomic<bool> fRunning;
+    std::atomic<uint64> fFramesPlayed;
+
+    // Written by the rendering thread only
+    std::atomic<uint64> fCallbacks;
+    std::atomic<uint64> fLateCallbacks;
+    std::atomic<uint64> fFailedWrites;
+    std::atomic<bigtime_t> fTotalCallbackTime;
+    std::atomic<bigtime_t> fMaxCallbackTime;
+};
+
+/**
+ * FileOutputDriver - Null driver that records its output to a WAV file
+ *
+ * The file is opened by Open() and finished by Close(), so manual Pump()
+ * calls are recorded as well as the driver thread's buffers. It is
+ * written through AsyncAudioWriter in lossless blocking mode: a
+ * free-running render is limited by the disk rather than dropping buffers.
+ * Buffers the writer refuses are counted in Stats::failedWrites; errors
+ * writing the file itself show in WriteStatus() after Close().
+ */
+class FileOutputDriver : public NullOutputDriver {
+public:
+    explicit FileOutputDriver(const char* path);
+    virtual ~FileOutputDriver();
+
+    virtual const char* Name() const { return "file"; }
+    const char* Path() const { return fPath.c_str(); }
+
+    virtual status_t Open(const media_raw_audio_format& format, AudioOutputCallback callback,
+                          void* cookie);
+    virtual void Close();
+
+    // Result of the last finished file
+    status_t WriteStatus() const { return fWriteStatus; }
+
+protected:
+    virtual status_t _BufferRendered(const void* buffer, size_t size);
+
+private:
+    status_t _Finish();
+
+    std::string fPath;
+    media_format fFileFormat;
+    AsyncAudioWriter* fWriter;
+    status_t fWriteStatus;
+};
+
+} // namespace VeniceDAW
+
+#endif // AUDIO_OUTPUT_DRIVER_H
@@ -56,11 +56,7 @@ AudioRecorder::~AudioRecorder()
     CleanupRecorder();
 
     // Cleanup async writer
-    if (fAsyncWriter) {
-        fAsyncWriter->StopWriting();
-        delete fAsyncWriter;
-        fAsyncWriter = nullptr;
-    }
+    ReleaseAsyncWriter();
 
     // fRecordBuffer is automatically cleaned up by AudioBuffer destructor
 }
@@ -85,13 +81,16 @@ status_t AudioRecorder::StartRecording(const char* filename)
     if (filename) {
         fRecordingPath.SetTo(filename);
 
-        // Create async writer
-        fAsyncWriter = new AsyncAudioWriter();
+        // Every track's take goes through the session's writer service
+        fAsyncWriter = AsyncWriterPool::Instance().GetRecordingWriter();
+        if (!fAsyncWriter) {
+            RECORDER_LOG_ERROR("No recording writer available");
+            return B_NO_MEMORY;
+        }
         status = fAsyncWriter->StartWriting(filename, fRecordingFormat);
         if (status != B_OK) {
             RECORDER_LOG_ERROR("Failed to start async recording: %s", strerror(status));
-            delete fAsyncWriter;
-            fAsyncWriter = nullptr;
+            ReleaseAsyncWriter();
             return status;
         }
 
@@ -104,11 +103,7 @@ status_t AudioRecorder::StartRecording(const char* filename)
         RECORDER_LOG_ERROR("Failed to start BSoundRecorder: %s", strerror(status));
 
         // Cleanup async writer on error
-        if (fAsyncWriter) {
-            fAsyncWriter->StopWriting();
-            delete fAsyncWriter;
-            fAsyncWriter = nullptr;
-        }
+        ReleaseAsyncWriter();
 
         return status;
     }
@@ -141,9 +136,7 @@ status_t AudioRecorder::StopRecording()
 
     // Stop async file writing
     if (fAsyncWriter) {
-        fAsyncWriter->StopWriting();
-        delete fAsyncWriter;
-        fAsyncWriter = nullptr;
+        ReleaseAsyncWriter();
         RECORDER_LOG_INFO("Async file writing stopped");
     }
 
@@ -157,6 +150,15 @@ status_t AudioRecorder::StopRecording()
     return B_OK;
 }
 
+void AudioRecorder::ReleaseAsyncWriter()
+{
+    if (fAsyncWriter) {
+        // Stops the writer, which writes the rest and closes the file
+        AsyncWriterPool::Instance().ReturnWriter(fAsyncWriter);
+        fAsyncWriter = nullptr;
+    }
+}
+
 status_t AudioRecorder::EnumerateInputDevices()
 {
     RECORDER_LOG_INFO("Enumerating input devices");
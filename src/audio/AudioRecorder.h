@@ -84,6 +84,7 @@ private:
     void CleanupRecorder();
     status_t CreateRecordingFile();
     void CloseRecordingFile();
+    void ReleaseAsyncWriter();
 
     // BSoundRecorder instance (temporarily disabled)
     // BSoundRecorder* fSoundRecorder;
@@ -105,7 +106,8 @@ private:
     // Recording format
     media_format fRecordingFormat;
 
-    // Async file recording
+    // Async file recording: a recording writer of AsyncWriterPool, so all
+    // tracks of a session share its service threads
     AsyncAudioWriter* fAsyncWriter;
     BString fRecordingPath;
 
@@ -3,9 +3,17 @@
  */
 
 #include "AudioSampleCache.h"
+#include "CompressedSampleStore.h"
+#include "FFT.h"
+#include "MappedPCMSource.h"
+#include "SampleConversion.h"
 #include <cmath>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -19,6 +27,139 @@ static const int16_t INT16_MIN_VALUE = -32768;
 static const float INT16_TO_FLOAT = 1.0f / 32768.0f;
 static const float FLOAT_TO_INT16 = 32767.0f;
 
+// WSOLA segments each search thread claims at a time
+static const size_t WSOLA_SEGMENTS_PER_CLAIM = 32;
+
+namespace {
+
+// WSOLA similarity search, one per thread (an FFT plan is not shared).
+//
+// The correlation of the template with every offset in the search window
+// comes from one FFT cross-correlation instead of a dot product per
+// offset. Channels are packed in pairs as complex samples, so a stereo
+// pair needs a single transform: the real part of conj(template) * region
+// is the sum of both channels' correlations. Offsets that score within
+// rounding of the best are rescored exactly, in the order the direct
+// search used, so the same offset wins.
+class WSOLAMatcher {
+public:
+    WSOLAMatcher(int channels, int templateSize, int searchWindow);
+
+    int FindBestMatch(const std::vector<float>& buffer, int pos, int searchStart,
+                      int searchEnd);
+
+private:
+    float _Correlation(const std::vector<float>& buffer, int pos, int testPos) const;
+
+    int fChannels;
+    int fTemplateSize;
+    size_t fSize;
+    DSP::FFT fFFT;
+    std::vector<float> fTemplate;   // Interleaved complex, fSize points
+    std::vector<float> fRegion;
+    std::vector<float> fProduct;
+};
+
+static size_t CorrelationSize(size_t frames)
+{
+    while (!DSP::FFT::IsSupportedSize(frames, DSP::FFT::Complex)) {
+        frames++;
+    }
+    return frames;
+}
+
+WSOLAMatcher::WSOLAMatcher(int channels, int templateSize, int searchWindow)
+    : fChannels(channels)
+    , fTemplateSize(templateSize)
+    , fSize(CorrelationSize(2 * searchWindow + templateSize))
+    , fFFT(fSize, DSP::FFT::Complex)
+    , fTemplate(fSize * 2)
+    , fRegion(fSize * 2)
+    , fProduct(fSize * 2)
+{
+}
+
+int WSOLAMatcher::FindBestMatch(const std::vector<float>& buffer, int pos, int searchStart,
+                                int searchEnd)
+{
+    int offsets = searchEnd - searchStart + 1;
+    if (offsets <= 0) {
+        return pos;
+    }
+    int regionFrames = offsets - 1 + fTemplateSize;
+
+    std::fill(fProduct.begin(), fProduct.end(), 0.0f);
+    float templateEnergy = 0.0f;
+    float regionEnergy = 0.0f;
+    for (int ch = 0; ch < fChannels; ch += 2) {
+        bool pair = ch + 1 < fChannels;
+        std::fill(fTemplate.begin(), fTemplate.end(), 0.0f);
+        std::fill(fRegion.begin(), fRegion.end(), 0.0f);
+        for (int i = 0; i < fTemplateSize; i++) {
+            const float* frame = &buffer[(pos + i) * fChannels + ch];
+            fTemplate[i * 2] = frame[0];
+            fTemplate[i * 2 + 1] = pair ? frame[1] : 0.0f;
+            templateEnergy += fTemplate[i * 2] * fTemplate[i * 2]
+                + fTemplate[i * 2 + 1] * fTemplate[i * 2 + 1];
+        }
+        for (int i = 0; i < regionFrames; i++) {
+            const float* frame = &buffer[(searchStart + i) * fChannels + ch];
+            fRegion[i * 2] = frame[0];
+            fRegion[i * 2 + 1] = pair ? frame[1] : 0.0f;
+            regionEnergy += fRegion[i * 2] * fRegion[i * 2]
+                + fRegion[i * 2 + 1] * fRegion[i * 2 + 1];
+        }
+
+        fFFT.Forward(fTemplate.data(), fTemplate.data());
+        fFFT.Forward(fRegion.data(), fRegion.data());
+        for (size_t k = 0; k < fSize; k++) {
+            fTemplate[k * 2 + 1] = -fTemplate[k * 2 + 1];
+        }
+        DSP::FFT::MultiplyAccumulate(fTemplate.data(), fRegion.data(), fProduct.data(), fSize);
+    }
+
+    // Every offset correlates to exactly zero: the first one wins
+    if (templateEnergy == 0.0f || regionEnergy == 0.0f) {
+        return searchStart;
+    }
+
+    // No wrap-around below regionFrames, since fSize >= regionFrames
+    fFFT.Inverse(fProduct.data(), fProduct.data());
+
+    float best = fProduct[0];
+    for (int k = 1; k < offsets; k++) {
+        best = std::max(best, fProduct[k * 2]);
+    }
+
+    float tolerance = 1e-5f * std::sqrt(templateEnergy * regionEnergy);
+    float bestCorrelation = -1.0f;
+    int bestPos = pos;
+    for (int k = 0; k < offsets; k++) {
+        if (fProduct[k * 2] >= best - tolerance) {
+            float correlation = _Correlation(buffer, pos, searchStart + k);
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestPos = searchStart + k;
+            }
+        }
+    }
+    return bestPos;
+}
+
+float WSOLAMatcher::_Correlation(const std::vector<float>& buffer, int pos, int testPos) const
+{
+    float correlation = 0.0f;
+    for (int i = 0; i < fTemplateSize; i++) {
+        for (int ch = 0; ch < fChannels; ch++) {
+            correlation += buffer[(pos + i) * fChannels + ch]
+                * buffer[(testPos + i) * fChannels + ch];
+        }
+    }
+    return correlation;
+}
+
+} // namespace
+
 AudioSampleCache::AudioSampleCache()
     : sampleRate(0.0f)
     , channels(2)
@@ -26,59 +167,216 @@ AudioSampleCache::AudioSampleCache()
 {
 }
 
-void AudioSampleCache::GetSample(float time, float duration, float* outMin, float* outMax) const
+void AudioSampleCache::GetSample(float time, float duration, float* outMin, float* outMax,
+                                 float* outRMS) const
 {
     *outMin = 0.0f;
     *outMax = 0.0f;
+    if (outRMS) {
+        *outRMS = 0.0f;
+    }
 
-    if (!isValid || samples.empty() || time < 0) {
+    if (!isValid || IsEmpty() || time < 0) {
         return;
     }
 
-    // Calculate sample range for the time window
-    int startSample = (int)(time * sampleRate) * channels;
-    int endSample = (int)((time + duration) * sampleRate) * channels;
+    // Calculate frame range for the time window
+    int startFrame = (int)(time * sampleRate);
+    int endFrame = (int)((time + duration) * sampleRate);
+    int totalFrames = GetFrameCount();
 
-    if (startSample >= (int)samples.size()) {
+    if (startFrame >= totalFrames) {
         return;
     }
 
-    endSample = std::min(endSample, (int)samples.size());
+    endFrame = std::min(endFrame, totalFrames);
+
+    // Wide columns come from the peak pyramid, rounded to its buckets;
+    // narrow ones (deep zoom) are scanned exactly
+    if (endFrame - startFrame >= kPeakQueryFrames && endFrame <= peaks.CountFrames()) {
+        float low, high;
+        if (peaks.GetPeaks(startFrame, endFrame, &low, &high, outRMS)) {
+            *outMin = std::min(0.0f, low);
+            *outMax = std::max(0.0f, high);
+            return;
+        }
+    }
 
     // Find min/max in range (average L+R channels for stereo)
     float minVal = 0.0f;
     float maxVal = 0.0f;
+    float sumSquares = 0.0f;
+
+    int16_t block[1024 * 2];
+    for (int frame = startFrame; frame < endFrame; ) {
+        const int16_t* data;
+        int count;
+        if (samples.empty()) {
+            count = (int)ReadFrames(frame, block, std::min(endFrame - frame, 1024));
+            data = block;
+        } else {
+            count = endFrame - frame;
+            data = samples.data() + frame * channels;
+        }
+        if (count <= 0) {
+            break;
+        }
 
-    for (int i = startSample; i < endSample; i += channels) {
-        // Average stereo channels
-        float avgSample = (samples[i] + samples[i + 1]) * 0.5f * INT16_TO_FLOAT;
-        minVal = std::min(minVal, avgSample);
-        maxVal = std::max(maxVal, avgSample);
+        for (int i = 0; i < count * 2; i += 2) {
+            // Average stereo channels
+            float avgSample = (data[i] + data[i + 1]) * 0.5f * INT16_TO_FLOAT;
+            minVal = std::min(minVal, avgSample);
+            maxVal = std::max(maxVal, avgSample);
+            sumSquares += avgSample * avgSample;
+        }
+        frame += count;
     }
 
     *outMin = minVal;
     *outMax = maxVal;
+    if (outRMS && endFrame > startFrame) {
+        *outRMS = std::sqrt(sumSquares / (endFrame - startFrame));
+    }
 }
 
 float AudioSampleCache::GetDuration() const
 {
-    if (!isValid || sampleRate <= 0.0f || samples.empty()) {
+    if (!isValid || sampleRate <= 0.0f || IsEmpty()) {
         return 0.0f;
     }
-    return (float)(samples.size() / channels) / sampleRate;
+    return (float)GetFrameCount() / sampleRate;
 }
 
 int AudioSampleCache::GetFrameCount() const
 {
+    if (samples.empty()) {
+        if (compressed) {
+            return (int)compressed->CountFrames();
+        }
+        if (source) {
+            return (int)source->CountFrames();
+        }
+    }
     return samples.size() / channels;
 }
 
+bool AudioSampleCache::IsEmpty() const
+{
+    return GetFrameCount() == 0;
+}
+
+int64_t AudioSampleCache::ReadFrames(int64_t frame, int16_t* dest, int64_t frames) const
+{
+    if (samples.empty()) {
+        if (compressed) {
+            return compressed->ReadFrames(frame, dest, frames);
+        }
+        if (source) {
+            return source->ReadFrames(frame, dest, frames);
+        }
+    }
+
+    int64_t total = samples.size() / 2;
+    if (frame < 0 || frame >= total || frames <= 0) {
+        return 0;
+    }
+    frames = std::min(frames, total - frame);
+    memcpy(dest, samples.data() + frame * 2, frames * 2 * sizeof(int16_t));
+    return frames;
+}
+
+bool AudioSampleCache::LoadSamples()
+{
+    if (!samples.empty() || (!source && !compressed)) {
+        return true;
+    }
+
+    int64_t frames = GetFrameCount();
+    std::vector<int16_t> decoded;
+    try {
+        decoded.resize(frames * 2);
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+
+    if (compressed) {
+        // Straight through the blocks, bypassing the shared cache
+        for (int64_t block = 0; block < compressed->CountBlocks(); block++) {
+            compressed->DecodeBlock(block,
+                decoded.data() + block * CompressedSampleStore::kBlockFrames * 2);
+        }
+    } else {
+        source->ReadFrames(0, decoded.data(), frames);
+    }
+    samples.swap(decoded);
+    channels = 2;
+    source.reset();
+    compressed.reset();
+    return true;
+}
+
+void AudioSampleCache::BuildPeaks()
+{
+    int64_t frames = GetFrameCount();
+    if (!samples.empty()) {
+        peaks.Rebuild(samples.data(), frames);
+        return;
+    }
+
+    peaks.Clear();
+    int16_t block[kPeakBuildFrames * 2];
+    for (int64_t frame = 0; frame < frames; ) {
+        int64_t count;
+        if (compressed) {
+            count = compressed->ReadFrames(frame, block, kPeakBuildFrames);
+        } else {
+            // Keep the read-ahead window moving so the scan does not leave
+            // the whole mapping resident
+            source->AdvisePlayback(frame);
+            count = source->ReadFrames(frame, block, kPeakBuildFrames);
+        }
+        if (count <= 0) {
+            break;
+        }
+        peaks.Append(block, count);
+        frame += count;
+    }
+    peaks.Finish();
+}
+
+void AudioSampleCache::UpdatePeaks(int64_t firstFrame, int64_t endFrame)
+{
+    // Only caches whose peaks were built keep them up to date
+    if (peaks.CountFrames() > 0) {
+        peaks.Update(samples.data(), GetFrameCount(), firstFrame, endFrame);
+    }
+}
+
+bool AudioSampleCache::Compress()
+{
+    if (samples.empty()) {
+        return true;
+    }
+
+    std::shared_ptr<CompressedSampleStore> store;
+    try {
+        store = std::make_shared<CompressedSampleStore>();
+        store->Assign(samples.data(), samples.size() / 2);
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+
+    compressed = store;
+    std::vector<int16_t>().swap(samples);
+    return true;
+}
+
 void AudioSampleCache::ConvertToFloat(std::vector<float>& output) const
 {
     output.resize(samples.size());
-    for (size_t i = 0; i < samples.size(); i++) {
-        output[i] = samples[i] * INT16_TO_FLOAT;
-    }
+    DSP::SampleConversion::ToFloat(samples.data(), DSP::SampleConversion::kInt16,
+                                   DSP::SampleConversion::HostIsBigEndian(),
+                                   output.data(), samples.size());
 }
 
 void AudioSampleCache::ConvertFromFloat(const std::vector<float>& input)
@@ -97,6 +395,10 @@ bool AudioSampleCache::Resize(float newLengthSeconds)
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     int newFrameCount = (int)(newLengthSeconds * sampleRate);
     int oldFrameCount = GetFrameCount();
 
@@ -136,6 +438,7 @@ bool AudioSampleCache::Resize(float newLengthSeconds)
 
     // Convert back to int16
     ConvertFromFloat(resized);
+    UpdatePeaks(0, GetFrameCount());
     return true;
 }
 
@@ -145,6 +448,10 @@ bool AudioSampleCache::TimeStretch(float ratio)
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     if (std::abs(ratio - 1.0f) < 0.001f) {
         return true;  // No change needed
     }
@@ -159,29 +466,59 @@ bool AudioSampleCache::TimeStretch(float ratio)
     int inputFrames = GetFrameCount();
     int outputFrames = (int)(inputFrames / ratio);
 
-    std::vector<float> output;
-    output.reserve(outputFrames * channels);
-
+    // Where each output segment is searched for depends only on the ratio,
+    // so the searches are independent of each other
+    std::vector<int> segments;
     int inputPos = 0;
     float outputPos = 0.0f;
+    while (inputPos < inputFrames - templateSize
+           && segments.size() * templateSize < (size_t)outputFrames) {
+        segments.push_back(inputPos);
+        outputPos += templateSize * ratio;
+        inputPos = (int)outputPos;
+    }
 
-    while (inputPos < inputFrames - templateSize && output.size() < (size_t)(outputFrames * channels)) {
-        // Find best match in search window
-        int searchStart = std::max(0, inputPos - searchWindow);
-        int searchEnd = std::min(inputFrames - templateSize, inputPos + searchWindow);
-
-        int bestMatch = FindBestMatch(floatSamples, inputPos, searchStart, searchEnd, templateSize);
+    std::vector<float> output(segments.size() * templateSize * channels);
+    std::atomic<size_t> nextSegment(0);
 
-        // Copy template at best match position
-        for (int i = 0; i < templateSize; i++) {
-            for (int ch = 0; ch < channels; ch++) {
-                output.push_back(floatSamples[(bestMatch + i) * channels + ch]);
+    auto matchSegments = [&]() {
+        WSOLAMatcher matcher(channels, templateSize, searchWindow);
+        for (;;) {
+            size_t first = nextSegment.fetch_add(WSOLA_SEGMENTS_PER_CLAIM);
+            if (first >= segments.size()) {
+                break;
+            }
+            size_t end = std::min(first + WSOLA_SEGMENTS_PER_CLAIM, segments.size());
+            for (size_t segment = first; segment < end; segment++) {
+                // Find best match in search window
+                int pos = segments[segment];
+                int searchStart = std::max(0, pos - searchWindow);
+                int searchEnd = std::min(inputFrames - templateSize, pos + searchWindow);
+                int bestMatch = matcher.FindBestMatch(floatSamples, pos, searchStart, searchEnd);
+
+                // Copy template at best match position
+                std::copy(floatSamples.begin() + (size_t)bestMatch * channels,
+                          floatSamples.begin() + (size_t)(bestMatch + templateSize) * channels,
+                          output.begin() + segment * templateSize * channels);
             }
         }
-
-        // Advance positions
-        outputPos += templateSize * ratio;
-        inputPos = (int)outputPos;
+    };
+
+    // This thread searches too; helpers that cannot be spawned are not needed
+    size_t claims = (segments.size() + WSOLA_SEGMENTS_PER_CLAIM - 1) / WSOLA_SEGMENTS_PER_CLAIM;
+    size_t helpers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()) - 1,
+                                      claims > 0 ? claims - 1 : 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < helpers; i++) {
+        try {
+            threads.emplace_back(matchSegments);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    matchSegments();
+    for (std::thread& thread : threads) {
+        thread.join();
     }
 
     // Resize output to exact length
@@ -189,45 +526,20 @@ bool AudioSampleCache::TimeStretch(float ratio)
 
     // Convert back to int16
     ConvertFromFloat(output);
+    UpdatePeaks(0, GetFrameCount());
     return true;
 }
 
-int AudioSampleCache::FindBestMatch(const std::vector<float>& buffer, int pos,
-                                    int searchStart, int searchEnd, int templateSize)
-{
-    float bestCorrelation = -1.0f;
-    int bestPos = pos;
-
-    for (int testPos = searchStart; testPos <= searchEnd; testPos++) {
-        float correlation = 0.0f;
-
-        // Calculate cross-correlation
-        for (int i = 0; i < templateSize; i++) {
-            for (int ch = 0; ch < channels; ch++) {
-                int idx1 = (pos + i) * channels + ch;
-                int idx2 = (testPos + i) * channels + ch;
-
-                if (idx1 < (int)buffer.size() && idx2 < (int)buffer.size()) {
-                    correlation += buffer[idx1] * buffer[idx2];
-                }
-            }
-        }
-
-        if (correlation > bestCorrelation) {
-            bestCorrelation = correlation;
-            bestPos = testPos;
-        }
-    }
-
-    return bestPos;
-}
-
 bool AudioSampleCache::PitchShift(float semitones)
 {
     if (!isValid || std::abs(semitones) > 24.0f) {
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     if (std::abs(semitones) < 0.01f) {
         return true;  // No change needed
     }
@@ -286,6 +598,7 @@ bool AudioSampleCache::PitchShift(float semitones)
         }
     }
 
+    UpdatePeaks(0, GetFrameCount());
     return true;
 }
 
@@ -295,6 +608,10 @@ bool AudioSampleCache::Normalize(float targetLevel, bool useRMS)
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     std::vector<float> floatSamples;
     ConvertToFloat(floatSamples);
 
@@ -330,6 +647,7 @@ bool AudioSampleCache::Normalize(float targetLevel, bool useRMS)
     }
 
     ConvertFromFloat(floatSamples);
+    UpdatePeaks(0, GetFrameCount());
     return true;
 }
 
@@ -339,6 +657,10 @@ bool AudioSampleCache::FadeIn(float durationSeconds, bool exponential)
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     int fadeFrames = (int)(durationSeconds * sampleRate);
     int totalFrames = GetFrameCount();
     fadeFrames = std::min(fadeFrames, totalFrames);
@@ -354,6 +676,7 @@ bool AudioSampleCache::FadeIn(float durationSeconds, bool exponential)
         }
     }
 
+    UpdatePeaks(0, fadeFrames);
     return true;
 }
 
@@ -363,6 +686,10 @@ bool AudioSampleCache::FadeOut(float durationSeconds, bool exponential)
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     int fadeFrames = (int)(durationSeconds * sampleRate);
     int totalFrames = GetFrameCount();
     fadeFrames = std::min(fadeFrames, totalFrames);
@@ -380,6 +707,7 @@ bool AudioSampleCache::FadeOut(float durationSeconds, bool exponential)
         }
     }
 
+    UpdatePeaks(fadeStart, totalFrames);
     return true;
 }
 
@@ -389,6 +717,10 @@ bool AudioSampleCache::Reverse()
         return false;
     }
 
+    if (!LoadSamples()) {
+        return false;
+    }
+
     int frameCount = GetFrameCount();
 
     for (int i = 0; i < frameCount / 2; i++) {
@@ -401,6 +733,7 @@ bool AudioSampleCache::Reverse()
         }
     }
 
+    UpdatePeaks(0, GetFrameCount());
     return true;
 }
 
@@ -2,8 +2,10 @@
  * AudioSampleCache.h - Audio sample cache with editing operations
  *
  * Features:
- * - Stereo int16 sample storage
- * - Time-based waveform sampling (for visualization)
+ * - Stereo int16 sample storage, losslessly compressed in RAM, or a
+ *   memory-mapped file read on demand
+ * - Time-based waveform sampling (for visualization), answered from a
+ *   min/max/RMS peak pyramid at any zoom level
  * - Audio editing operations:
  *   - Resize: Change audio length (stretch/compress)
  *   - TimeStretch: Change tempo without pitch change
@@ -17,13 +19,21 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include "WaveformPeakPyramid.h"
 
 namespace VeniceDAW {
 
+class CompressedSampleStore;
+class MappedPCMSource;
+
 /**
  * AudioSampleCache - Container for stereo audio samples with editing operations
  *
- * Storage format: Interleaved stereo int16 (L,R,L,R,...)
+ * Storage format: Interleaved stereo int16 (L,R,L,R,...), either decoded
+ * into samples, held by a CompressedSampleStore (decoded files, about half
+ * the size) or, for uncompressed files, read from a MappedPCMSource as
+ * needed. Editing operations decode back into samples first.
  *
  * Editing operations:
  * - Resize: Linear resampling to new length
@@ -34,18 +44,43 @@ namespace VeniceDAW {
  */
 struct AudioSampleCache {
     std::vector<int16_t> samples;    // Stereo int16 samples (L,R,L,R,...)
+    std::shared_ptr<const CompressedSampleStore> compressed;  // Used while samples is empty
+    std::shared_ptr<const MappedPCMSource> source;  // Mapped file, used while samples is empty
     float sampleRate;                // Sample rate (e.g., 44100)
     int channels;                    // Number of channels (always 2)
     bool isValid;
+    WaveformPeakPyramid peaks;       // Empty until BuildPeaks()
+
+    // Columns at least this wide are answered from peaks
+    static const int kPeakQueryFrames = 16 * WaveformPeakPyramid::kBaseFrames;
+    static const int kPeakBuildFrames = 4096;
 
     AudioSampleCache();
 
-    // Waveform visualization (R6-style on-the-fly calculation)
-    void GetSample(float time, float duration, float* outMin, float* outMax) const;
+    // Waveform visualization: min/max (and RMS) of the L+R average over a
+    // time window, from peaks for wide windows once they are built
+    void GetSample(float time, float duration, float* outMin, float* outMax,
+                   float* outRMS = nullptr) const;
+
+    // Scans whichever storage is in use into peaks; editing operations
+    // keep built peaks up to date
+    void BuildPeaks();
 
     // Duration helpers
     float GetDuration() const;       // Total duration in seconds
     int GetFrameCount() const;       // Total stereo frames
+    bool IsEmpty() const;            // No frames in any storage
+
+    // Copies stereo frames from whichever storage is in use; returns how
+    // many (compressed reads go through the store's shared block cache)
+    int64_t ReadFrames(int64_t frame, int16_t* dest, int64_t frames) const;
+
+    // Decodes a compressed store or a mapped source into samples and drops
+    // it, so the audio can be edited; the editing operations call it first
+    bool LoadSamples();
+
+    // Moves samples into a CompressedSampleStore and frees them
+    bool Compress();
 
     // Editing operations
     /**
@@ -59,6 +94,9 @@ struct AudioSampleCache {
     /**
      * TimeStretch - Change tempo without pitch (WSOLA algorithm)
      *
+     * The similarity search runs through the FFT, and segments are
+     * matched in parallel on every core.
+     *
      * @param ratio Time stretch ratio (0.5 = half speed, 2.0 = double speed)
      * @return true on success
      */
@@ -108,12 +146,9 @@ struct AudioSampleCache {
 
 private:
     // Internal helpers
+    void UpdatePeaks(int64_t firstFrame, int64_t endFrame);
     void ConvertToFloat(std::vector<float>& output) const;
     void ConvertFromFloat(const std::vector<float>& input);
-
-    // WSOLA helper for time stretching
-    int FindBestMatch(const std::vector<float>& buffer, int pos, int searchStart,
-                      int searchEnd, int templateSize);
 };
 
 } // namespace VeniceDAW
@@ -0,0 +1,373 @@
+#include "BiquadBank.h"
+#include <algorithm>
+#include <cstring>
+
+// Include SIMD headers if available on x86/x64
+#if defined(__i386__) || defined(__x86_64__)
+    #include <xmmintrin.h>  // SSE
+    #include <emmintrin.h>  // SSE2
+    #ifdef __AVX__
+        #include <immintrin.h>  // AVX
+    #endif
+    #define BIQUAD_HAVE_SSE2 1
+#endif
+
+namespace VeniceDAW {
+namespace DSP {
+
+namespace {
+
+struct ScalarOps {
+    typedef float V;
+    static const size_t kWidth = 1;
+    static V Load(const float* p) { return *p; }
+    static void Store(float* p, V v) { *p = v; }
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+};
+
+#ifdef BIQUAD_HAVE_SSE2
+struct SSE2Ops {
+    typedef __m128 V;
+    static const size_t kWidth = 4;
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+};
+#endif
+
+#ifdef __AVX__
+struct AVXOps {
+    typedef __m256 V;
+    static const size_t kWidth = 8;
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+};
+#endif
+
+// Runs every active stage sample by sample, in place, over frames that are
+// `stride` floats apart. Stage k of one sample does not depend on stage k+1
+// of the previous one, so the CPU overlaps the stages' feedback chains;
+// measured faster than running each stage over the whole chunk in turn.
+// a1 * y1 is folded in last since it is the only term on that chain.
+template <class Ops>
+void RunCascade(BiquadBank::Section* sections, const size_t* stages, size_t stageCount,
+                float* data, size_t stride, size_t frames, size_t lanes)
+{
+    typedef typename Ops::V V;
+    const size_t vectors = (lanes + Ops::kWidth - 1) / Ops::kWidth;
+
+    for (size_t v = 0; v < vectors; ++v) {
+        const size_t lane = v * Ops::kWidth;
+        float* p = data + lane;
+        for (size_t i = 0; i < frames; ++i, p += stride) {
+            V x = Ops::Load(p);
+            for (size_t k = 0; k < stageCount; ++k) {
+                BiquadBank::Section& s = sections[stages[k]];
+                const V y1 = Ops::Load(s.y1 + lane);
+                const V partial = Ops::Sub(Ops::Add(Ops::Add(Ops::Mul(Ops::Load(s.b0 + lane), x),
+                                                             Ops::Mul(Ops::Load(s.b1 + lane), Ops::Load(s.x1 + lane))),
+                                                    Ops::Mul(Ops::Load(s.b2 + lane), Ops::Load(s.x2 + lane))),
+                                           Ops::Mul(Ops::Load(s.a2 + lane), Ops::Load(s.y2 + lane)));
+                const V y = Ops::Sub(partial, Ops::Mul(Ops::Load(s.a1 + lane), y1));
+                Ops::Store(s.x2 + lane, Ops::Load(s.x1 + lane));
+                Ops::Store(s.x1 + lane, x);
+                Ops::Store(s.y2 + lane, y1);
+                Ops::Store(s.y1 + lane, y);
+                x = y;
+            }
+            Ops::Store(p, x);
+        }
+    }
+}
+
+// Single-lane cascade on a compact copy of each stage: a lane's fields are
+// spread over a whole Section, which costs a fifth of the throughput when
+// nothing else shares those cache lines.
+void RunSingleLaneCascade(BiquadBank::Section* sections, const size_t* stages, size_t stageCount,
+                          size_t lane, float* data, size_t frames)
+{
+    struct Compact { float b0, b1, b2, a1, a2, x1, x2, y1, y2; };
+    const size_t kMaxStages = 16;
+    Compact local[kMaxStages];
+
+    for (size_t first = 0; first < stageCount; first += kMaxStages) {
+        const size_t count = std::min(kMaxStages, stageCount - first);
+        for (size_t k = 0; k < count; ++k) {
+            const BiquadBank::Section& s = sections[stages[first + k]];
+            local[k] = {s.b0[lane], s.b1[lane], s.b2[lane], s.a1[lane], s.a2[lane],
+                        s.x1[lane], s.x2[lane], s.y1[lane], s.y2[lane]};
+        }
+
+        for (size_t i = 0; i < frames; ++i) {
+            float x = data[i];
+            for (size_t k = 0; k < count; ++k) {
+                Compact& c = local[k];
+                const float partial = c.b0 * x + c.b1 * c.x1 + c.b2 * c.x2 - c.a2 * c.y2;
+                const float y = partial - c.a1 * c.y1;
+                c.x2 = c.x1;
+                c.x1 = x;
+                c.y2 = c.y1;
+                c.y1 = y;
+                x = y;
+            }
+            data[i] = x;
+        }
+
+        for (size_t k = 0; k < count; ++k) {
+            BiquadBank::Section& s = sections[stages[first + k]];
+            s.x1[lane] = local[k].x1;
+            s.x2[lane] = local[k].x2;
+            s.y1[lane] = local[k].y1;
+            s.y2[lane] = local[k].y2;
+        }
+    }
+}
+
+} // namespace
+
+BiquadBank::BiquadBank()
+    : m_lanes(0)
+    , m_stages(0)
+    , m_groups(0)
+    , m_optLevel(OPT_SCALAR) {
+    DetectCPUFeatures();
+    m_scratch.resize(kChunkFrames * kGroupWidth, 0.0f);
+}
+
+BiquadBank::BiquadBank(size_t lanes, size_t stages)
+    : BiquadBank() {
+    Resize(lanes, stages);
+}
+
+void BiquadBank::Resize(size_t lanes, size_t stages) {
+    m_lanes = lanes;
+    m_stages = stages;
+    m_groups = (lanes + kGroupWidth - 1) / kGroupWidth;
+
+    Section identity;
+    std::memset(&identity, 0, sizeof(identity));
+    std::fill(identity.b0, identity.b0 + kGroupWidth, 1.0f);
+
+    m_sections.assign(m_groups * m_stages, identity);
+    m_stageEnabled.assign(m_stages, true);
+    m_activeStages.reserve(m_stages);
+    RebuildActiveStages();
+}
+
+BiquadBank::Section& BiquadBank::GetSection(size_t stage, size_t lane) {
+    return m_sections[(lane / kGroupWidth) * m_stages + stage];
+}
+
+void BiquadBank::SetCoefficients(size_t stage, size_t lane,
+                                 float b0, float b1, float b2, float a1, float a2) {
+    if (stage >= m_stages || lane >= m_lanes) return;
+
+    Section& s = GetSection(stage, lane);
+    const size_t i = lane % kGroupWidth;
+    s.b0[i] = b0;
+    s.b1[i] = b1;
+    s.b2[i] = b2;
+    s.a1[i] = a1;
+    s.a2[i] = a2;
+}
+
+void BiquadBank::SetCoefficients(size_t stage, size_t lane, const BiquadFilter& filter) {
+    float a0, a1, a2, b0, b1, b2;
+    filter.GetCoefficients(a0, a1, a2, b0, b1, b2);
+    SetCoefficients(stage, lane, b0, b1, b2, a1, a2);
+}
+
+void BiquadBank::SetStageCoefficients(size_t stage, const BiquadFilter& filter) {
+    for (size_t lane = 0; lane < m_lanes; ++lane) {
+        SetCoefficients(stage, lane, filter);
+    }
+}
+
+void BiquadBank::SetStageCoefficients(size_t stage, float b0, float b1, float b2,
+                                      float a1, float a2) {
+    if (stage >= m_stages) return;
+
+    for (size_t group = 0; group < m_groups; ++group) {
+        Section& s = m_sections[group * m_stages + stage];
+        std::fill(s.b0, s.b0 + kGroupWidth, b0);
+        std::fill(s.b1, s.b1 + kGroupWidth, b1);
+        std::fill(s.b2, s.b2 + kGroupWidth, b2);
+        std::fill(s.a1, s.a1 + kGroupWidth, a1);
+        std::fill(s.a2, s.a2 + kGroupWidth, a2);
+    }
+}
+
+void BiquadBank::SetStageEnabled(size_t stage, bool enabled) {
+    if (stage >= m_stages || m_stageEnabled[stage] == enabled) return;
+    m_stageEnabled[stage] = enabled;
+    RebuildActiveStages();
+}
+
+bool BiquadBank::IsStageEnabled(size_t stage) const {
+    return stage < m_stages && m_stageEnabled[stage];
+}
+
+void BiquadBank::RebuildActiveStages() {
+    // Capacity is reserved in Resize(), so this never allocates
+    m_activeStages.clear();
+    for (size_t stage = 0; stage < m_stages; ++stage) {
+        if (m_stageEnabled[stage]) {
+            m_activeStages.push_back(stage);
+        }
+    }
+}
+
+void BiquadBank::Reset() {
+    for (size_t stage = 0; stage < m_stages; ++stage) {
+        ResetStage(stage);
+    }
+}
+
+void BiquadBank::ResetStage(size_t stage) {
+    if (stage >= m_stages) return;
+
+    for (size_t group = 0; group < m_groups; ++group) {
+        Section& s = m_sections[group * m_stages + stage];
+        std::fill(s.x1, s.x1 + kGroupWidth, 0.0f);
+        std::fill(s.x2, s.x2 + kGroupWidth, 0.0f);
+        std::fill(s.y1, s.y1 + kGroupWidth, 0.0f);
+        std::fill(s.y2, s.y2 + kGroupWidth, 0.0f);
+    }
+}
+
+void BiquadBank::Process(float* const* channels, size_t numFrames) {
+    Process(channels, channels, numFrames);
+}
+
+void BiquadBank::Process(const float* const* inputs, float* const* outputs, size_t numFrames) {
+    if (m_lanes == 0) return;
+
+    if (m_activeStages.empty()) {
+        for (size_t lane = 0; lane < m_lanes; ++lane) {
+            if (inputs[lane] != outputs[lane]) {
+                std::memcpy(outputs[lane], inputs[lane], numFrames * sizeof(float));
+            }
+        }
+        return;
+    }
+
+    for (size_t offset = 0; offset < numFrames; offset += kChunkFrames) {
+        const size_t frames = std::min(kChunkFrames, numFrames - offset);
+        for (size_t group = 0; group < m_groups; ++group) {
+            ProcessGroup(group, inputs, outputs, offset, frames);
+        }
+    }
+}
+
+void BiquadBank::ProcessGroup(size_t group, const float* const* inputs, float* const* outputs,
+                              size_t offset, size_t frames) {
+    const size_t firstLane = group * kGroupWidth;
+    const size_t lanes = std::min(kGroupWidth, m_lanes - firstLane);
+    float* chunk = m_scratch.data();
+    Section* sections = m_sections.data() + group * m_stages;
+
+    const size_t* stages = m_activeStages.data();
+    const size_t stageCount = m_activeStages.size();
+
+    // A lone lane gains nothing from vectors or the transpose
+    if (lanes == 1) {
+        float* out = outputs[firstLane] + offset;
+        const float* in = inputs[firstLane] + offset;
+        if (in != out) {
+            std::memcpy(out, in, frames * sizeof(float));
+        }
+        RunSingleLaneCascade(sections, stages, stageCount, 0, out, frames);
+        return;
+    }
+
+    // Transpose planar lanes into frame-major order. Padding lanes inside
+    // a processed vector see whatever the chunk holds; their results are
+    // never copied out and their filters are identity, so state stays finite.
+    for (size_t l = 0; l < lanes; ++l) {
+        const float* in = inputs[firstLane + l] + offset;
+        for (size_t i = 0; i < frames; ++i) {
+            chunk[i * kGroupWidth + l] = in[i];
+        }
+    }
+
+#ifdef __AVX__
+    if (m_optLevel == OPT_AVX && lanes > SSE2Ops::kWidth) {
+        RunCascade<AVXOps>(sections, stages, stageCount, chunk, kGroupWidth, frames, lanes);
+    } else
+#endif
+#ifdef BIQUAD_HAVE_SSE2
+    if (m_optLevel >= OPT_SSE2) {
+        RunCascade<SSE2Ops>(sections, stages, stageCount, chunk, kGroupWidth, frames, lanes);
+    } else
+#endif
+    {
+        RunCascade<ScalarOps>(sections, stages, stageCount, chunk, kGroupWidth, frames, lanes);
+    }
+
+    for (size_t l = 0; l < lanes; ++l) {
+        float* out = outputs[firstLane + l] + offset;
+        for (size_t i = 0; i < frames; ++i) {
+            out[i] = chunk[i * kGroupWidth + l];
+        }
+    }
+}
+
+float BiquadBank::ProcessSample(size_t lane, float input) {
+    if (lane >= m_lanes) return input;
+
+    const size_t i = lane % kGroupWidth;
+    Section* sections = m_sections.data() + (lane / kGroupWidth) * m_stages;
+    float sample = input;
+
+    for (size_t stage : m_activeStages) {
+        Section& s = sections[stage];
+        const float partial = s.b0[i] * sample + s.b1[i] * s.x1[i] + s.b2[i] * s.x2[i]
+                            - s.a2[i] * s.y2[i];
+        const float output = partial - s.a1[i] * s.y1[i];
+        s.x2[i] = s.x1[i];
+        s.x1[i] = sample;
+        s.y2[i] = s.y1[i];
+        s.y1[i] = output;
+        sample = output;
+    }
+
+    return sample;
+}
+
+void BiquadBank::DetectCPUFeatures() {
+#ifdef __AVX__
+    m_optLevel = OPT_AVX;
+#elif defined(BIQUAD_HAVE_SSE2)
+    m_optLevel = OPT_SSE2;
+#else
+    m_optLevel = OPT_SCALAR;
+#endif
+}
+
+void BiquadBank::SetOptimizationLevel(OptimizationLevel level) {
+#ifndef __AVX__
+    if (level == OPT_AVX) level = OPT_SSE2;
+#endif
+#ifndef BIQUAD_HAVE_SSE2
+    if (level == OPT_SSE2) level = OPT_SCALAR;
+#endif
+    m_optLevel = level;
+}
+
+const char* BiquadBank::GetOptimizationName() const {
+    switch (m_optLevel) {
+        case OPT_AVX: return "AVX";
+        case OPT_SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+}
+}
@@ -0,0 +1,105 @@
+#ifndef DSP_BIQUAD_BANK_H
+#define DSP_BIQUAD_BANK_H
+
+#include <cstddef>
+#include <vector>
+#include "DSPAlgorithms.h"
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Structure-of-arrays bank of independent biquad cascades.
+//
+// Each lane is one signal (a channel of a surround buffer, or the same EQ
+// position across many tracks) running through the same number of
+// cascaded stages; every lane has its own coefficients and state. Lanes
+// are stored in groups of kGroupWidth so SSE advances 4 and AVX 8 filters
+// per instruction. Blocks are transposed in short chunks and each frame
+// then runs through the whole cascade, so the feedback chains of
+// successive stages overlap in the pipeline.
+//
+// The recurrence is BiquadFilter's direct form I with the a1 * y1 term
+// added last, so results match the scalar path to within float rounding.
+//
+// Resize() allocates; everything else is allocation-free and safe on the
+// audio thread.
+class BiquadBank {
+public:
+    enum OptimizationLevel {
+        OPT_SCALAR,
+        OPT_SSE2,
+        OPT_AVX
+    };
+
+    static const size_t kGroupWidth = 8;
+    static const size_t kChunkFrames = 64;
+
+    BiquadBank();
+    BiquadBank(size_t lanes, size_t stages);
+    ~BiquadBank() = default;
+
+    void Resize(size_t lanes, size_t stages);
+    size_t GetLaneCount() const { return m_lanes; }
+    size_t GetStageCount() const { return m_stages; }
+
+    // Coefficients are normalized (a0 == 1). New stages are identity
+    // filters and enabled.
+    void SetCoefficients(size_t stage, size_t lane,
+                         float b0, float b1, float b2, float a1, float a2);
+    void SetCoefficients(size_t stage, size_t lane, const BiquadFilter& filter);
+    void SetStageCoefficients(size_t stage, const BiquadFilter& filter);
+    void SetStageCoefficients(size_t stage, float b0, float b1, float b2, float a1, float a2);
+
+    // Disabled stages are skipped entirely and keep their state.
+    void SetStageEnabled(size_t stage, bool enabled);
+    bool IsStageEnabled(size_t stage) const;
+
+    // Planar processing: one pointer per lane, GetLaneCount() of them.
+    void Process(const float* const* inputs, float* const* outputs, size_t numFrames);
+    void Process(float* const* channels, size_t numFrames);
+
+    // Runs one sample of one lane through the enabled stages.
+    float ProcessSample(size_t lane, float input);
+
+    void Reset();
+    void ResetStage(size_t stage);
+
+    OptimizationLevel GetOptimizationLevel() const { return m_optLevel; }
+    void SetOptimizationLevel(OptimizationLevel level);
+    const char* GetOptimizationName() const;
+
+    // Stage coefficients and state of one lane group, kGroupWidth wide
+    struct Section {
+        float b0[kGroupWidth];
+        float b1[kGroupWidth];
+        float b2[kGroupWidth];
+        float a1[kGroupWidth];
+        float a2[kGroupWidth];
+        float x1[kGroupWidth];
+        float x2[kGroupWidth];
+        float y1[kGroupWidth];
+        float y2[kGroupWidth];
+    };
+
+private:
+    size_t m_lanes;
+    size_t m_stages;
+    size_t m_groups;
+    OptimizationLevel m_optLevel;
+
+    std::vector<Section> m_sections;        // [group * m_stages + stage]
+    std::vector<size_t> m_activeStages;     // Enabled stage indices, in order
+    std::vector<bool> m_stageEnabled;
+    std::vector<float> m_scratch;           // kChunkFrames * kGroupWidth
+
+    Section& GetSection(size_t stage, size_t lane);
+    void RebuildActiveStages();
+    void DetectCPUFeatures();
+    void ProcessGroup(size_t group, const float* const* inputs, float* const* outputs,
+                      size_t offset, size_t frames);
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,530 @@
+/*
+ * CompressedSampleStore.cpp - Lossless in-memory compression of sample caches
+ */
+
+#include "CompressedSampleStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace VeniceDAW {
+
+const int32 CompressedSampleStore::kBlockFrames;
+const int32 CompressedSampleStore::kPartitionSamples;
+const int32 CompressedSampleStore::kMaxOrder;
+const int32 CompressedSampleStore::BlockCache::kDefaultBlocks;
+
+namespace {
+
+// Block header byte
+enum StereoMode {
+    kLeftRight = 0,
+    kLeftSide = 1,
+    kSideRight = 2,
+    kMidSide = 3
+};
+const uint8_t kVerbatimFlag = 0x80;
+
+const int32 kOrderBits = 3;
+const uint32 kConstantChannel = 7;  // In place of the order: one value, no residuals
+const int32 kWarmupBits = 18;       // Zigzag of a side sample
+const int32 kRiceParameterBits = 5;
+const uint32 kMaxRiceParameter = 30;
+
+std::atomic<uint64> sNextSerial(1);
+
+inline uint32 ZigZag(int32 value)
+{
+    return ((uint32)value << 1) ^ (uint32)(value >> 31);
+}
+
+inline int32 UnZigZag(uint32 value)
+{
+    return (int32)(value >> 1) ^ -(int32)(value & 1);
+}
+
+// Residual of the fixed polynomial predictor of order at sample i >= order
+inline int32 Residual(const int32* x, int32 i, int32 order)
+{
+    switch (order) {
+        case 0: return x[i];
+        case 1: return x[i] - x[i - 1];
+        case 2: return x[i] - 2 * x[i - 1] + x[i - 2];
+        case 3: return x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+        default: return x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4];
+    }
+}
+
+// Cheapest predictor order by total absolute residual, which is what the
+// Rice coder pays for
+int32 BestOrder(const int32* x, int32 count, uint64* cost)
+{
+    uint64 sums[CompressedSampleStore::kMaxOrder + 1] = {};
+    int32 start = std::min(count, (int32)CompressedSampleStore::kMaxOrder);
+    for (int32 i = start; i < count; i++) {
+        int32 d0 = x[i];
+        int32 d1 = d0 - x[i - 1];
+        int32 d2 = d1 - (x[i - 1] - x[i - 2]);
+        int32 e2 = (x[i - 1] - x[i - 2]) - (x[i - 2] - x[i - 3]);
+        int32 d3 = d2 - e2;
+        int32 e3 = e2 - ((x[i - 2] - x[i - 3]) - (x[i - 3] - x[i - 4]));
+        int32 d4 = d3 - e3;
+        sums[0] += (uint32)std::abs(d0);
+        sums[1] += (uint32)std::abs(d1);
+        sums[2] += (uint32)std::abs(d2);
+        sums[3] += (uint32)std::abs(d3);
+        sums[4] += (uint32)std::abs(d4);
+    }
+
+    int32 best = 0;
+    for (int32 order = 1; order <= CompressedSampleStore::kMaxOrder && order < count; order++) {
+        if (sums[order] < sums[best]) {
+            best = order;
+        }
+    }
+    *cost = sums[best];
+    return best;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : fOut(out), fAccumulator(0), fCount(0) {}
+
+    // bits <= 32
+    void Put(uint32 value, int32 bits)
+    {
+        fAccumulator = (fAccumulator << bits) | value;
+        fCount += bits;
+        while (fCount >= 8) {
+            fCount -= 8;
+            fOut.push_back((uint8_t)(fAccumulator >> fCount));
+        }
+    }
+
+    void PutRice(uint32 value, uint32 parameter)
+    {
+        uint32 quotient = value >> parameter;
+        while (quotient >= 31) {
+            Put(0, 31);
+            quotient -= 31;
+        }
+        Put(1, quotient + 1);
+        if (parameter > 0) {
+            Put(value & ((1u << parameter) - 1), parameter);
+        }
+    }
+
+    void Flush()
+    {
+        if (fCount > 0) {
+            fOut.push_back((uint8_t)(fAccumulator << (8 - fCount)));
+            fCount = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& fOut;
+    uint64 fAccumulator;
+    int32 fCount;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, const uint8_t* end)
+        : fData(data), fEnd(end), fAccumulator(0), fCount(0) {}
+
+    uint32 Get(int32 bits)
+    {
+        if (bits == 0) {
+            return 0;
+        }
+        _Refill();
+        uint32 value = (uint32)(fAccumulator >> (64 - bits));
+        fAccumulator <<= bits;
+        fCount -= bits;
+        return value;
+    }
+
+    uint32 GetRice(uint32 parameter)
+    {
+        uint32 quotient = 0;
+        for (;;) {
+            _Refill();
+            if (fAccumulator != 0) {
+                int32 zeros = __builtin_clzll(fAccumulator);
+                fAccumulator <<= zeros + 1;
+                fCount -= zeros + 1;
+                quotient += zeros;
+                break;
+            }
+            if (fCount <= 0) {
+                return 0;       // Truncated, never happens with our own data
+            }
+            quotient += fCount;
+            fCount = 0;
+        }
+        return (quotient << parameter) | Get(parameter);
+    }
+
+private:
+    void _Refill()
+    {
+        while (fCount <= 56 && fData < fEnd) {
+            fAccumulator |= (uint64)*fData++ << (56 - fCount);
+            fCount += 8;
+        }
+    }
+
+    const uint8_t* fData;
+    const uint8_t* fEnd;
+    uint64 fAccumulator;
+    int32 fCount;
+};
+
+void EncodeChannel(BitWriter& writer, const int32* x, int32 count)
+{
+    // Digital silence and DC cost a few bytes per block
+    if (std::all_of(x, x + count, [x](int32 value) { return value == x[0]; })) {
+        writer.Put(kConstantChannel, kOrderBits);
+        writer.Put(ZigZag(x[0]), kWarmupBits);
+        return;
+    }
+
+    uint64 cost;
+    int32 order = BestOrder(x, count, &cost);
+    writer.Put(order, kOrderBits);
+    for (int32 i = 0; i < order; i++) {
+        writer.Put(ZigZag(x[i]), kWarmupBits);
+    }
+
+    uint32 residuals[CompressedSampleStore::kPartitionSamples];
+    for (int32 start = order; start < count; ) {
+        int32 end = std::min(count, (start / CompressedSampleStore::kPartitionSamples + 1)
+                                    * CompressedSampleStore::kPartitionSamples);
+        int32 n = end - start;
+        uint64 sum = 0;
+        for (int32 i = 0; i < n; i++) {
+            residuals[i] = ZigZag(Residual(x, start + i, order));
+            sum += residuals[i];
+        }
+
+        // Rice parameter near log2 of the mean, refined by exact cost
+        uint32 guess = 0;
+        while (guess < kMaxRiceParameter && ((uint64)n << (guess + 1)) <= sum) {
+            guess++;
+        }
+        uint32 best = guess;
+        uint64 bestBits = ~(uint64)0;
+        for (uint32 k = guess > 0 ? guess - 1 : 0; k <= std::min(guess + 1, kMaxRiceParameter); k++) {
+            uint64 bits = (uint64)n * (k + 1);
+            for (int32 i = 0; i < n; i++) {
+                bits += residuals[i] >> k;
+            }
+            if (bits < bestBits) {
+                bestBits = bits;
+                best = k;
+            }
+        }
+
+        writer.Put(best, kRiceParameterBits);
+        for (int32 i = 0; i < n; i++) {
+            writer.PutRice(residuals[i], best);
+        }
+        start = end;
+    }
+}
+
+void DecodeChannel(BitReader& reader, int32* x, int32 count)
+{
+    int32 order = (int32)reader.Get(kOrderBits);
+    if (order == (int32)kConstantChannel) {
+        std::fill(x, x + count, UnZigZag(reader.Get(kWarmupBits)));
+        return;
+    }
+    for (int32 i = 0; i < order && i < count; i++) {
+        x[i] = UnZigZag(reader.Get(kWarmupBits));
+    }
+
+    for (int32 start = order; start < count; ) {
+        int32 end = std::min(count, (start / CompressedSampleStore::kPartitionSamples + 1)
+                                    * CompressedSampleStore::kPartitionSamples);
+        uint32 parameter = reader.Get(kRiceParameterBits);
+        for (int32 i = start; i < end; i++) {
+            int32 residual = UnZigZag(reader.GetRice(parameter));
+            switch (order) {
+                case 0: x[i] = residual; break;
+                case 1: x[i] = residual + x[i - 1]; break;
+                case 2: x[i] = residual + 2 * x[i - 1] - x[i - 2]; break;
+                case 3: x[i] = residual + 3 * x[i - 1] - 3 * x[i - 2] + x[i - 3]; break;
+                default: x[i] = residual + 4 * x[i - 1] - 6 * x[i - 2] + 4 * x[i - 3] - x[i - 4]; break;
+            }
+        }
+        start = end;
+    }
+}
+
+} // namespace
+
+// #pragma mark - BlockCache
+
+CompressedSampleStore::BlockCache::BlockCache(int32 blocks)
+    : fData((size_t)std::max<int32>(1, blocks) * kBlockFrames * 2),
+      fSlots(std::max<int32>(1, blocks)),
+      fClock(0),
+      fHits(0),
+      fMisses(0)
+{
+    Clear();
+}
+
+const int16_t* CompressedSampleStore::BlockCache::Get(const CompressedSampleStore& store,
+                                                      int64 block, int32* frames)
+{
+    fClock++;
+
+    size_t victim = 0;
+    for (size_t i = 0; i < fSlots.size(); i++) {
+        Slot& slot = fSlots[i];
+        if (slot.store == store.fSerial && slot.block == block) {
+            slot.lastUsed = fClock;
+            fHits++;
+            *frames = slot.frames;
+            return &fData[i * kBlockFrames * 2];
+        }
+        if (slot.lastUsed < fSlots[victim].lastUsed) {
+            victim = i;
+        }
+    }
+
+    fMisses++;
+    Slot& slot = fSlots[victim];
+    int16_t* data = &fData[victim * kBlockFrames * 2];
+    slot.store = store.fSerial;
+    slot.block = block;
+    slot.frames = store.DecodeBlock(block, data);
+    slot.lastUsed = fClock;
+    *frames = slot.frames;
+    return data;
+}
+
+void CompressedSampleStore::BlockCache::Clear()
+{
+    for (Slot& slot : fSlots) {
+        slot.store = 0;
+        slot.block = -1;
+        slot.frames = 0;
+        slot.lastUsed = 0;
+    }
+}
+
+// #pragma mark - CompressedSampleStore
+
+CompressedSampleStore::CompressedSampleStore()
+    : fSerial(sNextSerial.fetch_add(1)),
+      fFrames(0),
+      fSharedCache(BlockCache::kDefaultBlocks)
+{
+}
+
+void CompressedSampleStore::Append(const int16_t* frames, int64 count)
+{
+    while (count > 0) {
+        int64 room = kBlockFrames - (int64)fPending.size() / 2;
+        int64 take = std::min(room, count);
+        fPending.insert(fPending.end(), frames, frames + take * 2);
+        frames += take * 2;
+        count -= take;
+
+        if ((int64)fPending.size() == (int64)kBlockFrames * 2) {
+            _EncodeBlock(fPending.data(), kBlockFrames);
+            fPending.clear();
+        }
+    }
+}
+
+void CompressedSampleStore::Finish()
+{
+    if (!fPending.empty()) {
+        _EncodeBlock(fPending.data(), (int32)(fPending.size() / 2));
+    }
+    std::vector<int16_t>().swap(fPending);
+    fData.shrink_to_fit();
+    fBlockOffsets.shrink_to_fit();
+}
+
+void CompressedSampleStore::Assign(const int16_t* frames, int64 count)
+{
+    fData.clear();
+    fBlockOffsets.clear();
+    fPending.clear();
+    fFrames = 0;
+    fSerial = sNextSerial.fetch_add(1);
+
+    // Whole blocks straight from the buffer
+    int64 whole = count / kBlockFrames * kBlockFrames;
+    for (int64 frame = 0; frame < whole; frame += kBlockFrames) {
+        _EncodeBlock(frames + frame * 2, kBlockFrames);
+    }
+    Append(frames + whole * 2, count - whole);
+    Finish();
+}
+
+size_t CompressedSampleStore::GetCompressedBytes() const
+{
+    return fData.capacity() + fBlockOffsets.capacity() * sizeof(uint64_t)
+           + fPending.capacity() * sizeof(int16_t);
+}
+
+void CompressedSampleStore::_EncodeBlock(const int16_t* frames, int32 count)
+{
+    // Candidate channels: left, right, side, mid
+    int32 left[kBlockFrames];
+    int32 right[kBlockFrames];
+    int32 side[kBlockFrames];
+    int32 mid[kBlockFrames];
+    for (int32 i = 0; i < count; i++) {
+        left[i] = frames[i * 2];
+        right[i] = frames[i * 2 + 1];
+        side[i] = left[i] - right[i];
+        mid[i] = (left[i] + right[i]) >> 1;
+    }
+
+    uint64 leftCost, rightCost, sideCost, midCost;
+    BestOrder(left, count, &leftCost);
+    BestOrder(right, count, &rightCost);
+    BestOrder(side, count, &sideCost);
+    BestOrder(mid, count, &midCost);
+
+    StereoMode mode = kLeftRight;
+    uint64 best = leftCost + rightCost;
+    if (leftCost + sideCost < best) {
+        mode = kLeftSide;
+        best = leftCost + sideCost;
+    }
+    if (sideCost + rightCost < best) {
+        mode = kSideRight;
+        best = sideCost + rightCost;
+    }
+    if (midCost + sideCost < best) {
+        mode = kMidSide;
+    }
+
+    const int32* first = mode == kSideRight ? side : mode == kMidSide ? mid : left;
+    const int32* second = mode == kLeftRight ? right : mode == kSideRight ? right : side;
+    if (mode == kSideRight) {
+        std::swap(first, second);   // Side is coded second, like the others
+    }
+
+    size_t start = fData.size();
+    fBlockOffsets.push_back(start);
+    fFrames += count;
+
+    fData.push_back((uint8_t)mode);
+    BitWriter writer(fData);
+    EncodeChannel(writer, first, count);
+    EncodeChannel(writer, second, count);
+    writer.Flush();
+
+    // Noise does not compress; keep it as it is
+    size_t verbatim = 1 + (size_t)count * 2 * sizeof(int16_t);
+    if (fData.size() - start > verbatim) {
+        fData.resize(start);
+        fData.push_back(kVerbatimFlag);
+        for (int32 i = 0; i < count * 2; i++) {
+            uint16 sample = (uint16)frames[i];
+            fData.push_back((uint8_t)sample);
+            fData.push_back((uint8_t)(sample >> 8));
+        }
+    }
+}
+
+int32 CompressedSampleStore::DecodeBlock(int64 block, int16_t* dest) const
+{
+    if (block < 0 || block >= CountBlocks()) {
+        return 0;
+    }
+
+    int32 count = (int32)std::min<int64>(kBlockFrames, fFrames - block * kBlockFrames);
+    const uint8_t* data = fData.data() + fBlockOffsets[block];
+    const uint8_t* end = block + 1 < CountBlocks()
+        ? fData.data() + fBlockOffsets[block + 1] : fData.data() + fData.size();
+
+    uint8_t header = *data++;
+    if (header & kVerbatimFlag) {
+        for (int32 i = 0; i < count * 2; i++) {
+            dest[i] = (int16_t)(uint16)(data[i * 2] | (data[i * 2 + 1] << 8));
+        }
+        return count;
+    }
+
+    int32 first[kBlockFrames];
+    int32 second[kBlockFrames];
+    BitReader reader(data, end);
+    DecodeChannel(reader, first, count);
+    DecodeChannel(reader, second, count);
+
+    switch ((StereoMode)(header & 3)) {
+        case kLeftRight:
+            for (int32 i = 0; i < count; i++) {
+                dest[i * 2] = (int16_t)first[i];
+                dest[i * 2 + 1] = (int16_t)second[i];
+            }
+            break;
+        case kLeftSide:
+            for (int32 i = 0; i < count; i++) {
+                dest[i * 2] = (int16_t)first[i];
+                dest[i * 2 + 1] = (int16_t)(first[i] - second[i]);
+            }
+            break;
+        case kSideRight:
+            // Right first, side second
+            for (int32 i = 0; i < count; i++) {
+                dest[i * 2] = (int16_t)(second[i] + first[i]);
+                dest[i * 2 + 1] = (int16_t)first[i];
+            }
+            break;
+        case kMidSide:
+            for (int32 i = 0; i < count; i++) {
+                int32 side = second[i];
+                int32 mid = (first[i] * 2) | (side & 1);
+                dest[i * 2] = (int16_t)((mid + side) >> 1);
+                dest[i * 2 + 1] = (int16_t)((mid - side) >> 1);
+            }
+            break;
+    }
+    return count;
+}
+
+int64 CompressedSampleStore::ReadFrames(int64 frame, int16_t* dest, int64 frames,
+                                        BlockCache& cache) const
+{
+    if (frame < 0 || frame >= fFrames || frames <= 0) {
+        return 0;
+    }
+    frames = std::min(frames, fFrames - frame);
+
+    int64 done = 0;
+    while (done < frames) {
+        int64 block = (frame + done) / kBlockFrames;
+        int32 offset = (int32)((frame + done) - block * kBlockFrames);
+        int32 blockFrames;
+        const int16_t* data = cache.Get(*this, block, &blockFrames);
+        int64 count = std::min<int64>(blockFrames - offset, frames - done);
+        if (count <= 0) {
+            break;
+        }
+        memcpy(dest + done * 2, data + offset * 2, count * 2 * sizeof(int16_t));
+        done += count;
+    }
+    return done;
+}
+
+int64 CompressedSampleStore::ReadFrames(int64 frame, int16_t* dest, int64 frames) const
+{
+    std::lock_guard<std::mutex> lock(fSharedLock);
+    return ReadFrames(frame, dest, frames, fSharedCache);
+}
+
+} // namespace VeniceDAW
@@ -1,4 +1,6 @@
 #include "DSPAlgorithms.h"
+#include "FFT.h"
+#include "FastApprox.h"
 #include <cstring>
 #include <algorithm>
 
@@ -250,9 +252,30 @@ float EnvelopeFollower::ProcessSample(float input) {
 }
 
 void EnvelopeFollower::ProcessBlock(const float* input, float* envelope, size_t numSamples) {
-    for (size_t i = 0; i < numSamples; ++i) {
-        envelope[i] = ProcessSample(input[i]);
+    // Run the recursion alone with the state in a register, then take the
+    // square roots in a separate pass that vectorizes
+    float state = m_envelope;
+    const float attack = m_attackCoeff;
+    const float release = m_releaseCoeff;
+    
+    if (m_rmsMode) {
+        for (size_t i = 0; i < numSamples; ++i) {
+            const float rectified = input[i] * input[i];
+            state += (rectified > state ? attack : release) * (rectified - state);
+            envelope[i] = state;
+        }
+        for (size_t i = 0; i < numSamples; ++i) {
+            envelope[i] = std::sqrt(envelope[i]);
+        }
+    } else {
+        for (size_t i = 0; i < numSamples; ++i) {
+            const float rectified = std::abs(input[i]);
+            state += (rectified > state ? attack : release) * (rectified - state);
+            envelope[i] = state;
+        }
     }
+    
+    m_envelope = state;
 }
 
 void EnvelopeFollower::Reset() {
@@ -282,8 +305,43 @@ float SoftClipper::ProcessSample(float input) {
 }
 
 void SoftClipper::ProcessBlock(const float* input, float* output, size_t numSamples) {
-    for (size_t i = 0; i < numSamples; ++i) {
-        output[i] = ApplyClipping(input[i]);
+    // The clip type is fixed for the block; the transcendental curves use
+    // the vectorized approximations (error <= 3e-7 of the threshold)
+    const float threshold = m_threshold;
+    const float inverseThreshold = 1.0f / threshold;
+    
+    switch (m_type) {
+        case HardClip:
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] = std::max(-threshold, std::min(threshold, input[i]));
+            }
+            break;
+            
+        case Tanh:
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] = input[i] * inverseThreshold;
+            }
+            FastApprox::Tanh(output, output, numSamples);
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] *= threshold;
+            }
+            break;
+            
+        case Sigmoid:
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] = 2.0f * input[i] * inverseThreshold;
+            }
+            FastApprox::Sigmoid(output, output, numSamples);
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] = threshold * (2.0f * output[i] - 1.0f);
+            }
+            break;
+            
+        default:
+            for (size_t i = 0; i < numSamples; ++i) {
+                output[i] = ApplyClipping(input[i]);
+            }
+            break;
     }
 }
 
@@ -414,6 +472,111 @@ void DCBlocker::Reset() {
     m_x1 = m_y1 = 0.0f;
 }
 
+SlidingPeakDetector::SlidingPeakDetector(size_t windowLength)
+    : m_window(0)
+    , m_mask(0)
+    , m_head(0)
+    , m_size(0)
+    , m_count(0) {
+    SetWindowLength(windowLength);
+}
+
+void SlidingPeakDetector::SetWindowLength(size_t windowLength) {
+    m_window = std::max<size_t>(1, windowLength);
+
+    // The deque never holds more than m_window entries; a power-of-two
+    // ring lets push/pop wrap with a mask.
+    size_t capacity = 1;
+    while (capacity < m_window) {
+        capacity <<= 1;
+    }
+    m_values.assign(capacity, 0.0f);
+    m_indices.assign(capacity, 0);
+    m_mask = capacity - 1;
+    Reset();
+}
+
+float SlidingPeakDetector::ProcessSample(float input) {
+    const float value = std::abs(input);
+    const uint64_t index = m_count++;
+
+    // Drop the oldest entry once it falls out of the window; at most one
+    // can expire per sample since indices are unique
+    if (m_size > 0 && m_indices[m_head] + m_window <= index) {
+        m_head = (m_head + 1) & m_mask;
+        --m_size;
+    }
+
+    // Entries not larger than the new sample can never be the max again
+    while (m_size > 0 && m_values[(m_head + m_size - 1) & m_mask] <= value) {
+        --m_size;
+    }
+
+    const size_t tail = (m_head + m_size) & m_mask;
+    m_values[tail] = value;
+    m_indices[tail] = index;
+    ++m_size;
+
+    return m_values[m_head];
+}
+
+void SlidingPeakDetector::ProcessBlock(const float* input, float* peaks, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        peaks[i] = ProcessSample(input[i]);
+    }
+}
+
+void SlidingPeakDetector::Reset() {
+    m_head = 0;
+    m_size = 0;
+    m_count = 0;
+}
+
+SlidingRMSDetector::SlidingRMSDetector(size_t windowLength)
+    : m_sum(0.0)
+    , m_position(0) {
+    SetWindowLength(windowLength);
+}
+
+void SlidingRMSDetector::SetWindowLength(size_t windowLength) {
+    m_squares.assign(std::max<size_t>(1, windowLength), 0.0f);
+    Reset();
+}
+
+float SlidingRMSDetector::ProcessSample(float input) {
+    const float square = input * input;
+    m_sum += static_cast<double>(square) - m_squares[m_position];
+    m_squares[m_position] = square;
+
+    if (++m_position == m_squares.size()) {
+        m_position = 0;
+        Resum();
+    }
+
+    const double mean = std::max(0.0, m_sum) / static_cast<double>(m_squares.size());
+    return static_cast<float>(std::sqrt(mean));
+}
+
+void SlidingRMSDetector::ProcessBlock(const float* input, float* rms, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        rms[i] = ProcessSample(input[i]);
+    }
+}
+
+void SlidingRMSDetector::Reset() {
+    std::fill(m_squares.begin(), m_squares.end(), 0.0f);
+    m_sum = 0.0;
+    m_position = 0;
+}
+
+void SlidingRMSDetector::Resum() {
+    double sum = 0.0;
+    for (float square : m_squares) {
+        sum += square;
+    }
+    m_sum = sum;
+}
+
 // Spatial Audio Processing Implementation
 
 // DelayLine implementation
@@ -464,20 +627,20 @@ float DelayLine::InterpolatedRead(float delaySamples) const {
     return m_buffer[index1] * (1.0f - frac) + m_buffer[index2] * frac;
 }
 
-// ConvolutionEngine implementation
-ConvolutionEngine::ConvolutionEngine(size_t maxImpulseLength) 
+// DirectConvolutionEngine implementation
+DirectConvolutionEngine::DirectConvolutionEngine(size_t maxImpulseLength) 
     : m_impulseLength(0), m_bufferSize(maxImpulseLength), m_writeIndex(0) {
     m_impulseResponse = new float[maxImpulseLength];
     m_delayLine = new float[maxImpulseLength];
     Reset();
 }
 
-ConvolutionEngine::~ConvolutionEngine() {
+DirectConvolutionEngine::~DirectConvolutionEngine() {
     delete[] m_impulseResponse;
     delete[] m_delayLine;
 }
 
-void ConvolutionEngine::SetImpulseResponse(const float* impulse, size_t length) {
+void DirectConvolutionEngine::SetImpulseResponse(const float* impulse, size_t length) {
     m_impulseLength = std::min(length, m_bufferSize);
     for (size_t i = 0; i < m_impulseLength; ++i) {
         m_impulseResponse[i] = impulse[i];
@@ -487,7 +650,7 @@ void ConvolutionEngine::SetImpulseResponse(const float* impulse, size_t length)
     }
 }
 
-float ConvolutionEngine::ProcessSample(float input) {
+float DirectConvolutionEngine::ProcessSample(float input) {
     m_delayLine[m_writeIndex] = input;
     
     float output = 0.0f;
@@ -500,19 +663,224 @@ float ConvolutionEngine::ProcessSample(float input) {
     return output;
 }
 
-void ConvolutionEngine::ProcessBlock(const float* input, float* output, size_t numSamples) {
+void DirectConvolutionEngine::ProcessBlock(const float* input, float* output, size_t numSamples) {
     for (size_t i = 0; i < numSamples; ++i) {
         output[i] = ProcessSample(input[i]);
     }
 }
 
-void ConvolutionEngine::Reset() {
+void DirectConvolutionEngine::Reset() {
     for (size_t i = 0; i < m_bufferSize; ++i) {
         m_delayLine[i] = 0.0f;
     }
     m_writeIndex = 0;
 }
 
+// ConvolutionEngine implementation
+//
+// Each stage is a uniformly partitioned overlap-save convolver with
+// partition size N, covering the impulse from `offset` onwards. A stage
+// fires every N input samples and its N output samples are played out
+// over the following N samples, i.e. with a latency of N. Placing the
+// stage at offset N - blockSize makes that latency line up exactly with
+// the engine's one-block latency, so no extra delay lines are needed.
+struct ConvolutionEngine::Stage {
+    size_t partitionSize;
+    size_t offset;
+    size_t partitionCount;
+    size_t activePartitions;
+    size_t spectrumSize;
+    
+    FFT fft;
+    std::vector<float> irSpectra;      // partitionCount spectra
+    std::vector<float> inputSpectra;   // Frequency-domain delay line
+    size_t head;
+    
+    std::vector<float> frame;          // Previous + current input block (2N)
+    size_t fill;
+    std::vector<float> accumulator;
+    std::vector<float> scratch;
+    std::vector<float> output;         // N samples being played out
+    size_t outputPos;
+    
+    Stage(size_t size, size_t irOffset, size_t count)
+        : partitionSize(size), offset(irOffset), partitionCount(count)
+        , activePartitions(0), spectrumSize(2 * size + 2), fft(2 * size)
+        , irSpectra(count * (2 * size + 2), 0.0f)
+        , inputSpectra(count * (2 * size + 2), 0.0f), head(0)
+        , frame(2 * size, 0.0f), fill(0)
+        , accumulator(2 * size + 2, 0.0f), scratch(2 * size, 0.0f)
+        , output(size, 0.0f), outputPos(0) {
+    }
+};
+
+ConvolutionEngine::ConvolutionEngine(size_t maxImpulseLength, size_t blockSize,
+                                     PartitionMode mode)
+    : m_maxImpulseLength(std::max<size_t>(1, maxImpulseLength))
+    , m_blockSize(2)
+    , m_blockPos(0) {
+    // The FFT needs a power-of-two partition size of at least 2
+    while (m_blockSize < blockSize && m_blockSize < kMaxPartitionSize) {
+        m_blockSize *= 2;
+    }
+    m_inputBlock.resize(m_blockSize, 0.0f);
+    m_outputBlock.resize(m_blockSize, 0.0f);
+    
+    const size_t uniformPartitions = (m_maxImpulseLength + m_blockSize - 1) / m_blockSize;
+    if (mode == Uniform || (mode == Automatic && uniformPartitions <= kMaxUniformPartitions)) {
+        AddStage(m_blockSize, 0, uniformPartitions);
+        return;
+    }
+    
+    // Each stage holds three partitions before handing over to a stage
+    // with 4x larger partitions; with that ratio every stage starts exactly
+    // at its own alignment offset (partitionSize - blockSize).
+    size_t offset = 0;
+    size_t size = m_blockSize;
+    while (offset < m_maxImpulseLength) {
+        const size_t remaining = m_maxImpulseLength - offset;
+        if (remaining <= 3 * size || size * 4 > kMaxPartitionSize) {
+            AddStage(size, offset, (remaining + size - 1) / size);
+            break;
+        }
+        AddStage(size, offset, 3);
+        offset += 3 * size;
+        size *= 4;
+    }
+}
+
+ConvolutionEngine::~ConvolutionEngine() {
+}
+
+void ConvolutionEngine::AddStage(size_t partitionSize, size_t offset, size_t partitionCount) {
+    m_stages.emplace_back(new Stage(partitionSize, offset, partitionCount));
+}
+
+void ConvolutionEngine::SetImpulseResponse(const float* impulse, size_t length) {
+    length = std::min(length, m_maxImpulseLength);
+    
+    for (auto& stagePtr : m_stages) {
+        Stage& stage = *stagePtr;
+        const size_t N = stage.partitionSize;
+        
+        stage.activePartitions = 0;
+        for (size_t p = 0; p < stage.partitionCount; ++p) {
+            const size_t begin = stage.offset + p * N;
+            const size_t end = std::min(length, begin + N);
+            
+            std::fill(stage.scratch.begin(), stage.scratch.end(), 0.0f);
+            if (begin < end) {
+                std::copy(impulse + begin, impulse + end, stage.scratch.begin());
+                stage.activePartitions = p + 1;
+            }
+            stage.fft.ForwardReal(stage.scratch.data(),
+                                  stage.irSpectra.data() + p * stage.spectrumSize);
+        }
+    }
+}
+
+float ConvolutionEngine::ProcessSample(float input) {
+    m_inputBlock[m_blockPos] = input;
+    const float output = m_outputBlock[m_blockPos];
+    
+    if (++m_blockPos == m_blockSize) {
+        RunBlock();
+        m_blockPos = 0;
+    }
+    
+    return output;
+}
+
+void ConvolutionEngine::ProcessBlock(const float* input, float* output, size_t numSamples) {
+    size_t done = 0;
+    while (done < numSamples) {
+        const size_t count = std::min(numSamples - done, m_blockSize - m_blockPos);
+        
+        // Read the input chunk before writing output so in-place use works
+        std::memcpy(m_inputBlock.data() + m_blockPos, input + done, count * sizeof(float));
+        std::memcpy(output + done, m_outputBlock.data() + m_blockPos, count * sizeof(float));
+        
+        m_blockPos += count;
+        done += count;
+        
+        if (m_blockPos == m_blockSize) {
+            RunBlock();
+            m_blockPos = 0;
+        }
+    }
+}
+
+void ConvolutionEngine::Reset() {
+    for (auto& stagePtr : m_stages) {
+        Stage& stage = *stagePtr;
+        std::fill(stage.inputSpectra.begin(), stage.inputSpectra.end(), 0.0f);
+        std::fill(stage.frame.begin(), stage.frame.end(), 0.0f);
+        std::fill(stage.output.begin(), stage.output.end(), 0.0f);
+        stage.head = 0;
+        stage.fill = 0;
+        stage.outputPos = 0;
+    }
+    std::fill(m_inputBlock.begin(), m_inputBlock.end(), 0.0f);
+    std::fill(m_outputBlock.begin(), m_outputBlock.end(), 0.0f);
+    m_blockPos = 0;
+}
+
+void ConvolutionEngine::RunBlock() {
+    std::fill(m_outputBlock.begin(), m_outputBlock.end(), 0.0f);
+    
+    for (auto& stagePtr : m_stages) {
+        Stage& stage = *stagePtr;
+        const size_t N = stage.partitionSize;
+        
+        std::memcpy(stage.frame.data() + N + stage.fill, m_inputBlock.data(),
+                    m_blockSize * sizeof(float));
+        stage.fill += m_blockSize;
+        
+        if (stage.fill == N) {
+            ProcessStage(stage);
+            stage.fill = 0;
+            stage.outputPos = 0;
+        }
+        
+        const float* source = stage.output.data() + stage.outputPos;
+        for (size_t i = 0; i < m_blockSize; ++i) {
+            m_outputBlock[i] += source[i];
+        }
+        stage.outputPos += m_blockSize;
+    }
+}
+
+void ConvolutionEngine::ProcessStage(Stage& stage) {
+    const size_t N = stage.partitionSize;
+    const size_t spectrumSize = stage.spectrumSize;
+    const size_t bins = N + 1;
+    
+    float* current = stage.inputSpectra.data() + stage.head * spectrumSize;
+    stage.fft.ForwardReal(stage.frame.data(), current);
+    
+    if (stage.activePartitions > 0) {
+        std::fill(stage.accumulator.begin(), stage.accumulator.end(), 0.0f);
+        
+        // Partition p meets the input spectrum from p blocks ago
+        size_t slot = stage.head;
+        for (size_t p = 0; p < stage.activePartitions; ++p) {
+            FFT::MultiplyAccumulate(stage.inputSpectra.data() + slot * spectrumSize,
+                                    stage.irSpectra.data() + p * spectrumSize,
+                                    stage.accumulator.data(), bins);
+            slot = (slot == 0) ? stage.partitionCount - 1 : slot - 1;
+        }
+        
+        // Overlap-save: only the second half of the circular result is valid
+        stage.fft.InverseReal(stage.accumulator.data(), stage.scratch.data());
+        std::memcpy(stage.output.data(), stage.scratch.data() + N, N * sizeof(float));
+    } else {
+        std::fill(stage.output.begin(), stage.output.end(), 0.0f);
+    }
+    
+    std::memcpy(stage.frame.data(), stage.frame.data() + N, N * sizeof(float));
+    stage.head = (stage.head + 1) % stage.partitionCount;
+}
+
 // Vector3D implementation
 float Vector3D::Distance(const Vector3D& other) const {
     return (*this - other).Magnitude();
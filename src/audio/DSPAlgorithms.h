@@ -2,8 +2,11 @@
 #define DSP_ALGORITHMS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace VeniceDAW {
 namespace DSP {
@@ -145,6 +148,57 @@ private:
     float m_R;
 };
 
+// Running max of |x| over the last N samples (the current one included),
+// in amortised O(1) per sample. A monotonic deque keeps only the samples
+// that can still become the maximum; it is stored in a fixed ring so no
+// allocation happens after SetWindowLength().
+class SlidingPeakDetector {
+public:
+    explicit SlidingPeakDetector(size_t windowLength = 1);
+    ~SlidingPeakDetector() = default;
+
+    void SetWindowLength(size_t windowLength);
+    size_t GetWindowLength() const { return m_window; }
+
+    float ProcessSample(float input);
+    void ProcessBlock(const float* input, float* peaks, size_t numSamples);
+
+    void Reset();
+
+private:
+    std::vector<float> m_values;
+    std::vector<uint64_t> m_indices;
+    size_t m_window;
+    size_t m_mask;
+    size_t m_head;
+    size_t m_size;
+    uint64_t m_count;
+};
+
+// Running RMS over the last N samples. The sum of squares is updated
+// incrementally and recomputed exactly once per window so rounding error
+// cannot accumulate.
+class SlidingRMSDetector {
+public:
+    explicit SlidingRMSDetector(size_t windowLength = 1);
+    ~SlidingRMSDetector() = default;
+
+    void SetWindowLength(size_t windowLength);
+    size_t GetWindowLength() const { return m_squares.size(); }
+
+    float ProcessSample(float input);
+    void ProcessBlock(const float* input, float* rms, size_t numSamples);
+
+    void Reset();
+
+private:
+    std::vector<float> m_squares;
+    double m_sum;
+    size_t m_position;
+
+    void Resum();
+};
+
 // Spatial Audio Processing Components
 class DelayLine {
 public:
@@ -165,15 +219,19 @@ private:
     float InterpolatedRead(float delaySamples) const;
 };
 
-class ConvolutionEngine {
+// Direct-form FIR convolution: one dot product over the whole impulse
+// response per sample, zero latency. Kept as the reference implementation
+// for tests and benchmarks; use ConvolutionEngine for real processing.
+class DirectConvolutionEngine {
 public:
-    ConvolutionEngine(size_t maxImpulseLength);
-    ~ConvolutionEngine();
+    DirectConvolutionEngine(size_t maxImpulseLength);
+    ~DirectConvolutionEngine();
     
     void SetImpulseResponse(const float* impulse, size_t length);
     float ProcessSample(float input);
     void ProcessBlock(const float* input, float* output, size_t numSamples);
     void Reset();
+    size_t GetLatencySamples() const { return 0; }
     
 private:
     float* m_impulseResponse;
@@ -183,6 +241,62 @@ private:
     size_t m_writeIndex;
 };
 
+// Partitioned overlap-save FFT convolution.
+//
+// The impulse response is cut into partitions whose spectra are computed
+// once in SetImpulseResponse(). Every input block is transformed once and
+// multiplied against all partition spectra through a frequency-domain
+// delay line, so the per-sample cost grows with log(blockSize) and the
+// number of partitions instead of with the number of taps.
+//
+// Uniform mode uses blockSize-sized partitions throughout. NonUniform mode
+// starts with blockSize partitions and grows them 4x per stage, so long
+// reverb tails are covered by a few large FFTs. Automatic picks NonUniform
+// once the impulse would need more than kMaxUniformPartitions partitions.
+//
+// Output is delayed by GetLatencySamples() (one block). All memory is
+// allocated in the constructor; processing never allocates.
+class ConvolutionEngine {
+public:
+    enum PartitionMode {
+        Uniform,
+        NonUniform,
+        Automatic
+    };
+    
+    static constexpr size_t kDefaultBlockSize = 64;
+    static constexpr size_t kMaxUniformPartitions = 16;
+    static constexpr size_t kMaxPartitionSize = 8192;
+    
+    ConvolutionEngine(size_t maxImpulseLength, size_t blockSize = kDefaultBlockSize,
+                      PartitionMode mode = Automatic);
+    ~ConvolutionEngine();
+    
+    void SetImpulseResponse(const float* impulse, size_t length);
+    float ProcessSample(float input);
+    void ProcessBlock(const float* input, float* output, size_t numSamples);
+    void Reset();
+    
+    size_t GetLatencySamples() const { return m_blockSize; }
+    size_t GetBlockSize() const { return m_blockSize; }
+    size_t GetMaxImpulseLength() const { return m_maxImpulseLength; }
+    size_t GetStageCount() const { return m_stages.size(); }
+    
+private:
+    struct Stage;
+    
+    size_t m_maxImpulseLength;
+    size_t m_blockSize;
+    size_t m_blockPos;
+    std::vector<float> m_inputBlock;
+    std::vector<float> m_outputBlock;
+    std::vector<std::unique_ptr<Stage>> m_stages;
+    
+    void AddStage(size_t partitionSize, size_t offset, size_t partitionCount);
+    void ProcessStage(Stage& stage);
+    void RunBlock();
+};
+
 struct Vector3D {
     float x, y, z;
     
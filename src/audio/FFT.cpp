@@ -0,0 +1,512 @@
+#include "FFT.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// Include SIMD headers if available on x86/x64
+#if defined(__i386__) || defined(__x86_64__)
+    #include <xmmintrin.h>  // SSE
+    #include <emmintrin.h>  // SSE2
+    #ifdef __AVX__
+        #include <immintrin.h>  // AVX
+    #endif
+    #define FFT_HAVE_SSE2 1
+#endif
+
+namespace VeniceDAW {
+namespace DSP {
+
+static constexpr double TWO_PI = 6.28318530717958647692;
+
+namespace {
+
+// Vector abstractions used by the radix kernels. Each holds kWidth
+// interleaved complex values; the same butterfly code is instantiated for
+// all of them. `sign` is -1 for forward and +1 for inverse transforms.
+
+struct ScalarOps {
+    struct V { float re, im; };
+    static const size_t kWidth = 1;
+
+    static V Load(const float* p) { return {p[0], p[1]}; }
+    static void Store(float* p, V v) { p[0] = v.re; p[1] = v.im; }
+    static V Add(V a, V b) { return {a.re + b.re, a.im + b.im}; }
+    static V Sub(V a, V b) { return {a.re - b.re, a.im - b.im}; }
+    static V Scale(V a, float c) { return {a.re * c, a.im * c}; }
+    // sign * i * a
+    static V MulI(V a, float sign) { return {-sign * a.im, sign * a.re}; }
+    static V Twiddle(V a, float wr, float wi) {
+        return {a.re * wr - a.im * wi, a.re * wi + a.im * wr};
+    }
+};
+
+#ifdef FFT_HAVE_SSE2
+struct SSE2Ops {
+    typedef __m128 V;
+    static const size_t kWidth = 2;
+
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Scale(V a, float c) { return _mm_mul_ps(a, _mm_set1_ps(c)); }
+    static V Swap(V a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static V MulI(V a, float sign) {
+        return _mm_mul_ps(Swap(a), _mm_set_ps(sign, -sign, sign, -sign));
+    }
+    static V Twiddle(V a, float wr, float wi) {
+        return _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(wr)),
+                          _mm_mul_ps(Swap(a), _mm_set_ps(wi, -wi, wi, -wi)));
+    }
+};
+#endif
+
+#ifdef __AVX__
+struct AVXOps {
+    typedef __m256 V;
+    static const size_t kWidth = 4;
+
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Scale(V a, float c) { return _mm256_mul_ps(a, _mm256_set1_ps(c)); }
+    static V Swap(V a) { return _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static V MulI(V a, float sign) {
+        return _mm256_mul_ps(Swap(a), _mm256_set_ps(sign, -sign, sign, -sign,
+                                                    sign, -sign, sign, -sign));
+    }
+    static V Twiddle(V a, float wr, float wi) {
+        return _mm256_add_ps(_mm256_mul_ps(a, _mm256_set1_ps(wr)),
+                             _mm256_mul_ps(Swap(a), _mm256_set_ps(wi, -wi, wi, -wi,
+                                                                  wi, -wi, wi, -wi)));
+    }
+};
+#endif
+
+// Small DFT butterflies. in[j] are the radix inputs, out[k] the outputs
+// before twiddling.
+template <class Ops, size_t R> struct Butterfly;
+
+template <class Ops> struct Butterfly<Ops, 2> {
+    typedef typename Ops::V V;
+    static void Run(const V* a, V* y, float) {
+        y[0] = Ops::Add(a[0], a[1]);
+        y[1] = Ops::Sub(a[0], a[1]);
+    }
+};
+
+template <class Ops> struct Butterfly<Ops, 3> {
+    typedef typename Ops::V V;
+    static void Run(const V* a, V* y, float sign) {
+        const float s60 = 0.86602540378443864676f;
+        V sum = Ops::Add(a[1], a[2]);
+        V mid = Ops::Sub(a[0], Ops::Scale(sum, 0.5f));
+        V rot = Ops::MulI(Ops::Scale(Ops::Sub(a[1], a[2]), s60), sign);
+        y[0] = Ops::Add(a[0], sum);
+        y[1] = Ops::Add(mid, rot);
+        y[2] = Ops::Sub(mid, rot);
+    }
+};
+
+template <class Ops> struct Butterfly<Ops, 4> {
+    typedef typename Ops::V V;
+    static void Run(const V* a, V* y, float sign) {
+        V t0 = Ops::Add(a[0], a[2]);
+        V t1 = Ops::Sub(a[0], a[2]);
+        V t2 = Ops::Add(a[1], a[3]);
+        V t3 = Ops::MulI(Ops::Sub(a[1], a[3]), sign);
+        y[0] = Ops::Add(t0, t2);
+        y[1] = Ops::Add(t1, t3);
+        y[2] = Ops::Sub(t0, t2);
+        y[3] = Ops::Sub(t1, t3);
+    }
+};
+
+template <class Ops> struct Butterfly<Ops, 5> {
+    typedef typename Ops::V V;
+    static void Run(const V* a, V* y, float sign) {
+        const float c1 = 0.30901699437494742410f;   // cos(2pi/5)
+        const float c2 = -0.80901699437494742410f;  // cos(4pi/5)
+        const float s1 = 0.95105651629515357212f;   // sin(2pi/5)
+        const float s2 = 0.58778525229247312917f;   // sin(4pi/5)
+
+        V b1 = Ops::Add(a[1], a[4]);
+        V b2 = Ops::Add(a[2], a[3]);
+        V d1 = Ops::Sub(a[1], a[4]);
+        V d2 = Ops::Sub(a[2], a[3]);
+
+        V t1 = Ops::Add(a[0], Ops::Add(Ops::Scale(b1, c1), Ops::Scale(b2, c2)));
+        V t2 = Ops::Add(a[0], Ops::Add(Ops::Scale(b1, c2), Ops::Scale(b2, c1)));
+        V u1 = Ops::MulI(Ops::Add(Ops::Scale(d1, s1), Ops::Scale(d2, s2)), sign);
+        V u2 = Ops::MulI(Ops::Sub(Ops::Scale(d1, s2), Ops::Scale(d2, s1)), sign);
+
+        y[0] = Ops::Add(a[0], Ops::Add(b1, b2));
+        y[1] = Ops::Add(t1, u1);
+        y[4] = Ops::Sub(t1, u1);
+        y[2] = Ops::Add(t2, u2);
+        y[3] = Ops::Sub(t2, u2);
+    }
+};
+
+// One Stockham DIF pass over sub-transform columns [qBegin, qEnd):
+//   y[q + s*(R*p + k)] = W_n^(p*k) * sum_j x[q + s*(p + j*m)] * W_R^(j*k)
+// The twiddle only depends on p and k, so it is broadcast across q.
+template <class Ops, size_t R>
+void RunRadix(const FFT::Pass& pass, const float* twiddles, const float* x, float* y,
+              size_t qBegin, size_t qEnd, bool inverse)
+{
+    typedef typename Ops::V V;
+    const size_t s = pass.stride;
+    const size_t m = pass.length / R;
+    const float sign = inverse ? 1.0f : -1.0f;
+    const float conj = inverse ? -1.0f : 1.0f;
+
+    V a[R];
+    V out[R];
+    for (size_t p = 0; p < m; ++p) {
+        const float* w = twiddles + 2 * p * (R - 1);
+        for (size_t q = qBegin; q < qEnd; q += Ops::kWidth) {
+            for (size_t j = 0; j < R; ++j) {
+                a[j] = Ops::Load(x + 2 * (q + s * (p + j * m)));
+            }
+            Butterfly<Ops, R>::Run(a, out, sign);
+            Ops::Store(y + 2 * (q + s * (R * p)), out[0]);
+            for (size_t k = 1; k < R; ++k) {
+                Ops::Store(y + 2 * (q + s * (R * p + k)),
+                           Ops::Twiddle(out[k], w[2 * (k - 1)], conj * w[2 * (k - 1) + 1]));
+            }
+        }
+    }
+}
+
+template <class Ops>
+void DispatchRadix(const FFT::Pass& pass, const float* twiddles, const float* x, float* y,
+                   size_t qBegin, size_t qEnd, bool inverse)
+{
+    switch (pass.radix) {
+        case 2: RunRadix<Ops, 2>(pass, twiddles, x, y, qBegin, qEnd, inverse); break;
+        case 3: RunRadix<Ops, 3>(pass, twiddles, x, y, qBegin, qEnd, inverse); break;
+        case 4: RunRadix<Ops, 4>(pass, twiddles, x, y, qBegin, qEnd, inverse); break;
+        case 5: RunRadix<Ops, 5>(pass, twiddles, x, y, qBegin, qEnd, inverse); break;
+    }
+}
+
+} // namespace
+
+FFT::FFT(size_t size, TransformType type)
+    : m_size(size)
+    , m_type(type)
+    , m_complexSize(type == Real ? size / 2 : size)
+    , m_valid(IsSupportedSize(size, type))
+    , m_optLevel(OPT_SCALAR) {
+    DetectCPUFeatures();
+
+    if (!m_valid) {
+        return;
+    }
+
+    BuildPasses();
+
+    if (m_type == Real) {
+        // Twiddles are computed in double precision so that long transforms
+        // do not accumulate the rounding error of a float recurrence.
+        const size_t half = m_size / 2;
+        m_realTwiddles.resize(2 * half);
+        for (size_t k = 0; k < half; ++k) {
+            const double angle = -TWO_PI * static_cast<double>(k) / static_cast<double>(m_size);
+            m_realTwiddles[2 * k] = static_cast<float>(std::cos(angle));
+            m_realTwiddles[2 * k + 1] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    m_work.resize(4 * m_complexSize, 0.0f);
+}
+
+bool FFT::Factorize(size_t size, std::vector<size_t>& radices) {
+    radices.clear();
+    if (size == 0) {
+        return false;
+    }
+
+    // Radix-4 first: fewest passes, and the stride grows fast enough for
+    // the SIMD kernels to take over from the second pass on.
+    while (size % 4 == 0) { radices.push_back(4); size /= 4; }
+    while (size % 2 == 0) { radices.push_back(2); size /= 2; }
+    while (size % 3 == 0) { radices.push_back(3); size /= 3; }
+    while (size % 5 == 0) { radices.push_back(5); size /= 5; }
+
+    return size == 1;
+}
+
+bool FFT::IsSupportedSize(size_t size, TransformType type) {
+    std::vector<size_t> radices;
+    if (type == Real) {
+        return size >= 2 && size % 2 == 0 && Factorize(size / 2, radices);
+    }
+    return Factorize(size, radices);
+}
+
+void FFT::BuildPasses() {
+    std::vector<size_t> radices;
+    Factorize(m_complexSize, radices);
+
+    m_passes.clear();
+    m_twiddles.clear();
+
+    size_t length = m_complexSize;
+    size_t stride = 1;
+    for (size_t radix : radices) {
+        Pass pass;
+        pass.radix = radix;
+        pass.length = length;
+        pass.stride = stride;
+        pass.twiddleOffset = m_twiddles.size();
+
+        const size_t m = length / radix;
+        for (size_t p = 0; p < m; ++p) {
+            for (size_t k = 1; k < radix; ++k) {
+                const double angle = -TWO_PI * static_cast<double>(p * k) / static_cast<double>(length);
+                m_twiddles.push_back(static_cast<float>(std::cos(angle)));
+                m_twiddles.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        m_passes.push_back(pass);
+        length = m;
+        stride *= radix;
+    }
+}
+
+void FFT::DetectCPUFeatures() {
+    if (HasAVXSupport()) {
+        m_optLevel = OPT_AVX;
+    } else if (HasSSE2Support()) {
+        m_optLevel = OPT_SSE2;
+    } else {
+        m_optLevel = OPT_SCALAR;
+    }
+}
+
+void FFT::SetOptimizationLevel(OptimizationLevel level) {
+    if (level == OPT_AVX && !HasAVXSupport()) {
+        level = OPT_SSE2;
+    }
+    if (level == OPT_SSE2 && !HasSSE2Support()) {
+        level = OPT_SCALAR;
+    }
+    m_optLevel = level;
+}
+
+const char* FFT::GetOptimizationName() const {
+    switch (m_optLevel) {
+        case OPT_AVX: return "AVX";
+        case OPT_SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+bool FFT::HasSSE2Support() {
+#ifdef FFT_HAVE_SSE2
+    // SSE2 is standard on most x86/x64 systems
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FFT::HasAVXSupport() {
+#ifdef __AVX__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FFT::ForwardReal(const float* input, float* spectrum) {
+    if (!m_valid || m_type != Real) {
+        std::memset(spectrum, 0, GetSpectrumSize() * sizeof(float));
+        return;
+    }
+
+    // Pack even/odd samples as one complex sequence of half the length:
+    // z[n] = x[2n] + i*x[2n+1]. This is exactly the input memory layout.
+    float* z = m_work.data();
+    std::memcpy(z, input, m_size * sizeof(float));
+    ComplexTransform(z, false);
+
+    const size_t M = m_complexSize;
+
+    spectrum[0] = z[0] + z[1];
+    spectrum[1] = 0.0f;
+    spectrum[2 * M] = z[0] - z[1];
+    spectrum[2 * M + 1] = 0.0f;
+
+    for (size_t k = 1; k < M; ++k) {
+        const float zr = z[2 * k];
+        const float zi = z[2 * k + 1];
+        const float mr = z[2 * (M - k)];
+        const float mi = -z[2 * (M - k) + 1];   // conj(Z[M-k])
+
+        // Even part: (Z[k] + conj(Z[M-k])) / 2
+        const float er = 0.5f * (zr + mr);
+        const float ei = 0.5f * (zi + mi);
+        // Odd part: (Z[k] - conj(Z[M-k])) / 2i
+        const float orr = 0.5f * (zi - mi);
+        const float oi = -0.5f * (zr - mr);
+
+        const float wr = m_realTwiddles[2 * k];
+        const float wi = m_realTwiddles[2 * k + 1];
+
+        spectrum[2 * k] = er + (wr * orr - wi * oi);
+        spectrum[2 * k + 1] = ei + (wr * oi + wi * orr);
+    }
+}
+
+void FFT::InverseReal(const float* spectrum, float* output) {
+    if (!m_valid || m_type != Real) {
+        std::memset(output, 0, m_size * sizeof(float));
+        return;
+    }
+
+    float* z = m_work.data();
+    const size_t M = m_complexSize;
+
+    for (size_t k = 0; k < M; ++k) {
+        const float xr = spectrum[2 * k];
+        const float xi = spectrum[2 * k + 1];
+        const float mr = spectrum[2 * (M - k)];
+        const float mi = -spectrum[2 * (M - k) + 1];   // conj(X[M-k])
+
+        const float er = 0.5f * (xr + mr);
+        const float ei = 0.5f * (xi + mi);
+        const float dr = 0.5f * (xr - mr);
+        const float di = 0.5f * (xi - mi);
+
+        // Odd part: (X[k] - conj(X[M-k])) * conj(W^k) / 2
+        const float wr = m_realTwiddles[2 * k];
+        const float wi = -m_realTwiddles[2 * k + 1];
+        const float orr = dr * wr - di * wi;
+        const float oi = dr * wi + di * wr;
+
+        // Z[k] = even + i*odd
+        z[2 * k] = er - oi;
+        z[2 * k + 1] = ei + orr;
+    }
+
+    ComplexTransform(z, true);
+
+    const float scale = 1.0f / static_cast<float>(M);
+    for (size_t i = 0; i < m_size; ++i) {
+        output[i] = z[i] * scale;
+    }
+}
+
+void FFT::Forward(const float* input, float* output) {
+    if (!m_valid || m_type != Complex) {
+        std::memset(output, 0, 2 * m_size * sizeof(float));
+        return;
+    }
+
+    if (input != output) {
+        std::memcpy(output, input, 2 * m_size * sizeof(float));
+    }
+    ComplexTransform(output, false);
+}
+
+void FFT::Inverse(const float* input, float* output) {
+    if (!m_valid || m_type != Complex) {
+        std::memset(output, 0, 2 * m_size * sizeof(float));
+        return;
+    }
+
+    if (input != output) {
+        std::memcpy(output, input, 2 * m_size * sizeof(float));
+    }
+    ComplexTransform(output, true);
+
+    const float scale = 1.0f / static_cast<float>(m_size);
+    for (size_t i = 0; i < 2 * m_size; ++i) {
+        output[i] *= scale;
+    }
+}
+
+void FFT::MultiplyAccumulate(const float* a, const float* b,
+                             float* accumulator, size_t bins) {
+    size_t k = 0;
+#if defined(__AVX__)
+    for (; k + 4 <= bins; k += 4) {
+        __m256 va = _mm256_loadu_ps(a + 2 * k);
+        __m256 vb = _mm256_loadu_ps(b + 2 * k);
+        __m256 br = _mm256_moveldup_ps(vb);   // (br, br)
+        __m256 bi = _mm256_movehdup_ps(vb);   // (bi, bi)
+        __m256 swapped = _mm256_permute_ps(va, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 product = _mm256_addsub_ps(_mm256_mul_ps(va, br), _mm256_mul_ps(swapped, bi));
+        _mm256_storeu_ps(accumulator + 2 * k,
+                         _mm256_add_ps(_mm256_loadu_ps(accumulator + 2 * k), product));
+    }
+#elif defined(FFT_HAVE_SSE2)
+    const __m128 signs = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+    for (; k + 2 <= bins; k += 2) {
+        __m128 va = _mm_loadu_ps(a + 2 * k);
+        __m128 vb = _mm_loadu_ps(b + 2 * k);
+        __m128 br = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 bi = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 swapped = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 product = _mm_add_ps(_mm_mul_ps(va, br),
+                                    _mm_mul_ps(_mm_mul_ps(swapped, bi), signs));
+        _mm_storeu_ps(accumulator + 2 * k,
+                      _mm_add_ps(_mm_loadu_ps(accumulator + 2 * k), product));
+    }
+#endif
+    for (; k < bins; ++k) {
+        const float ar = a[2 * k], ai = a[2 * k + 1];
+        const float br = b[2 * k], bi = b[2 * k + 1];
+        accumulator[2 * k] += ar * br - ai * bi;
+        accumulator[2 * k + 1] += ar * bi + ai * br;
+    }
+}
+
+// Mixed-radix Stockham autosort transform: every pass reads one buffer and
+// writes the other, so no digit-reversal permutation is needed and the
+// result comes out in natural order.
+void FFT::ComplexTransform(float* data, bool inverse) {
+    float* x = data;
+    float* y = (data == m_work.data()) ? m_work.data() + 2 * m_complexSize : m_work.data();
+
+    for (const Pass& pass : m_passes) {
+        RunPass(pass, x, y, inverse);
+        std::swap(x, y);
+    }
+
+    if (x != data) {
+        std::memcpy(data, x, 2 * m_complexSize * sizeof(float));
+    }
+}
+
+void FFT::RunPass(const Pass& pass, const float* x, float* y, bool inverse) const {
+    const float* twiddles = m_twiddles.data() + pass.twiddleOffset;
+    const size_t s = pass.stride;
+    size_t vectorEnd = 0;
+
+    // SIMD runs across the s interleaved sub-transforms, which share their
+    // twiddles; the first pass (s == 1) and any remainder stay scalar.
+#ifdef __AVX__
+    if (m_optLevel == OPT_AVX && s >= AVXOps::kWidth) {
+        vectorEnd = s - s % AVXOps::kWidth;
+        DispatchRadix<AVXOps>(pass, twiddles, x, y, 0, vectorEnd, inverse);
+    }
+#endif
+#ifdef FFT_HAVE_SSE2
+    if (vectorEnd == 0 && m_optLevel >= OPT_SSE2 && s >= SSE2Ops::kWidth) {
+        vectorEnd = s - s % SSE2Ops::kWidth;
+        DispatchRadix<SSE2Ops>(pass, twiddles, x, y, 0, vectorEnd, inverse);
+    }
+#endif
+    if (vectorEnd < s) {
+        DispatchRadix<ScalarOps>(pass, twiddles, x, y, vectorEnd, s, inverse);
+    }
+}
+
+}
+}
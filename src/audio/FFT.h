@@ -0,0 +1,103 @@
+#ifndef DSP_FFT_H
+#define DSP_FFT_H
+
+#include <cstddef>
+#include <vector>
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Real or complex FFT plan.
+//
+// A plan factors its size into radix 4/2/3/5 passes, precomputes every
+// twiddle and allocates its scratch memory when it is constructed, so the
+// transform methods never allocate and are safe to call from the audio
+// thread. Create plans off the audio thread. A plan owns its scratch
+// buffer: do not execute the same plan from two threads at once.
+//
+// Supported sizes are 2^a * 3^b * 5^c. Real plans need an even size whose
+// half is such a number (e.g. 64, 96, 480, 1000, 1024, 4800).
+//
+// Layouts:
+// - Complex data is interleaved (re, im), GetSize() pairs.
+// - Real spectra hold GetSize()/2 + 1 interleaved (re, im) bins, i.e.
+//   GetSpectrumSize() floats, DC first and Nyquist last.
+// - Inverse transforms are scaled by 1/size, so Inverse(Forward(x)) == x.
+//
+// Butterflies run through SSE2 or AVX kernels when the CPU provides them,
+// selected the same way AudioLevelCalculator does, with a scalar fallback.
+class FFT {
+public:
+    enum TransformType {
+        Real,
+        Complex
+    };
+
+    enum OptimizationLevel {
+        OPT_SCALAR,
+        OPT_SSE2,
+        OPT_AVX
+    };
+
+    explicit FFT(size_t size, TransformType type = Real);
+    ~FFT() = default;
+
+    size_t GetSize() const { return m_size; }
+    size_t GetSpectrumSize() const { return m_size + 2; }
+    TransformType GetType() const { return m_type; }
+    bool IsValid() const { return m_valid; }
+
+    // Real plans. Unsupported sizes produce silence.
+    void ForwardReal(const float* input, float* spectrum);
+    void InverseReal(const float* spectrum, float* output);
+
+    // Complex plans; input and output may alias.
+    void Forward(const float* input, float* output);
+    void Inverse(const float* input, float* output);
+
+    // Kernel selection. SetOptimizationLevel() never selects a level the
+    // CPU lacks; it exists so tests can compare kernels against each other.
+    OptimizationLevel GetOptimizationLevel() const { return m_optLevel; }
+    void SetOptimizationLevel(OptimizationLevel level);
+    const char* GetOptimizationName() const;
+
+    static bool IsSupportedSize(size_t size, TransformType type = Real);
+    static bool HasSSE2Support();
+    static bool HasAVXSupport();
+
+    // accumulator += a * b for `bins` interleaved complex values.
+    static void MultiplyAccumulate(const float* a, const float* b,
+                                   float* accumulator, size_t bins);
+
+    // One radix pass of the Stockham transform (public for the kernels).
+    struct Pass {
+        size_t radix;
+        size_t length;      // Points per sub-transform at this pass (m * radix)
+        size_t stride;      // Number of interleaved sub-transforms (s)
+        size_t twiddleOffset;
+    };
+
+private:
+    size_t m_size;
+    TransformType m_type;
+    size_t m_complexSize;   // Points of the complex transform actually run
+    bool m_valid;
+    OptimizationLevel m_optLevel;
+
+    std::vector<Pass> m_passes;
+    std::vector<float> m_twiddles;      // Per-pass W_length^(p*k), interleaved
+    std::vector<float> m_realTwiddles;  // W_size^k, k < size/2 (real plans)
+    std::vector<float> m_work;          // Two ping-pong buffers
+
+    void DetectCPUFeatures();
+    void BuildPasses();
+    void ComplexTransform(float* data, bool inverse);
+    void RunPass(const Pass& pass, const float* x, float* y, bool inverse) const;
+
+    static bool Factorize(size_t size, std::vector<size_t>& radices);
+};
+
+}
+}
+
+#endif
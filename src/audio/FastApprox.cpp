@@ -0,0 +1,306 @@
+#include "FastApprox.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Include SIMD headers if available on x86/x64
+#if defined(__i386__) || defined(__x86_64__)
+    #include <xmmintrin.h>  // SSE
+    #include <emmintrin.h>  // SSE2
+    #ifdef __AVX2__
+        #include <immintrin.h>  // AVX2 (256-bit integer ops for the exponent)
+    #endif
+    #define APPROX_HAVE_SSE2 1
+#endif
+
+namespace VeniceDAW {
+namespace DSP {
+
+namespace {
+
+// Minimax coefficients, lowest order first.
+// log2(1 + t) ~= t * P(t) for t in [sqrt(1/2) - 1, sqrt(2) - 1]
+const float kLog2Poly[8] = {
+    1.4426949224516852f, -0.7213524881459236f, 0.480931147552223f,
+    -0.3602634066088976f, 0.28686930129465815f, -0.24832397552355376f,
+    0.2357065624150316f, -0.14972555525753117f
+};
+
+// 2^f ~= 1 + f * Q(f) for f in [0, 1), relative error 8.3e-8. The
+// constant term is exactly 1 so Exp2(0) == 1 and Tanh(0) == 0.
+const float kExp2Poly[5] = {
+    0.693151312030642f, 0.2401644487883253f, 0.05579991574255609f,
+    0.009017028374840383f, 0.0018671305140150263f
+};
+
+const float kSqrt2 = 1.41421356237309505f;
+const float kMinNormal = 1.17549435e-38f;
+const float kLog2E = 1.44269504088896341f;
+const float kdBPerLog2 = 6.02059991327962390f;       // 20 * log10(2)
+const float kLog2PerdB = 0.166096404744368118f;      // log2(10) / 20
+const float kMinLinearFordB = 1e-10f;
+
+// Vector abstractions; the same kernels are instantiated for all of them
+
+struct ScalarOps {
+    typedef float V;
+    typedef int32_t I;
+    static const size_t kWidth = 1;
+
+    static V Load(const float* p) { return *p; }
+    static void Store(float* p, V v) { *p = v; }
+    static V Set(float c) { return c; }
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Min(V a, V b) { return a < b ? a : b; }
+    static V Max(V a, V b) { return a > b ? a : b; }
+    static V Floor(V a) { return std::floor(a); }
+    // Returns a where mask is set, b elsewhere
+    static V SelectGreater(V x, V y, V a, V b) { return x > y ? a : b; }
+
+    static I ToInt(V a) { return static_cast<int32_t>(a); }
+    static V ToFloat(I a) { return static_cast<float>(a); }
+    static I AsInt(V a) { int32_t i; std::memcpy(&i, &a, sizeof(i)); return i; }
+    static V AsFloat(I a) { float f; std::memcpy(&f, &a, sizeof(f)); return f; }
+    static I SetInt(int32_t c) { return c; }
+    static I AddInt(I a, I b) { return a + b; }
+    static I AndInt(I a, I b) { return a & b; }
+    static I OrInt(I a, I b) { return a | b; }
+    static I ShiftLeft23(I a) { return static_cast<int32_t>(static_cast<uint32_t>(a) << 23); }
+    static I ShiftRight23(I a) { return static_cast<int32_t>(static_cast<uint32_t>(a) >> 23); }
+};
+
+#ifdef APPROX_HAVE_SSE2
+struct SSE2Ops {
+    typedef __m128 V;
+    typedef __m128i I;
+    static const size_t kWidth = 4;
+
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Set(float c) { return _mm_set1_ps(c); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Min(V a, V b) { return _mm_min_ps(a, b); }
+    static V Max(V a, V b) { return _mm_max_ps(a, b); }
+    static V Floor(V a) {
+        // Truncate, then step down where truncation rounded up (negatives)
+        V t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+    }
+    static V SelectGreater(V x, V y, V a, V b) {
+        V mask = _mm_cmpgt_ps(x, y);
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static I ToInt(V a) { return _mm_cvttps_epi32(a); }
+    static V ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+    static I AsInt(V a) { return _mm_castps_si128(a); }
+    static V AsFloat(I a) { return _mm_castsi128_ps(a); }
+    static I SetInt(int32_t c) { return _mm_set1_epi32(c); }
+    static I AddInt(I a, I b) { return _mm_add_epi32(a, b); }
+    static I AndInt(I a, I b) { return _mm_and_si128(a, b); }
+    static I OrInt(I a, I b) { return _mm_or_si128(a, b); }
+    static I ShiftLeft23(I a) { return _mm_slli_epi32(a, 23); }
+    static I ShiftRight23(I a) { return _mm_srli_epi32(a, 23); }
+};
+#endif
+
+#ifdef __AVX2__
+struct AVX2Ops {
+    typedef __m256 V;
+    typedef __m256i I;
+    static const size_t kWidth = 8;
+
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Set(float c) { return _mm256_set1_ps(c); }
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V Floor(V a) { return _mm256_floor_ps(a); }
+    static V SelectGreater(V x, V y, V a, V b) {
+        return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, y, _CMP_GT_OQ));
+    }
+
+    static I ToInt(V a) { return _mm256_cvttps_epi32(a); }
+    static V ToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+    static I AsInt(V a) { return _mm256_castps_si256(a); }
+    static V AsFloat(I a) { return _mm256_castsi256_ps(a); }
+    static I SetInt(int32_t c) { return _mm256_set1_epi32(c); }
+    static I AddInt(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I AndInt(I a, I b) { return _mm256_and_si256(a, b); }
+    static I OrInt(I a, I b) { return _mm256_or_si256(a, b); }
+    static I ShiftLeft23(I a) { return _mm256_slli_epi32(a, 23); }
+    static I ShiftRight23(I a) { return _mm256_srli_epi32(a, 23); }
+};
+#endif
+
+template <typename Ops>
+inline typename Ops::V Log2V(typename Ops::V x) {
+    typedef typename Ops::V V;
+    typedef typename Ops::I I;
+
+    x = Ops::Max(x, Ops::Set(kMinNormal));
+
+    I bits = Ops::AsInt(x);
+    V exponent = Ops::ToFloat(Ops::AddInt(Ops::ShiftRight23(bits), Ops::SetInt(-127)));
+    V mantissa = Ops::AsFloat(Ops::OrInt(Ops::AndInt(bits, Ops::SetInt(0x007FFFFF)),
+                                         Ops::SetInt(0x3F800000)));
+
+    // Fold [sqrt(2), 2) down to [sqrt(1/2), 1) so the polynomial is centred on 1
+    V one = Ops::Set(1.0f);
+    V sqrt2 = Ops::Set(kSqrt2);
+    exponent = Ops::Add(exponent, Ops::SelectGreater(mantissa, sqrt2, one, Ops::Set(0.0f)));
+    mantissa = Ops::SelectGreater(mantissa, sqrt2, Ops::Mul(mantissa, Ops::Set(0.5f)), mantissa);
+
+    V t = Ops::Sub(mantissa, one);
+    V p = Ops::Set(kLog2Poly[7]);
+    for (int k = 6; k >= 0; --k) {
+        p = Ops::Add(Ops::Mul(p, t), Ops::Set(kLog2Poly[k]));
+    }
+    return Ops::Add(exponent, Ops::Mul(t, p));
+}
+
+template <typename Ops>
+inline typename Ops::V Exp2V(typename Ops::V x) {
+    typedef typename Ops::V V;
+    typedef typename Ops::I I;
+
+    x = Ops::Min(Ops::Max(x, Ops::Set(-126.0f)), Ops::Set(127.0f));
+
+    V n = Ops::Floor(x);
+    V f = Ops::Sub(x, n);
+
+    V p = Ops::Set(kExp2Poly[4]);
+    for (int k = 3; k >= 0; --k) {
+        p = Ops::Add(Ops::Mul(p, f), Ops::Set(kExp2Poly[k]));
+    }
+    p = Ops::Add(Ops::Mul(p, f), Ops::Set(1.0f));
+
+    I biased = Ops::AddInt(Ops::ToInt(n), Ops::SetInt(127));
+    return Ops::Mul(p, Ops::AsFloat(Ops::ShiftLeft23(biased)));
+}
+
+template <typename Ops>
+inline typename Ops::V LinearTodBV(typename Ops::V x) {
+    x = Ops::Max(x, Ops::Set(kMinLinearFordB));
+    return Ops::Mul(Log2V<Ops>(x), Ops::Set(kdBPerLog2));
+}
+
+template <typename Ops>
+inline typename Ops::V dBToLinearV(typename Ops::V dB) {
+    return Exp2V<Ops>(Ops::Mul(dB, Ops::Set(kLog2PerdB)));
+}
+
+template <typename Ops>
+inline typename Ops::V TanhV(typename Ops::V x) {
+    typedef typename Ops::V V;
+
+    // tanh(x) = (e^2x - 1) / (e^2x + 1); beyond |x| = 9 it is 1 in float
+    x = Ops::Min(Ops::Max(x, Ops::Set(-9.0f)), Ops::Set(9.0f));
+    V e = Exp2V<Ops>(Ops::Mul(x, Ops::Set(2.0f * kLog2E)));
+    V one = Ops::Set(1.0f);
+    return Ops::Div(Ops::Sub(e, one), Ops::Add(e, one));
+}
+
+template <typename Ops>
+inline typename Ops::V SigmoidV(typename Ops::V x) {
+    typedef typename Ops::V V;
+
+    V one = Ops::Set(1.0f);
+    V e = Exp2V<Ops>(Ops::Mul(x, Ops::Set(-kLog2E)));
+    return Ops::Div(one, Ops::Add(one, e));
+}
+
+// Runs Kernel over a block with the widest available ops, then narrower
+// ones for the tail
+template <template <typename> class Kernel>
+void RunBlock(const float* input, float* output, size_t count) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + AVX2Ops::kWidth <= count; i += AVX2Ops::kWidth) {
+        AVX2Ops::Store(output + i, Kernel<AVX2Ops>::Apply(AVX2Ops::Load(input + i)));
+    }
+#endif
+#ifdef APPROX_HAVE_SSE2
+    for (; i + SSE2Ops::kWidth <= count; i += SSE2Ops::kWidth) {
+        SSE2Ops::Store(output + i, Kernel<SSE2Ops>::Apply(SSE2Ops::Load(input + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = Kernel<ScalarOps>::Apply(input[i]);
+    }
+}
+
+template <typename Ops> struct Log2Kernel {
+    static typename Ops::V Apply(typename Ops::V x) { return Log2V<Ops>(x); }
+};
+template <typename Ops> struct Exp2Kernel {
+    static typename Ops::V Apply(typename Ops::V x) { return Exp2V<Ops>(x); }
+};
+template <typename Ops> struct LinearTodBKernel {
+    static typename Ops::V Apply(typename Ops::V x) { return LinearTodBV<Ops>(x); }
+};
+template <typename Ops> struct dBToLinearKernel {
+    static typename Ops::V Apply(typename Ops::V x) { return dBToLinearV<Ops>(x); }
+};
+template <typename Ops> struct TanhKernel {
+    static typename Ops::V Apply(typename Ops::V x) { return TanhV<Ops>(x); }
+};
+template <typename Ops> struct SigmoidKernel {
+    static typename Ops::V Apply(typename Ops::V x) { return SigmoidV<Ops>(x); }
+};
+
+}
+
+float FastApprox::Log2(float x) { return Log2V<ScalarOps>(x); }
+float FastApprox::Exp2(float x) { return Exp2V<ScalarOps>(x); }
+float FastApprox::LinearTodB(float linear) { return LinearTodBV<ScalarOps>(linear); }
+float FastApprox::dBToLinear(float dB) { return dBToLinearV<ScalarOps>(dB); }
+float FastApprox::Tanh(float x) { return TanhV<ScalarOps>(x); }
+float FastApprox::Sigmoid(float x) { return SigmoidV<ScalarOps>(x); }
+
+void FastApprox::Log2(const float* input, float* output, size_t count) {
+    RunBlock<Log2Kernel>(input, output, count);
+}
+
+void FastApprox::Exp2(const float* input, float* output, size_t count) {
+    RunBlock<Exp2Kernel>(input, output, count);
+}
+
+void FastApprox::LinearTodB(const float* input, float* output, size_t count) {
+    RunBlock<LinearTodBKernel>(input, output, count);
+}
+
+void FastApprox::dBToLinear(const float* input, float* output, size_t count) {
+    RunBlock<dBToLinearKernel>(input, output, count);
+}
+
+void FastApprox::Tanh(const float* input, float* output, size_t count) {
+    RunBlock<TanhKernel>(input, output, count);
+}
+
+void FastApprox::Sigmoid(const float* input, float* output, size_t count) {
+    RunBlock<SigmoidKernel>(input, output, count);
+}
+
+const char* FastApprox::GetKernelName() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(APPROX_HAVE_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+}
+}
@@ -0,0 +1,53 @@
+#ifndef DSP_FAST_APPROX_H
+#define DSP_FAST_APPROX_H
+
+#include <cstddef>
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Bounded-error approximations of the transcendental functions used by
+// gain computers and waveshapers.
+//
+// log2 splits off the exponent and evaluates a degree-7 polynomial on the
+// mantissa folded into [sqrt(1/2), sqrt(2)); exp2 splits off the integer
+// part and evaluates a degree-5 minimax polynomial on the fraction. The
+// other functions are built on those two. Block versions run 8 (AVX2) or
+// 4 (SSE2) values per instruction and never allocate; input and output
+// may alias. Scalar versions use the same polynomials.
+//
+// Error bounds, measured and enforced by FastApproxTest. "abs" errors are
+// divided by max(1, |result|), i.e. relative once the result exceeds 1:
+//   Log2          abs <= 3e-7 for positive normal inputs
+//   Exp2          rel <= 3e-7 for x in [-126, 127]
+//   LinearTodB    abs <= 2e-6 dB for inputs >= 1e-10
+//   dBToLinear    rel <= 1e-6 for dB in [-140, +40]
+//   Tanh          abs <= 3e-7
+//   Sigmoid       abs <= 3e-7
+//
+// Log2/LinearTodB clamp non-positive inputs (LinearTodB to -200 dB, like
+// linearTodB()); Exp2 clamps its argument to [-126, 127].
+class FastApprox {
+public:
+    static float Log2(float x);
+    static float Exp2(float x);
+    static float LinearTodB(float linear);
+    static float dBToLinear(float dB);
+    static float Tanh(float x);
+    static float Sigmoid(float x);
+
+    static void Log2(const float* input, float* output, size_t count);
+    static void Exp2(const float* input, float* output, size_t count);
+    static void LinearTodB(const float* input, float* output, size_t count);
+    static void dBToLinear(const float* input, float* output, size_t count);
+    static void Tanh(const float* input, float* output, size_t count);
+    static void Sigmoid(const float* input, float* output, size_t count);
+
+    // Name of the widest kernel compiled in ("AVX2", "SSE2" or "Scalar")
+    static const char* GetKernelName();
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,548 @@
+/*
+ * MappedPCMSource.cpp - Zero-copy sample source for uncompressed audio files
+ */
+
+#include "MappedPCMSource.h"
+#include "PolyphaseResampler.h"
+#include "SampleConversion.h"
+#include "3dmix/3DMixFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace VeniceDAW {
+
+const size_t MappedPCMSource::kReadAheadBytes;
+const size_t MappedPCMSource::kKeepBehindBytes;
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool kHostIsBigEndian = true;
+#else
+const bool kHostIsBigEndian = false;
+#endif
+
+// BeOS track object files: fixed header in front of big-endian PCM
+const size_t kTrackObjectHeaderSize = 96;
+
+inline uint32 ReadLE32(const uint8_t* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32)data[3] << 24);
+}
+
+inline uint16 ReadLE16(const uint8_t* data)
+{
+    return (uint16)(data[0] | (data[1] << 8));
+}
+
+inline uint32 ReadBE32(const uint8_t* data)
+{
+    return ((uint32)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+inline uint16 ReadBE16(const uint8_t* data)
+{
+    return (uint16)((data[0] << 8) | data[1]);
+}
+
+// AIFF stores the sample rate as an 80-bit IEEE extended float
+double ReadExtended80(const uint8_t* data)
+{
+    int exponent = ((data[0] & 0x7f) << 8) | data[1];
+    uint64_t mantissa = 0;
+    for (int i = 2; i < 10; i++) {
+        mantissa = (mantissa << 8) | data[i];
+    }
+    if (exponent == 0 && mantissa == 0) {
+        return 0.0;
+    }
+    double value = std::ldexp((double)mantissa, exponent - 16383 - 63);
+    return (data[0] & 0x80) ? -value : value;
+}
+
+inline int16_t ClampToInt16(float sample)
+{
+    float scaled = sample * 32767.0f;
+    if (scaled >= 32767.0f) return 32767;
+    if (scaled <= -32768.0f) return -32768;
+    return (int16_t)lrintf(scaled);
+}
+
+// Generic path: any sample width and channel count to stereo int16
+template <typename Decode>
+void ConvertFrames(const uint8_t* source, int32 channels, int32 sampleBytes,
+                   int16_t* dest, int64 frames, Decode decode)
+{
+    // Mono feeds both sides, extra channels are ignored
+    size_t frameBytes = (size_t)channels * sampleBytes;
+    size_t rightOffset = channels > 1 ? sampleBytes : 0;
+    for (int64 i = 0; i < frames; i++, source += frameBytes) {
+        dest[i * 2] = decode(source);
+        dest[i * 2 + 1] = decode(source + rightOffset);
+    }
+}
+
+} // namespace
+
+MappedPCMSource::MappedPCMSource()
+    : fBase(nullptr),
+      fMappedSize(0),
+      fContainer(kRawContainer),
+      fEncoding(kSigned16),
+      fBigEndian(false),
+      fChannels(0),
+      fSampleBytes(0),
+      fSampleRate(0.0f),
+      fData(nullptr),
+      fFrames(0),
+      fAdviseStart(0),
+      fAdviseEnd(0),
+      fPageSize(4096),
+      fPlayFrame(-1),
+      fAdvisePending(false),
+      fReadAhead(*this),
+      fService(nullptr)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        fPageSize = (size_t)pageSize;
+    }
+}
+
+MappedPCMSource::~MappedPCMSource()
+{
+    Close();
+}
+
+status_t MappedPCMSource::Open(const char* path, const AudioFormat3DMix* rawFormat)
+{
+    Close();
+    if (!path) {
+        return B_BAD_VALUE;
+    }
+
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return B_ENTRY_NOT_FOUND;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0) {
+        close(file);
+        return B_BAD_DATA;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* base = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (base == MAP_FAILED) {
+        return B_NO_MEMORY;
+    }
+    fBase = static_cast<uint8_t*>(base);
+    fMappedSize = (size_t)info.st_size;
+
+    // Only what AdvisePlayback() asks for and what is touched gets read
+    posix_madvise(fBase, fMappedSize, POSIX_MADV_RANDOM);
+
+    status_t status = B_BAD_DATA;
+    if (fMappedSize >= 12 && memcmp(fBase, "RIFF", 4) == 0
+        && memcmp(fBase + 8, "WAVE", 4) == 0) {
+        status = _ParseWave();
+    } else if (fMappedSize >= 12 && memcmp(fBase, "FORM", 4) == 0
+               && (memcmp(fBase + 8, "AIFF", 4) == 0 || memcmp(fBase + 8, "AIFC", 4) == 0)) {
+        status = _ParseAiff();
+    } else if (rawFormat && rawFormat->isRawFormat) {
+        status = _ParseRaw(*rawFormat);
+    }
+
+    if (status == B_OK && fFrames <= 0) {
+        status = B_BAD_DATA;
+    }
+    if (status != B_OK) {
+        Close();
+        return status;
+    }
+
+    fService = &StreamingService::GetInstance();
+    fService->Register(&fReadAhead);
+    return B_OK;
+}
+
+void MappedPCMSource::Close()
+{
+    // Returns once no reader is advising the mapping anymore
+    if (fService) {
+        fService->Unregister(&fReadAhead);
+        fService = nullptr;
+    }
+
+    if (fBase) {
+        munmap(fBase, fMappedSize);
+    }
+    fBase = nullptr;
+    fMappedSize = 0;
+    fData = nullptr;
+    fFrames = 0;
+    fChannels = 0;
+    fSampleBytes = 0;
+    fSampleRate = 0.0f;
+    fAdviseStart.store(0);
+    fAdviseEnd.store(0);
+    fPlayFrame.store(-1);
+    fAdvisePending.store(false);
+}
+
+status_t MappedPCMSource::_ParseWave()
+{
+    uint16 formatTag = 0;
+    uint16 channels = 0;
+    uint32 sampleRate = 0;
+    uint16 bits = 0;
+    size_t dataOffset = 0;
+    size_t dataBytes = 0;
+    bool haveData = false;
+
+    // Chunks are word aligned; a truncated data chunk keeps what is there
+    size_t offset = 12;
+    while (offset + 8 <= fMappedSize) {
+        const uint8_t* chunk = fBase + offset;
+        size_t size = ReadLE32(chunk + 4);
+        size_t available = std::min(size, fMappedSize - offset - 8);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            formatTag = ReadLE16(chunk + 8);
+            channels = ReadLE16(chunk + 10);
+            sampleRate = ReadLE32(chunk + 12);
+            bits = ReadLE16(chunk + 22);
+            if (formatTag == 0xfffe && available >= 26) {
+                formatTag = ReadLE16(chunk + 32);   // WAVE_FORMAT_EXTENSIBLE subformat
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            dataOffset = offset + 8;
+            dataBytes = available;
+            haveData = true;
+        }
+        offset += 8 + size + (size & 1);
+    }
+
+    bool isFloat = formatTag == 3 && bits == 32;
+    bool isPCM = formatTag == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    if (!haveData || channels == 0 || sampleRate == 0 || (!isFloat && !isPCM)) {
+        return B_BAD_DATA;
+    }
+
+    fContainer = kWaveContainer;
+    fBigEndian = false;
+    fChannels = channels;
+    fSampleBytes = bits / 8;
+    fSampleRate = (float)sampleRate;
+    if (isFloat) {
+        fEncoding = kFloat32;
+    } else {
+        fEncoding = bits == 8 ? kUnsigned8 : bits == 16 ? kSigned16
+                    : bits == 24 ? kSigned24 : kSigned32;
+    }
+    _SetData(dataOffset, dataBytes);
+    return B_OK;
+}
+
+status_t MappedPCMSource::_ParseAiff()
+{
+    bool compressed = memcmp(fBase + 8, "AIFC", 4) == 0;
+    uint16 channels = 0;
+    uint32 frames = 0;
+    uint16 bits = 0;
+    double sampleRate = 0.0;
+    bool bigEndian = true;
+    bool isFloat = false;
+    bool haveCommon = false;
+    size_t dataOffset = 0;
+    size_t dataBytes = 0;
+    bool haveData = false;
+
+    size_t offset = 12;
+    while (offset + 8 <= fMappedSize) {
+        const uint8_t* chunk = fBase + offset;
+        size_t size = ReadBE32(chunk + 4);
+        size_t available = std::min(size, fMappedSize - offset - 8);
+
+        if (memcmp(chunk, "COMM", 4) == 0 && available >= 18) {
+            channels = ReadBE16(chunk + 8);
+            frames = ReadBE32(chunk + 10);
+            bits = ReadBE16(chunk + 14);
+            sampleRate = ReadExtended80(chunk + 16);
+            haveCommon = true;
+
+            if (compressed && available >= 22) {
+                const uint8_t* type = chunk + 26;
+                if (memcmp(type, "sowt", 4) == 0) {
+                    bigEndian = false;
+                } else if (memcmp(type, "fl32", 4) == 0 || memcmp(type, "FL32", 4) == 0) {
+                    isFloat = true;
+                } else if (memcmp(type, "NONE", 4) != 0 && memcmp(type, "twos", 4) != 0) {
+                    return B_BAD_DATA;      // Really compressed
+                }
+            }
+        } else if (memcmp(chunk, "SSND", 4) == 0 && available >= 8) {
+            size_t skip = ReadBE32(chunk + 8);
+            if (skip <= available - 8) {
+                dataOffset = offset + 16 + skip;
+                dataBytes = available - 8 - skip;
+                haveData = true;
+            }
+        }
+        offset += 8 + size + (size & 1);
+    }
+
+    if (isFloat && bits != 32) {
+        return B_BAD_DATA;
+    }
+    bool isPCM = !isFloat && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    if (!haveCommon || !haveData || channels == 0 || sampleRate <= 0.0
+        || (!isFloat && !isPCM)) {
+        return B_BAD_DATA;
+    }
+
+    fContainer = kAiffContainer;
+    fBigEndian = bigEndian;
+    fChannels = channels;
+    fSampleBytes = bits / 8;
+    fSampleRate = (float)sampleRate;
+    if (isFloat) {
+        fEncoding = kFloat32;
+    } else {
+        fEncoding = bits == 8 ? kSigned8 : bits == 16 ? kSigned16
+                    : bits == 24 ? kSigned24 : kSigned32;
+    }
+    _SetData(dataOffset, dataBytes);
+
+    // The frame count in COMM wins over a longer sound chunk
+    fFrames = std::min<int64>(fFrames, frames);
+    return B_OK;
+}
+
+status_t MappedPCMSource::_ParseRaw(const AudioFormat3DMix& format)
+{
+    if (format.bitDepth != 16 || (format.channels != 1 && format.channels != 2)) {
+        return B_BAD_DATA;
+    }
+
+    size_t start = 0;
+    float sampleRate = format.sampleRate > 0 ? (float)format.sampleRate : 44100.0f;
+    fContainer = kRawContainer;
+
+    if (fMappedSize >= 4 && memcmp(fBase, "!TRK", 4) == 0) {
+        // The header stores twice the rate the audio plays at
+        static const int32 kCommonRates[] = { 11025, 22050, 44100, 48000, 88200, 96000 };
+        float detectedRate = 44100.0f;
+        bool found = false;
+        for (size_t offset = 4; offset < 90 && offset + 4 <= fMappedSize && !found; offset += 4) {
+            int32 value = (int32)ReadBE32(fBase + offset);
+            for (int32 rate : kCommonRates) {
+                if (value == rate) {
+                    detectedRate = (float)rate;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        sampleRate = detectedRate / 2.0f;
+        start = std::min(fMappedSize, kTrackObjectHeaderSize);
+        fContainer = kTrackObjectContainer;
+    }
+
+    fEncoding = kSigned16;
+    fBigEndian = true;
+    fChannels = format.channels;
+    fSampleBytes = 2;
+    fSampleRate = sampleRate;
+    _SetData(start, fMappedSize - start);
+    return B_OK;
+}
+
+void MappedPCMSource::_SetData(size_t offset, size_t bytes)
+{
+    fData = fBase + offset;
+    fFrames = (int64)(bytes / ((size_t)fChannels * fSampleBytes));
+}
+
+int64 MappedPCMSource::ReadFrames(int64 frame, int16_t* dest, int64 frames) const
+{
+    if (!fData || frame < 0 || frame >= fFrames || frames <= 0) {
+        return 0;
+    }
+    frames = std::min(frames, fFrames - frame);
+
+    const uint8_t* source = fData + frame * fChannels * fSampleBytes;
+    bool swap = fBigEndian != kHostIsBigEndian;
+
+    if (fEncoding == kSigned16 && fChannels == 2) {
+        // The common case: only the byte order can differ
+        if (swap) {
+            DSP::SampleConversion::SwapBytes16(source, dest, frames * 2);
+        } else {
+            memcpy(dest, source, frames * 2 * sizeof(int16_t));
+        }
+        return frames;
+    }
+
+    // Keep the top 16 bits of wider samples
+    int32 high = fBigEndian ? 0 : fSampleBytes - 1;
+    int32 low = fBigEndian ? 1 : fSampleBytes - 2;
+    bool bigEndian = fBigEndian;
+
+    switch (fEncoding) {
+        case kUnsigned8:
+            ConvertFrames(source, fChannels, 1, dest, frames,
+                [](const uint8_t* s) { return (int16_t)((s[0] - 128) << 8); });
+            break;
+        case kSigned8:
+            ConvertFrames(source, fChannels, 1, dest, frames,
+                [](const uint8_t* s) { return (int16_t)((int8_t)s[0] * 256); });
+            break;
+        case kSigned16:
+        case kSigned24:
+        case kSigned32:
+            ConvertFrames(source, fChannels, fSampleBytes, dest, frames,
+                [high, low](const uint8_t* s) { return (int16_t)((s[high] << 8) | s[low]); });
+            break;
+        case kFloat32:
+            ConvertFrames(source, fChannels, 4, dest, frames,
+                [bigEndian](const uint8_t* s) {
+                    uint32 bits = bigEndian ? ReadBE32(s) : ReadLE32(s);
+                    float value;
+                    memcpy(&value, &bits, sizeof(value));
+                    return ClampToInt16(value);
+                });
+            break;
+    }
+    return frames;
+}
+
+size_t MappedPCMSource::Render(DSP::PolyphaseResampler& resampler, double position,
+                               float* output, size_t outputFrames) const
+{
+    if (!fData || resampler.GetChannelCount() != 2) {
+        memset(output, 0, outputFrames * 2 * sizeof(float));
+        return 0;
+    }
+
+    // No system calls here: a stream reader moves the window
+    int64 frame = (int64)position;
+    fPlayFrame.store(frame, std::memory_order_release);
+    if (fService && frame >= 0 && frame < fFrames && _FramesAhead(frame) < 0
+        && !fAdvisePending.exchange(true, std::memory_order_acq_rel)) {
+        fService->Wake();
+    }
+
+    return resampler.RenderFrom(
+        [this](int64 frame, int16_t* dest, int64 frames) {
+            return ReadFrames(frame, dest, frames);
+        },
+        (size_t)fFrames, position, output, outputFrames);
+}
+
+void MappedPCMSource::AdvisePlayback(int64 frame) const
+{
+    if (!fData || frame < 0 || frame >= fFrames) {
+        return;
+    }
+
+    int64 frameBytes = (int64)fChannels * fSampleBytes;
+    int64 byte = (fData - fBase) + frame * frameBytes;
+    int64 start = fAdviseStart.load(std::memory_order_relaxed);
+    int64 end = fAdviseEnd.load(std::memory_order_relaxed);
+
+    // Still well inside the current window
+    if (_FramesAhead(frame) >= 0) {
+        return;
+    }
+
+    int64 page = (int64)fPageSize;
+    int64 newStart = byte / page * page;
+    int64 newEnd = std::min<int64>((int64)fMappedSize, newStart + (int64)kReadAheadBytes);
+
+    // One thread moves the window; the others keep playing
+    if (!fAdviseEnd.compare_exchange_strong(end, newEnd)) {
+        return;
+    }
+    fAdviseStart.store(newStart, std::memory_order_relaxed);
+
+    posix_madvise(fBase + newStart, (size_t)(newEnd - newStart), POSIX_MADV_WILLNEED);
+
+    // Drop what was played long enough ago; the pages stay in the file
+    // cache, so going back only costs a soft fault
+    int64 dropEnd = (newStart - (int64)kKeepBehindBytes) / page * page;
+    if (dropEnd > 0) {
+        int64 dropStart = std::max<int64>(0, std::min(start, dropEnd) - (int64)kReadAheadBytes);
+        dropStart = dropStart / page * page;
+#ifdef MADV_DONTNEED
+        madvise(fBase + dropStart, (size_t)(dropEnd - dropStart), MADV_DONTNEED);
+#else
+        posix_madvise(fBase + dropStart, (size_t)(dropEnd - dropStart), POSIX_MADV_DONTNEED);
+#endif
+    }
+}
+
+int64 MappedPCMSource::_FramesAhead(int64 frame) const
+{
+    int64 frameBytes = (int64)fChannels * fSampleBytes;
+    int64 byte = (fData - fBase) + frame * frameBytes;
+    int64 start = fAdviseStart.load(std::memory_order_relaxed);
+    int64 end = fAdviseEnd.load(std::memory_order_relaxed);
+
+    // Re-advised once half of the window has been played, unless it
+    // already reaches the end of the file
+    if (byte < start || (byte + (int64)kReadAheadBytes / 2 >= end && end < (int64)fMappedSize)) {
+        return -1;
+    }
+    return (end - byte) / frameBytes;
+}
+
+double MappedPCMSource::ReadAheadClient::BufferedSeconds() const
+{
+    int64 frame = fSource.fPlayFrame.load(std::memory_order_acquire);
+    if (frame < 0 || fSource.fSampleRate <= 0.0f) {
+        return 1e9;     // Not playing
+    }
+    return std::max<int64>(fSource._FramesAhead(frame), 0) / (double)fSource.fSampleRate;
+}
+
+int64 MappedPCMSource::ReadAheadClient::ServiceRead(int64 maxFrames)
+{
+    (void)maxFrames;    // Nothing is copied; the kernel pages the window in
+
+    // A Render() after this sets the flag again and wakes another read
+    if (!fSource.fAdvisePending.exchange(false, std::memory_order_acq_rel)) {
+        return 0;
+    }
+
+    int64 frame = fSource.fPlayFrame.load(std::memory_order_acquire);
+    fSource.AdvisePlayback(frame);
+    return std::max<int64>(fSource._FramesAhead(frame), 1);
+}
+
+int32 MappedPCMSource::ReadAheadClient::FillPercent() const
+{
+    int64 frame = fSource.fPlayFrame.load(std::memory_order_acquire);
+    int64 frameBytes = (int64)fSource.fChannels * fSource.fSampleBytes;
+    if (frame < 0 || frameBytes <= 0) {
+        return 100;
+    }
+    int64 windowFrames = (int64)kReadAheadBytes / frameBytes;
+    return (int32)std::min<int64>(100, std::max<int64>(fSource._FramesAhead(frame), 0) * 100
+                                       / std::max<int64>(windowFrames, 1));
+}
+
+const char* MappedPCMSource::GetKernelName()
+{
+    return DSP::SampleConversion::GetKernelName();
+}
+
+} // namespace VeniceDAW
@@ -0,0 +1,165 @@
+/*
+ * MappedPCMSource.h - Zero-copy sample source for uncompressed audio files
+ *
+ * Maps a WAV, AIFF or BeOS RAW file (with or without the "!TRK" track
+ * object header) into memory instead of decoding it into a sample vector.
+ * Opening only parses the header, so a session of long tracks opens in
+ * milliseconds; samples are converted to host-endian stereo int16 as they
+ * are read, and only the pages that are played become resident.
+ */
+
+#ifndef MAPPED_PCM_SOURCE_H
+#define MAPPED_PCM_SOURCE_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "StreamingService.h"
+
+namespace VeniceDAW {
+
+struct AudioFormat3DMix;
+
+namespace DSP {
+    class PolyphaseResampler;
+}
+
+/*
+ * Playback read-ahead: the kernel is asked (madvise) to page in the next
+ * kReadAheadBytes ahead of the play position, and again once half of that
+ * window has been played. Pages further than kKeepBehindBytes behind the
+ * play position are dropped from the mapping again, so the resident size
+ * stays around two windows per playing file however long it is. Render()
+ * only publishes the play position; an open source is a StreamingService
+ * client, and a stream reader makes the madvise calls. Random access
+ * (waveform drawing, editing) reads through the same mapping without
+ * moving the window.
+ *
+ * Open() and Close() are for the control thread; everything else but
+ * AdvisePlayback() is const, allocation-free and safe on the audio
+ * thread, also from several threads at once.
+ */
+class MappedPCMSource {
+public:
+    enum Container {
+        kWaveContainer,
+        kAiffContainer,
+        kRawContainer,          // Headerless PCM described by a track's format
+        kTrackObjectContainer   // BeOS track object: 96-byte "!TRK" header + RAW
+    };
+
+    enum Encoding {
+        kUnsigned8,             // WAV 8-bit
+        kSigned8,               // AIFF 8-bit
+        kSigned16,
+        kSigned24,
+        kSigned32,
+        kFloat32
+    };
+
+    static const size_t kReadAheadBytes = 1024 * 1024;
+    static const size_t kKeepBehindBytes = 1024 * 1024;
+
+    MappedPCMSource();
+    ~MappedPCMSource();
+
+    // Maps path and parses a WAV or AIFF header; any other file is read as
+    // RAW PCM when rawFormat says it is one (same rules as the 3dmix
+    // loaders: 16-bit big-endian, and a "!TRK" header stores twice the
+    // rate the audio plays at).
+    status_t Open(const char* path, const AudioFormat3DMix* rawFormat = nullptr);
+    void Close();
+    bool IsOpen() const { return fBase != nullptr; }
+
+    Container GetContainer() const { return fContainer; }
+    Encoding GetEncoding() const { return fEncoding; }
+    bool IsBigEndian() const { return fBigEndian; }
+    int32 CountChannels() const { return fChannels; }   // In the file
+    float GetSampleRate() const { return fSampleRate; }
+    int64 CountFrames() const { return fFrames; }
+    size_t GetMappedSize() const { return fMappedSize; }
+
+    // Copies frames from frame on as interleaved host-endian stereo int16:
+    // mono feeds both sides, channels past the second are ignored, wider
+    // samples keep their top 16 bits. Returns the frames copied, fewer
+    // than asked at the end of the file.
+    int64 ReadFrames(int64 frame, int16_t* dest, int64 frames) const;
+
+    // PolyphaseResampler::RenderFrom() the mapping, converting the spans
+    // the filter needs as it goes, after handing position to the stream
+    // readers for the read-ahead window. Same result and return value as
+    // rendering the whole file decoded into memory.
+    size_t Render(DSP::PolyphaseResampler& resampler, double position,
+                  float* output, size_t outputFrames) const;
+
+    // True from a Render() that left the read-ahead window until a stream
+    // reader has moved it
+    bool IsReadAheadPending() const { return fAdvisePending.load(std::memory_order_acquire); }
+
+    // Moves the read-ahead window to frame right away. Makes system calls,
+    // so not for the audio thread; loaders scanning the file use it.
+    void AdvisePlayback(int64 frame) const;
+
+    // Widest endian conversion kernel compiled in
+    static const char* GetKernelName();
+
+private:
+    // Moves the window for Render() from a stream reader thread
+    class ReadAheadClient : public StreamClient {
+    public:
+        explicit ReadAheadClient(const MappedPCMSource& source) : fSource(source) {}
+
+        virtual double BufferedSeconds() const;
+        virtual int64 FreeFrames() const { return 0; }
+        virtual int64 ServiceRead(int64 maxFrames);
+        virtual bool HasPendingWork() const { return fSource.IsReadAheadPending(); }
+        virtual int32 FillPercent() const;
+        virtual uint32 Underruns() const { return 0; }
+
+    private:
+        const MappedPCMSource& fSource;
+    };
+
+    status_t _ParseWave();
+    status_t _ParseAiff();
+    status_t _ParseRaw(const AudioFormat3DMix& format);
+    void _SetData(size_t offset, size_t bytes);
+    // Frames of the read-ahead window left ahead of frame, -1 when frame
+    // is outside it
+    int64 _FramesAhead(int64 frame) const;
+
+    uint8_t* fBase;
+    size_t fMappedSize;
+
+    Container fContainer;
+    Encoding fEncoding;
+    bool fBigEndian;
+    int32 fChannels;
+    int32 fSampleBytes;
+    float fSampleRate;
+    const uint8_t* fData;
+    int64 fFrames;
+
+    // Read-ahead window, in bytes from the start of the mapping
+    mutable std::atomic<int64> fAdviseStart;
+    mutable std::atomic<int64> fAdviseEnd;
+    size_t fPageSize;
+
+    // Published by Render() for the stream readers
+    mutable std::atomic<int64> fPlayFrame;
+    mutable std::atomic<bool> fAdvisePending;
+    ReadAheadClient fReadAhead;
+    StreamingService* fService;     // While registered
+
+    MappedPCMSource(const MappedPCMSource&) = delete;
+    MappedPCMSource& operator=(const MappedPCMSource&) = delete;
+};
+
+} // namespace VeniceDAW
+
+#endif // MAPPED_PCM_SOURCE_H
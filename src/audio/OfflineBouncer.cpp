@@ -0,0 +1,391 @@
+/*
+ * OfflineBouncer.cpp - Faster-than-realtime mixdown and stem export
+ */
+
+#include "OfflineBouncer.h"
+#include "MappedPCMSource.h"
+#include "3dmix/3DMixFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace VeniceDAW {
+
+const int32 OfflineBouncer::kDefaultBlockFrames;
+
+namespace {
+
+// Audio each writer may hold; the renderer waits when it is full
+const bigtime_t kWriterBufferDuration = 500000;
+
+bool FileExists(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file) {
+        fclose(file);
+        return true;
+    }
+    return false;
+}
+
+// 32-bit float stereo, what the mix bus produces
+media_format BounceFormat(float sampleRate, int32 blockFrames)
+{
+    media_format format;
+    format.type = B_MEDIA_RAW_AUDIO;
+#ifdef __HAIKU__
+    format.u.raw_audio = media_raw_audio_format::wildcard;
+#endif
+    format.u.raw_audio.format = media_raw_audio_format::B_AUDIO_FLOAT;
+    format.u.raw_audio.frame_rate = sampleRate;
+    format.u.raw_audio.channel_count = 2;
+    format.u.raw_audio.byte_order = B_MEDIA_LITTLE_ENDIAN;
+    format.u.raw_audio.buffer_size = blockFrames * 2 * sizeof(float);
+    return format;
+}
+
+std::string StemFileName(int32 index, const std::string& name)
+{
+    char prefix[16];
+    snprintf(prefix, sizeof(prefix), "%02d-", (int)index + 1);
+
+    std::string fileName = prefix;
+    for (char c : name) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+                    || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        fileName += safe ? c : '_';
+    }
+    return fileName + ".wav";
+}
+
+} // namespace
+
+OfflineBouncer::Options::Options()
+    : masterPath(nullptr)
+    , stemDirectory(nullptr)
+    , sampleRate(0.0f)
+    , blockFrames(kDefaultBlockFrames)
+    , threadCount(0)
+    , reverb(true)
+{
+}
+
+OfflineBouncer::OfflineBouncer()
+    : fProject(nullptr)
+    , fSampleRate(44100.0f)
+{
+    fListener[0] = fListener[1] = fListener[2] = 0.0f;
+}
+
+OfflineBouncer::~OfflineBouncer()
+{
+    for (TrackRender* render : fTracks) {
+        delete render;
+    }
+}
+
+bool OfflineBouncer::LoadAudioFile(const char* path, const AudioFormat3DMix* rawFormat,
+                                   AudioSampleCache& cache)
+{
+    if (!path) {
+        return false;
+    }
+
+    // Uncompressed files are played straight from a mapping of the file
+    std::shared_ptr<MappedPCMSource> source = std::make_shared<MappedPCMSource>();
+    if (source->Open(path, rawFormat) != B_OK) {
+        if (rawFormat && rawFormat->isRawFormat
+            && (rawFormat->bitDepth != 16 || (rawFormat->channels != 1 && rawFormat->channels != 2))) {
+            AUDIO_LOG_WARNING("OfflineBouncer", "Unsupported RAW format (bitDepth=%d, channels=%d)",
+                              (int)rawFormat->bitDepth, (int)rawFormat->channels);
+        }
+        return false;
+    }
+
+    cache.samples.clear();
+    cache.source = source;
+    cache.sampleRate = source->GetSampleRate();
+    cache.channels = 2;
+    cache.isValid = true;
+    return true;
+}
+
+std::string OfflineBouncer::_ResolvePath(const char* path) const
+{
+    if (!path || !path[0]) {
+        return std::string();
+    }
+    if (FileExists(path)) {
+        return path;
+    }
+    if (fBaseDirectory.empty()) {
+        return std::string();
+    }
+
+    // Projects store BeOS paths; look for the file next to the project
+    const char* leaf = strrchr(path, '/');
+    leaf = leaf ? leaf + 1 : path;
+
+    const char* extensions[] = { "", ".wav", ".raw", nullptr };
+    for (int ext = 0; extensions[ext] != nullptr; ext++) {
+        std::string candidate = fBaseDirectory + "/" + leaf + extensions[ext];
+        if (FileExists(candidate)) {
+            return candidate;
+        }
+    }
+    return std::string();
+}
+
+status_t OfflineBouncer::SetProject(const Project3DMix* project, const char* baseDirectory)
+{
+    for (TrackRender* render : fTracks) {
+        delete render;
+    }
+    fTracks.clear();
+
+    fProject = project;
+    fBaseDirectory = baseDirectory ? baseDirectory : "";
+    if (!project) {
+        return B_BAD_VALUE;
+    }
+
+    for (int32 i = 0; i < project->CountTracks(); i++) {
+        Track3DMix* track = project->TrackAt(i);
+        if (!track || !track->IsEnabled()) {
+            continue;
+        }
+
+        std::string path = _ResolvePath(track->AudioFilePath().String());
+        std::unique_ptr<TrackRender> render(new TrackRender());
+        if (path.empty() || !LoadAudioFile(path.c_str(), &track->GetAudioFormat(), render->cache)) {
+            AUDIO_LOG_WARNING("OfflineBouncer", "Skipping track %d: cannot read '%s'",
+                              (int)i, track->AudioFilePath().String());
+            continue;
+        }
+
+        render->track = track;
+        render->name = track->TrackName().Length() > 0 ? track->TrackName().String() : "";
+        if (render->name.empty()) {
+            const char* leaf = strrchr(path.c_str(), '/');
+            render->name = leaf ? leaf + 1 : path;
+        }
+        render->writer = nullptr;
+        fTracks.push_back(render.release());
+    }
+
+    return fTracks.empty() ? B_ENTRY_NOT_FOUND : B_OK;
+}
+
+int64 OfflineBouncer::_ContentFrames(float sampleRate) const
+{
+    double end = 0.0;
+    for (const TrackRender* render : fTracks) {
+        double rate = render->cache.sampleRate;
+        double seconds = (render->track->StartPosition() + render->cache.GetFrameCount()) / rate;
+        end = std::max(end, seconds);
+    }
+    return (int64)ceil(end * sampleRate);
+}
+
+status_t OfflineBouncer::_StartWriter(AsyncAudioWriter* writer, const std::string& path,
+                                      const media_format& format)
+{
+    // Never drop: the renderer is faster than the disk
+    writer->SetBufferDuration(kWriterBufferDuration);
+    writer->SetBlockWhenFull(true);
+    return writer->StartWriting(path.c_str(), format);
+}
+
+void OfflineBouncer::_RenderTrackEntry(void* cookie, size_t task)
+{
+    BlockJob* job = static_cast<BlockJob*>(cookie);
+    job->bouncer->_RenderTrack(*job->bouncer->fTracks[task], job->frames, job->time);
+}
+
+void OfflineBouncer::_RenderTrack(TrackRender& render, int32 frames, double time)
+{
+    // Private buffers only: tracks render on any worker
+    std::fill(render.stem.begin(), render.stem.begin() + frames * 2, 0.0f);
+    std::fill(render.send.begin(), render.send.begin() + frames * 2, 0.0f);
+    render.channel.ProcessAndMix(render.stem.data(), frames, time, fSampleRate, fListener);
+}
+
+status_t OfflineBouncer::Bounce(const Options& options, Stats* stats)
+{
+    if (stats) {
+        *stats = Stats();
+    }
+    if (!fProject || fTracks.empty()) {
+        return B_NO_INIT;
+    }
+    if (!options.masterPath && !options.stemDirectory) {
+        return B_BAD_VALUE;
+    }
+
+    fSampleRate = options.sampleRate > 0.0f ? options.sampleRate
+                  : fProject->ProjectSampleRate() > 0 ? (float)fProject->ProjectSampleRate()
+                  : 44100.0f;
+    int32 blockFrames = std::max<int32>(64, std::min<int32>(options.blockFrames, 65536));
+
+    const Coordinate3D& listener = fProject->ListenerPosition();
+    fListener[0] = listener.x;
+    fListener[1] = listener.y;
+    fListener[2] = listener.z;
+
+    fReverbBus.SetSampleRate(fSampleRate);
+    fReverbBus.SetMaxBlockFrames(blockFrames);
+    fReverbBus.Reset();
+
+    for (TrackRender* render : fTracks) {
+        Track3DMix* track = render->track;
+        TrackChannel& channel = render->channel;
+        channel.SetTrack(track);
+        channel.SetAudioCache(&render->cache);
+        channel.SetSampleRate(fSampleRate);
+        channel.SetVolume(track->Volume());
+        channel.SetPan(track->Balance());
+        channel.SetPosition3D(track->Position().x, track->Position().y, track->Position().z);
+        channel.SetReverbBus(options.reverb ? &fReverbBus : nullptr);
+        channel.SetReverbLevel(track->ReverbLevel());
+        channel.Reset();
+
+        render->stem.assign(blockFrames * 2, 0.0f);
+        render->send.assign(blockFrames * 2, 0.0f);
+        channel.SetSendBuffer(render->send.data());
+    }
+
+    // Writers: the master, one per track and the reverb return
+    media_format format = BounceFormat(fSampleRate, blockFrames);
+    std::vector<std::unique_ptr<AsyncAudioWriter> > writers;
+    AsyncAudioWriter* masterWriter = nullptr;
+    AsyncAudioWriter* reverbWriter = nullptr;
+    status_t status = B_OK;
+
+    if (options.masterPath) {
+        writers.emplace_back(new AsyncAudioWriter());
+        masterWriter = writers.back().get();
+        status = _StartWriter(masterWriter, options.masterPath, format);
+    }
+    for (size_t i = 0; i < fTracks.size(); i++) {
+        fTracks[i]->writer = nullptr;
+        if (options.stemDirectory && status == B_OK) {
+            writers.emplace_back(new AsyncAudioWriter());
+            fTracks[i]->writer = writers.back().get();
+            status = _StartWriter(fTracks[i]->writer, std::string(options.stemDirectory) + "/"
+                                  + StemFileName((int32)i, fTracks[i]->name), format);
+        }
+    }
+    if (options.stemDirectory && options.reverb && status == B_OK) {
+        writers.emplace_back(new AsyncAudioWriter());
+        reverbWriter = writers.back().get();
+        status = _StartWriter(reverbWriter, std::string(options.stemDirectory) + "/reverb.wav",
+                              format);
+    }
+
+    // The calling thread renders too, so the pool gets one thread less;
+    // a pool that is not started renders everything serially
+    RenderWorkerPool pool(options.threadCount > 1 ? options.threadCount - 1 : 0);
+    pool.SetParallelThreshold(2);
+    if (status == B_OK && options.threadCount != 1) {
+        pool.Start();
+    }
+
+    std::vector<float> mix(blockFrames * 2);
+    std::vector<float> reverbReturn(blockFrames * 2);
+    const float masterVolume = fProject->MasterVolume();
+
+    int64 contentFrames = _ContentFrames(fSampleRate);
+    int64 endFrames = contentFrames + (options.reverb ? fReverbBus.GetReverb().GetTailFrames() : 0);
+    int64 position = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Past the content only the reverb tail is left; stop once it decays
+    while (status == B_OK && position < endFrames
+           && (position < contentFrames || fReverbBus.IsActive())) {
+        int32 frames = (int32)std::min<int64>(blockFrames, endFrames - position);
+        if (position < contentFrames) {
+            frames = (int32)std::min<int64>(frames, contentFrames - position);
+        }
+
+        BlockJob job = { this, frames, position / (double)fSampleRate };
+        pool.Run(fTracks.size(), _RenderTrackEntry, &job);
+
+        // Combine in track order, so the result does not depend on threads
+        std::fill(mix.begin(), mix.begin() + frames * 2, 0.0f);
+        fReverbBus.BeginBlock(frames);
+        for (TrackRender* render : fTracks) {
+            const float* stem = render->stem.data();
+            for (int32 i = 0; i < frames * 2; i++) {
+                mix[i] += stem[i];
+            }
+            if (render->channel.HasPendingSend()) {
+                fReverbBus.AddSend(0, render->send.data(), frames, 1.0f);
+            }
+        }
+
+        std::fill(reverbReturn.begin(), reverbReturn.begin() + frames * 2, 0.0f);
+        if (options.reverb) {
+            fReverbBus.ProcessAndMix(reverbReturn.data(), frames);
+        }
+        for (int32 i = 0; i < frames * 2; i++) {
+            mix[i] = (mix[i] + reverbReturn[i]) * masterVolume;
+        }
+
+        size_t bytes = frames * 2 * sizeof(float);
+
+        if (masterWriter) {
+            status = masterWriter->QueueAudioData(mix.data(), bytes, format);
+        }
+        for (TrackRender* render : fTracks) {
+            if (render->writer && status == B_OK) {
+                status = render->writer->QueueAudioData(render->stem.data(), bytes, format);
+            }
+        }
+        if (reverbWriter && status == B_OK) {
+            status = reverbWriter->QueueAudioData(reverbReturn.data(), bytes, format);
+        }
+
+        position += frames;
+    }
+
+    pool.Stop();
+
+    // Flush and close every file, even after an error
+    uint32 filesWritten = 0;
+    uint32 writeErrors = status == B_OK ? 0 : 1;
+    for (std::unique_ptr<AsyncAudioWriter>& writer : writers) {
+        status_t writerStatus = writer->StopWriting();
+        writeErrors += writer->GetStats().writeErrors;
+        if (writerStatus == B_OK) {
+            filesWritten++;
+        } else if (status == B_OK) {
+            status = writerStatus;
+        }
+    }
+    for (TrackRender* render : fTracks) {
+        render->writer = nullptr;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (stats) {
+        stats->tracksRendered = (int32)fTracks.size();
+        stats->framesRendered = position;
+        stats->sampleRate = fSampleRate;
+        stats->renderSeconds = seconds;
+        stats->realtimeFactor = seconds > 0.0 ? position / (double)fSampleRate / seconds : 0.0;
+        stats->filesWritten = filesWritten;
+        stats->writeErrors = writeErrors;
+    }
+
+    if (status != B_OK) {
+        AUDIO_LOG_ERROR("OfflineBouncer", "Bounce failed after %lld frames", (long long)position);
+    }
+    return status;
+}
+
+} // namespace VeniceDAW
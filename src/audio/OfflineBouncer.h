@@ -0,0 +1,125 @@
+/*
+ * OfflineBouncer.h - Faster-than-realtime mixdown and stem export
+ *
+ * Renders a Project3DMix through the same chain as playback (one
+ * TrackChannel per track into a shared ReverbBus) without an audio
+ * device: blocks are rendered as fast as the CPU allows, the tracks of
+ * each block in parallel on a RenderWorkerPool, and the master and
+ * per-track stems stream to WAV through AsyncAudioWriter.
+ */
+
+#ifndef OFFLINE_BOUNCER_H
+#define OFFLINE_BOUNCER_H
+
+#include "AsyncAudioWriter.h"
+#include "AudioSampleCache.h"
+#include "RenderWorkerPool.h"
+#include "ReverbBus.h"
+#include "TrackChannel.h"
+#include <string>
+#include <vector>
+
+namespace VeniceDAW {
+
+class Project3DMix;
+class Track3DMix;
+struct AudioFormat3DMix;
+
+/**
+ * OfflineBouncer - Headless renderer for a Project3DMix
+ *
+ * Usage:
+ *   OfflineBouncer bouncer;
+ *   bouncer.SetProject(project, projectDirectory);   // loads the audio
+ *   OfflineBouncer::Options options;
+ *   options.masterPath = "mix.wav";
+ *   options.stemDirectory = "stems";
+ *   bouncer.Bounce(options, &stats);
+ *
+ * Stems are the dry, post-fader output of each track (volume, pan and 3D
+ * position applied) plus "reverb.wav", the shared reverb return. The
+ * master is their sum times the project's master volume, so the stems
+ * null against the master. All files are 32-bit float stereo WAV of the
+ * same length: the longest track plus the reverb tail.
+ *
+ * The project must outlive the bouncer; it is not modified.
+ */
+class OfflineBouncer {
+public:
+    static const int32 kDefaultBlockFrames = 4096;
+
+    struct Options {
+        const char* masterPath;     // nullptr: no master file
+        const char* stemDirectory;  // nullptr: no stems (must exist)
+        float sampleRate;           // 0: the project's sample rate
+        int32 blockFrames;
+        int32 threadCount;          // 0: one per core, 1: calling thread only
+        bool reverb;                // Route track sends to the reverb bus
+
+        Options();
+    };
+
+    struct Stats {
+        int32 tracksRendered;
+        int64 framesRendered;
+        float sampleRate;
+        double renderSeconds;
+        double realtimeFactor;      // Audio seconds per wall-clock second
+        uint32 filesWritten;
+        uint32 writeErrors;
+    };
+
+    OfflineBouncer();
+    ~OfflineBouncer();
+
+    // Loads the audio of every enabled track. Relative or missing paths
+    // are also looked up by file name in baseDirectory, like the viewer
+    // does. Tracks without readable audio are skipped with a warning.
+    status_t SetProject(const Project3DMix* project, const char* baseDirectory = nullptr);
+    int32 CountLoadedTracks() const { return (int32)fTracks.size(); }
+
+    status_t Bounce(const Options& options, Stats* stats = nullptr);
+
+    // Maps a WAV or AIFF file, or 3dmix RAW PCM (with or without the
+    // "!TRK" track object header) when rawFormat says so, as the source of
+    // a stereo int16 cache; mono is duplicated to both channels
+    static bool LoadAudioFile(const char* path, const AudioFormat3DMix* rawFormat,
+                              AudioSampleCache& cache);
+
+private:
+    struct TrackRender {
+        Track3DMix* track;
+        std::string name;
+        AudioSampleCache cache;
+        TrackChannel channel;
+        std::vector<float> stem;    // Interleaved stereo, one block
+        std::vector<float> send;
+        AsyncAudioWriter* writer;
+    };
+
+    struct BlockJob {
+        OfflineBouncer* bouncer;
+        int32 frames;
+        double time;
+    };
+
+    static void _RenderTrackEntry(void* cookie, size_t task);
+    void _RenderTrack(TrackRender& render, int32 frames, double time);
+
+    std::string _ResolvePath(const char* path) const;
+    int64 _ContentFrames(float sampleRate) const;
+    status_t _StartWriter(AsyncAudioWriter* writer, const std::string& path,
+                          const media_format& format);
+
+    const Project3DMix* fProject;
+    std::string fBaseDirectory;
+    std::vector<TrackRender*> fTracks;
+
+    ReverbBus fReverbBus;
+    float fSampleRate;
+    float fListener[3];
+};
+
+} // namespace VeniceDAW
+
+#endif // OFFLINE_BOUNCER_H
@@ -0,0 +1,412 @@
+#include "PhaseVocoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace VeniceDAW {
+namespace DSP {
+
+static constexpr double TWO_PI = 6.28318530717958647692;
+
+const size_t PhaseVocoder::kDefaultFrameSize;
+const size_t PhaseVocoder::kOverlap;
+const size_t PhaseVocoder::kLeadFrames;
+
+// Sum of the squared Hann window over kOverlap hops is 3/2
+static const float kOverlapAddGain = 2.0f / 3.0f;
+
+// Wraps a phase to [-pi, pi]
+static inline double PrincipalArgument(double phase)
+{
+    return std::remainder(phase, TWO_PI);
+}
+
+PhaseVocoder::PhaseVocoder(size_t channels, size_t frameSize)
+    : m_channels(0),
+      m_frameSize(0),
+      m_hopSize(0),
+      m_bins(0),
+      m_semitones(0.0f),
+      m_tempo(1.0f),
+      m_resampler(channels, PolyphaseResampler::QUALITY_BALANCED),
+      m_resampling(false),
+      m_ratio(1.0),
+      m_fft(frameSize, FFT::Real),
+      m_havePrevious(false),
+      m_lastHop(0),
+      m_capacity(0),
+      m_fill(0),
+      m_skip(0),
+      m_advance(false),
+      m_hopRemainder(0.0),
+      m_outputRead(0),
+      m_lead(0)
+{
+    Configure(channels, frameSize);
+}
+
+void PhaseVocoder::Configure(size_t channels, size_t frameSize)
+{
+    if (frameSize != m_fft.GetSize()) {
+        m_fft = FFT(frameSize, FFT::Real);
+    }
+
+    m_channels = std::max<size_t>(1, channels);
+    m_frameSize = frameSize;
+    m_hopSize = frameSize / kOverlap;
+    m_bins = frameSize / 2 + 1;
+
+    // Room for two hops of input, so a hop fed in place always fits
+    m_resampler.Configure(m_channels, PolyphaseResampler::QUALITY_BALANCED, 2 * m_hopSize);
+    m_resampled.assign(m_hopSize * m_channels, 0.0f);
+
+    m_window.resize(m_frameSize);
+    for (size_t i = 0; i < m_frameSize; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(TWO_PI * i / m_frameSize));
+    }
+
+    m_frame.assign(m_frameSize, 0.0f);
+    m_spectrum.assign(m_fft.GetSpectrumSize(), 0.0f);
+    m_magnitude.assign(m_bins, 0.0f);
+    m_phase.assign(m_bins, 0.0f);
+    m_peaks.assign(m_bins, 0);
+    m_lastPhase.assign(m_bins * m_channels, 0.0f);
+    m_synthesisPhase.assign(m_bins * m_channels, 0.0f);
+
+    // A reference frame and an analysis frame, a hop of input behind them
+    m_capacity = 2 * m_frameSize + m_hopSize;
+    m_input.assign(m_capacity * m_channels, 0.0f);
+    m_output.assign(m_frameSize * m_channels, 0.0f);
+
+    Reset();
+}
+
+void PhaseVocoder::SetPitch(float semitones)
+{
+    m_semitones.store(std::max(kMinSemitones, std::min(kMaxSemitones, semitones)),
+                      std::memory_order_relaxed);
+}
+
+void PhaseVocoder::SetTempo(float tempo)
+{
+    m_tempo.store(std::max(kMinTempo, std::min(kMaxTempo, tempo)), std::memory_order_relaxed);
+}
+
+size_t PhaseVocoder::GetLatencyFrames() const
+{
+    // The output is aligned with frame centres half a frame into the
+    // resampled input, and a resampled frame spans ratio input frames
+    double ratio = std::exp2(GetPitch() / 12.0);
+    return kLeadFrames + m_frameSize / 2
+        + static_cast<size_t>(std::lround(ratio * (m_frameSize / 2)));
+}
+
+void PhaseVocoder::Reset()
+{
+    std::fill(m_input.begin(), m_input.end(), 0.0f);
+    std::fill(m_output.begin(), m_output.end(), 0.0f);
+    std::fill(m_lastPhase.begin(), m_lastPhase.end(), 0.0f);
+    std::fill(m_synthesisPhase.begin(), m_synthesisPhase.end(), 0.0f);
+    m_havePrevious = false;
+    m_lastHop = 0;
+
+    m_resampler.SetRates(1.0, 1.0);
+    m_resampler.Reset();
+    m_resampling = false;
+    m_ratio = 1.0;
+
+    // A frame and a hop of silence, the first of which is dropped as any
+    // frame's hop: the first frame is taken once a hop of input has
+    // arrived, by which time the lead and a hop of (silent) output have
+    // gone out
+    m_fill = m_frameSize + m_hopSize;
+    m_skip = 0;
+    m_advance = true;
+    m_hopRemainder = 0.0;
+    m_outputRead = 0;
+    m_lead = kLeadFrames;
+}
+
+void PhaseVocoder::UpdateRatio()
+{
+    double ratio = std::exp2(GetPitch() / 12.0);
+    if (ratio == m_ratio) {
+        return;
+    }
+
+    // Starting the resampler mid-stream aligns it with the next input
+    // frame, so the output stays in time
+    if (!m_resampling) {
+        m_resampler.Reset();
+        m_resampling = true;
+    }
+    m_resampler.SetRates(ratio, 1.0);
+    m_ratio = ratio;
+}
+
+size_t PhaseVocoder::NextHop(double& hopRemainder, double factor) const
+{
+    hopRemainder += factor * m_hopSize;
+    size_t hop = static_cast<size_t>(hopRemainder);
+    hopRemainder -= hop;
+    return hop;
+}
+
+size_t PhaseVocoder::GetInputCapacity() const
+{
+    if (m_resampling) {
+        return m_resampler.GetInputCapacity();
+    }
+    return m_capacity - m_fill + m_skip;
+}
+
+size_t PhaseVocoder::GetInputFramesNeeded(size_t outputFrames) const
+{
+    size_t lead = std::min(outputFrames, m_lead);
+    size_t available = m_hopSize - m_outputRead;
+    if (outputFrames - lead <= available) {
+        return 0;
+    }
+
+    // Resampled frames the stage will ask for
+    size_t frames = (outputFrames - lead - available + m_hopSize - 1) / m_hopSize;
+    size_t required = m_frameSize + m_hopSize;
+    size_t fill = m_fill;
+    size_t skip = m_skip;
+    double hopRemainder = m_hopRemainder;
+    double ratio = std::exp2(GetPitch() / 12.0);
+    double factor = m_tempo.load(std::memory_order_relaxed) / ratio;
+
+    size_t needed = 0;
+    bool advance = m_advance;
+    for (size_t i = 0; i < frames; ++i) {
+        if (advance) {
+            size_t hop = NextHop(hopRemainder, factor);
+            size_t dropped = std::min(hop, fill);
+            fill -= dropped;
+            skip += hop - dropped;
+        }
+        if (fill < required) {
+            needed += skip + required - fill;
+            skip = 0;
+            fill = required;
+        }
+        advance = true;
+    }
+
+    if (!m_resampling && ratio == 1.0) {
+        return needed;
+    }
+    if (m_resampling && ratio == m_ratio) {
+        return m_resampler.GetInputFramesNeeded(needed);
+    }
+    return static_cast<size_t>(std::ceil(needed * ratio)) + 2 * m_resampler.GetLatencyFrames() + 2;
+}
+
+size_t PhaseVocoder::Fill(const float* input, size_t inputFrames, size_t frames)
+{
+    // Resampled frames that go into the buffer, after any skipped ones
+    size_t taken = 0;
+    while (frames > 0 || m_skip > 0) {
+        const float* resampled = nullptr;
+        size_t count = 0;
+        const float* source = input + taken * m_channels;
+        size_t sourceFrames = inputFrames - taken;
+
+        if (m_resampling) {
+            count = std::min(m_skip + frames, m_hopSize);
+            size_t fed = sourceFrames;
+            count = m_resampler.Process(source, fed, m_resampled.data(), count);
+            taken += fed;
+            resampled = m_resampled.data();
+        } else {
+            count = std::min(m_skip + frames, sourceFrames);
+            taken += count;
+            resampled = source;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        size_t skipped = std::min(m_skip, count);
+        m_skip -= skipped;
+        size_t kept = std::min(count - skipped, frames);
+        for (size_t ch = 0; ch < m_channels; ++ch) {
+            float* dest = &m_input[ch * m_capacity + m_fill];
+            const float* src = resampled + skipped * m_channels + ch;
+            for (size_t i = 0; i < kept; ++i) {
+                dest[i] = src[i * m_channels];
+            }
+        }
+        m_fill += kept;
+        frames -= kept;
+    }
+    return taken;
+}
+
+size_t PhaseVocoder::Process(const float* input, size_t& inputFrames, float* output,
+                             size_t outputFrames)
+{
+    UpdateRatio();
+
+    const size_t required = m_frameSize + m_hopSize;
+    size_t taken = 0;
+    size_t written = 0;
+
+    if (m_lead > 0) {
+        size_t count = std::min(m_lead, outputFrames);
+        std::memset(output, 0, count * m_channels * sizeof(float));
+        m_lead -= count;
+        written += count;
+    }
+
+    while (written < outputFrames) {
+        if (m_outputRead < m_hopSize) {
+            size_t count = std::min(m_hopSize - m_outputRead, outputFrames - written);
+            for (size_t ch = 0; ch < m_channels; ++ch) {
+                const float* src = &m_output[ch * m_frameSize + m_outputRead];
+                float* dest = output + written * m_channels + ch;
+                for (size_t i = 0; i < count; ++i) {
+                    dest[i * m_channels] = src[i];
+                }
+            }
+            m_outputRead += count;
+            written += count;
+            continue;
+        }
+
+        if (m_advance) {
+            Advance();
+        }
+        if (m_fill < required) {
+            taken += Fill(input + taken * m_channels, inputFrames - taken, required - m_fill);
+        }
+        if (m_fill < required) {
+            break;
+        }
+        ProduceFrame();
+    }
+
+    // Keep what is left for the next call, as far as it fits
+    size_t rest = inputFrames - taken;
+    if (m_resampling) {
+        m_resampler.Process(input + taken * m_channels, rest, nullptr, 0);
+        taken += rest;
+    } else {
+        taken += Fill(input + taken * m_channels, rest, m_capacity - m_fill);
+    }
+
+    inputFrames = taken;
+    return written;
+}
+
+void PhaseVocoder::Analyze(size_t channel, size_t offset, float* phase)
+{
+    const float* input = &m_input[channel * m_capacity + offset];
+    for (size_t i = 0; i < m_frameSize; ++i) {
+        m_frame[i] = input[i] * m_window[i];
+    }
+    m_fft.ForwardReal(m_frame.data(), m_spectrum.data());
+
+    for (size_t k = 0; k < m_bins; ++k) {
+        float re = m_spectrum[k * 2];
+        float im = m_spectrum[k * 2 + 1];
+        m_magnitude[k] = std::sqrt(re * re + im * im);
+        phase[k] = std::atan2(im, re);
+    }
+}
+
+void PhaseVocoder::ProduceFrame()
+{
+    // The previous frame is the reference when it lies at most a hop back;
+    // beyond that the phase difference could wrap more than once
+    const bool previousIsReference = m_havePrevious && m_lastHop > 0 && m_lastHop <= m_hopSize;
+    const size_t referenceHop = previousIsReference ? m_lastHop : m_hopSize;
+    const double binAdvance = TWO_PI * referenceHop / m_frameSize;
+    const double toSynthesisHop = static_cast<double>(m_hopSize) / referenceHop;
+
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        float* lastPhase = &m_lastPhase[ch * m_bins];
+        float* synthesisPhase = &m_synthesisPhase[ch * m_bins];
+
+        if (m_havePrevious && !previousIsReference) {
+            Analyze(ch, 0, lastPhase);
+        }
+        Analyze(ch, m_hopSize, m_phase.data());
+
+        // Peaks carry their phase forward at their measured frequency; the
+        // bins around each peak keep their phase relative to it
+        size_t peakCount = 0;
+        for (size_t k = 1; k + 1 < m_bins; ++k) {
+            if (m_magnitude[k] > m_magnitude[k - 1] && m_magnitude[k] >= m_magnitude[k + 1]) {
+                m_peaks[peakCount++] = k;
+            }
+        }
+
+        if (!m_havePrevious || peakCount == 0) {
+            std::copy(m_phase.begin(), m_phase.end(), synthesisPhase);
+        } else {
+            size_t regionStart = 0;
+            for (size_t p = 0; p < peakCount; ++p) {
+                size_t peak = m_peaks[p];
+                size_t regionEnd = p + 1 < peakCount ? (peak + m_peaks[p + 1]) / 2 + 1 : m_bins;
+
+                double deviation = PrincipalArgument(m_phase[peak] - lastPhase[peak]
+                                                     - binAdvance * peak);
+                double advance = (binAdvance * peak + deviation) * toSynthesisHop;
+                double peakPhase = PrincipalArgument(synthesisPhase[peak] + advance);
+                double rotation = peakPhase - m_phase[peak];
+
+                for (size_t k = regionStart; k < regionEnd; ++k) {
+                    synthesisPhase[k] = static_cast<float>(PrincipalArgument(m_phase[k] + rotation));
+                }
+                regionStart = regionEnd;
+            }
+        }
+
+        for (size_t k = 0; k < m_bins; ++k) {
+            m_spectrum[k * 2] = m_magnitude[k] * std::cos(synthesisPhase[k]);
+            m_spectrum[k * 2 + 1] = m_magnitude[k] * std::sin(synthesisPhase[k]);
+        }
+        std::copy(m_phase.begin(), m_phase.end(), lastPhase);
+
+        m_fft.InverseReal(m_spectrum.data(), m_frame.data());
+
+        // Slide the accumulator a hop on and add the frame
+        float* accumulator = &m_output[ch * m_frameSize];
+        std::memmove(accumulator, accumulator + m_hopSize,
+                     (m_frameSize - m_hopSize) * sizeof(float));
+        std::fill(accumulator + m_frameSize - m_hopSize, accumulator + m_frameSize, 0.0f);
+        for (size_t i = 0; i < m_frameSize; ++i) {
+            accumulator[i] += m_frame[i] * m_window[i] * kOverlapAddGain;
+        }
+    }
+
+    m_havePrevious = true;
+    m_advance = true;
+    m_outputRead = 0;
+}
+
+void PhaseVocoder::Advance()
+{
+    // The hop is taken when the next frame is due rather than after the
+    // last one, so it follows the tempo and pitch of the frame it leads to
+    // and a pitch change never asks for more than a hop of input at once.
+    // Input that has not arrived yet is skipped when the hop is longer
+    // than the buffer.
+    double factor = m_tempo.load(std::memory_order_relaxed) / m_ratio;
+    size_t hop = NextHop(m_hopRemainder, factor);
+    size_t dropped = std::min(hop, m_fill);
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        float* input = &m_input[ch * m_capacity];
+        std::memmove(input, input + dropped, (m_fill - dropped) * sizeof(float));
+    }
+    m_fill -= dropped;
+    m_skip += hop - dropped;
+    m_lastHop = hop;
+    m_advance = false;
+}
+
+}
+}
@@ -0,0 +1,147 @@
+#ifndef DSP_PHASE_VOCODER_H
+#define DSP_PHASE_VOCODER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "FFT.h"
+#include "PolyphaseResampler.h"
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Streaming pitch and tempo change for playback (STFT phase vocoder).
+//
+// Pitch is changed by resampling the input by 2^(semitones / 12) with a
+// PolyphaseResampler, which also changes its duration; an STFT time-scale
+// stage then restores the duration (and applies the tempo). Analysis frames
+// of GetFrameSize() frames (periodic Hann window) are overlap-added every
+// GetHopSize() output frames (4x overlap) and taken every
+// tempo / ratio * GetHopSize() resampled frames. Each bin's frequency is
+// measured against the previous frame when it lies at most a hop back,
+// against an extra transform a hop back otherwise, so large analysis hops
+// do not alias it. Phases are locked to the nearest spectral peak so
+// partials stay coherent across the bins they cover. At pitch 0 and tempo
+// 1 the resampler is not used and the output is the input, delayed by
+// GetLatencyFrames().
+//
+// Pitch and tempo may be changed from any thread; they take effect at the
+// next Process() call. The first pitch change away from 0 starts the
+// resampler, which then stays in use until Reset(). The constructor and
+// Configure() allocate; everything else is allocation-free and safe on the
+// audio thread (a pitch change redesigns the resampler's filter table when
+// shifting up).
+class PhaseVocoder {
+public:
+    static const size_t kDefaultFrameSize = 2048;
+    static const size_t kOverlap = 4;
+
+    // Silent output frames ahead of the first hop, so the resampler's
+    // lookahead never holds the output back in step-by-step processing
+    static const size_t kLeadFrames = 64;
+
+    static constexpr float kMinSemitones = -24.0f;
+    static constexpr float kMaxSemitones = 24.0f;
+    static constexpr float kMinTempo = 0.25f;
+    static constexpr float kMaxTempo = 4.0f;
+
+    // frameSize must be a supported real FFT size and a multiple of
+    // kOverlap; 2048 suits 44.1/48 kHz
+    explicit PhaseVocoder(size_t channels = 2, size_t frameSize = kDefaultFrameSize);
+    ~PhaseVocoder() = default;
+
+    void Configure(size_t channels, size_t frameSize = kDefaultFrameSize);
+
+    // Clamped to kMinSemitones..kMaxSemitones
+    void SetPitch(float semitones);
+    float GetPitch() const { return m_semitones.load(std::memory_order_relaxed); }
+
+    // Input frames consumed per output frame, clamped to kMinTempo..kMaxTempo
+    void SetTempo(float tempo);
+    float GetTempo() const { return m_tempo.load(std::memory_order_relaxed); }
+
+    size_t GetChannelCount() const { return m_channels; }
+    size_t GetFrameSize() const { return m_frameSize; }
+    size_t GetHopSize() const { return m_hopSize; }
+
+    // Output frames between an input frame going in and coming out at
+    // tempo 1 and the current pitch: GetFrameSize() + kLeadFrames at pitch
+    // 0, from 3/8 of a frame less at -24 to 3/2 of a frame more at +24
+    // semitones. At other tempos output frame n plays input from about
+    // (n - GetLatencyFrames()) * tempo.
+    size_t GetLatencyFrames() const;
+
+    // Streaming processing of interleaved frames, as
+    // PolyphaseResampler::Process(): writes up to outputFrames frames and
+    // returns how many it wrote. On return inputFrames holds the number of
+    // input frames taken, which is limited by GetInputCapacity(); feeding
+    // GetInputFramesNeeded() frames, clamped to the capacity, never leaves
+    // input behind. At tempo 1, feeding n frames of at most GetHopSize()
+    // frames and asking for n returns n, so the vocoder can run in place
+    // of a plain effect.
+    size_t Process(const float* input, size_t& inputFrames, float* output, size_t outputFrames);
+    size_t GetInputFramesNeeded(size_t outputFrames) const;
+    size_t GetInputCapacity() const;
+
+    // Silence in the pipeline, first output frame aligned as after
+    // construction
+    void Reset();
+
+private:
+    void UpdateRatio();
+    size_t Fill(const float* input, size_t inputFrames, size_t frames);
+    void Analyze(size_t channel, size_t offset, float* phase);
+    void ProduceFrame();
+    void Advance();
+    size_t NextHop(double& hopRemainder, double factor) const;
+
+    size_t m_channels;
+    size_t m_frameSize;
+    size_t m_hopSize;
+    size_t m_bins;
+
+    std::atomic<float> m_semitones;
+    std::atomic<float> m_tempo;
+
+    // Pitch stage, used once the pitch has left 0
+    PolyphaseResampler m_resampler;
+    std::vector<float> m_resampled;     // Interleaved, a hop of frames
+    bool m_resampling;
+    double m_ratio;
+
+    FFT m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_frame;         // Windowed time frame / inverse output
+    std::vector<float> m_spectrum;      // GetSpectrumSize() floats
+    std::vector<float> m_magnitude;     // Per bin scratch
+    std::vector<float> m_phase;         // Analysis phase scratch
+    std::vector<size_t> m_peaks;
+
+    // Planar, m_bins per channel
+    std::vector<float> m_lastPhase;     // Analysis phases of the previous frame
+    std::vector<float> m_synthesisPhase;
+    bool m_havePrevious;
+    size_t m_lastHop;
+
+    // Planar (resampled) input, m_capacity frames per channel; the frame
+    // under analysis starts m_hopSize frames in (the reference frame
+    // before it). Hops longer than the buffer skip input still to come.
+    std::vector<float> m_input;
+    size_t m_capacity;
+    size_t m_fill;
+    size_t m_skip;
+    bool m_advance;                     // The next frame's hop is still to drop
+    double m_hopRemainder;
+
+    // Planar overlap-add accumulator, m_frameSize frames per channel; its
+    // first m_hopSize frames are complete once a frame has been added
+    std::vector<float> m_output;
+    size_t m_outputRead;
+    size_t m_lead;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,455 @@
+#include "PolyphaseResampler.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// Include SIMD headers if available on x86/x64
+#if defined(__i386__) || defined(__x86_64__)
+    #include <xmmintrin.h>  // SSE
+    #ifdef __AVX__
+        #include <immintrin.h>  // AVX/FMA
+    #endif
+    #define RESAMPLER_HAVE_SSE 1
+#endif
+
+namespace VeniceDAW {
+namespace DSP {
+
+namespace {
+
+struct QualitySettings {
+    size_t halfTaps;
+    size_t phases;
+    float beta;      // Kaiser window shape
+    float rolloff;   // Cutoff as a fraction of the lower Nyquist frequency
+};
+
+// Rolloff puts the -6 dB point far enough below Nyquist that the
+// transition band of the window (roughly (A - 8) / (14.36 * taps) of the
+// sample rate for A dB attenuation) ends near it
+const QualitySettings kQualitySettings[] = {
+    {  8, 128,  5.0f, 0.80f },   // QUALITY_REALTIME
+    { 16, 256,  7.0f, 0.87f },   // QUALITY_BALANCED
+    { 32, 256,  9.5f, 0.91f }    // QUALITY_HIGHEST
+};
+
+const double kMaxRatio = 64.0;
+const float kInt16ToFloat = 1.0f / 32768.0f;
+
+double BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = 0.5 * x;
+    for (int k = 1; k < 50; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// Taps are a multiple of 8, so there is no tail to handle
+inline float Dot(const float* a, const float* b, size_t count)
+{
+#if defined(__AVX__)
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+#ifdef __FMA__
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+#else
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+#endif
+    }
+    for (; i < count; i += 8) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(RESAMPLER_HAVE_SSE)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < count; i += 4) {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+// row = lower + t * (upper - lower)
+inline void InterpolateRow(const float* lower, const float* upper, float t,
+                           float* row, size_t count)
+{
+#if defined(__AVX__)
+    __m256 vt = _mm256_set1_ps(t);
+    for (size_t i = 0; i < count; i += 8) {
+        __m256 lo = _mm256_loadu_ps(lower + i);
+        __m256 hi = _mm256_loadu_ps(upper + i);
+        _mm256_storeu_ps(row + i, _mm256_add_ps(lo, _mm256_mul_ps(vt, _mm256_sub_ps(hi, lo))));
+    }
+#elif defined(RESAMPLER_HAVE_SSE)
+    __m128 vt = _mm_set1_ps(t);
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 lo = _mm_loadu_ps(lower + i);
+        __m128 hi = _mm_loadu_ps(upper + i);
+        _mm_storeu_ps(row + i, _mm_add_ps(lo, _mm_mul_ps(vt, _mm_sub_ps(hi, lo))));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        row[i] = lower[i] + t * (upper[i] - lower[i]);
+    }
+#endif
+}
+
+// Stereo fast path: interpolates the row on the fly and convolves both
+// channels with it, so each coefficient is loaded once and never stored
+inline void InterpolatedDot2(const float* lower, const float* upper, float t,
+                             const float* left, const float* right, size_t count,
+                             float* output)
+{
+#if defined(__AVX__)
+    __m256 vt = _mm256_set1_ps(t);
+    __m256 accLeft = _mm256_setzero_ps();
+    __m256 accRight = _mm256_setzero_ps();
+    for (size_t i = 0; i < count; i += 8) {
+        __m256 lo = _mm256_loadu_ps(lower + i);
+        __m256 coeff = _mm256_add_ps(lo, _mm256_mul_ps(vt, _mm256_sub_ps(_mm256_loadu_ps(upper + i), lo)));
+#ifdef __FMA__
+        accLeft = _mm256_fmadd_ps(coeff, _mm256_loadu_ps(left + i), accLeft);
+        accRight = _mm256_fmadd_ps(coeff, _mm256_loadu_ps(right + i), accRight);
+#else
+        accLeft = _mm256_add_ps(accLeft, _mm256_mul_ps(coeff, _mm256_loadu_ps(left + i)));
+        accRight = _mm256_add_ps(accRight, _mm256_mul_ps(coeff, _mm256_loadu_ps(right + i)));
+#endif
+    }
+    // Reduce both accumulators together: [l0+l4 .. l3+l7 | r0+r4 .. r3+r7]
+    __m128 l = _mm_add_ps(_mm256_castps256_ps128(accLeft), _mm256_extractf128_ps(accLeft, 1));
+    __m128 r = _mm_add_ps(_mm256_castps256_ps128(accRight), _mm256_extractf128_ps(accRight, 1));
+    __m128 lr = _mm_add_ps(_mm_unpacklo_ps(l, r), _mm_unpackhi_ps(l, r));
+    lr = _mm_add_ps(lr, _mm_movehl_ps(lr, lr));
+    _mm_storel_pi(reinterpret_cast<__m64*>(output), lr);
+#elif defined(RESAMPLER_HAVE_SSE)
+    __m128 vt = _mm_set1_ps(t);
+    __m128 accLeft = _mm_setzero_ps();
+    __m128 accRight = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 lo = _mm_loadu_ps(lower + i);
+        __m128 coeff = _mm_add_ps(lo, _mm_mul_ps(vt, _mm_sub_ps(_mm_loadu_ps(upper + i), lo)));
+        accLeft = _mm_add_ps(accLeft, _mm_mul_ps(coeff, _mm_loadu_ps(left + i)));
+        accRight = _mm_add_ps(accRight, _mm_mul_ps(coeff, _mm_loadu_ps(right + i)));
+    }
+    __m128 lr = _mm_add_ps(_mm_unpacklo_ps(accLeft, accRight), _mm_unpackhi_ps(accLeft, accRight));
+    lr = _mm_add_ps(lr, _mm_movehl_ps(lr, lr));
+    _mm_storel_pi(reinterpret_cast<__m64*>(output), lr);
+#else
+    float sumLeft = 0.0f;
+    float sumRight = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float coeff = lower[i] + t * (upper[i] - lower[i]);
+        sumLeft += coeff * left[i];
+        sumRight += coeff * right[i];
+    }
+    output[0] = sumLeft;
+    output[1] = sumRight;
+#endif
+}
+
+inline float ToFloat(float sample) { return sample; }
+inline float ToFloat(int16_t sample) { return sample * kInt16ToFloat; }
+
+}
+
+PolyphaseResampler::PolyphaseResampler(size_t channels, Quality quality, size_t maxBlockFrames)
+    : m_channels(0)
+    , m_quality(quality)
+    , m_taps(0)
+    , m_halfTaps(0)
+    , m_phases(0)
+    , m_beta(0.0f)
+    , m_rolloff(0.0f)
+    , m_ratio(1.0)
+    , m_inputRate(0.0)
+    , m_outputRate(0.0)
+    , m_cutoff(0.0)
+    , m_capacity(0)
+    , m_fill(0)
+    , m_position(0.0)
+{
+    Configure(channels, quality, maxBlockFrames);
+}
+
+void PolyphaseResampler::Configure(size_t channels, Quality quality, size_t maxBlockFrames)
+{
+    const QualitySettings& settings = kQualitySettings[quality];
+
+    m_channels = std::max<size_t>(1, channels);
+    m_quality = quality;
+    m_halfTaps = settings.halfTaps;
+    m_taps = 2 * settings.halfTaps;
+    m_phases = settings.phases;
+    m_beta = settings.beta;
+    m_rolloff = settings.rolloff;
+
+    m_table.assign((m_phases + 1) * m_taps, 0.0f);
+    m_row.assign(m_taps, 0.0f);
+
+    // Room for a full block plus the filter span on either side of it
+    m_capacity = std::max<size_t>(1, maxBlockFrames) + 2 * m_taps;
+    m_history.assign(m_capacity * m_channels, 0.0f);
+
+    double cutoff = m_rolloff;
+    if (m_inputRate > 0.0 && m_outputRate < m_inputRate) {
+        cutoff *= m_outputRate / m_inputRate;
+    }
+    m_cutoff = cutoff;
+    DesignTable();
+    Reset();
+}
+
+void PolyphaseResampler::SetRates(double inputRate, double outputRate)
+{
+    if (inputRate <= 0.0 || outputRate <= 0.0) return;
+    if (inputRate == m_inputRate && outputRate == m_outputRate) return;
+
+    m_inputRate = inputRate;
+    m_outputRate = outputRate;
+    SetRatio(inputRate / outputRate);
+
+    double cutoff = m_rolloff * std::min(1.0, outputRate / inputRate);
+    if (cutoff != m_cutoff) {
+        m_cutoff = cutoff;
+        DesignTable();
+    }
+}
+
+void PolyphaseResampler::SetRatio(double ratio)
+{
+    if (!(ratio > 0.0)) return;
+    m_ratio = std::min(ratio, kMaxRatio);
+}
+
+void PolyphaseResampler::DesignTable()
+{
+    // Row p holds the kernel at offsets k - (halfTaps - 1) - p / phases,
+    // i.e. the weights of input frames i - halfTaps + 1 .. i + halfTaps
+    // for an output at i + p / phases. Each row is normalized to unity DC
+    // gain so all phases pass DC identically.
+    //
+    // The window has the Kaiser pedestal removed so it reaches zero at
+    // +/-halfTaps; the last row is then exactly the first one shifted by a
+    // tap and interpolating across the row wrap is seamless.
+    const double pi = 3.14159265358979323846;
+    const double halfSpan = static_cast<double>(m_halfTaps);
+    const double pedestal = 1.0;
+    const double windowNorm = 1.0 / (BesselI0(m_beta) - pedestal);
+
+    for (size_t p = 0; p <= m_phases; ++p) {
+        float* row = &m_table[p * m_taps];
+        double fraction = static_cast<double>(p) / m_phases;
+        double sum = 0.0;
+
+        for (size_t k = 0; k < m_taps; ++k) {
+            double x = static_cast<double>(k) - (halfSpan - 1.0) - fraction;
+            double u = x / halfSpan;
+            double window = (std::abs(u) <= 1.0)
+                ? (BesselI0(m_beta * std::sqrt(1.0 - u * u)) - pedestal) * windowNorm : 0.0;
+            double arg = pi * m_cutoff * x;
+            double sinc = (std::abs(arg) < 1e-12) ? 1.0 : std::sin(arg) / arg;
+            double weight = m_cutoff * sinc * window;
+            row[k] = static_cast<float>(weight);
+            sum += weight;
+        }
+
+        float scale = static_cast<float>(1.0 / sum);
+        for (size_t k = 0; k < m_taps; ++k) {
+            row[k] *= scale;
+        }
+    }
+}
+
+void PolyphaseResampler::Reset()
+{
+    // halfTaps - 1 frames of silence ahead of the first input frame, so
+    // output frame 0 lands exactly on input frame 0
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_fill = m_halfTaps - 1;
+    m_position = static_cast<double>(m_halfTaps - 1);
+}
+
+size_t PolyphaseResampler::Produce(double& position, float* output, size_t outputFrames)
+{
+    const size_t taps = m_taps;
+    const size_t channels = m_channels;
+    const double phaseScale = static_cast<double>(m_phases);
+    float* row = m_row.data();
+
+    size_t produced = 0;
+    while (produced < outputFrames) {
+        size_t index = static_cast<size_t>(position);
+        if (index + m_halfTaps >= m_fill) break;
+
+        double phase = (position - static_cast<double>(index)) * phaseScale;
+        size_t phaseIndex = static_cast<size_t>(phase);
+        float t = static_cast<float>(phase - static_cast<double>(phaseIndex));
+        const float* lower = &m_table[phaseIndex * taps];
+
+        size_t first = index + 1 - m_halfTaps;
+        float* out = output + produced * channels;
+        if (channels == 2) {
+            InterpolatedDot2(lower, lower + taps, t, &m_history[first],
+                             &m_history[m_capacity + first], taps, out);
+        } else {
+            InterpolateRow(lower, lower + taps, t, row, taps);
+            for (size_t c = 0; c < channels; ++c) {
+                out[c] = Dot(&m_history[c * m_capacity + first], row, taps);
+            }
+        }
+
+        position += m_ratio;
+        ++produced;
+    }
+    return produced;
+}
+
+size_t PolyphaseResampler::Process(const float* input, size_t& inputFrames,
+                                   float* output, size_t outputFrames)
+{
+    size_t taken = std::min(inputFrames, GetInputCapacity());
+    for (size_t c = 0; c < m_channels; ++c) {
+        float* dest = &m_history[c * m_capacity + m_fill];
+        const float* src = input + c;
+        for (size_t i = 0; i < taken; ++i) {
+            dest[i] = src[i * m_channels];
+        }
+    }
+    m_fill += taken;
+    inputFrames = taken;
+
+    size_t produced = Produce(m_position, output, outputFrames);
+
+    // Drop frames no later output can reach
+    size_t index = static_cast<size_t>(m_position);
+    size_t discard = std::min(m_fill, index + 1 > m_halfTaps ? index + 1 - m_halfTaps : 0);
+    if (discard > 0) {
+        for (size_t c = 0; c < m_channels; ++c) {
+            float* history = &m_history[c * m_capacity];
+            std::memmove(history, history + discard, (m_fill - discard) * sizeof(float));
+        }
+        m_fill -= discard;
+        m_position -= static_cast<double>(discard);
+    }
+
+    return produced;
+}
+
+size_t PolyphaseResampler::GetInputFramesNeeded(size_t outputFrames) const
+{
+    if (outputFrames == 0) return 0;
+
+    // One frame of slack for rounding in the accumulated position; an
+    // extra frame just stays in the history
+    double last = m_position + static_cast<double>(outputFrames - 1) * m_ratio;
+    size_t required = static_cast<size_t>(last) + m_halfTaps + 2;
+    return required > m_fill ? required - m_fill : 0;
+}
+
+template <typename Sample>
+size_t PolyphaseResampler::RenderSource(const Sample* source, size_t sourceFrames,
+                                        double position, float* output, size_t outputFrames)
+{
+    // Largest output chunk whose input span fits the history
+    size_t span = m_capacity - m_taps - 2;
+    size_t chunkFrames = std::max<size_t>(1, static_cast<size_t>(span / m_ratio));
+
+    size_t inside = 0;
+    size_t done = 0;
+    while (done < outputFrames) {
+        size_t count = std::min(chunkFrames, outputFrames - done);
+
+        // Stage source frames [base, base + m_fill) planar, zero outside
+        double start = std::floor(position);
+        int64_t base = static_cast<int64_t>(start) - static_cast<int64_t>(m_halfTaps) + 1;
+        double last = position + static_cast<double>(count - 1) * m_ratio;
+        m_fill = std::min(m_capacity,
+                          static_cast<size_t>(std::floor(last) - start) + m_taps + 1);
+
+        int64_t validBegin = std::max<int64_t>(0, -base);
+        int64_t validEnd = std::max<int64_t>(validBegin,
+            std::min<int64_t>(static_cast<int64_t>(m_fill),
+                              static_cast<int64_t>(sourceFrames) - base));
+        for (size_t c = 0; c < m_channels; ++c) {
+            float* dest = &m_history[c * m_capacity];
+            for (int64_t i = 0; i < validBegin; ++i) dest[i] = 0.0f;
+            const Sample* src = source + (base + validBegin) * static_cast<int64_t>(m_channels) + c;
+            for (int64_t i = validBegin; i < validEnd; ++i, src += m_channels) {
+                dest[i] = ToFloat(*src);
+            }
+            for (int64_t i = validEnd; i < static_cast<int64_t>(m_fill); ++i) dest[i] = 0.0f;
+        }
+
+        double local = position - static_cast<double>(base);
+        size_t produced = Produce(local, output + done * m_channels, count);
+        for (size_t i = 0; i < produced; ++i) {
+            double p = position + static_cast<double>(i) * m_ratio;
+            if (p < static_cast<double>(sourceFrames)) inside = done + i + 1;
+        }
+        position = local + static_cast<double>(base);
+        done += produced;
+        if (produced == 0) break;
+    }
+
+    // Produce() always fits the chunk, but never leave garbage behind
+    if (done < outputFrames) {
+        std::memset(output + done * m_channels, 0,
+                    (outputFrames - done) * m_channels * sizeof(float));
+    }
+    return inside;
+}
+
+size_t PolyphaseResampler::Render(const int16_t* source, size_t sourceFrames, double position,
+                                  float* output, size_t outputFrames)
+{
+    return RenderSource(source, sourceFrames, position, output, outputFrames);
+}
+
+size_t PolyphaseResampler::Render(const float* source, size_t sourceFrames, double position,
+                                  float* output, size_t outputFrames)
+{
+    return RenderSource(source, sourceFrames, position, output, outputFrames);
+}
+
+const char* PolyphaseResampler::GetKernelName()
+{
+#if defined(__AVX__) && defined(__FMA__)
+    return "AVX/FMA";
+#elif defined(__AVX__)
+    return "AVX";
+#elif defined(RESAMPLER_HAVE_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
+
+}
+}
@@ -0,0 +1,183 @@
+#ifndef DSP_POLYPHASE_RESAMPLER_H
+#define DSP_POLYPHASE_RESAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Band-limited sample rate converter for playback.
+//
+// A Kaiser-windowed sinc is tabulated once at GetPhaseCount() + 1 evenly
+// spaced fractional offsets ("phases"). Each output frame interpolates the
+// two neighbouring phase rows into one coefficient row and takes an
+// inner product with GetTapCount() input frames per channel (SSE/AVX), so
+// the cost is a fixed GetMultiplyAddsPerFrame() regardless of the ratio
+// or of how the ratio changes. Positions are kept in double precision.
+//
+// When downsampling the cutoff follows the output rate; SetRates()
+// redesigns the table in place when that changes. SetRatio() only changes
+// the step and is meant for small per-block variations (varispeed,
+// clock drift correction) around the rates the table was designed for.
+//
+// Output frame n is aligned with input frame n (no delay), which needs
+// GetLatencyFrames() input frames of lookahead; the first output frames
+// see zeros before the start of the input.
+//
+// The constructor and Configure() allocate; everything else is
+// allocation-free and safe on the audio thread.
+class PolyphaseResampler {
+public:
+    // Same order as VeniceDAW::ProcessingQuality, so a value of that enum
+    // can be cast directly
+    enum Quality {
+        QUALITY_REALTIME,   // 16 taps
+        QUALITY_BALANCED,   // 32 taps
+        QUALITY_HIGHEST     // 64 taps
+    };
+
+    static const size_t kDefaultBlockFrames = 512;
+
+    explicit PolyphaseResampler(size_t channels = 2, Quality quality = QUALITY_BALANCED,
+                                size_t maxBlockFrames = kDefaultBlockFrames);
+    ~PolyphaseResampler() = default;
+
+    void Configure(size_t channels, Quality quality, size_t maxBlockFrames = kDefaultBlockFrames);
+
+    // Sets the ratio to inputRate / outputRate and redesigns the filter
+    // if the cutoff changes (only happens for downsampling). No-op when
+    // the rates are unchanged.
+    void SetRates(double inputRate, double outputRate);
+
+    // Input frames consumed per output frame; takes effect on the next
+    // output frame and keeps the current filter.
+    void SetRatio(double ratio);
+    double GetRatio() const { return m_ratio; }
+
+    size_t GetChannelCount() const { return m_channels; }
+    Quality GetQuality() const { return m_quality; }
+    size_t GetTapCount() const { return m_taps; }
+    size_t GetPhaseCount() const { return m_phases; }
+    size_t GetLatencyFrames() const { return m_halfTaps; }
+    size_t GetMultiplyAddsPerFrame() const { return m_taps * (m_channels + 1); }
+
+    // Streaming conversion of interleaved frames.
+    //
+    // Process() buffers the input, writes up to outputFrames frames and
+    // returns how many it wrote. On return inputFrames holds the number of
+    // input frames taken, which is limited by GetInputCapacity(); feeding
+    // GetInputFramesNeeded() frames, clamped to the capacity, never
+    // leaves input behind.
+    size_t Process(const float* input, size_t& inputFrames, float* output, size_t outputFrames);
+    size_t GetInputFramesNeeded(size_t outputFrames) const;
+    size_t GetInputCapacity() const { return m_capacity - m_fill; }
+
+    // Random access conversion of an interleaved source with the same
+    // channel count, for sample caches. Renders outputFrames frames
+    // starting at fractional source frame position, treating frames
+    // outside the source as silence, and returns how many of them start
+    // before the end of the source. int16 input is scaled by 1/32768.
+    //
+    // Render() uses the streaming history as scratch: call Reset() before
+    // going back to Process() on the same instance.
+    size_t Render(const int16_t* source, size_t sourceFrames, double position,
+                  float* output, size_t outputFrames);
+    size_t Render(const float* source, size_t sourceFrames, double position,
+                  float* output, size_t outputFrames);
+
+    // Render() from an int16 source that is not held in memory as a whole
+    // (a file mapping, compressed blocks): read(frame, dest, frames) copies
+    // up to frames interleaved frames from frame on into dest and returns
+    // how many it copied. Only the spans the filter reaches are read, at
+    // most kSpanSamples samples at a time; the result is the same as
+    // rendering the whole source.
+    static const size_t kSpanSamples = 4096;
+
+    template <typename Reader>
+    size_t RenderFrom(Reader&& read, size_t sourceFrames, double position,
+                      float* output, size_t outputFrames);
+
+    // Clears the streaming history; the next input frame is aligned with
+    // the next output frame
+    void Reset();
+
+    // Name of the widest inner product kernel compiled in
+    static const char* GetKernelName();
+
+private:
+    template <typename Sample>
+    size_t RenderSource(const Sample* source, size_t sourceFrames, double position,
+                        float* output, size_t outputFrames);
+    size_t Produce(double& position, float* output, size_t outputFrames);
+    void DesignTable();
+
+    size_t m_channels;
+    Quality m_quality;
+    size_t m_taps;
+    size_t m_halfTaps;
+    size_t m_phases;
+    float m_beta;
+    float m_rolloff;
+
+    double m_ratio;
+    double m_inputRate;
+    double m_outputRate;
+    double m_cutoff;
+
+    // (phases + 1) rows of taps coefficients
+    std::vector<float> m_table;
+    std::vector<float> m_row;
+
+    // Planar history, capacity frames per channel
+    std::vector<float> m_history;
+    size_t m_capacity;
+    size_t m_fill;
+    double m_position;
+};
+
+template <typename Reader>
+size_t PolyphaseResampler::RenderFrom(Reader&& read, size_t sourceFrames, double position,
+                                      float* output, size_t outputFrames)
+{
+    // Each run renders from a span holding every frame its filter reaches;
+    // frames outside the span are outside the source as well
+    int16_t span[kSpanSamples];
+    int64_t spanCapacity = static_cast<int64_t>(kSpanSamples / m_channels);
+    int64_t halfTaps = static_cast<int64_t>(m_halfTaps);
+    double room = static_cast<double>(spanCapacity - 2 * halfTaps - 2);
+    size_t runFrames = std::max<size_t>(1, static_cast<size_t>(room / m_ratio));
+
+    size_t inside = 0;
+    size_t done = 0;
+    while (done < outputFrames) {
+        size_t count = std::min(runFrames, outputFrames - done);
+        double last = position + static_cast<double>(count - 1) * m_ratio;
+
+        int64_t first = std::max<int64_t>(0, static_cast<int64_t>(std::floor(position)) - halfTaps);
+        int64_t end = std::min<int64_t>(static_cast<int64_t>(sourceFrames),
+                                        static_cast<int64_t>(std::floor(last)) + halfTaps + 2);
+        int64_t spanFrames = end > first ? read(first, span, end - first) : 0;
+
+        Render(span, static_cast<size_t>(std::max<int64_t>(0, spanFrames)),
+               position - static_cast<double>(first), output + done * m_channels, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (position + static_cast<double>(i) * m_ratio < static_cast<double>(sourceFrames)) {
+                inside = done + i + 1;
+            }
+        }
+
+        position += static_cast<double>(count) * m_ratio;
+        done += count;
+    }
+    return inside;
+}
+
+}
+}
+
+#endif
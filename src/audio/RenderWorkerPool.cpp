@@ -0,0 +1,321 @@
+/*
+ * RenderWorkerPool.cpp - Real-time helper threads for parallel track rendering
+ */
+
+#include "RenderWorkerPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <system_error>
+
+#ifndef __HAIKU__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define RENDER_POOL_X86 1
+#endif
+
+namespace VeniceDAW {
+
+const size_t RenderWorkerPool::kMaxWorkers;
+const size_t RenderWorkerPool::kDefaultParallelThreshold;
+
+namespace {
+
+// How long an idle worker keeps spinning before it parks. Long enough to
+// catch back-to-back runs (offline bounces, several small buffers per
+// period), short compared to a 256-frame period.
+const int64_t kSpinMicroseconds = 100;
+
+inline void SpinPause()
+{
+#ifdef RENDER_POOL_X86
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void ElevateCurrentThread(size_t index)
+{
+#ifdef __HAIKU__
+    char name[B_OS_NAME_LENGTH];
+    snprintf(name, sizeof(name), "VeniceDAW render %d", (int)index);
+    rename_thread(find_thread(NULL), name);
+    set_thread_priority(find_thread(NULL), B_REAL_TIME_PRIORITY);
+#else
+    (void)index;
+    // Needs privileges outside of Haiku; keep the default policy if refused
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+} // namespace
+
+RenderWorkerPool::RenderWorkerPool(size_t workerCount)
+    : fWorkerCount(workerCount),
+      fParallelThreshold(kDefaultParallelThreshold),
+      fRunning(false),
+      fLaneCount(1),
+      fFunction(nullptr),
+      fCookie(nullptr),
+      fCompleted(0),
+      fGeneration(0),
+      fParallelRuns(0),
+      fSerialRuns(0),
+      fStolenTasks(0)
+{
+    if (fWorkerCount == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        fWorkerCount = cores > 1 ? cores - 1 : 0;
+    }
+    fWorkerCount = std::min(fWorkerCount, kMaxWorkers);
+    fLaneCount = fWorkerCount + 1;
+
+    for (size_t i = 0; i <= kMaxWorkers; ++i) {
+        fLanes[i].cursor.store(0, std::memory_order_relaxed);
+        fSleepers[i].parked.store(false, std::memory_order_relaxed);
+#ifdef __HAIKU__
+        fSleepers[i].wake = create_sem(0, "render worker wake");
+#else
+        sem_init(&fSleepers[i].wake, 0, 0);
+#endif
+    }
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    Stop();
+
+    for (size_t i = 0; i <= kMaxWorkers; ++i) {
+#ifdef __HAIKU__
+        delete_sem(fSleepers[i].wake);
+#else
+        sem_destroy(&fSleepers[i].wake);
+#endif
+    }
+}
+
+void* RenderWorkerPool::operator new(size_t size)
+{
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignof(RenderWorkerPool), size) != 0) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void RenderWorkerPool::operator delete(void* pointer)
+{
+    free(pointer);
+}
+
+bool RenderWorkerPool::Start()
+{
+    if (fRunning.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    fRunning.store(true, std::memory_order_release);
+    try {
+        for (size_t i = 0; i < fWorkerCount; ++i) {
+            fThreads.emplace_back(&RenderWorkerPool::_WorkerLoop, this, i + 1);
+        }
+    } catch (const std::system_error& error) {
+        printf("RenderWorkerPool: Could not spawn worker %d: %s\n",
+               (int)fThreads.size(), error.what());
+        Stop();
+        return false;
+    }
+
+    printf("RenderWorkerPool: %d render workers started\n", (int)fWorkerCount);
+    return true;
+}
+
+void RenderWorkerPool::Stop()
+{
+    if (!fRunning.exchange(false, std::memory_order_seq_cst) && fThreads.empty()) {
+        return;
+    }
+
+    _WakeParked();
+
+    for (std::thread& thread : fThreads) {
+        thread.join();
+    }
+    fThreads.clear();
+}
+
+void RenderWorkerPool::Run(size_t taskCount, TaskFunction function, void* cookie)
+{
+    if (taskCount == 0) {
+        return;
+    }
+
+    if (taskCount < fParallelThreshold.load(std::memory_order_relaxed) || fThreads.empty()
+        || !fRunning.load(std::memory_order_relaxed)) {
+        for (size_t task = 0; task < taskCount; ++task) {
+            function(cookie, task);
+        }
+        fSerialRuns++;
+        return;
+    }
+
+    // Every task of the previous run has completed, so nobody reads these
+    // until a claim on the lanes below succeeds
+    fFunction = function;
+    fCookie = cookie;
+    fCompleted.store(0, std::memory_order_relaxed);
+
+    for (size_t lane = 0; lane < fLaneCount; ++lane) {
+        uint64_t begin = taskCount * lane / fLaneCount;
+        uint64_t end = taskCount * (lane + 1) / fLaneCount;
+        fLanes[lane].cursor.store(begin << 32 | end, std::memory_order_release);
+    }
+
+    fGeneration.fetch_add(1, std::memory_order_seq_cst);
+    _WakeParked();
+
+    _Participate(0);
+
+    // Only tasks already claimed by workers are left. Yield now and then
+    // in case one of them was preempted on the core we are spinning on.
+    for (unsigned spins = 1; fCompleted.load(std::memory_order_acquire) < taskCount; ++spins) {
+        if ((spins & 1023) == 0) {
+            std::this_thread::yield();
+        } else {
+            SpinPause();
+        }
+    }
+    fParallelRuns++;
+}
+
+bool RenderWorkerPool::_Claim(size_t lane, size_t& task)
+{
+    std::atomic<uint64_t>& cursor = fLanes[lane].cursor;
+    uint64_t value = cursor.load(std::memory_order_relaxed);
+
+    for (;;) {
+        uint64_t next = value >> 32;
+        uint64_t end = value & 0xffffffffu;
+        if (next >= end) {
+            return false;
+        }
+        if (cursor.compare_exchange_weak(value, value + (uint64_t(1) << 32),
+                                         std::memory_order_acquire, std::memory_order_relaxed)) {
+            task = static_cast<size_t>(next);
+            return true;
+        }
+    }
+}
+
+void RenderWorkerPool::_Participate(size_t lane)
+{
+    // The function is read after the claim: a claim can only succeed on
+    // lanes published by the run that is still waiting for this task
+    size_t task;
+    while (_Claim(lane, task)) {
+        fFunction(fCookie, task);
+        fCompleted.fetch_add(1, std::memory_order_release);
+    }
+
+    for (size_t i = 1; i < fLaneCount; ++i) {
+        size_t victim = (lane + i) % fLaneCount;
+        while (_Claim(victim, task)) {
+            fFunction(fCookie, task);
+            fCompleted.fetch_add(1, std::memory_order_release);
+            fStolenTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void RenderWorkerPool::_WorkerLoop(size_t lane)
+{
+    ElevateCurrentThread(lane);
+
+    uint32_t seen = fGeneration.load(std::memory_order_acquire);
+
+    for (;;) {
+        uint32_t generation = seen;
+        std::chrono::steady_clock::time_point spinUntil =
+            std::chrono::steady_clock::now() + std::chrono::microseconds(kSpinMicroseconds);
+
+        for (unsigned spins = 1; ; ++spins) {
+            generation = fGeneration.load(std::memory_order_acquire);
+            if (generation != seen || !fRunning.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if ((spins & 63) == 0 && std::chrono::steady_clock::now() >= spinUntil) {
+                break;
+            }
+            SpinPause();
+        }
+
+        if (generation == seen) {
+            _Park(lane, seen);
+            generation = fGeneration.load(std::memory_order_acquire);
+            if (generation == seen && fRunning.load(std::memory_order_acquire)) {
+                continue;
+            }
+        }
+
+        if (!fRunning.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        seen = generation;
+        _Participate(lane);
+    }
+}
+
+void RenderWorkerPool::_Park(size_t lane, uint32_t seen)
+{
+    Sleeper& sleeper = fSleepers[lane];
+
+    // Pairs with the generation bump in Run(): either this check sees the
+    // new run, or Run() sees the flag and releases the semaphore
+    sleeper.parked.store(true, std::memory_order_seq_cst);
+    if (fGeneration.load(std::memory_order_seq_cst) != seen
+        || !fRunning.load(std::memory_order_seq_cst)) {
+        if (sleeper.parked.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        // Too late to take it back: consume the release that is coming
+    }
+
+#ifdef __HAIKU__
+    while (acquire_sem(sleeper.wake) == B_INTERRUPTED) {
+    }
+#else
+    while (sem_wait(&sleeper.wake) != 0 && errno == EINTR) {
+    }
+#endif
+}
+
+void RenderWorkerPool::_WakeParked()
+{
+    // Lock-free: one exchange per worker, and a release only for the
+    // parked ones
+    for (size_t lane = 1; lane < fLaneCount; ++lane) {
+        Sleeper& sleeper = fSleepers[lane];
+        if (sleeper.parked.load(std::memory_order_seq_cst)
+            && sleeper.parked.exchange(false, std::memory_order_acq_rel)) {
+#ifdef __HAIKU__
+            release_sem_etc(sleeper.wake, 1, B_DO_NOT_RESCHEDULE);
+#else
+            sem_post(&sleeper.wake);
+#endif
+        }
+    }
+}
+
+} // namespace VeniceDAW
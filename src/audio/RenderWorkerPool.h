@@ -0,0 +1,120 @@
+#ifndef RENDER_WORKER_POOL_H
+#define RENDER_WORKER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include <semaphore.h>
+#endif
+
+namespace VeniceDAW {
+
+// Fixed pool of pre-spawned real-time threads that help the audio callback
+// render independent tasks (tracks) in parallel.
+//
+// Run() splits the tasks into one contiguous range per participant - the
+// calling thread plus every worker - and each participant claims tasks
+// from its own range with a CAS on a single packed cursor, then steals
+// from the other ranges once its own is exhausted. Completion is a
+// lock-free counter the caller spins on, so a run takes no locks and no
+// semaphores. The caller always takes part: a worker that wakes late
+// simply finds nothing left to claim.
+//
+// Between runs the workers spin for a short while and then park on a
+// semaphore of their own. Run() releases the semaphore of each worker that
+// is actually parked, which never blocks the audio thread.
+//
+// Task functions write to task-private memory only. The caller combines
+// the results after Run() returns, in task order, so the output does not
+// depend on which thread rendered what.
+class RenderWorkerPool {
+public:
+    typedef void (*TaskFunction)(void* cookie, size_t task);
+
+    static const size_t kMaxWorkers = 15;
+    static const size_t kDefaultParallelThreshold = 8;
+
+    // workerCount 0 picks one worker per remaining core
+    explicit RenderWorkerPool(size_t workerCount = 0);
+    ~RenderWorkerPool();
+
+    // Keeps the lanes on their own cache lines on the heap also before
+    // C++17 aligned new
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer);
+
+    // Spawns the workers at real-time priority (best effort outside of
+    // Haiku). Neither Start() nor Stop() may be called from the audio
+    // thread or during a Run().
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return fRunning.load(std::memory_order_acquire); }
+
+    size_t GetWorkerCount() const { return fWorkerCount; }
+
+    // Runs with fewer tasks than this are rendered on the calling thread
+    void SetParallelThreshold(size_t taskCount) { fParallelThreshold.store(taskCount, std::memory_order_relaxed); }
+    size_t GetParallelThreshold() const { return fParallelThreshold.load(std::memory_order_relaxed); }
+
+    // Calls function(cookie, task) once for every task in [0, taskCount)
+    // and returns when all of them have completed
+    void Run(size_t taskCount, TaskFunction function, void* cookie);
+
+    // Statistics, for benchmarks and diagnostics
+    uint64_t GetParallelRuns() const { return fParallelRuns; }
+    uint64_t GetSerialRuns() const { return fSerialRuns; }
+    uint64_t GetStolenTasks() const { return fStolenTasks.load(std::memory_order_relaxed); }
+
+private:
+    // next << 32 | end, so a claim is one CAS
+    struct alignas(64) Lane {
+        std::atomic<uint64_t> cursor;
+    };
+
+    // A worker's parking place; parked is only ever set by the worker
+    // and cleared by whoever releases wake
+    struct alignas(64) Sleeper {
+        std::atomic<bool> parked;
+#ifdef __HAIKU__
+        sem_id wake;
+#else
+        sem_t wake;
+#endif
+    };
+
+    void _WorkerLoop(size_t lane);
+    void _Park(size_t lane, uint32_t seen);
+    void _WakeParked();
+    void _Participate(size_t lane);
+    bool _Claim(size_t lane, size_t& task);
+
+    size_t fWorkerCount;
+    std::atomic<size_t> fParallelThreshold;
+    std::vector<std::thread> fThreads;
+    std::atomic<bool> fRunning;
+
+    Lane fLanes[kMaxWorkers + 1];
+    size_t fLaneCount;
+
+    // Current run, written before the lanes are published
+    TaskFunction fFunction;
+    void* fCookie;
+    alignas(64) std::atomic<size_t> fCompleted;
+    alignas(64) std::atomic<uint32_t> fGeneration;
+
+    Sleeper fSleepers[kMaxWorkers + 1];
+
+    uint64_t fParallelRuns;
+    uint64_t fSerialRuns;
+    std::atomic<uint64_t> fStolenTasks;
+};
+
+} // namespace VeniceDAW
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * ReverbBus.cpp - Shared send/return reverb
+ */
+
+#include "ReverbBus.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace VeniceDAW {
+
+ReverbBus::ReverbBus()
+    : fSampleRate(44100.0f)
+    , fReturnLevel(1.0f)
+    , fMaxBlockFrames(0)
+    , fBlockFrames(0)
+    , fTailRemaining(0)
+    , fHasSend(false)
+{
+    // Same medium room the per-track reverbs used
+    fReverb.SetSampleRate(fSampleRate);
+    fReverb.SetRoomSize(0.7f);
+    fReverb.SetDamping(0.5f);
+    fReverb.SetWidth(1.0f);
+
+    SetMaxBlockFrames(kDefaultMaxBlockFrames);
+}
+
+ReverbBus::~ReverbBus()
+{
+}
+
+void ReverbBus::SetSampleRate(float sampleRate)
+{
+    if (fSampleRate != sampleRate) {
+        fSampleRate = sampleRate;
+        fReverb.SetSampleRate(sampleRate);
+        fTailRemaining = 0;
+    }
+}
+
+void ReverbBus::SetMaxBlockFrames(int frames)
+{
+    fMaxBlockFrames = std::max(frames, 1);
+    fSendLeft.assign(fMaxBlockFrames, 0.0f);
+    fSendRight.assign(fMaxBlockFrames, 0.0f);
+    fReturnLeft.assign(fMaxBlockFrames, 0.0f);
+    fReturnRight.assign(fMaxBlockFrames, 0.0f);
+    fBlockFrames = 0;
+    fHasSend = false;
+}
+
+void ReverbBus::BeginBlock(int frameCount)
+{
+    // Only the frames the previous block sent to need clearing
+    if (fHasSend) {
+        memset(fSendLeft.data(), 0, fBlockFrames * sizeof(float));
+        memset(fSendRight.data(), 0, fBlockFrames * sizeof(float));
+    }
+    fBlockFrames = std::min(frameCount, fMaxBlockFrames);
+    fHasSend = false;
+}
+
+void ReverbBus::AddSend(int offset, const float* input, int frameCount, float level)
+{
+    if (level <= 0.0f || offset >= fBlockFrames) {
+        return;
+    }
+
+    int frames = std::min(frameCount, fBlockFrames - offset);
+    float* left = fSendLeft.data() + offset;
+    float* right = fSendRight.data() + offset;
+
+    for (int i = 0; i < frames; i++) {
+        left[i] += input[i * 2] * level;
+        right[i] += input[i * 2 + 1] * level;
+    }
+
+    if (frames > 0) {
+        fHasSend = true;
+    }
+}
+
+float ReverbBus::ProcessAndMix(float* outputBuffer, int frameCount)
+{
+    int frames = std::min(frameCount, fBlockFrames);
+
+    if (fHasSend) {
+        fTailRemaining = fReverb.GetTailFrames();
+    } else if (fTailRemaining <= 0 || frames <= 0) {
+        return 0.0f;
+    } else {
+        fTailRemaining -= frames;
+    }
+
+    memset(fReturnLeft.data(), 0, frames * sizeof(float));
+    memset(fReturnRight.data(), 0, frames * sizeof(float));
+
+    // Silent sends while the tail decays: the buffers are already zero
+    fReverb.ProcessWet(fSendLeft.data(), fSendRight.data(),
+                       fReturnLeft.data(), fReturnRight.data(), frames);
+
+    float peakLevel = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        float left = fReturnLeft[i] * fReturnLevel;
+        float right = fReturnRight[i] * fReturnLevel;
+
+        outputBuffer[i * 2] += left;
+        outputBuffer[i * 2 + 1] += right;
+
+        float level = std::max(std::abs(left), std::abs(right));
+        if (level > peakLevel) peakLevel = level;
+    }
+
+    return peakLevel;
+}
+
+void ReverbBus::Reset()
+{
+    fReverb.Reset();
+    std::fill(fSendLeft.begin(), fSendLeft.end(), 0.0f);
+    std::fill(fSendRight.begin(), fSendRight.end(), 0.0f);
+    fTailRemaining = 0;
+    fHasSend = false;
+}
+
+} // namespace VeniceDAW
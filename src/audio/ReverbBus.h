@@ -0,0 +1,82 @@
+/*
+ * ReverbBus.h - Shared send/return reverb
+ *
+ * Tracks add a distance-scaled send into the bus while they mix; the bus
+ * then runs a single SpatialReverb over the summed sends and mixes the
+ * wet return into the output. The reverb is linear, so this sounds the
+ * same as one reverb per track at the cost of one.
+ */
+
+#ifndef REVERB_BUS_H
+#define REVERB_BUS_H
+
+#include "SpatialReverb.h"
+#include <vector>
+
+namespace VeniceDAW {
+
+/**
+ * ReverbBus - One reverb return shared by any number of tracks
+ *
+ * Per block:
+ *   bus.BeginBlock(frameCount);                // clears the sends
+ *   channel.ProcessAndMix(output, ...);        // each routed track adds its send
+ *   bus.ProcessAndMix(output, frameCount);     // reverb once, adds the return
+ *
+ * Send buffers are planar and hold GetMaxBlockFrames() frames; sends past
+ * that are dropped. SetMaxBlockFrames() and SetSampleRate() allocate, the
+ * rest does not.
+ */
+class ReverbBus {
+public:
+    static const int kDefaultMaxBlockFrames = 4096;
+
+    ReverbBus();
+    ~ReverbBus();
+
+    // Configuration
+    void SetSampleRate(float sampleRate);
+    void SetMaxBlockFrames(int frames);
+    int GetMaxBlockFrames() const { return fMaxBlockFrames; }
+
+    // Return level (0.0 to 1.0+) applied to the whole bus
+    void SetReturnLevel(float level) { fReturnLevel = level; }
+    float GetReturnLevel() const { return fReturnLevel; }
+
+    // Room parameters and distance curve of the shared reverb
+    SpatialReverb& GetReverb() { return fReverb; }
+    float CalculateWetAmount(float distance) { return fReverb.CalculateWetAmount(distance); }
+
+    // Send accumulation: adds level * input (stereo interleaved) to the
+    // sends starting at frame offset of the current block
+    void BeginBlock(int frameCount);
+    void AddSend(int offset, const float* input, int frameCount, float level);
+
+    // Runs the reverb over the summed sends and adds the return to a
+    // stereo interleaved buffer. Blocks without sends are skipped once the
+    // tail has decayed. Returns the return's peak level.
+    float ProcessAndMix(float* outputBuffer, int frameCount);
+
+    // True while the next ProcessAndMix() will run the reverb
+    bool IsActive() const { return fHasSend || fTailRemaining > 0; }
+
+    void Reset();
+
+private:
+    SpatialReverb fReverb;
+    float fSampleRate;
+    float fReturnLevel;
+    int fMaxBlockFrames;
+    int fBlockFrames;
+    int fTailRemaining;      // Frames until the tail is inaudible
+    bool fHasSend;
+
+    std::vector<float> fSendLeft;
+    std::vector<float> fSendRight;
+    std::vector<float> fReturnLeft;
+    std::vector<float> fReturnRight;
+};
+
+} // namespace VeniceDAW
+
+#endif // REVERB_BUS_H
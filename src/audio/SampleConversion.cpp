@@ -0,0 +1,521 @@
+#include "SampleConversion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // SSE2
+    #define CONVERT_HAVE_SSE2 1
+    #if defined(__SSSE3__)
+        #include <tmmintrin.h>  // SSSE3 (byte shuffles for packed 24-bit)
+        #define CONVERT_HAVE_SSSE3 1
+    #endif
+    #if defined(__AVX2__)
+        #include <immintrin.h>  // AVX2
+        #define CONVERT_HAVE_AVX2 1
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CONVERT_HAVE_NEON 1
+#endif
+
+namespace VeniceDAW {
+namespace DSP {
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool kHostIsBigEndian = true;
+#else
+const bool kHostIsBigEndian = false;
+#endif
+
+const float kInt16Scale = 32768.0f;         // 2^15
+const float kInt24Scale = 8388608.0f;       // 2^23
+const float kInt32Scale = 2147483648.0f;    // 2^31
+
+inline uint16_t Swap16(uint16_t value) {
+    return (uint16_t)((value >> 8) | (value << 8));
+}
+
+inline uint32_t Swap32(uint32_t value) {
+    return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+}
+
+// Saturate and round as the vector kernels do: clamp, then round to nearest
+inline int32_t Quantize(float sample, float scale) {
+    float scaled = std::min(std::max(sample * scale, -scale), scale - 1.0f);
+    return (int32_t)lrintf(scaled);
+}
+
+// int32 full scale is not a float; the vector kernels saturate it to
+// INT32_MAX after the conversion
+inline int32_t QuantizeInt32(float sample) {
+    float scaled = sample * kInt32Scale;
+    if (scaled >= kInt32Scale) {
+        return INT32_MAX;
+    }
+    return (int32_t)lrintf(std::max(scaled, -kInt32Scale));
+}
+
+#if defined(CONVERT_HAVE_SSE2)
+inline __m128i SwapLanes16(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+inline __m128i SwapLanes32(__m128i v) {
+    v = SwapLanes16(v);
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+inline __m128 Clamp(__m128 v, float scale) {
+    return _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-scale)), _mm_set1_ps(scale - 1.0f));
+}
+#endif
+
+#if defined(CONVERT_HAVE_AVX2)
+inline __m256i SwapLanes16(__m256i v) {
+    return _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+}
+
+inline __m256i SwapLanes32(__m256i v) {
+    v = SwapLanes16(v);
+    v = _mm256_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+inline __m256 Clamp(__m256 v, float scale) {
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-scale)), _mm256_set1_ps(scale - 1.0f));
+}
+#endif
+
+// Kernels, instantiated for native and swapped byte order
+
+template <bool kSwap>
+void Int16ToFloat(const uint8_t* input, float* output, size_t count) {
+    const float scale = 1.0f / kInt16Scale;
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+        if (kSwap) v = SwapLanes16(v);
+        __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(f, _mm256_set1_ps(scale)));
+    }
+#elif defined(CONVERT_HAVE_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+        if (kSwap) v = SwapLanes16(v);
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), _mm_set1_ps(scale)));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), _mm_set1_ps(scale)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t raw;
+        memcpy(&raw, input + i * 2, sizeof(raw));
+        if (kSwap) raw = Swap16(raw);
+        output[i] = (int16_t)raw * scale;
+    }
+}
+
+template <bool kSwap>
+void FloatToInt16(const float* input, uint8_t* output, size_t count) {
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtps_epi32(Clamp(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), kInt16Scale));
+        __m256i b = _mm256_cvtps_epi32(Clamp(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale), kInt16Scale));
+        // packs works per 128-bit lane: a0-3 b0-3 a4-7 b4-7
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        if (kSwap) packed = SwapLanes16(packed);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i * 2), packed);
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    const __m128 scale4 = _mm_set1_ps(kInt16Scale);
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_loadu_ps(input + i), scale4), kInt16Scale));
+        __m128i b = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale4), kInt16Scale));
+        __m128i packed = _mm_packs_epi32(a, b);
+        if (kSwap) packed = SwapLanes16(packed);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2), packed);
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t raw = (uint16_t)Quantize(input[i], kInt16Scale);
+        if (kSwap) raw = Swap16(raw);
+        memcpy(output + i * 2, &raw, sizeof(raw));
+    }
+}
+
+template <bool kSwap>
+void Int32ToFloat(const uint8_t* input, float* output, size_t count) {
+    const float scale = 1.0f / kInt32Scale;
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i * 4));
+        if (kSwap) v = SwapLanes32(v);
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(scale)));
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 4));
+        if (kSwap) v = SwapLanes32(v);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(scale)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t raw;
+        memcpy(&raw, input + i * 4, sizeof(raw));
+        if (kSwap) raw = Swap32(raw);
+        output[i] = (float)(int32_t)raw * scale;
+    }
+}
+
+template <bool kSwap>
+void FloatToInt32(const float* input, uint8_t* output, size_t count) {
+    size_t i = 0;
+    // cvtps returns INT32_MIN for values out of range; flipping every bit
+    // of it where the input reached full scale gives INT32_MAX
+#if defined(CONVERT_HAVE_AVX2)
+    const __m256 scale = _mm256_set1_ps(kInt32Scale);
+    for (; i + 8 <= count; i += 8) {
+        __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale);
+        __m256 overflow = _mm256_cmp_ps(scaled, scale, _CMP_GE_OQ);
+        __m256i v = _mm256_xor_si256(_mm256_cvtps_epi32(scaled), _mm256_castps_si256(overflow));
+        if (kSwap) v = SwapLanes32(v);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i * 4), v);
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    const __m128 scale4 = _mm_set1_ps(kInt32Scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(input + i), scale4);
+        __m128 overflow = _mm_cmpge_ps(scaled, scale4);
+        __m128i v = _mm_xor_si128(_mm_cvtps_epi32(scaled), _mm_castps_si128(overflow));
+        if (kSwap) v = SwapLanes32(v);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 4), v);
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t raw = (uint32_t)QuantizeInt32(input[i]);
+        if (kSwap) raw = Swap32(raw);
+        memcpy(output + i * 4, &raw, sizeof(raw));
+    }
+}
+
+// Packed 24-bit samples are read and written by byte, so byte order is
+// the file's rather than a swap of the host's
+void Int24ToFloat(const uint8_t* input, bool bigEndian, float* output, size_t count) {
+    size_t i = 0;
+#if defined(CONVERT_HAVE_SSSE3)
+    // Each sample into the top three bytes of a lane: the lane holds the
+    // sample times 2^8, which converts exactly
+    const __m128i order = bigEndian
+        ? _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+        : _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    const __m128 scale = _mm_set1_ps(1.0f / kInt32Scale);
+    // 16-byte loads of 12 bytes stay inside the input while 6 samples remain
+    for (; i + 6 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 3));
+        v = _mm_shuffle_epi8(v, order);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+#endif
+    const float scale1 = 1.0f / kInt24Scale;
+    for (; i < count; i++) {
+        const uint8_t* s = input + i * 3;
+        int32_t value = bigEndian
+            ? (int32_t)(((uint32_t)s[0] << 24) | ((uint32_t)s[1] << 16) | ((uint32_t)s[2] << 8))
+            : (int32_t)(((uint32_t)s[2] << 24) | ((uint32_t)s[1] << 16) | ((uint32_t)s[0] << 8));
+        output[i] = (value >> 8) * scale1;
+    }
+}
+
+void FloatToInt24(const float* input, uint8_t* output, bool bigEndian, size_t count) {
+    size_t i = 0;
+#if defined(CONVERT_HAVE_SSSE3)
+    const __m128i order = bigEndian
+        ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+        : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128 scale = _mm_set1_ps(kInt24Scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_loadu_ps(input + i), scale), kInt24Scale));
+        v = _mm_shuffle_epi8(v, order);
+        uint8_t* d = output + i * 3;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(d), v);
+        int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        memcpy(d + 8, &tail, sizeof(tail));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t value = (uint32_t)Quantize(input[i], kInt24Scale);
+        uint8_t* d = output + i * 3;
+        if (bigEndian) {
+            d[0] = (uint8_t)(value >> 16);
+            d[1] = (uint8_t)(value >> 8);
+            d[2] = (uint8_t)value;
+        } else {
+            d[0] = (uint8_t)value;
+            d[1] = (uint8_t)(value >> 8);
+            d[2] = (uint8_t)(value >> 16);
+        }
+    }
+}
+
+void InterleaveStereo(const float* left, const float* right, float* output, size_t frames) {
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 8 <= frames; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        __m256 low = _mm256_unpacklo_ps(l, r);     // l0 r0 l1 r1 | l4 r4 l5 r5
+        __m256 high = _mm256_unpackhi_ps(l, r);    // l2 r2 l3 r3 | l6 r6 l7 r7
+        _mm256_storeu_ps(output + i * 2, _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_storeu_ps(output + i * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(output + i * 2, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(output + i * 2 + 4, _mm_unpackhi_ps(l, r));
+    }
+#endif
+    for (; i < frames; i++) {
+        output[i * 2] = left[i];
+        output[i * 2 + 1] = right[i];
+    }
+}
+
+void DeinterleaveStereo(const float* input, float* left, float* right, size_t frames) {
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(input + i * 2);
+        __m256 b = _mm256_loadu_ps(input + i * 2 + 8);
+        __m256 first = _mm256_permute2f128_ps(a, b, 0x20);     // l0 r0 l1 r1 | l4 r4 l5 r5
+        __m256 second = _mm256_permute2f128_ps(a, b, 0x31);    // l2 r2 l3 r3 | l6 r6 l7 r7
+        _mm256_storeu_ps(left + i, _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(right + i, _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(input + i * 2);
+        __m128 b = _mm_loadu_ps(input + i * 2 + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+    for (; i < frames; i++) {
+        left[i] = input[i * 2];
+        right[i] = input[i * 2 + 1];
+    }
+}
+
+}
+
+size_t SampleConversion::BytesPerSample(Encoding encoding) {
+    switch (encoding) {
+        case kInt16: return 2;
+        case kInt24: return 3;
+        default:     return 4;
+    }
+}
+
+bool SampleConversion::HostIsBigEndian() {
+    return kHostIsBigEndian;
+}
+
+void SampleConversion::ToFloat(const void* input, Encoding encoding, bool bigEndian,
+                               float* output, size_t count) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    bool swap = bigEndian != kHostIsBigEndian;
+    switch (encoding) {
+        case kInt16:
+            swap ? Int16ToFloat<true>(bytes, output, count)
+                 : Int16ToFloat<false>(bytes, output, count);
+            break;
+        case kInt24:
+            Int24ToFloat(bytes, bigEndian, output, count);
+            break;
+        case kInt32:
+            swap ? Int32ToFloat<true>(bytes, output, count)
+                 : Int32ToFloat<false>(bytes, output, count);
+            break;
+        case kFloat32:
+            if (swap) {
+                SwapBytes32(input, output, count);
+            } else {
+                memcpy(output, input, count * sizeof(float));
+            }
+            break;
+    }
+}
+
+void SampleConversion::FromFloat(const float* input, void* output, Encoding encoding,
+                                 bool bigEndian, size_t count) {
+    uint8_t* bytes = static_cast<uint8_t*>(output);
+    bool swap = bigEndian != kHostIsBigEndian;
+    switch (encoding) {
+        case kInt16:
+            swap ? FloatToInt16<true>(input, bytes, count)
+                 : FloatToInt16<false>(input, bytes, count);
+            break;
+        case kInt24:
+            FloatToInt24(input, bytes, bigEndian, count);
+            break;
+        case kInt32:
+            swap ? FloatToInt32<true>(input, bytes, count)
+                 : FloatToInt32<false>(input, bytes, count);
+            break;
+        case kFloat32:
+            if (swap) {
+                SwapBytes32(input, output, count);
+            } else {
+                memcpy(output, input, count * sizeof(float));
+            }
+            break;
+    }
+}
+
+void SampleConversion::SwapBytes16(const void* input, void* output, size_t count) {
+    const uint8_t* source = static_cast<const uint8_t*>(input);
+    uint8_t* dest = static_cast<uint8_t*>(output);
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 2));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 2), SwapLanes16(v));
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 2), SwapLanes16(v));
+    }
+#elif defined(CONVERT_HAVE_NEON)
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u8(dest + i * 2, vrev16q_u8(vld1q_u8(source + i * 2)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint16_t value;
+        memcpy(&value, source + i * 2, sizeof(value));
+        value = Swap16(value);
+        memcpy(dest + i * 2, &value, sizeof(value));
+    }
+}
+
+void SampleConversion::SwapBytes32(const void* input, void* output, size_t count) {
+    const uint8_t* source = static_cast<const uint8_t*>(input);
+    uint8_t* dest = static_cast<uint8_t*>(output);
+    size_t i = 0;
+#if defined(CONVERT_HAVE_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 4), SwapLanes32(v));
+    }
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), SwapLanes32(v));
+    }
+#elif defined(CONVERT_HAVE_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u8(dest + i * 4, vrev32q_u8(vld1q_u8(source + i * 4)));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t value;
+        memcpy(&value, source + i * 4, sizeof(value));
+        value = Swap32(value);
+        memcpy(dest + i * 4, &value, sizeof(value));
+    }
+}
+
+void SampleConversion::Interleave(const float* const* planar, size_t channels,
+                                  float* interleaved, size_t frames) {
+    if (channels == 1) {
+        memcpy(interleaved, planar[0], frames * sizeof(float));
+    } else if (channels == 2) {
+        InterleaveStereo(planar[0], planar[1], interleaved, frames);
+    } else {
+        for (size_t channel = 0; channel < channels; channel++) {
+            const float* source = planar[channel];
+            float* dest = interleaved + channel;
+            for (size_t i = 0; i < frames; i++) {
+                dest[i * channels] = source[i];
+            }
+        }
+    }
+}
+
+void SampleConversion::Deinterleave(const float* interleaved, size_t channels,
+                                    float* const* planar, size_t frames) {
+    if (channels == 1) {
+        memcpy(planar[0], interleaved, frames * sizeof(float));
+    } else if (channels == 2) {
+        DeinterleaveStereo(interleaved, planar[0], planar[1], frames);
+    } else {
+        for (size_t channel = 0; channel < channels; channel++) {
+            const float* source = interleaved + channel;
+            float* dest = planar[channel];
+            for (size_t i = 0; i < frames; i++) {
+                dest[i] = source[i * channels];
+            }
+        }
+    }
+}
+
+size_t SampleConversion::ReadRing(const void* ring, size_t capacity, size_t position,
+                                  void* output, size_t count, size_t elementSize) {
+    const uint8_t* source = static_cast<const uint8_t*>(ring);
+    uint8_t* dest = static_cast<uint8_t*>(output);
+
+    // At most two contiguous runs: up to the end of the ring, then from its start
+    size_t firstRun = std::min(count, capacity - position);
+    memcpy(dest, source + position * elementSize, firstRun * elementSize);
+    memcpy(dest + firstRun * elementSize, source, (count - firstRun) * elementSize);
+
+    position += count;
+    return position >= capacity ? position - capacity : position;
+}
+
+size_t SampleConversion::WriteRing(void* ring, size_t capacity, size_t position,
+                                   const void* input, size_t count, size_t elementSize) {
+    const uint8_t* source = static_cast<const uint8_t*>(input);
+    uint8_t* dest = static_cast<uint8_t*>(ring);
+
+    size_t firstRun = std::min(count, capacity - position);
+    memcpy(dest + position * elementSize, source, firstRun * elementSize);
+    memcpy(dest, source + firstRun * elementSize, (count - firstRun) * elementSize);
+
+    position += count;
+    return position >= capacity ? position - capacity : position;
+}
+
+const char* SampleConversion::GetKernelName() {
+#if defined(CONVERT_HAVE_AVX2)
+    return "AVX2";
+#elif defined(CONVERT_HAVE_SSE2)
+    return "SSE2";
+#elif defined(CONVERT_HAVE_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+}
+}
@@ -0,0 +1,69 @@
+#ifndef DSP_SAMPLE_CONVERSION_H
+#define DSP_SAMPLE_CONVERSION_H
+
+#include <cstddef>
+
+namespace VeniceDAW {
+namespace DSP {
+
+// Sample format, layout and ring-buffer copy kernels for the I/O paths.
+//
+// Integer samples map to float by dividing by 2^(bits - 1), so every
+// integer converts exactly and converts back to itself. Float to integer
+// scales by the same power of two, saturates to the integer range and
+// rounds to nearest (ties to even). 24-bit samples are packed, 3 bytes
+// each. Either byte order can be read and written on any host.
+//
+// Block kernels run 8 (AVX2) or 4-8 (SSE2) samples per instruction, 24-bit
+// ones where SSSE3 byte shuffles are available, with a scalar loop for the
+// rest; all paths give bit-identical results (SampleConversionTest). None
+// allocates; input and output need no particular alignment and must not
+// overlap, except for the byte swaps, which may run in place.
+class SampleConversion {
+public:
+    enum Encoding {
+        kInt16,
+        kInt24,     // Packed, 3 bytes per sample
+        kInt32,
+        kFloat32
+    };
+
+    static size_t BytesPerSample(Encoding encoding);
+    static bool HostIsBigEndian();
+
+    // count samples to and from float
+    static void ToFloat(const void* input, Encoding encoding, bool bigEndian,
+                        float* output, size_t count);
+    static void FromFloat(const float* input, void* output, Encoding encoding,
+                          bool bigEndian, size_t count);
+
+    // Reverse the bytes of count 16- or 32-bit values
+    static void SwapBytes16(const void* input, void* output, size_t count);
+    static void SwapBytes32(const void* input, void* output, size_t count);
+
+    // Interleaved frames to and from one buffer per channel. Stereo has
+    // dedicated kernels; a planar buffer may be passed for several
+    // channels, e.g. to spread mono over a stereo pair.
+    static void Interleave(const float* const* planar, size_t channels,
+                           float* interleaved, size_t frames);
+    static void Deinterleave(const float* interleaved, size_t channels,
+                             float* const* planar, size_t frames);
+
+    // Copy count elements of elementSize bytes out of or into a ring of
+    // capacity elements, starting at element position (< capacity) and
+    // wrapping at most once (count <= capacity). Returns the position
+    // after the last element copied.
+    static size_t ReadRing(const void* ring, size_t capacity, size_t position,
+                           void* output, size_t count, size_t elementSize);
+    static size_t WriteRing(void* ring, size_t capacity, size_t position,
+                            const void* input, size_t count, size_t elementSize);
+
+    // Name of the widest kernel compiled in ("AVX2", "SSE2", "NEON" or
+    // "Scalar"; NEON covers the byte swaps only)
+    static const char* GetKernelName();
+};
+
+}
+}
+
+#endif
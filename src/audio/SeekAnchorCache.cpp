@@ -0,0 +1,353 @@
+/*
+ * SeekAnchorCache.cpp - Decoded pre-roll blocks for instant locates
+ */
+
+#include "SeekAnchorCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace VeniceDAW {
+
+const int32 SeekAnchorCache::kMaxAnchors;
+const int32 SeekAnchorCache::kMaxPinnedAnchors;
+const int64 SeekAnchorCache::kAnchorFrames;
+const int64 SeekAnchorCache::kMinPrerollFrames;
+
+SeekAnchorCache::SeekAnchorCache(int32 channels)
+    : fChannels(channels),
+      fFileFrames(0),
+      fRecentRequest(-1),
+      fHits(0),
+      fMisses(0)
+{
+    for (Anchor& anchor : fAnchors) {
+        anchor.kind = kRecentAnchor;
+        anchor.used = false;
+        anchor.capturing = false;
+        anchor.frame = 0;
+        anchor.frames = 0;
+        anchor.captured = 0;
+        anchor.generation = 0;
+        anchor.captureGeneration = 0;
+        anchor.lastUsed = 0;
+        anchor.data = nullptr;
+        anchor.holds = 0;
+    }
+}
+
+SeekAnchorCache::~SeekAnchorCache()
+{
+    for (Anchor& anchor : fAnchors) {
+        delete[] anchor.data;
+    }
+}
+
+void SeekAnchorCache::Reset(int64 fileFrames)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    for (Anchor& anchor : fAnchors) {
+        _Clear(anchor);
+    }
+
+    fFileFrames = fileFrames;
+    fRecentRequest = -1;
+    fHits = 0;
+    fMisses = 0;
+
+    int32 index = _FreeSlot();
+    if (index >= 0 && fileFrames > 0) {
+        Anchor& anchor = fAnchors[index];
+        anchor.kind = kStartAnchor;
+        anchor.used = true;
+        anchor.frame = 0;
+    }
+}
+
+status_t SeekAnchorCache::AddAnchor(int64 frame)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    if (frame < 0 || frame >= fFileFrames) {
+        return B_BAD_VALUE;
+    }
+
+    int32 index = _Find(frame);
+    if (index >= 0) {
+        if (fAnchors[index].kind == kRecentAnchor) {
+            fAnchors[index].kind = kPinnedAnchor;
+        }
+        return B_OK;
+    }
+
+    int32 pinned = 0;
+    for (const Anchor& anchor : fAnchors) {
+        if (anchor.used && anchor.kind == kPinnedAnchor) {
+            pinned++;
+        }
+    }
+    if (pinned >= kMaxPinnedAnchors) {
+        return B_NO_MEMORY;
+    }
+
+    index = _FreeSlot();
+    if (index < 0) {
+        return B_NO_MEMORY;
+    }
+
+    Anchor& anchor = fAnchors[index];
+    anchor.kind = kPinnedAnchor;
+    anchor.used = true;
+    anchor.frame = frame;
+    return B_OK;
+}
+
+void SeekAnchorCache::RemoveAnchor(int64 frame)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    int32 index = _Find(frame);
+    if (index < 0 || fAnchors[index].kind != kPinnedAnchor) {
+        return;
+    }
+
+    // A decoded one is still good as a recent locate
+    Anchor& anchor = fAnchors[index];
+    if (anchor.frames > 0) {
+        anchor.kind = kRecentAnchor;
+    } else {
+        _Clear(anchor);
+    }
+}
+
+void SeekAnchorCache::ClearPinnedAnchors()
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    for (Anchor& anchor : fAnchors) {
+        if (!anchor.used || anchor.kind != kPinnedAnchor) {
+            continue;
+        }
+        if (anchor.frames > 0) {
+            anchor.kind = kRecentAnchor;
+        } else {
+            _Clear(anchor);
+        }
+    }
+}
+
+bool SeekAnchorCache::Acquire(int64 frame, Preroll* preroll)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    for (int32 i = 0; i < kMaxAnchors; i++) {
+        Anchor& anchor = fAnchors[i];
+        if (!anchor.used || anchor.frames <= 0 || frame < anchor.frame) {
+            continue;
+        }
+
+        int64 offset = frame - anchor.frame;
+        int64 remaining = anchor.frames - offset;
+        bool toEnd = anchor.frame + anchor.frames >= fFileFrames;
+        if (remaining <= 0 || (remaining < kMinPrerollFrames && !toEnd)) {
+            continue;
+        }
+
+        anchor.holds.fetch_add(1);
+        anchor.lastUsed = system_time();
+        fHits++;
+
+        GetHeld(i, offset, preroll);
+        return true;
+    }
+
+    fMisses++;
+    fRecentRequest = frame;
+    return false;
+}
+
+void SeekAnchorCache::GetHeld(int32 index, int64 offset, Preroll* preroll) const
+{
+    // Held anchors are never modified, so no lock is needed
+    const Anchor& anchor = fAnchors[index];
+    preroll->anchor = index;
+    preroll->offset = offset;
+    preroll->data = anchor.data + offset * fChannels;
+    preroll->frames = anchor.frames - offset;
+    preroll->resumeFrame = anchor.frame + anchor.frames;
+}
+
+void SeekAnchorCache::Release(int32 anchor)
+{
+    if (anchor >= 0 && anchor < kMaxAnchors) {
+        fAnchors[anchor].holds.fetch_sub(1);
+    }
+}
+
+bool SeekAnchorCache::HasPending() const
+{
+    int64 frame;
+    return NextPending(&frame);
+}
+
+bool SeekAnchorCache::NextPending(int64* frame) const
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    for (const Anchor& anchor : fAnchors) {
+        if (anchor.used && anchor.frames == 0 && !anchor.capturing) {
+            *frame = anchor.frame;
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 SeekAnchorCache::BeginCapture(int64 frame)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    int32 index = _Find(frame);
+    if (index >= 0) {
+        // Already decoded, or being decoded
+        if (fAnchors[index].frames > 0 || fAnchors[index].capturing) {
+            return -1;
+        }
+    } else {
+        // Only locates that missed become recent anchors
+        if (fRecentRequest != frame) {
+            return -1;
+        }
+        index = _FreeSlot();
+        if (index < 0) {
+            return -1;
+        }
+        fAnchors[index].kind = kRecentAnchor;
+        fAnchors[index].used = true;
+        fAnchors[index].frame = frame;
+    }
+    fRecentRequest = -1;
+
+    Anchor& anchor = fAnchors[index];
+    if (!anchor.data) {
+        anchor.data = new(std::nothrow) float[kAnchorFrames * fChannels];
+        if (!anchor.data) {
+            _Clear(anchor);
+            return -1;
+        }
+    }
+
+    anchor.capturing = true;
+    anchor.captured = 0;
+    anchor.captureGeneration = anchor.generation;
+    return index;
+}
+
+bool SeekAnchorCache::Capture(int32 index, const float* source, int64 frames)
+{
+    // Only the capturing reader touches the slot's data and count
+    Anchor& anchor = fAnchors[index];
+    int64 count = std::min(frames, kAnchorFrames - anchor.captured);
+    if (count > 0) {
+        memcpy(anchor.data + anchor.captured * fChannels, source,
+               count * fChannels * sizeof(float));
+        anchor.captured += count;
+    }
+    return anchor.captured < kAnchorFrames;
+}
+
+void SeekAnchorCache::EndCapture(int32 index)
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    Anchor& anchor = fAnchors[index];
+    anchor.capturing = false;
+
+    // Removed or reset meanwhile
+    if (!anchor.used || anchor.generation != anchor.captureGeneration) {
+        return;
+    }
+
+    if (anchor.captured == 0) {
+        // Nothing to decode there; don't retry forever
+        _Clear(anchor);
+        return;
+    }
+
+    anchor.frames = anchor.captured;
+    anchor.lastUsed = system_time();
+}
+
+SeekAnchorCache::Stats SeekAnchorCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    Stats stats;
+    stats.anchors = 0;
+    stats.pending = 0;
+    stats.hits = fHits;
+    stats.misses = fMisses;
+    stats.memoryBytes = 0;
+
+    for (const Anchor& anchor : fAnchors) {
+        if (anchor.used) {
+            if (anchor.frames > 0) {
+                stats.anchors++;
+            } else {
+                stats.pending++;
+            }
+        }
+        if (anchor.data) {
+            stats.memoryBytes += kAnchorFrames * fChannels * sizeof(float);
+        }
+    }
+    return stats;
+}
+
+int32 SeekAnchorCache::_Find(int64 frame) const
+{
+    for (int32 i = 0; i < kMaxAnchors; i++) {
+        if (fAnchors[i].used && fAnchors[i].frame == frame) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int32 SeekAnchorCache::_FreeSlot()
+{
+    int32 oldest = -1;
+
+    for (int32 i = 0; i < kMaxAnchors; i++) {
+        Anchor& anchor = fAnchors[i];
+        if (anchor.holds.load() > 0 || anchor.capturing) {
+            continue;
+        }
+        if (!anchor.used) {
+            return i;
+        }
+        if (anchor.kind == kRecentAnchor && anchor.frames > 0
+            && (oldest < 0 || anchor.lastUsed < fAnchors[oldest].lastUsed)) {
+            oldest = i;
+        }
+    }
+
+    // Evict the least recently used recent locate
+    if (oldest >= 0) {
+        _Clear(fAnchors[oldest]);
+    }
+    return oldest;
+}
+
+void SeekAnchorCache::_Clear(Anchor& anchor)
+{
+    // The data buffer is kept for the next anchor in this slot
+    anchor.used = false;
+    anchor.frames = 0;
+    anchor.captured = 0;
+    anchor.generation++;
+}
+
+} // namespace VeniceDAW
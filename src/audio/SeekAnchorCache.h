@@ -0,0 +1,136 @@
+/*
+ * SeekAnchorCache.h - Decoded pre-roll blocks for instant locates
+ *
+ * Keeps short blocks of decoded audio ("anchors") at the places a stream
+ * is likely to be located to: the start of the file, loop points and
+ * markers, and the most recently used locate positions. A locate that
+ * lands inside an anchor plays from it right away while the disk reader
+ * refills the stream from the end of the anchor.
+ */
+
+#ifndef SEEK_ANCHOR_CACHE_H
+#define SEEK_ANCHOR_CACHE_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <atomic>
+#include <mutex>
+
+namespace VeniceDAW {
+
+/*
+ * Threads: anchors are added and looked up by the control thread and
+ * decoded by the disk reader, both under an internal lock. The audio
+ * thread only plays from an anchor it holds - held anchors are never
+ * modified or evicted - and gives the hold back with Release(), which is
+ * lock-free.
+ */
+class SeekAnchorCache {
+public:
+    enum AnchorKind {
+        kStartAnchor,       // Start of the file, always kept
+        kPinnedAnchor,      // Loop point or marker, kept until removed
+        kRecentAnchor       // Recent locate, evicted least recently used first
+    };
+
+    static const int32 kMaxAnchors = 8;
+    static const int32 kMaxPinnedAnchors = 5;
+
+    // ~0.75s at 44.1kHz: covers the refill after a locate even when a
+    // whole session of streams locates at once
+    static const int64 kAnchorFrames = 32768;
+
+    // Locates closer than this to the end of an anchor are not served
+    // from it, unless the anchor runs to the end of the file
+    static const int64 kMinPrerollFrames = 8192;
+
+    // A locate served from an anchor: play frames frames from data, then
+    // continue at resumeFrame
+    struct Preroll {
+        int32 anchor;
+        int64 offset;           // Into the anchor
+        const float* data;
+        int64 frames;
+        int64 resumeFrame;
+    };
+
+    struct Stats {
+        int32 anchors;          // Decoded and ready
+        int32 pending;          // Waiting to be decoded
+        uint64 hits;
+        uint64 misses;
+        size_t memoryBytes;
+    };
+
+    explicit SeekAnchorCache(int32 channels);
+    ~SeekAnchorCache();
+
+    // Forgets every anchor and sets up a pending start anchor. Anchors held
+    // by the audio thread stay valid until released.
+    void Reset(int64 fileFrames);
+
+    // Control thread. Pinned anchors are decoded in the background.
+    status_t AddAnchor(int64 frame);
+    void RemoveAnchor(int64 frame);
+    void ClearPinnedAnchors();
+
+    // Looks up a decoded anchor for a locate to frame and holds it for the
+    // audio thread. On a miss the locate position is remembered, so the
+    // reader keeps the audio it streams from there as a recent anchor.
+    bool Acquire(int64 frame, Preroll* preroll);
+    // Lock-free, callable from the audio thread: the preroll of a held
+    // anchor at offset, and giving the hold back
+    void GetHeld(int32 anchor, int64 offset, Preroll* preroll) const;
+    void Release(int32 anchor);
+
+    // Disk reader: anchors still to be decoded. The reader either
+    // captures the audio it streams after a locate (BeginCapture with the
+    // locate frame) or decodes a pending anchor away from the stream
+    // position (NextPending, then BeginCapture with its frame).
+    bool HasPending() const;
+    bool NextPending(int64* frame) const;
+    int32 BeginCapture(int64 frame);
+    // Returns false once the anchor is complete
+    bool Capture(int32 anchor, const float* source, int64 frames);
+    void EndCapture(int32 anchor);
+
+    Stats GetStats() const;
+
+private:
+    struct Anchor {
+        AnchorKind kind;
+        bool used;              // Slot holds an anchor
+        bool capturing;         // Reader is decoding into it
+        int64 frame;            // First file frame
+        int64 frames;           // Decoded frames, 0 = pending
+        int64 captured;         // Frames written by the current capture
+        uint32 generation;      // Bumped when the slot is reassigned
+        uint32 captureGeneration;
+        bigtime_t lastUsed;
+        float* data;
+        std::atomic<int32> holds;
+    };
+
+    int32 _Find(int64 frame) const;
+    int32 _FreeSlot();
+    void _Clear(Anchor& anchor);
+
+    int32 fChannels;
+    int64 fFileFrames;
+    int64 fRecentRequest;       // Missed locate to keep, -1 if none
+    Anchor fAnchors[kMaxAnchors];
+
+    mutable std::mutex fLock;
+    uint64 fHits;
+    uint64 fMisses;
+
+    SeekAnchorCache(const SeekAnchorCache&) = delete;
+    SeekAnchorCache& operator=(const SeekAnchorCache&) = delete;
+};
+
+} // namespace VeniceDAW
+
+#endif // SEEK_ANCHOR_CACHE_H
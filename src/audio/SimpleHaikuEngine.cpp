@@ -4,13 +4,17 @@
 
 #include "SimpleHaikuEngine.h"
 #include "AudioFileStreamer.h"
+#include "AudioOutputDriver.h"
+#include "RenderWorkerPool.h"
+#include "SampleConversion.h"
 #include "VeniceAudioInputNode.h"  // Cortex integration
 // #include "AudioRecorder.h"  // Temporarily disabled
 #include "AudioConfig.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdint.h>
-#include <stdlib.h>  // For rand()
+#include <stdlib.h>
+#include <string.h>
 #include <storage/File.h>
 #include <media/MediaFormats.h>
 #include <media/MediaRoster.h>
@@ -22,8 +26,10 @@ namespace HaikuDAW {
 SimpleTrack::SimpleTrack(int id, const char* name)
     : fId(id), fName(name), fVolume(1.0f), fPan(0.0f), fX(0), fY(0), fZ(0), fMuted(false), fSolo(false),
       fPeakLevel(0.0f), fRMSLevel(0.0f), fPhase(0.0f), fSignalType(kSignalSine), fFrequency(440.0f),
-      fPinkNoiseMax(1.0f), fMonitoringMode(kMonitorBoth), fStreamer(nullptr), fFileLoaded(false),
+      fPinkNoiseMax(1.0f), fNoiseState((uint32)(id + 1) * 2654435761u),
+      fMonitoringMode(kMonitorBoth), fStreamer(nullptr), fFileLoaded(false),
       fLiveInputAvailable(false), fLiveInputFrameCount(0), fLiveInputChannels(0),
+      fRenderActive(false), fRenderPeak(0.0f), fRenderRMSSum(0.0f), fHasRenderLevels(false),
       fColorIndex(0)
 {
     // Track created
@@ -33,6 +39,7 @@ SimpleTrack::SimpleTrack(int id, const char* name)
     }
     // Initialize live input buffer
     memset(fLiveInputBuffer, 0, sizeof(fLiveInputBuffer));
+    memset(fRenderBuffer, 0, sizeof(fRenderBuffer));
     // File format now managed by AudioFileStreamer
 }
 
@@ -105,6 +112,10 @@ status_t SimpleTrack::ReadFileData(float* buffer, int32 frameCount, float sample
         return B_OK;
     }
 
+    // Files at another rate (e.g. 22.05 kHz material on a 48 kHz output)
+    // are resampled by the streamer; a no-op unless the rate changed
+    fStreamer->SetOutputSampleRate(sampleRate);
+
     // RT-safe read from lock-free ring buffer
     // This replaces the old synchronous BMediaTrack::ReadFrames() call
     return fStreamer->GetAudioData(buffer, frameCount);
@@ -134,6 +145,18 @@ float SimpleTrack::GetFileSampleRate() const
     return fStreamer ? fStreamer->GetSampleRate() : 44100.0f;
 }
 
+status_t SimpleTrack::AddLocateAnchor(int64 frame)
+{
+    return fStreamer ? fStreamer->AddLocateAnchor(frame) : B_NO_INIT;
+}
+
+void SimpleTrack::ClearLocateAnchors()
+{
+    if (fStreamer) {
+        fStreamer->ClearLocateAnchors();
+    }
+}
+
 const char* SimpleTrack::GetFilePath() const
 {
     return fStreamer ? fStreamer->GetFilePath() : "";
@@ -148,10 +171,11 @@ void SimpleTrack::ProcessLiveInput(const float* inputData, size_t frameCount, ui
     size_t framesToCopy = (frameCount < kLiveInputBufferSize / 2) ? frameCount : (kLiveInputBufferSize / 2);
 
     if (channels == 1) {
-        // Mono input - duplicate to stereo
-        for (size_t i = 0; i < framesToCopy; i++) {
-            fLiveInputBuffer[i * 2] = inputData[i] * fVolume;
-            fLiveInputBuffer[i * 2 + 1] = inputData[i] * fVolume;
+        // Mono input - duplicate to stereo, then apply volume
+        const float* pair[2] = { inputData, inputData };
+        ::VeniceDAW::DSP::SampleConversion::Interleave(pair, 2, fLiveInputBuffer, framesToCopy);
+        for (size_t i = 0; i < framesToCopy * 2; i++) {
+            fLiveInputBuffer[i] *= fVolume;
         }
     } else if (channels == 2) {
         // Stereo input - copy with volume
@@ -176,17 +200,15 @@ void SimpleTrack::ProcessLiveInput(const float* inputData, size_t frameCount, ui
 // === SimpleHaikuEngine ===
 
 SimpleHaikuEngine::SimpleHaikuEngine()
-    : fSoundPlayer(nullptr), fAudioTracks(&fTrackBuffer1), fRunning(false),
+    : fOutputDriver(nullptr), fSampleRate(44100.0f), fAudioTracks(&fTrackBuffer1), fRunning(false),
       fMasterVolume(1.0f), fSoloTrack(-1),
       fMasterPeakLeft(0.0f), fMasterPeakRight(0.0f), fMasterRMSLeft(0.0f), fMasterRMSRight(0.0f),
-      fRecordingSession(nullptr), fMonitoringTrackIndex(-1)
+      fRecordingSession(nullptr), fMonitoringTrackIndex(-1),
+      fRenderPool(new ::VeniceDAW::RenderWorkerPool())
 {
-    // Pre-allocate RT-safe buffer pool to avoid allocations in audio callback
-    fMixBuffer.resize(MAX_BUFFER_FRAMES * 2, 0.0f);  // Stereo buffer
-
     // Initialize double-buffered track lists for lock-free audio thread access
-    fTrackBuffer1.reserve(32);  // Pre-allocate for 32 tracks
-    fTrackBuffer2.reserve(32);
+    fTrackBuffer1.reserve(128);  // Pre-allocate for 128 tracks
+    fTrackBuffer2.reserve(128);
 
     printf("SimpleHaikuEngine: Initialized with lock-free track management\n");
 
@@ -203,7 +225,8 @@ SimpleHaikuEngine::~SimpleHaikuEngine()
     // delete fRecordingSession;  // Temporarily disabled
     fRecordingSession = nullptr;
 
-    delete fSoundPlayer;
+    delete fOutputDriver;
+    delete fRenderPool;
     
     // Cleanup tracks
     for (auto track : fTracks) {
@@ -223,47 +246,60 @@ status_t SimpleHaikuEngine::Start()
     // Check media_server status first
     // Checking media
     
-    // Use completely default format - let BSoundPlayer negotiate everything
+    if (!fOutputDriver) {
+        fOutputDriver = ::VeniceDAW::CreateAudioOutputDriver(getenv("VENICEDAW_AUDIO_DRIVER"),
+                                                             getenv("VENICEDAW_AUDIO_FILE"));
+        if (!fOutputDriver) {
+            printf("SimpleHaikuEngine: Unknown VENICEDAW_AUDIO_DRIVER '%s', using the default\n",
+                   getenv("VENICEDAW_AUDIO_DRIVER"));
+            fOutputDriver = ::VeniceDAW::CreateAudioOutputDriver(nullptr);
+        }
+    }
+
+    // Use completely default format - let the driver negotiate everything
     media_raw_audio_format format = media_raw_audio_format::wildcard;
     
-    // Don't force any parameters - let the system decide
-    // BSoundPlayer will negotiate the best format automatically
-    
-    // Using default format
-    
-    // Create BSoundPlayer with minimal parameters - let it negotiate everything
-    fSoundPlayer = new BSoundPlayer(&format, "VeniceDAW", _AudioCallback, nullptr, this);
-    
-    status_t status = fSoundPlayer->InitCheck();
+    status_t status = fOutputDriver->Open(format, _AudioCallback, this);
     if (status != B_OK) {
-        printf("SimpleHaikuEngine: BSoundPlayer init failed: %s (0x%x)\n", strerror(status), (int)status);
-        printf("CRITICAL: BSoundPlayer should ALWAYS work on native Haiku!\n");
-        printf("Possible causes:\n");
-        printf("  -> Another audio application is blocking the audio device\n");
-        printf("  -> BSoundPlayer created from wrong thread context\n");
-        printf("  -> Media preferences misconfigured\n");
-        printf("  -> System audio driver issues\n");
+        printf("SimpleHaikuEngine: %s output init failed: %s (0x%x)\n", fOutputDriver->Name(),
+               strerror(status), (int)status);
+        if (strcmp(fOutputDriver->Name(), "soundplayer") == 0) {
+            printf("CRITICAL: BSoundPlayer should ALWAYS work on native Haiku!\n");
+            printf("Possible causes:\n");
+            printf("  -> Another audio application is blocking the audio device\n");
+            printf("  -> BSoundPlayer created from wrong thread context\n");
+            printf("  -> Media preferences misconfigured\n");
+            printf("  -> System audio driver issues\n");
+        }
         return status;
     }
     
     // Print the negotiated format
-    media_raw_audio_format negotiatedFormat = fSoundPlayer->Format();
-    printf("✓ BSoundPlayer initialized successfully!\n");
+    media_raw_audio_format negotiatedFormat = fOutputDriver->Format();
+    fSampleRate = negotiatedFormat.frame_rate;
+    printf("✓ %s output initialized successfully!\n", fOutputDriver->Name());
     printf("  Format: %s\n", 
            (negotiatedFormat.format == media_raw_audio_format::B_AUDIO_FLOAT) ? "32-bit float" :
            (negotiatedFormat.format == media_raw_audio_format::B_AUDIO_SHORT) ? "16-bit integer" : "other");
     printf("  Sample rate: %.0f Hz\n", negotiatedFormat.frame_rate);
     printf("  Channels: %d\n", (int)negotiatedFormat.channel_count);
-    printf("  Buffer size: %ld bytes\n", negotiatedFormat.buffer_size);
+    printf("  Buffer size: %ld bytes\n", (long)negotiatedFormat.buffer_size);
     
-    float actualLatencyMs = (negotiatedFormat.buffer_size / (negotiatedFormat.channel_count * 
-                            (negotiatedFormat.format == media_raw_audio_format::B_AUDIO_FLOAT ? sizeof(float) : sizeof(int16)))) 
+    float actualLatencyMs = ::VeniceDAW::AudioOutputDriver::BufferFrames(negotiatedFormat)
                            * 1000.0f / negotiatedFormat.frame_rate;
     printf("  Latency: %.2f ms\n", actualLatencyMs);
     
-    status = fSoundPlayer->Start();
+    // Render workers must be up before the first callback; without them
+    // the callback renders every track itself
+    if (!fRenderPool->Start()) {
+        printf("SimpleHaikuEngine: Rendering all tracks on the audio thread\n");
+    }
+
+    status = fOutputDriver->Start();
     if (status != B_OK) {
-        printf("SimpleHaikuEngine: BSoundPlayer start failed\n");
+        printf("SimpleHaikuEngine: %s output start failed\n", fOutputDriver->Name());
+        fOutputDriver->Close();
+        fRenderPool->Stop();
         return status;
     }
     
@@ -284,18 +320,34 @@ status_t SimpleHaikuEngine::Stop()
     
     // Stopping
     
-    if (fSoundPlayer) {
-        fSoundPlayer->Stop();
+    if (fOutputDriver) {
+        fOutputDriver->Stop();
+        fOutputDriver->Close();
     }
+    fRenderPool->Stop();
     
     fRunning = false;
     // Stopped
     return B_OK;
 }
 
+status_t SimpleHaikuEngine::SetOutputDriver(::VeniceDAW::AudioOutputDriver* driver)
+{
+    if (fRunning) {
+        return B_NOT_ALLOWED;
+    }
+
+    if (driver != fOutputDriver) {
+        delete fOutputDriver;
+        fOutputDriver = driver;
+    }
+    return B_OK;
+}
+
 void SimpleHaikuEngine::ResetAllTracks()
 {
-    // Resetting tracks
+    // Resetting tracks; the start of every file is cached, so playback
+    // resumes without waiting for the disk
 
     for (SimpleTrack* track : fTracks) {
         if (track && track->HasFile()) {
@@ -305,6 +357,38 @@ void SimpleHaikuEngine::ResetAllTracks()
     }
 }
 
+void SimpleHaikuEngine::LocateAllTracks(double seconds)
+{
+    for (SimpleTrack* track : fTracks) {
+        if (track && track->HasFile()) {
+            track->SetPlaybackPosition((int64)(seconds * track->GetFileSampleRate()));
+        }
+    }
+}
+
+void SimpleHaikuEngine::AddLocateAnchor(double seconds)
+{
+    for (SimpleTrack* track : fTracks) {
+        if (track && track->HasFile()) {
+            int64 frame = (int64)(seconds * track->GetFileSampleRate());
+            if (frame < track->GetFileDuration()
+                && track->AddLocateAnchor(frame) != B_OK) {
+                printf("SimpleHaikuEngine: No room for another locate anchor on '%s'\n",
+                       track->GetName());
+            }
+        }
+    }
+}
+
+void SimpleHaikuEngine::ClearLocateAnchors()
+{
+    for (SimpleTrack* track : fTracks) {
+        if (track) {
+            track->ClearLocateAnchors();
+        }
+    }
+}
+
 int64 SimpleHaikuEngine::GetGlobalPlaybackPosition() const
 {
     // Get maximum playback position across all tracks with loaded files
@@ -383,187 +467,157 @@ void SimpleHaikuEngine::_AudioCallback(void* cookie, void* buffer, size_t size,
         return;
     }
     
-    // Calculate frame count based on actual format
-    size_t bytesPerSample = (format.format == media_raw_audio_format::B_AUDIO_FLOAT) ? sizeof(float) : sizeof(int16);
+    // Mix in float and convert to whatever the device takes; the mix is
+    // always stereo
+    ::VeniceDAW::DSP::SampleConversion::Encoding encoding;
+    switch (format.format) {
+        case media_raw_audio_format::B_AUDIO_FLOAT:
+            encoding = ::VeniceDAW::DSP::SampleConversion::kFloat32;
+            break;
+        case media_raw_audio_format::B_AUDIO_INT:
+            encoding = ::VeniceDAW::DSP::SampleConversion::kInt32;
+            break;
+        case media_raw_audio_format::B_AUDIO_SHORT:
+            encoding = ::VeniceDAW::DSP::SampleConversion::kInt16;
+            break;
+        default:
+            engine->_ProcessSilent(buffer, size, format);
+            return;
+    }
+
+    bool bigEndian = (format.byte_order == B_MEDIA_BIG_ENDIAN);
+    size_t bytesPerSample = ::VeniceDAW::DSP::SampleConversion::BytesPerSample(encoding);
     size_t frameCount = size / (format.channel_count * bytesPerSample);
-    
-    if (format.format == media_raw_audio_format::B_AUDIO_FLOAT) {
-        // Native float format - process directly
-        engine->_ProcessAudio(static_cast<float*>(buffer), frameCount);
-    } else {
-        // For any other format, clear buffer (silent audio)
-        // In a real implementation, you'd convert, but for now keep it simple
-        memset(buffer, 0, size);
-        
-        // Still call ProcessAudio for internal state updates (muting, level meters, etc.)
-        static float dummyBuffer[1024 * 2];  // Max 1024 stereo frames
-        if (frameCount * format.channel_count <= 1024 * 2) {
-            memset(dummyBuffer, 0, frameCount * format.channel_count * sizeof(float));
-            engine->_ProcessAudio(dummyBuffer, frameCount);
-        }
+
+    if (format.channel_count != 2) {
+        engine->_ProcessSilent(buffer, size, format);
+        return;
+    }
+
+    engine->_ProcessAudio(buffer, frameCount, encoding, bigEndian);
+}
+
+void SimpleHaikuEngine::_ProcessSilent(void* buffer, size_t size, const media_raw_audio_format& format)
+{
+    // A format the mix can't be converted to: output silence
+    memset(buffer, 0, size);
+
+    // Still call ProcessAudio for internal state updates (muting, level meters, etc.)
+    size_t bytesPerSample = format.format & media_raw_audio_format::B_AUDIO_SIZE_MASK;
+    if (bytesPerSample == 0 || format.channel_count == 0) return;
+    size_t frameCount = size / (format.channel_count * bytesPerSample);
+    if (frameCount > SimpleTrack::kRenderBufferFrames) {
+        frameCount = SimpleTrack::kRenderBufferFrames;
     }
+    _ProcessAudio(fConversionBuffer, frameCount, ::VeniceDAW::DSP::SampleConversion::kFloat32,
+                  ::VeniceDAW::DSP::SampleConversion::HostIsBigEndian());
 }
 
-void SimpleHaikuEngine::_ProcessAudio(float* buffer, size_t frameCount)
+namespace {
+
+// One callback's worth of track rendering, shared with the render workers
+struct TrackRenderJob {
+    SimpleHaikuEngine* engine;
+    std::vector<SimpleTrack*>* tracks;
+    size_t offset;          // Of this slice in the callback
+    size_t frameCount;
+    bool lastSlice;
+    float sampleRate;
+};
+
+} // namespace
+
+void SimpleHaikuEngine::_ProcessAudio(void* buffer, size_t frameCount,
+                                      ::VeniceDAW::DSP::SampleConversion::Encoding encoding,
+                                      bool bigEndian)
 {
+    if (frameCount == 0) return;
+
+    // Host-order float is mixed straight into the device buffer; anything
+    // else a slice at a time through fConversionBuffer
+    bool convert = encoding != ::VeniceDAW::DSP::SampleConversion::kFloat32
+        || bigEndian != ::VeniceDAW::DSP::SampleConversion::HostIsBigEndian();
+    size_t bytesPerSample = ::VeniceDAW::DSP::SampleConversion::BytesPerSample(encoding);
+
     // Master level calculation variables
     float masterPeakLeft = 0.0f;
     float masterPeakRight = 0.0f;
     float masterRMSLeft = 0.0f;
     float masterRMSRight = 0.0f;
 
-    // Get sample rate from BSoundPlayer format
-    float sampleRate = 44100.0f;  // Default, will be updated if possible
-    if (fSoundPlayer) {
-        media_raw_audio_format format = fSoundPlayer->Format();
-        sampleRate = format.frame_rate;
-    }
+    // Normalize by the gain factor used in audio processing to get visual levels
+    const float displayGain = AudioConstants::DISPLAY_GAIN_COMPENSATION;
+
+    // Negotiated by the output driver
+    float sampleRate = fSampleRate;
 
     // Use atomic track list for lock-free access (RT-safe)
     std::vector<SimpleTrack*>* audioTracks = fAudioTracks.load();
 
-    // Process audio for each track
-    for (size_t trackIndex = 0; trackIndex < audioTracks->size(); trackIndex++) {
-        SimpleTrack* track = (*audioTracks)[trackIndex];
-        
-        // Solo logic: if any track is solo, only play solo tracks (unless muted)
-        // If no solo, play all non-muted tracks
-        bool shouldPlay = false;
-        if (fSoloTrack >= 0) {
-            // Solo mode: only play if this track is solo AND not muted
-            shouldPlay = track->IsSolo() && !track->IsMuted();
-        } else {
-            // Normal mode: play if not muted
-            shouldPlay = !track->IsMuted();
+    // Render every track into its private buffer, spread over the render
+    // workers, then sum them in track order so the mix is identical no
+    // matter which thread rendered which track. Buffers larger than the
+    // track render buffers are rendered in slices; levels cover them all.
+    for (size_t offset = 0; offset < frameCount; offset += SimpleTrack::kRenderBufferFrames) {
+        size_t sliceFrames = frameCount - offset;
+        if (sliceFrames > SimpleTrack::kRenderBufferFrames) {
+            sliceFrames = SimpleTrack::kRenderBufferFrames;
         }
-        
-        if (!shouldPlay) continue;
-        
-        float volume = track->GetVolume() * fMasterVolume * AudioConstants::FILE_PLAYBACK_GAIN;
 
-        // Use track pan setting (-1 = left, 0 = center, +1 = right)
-        float pan = track->GetPan();
-
-        // Equal-power panning law (constant perceived loudness)
-        // Maps pan [-1,+1] to angle [0, π/2], then applies sin/cos
-        float panAngle = (pan + 1.0f) * 0.5f * M_PI_2;  // M_PI_2 = π/2
-        float leftGain = cosf(panAngle) * volume;        // Left weight
-        float rightGain = sinf(panAngle) * volume;       // Right weight
-        
-        // Process audio based on track type
-        float peakLevel = 0.0f;
-        float rmsSum = 0.0f;
-
-        bool hasFileAudio = track->HasFile();
-        bool hasLiveInput = track->HasLiveInput();
-        SimpleTrack::MonitoringMode mode = track->GetMonitoringMode();
-
-        // Apply monitoring mode filter
-        bool useFile = hasFileAudio && (mode == SimpleTrack::kMonitorFile || mode == SimpleTrack::kMonitorBoth);
-        bool useInput = hasLiveInput && (mode == SimpleTrack::kMonitorInput || mode == SimpleTrack::kMonitorBoth);
-
-        if (useFile || useInput) {
-            // FILE PLAYBACK AND/OR LIVE INPUT
-            // Use pre-allocated RT-safe buffer (no dynamic allocation!)
-            size_t requiredSize = frameCount * 2;
-            if (requiredSize > fMixBuffer.size()) {
-                // Buffer too small - skip this track to avoid allocation
-                // This should never happen with MAX_BUFFER_FRAMES = 4096
-                continue;
-            }
+        TrackRenderJob job = { this, audioTracks, offset, sliceFrames,
+                               offset + sliceFrames == frameCount, sampleRate };
+        fRenderPool->Run(audioTracks->size(), _RenderTrackEntry, &job);
 
-            // Clear buffer using memset (faster than std::fill)
-            memset(fMixBuffer.data(), 0, requiredSize * sizeof(float));
+        // Drivers and the conversion buffer hand over stale samples
+        float* output = convert ? fConversionBuffer : static_cast<float*>(buffer) + offset * 2;
+        memset(output, 0, sliceFrames * 2 * sizeof(float));
+        for (size_t trackIndex = 0; trackIndex < audioTracks->size(); trackIndex++) {
+            const SimpleTrack* track = (*audioTracks)[trackIndex];
+            if (!track->IsRenderActive()) continue;
 
-            // Read file audio if monitoring mode allows
-            if (useFile) {
-                status_t status = track->ReadFileData(fMixBuffer.data(), frameCount, sampleRate);
-                if (status != B_OK) {
-                    // File read failed, buffer remains cleared
-                    useFile = false;
-                }
+            const float* trackOutput = track->GetRenderBuffer();
+            for (size_t i = 0; i < sliceFrames * 2; i++) {
+                output[i] += trackOutput[i];
             }
+        }
 
-            // Mix in live input if monitoring mode allows
-            if (useInput) {
-                // Get live input data from track's buffer
-                size_t liveFrames = track->GetLiveInputFrameCount();
-                const float* liveData = track->GetLiveInputData();
-
-                if (liveData && liveFrames > 0) {
-                    // Mix live input with file audio (or use alone if no file)
-                    size_t framesToMix = (liveFrames < frameCount) ? liveFrames : frameCount;
-
-                    for (size_t i = 0; i < framesToMix; i++) {
-                        fMixBuffer[i * 2] += liveData[i * 2];       // Left
-                        fMixBuffer[i * 2 + 1] += liveData[i * 2 + 1]; // Right
-                    }
-                }
-            }
+        // Master levels of the final mix
+        for (size_t i = 0; i < sliceFrames; i++) {
+            float leftSample = fabsf(output[i * 2]) * displayGain;     // Left channel
+            float rightSample = fabsf(output[i * 2 + 1]) * displayGain; // Right channel
 
-            // Always clear live input flag (consumed), even if mode filtered it out
-            if (hasLiveInput) {
-                track->ClearLiveInput();
-            }
+            // Clamp to avoid overly high values
+            leftSample = fminf(leftSample, 2.0f);   // Max 2.0 for 200% display
+            rightSample = fminf(rightSample, 2.0f);
 
-            // Mix final audio into main buffer
-            for (size_t i = 0; i < frameCount; i++) {
-                float leftSample = fMixBuffer[i * 2];
-                float rightSample = fMixBuffer[i * 2 + 1];
+            masterPeakLeft = fmaxf(masterPeakLeft, leftSample);
+            masterPeakRight = fmaxf(masterPeakRight, rightSample);
 
-                buffer[i * 2] += leftSample * leftGain;      // Left
-                buffer[i * 2 + 1] += rightSample * rightGain; // Right
+            masterRMSLeft += leftSample * leftSample;
+            masterRMSRight += rightSample * rightSample;
+        }
 
-                // Calculate levels for VU meter using mixed samples
-                float mixedSample = (leftSample + rightSample) * 0.5f;
-                float displayLevel = fabsf(mixedSample) * track->GetVolume();
-                peakLevel = fmaxf(peakLevel, displayLevel);
-                rmsSum += displayLevel * displayLevel;
-            }
-        } else {
-            // TEST SIGNAL GENERATION: For tracks without files or live input
-            for (size_t i = 0; i < frameCount; i++) {
-                float sample = _GenerateTestSignal(track, sampleRate);
+        if (convert) {
+            ::VeniceDAW::DSP::SampleConversion::FromFloat(output,
+                static_cast<uint8*>(buffer) + offset * 2 * bytesPerSample, encoding, bigEndian,
+                sliceFrames * 2);
+        }
+    }
 
-                buffer[i * 2] += sample * leftGain;      // Left
-                buffer[i * 2 + 1] += sample * rightGain; // Right
+    // Track levels, once per callback
+    for (size_t trackIndex = 0; trackIndex < audioTracks->size(); trackIndex++) {
+        SimpleTrack* track = (*audioTracks)[trackIndex];
+        if (!track->HasRenderLevels()) continue;
 
-                // Calculate levels for VU meter display
-                float displayLevel = fabsf(sample) * track->GetVolume();
-                peakLevel = fmaxf(peakLevel, displayLevel);
-                rmsSum += displayLevel * displayLevel;
-            }
-        }
-        
-        // Update track levels (smooth decay)
-        float newPeak = peakLevel;
-        float newRMS = sqrtf(rmsSum / frameCount);
+        float newPeak = track->GetRenderPeak();
+        float newRMS = sqrtf(track->GetRenderRMSSum() / frameCount);
 
         float smoothPeak = fmaxf(newPeak, track->GetPeakLevel() * AudioConstants::PEAK_DECAY_FACTOR);
         float smoothRMS = track->GetRMSLevel() * AudioConstants::RMS_SMOOTH_FACTOR + newRMS * (1.0f - AudioConstants::RMS_SMOOTH_FACTOR);
-        
+
         track->UpdateLevels(smoothPeak, smoothRMS);
     }
-    
-    // Calculate master levels from final buffer
-    // Normalize by the gain factor used in audio processing to get visual levels
-    const float displayGain = AudioConstants::DISPLAY_GAIN_COMPENSATION;
-    
-    for (size_t i = 0; i < frameCount; i++) {
-        float leftSample = fabsf(buffer[i * 2]) * displayGain;     // Left channel
-        float rightSample = fabsf(buffer[i * 2 + 1]) * displayGain; // Right channel
-        
-        // Clamp to avoid overly high values
-        leftSample = fminf(leftSample, 2.0f);   // Max 2.0 for 200% display
-        rightSample = fminf(rightSample, 2.0f);
-        
-        masterPeakLeft = fmaxf(masterPeakLeft, leftSample);
-        masterPeakRight = fmaxf(masterPeakRight, rightSample);
-        
-        masterRMSLeft += leftSample * leftSample;
-        masterRMSRight += rightSample * rightSample;
-    }
-    
+
     // Update master levels with smoothing
     masterRMSLeft = sqrtf(masterRMSLeft / frameCount);
     masterRMSRight = sqrtf(masterRMSRight / frameCount);
@@ -574,6 +628,150 @@ void SimpleHaikuEngine::_ProcessAudio(float* buffer, size_t frameCount)
     fMasterRMSRight = fMasterRMSRight * AudioConstants::RMS_SMOOTH_FACTOR + masterRMSRight * (1.0f - AudioConstants::RMS_SMOOTH_FACTOR);
 }
 
+void SimpleHaikuEngine::_RenderTrackEntry(void* cookie, size_t trackIndex)
+{
+    // Runs on the audio callback thread or on a render worker
+    TrackRenderJob* job = static_cast<TrackRenderJob*>(cookie);
+    job->engine->_RenderTrack((*job->tracks)[trackIndex], job->offset, job->frameCount,
+                              job->lastSlice, job->sampleRate);
+}
+
+void SimpleHaikuEngine::_RenderTrack(SimpleTrack* track, size_t offset, size_t frameCount,
+                                     bool lastSlice, float sampleRate)
+{
+    // Only touches the track's own state and render buffer, so tracks can
+    // render concurrently
+    track->SetRenderActive(false);
+    if (offset == 0) {
+        track->ResetRenderLevels();
+    }
+
+    // Solo logic: if any track is solo, only play solo tracks (unless muted)
+    // If no solo, play all non-muted tracks
+    bool shouldPlay = false;
+    if (fSoloTrack >= 0) {
+        // Solo mode: only play if this track is solo AND not muted
+        shouldPlay = track->IsSolo() && !track->IsMuted();
+    } else {
+        // Normal mode: play if not muted
+        shouldPlay = !track->IsMuted();
+    }
+    
+    if (!shouldPlay) return;
+    
+    float volume = track->GetVolume() * fMasterVolume * AudioConstants::FILE_PLAYBACK_GAIN;
+
+    // Use track pan setting (-1 = left, 0 = center, +1 = right)
+    float pan = track->GetPan();
+
+    // Equal-power panning law (constant perceived loudness)
+    // Maps pan [-1,+1] to angle [0, π/2], then applies sin/cos
+    float panAngle = (pan + 1.0f) * 0.5f * M_PI_2;  // M_PI_2 = π/2
+    float leftGain = cosf(panAngle) * volume;        // Left weight
+    float rightGain = sinf(panAngle) * volume;       // Right weight
+    
+    // Process audio based on track type
+    float peakLevel = 0.0f;
+    float rmsSum = 0.0f;
+    float* output = track->GetRenderBuffer();
+
+    bool hasFileAudio = track->HasFile();
+    bool hasLiveInput = track->HasLiveInput();
+    SimpleTrack::MonitoringMode mode = track->GetMonitoringMode();
+
+    // Apply monitoring mode filter
+    bool useFile = hasFileAudio && (mode == SimpleTrack::kMonitorFile || mode == SimpleTrack::kMonitorBoth);
+    bool useInput = hasLiveInput && (mode == SimpleTrack::kMonitorInput || mode == SimpleTrack::kMonitorBoth);
+
+    if (useFile || useInput) {
+        // FILE PLAYBACK AND/OR LIVE INPUT
+        // Clear buffer using memset (faster than std::fill)
+        memset(output, 0, frameCount * 2 * sizeof(float));
+
+        // Read file audio if monitoring mode allows
+        if (useFile) {
+            status_t status = track->ReadFileData(output, frameCount, sampleRate);
+            if (status != B_OK) {
+                // File read failed, buffer remains cleared
+                useFile = false;
+            }
+        }
+
+        // Mix in live input if monitoring mode allows
+        if (useInput) {
+            // Get live input data from track's buffer, from this slice on
+            size_t liveFrames = track->GetLiveInputFrameCount();
+            const float* liveData = track->GetLiveInputData();
+
+            if (liveData && liveFrames > offset) {
+                // Mix live input with file audio (or use alone if no file)
+                liveData += offset * 2;
+                liveFrames -= offset;
+                size_t framesToMix = (liveFrames < frameCount) ? liveFrames : frameCount;
+
+                for (size_t i = 0; i < framesToMix; i++) {
+                    output[i * 2] += liveData[i * 2];       // Left
+                    output[i * 2 + 1] += liveData[i * 2 + 1]; // Right
+                }
+            }
+        }
+
+        // Always clear live input flag (consumed) after the callback's last
+        // slice, even if mode filtered it out
+        if (hasLiveInput && lastSlice) {
+            track->ClearLiveInput();
+        }
+
+        // Apply pan and volume in place
+        for (size_t i = 0; i < frameCount; i++) {
+            float leftSample = output[i * 2];
+            float rightSample = output[i * 2 + 1];
+
+            output[i * 2] = leftSample * leftGain;      // Left
+            output[i * 2 + 1] = rightSample * rightGain; // Right
+
+            // Calculate levels for VU meter using mixed samples
+            float mixedSample = (leftSample + rightSample) * 0.5f;
+            float displayLevel = fabsf(mixedSample) * track->GetVolume();
+            peakLevel = fmaxf(peakLevel, displayLevel);
+            rmsSum += displayLevel * displayLevel;
+        }
+    } else {
+        // TEST SIGNAL GENERATION: For tracks without files or live input
+        for (size_t i = 0; i < frameCount; i++) {
+            float sample = _GenerateTestSignal(track, sampleRate);
+
+            output[i * 2] = sample * leftGain;      // Left
+            output[i * 2 + 1] = sample * rightGain; // Right
+
+            // Calculate levels for VU meter display
+            float displayLevel = fabsf(sample) * track->GetVolume();
+            peakLevel = fmaxf(peakLevel, displayLevel);
+            rmsSum += displayLevel * displayLevel;
+        }
+    }
+
+    track->SetRenderActive(true);
+
+    // Published by the engine once the whole callback is rendered
+    track->AccumulateRenderLevels(peakLevel, rmsSum);
+}
+
+void SimpleHaikuEngine::SetParallelRenderThreshold(size_t trackCount)
+{
+    fRenderPool->SetParallelThreshold(trackCount);
+}
+
+size_t SimpleHaikuEngine::GetParallelRenderThreshold() const
+{
+    return fRenderPool->GetParallelThreshold();
+}
+
+size_t SimpleHaikuEngine::GetRenderWorkerCount() const
+{
+    return fRenderPool->GetWorkerCount();
+}
+
 void SimpleHaikuEngine::SetTrackSolo(int trackIndex, bool solo)
 {
     if (trackIndex < 0 || (size_t)trackIndex >= fTracks.size()) {
@@ -675,7 +873,7 @@ float SimpleHaikuEngine::_GenerateTestSignal(SimpleTrack* track, float sampleRat
         case SimpleTrack::kSignalWhiteNoise:
         {
             // White noise generator
-            sample = ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f) * AudioConstants::NOISE_SIGNAL_GAIN;
+            sample = track->NextNoiseSample() * AudioConstants::NOISE_SIGNAL_GAIN;
             break;
         }
         
@@ -683,7 +881,7 @@ float SimpleHaikuEngine::_GenerateTestSignal(SimpleTrack* track, float sampleRat
         {
             // Pink noise generator (1/f spectrum)
             // Using the Voss-McCartney algorithm
-            float white = ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f);
+            float white = track->NextNoiseSample();
 
             track->GetPinkNoiseState(0) = 0.99886f * track->GetPinkNoiseState(0) + white * 0.0555179f;
             track->GetPinkNoiseState(1) = 0.99332f * track->GetPinkNoiseState(1) + white * 0.0750759f;
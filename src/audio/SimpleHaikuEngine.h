@@ -11,10 +11,13 @@
 #include <support/String.h>
 #include <vector>
 #include <atomic>
+#include "SampleConversion.h"
 
 // Forward declaration to avoid circular includes
 namespace VeniceDAW {
+    class AudioOutputDriver;
     class RecordingSession;
+    class RenderWorkerPool;
 }
 
 namespace HaikuDAW {
@@ -103,6 +106,34 @@ public:
     float& GetPinkNoiseState(int index) { return fPinkNoiseState[index]; }
     float GetPinkNoiseMax() { return fPinkNoiseMax; }
     void SetPinkNoiseMax(float max) { fPinkNoiseMax = max; }
+
+    // Per-track white noise in [-1, 1] (xorshift32; rand() is shared state
+    // and tracks render on several threads)
+    float NextNoiseSample() {
+        fNoiseState ^= fNoiseState << 13;
+        fNoiseState ^= fNoiseState >> 17;
+        fNoiseState ^= fNoiseState << 5;
+        return (float)(int32)fNoiseState * (1.0f / 2147483648.0f);
+    }
+
+    // Private render target (audio engine): the track's panned, gained
+    // stereo output for the current buffer, summed by the engine in track order
+    static const size_t kRenderBufferFrames = 4096;
+    float* GetRenderBuffer() { return fRenderBuffer; }
+    const float* GetRenderBuffer() const { return fRenderBuffer; }
+    void SetRenderActive(bool active) { fRenderActive = active; }
+    bool IsRenderActive() const { return fRenderActive; }
+
+    // Levels of the callback being rendered, summed over its slices
+    void ResetRenderLevels() { fRenderPeak = 0.0f; fRenderRMSSum = 0.0f; fHasRenderLevels = false; }
+    void AccumulateRenderLevels(float peak, float rmsSum) {
+        fRenderPeak = peak > fRenderPeak ? peak : fRenderPeak;
+        fRenderRMSSum += rmsSum;
+        fHasRenderLevels = true;
+    }
+    bool HasRenderLevels() const { return fHasRenderLevels; }
+    float GetRenderPeak() const { return fRenderPeak; }
+    float GetRenderRMSSum() const { return fRenderRMSSum; }
     
     // Audio file loading and playback
     status_t LoadAudioFile(const char* path);
@@ -120,6 +151,8 @@ public:
     int64 GetPlaybackPosition() const;
     int64 GetFileDuration() const;
     float GetFileSampleRate() const;
+    status_t AddLocateAnchor(int64 frame);    // Keep a locate target decoded
+    void ClearLocateAnchors();
     
     // File data access (for audio engine)
     status_t ReadFileData(float* buffer, int32 frameCount, float sampleRate);
@@ -145,6 +178,7 @@ private:
     float fFrequency;  // Frequency for test signal
     float fPinkNoiseState[7];  // State for pink noise generator
     float fPinkNoiseMax;  // Maximum value for pink noise normalization
+    uint32 fNoiseState;  // White noise generator state
     MonitoringMode fMonitoringMode;  // File/Input/Both monitoring mode
     
     // Audio file streaming (lock-free asynchronous I/O)
@@ -158,6 +192,13 @@ private:
     size_t fLiveInputFrameCount;
     uint32 fLiveInputChannels;
 
+    // Render target, written by whichever render thread picks the track up
+    float fRenderBuffer[kRenderBufferFrames * 2];
+    bool fRenderActive;
+    float fRenderPeak;
+    float fRenderRMSSum;
+    bool fHasRenderLevels;
+
     // Visual organization
     int fColorIndex;  // Index into TrackColors palette
 };
@@ -170,9 +211,21 @@ public:
     status_t Start();
     status_t Stop();
     bool IsRunning() const { return fRunning; }
+
+    // Where the audio callback runs and its output goes: BSoundPlayer by
+    // default, or a null/file driver for headless and benchmark runs.
+    // The engine takes ownership; only while stopped. Without a driver,
+    // Start() picks the one named by VENICEDAW_AUDIO_DRIVER ("null",
+    // "file" writing to VENICEDAW_AUDIO_FILE), else the platform default.
+    status_t SetOutputDriver(::VeniceDAW::AudioOutputDriver* driver);
+    ::VeniceDAW::AudioOutputDriver* GetOutputDriver() const { return fOutputDriver; }
     
     // Playback controls
     void ResetAllTracks();     // Reset playback position of all loaded files
+    void LocateAllTracks(double seconds);
+    // Loop points and markers: locates there start without a gap
+    void AddLocateAnchor(double seconds);
+    void ClearLocateAnchors();
     int64 GetGlobalPlaybackPosition() const;  // Get maximum playback position across all tracks
     void SetMasterVolume(float volume) { fMasterVolume = volume; }
     float GetMasterVolume() const { return fMasterVolume; }
@@ -192,6 +245,12 @@ public:
     void SetTrackSolo(int trackIndex, bool solo);
     int GetSoloTrack() const { return fSoloTrack; }  // -1 if no solo
     bool HasSoloTrack() const { return fSoloTrack >= 0; }
+
+    // Parallel track rendering: below this many tracks everything renders
+    // on the audio callback thread
+    void SetParallelRenderThreshold(size_t trackCount);
+    size_t GetParallelRenderThreshold() const;
+    size_t GetRenderWorkerCount() const;
     
     // Master level monitoring
     float GetMasterPeakLeft() const { return fMasterPeakLeft; }
@@ -226,11 +285,17 @@ public:
 
 private:
     static void _AudioCallback(void* cookie, void* buffer, size_t size, const media_raw_audio_format& format);
-    void _ProcessAudio(float* buffer, size_t frameCount);
+    void _ProcessAudio(void* buffer, size_t frameCount,
+                       ::VeniceDAW::DSP::SampleConversion::Encoding encoding, bool bigEndian);
+    void _ProcessSilent(void* buffer, size_t size, const media_raw_audio_format& format);
+    static void _RenderTrackEntry(void* cookie, size_t trackIndex);
+    void _RenderTrack(SimpleTrack* track, size_t offset, size_t frameCount, bool lastSlice,
+                      float sampleRate);
     float _GenerateTestSignal(SimpleTrack* track, float sampleRate);
     void _SyncAudioTracks();  // Sync UI track list to RT-safe audio track list
     
-    BSoundPlayer* fSoundPlayer;
+    ::VeniceDAW::AudioOutputDriver* fOutputDriver;
+    float fSampleRate;  // Negotiated by the output driver at Start()
     std::vector<SimpleTrack*> fTracks;  // UI thread track list (for modifications)
     std::atomic<std::vector<SimpleTrack*>*> fAudioTracks;  // RT thread track list (atomic pointer swap)
     std::vector<SimpleTrack*> fTrackBuffer1;  // Double-buffer for lock-free updates
@@ -255,9 +320,13 @@ private:
     // Cortex Media Kit nodes
     std::vector<class VeniceAudioInputNode*> fCortexInputNodes;  // One node per track
 
-    // RT-safe buffer pool (pre-allocated to avoid allocations in audio callback)
-    static constexpr size_t MAX_BUFFER_FRAMES = 4096;
-    std::vector<float> fMixBuffer;  // Pre-allocated mix buffer for audio processing
+    // Track rendering: helper threads plus the audio callback thread, each
+    // track into its own SimpleTrack render buffer
+    ::VeniceDAW::RenderWorkerPool* fRenderPool;
+
+    // Mix for output devices that don't take host-order float, converted
+    // to the device format one slice at a time
+    float fConversionBuffer[SimpleTrack::kRenderBufferFrames * 2];
 };
 
 } // namespace HaikuDAW
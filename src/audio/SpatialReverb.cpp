@@ -337,6 +337,47 @@ void SpatialReverb::ProcessStereo(const float* leftIn, const float* rightIn,
     }
 }
 
+void SpatialReverb::ProcessWet(const float* leftIn, const float* rightIn,
+                                float* leftOut, float* rightOut, int frameCount)
+{
+    for (int i = 0; i < frameCount; i++) {
+        float monoInput = (leftIn[i] + rightIn[i]) * 0.5f;
+
+        float combOutL = 0.0f;
+        for (int c = 0; c < NUM_COMBS / 2; c++) {
+            combOutL += fCombL[c].Process(monoInput);
+        }
+
+        float combOutR = 0.0f;
+        for (int c = 0; c < NUM_COMBS / 2; c++) {
+            combOutR += fCombR[c].Process(monoInput);
+        }
+
+        float reverbL = combOutL;
+        for (int a = 0; a < NUM_ALLPASSES / 2; a++) {
+            reverbL = fAllpassL[a].Process(reverbL);
+        }
+
+        float reverbR = combOutR;
+        for (int a = 0; a < NUM_ALLPASSES / 2; a++) {
+            reverbR = fAllpassR[a].Process(reverbR);
+        }
+
+        leftOut[i] += reverbL * SCALING_WET;
+        rightOut[i] += reverbR * SCALING_WET;
+    }
+}
+
+int SpatialReverb::GetTailFrames() const
+{
+    // Each pass through the longest comb scales it by the feedback (damping
+    // only makes it decay faster); 90 dB down, plus the allpass delays
+    float feedback = OFFSET_ROOM + (fRoomSize * SCALING_ROOM);
+    float passes = logf(3.16e-5f) / logf(feedback);
+    float scale = fSampleRate / 44100.0f;
+    return (int)((passes * COMB_TUNING_R4 + ALLPASS_TUNING_R1 + ALLPASS_TUNING_R2) * scale) + 1;
+}
+
 void SpatialReverb::Reset()
 {
     for (int i = 0; i < NUM_COMBS / 2; i++) {
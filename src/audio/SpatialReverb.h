@@ -55,6 +55,14 @@ public:
                        float* leftOut, float* rightOut,
                        int frameCount, float wetAmount);
 
+    // Wet-only processing for send/return buses: adds the reverb of the
+    // (already send-scaled) input to the outputs, with no dry path
+    void ProcessWet(const float* leftIn, const float* rightIn,
+                    float* leftOut, float* rightOut, int frameCount);
+
+    // Frames for the tail to decay by 90 dB after the input stops
+    int GetTailFrames() const;
+
     // State management
     void Reset();  // Clear all delay buffers
 
@@ -0,0 +1,305 @@
+/*
+ * StreamingService.cpp - Shared disk reader pool for streaming playback
+ */
+
+#include "StreamingService.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <system_error>
+
+#ifndef __HAIKU__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace VeniceDAW {
+
+const int32 StreamingService::kDefaultReaderCount;
+const int32 StreamingService::kMaxReaderCount;
+const int64 StreamingService::kMinReadFrames;
+const int64 StreamingService::kCoalesceFrames;
+const int64 StreamingService::kMaxReadFrames;
+constexpr double StreamingService::kUrgentSeconds;
+
+namespace {
+
+// Safety net for a Wake() that raced with a reader going to sleep, and
+// the polling interval for streams that read nothing
+const std::chrono::milliseconds kIdleTimeout(20);
+
+void LowerCurrentThread(int32 index)
+{
+#ifdef __HAIKU__
+    char name[B_OS_NAME_LENGTH];
+    snprintf(name, sizeof(name), "VeniceDAW stream reader %d", (int)index);
+    rename_thread(find_thread(NULL), name);
+    set_thread_priority(find_thread(NULL), B_LOW_PRIORITY);
+#else
+    (void)index;
+    sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+#endif
+}
+
+} // namespace
+
+StreamingService& StreamingService::GetInstance()
+{
+    static StreamingService sInstance;
+    static bool sStarted = (sInstance.Start(), true);
+    (void)sStarted;
+    return sInstance;
+}
+
+StreamingService::StreamingService(int32 readerCount)
+    : fReaderCount(std::max(1, std::min(readerCount, kMaxReaderCount))),
+      fWakeGeneration(0),
+      fStopping(false),
+      fReads(0),
+      fFramesRead(0),
+      fIdleWaits(0)
+{
+}
+
+StreamingService::~StreamingService()
+{
+    Stop();
+
+    for (Registration* registration : fStreams) {
+        delete registration;
+    }
+}
+
+status_t StreamingService::Start()
+{
+    if (!fThreads.empty()) {
+        return B_OK;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        fStopping = false;
+    }
+
+    try {
+        for (int32 i = 0; i < fReaderCount; i++) {
+            fThreads.emplace_back(&StreamingService::_ReaderLoop, this, i);
+        }
+    } catch (const std::system_error& error) {
+        printf("StreamingService: Could not spawn reader %d: %s\n", (int)fThreads.size(),
+               error.what());
+        if (fThreads.empty()) {
+            return B_NO_MEMORY;
+        }
+    }
+
+    printf("StreamingService: %d stream readers started\n", (int)fThreads.size());
+    return B_OK;
+}
+
+void StreamingService::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        fStopping = true;
+    }
+    fCondition.notify_all();
+
+    for (std::thread& thread : fThreads) {
+        thread.join();
+    }
+    fThreads.clear();
+}
+
+status_t StreamingService::Register(StreamClient* client)
+{
+    if (!client) {
+        return B_BAD_VALUE;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        if (_Find(client)) {
+            return B_OK;
+        }
+
+        Registration* registration = new Registration();
+        registration->client = client;
+        registration->busy = false;
+        registration->removed = false;
+        registration->stalled = false;
+        registration->stalledGeneration = 0;
+        registration->reads = 0;
+        registration->framesRead = 0;
+        registration->totalReadTime = 0;
+        registration->maxReadTime = 0;
+        fStreams.push_back(registration);
+    }
+
+    Wake();
+    return B_OK;
+}
+
+void StreamingService::Unregister(StreamClient* client)
+{
+    std::unique_lock<std::mutex> lock(fLock);
+
+    Registration* registration = _Find(client);
+    if (!registration) {
+        return;
+    }
+
+    // No new reads start on it; wait for the one in flight
+    registration->removed = true;
+    fReadDone.wait(lock, [registration]() { return !registration->busy; });
+
+    fStreams.erase(std::find(fStreams.begin(), fStreams.end(), registration));
+    delete registration;
+}
+
+int32 StreamingService::CountStreams() const
+{
+    std::lock_guard<std::mutex> lock(fLock);
+    return (int32)fStreams.size();
+}
+
+void StreamingService::Wake()
+{
+    // No lock: a reader that is just about to wait can miss the
+    // notification, and then finds the new generation after kIdleTimeout
+    fWakeGeneration.fetch_add(1, std::memory_order_release);
+    fCondition.notify_one();
+}
+
+bool StreamingService::GetTelemetry(const StreamClient* client, StreamTelemetry* telemetry) const
+{
+    if (!client || !telemetry) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(fLock);
+    Registration* registration = _Find(client);
+    if (!registration) {
+        return false;
+    }
+
+    telemetry->fillPercent = client->FillPercent();
+    telemetry->bufferedSeconds = client->BufferedSeconds();
+    telemetry->underruns = client->Underruns();
+    telemetry->reads = registration->reads;
+    telemetry->framesRead = registration->framesRead;
+    telemetry->totalReadTime = registration->totalReadTime;
+    telemetry->maxReadTime = registration->maxReadTime;
+    return true;
+}
+
+StreamingService::Stats StreamingService::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(fLock);
+
+    Stats stats;
+    stats.streams = (int32)fStreams.size();
+    stats.readers = (int32)fThreads.size();
+    stats.reads = fReads;
+    stats.framesRead = fFramesRead;
+    stats.idleWaits = fIdleWaits;
+    return stats;
+}
+
+StreamingService::Registration* StreamingService::_Find(const StreamClient* client) const
+{
+    for (Registration* registration : fStreams) {
+        if (registration->client == client) {
+            return registration;
+        }
+    }
+    return nullptr;
+}
+
+StreamingService::Registration* StreamingService::_PickNext(uint32 generation)
+{
+    Registration* best = nullptr;
+    double bestDeadline = 0.0;
+
+    for (Registration* registration : fStreams) {
+        if (registration->busy || registration->removed) {
+            continue;
+        }
+        if (registration->stalled && registration->stalledGeneration == generation) {
+            continue;
+        }
+        registration->stalled = false;
+
+        StreamClient* client = registration->client;
+        double deadline = client->BufferedSeconds();
+        int64 freeFrames = client->FreeFrames();
+
+        // Wait for room for a long read, unless the stream is running dry
+        bool eligible = freeFrames >= kCoalesceFrames
+                        || (deadline < kUrgentSeconds && freeFrames >= kMinReadFrames)
+                        || deadline <= 0.0
+                        || client->HasPendingWork();
+        if (!eligible) {
+            continue;
+        }
+
+        if (!best || deadline < bestDeadline) {
+            best = registration;
+            bestDeadline = deadline;
+        }
+    }
+
+    return best;
+}
+
+void StreamingService::_ReaderLoop(int32 index)
+{
+    LowerCurrentThread(index);
+
+    std::unique_lock<std::mutex> lock(fLock);
+
+    while (!fStopping) {
+        uint32 generation = fWakeGeneration.load(std::memory_order_acquire);
+        Registration* registration = _PickNext(generation);
+
+        if (!registration) {
+            fIdleWaits++;
+            fCondition.wait_for(lock, kIdleTimeout, [this, generation]() {
+                return fStopping || fWakeGeneration.load(std::memory_order_acquire) != generation;
+            });
+            continue;
+        }
+
+        registration->busy = true;
+        StreamClient* client = registration->client;
+        int64 frames = std::min(std::max(client->FreeFrames(), (int64)0), kMaxReadFrames);
+        lock.unlock();
+
+        bigtime_t start = system_time();
+        int64 read = client->ServiceRead(frames);
+        bigtime_t elapsed = system_time() - start;
+
+        lock.lock();
+        registration->busy = false;
+        registration->reads++;
+        registration->framesRead += read;
+        registration->totalReadTime += elapsed;
+        registration->maxReadTime = std::max(registration->maxReadTime, elapsed);
+        fReads++;
+        fFramesRead += read;
+
+        if (read <= 0) {
+            // End of file or an error: leave it alone until someone seeks
+            registration->stalled = true;
+            registration->stalledGeneration = generation;
+        }
+        if (registration->removed) {
+            fReadDone.notify_all();
+        }
+    }
+}
+
+} // namespace VeniceDAW
@@ -0,0 +1,149 @@
+/*
+ * StreamingService.h - Shared disk reader pool for streaming playback
+ *
+ * One small pool of reader threads feeds the ring buffers of every
+ * streaming track, instead of one polling I/O thread per stream. The
+ * readers always serve the stream closest to running dry first (earliest
+ * deadline first) and read in large coalesced chunks, so a big session
+ * costs a couple of threads and few, long reads - what slow disks like.
+ */
+
+#ifndef STREAMING_SERVICE_H
+#define STREAMING_SERVICE_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VeniceDAW {
+
+// A stream the service keeps filled. All methods but ServiceRead() may be
+// called from any thread; ServiceRead() is only ever running on one
+// reader at a time for a given client.
+class StreamClient {
+public:
+    virtual ~StreamClient() {}
+
+    // Audio buffered ahead of the playback position, in seconds: the
+    // time left before this stream underruns. Streams with pending work
+    // that must happen before anything plays (a seek) report 0.
+    virtual double BufferedSeconds() const = 0;
+
+    // Frames that can be read now without overwriting unplayed audio
+    virtual int64 FreeFrames() const = 0;
+
+    // Reads up to maxFrames into the stream's buffer; returns the frames
+    // read, 0 when there is nothing to read (end of file)
+    virtual int64 ServiceRead(int64 maxFrames) = 0;
+
+    // Background reads that do not depend on free space (e.g. decoding
+    // seek anchors): the stream is served even with a full buffer, after
+    // every stream that is closer to running dry
+    virtual bool HasPendingWork() const { return false; }
+
+    // Telemetry
+    virtual int32 FillPercent() const = 0;
+    virtual uint32 Underruns() const = 0;
+};
+
+// Per-stream telemetry: fill state from the client, reads from the service
+struct StreamTelemetry {
+    int32 fillPercent;
+    double bufferedSeconds;
+    uint32 underruns;
+    uint64 reads;
+    uint64 framesRead;
+    bigtime_t totalReadTime;
+    bigtime_t maxReadTime;
+};
+
+class StreamingService {
+public:
+    static const int32 kDefaultReaderCount = 2;
+    static const int32 kMaxReaderCount = 8;
+
+    // Read sizes in frames. Streams are topped up once this much space is
+    // free, earlier only when they are about to run dry, and never with
+    // less than kMinReadFrames.
+    static const int64 kMinReadFrames = 2048;
+    static const int64 kCoalesceFrames = 16384;
+    static const int64 kMaxReadFrames = 65536;
+    static constexpr double kUrgentSeconds = 1.0;
+
+    // Started, with kDefaultReaderCount readers
+    static StreamingService& GetInstance();
+
+    explicit StreamingService(int32 readerCount = kDefaultReaderCount);
+    ~StreamingService();
+
+    // Readers run at low priority, below the audio threads
+    status_t Start();
+    void Stop();
+    bool IsRunning() const { return !fThreads.empty(); }
+    int32 CountReaders() const { return fReaderCount; }
+
+    status_t Register(StreamClient* client);
+    // Returns once no reader is inside the client's ServiceRead() anymore
+    void Unregister(StreamClient* client);
+    int32 CountStreams() const;
+
+    // Asks the readers to look at the streams again, e.g. after a seek or
+    // when a stream drains. Lock-free, callable from the audio thread.
+    void Wake();
+
+    bool GetTelemetry(const StreamClient* client, StreamTelemetry* telemetry) const;
+
+    struct Stats {
+        int32 streams;
+        int32 readers;
+        uint64 reads;
+        uint64 framesRead;
+        uint64 idleWaits;
+    };
+    Stats GetStats() const;
+
+private:
+    struct Registration {
+        StreamClient* client;
+        bool busy;
+        bool removed;
+        uint32 stalledGeneration;   // Read nothing; skip until the next Wake()
+        bool stalled;
+        uint64 reads;
+        uint64 framesRead;
+        bigtime_t totalReadTime;
+        bigtime_t maxReadTime;
+    };
+
+    void _ReaderLoop(int32 index);
+    Registration* _PickNext(uint32 generation);
+    Registration* _Find(const StreamClient* client) const;
+
+    int32 fReaderCount;
+    std::vector<std::thread> fThreads;
+    std::vector<Registration*> fStreams;
+
+    mutable std::mutex fLock;
+    std::condition_variable fCondition;     // Readers wait for work
+    std::condition_variable fReadDone;      // Unregister() waits for a read
+    std::atomic<uint32> fWakeGeneration;
+    bool fStopping;
+
+    uint64 fReads;
+    uint64 fFramesRead;
+    uint64 fIdleWaits;
+
+    StreamingService(const StreamingService&) = delete;
+    StreamingService& operator=(const StreamingService&) = delete;
+};
+
+} // namespace VeniceDAW
+
+#endif // STREAMING_SERVICE_H
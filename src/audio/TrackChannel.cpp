@@ -3,8 +3,10 @@
  */
 
 #include "TrackChannel.h"
-#include "Track3DMix.h"
+#include "3dmix/3DMixFormat.h"
 #include "AudioSampleCache.h"
+#include "CompressedSampleStore.h"
+#include "MappedPCMSource.h"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
@@ -20,6 +22,9 @@ static const float SPEED_OF_SOUND = 343.0f;  // m/s at 20°C
 static const float HEAD_RADIUS = 0.0875f;    // 8.75 cm average human head
 static const float MIN_DISTANCE = 0.5f;      // Minimum distance for attenuation (prevents division by zero)
 
+// Frames resampled from the cache per pass
+static const int RESAMPLE_CHUNK_FRAMES = 256;
+
 TrackChannel::TrackChannel()
     : fTrack(nullptr)
     , fAudioCache(nullptr)
@@ -30,6 +35,9 @@ TrackChannel::TrackChannel()
     , fPan(0.0f)
     , fFilterEnabled(false)
     , fReverbLevel(0.0f)
+    , fReverbBus(nullptr)
+    , fSendBuffer(nullptr)
+    , fPendingSend(false)
     , fCurrentLevel(0.0f)
 {
     fPosition3D[0] = 0.0f;
@@ -41,12 +49,6 @@ TrackChannel::TrackChannel()
     fFilter.SetMode(HaikuDAW::BiquadFilter::LOW_PASS);
     fFilter.SetFrequency(20000.0f);  // Passthrough by default
     fFilter.SetQ(0.707f);
-
-    // Initialize reverb with medium room settings
-    fReverb.SetSampleRate(fSampleRate);
-    fReverb.SetRoomSize(0.7f);
-    fReverb.SetDamping(0.5f);
-    fReverb.SetWidth(1.0f);
 }
 
 TrackChannel::~TrackChannel()
@@ -68,7 +70,6 @@ void TrackChannel::SetSampleRate(float sampleRate)
     if (fSampleRate != sampleRate) {
         fSampleRate = sampleRate;
         fFilter.SetSampleRate(sampleRate);
-        fReverb.SetSampleRate(sampleRate);
     }
 }
 
@@ -124,15 +125,16 @@ void TrackChannel::SetReverbLevel(float level)
 void TrackChannel::Reset()
 {
     fFilter.Reset();
-    fReverb.Reset();
     fCurrentLevel = 0.0f;
 }
 
-void TrackChannel::ProcessAndMix(float* outputBuffer, int frameCount, float currentTime,
+void TrackChannel::ProcessAndMix(float* outputBuffer, int frameCount, double currentTime,
                                    float sampleRate, const float* listenerPos)
 {
+    fPendingSend = false;
+
     // Early exit conditions
-    if (!fTrack || !fAudioCache || !fAudioCache->isValid || fAudioCache->samples.empty()) {
+    if (!fTrack || !fAudioCache || !fAudioCache->isValid || fAudioCache->IsEmpty()) {
         fCurrentLevel = 0.0f;
         return;
     }
@@ -143,10 +145,10 @@ void TrackChannel::ProcessAndMix(float* outputBuffer, int frameCount, float curr
     }
 
     // Calculate track start time
-    float trackStartTime = fTrack->StartPosition() / fAudioCache->sampleRate;
-    float relativeTime = currentTime - trackStartTime;
+    double trackStartTime = fTrack->StartPosition() / (double)fAudioCache->sampleRate;
+    double relativeTime = currentTime - trackStartTime;
 
-    if (relativeTime < 0.0f) {
+    if (relativeTime < 0.0) {
         fCurrentLevel = 0.0f;
         return;  // Track hasn't started yet
     }
@@ -159,105 +161,99 @@ void TrackChannel::ProcessAndMix(float* outputBuffer, int frameCount, float curr
     leftGain *= fVolume;
     rightGain *= fVolume;
 
-    // Calculate sample position in audio file
-    float samplePosition = relativeTime * fAudioCache->sampleRate;
-    int sampleIndex = (int)samplePosition;
+    // Calculate sample position in audio file (double: float cannot step
+    // by fractional frames past 2^24 frames, ~6 minutes at 44.1 kHz)
+    double samplePosition = relativeTime * fAudioCache->sampleRate;
 
     // Handle end of track
-    int totalSamples = fAudioCache->samples.size() / 2;  // Stereo samples
-    if (sampleIndex >= totalSamples) {
+    size_t totalFrames = fAudioCache->GetFrameCount();  // Stereo frames
+    if (samplePosition >= (double)totalFrames) {
         fCurrentLevel = 0.0f;
         return;
     }
 
-    // Temporary buffers for processing and reverb
-    float reverbInputLeft[1024];
-    float reverbInputRight[1024];
-    float reverbOutputLeft[1024];
-    float reverbOutputRight[1024];
+    // Band-limited conversion from the cache rate to the output rate
+    fResampler.SetRates(fAudioCache->sampleRate, sampleRate);
+
+    // Reverb send level from the distance to the listener
+    float sendLevel = 0.0f;
+    if (fReverbBus && fReverbLevel > 0.0f) {
+        float dx = fPosition3D[0] - (listenerPos ? listenerPos[0] : 0.0f);
+        float dy = fPosition3D[1] - (listenerPos ? listenerPos[1] : 0.0f);
+        float dz = fPosition3D[2] - (listenerPos ? listenerPos[2] : 0.0f);
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+        sendLevel = fReverbBus->CalculateWetAmount(distance) * fReverbLevel;
+    }
 
-    int processedFrames = 0;
+    float resampled[RESAMPLE_CHUNK_FRAMES * 2];
     float peakLevel = 0.0f;
 
     // Process audio in chunks
-    for (int frame = 0; frame < frameCount && sampleIndex < totalSamples; frame++) {
-        // Linear interpolation for resampling
-        float frac = samplePosition - (float)sampleIndex;
-        int nextIndex = std::min(sampleIndex + 1, totalSamples - 1);
-
-        // Get stereo samples (cache is interleaved L,R,L,R...)
-        int cacheIdx = sampleIndex * 2;
-        int nextCacheIdx = nextIndex * 2;
-
-        float leftSample = fAudioCache->samples[cacheIdx] * (1.0f - frac) +
-                          fAudioCache->samples[nextCacheIdx] * frac;
-        float rightSample = fAudioCache->samples[cacheIdx + 1] * (1.0f - frac) +
-                           fAudioCache->samples[nextCacheIdx + 1] * frac;
-
-        // Apply EQ filter if enabled
-        if (fFilterEnabled) {
-            leftSample = fFilter.Process(leftSample);
-            rightSample = fFilter.Process(rightSample);
+    for (int chunkStart = 0; chunkStart < frameCount; chunkStart += RESAMPLE_CHUNK_FRAMES) {
+        int chunkFrames = std::min(RESAMPLE_CHUNK_FRAMES, frameCount - chunkStart);
+        double chunkPosition = samplePosition + chunkStart * fResampler.GetRatio();
+
+        // Frames past the end of the cache are not mixed. A compressed cache
+        // is decoded block by block through this channel's own block cache,
+        // a mapped file converted to host int16 on the way in.
+        int validFrames;
+        if (fAudioCache->samples.empty() && fAudioCache->compressed) {
+            const CompressedSampleStore* store = fAudioCache->compressed.get();
+            validFrames = (int)fResampler.RenderFrom(
+                [this, store](int64 frame, int16_t* dest, int64 frames) {
+                    return store->ReadFrames(frame, dest, frames, fBlockCache);
+                },
+                totalFrames, chunkPosition, resampled, chunkFrames);
+        } else if (fAudioCache->samples.empty()) {
+            validFrames = (int)fAudioCache->source->Render(fResampler, chunkPosition,
+                                                           resampled, chunkFrames);
+        } else {
+            validFrames = (int)fResampler.Render(fAudioCache->samples.data(), totalFrames,
+                                                 chunkPosition, resampled, chunkFrames);
         }
 
-        // Store samples for reverb send (pre-gain)
-        if (frame < 1024) {
-            reverbInputLeft[frame] = leftSample;
-            reverbInputRight[frame] = rightSample;
-            processedFrames = frame + 1;
-        }
+        for (int i = 0; i < validFrames; i++) {
+            int frame = chunkStart + i;
+            float leftSample = resampled[i * 2];
+            float rightSample = resampled[i * 2 + 1];
 
-        // Apply stereo gains (includes 3D positioning and pan)
-        float outputLeft = leftSample * leftGain;
-        float outputRight = rightSample * rightGain;
+            // Apply EQ filter if enabled
+            if (fFilterEnabled) {
+                leftSample = fFilter.Process(leftSample);
+                rightSample = fFilter.Process(rightSample);
 
-        // Mix into output buffer (stereo interleaved)
-        int outputIdx = frame * 2;
-        outputBuffer[outputIdx] += outputLeft;
-        outputBuffer[outputIdx + 1] += outputRight;
+                // Keep the post-EQ signal for the reverb send (pre-gain)
+                resampled[i * 2] = leftSample;
+                resampled[i * 2 + 1] = rightSample;
+            }
 
-        // Track peak level for metering
-        float level = std::max(std::abs(outputLeft), std::abs(outputRight));
-        if (level > peakLevel) peakLevel = level;
+            // Apply stereo gains (includes 3D positioning and pan)
+            float outputLeft = leftSample * leftGain;
+            float outputRight = rightSample * rightGain;
 
-        // Advance sample position
-        samplePosition += fAudioCache->sampleRate / sampleRate;
-        sampleIndex = (int)samplePosition;
-    }
+            // Mix into output buffer (stereo interleaved)
+            int outputIdx = frame * 2;
+            outputBuffer[outputIdx] += outputLeft;
+            outputBuffer[outputIdx + 1] += outputRight;
 
-    // Process reverb if enabled and we have processed frames
-    if (fReverbLevel > 0.0f && processedFrames > 0) {
-        // Calculate distance from listener to track position
-        float dx = fPosition3D[0] - (listenerPos ? listenerPos[0] : 0.0f);
-        float dy = fPosition3D[1] - (listenerPos ? listenerPos[1] : 0.0f);
-        float dz = fPosition3D[2] - (listenerPos ? listenerPos[2] : 0.0f);
-        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+            // Track peak level for metering
+            float level = std::max(std::abs(outputLeft), std::abs(outputRight));
+            if (level > peakLevel) peakLevel = level;
+        }
 
-        // Calculate distance-based wet amount and scale by reverb level
-        float wetAmount = fReverb.CalculateWetAmount(distance) * fReverbLevel;
-
-        if (wetAmount > 0.0f) {
-            // Clear output buffers
-            memset(reverbOutputLeft, 0, processedFrames * sizeof(float));
-            memset(reverbOutputRight, 0, processedFrames * sizeof(float));
-
-            // Process through reverb
-            fReverb.ProcessStereo(reverbInputLeft, reverbInputRight,
-                                  reverbOutputLeft, reverbOutputRight,
-                                  processedFrames, wetAmount);
-
-            // Mix reverb output into final output buffer
-            for (int i = 0; i < processedFrames; i++) {
-                int outputIdx = i * 2;
-                outputBuffer[outputIdx] += reverbOutputLeft[i];
-                outputBuffer[outputIdx + 1] += reverbOutputRight[i];
-
-                // Update peak level with reverb contribution
-                float level = std::max(std::abs(reverbOutputLeft[i]),
-                                      std::abs(reverbOutputRight[i]));
-                if (level > peakLevel) peakLevel = level;
+        // Send to the shared reverb; the bus mixes the return once for all tracks
+        if (sendLevel > 0.0f && fSendBuffer) {
+            float* send = fSendBuffer + chunkStart * 2;
+            for (int i = 0; i < validFrames * 2; i++) {
+                send[i] += resampled[i] * sendLevel;
             }
+            fPendingSend = fPendingSend || validFrames > 0;
+        } else if (sendLevel > 0.0f) {
+            fReverbBus->AddSend(chunkStart, resampled, validFrames, sendLevel);
         }
+
+        if (validFrames < chunkFrames) break;
     }
 
     fCurrentLevel = peakLevel;
@@ -5,7 +5,7 @@
  * - Volume and panning
  * - Biquad filtering (EQ)
  * - Spatial positioning (3D)
- * - Reverb processing
+ * - Reverb send (to a shared ReverbBus)
  * - Mute/Solo state
  */
 
@@ -13,8 +13,9 @@
 #define TRACK_CHANNEL_H
 
 #include "BiquadFilter.h"
-#include "SpatialReverb.h"
-#include <String.h>
+#include "CompressedSampleStore.h"
+#include "PolyphaseResampler.h"
+#include "ReverbBus.h"
 
 namespace VeniceDAW {
 
@@ -29,7 +30,7 @@ struct AudioSampleCache;
  * - Audio sample playback with resampling
  * - EQ (via BiquadFilter)
  * - Spatial audio (3D positioning, ITD)
- * - Reverb send level
+ * - Reverb send level, routed to a shared ReverbBus
  * - Volume/Pan controls
  * - Mute/Solo state
  */
@@ -67,21 +68,35 @@ public:
     void SetPosition3D(float x, float y, float z);
     void GetPosition3D(float* x, float* y, float* z) const;
 
-    // Reverb control
+    // Reverb control. The send is the post-EQ signal scaled by the level
+    // and by the bus's distance curve; the bus (owned by the mixer, shared
+    // between tracks) runs the reverb once per block. nullptr: no reverb.
+    void SetReverbBus(ReverbBus* bus) { fReverbBus = bus; }
+    ReverbBus* GetReverbBus() const { return fReverbBus; }
     void SetReverbLevel(float level);   // 0.0 to 1.0 (send amount)
     float GetReverbLevel() const { return fReverbLevel; }
 
+    // Channels rendered on several threads cannot share AddSend(). With a
+    // send buffer (stereo interleaved, cleared by the caller) the scaled
+    // send accumulates there instead; the caller adds pending sends to the
+    // bus with level 1.0 once every channel of the block has rendered.
+    void SetSendBuffer(float* buffer) { fSendBuffer = buffer; }
+    bool HasPendingSend() const { return fPendingSend; }
+
     // Audio processing
     /**
      * Process audio for this track and mix into output buffer
      *
+     * Adds the reverb send to the track's bus; call ReverbBus::BeginBlock()
+     * before and ReverbBus::ProcessAndMix() after all channels of a block.
+     *
      * @param outputBuffer Stereo interleaved output buffer (L,R,L,R,...)
      * @param frameCount Number of stereo frames to process
      * @param currentTime Current playback time in seconds
      * @param sampleRate Output sample rate
      * @param listenerPos Listener position for 3D audio (x, y, z)
      */
-    void ProcessAndMix(float* outputBuffer, int frameCount, float currentTime,
+    void ProcessAndMix(float* outputBuffer, int frameCount, double currentTime,
                        float sampleRate, const float* listenerPos);
 
     // Level metering (post-processing)
@@ -95,6 +110,8 @@ private:
     Track3DMix* fTrack;
     const AudioSampleCache* fAudioCache;
     float fSampleRate;
+    DSP::PolyphaseResampler fResampler;
+    CompressedSampleStore::BlockCache fBlockCache;  // Decoded blocks of a compressed cache
 
     // Playback state
     bool fMuted;
@@ -109,7 +126,9 @@ private:
     bool fFilterEnabled;
     HaikuDAW::BiquadFilter fFilter;
     float fReverbLevel;
-    SpatialReverb fReverb;
+    ReverbBus* fReverbBus;
+    float* fSendBuffer;
+    bool fPendingSend;
 
     // Level metering
     float fCurrentLevel;
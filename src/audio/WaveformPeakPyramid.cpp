@@ -0,0 +1,200 @@
+/*
+ * WaveformPeakPyramid.cpp - Multi-resolution min/max/RMS peaks for waveforms
+ */
+
+#include "WaveformPeakPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VeniceDAW {
+
+const int32 WaveformPeakPyramid::kBaseFrames;
+
+static const float kInt16ToFloat = 1.0f / 32768.0f;
+
+WaveformPeakPyramid::WaveformPeakPyramid()
+{
+    Clear();
+}
+
+void WaveformPeakPyramid::Clear()
+{
+    fLevels.clear();
+    fPending.min = 0.0f;
+    fPending.max = 0.0f;
+    fPending.sumSquares = 0.0f;
+    fPendingFrames = 0;
+    fFrames = 0;
+    fFinished = false;
+}
+
+void WaveformPeakPyramid::Append(const int16_t* frames, int64 count)
+{
+    while (count > 0) {
+        int64 take = std::min<int64>(count, kBaseFrames - fPendingFrames);
+        Peak peak = _Scan(frames, take);
+        fPending = fPendingFrames > 0 ? _Combine(fPending, peak) : peak;
+        fPendingFrames += (int32)take;
+        fFrames += take;
+        frames += take * 2;
+        count -= take;
+
+        if (fPendingFrames == kBaseFrames) {
+            _Push(0, fPending);
+            fPendingFrames = 0;
+        }
+    }
+}
+
+void WaveformPeakPyramid::Finish()
+{
+    if (fPendingFrames > 0) {
+        _Push(0, fPending);
+        fPendingFrames = 0;
+    }
+
+    // A last bucket without a partner still needs its parent
+    for (size_t level = 0; level < fLevels.size() && fLevels[level].size() > 1; level++) {
+        size_t parents = (fLevels[level].size() + 1) / 2;
+        if (level + 1 >= fLevels.size() || fLevels[level + 1].size() < parents) {
+            Peak last = fLevels[level].back();
+            _Push(level + 1, last);
+        }
+    }
+    for (std::vector<Peak>& level : fLevels) {
+        level.shrink_to_fit();
+    }
+    fFinished = true;
+}
+
+void WaveformPeakPyramid::Rebuild(const int16_t* frames, int64 count)
+{
+    Clear();
+    Append(frames, count);
+    Finish();
+}
+
+void WaveformPeakPyramid::Update(const int16_t* frames, int64 count, int64 firstFrame,
+                                 int64 endFrame)
+{
+    if (!fFinished || count != fFrames || fLevels.empty()) {
+        Rebuild(frames, count);
+        return;
+    }
+
+    int64 first = std::max<int64>(0, firstFrame) / kBaseFrames;
+    int64 end = std::min<int64>((std::min(endFrame, count) + kBaseFrames - 1) / kBaseFrames,
+                                (int64)fLevels[0].size());
+    for (int64 i = first; i < end; i++) {
+        fLevels[0][i] = _Scan(frames + i * kBaseFrames * 2,
+                              std::min<int64>(kBaseFrames, count - i * kBaseFrames));
+    }
+
+    for (size_t level = 1; level < fLevels.size() && first < end; level++) {
+        const std::vector<Peak>& children = fLevels[level - 1];
+        first >>= 1;
+        end = std::min<int64>((end + 1) >> 1, (int64)fLevels[level].size());
+        for (int64 i = first; i < end; i++) {
+            size_t left = (size_t)i * 2;
+            fLevels[level][i] = left + 1 < children.size()
+                ? _Combine(children[left], children[left + 1]) : children[left];
+        }
+    }
+}
+
+size_t WaveformPeakPyramid::GetMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const std::vector<Peak>& level : fLevels) {
+        bytes += level.capacity() * sizeof(Peak);
+    }
+    return bytes;
+}
+
+bool WaveformPeakPyramid::GetPeaks(int64 startFrame, int64 endFrame, float* outMin,
+                                   float* outMax, float* outRMS) const
+{
+    int64 complete = fLevels.empty() ? 0 : (int64)fLevels[0].size();
+    int64 buckets = complete + (fPendingFrames > 0 ? 1 : 0);
+    if (buckets == 0 || startFrame >= fFrames || endFrame <= 0) {
+        return false;
+    }
+
+    int64 b0 = (std::max<int64>(0, startFrame) + kBaseFrames / 2) / kBaseFrames;
+    int64 b1 = endFrame >= fFrames ? buckets : (endFrame + kBaseFrames / 2) / kBaseFrames;
+    b0 = std::min(b0, buckets - 1);
+    b1 = std::min(std::max(b1, b0 + 1), buckets);
+    int64 frames = std::min(b1 * kBaseFrames, fFrames) - b0 * kBaseFrames;
+
+    Peak result;
+    bool found = false;
+    auto take = [&](const Peak& peak) {
+        result = found ? _Combine(result, peak) : peak;
+        found = true;
+    };
+
+    if (b1 > complete) {
+        take(fPending);
+        b1 = complete;
+    }
+
+    // Bottom-up: odd edges are taken at this level, the rest from the
+    // parents
+    for (size_t level = 0; b0 < b1 && level < fLevels.size(); level++) {
+        if (b0 & 1) {
+            take(fLevels[level][b0++]);
+        }
+        if (b1 & 1) {
+            take(fLevels[level][--b1]);
+        }
+        b0 >>= 1;
+        b1 >>= 1;
+    }
+
+    *outMin = result.min;
+    *outMax = result.max;
+    if (outRMS) {
+        *outRMS = frames > 0 ? std::sqrt(result.sumSquares / frames) : 0.0f;
+    }
+    return found;
+}
+
+void WaveformPeakPyramid::_Push(size_t level, const Peak& peak)
+{
+    if (level >= fLevels.size()) {
+        fLevels.resize(level + 1);
+    }
+    std::vector<Peak>& peaks = fLevels[level];
+    peaks.push_back(peak);
+    if (peaks.size() % 2 == 0) {
+        _Push(level + 1, _Combine(peaks[peaks.size() - 2], peaks.back()));
+    }
+}
+
+WaveformPeakPyramid::Peak WaveformPeakPyramid::_Combine(const Peak& a, const Peak& b)
+{
+    Peak peak;
+    peak.min = std::min(a.min, b.min);
+    peak.max = std::max(a.max, b.max);
+    peak.sumSquares = a.sumSquares + b.sumSquares;
+    return peak;
+}
+
+WaveformPeakPyramid::Peak WaveformPeakPyramid::_Scan(const int16_t* frames, int64 count)
+{
+    Peak peak;
+    peak.min = 1.0f;
+    peak.max = -1.0f;
+    peak.sumSquares = 0.0f;
+    for (int64 i = 0; i < count; i++) {
+        // Same mono mix as AudioSampleCache::GetSample()
+        float value = (frames[i * 2] + frames[i * 2 + 1]) * 0.5f * kInt16ToFloat;
+        peak.min = std::min(peak.min, value);
+        peak.max = std::max(peak.max, value);
+        peak.sumSquares += value * value;
+    }
+    return peak;
+}
+
+} // namespace VeniceDAW
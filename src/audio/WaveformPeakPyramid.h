@@ -0,0 +1,84 @@
+/*
+ * WaveformPeakPyramid.h - Multi-resolution min/max/RMS peaks for waveforms
+ *
+ * Level 0 holds the min, max and sum of squares of the mono mix (L+R)/2 of
+ * every kBaseFrames frames; each level above combines pairs of the level
+ * below. A waveform column of any width is answered from O(log n) buckets
+ * instead of rescanning the samples, so drawing costs the same per pixel
+ * at every zoom level and for every file length. About 0.4 bytes per
+ * frame, a tenth of the int16 samples.
+ */
+
+#ifndef WAVEFORM_PEAK_PYRAMID_H
+#define WAVEFORM_PEAK_PYRAMID_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "../testing/HaikuMockHeaders.h"
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VeniceDAW {
+
+/*
+ * Built incrementally with Append() while audio loads (queries already
+ * work on the frames appended so far) and closed with Finish(). Edits
+ * either Update() the frames they touched or Rebuild() everything.
+ * Not thread-safe: whoever appends must also be the one who queries, or
+ * hand the pyramid over once it is finished.
+ */
+class WaveformPeakPyramid {
+public:
+    static const int32 kBaseFrames = 64;    // Frames per level 0 bucket
+
+    struct Peak {
+        float min;
+        float max;
+        float sumSquares;
+    };
+
+    WaveformPeakPyramid();
+
+    void Clear();
+
+    // Interleaved stereo int16 frames, in order
+    void Append(const int16_t* frames, int64 count);
+    void Finish();
+
+    // Clear(), Append() and Finish() in one
+    void Rebuild(const int16_t* frames, int64 count);
+
+    // Recomputes the buckets over [firstFrame, endFrame) after an edit
+    // that kept the length; frames is the whole audio
+    void Update(const int16_t* frames, int64 count, int64 firstFrame, int64 endFrame);
+
+    int64 CountFrames() const { return fFrames; }   // Appended so far
+    bool IsComplete() const { return fFinished; }
+    int32 CountLevels() const { return (int32)fLevels.size(); }
+    size_t GetMemoryUsage() const;
+
+    // Min, max (in -1..1) and RMS of [startFrame, endFrame), with both ends
+    // rounded to the nearest kBaseFrames boundary (or the last frame) and
+    // at least one bucket wide. Returns false if nothing of the range has
+    // been appended yet.
+    bool GetPeaks(int64 startFrame, int64 endFrame, float* outMin, float* outMax,
+                  float* outRMS = nullptr) const;
+
+private:
+    void _Push(size_t level, const Peak& peak);
+    static Peak _Combine(const Peak& a, const Peak& b);
+    static Peak _Scan(const int16_t* frames, int64 count);
+
+    std::vector<std::vector<Peak> > fLevels;
+    Peak fPending;              // Level 0 bucket being appended
+    int32 fPendingFrames;
+    int64 fFrames;
+    bool fFinished;
+};
+
+} // namespace VeniceDAW
+
+#endif // WAVEFORM_PEAK_PYRAMID_H
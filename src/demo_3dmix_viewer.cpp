@@ -17,9 +17,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <String.h>
+#include <algorithm>
 #include <vector>
 #include <map>
+#include <memory>
 #include <atomic>
+#include <mutex>
 #include <Bitmap.h>
 #include <View.h>
 #include <Font.h>
@@ -39,6 +42,11 @@
 #include "audio/3dmix/3DMixParser.h"
 #include "audio/3dmix/AudioPathResolver.h"
 #include "audio/BiquadFilter.h"
+#include "audio/PolyphaseResampler.h"
+#include "audio/AudioLoaderService.h"
+#include "audio/CompressedSampleStore.h"
+#include "audio/MappedPCMSource.h"
+#include "audio/WaveformPeakPyramid.h"
 #include <MediaFile.h>
 #include <SoundPlayer.h>
 #include <MediaDefs.h>
@@ -63,6 +71,9 @@ namespace VeniceDAW {
 // Precomputed reciprocal for int16→float conversion (multiply is faster than divide)
 static const float kInt16ToFloat = 1.0f / 32768.0f;
 
+// Frames resampled per pass in the audio callback
+static const int32 kMixChunkFrames = 256;
+
 struct AudioSource {
     BString name;
     float x, y, z;  // 3D position
@@ -122,55 +133,89 @@ struct FilterInChain {
     }
 };
 
-// Audio sample cache - stores ALL audio samples (loaded once)
+// Audio sample cache - stores ALL audio samples (loaded once), or maps
+// uncompressed files and converts them as they are read
 // BeOS R6 original: stereo int16 interleaved format
 struct AudioSampleCache {
     std::vector<int16_t> samples;    // Stereo int16 samples (L,R,L,R,...)
+    std::shared_ptr<const VeniceDAW::CompressedSampleStore> compressed;  // Decoded file, losslessly compressed
+    std::shared_ptr<const VeniceDAW::MappedPCMSource> source;  // Mapped file, used while samples is empty
+    std::shared_ptr<VeniceDAW::AudioLoadHandle> load;  // Peaks, and progress while loading
     float sampleRate;                // Sample rate (e.g., 44100)
     int channels;                    // Number of channels (always 2)
     bool isValid;
 
+    // Columns at least this wide are answered from peaks
+    static const int64 kPeakQueryFrames = 16 * VeniceDAW::WaveformPeakPyramid::kBaseFrames;
+
     AudioSampleCache() : sampleRate(0.0f), channels(2), isValid(false) {}
 
+    // False while the file is still loading: only peaks, no audio
+    bool HasAudio() const { return compressed || source || !samples.empty(); }
+
+    int64 GetFrameCount() const {
+        if (compressed) return compressed->CountFrames();
+        if (source) return source->CountFrames();
+        if (samples.empty() && load) return load->CountFrames();
+        return (int64)(samples.size() / 2);
+    }
+
+    bool IsEmpty() const { return GetFrameCount() == 0; }
+
     // R6-style GetSample: Calculate min/max ON-THE-FLY for a time range
     // Stereo int16: average L+R channels for waveform display
     void GetSample(float time, float duration, float* outMin, float* outMax) const {
         *outMin = 0.0f;
         *outMax = 0.0f;
 
-        if (!isValid || samples.empty() || time < 0) {
+        if (!isValid || IsEmpty() || time < 0) {
             return;
         }
 
-        // Convert time to frame indices (1 frame = 2 samples for stereo)
-        int startFrame = (int)(time * sampleRate);
-        int numFrames = (int)(duration * sampleRate);
+        int64 totalFrames = GetFrameCount();
+        int64 startFrame = (int64)(time * sampleRate);
+        int64 numFrames = (int64)(duration * sampleRate);
 
         if (numFrames == 0) numFrames = 1;
-
-        int startIdx = startFrame * 2;  // Stereo: 2 samples per frame
-        if (startIdx >= (int)samples.size()) return;
-
-        int endIdx = (startFrame + numFrames) * 2;
-        if (endIdx > (int)samples.size()) {
-            endIdx = samples.size();
+        if (startFrame >= totalFrames) return;
+
+        int64 endFrame = std::min(startFrame + numFrames, totalFrames);
+
+        // Zoomed out, or still loading: O(log n) buckets of the peak
+        // pyramid per column (blank past what has been loaded so far)
+        bool hasAudio = HasAudio();
+        if (load && (!hasAudio || endFrame - startFrame >= kPeakQueryFrames)) {
+            float low, high;
+            if (load->GetPeaks(startFrame, endFrame, &low, &high)) {
+                *outMin = std::min(0.0f, low);
+                *outMax = std::max(0.0f, high);
+                return;
+            }
+            if (!hasAudio) return;
         }
 
         // Adaptive step: examine at least ~256 sample points for accurate min/max
-        int step = 2;  // Default: every frame (2 samples for stereo)
+        int64 step = 1;  // Default: every frame
         if (numFrames > 256) {
-            step = (numFrames / 256) * 2;  // *2 for stereo
-            if (step < 2) step = 2;
+            step = numFrames / 256;
+            if (step < 1) step = 1;
         }
 
         int16_t minVal = 0;
         int16_t maxVal = 0;
 
         // Scan frames, average L+R for mono waveform display
-        for (int i = startIdx; i < endIdx && i + 1 < (int)samples.size(); i += step) {
-            int16_t left = samples[i];
-            int16_t right = samples[i + 1];
-            int16_t avg = (left + right) / 2;
+        for (int64 frame = startFrame; frame < endFrame; frame += step) {
+            int16_t pair[2];
+            if (compressed) {
+                if (compressed->ReadFrames(frame, pair, 1) != 1) break;
+            } else if (source) {
+                if (source->ReadFrames(frame, pair, 1) != 1) break;
+            } else {
+                pair[0] = samples[frame * 2];
+                pair[1] = samples[frame * 2 + 1];
+            }
+            int16_t avg = (pair[0] + pair[1]) / 2;
             if (avg < minVal) minVal = avg;
             if (avg > maxVal) maxVal = avg;
         }
@@ -181,7 +226,8 @@ struct AudioSampleCache {
     }
 };
 
-// Waveform cache - R6 approach: only cache samples, calculate peaks on-the-fly
+// Waveform cache - R6 approach: only cache samples, calculate peaks on-the-fly.
+// Files load on the AudioLoaderService threads; nothing here waits for them.
 class WaveformCache {
 public:
     static WaveformCache& Instance() {
@@ -189,281 +235,110 @@ public:
         return instance;
     }
 
-    // Get audio sample cache (loads once, then returns cached version)
+    // Get audio sample cache without waiting: the loaded file, or while it
+    // is loading a cache with only the peaks loaded so far (null until the
+    // file has been opened, or if it cannot be loaded).
     // Rendering will call GetSample() on the returned cache
-    const AudioSampleCache* GetAudioCache(const char* filePath, const VeniceDAW::AudioFormat3DMix* rawFormat = nullptr) {
-        // Check if already loaded
-        std::string key(filePath);
-        auto it = fSamplesCache.find(key);
-        if (it != fSamplesCache.end()) {
-            return &it->second;  // Already loaded!
-        }
-
-        // Load audio samples ONCE
-        AudioSampleCache samples = LoadAudioSamples(filePath, rawFormat);
-        fSamplesCache[key] = samples;
-        return &fSamplesCache[key];
+    const AudioSampleCache* GetAudioCache(const char* filePath, const VeniceDAW::AudioFormat3DMix* rawFormat = nullptr,
+                                          int32 priority = VeniceDAW::AudioLoaderService::kVisiblePriority) {
+        std::lock_guard<std::mutex> lock(fLock);
+        return Current(Request(filePath, rawFormat, priority));
     }
 
-private:
-    WaveformCache() {}
-
-    // Load ALL audio samples once (zoom-independent!)
-    AudioSampleCache LoadAudioSamples(const char* filePath, const VeniceDAW::AudioFormat3DMix* rawFormat) {
-        AudioSampleCache cache;
-
-        printf("[AudioCache] Loading audio samples: '%s'\n", filePath);
-
-        // Try BMediaFile first
-        entry_ref ref;
-        if (get_ref_for_path(filePath, &ref) == B_OK) {
-            BMediaFile mediaFile(&ref);
-            if (mediaFile.InitCheck() == B_OK) {
-                // Get first audio track
-                BMediaTrack* track = nullptr;
-                for (int32 i = 0; i < mediaFile.CountTracks(); i++) {
-                    BMediaTrack* t = mediaFile.TrackAt(i);
-                    media_format format;
-                    if (t && t->EncodedFormat(&format) == B_OK) {
-                        if (format.type == B_MEDIA_RAW_AUDIO || format.type == B_MEDIA_ENCODED_AUDIO) {
-                            track = t;
-                            break;
-                        }
-                    }
-                    if (t && !track) {
-                        mediaFile.ReleaseTrack(t);
-                    }
-                }
-
-                if (track) {
-                    // Decode to raw audio - BeOS R6 format: stereo int16
-                    media_format format;
-                    format.type = B_MEDIA_RAW_AUDIO;
-                    format.u.raw_audio = media_raw_audio_format::wildcard;
-                    format.u.raw_audio.format = media_raw_audio_format::B_AUDIO_SHORT;
-                    format.u.raw_audio.channel_count = 2;
-
-                    if (track->DecodedFormat(&format) == B_OK) {
-                        int64 frameCount = track->CountFrames();
-                        if (frameCount > 0) {
-                            cache.sampleRate = format.u.raw_audio.frame_rate;
-                            cache.channels = 2;  // Always stereo
-
-                            // Reserve space for stereo samples (2 samples per frame)
-                            cache.samples.reserve(frameCount * 2);
-
-                            // Read samples as stereo int16
-                            const int bufferSize = 8192;
-                            int16_t buffer[bufferSize * 2];
-                            int64 framesRead = 0;
-
-                            while (framesRead < frameCount) {
-                                int64 frames = 0;
-                                if (track->ReadFrames(buffer, &frames) != B_OK || frames == 0) {
-                                    break;
-                                }
-
-                                // Store stereo samples as-is (L,R,L,R,...)
-                                for (int64 i = 0; i < frames * 2; i++) {
-                                    cache.samples.push_back(buffer[i]);
-                                }
-
-                                framesRead += frames;
-                            }
-
-                            mediaFile.ReleaseTrack(track);
-                            cache.isValid = true;
-                            printf("[AudioCache] ✓ Loaded %zu samples (%zu frames) at %.0f Hz\n",
-                                   cache.samples.size(), cache.samples.size() / 2, cache.sampleRate);
-                            return cache;
-                        }
-                    }
-                    mediaFile.ReleaseTrack(track);
-                }
-            }
-        }
-
-        // Try RAW format if BMediaFile failed and we have format info
-        if (!cache.isValid && rawFormat && rawFormat->isRawFormat) {
-            cache = LoadRawAudioSamples(filePath, *rawFormat);
-        }
-
-        return cache;
+    // The load behind GetAudioCache(), for the mixer to hold on to
+    std::shared_ptr<VeniceDAW::AudioLoadHandle> RequestLoad(const char* filePath,
+                                                            const VeniceDAW::AudioFormat3DMix* rawFormat,
+                                                            int32 priority) {
+        std::lock_guard<std::mutex> lock(fLock);
+        return Request(filePath, rawFormat, priority).load;
     }
 
-    AudioSampleCache LoadRawAudioSamples(const char* filePath, const VeniceDAW::AudioFormat3DMix& format) {
-        AudioSampleCache cache;
-
-        printf("[AudioCache] Loading RAW PCM: '%s'\n", filePath);
-        printf("[AudioCache] RAW format from track: bitDepth=%d, channels=%d, sampleRate=%d\n",
-               format.bitDepth, format.channels, format.sampleRate);
-
-        // Initialize sample rate from format if available
-        if (format.sampleRate > 0) {
-            cache.sampleRate = (float)format.sampleRate;
-            printf("[AudioCache] Using sample rate from track format: %.0f Hz\n", cache.sampleRate);
-        }
+    // UI pulse: returns a value that changes whenever there is more
+    // waveform to draw
+    uint32 Poll() {
+        std::lock_guard<std::mutex> lock(fLock);
 
-        BFile file(filePath, B_READ_ONLY);
-        if (file.InitCheck() != B_OK) {
-            return cache;
+        uint32 progress = 0;
+        for (auto& it : fEntries) {
+            const AudioSampleCache* cache = Current(it.second);
+            progress += cache ? 1 : 0;
+            progress += it.second.ready ? 100 : (uint32)(it.second.load->GetProgress() * 50);
         }
+        return progress;
+    }
 
-        off_t fileSize;
-        if (file.GetSize(&fileSize) != B_OK || fileSize == 0) {
-            return cache;
-        }
+private:
+    struct Entry {
+        std::shared_ptr<VeniceDAW::AudioLoadHandle> load;
+        std::unique_ptr<AudioSampleCache> loading;  // Peaks only, once open
+        std::unique_ptr<AudioSampleCache> ready;    // Loaded file
+    };
 
-        // Check for BeOS Track Object header (!TRK marker)
-        off_t headerSkip = 0;
-        char marker[5] = {0};
-        file.Read(marker, 4);
-        if (strcmp(marker, "!TRK") == 0) {
-            // This is a BeOS Track Object file with header - skip to audio data
-            // The header contains: !TRK, track name, SIMPRAW_, filename, etc.
-            // Audio data typically starts around offset 96, but we'll search for it
-
-            // Read more header to find audio start
-            uint8 headerBuf[512];
-            file.Seek(0, SEEK_SET);
-            ssize_t headerRead = file.Read(headerBuf, 512);
-
-            // BeOS Track Object files typically have a 96-byte header
-            // Header structure: !TRK, track name, SIMPRAW_, filename, various metadata
-            // Let's try to find the sample rate in the header
-
-            // Common sample rates to check for
-            float detectedRate = 44100.0f;  // default
-
-            // Scan header for int32 values that match common sample rates
-            int32 commonRates[] = {11025, 22050, 44100, 48000, 88200, 96000};
-            for (int offset = 4; offset < 90; offset += 4) {
-                // Try reading as big-endian int32
-                uint8* ptr = headerBuf + offset;
-                int32 beValue = (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
-
-                // Check if it matches a common sample rate
-                for (int i = 0; i < 6; i++) {
-                    if (beValue == commonRates[i]) {
-                        detectedRate = (float)beValue;
-                        printf("[AudioCache] Found sample rate in header at offset %d: %.0f Hz\n", offset, detectedRate);
-                        goto found_rate;
-                    }
-                }
-            }
-found_rate:
-
-            headerSkip = 96;
-            printf("[AudioCache] Detected BeOS Track Object header, skip=%lld bytes, rate=%.0f Hz\n",
-                   headerSkip, detectedRate);
-
-            file.Seek(headerSkip, SEEK_SET);
-            fileSize -= headerSkip;
-
-            // Verify we're at the right position - read first few bytes to check
-            uint8 verifyBuf[8];
-            ssize_t verified = file.Read(verifyBuf, 8);
-            if (verified == 8) {
-                printf("[AudioCache] First 8 bytes after header: %02x %02x %02x %02x %02x %02x %02x %02x\n",
-                       verifyBuf[0], verifyBuf[1], verifyBuf[2], verifyBuf[3],
-                       verifyBuf[4], verifyBuf[5], verifyBuf[6], verifyBuf[7]);
-                // Seek back to start of audio
-                file.Seek(headerSkip, SEEK_SET);
-            }
+    WaveformCache() {}
 
-            // BeOS Track Object files: header contains 44100 Hz but audio data is at 22050 Hz
-            // This is because the original BeOS mixer played at half speed
-            if (detectedRate > 0) {
-                cache.sampleRate = detectedRate / 2.0f;  // Correct: 44100 → 22050 Hz
-                printf("[AudioCache] Using sample rate from header: %.0f Hz (corrected from %.0f Hz)\n",
-                       cache.sampleRate, detectedRate);
-            }
-        } else {
-            // Pure RAW file, start from beginning
-            file.Seek(0, SEEK_SET);
+    // Called with fLock held. Queues the load once; failures are not
+    // retried on every draw.
+    Entry& Request(const char* filePath, const VeniceDAW::AudioFormat3DMix* rawFormat, int32 priority) {
+        auto it = fEntries.find(filePath);
+        if (it == fEntries.end()) {
+            Entry entry;
+            entry.load = VeniceDAW::AudioLoaderService::GetInstance().Load(filePath, rawFormat, priority);
+            it = fEntries.emplace(filePath, std::move(entry)).first;
+        } else if (priority > it->second.load->GetPriority()) {
+            it->second.load->SetPriority(priority);
         }
+        return it->second;
+    }
 
-        // Calculate total frames
-        int32 bytesPerSample = (format.bitDepth + 7) / 8;
-        int32 bytesPerFrame = bytesPerSample * format.channels;
-        int64 totalFrames = fileSize / bytesPerFrame;
-
-        printf("[AudioCache] RAW calculation: fileSize=%lld, bytesPerFrame=%d, totalFrames=%lld\n",
-               fileSize, bytesPerFrame, totalFrames);
-
-        if (totalFrames <= 0) {
-            return cache;
+    // Called with fLock held. Caches are created once and never change
+    // or go away, so callers may keep using them after unlocking.
+    const AudioSampleCache* Current(Entry& entry) {
+        if (entry.ready) {
+            return entry.ready.get();
         }
 
-        // Use detected sample rate from header if available, otherwise use format or default
-        if (cache.sampleRate == 0) {
-            cache.sampleRate = format.sampleRate > 0 ? format.sampleRate : 44100.0f;
+        const VeniceDAW::AudioLoadHandle& load = *entry.load;
+        if (load.IsReady()) {
+            entry.ready.reset(NewCache(entry.load));
+            entry.ready->compressed = load.GetCompressed();
+            entry.ready->source = load.GetSource();
+            return entry.ready.get();
         }
-        cache.channels = format.channels;
-        cache.samples.reserve(totalFrames);
 
-        // Read ALL samples in large chunks
-        const int chunkFrames = 131072;  // 128K frames per chunk
-        const int chunkSize = chunkFrames * bytesPerFrame;
-        uint8* chunkBuffer = new uint8[chunkSize];
-
-        while (cache.samples.size() < (size_t)totalFrames) {
-            ssize_t bytesRead = file.Read(chunkBuffer, chunkSize);
-            if (bytesRead <= 0) break;
-
-            int framesInChunk = bytesRead / bytesPerFrame;
-
-            for (int i = 0; i < framesInChunk; i++) {
-                uint8* frameData = chunkBuffer + (i * bytesPerFrame);
-
-                // Store stereo int16 samples directly (BeOS R6 format)
-                if (format.bitDepth == 16 && format.channels == 2) {
-                    int16* samples = (int16*)frameData;
-
-                    // BeOS Track Object files are stored in BIG-ENDIAN on Intel!
-                    // The original BeOS code does byte swap on Intel:
-                    //   swap((ushort *)samples, size);  // track_obj.cpp line 1960
-                    // We must do the same!
-
-                    // Swap bytes: convert big-endian to little-endian on x86
-                    uint16_t* rawSamples = (uint16_t*)samples;
-                    int16_t leftSwapped = (int16_t)((rawSamples[0] >> 8) | (rawSamples[0] << 8));
-                    int16_t rightSwapped = (int16_t)((rawSamples[1] >> 8) | (rawSamples[1] << 8));
-
-                    // Debug: log first few values BEFORE and AFTER swap
-                    if (cache.samples.size() < 10) {
-                        printf("[AudioCache] Sample %zu: BEFORE swap=[%d, %d], AFTER swap=[%d, %d]\n",
-                               cache.samples.size() / 2, samples[0], samples[1], leftSwapped, rightSwapped);
-                    }
-
-                    // Store byte-swapped samples
-                    cache.samples.push_back(leftSwapped);   // Left
-                    cache.samples.push_back(rightSwapped);  // Right
-                } else {
-                    // Fallback for non-stereo or non-16bit
-                    printf("[AudioCache] WARNING: Unsupported format (bitDepth=%d, channels=%d)\n",
-                           format.bitDepth, format.channels);
-                }
-            }
+        if (!entry.loading && !load.IsDone() && load.GetSampleRate() > 0.0f) {
+            entry.loading.reset(NewCache(entry.load));
         }
+        return entry.loading.get();
+    }
 
-        delete[] chunkBuffer;
-        cache.isValid = true;
-
-        // Calculate expected duration at different sample rates for debugging
-        float duration44100 = cache.samples.size() / 44100.0f;
-        float duration22050 = cache.samples.size() / 22050.0f;
-
-        printf("[AudioCache] ✓ Loaded %zu RAW samples at %.0f Hz\n",
-               cache.samples.size(), cache.sampleRate);
-        printf("[AudioCache] ⏱️  Duration test: %.2fs @ 44100Hz OR %.2fs @ 22050Hz\n",
-               duration44100, duration22050);
-        printf("[AudioCache] 📝 Use stopwatch: play file and measure real duration!\n");
-
+    static AudioSampleCache* NewCache(const std::shared_ptr<VeniceDAW::AudioLoadHandle>& load) {
+        AudioSampleCache* cache = new AudioSampleCache();
+        cache->load = load;
+        cache->sampleRate = load->GetSampleRate();
+        cache->channels = 2;  // Always stereo
+        cache->isValid = true;
         return cache;
     }
 
-    std::map<std::string, AudioSampleCache> fSamplesCache;  // Samples cached by filePath (loaded once)
+    std::mutex fLock;
+    std::map<std::string, Entry, std::less<> > fEntries;  // Loads by filePath (never removed)
+};
+
+// One project track as the audio thread mixes it, resolved when the
+// project is loaded: the callback only follows pointers, and plays the
+// file once load->IsReady()
+struct MixTrackSource {
+    VeniceDAW::Track3DMix* track;
+    std::shared_ptr<VeniceDAW::AudioLoadHandle> load;  // Null: no audio file found
+    // Decoded blocks of a compressed cache, used by the audio thread only.
+    // One per track, so a big session never evicts another track's blocks.
+    std::shared_ptr<VeniceDAW::CompressedSampleStore::BlockCache> blockCache;
+};
+
+// Immutable once published to the audio thread; replaced as a whole
+struct MixTrackTable {
+    std::vector<MixTrackSource> tracks;  // Project order
+    float duration;                      // Seconds, as GetProjectDuration()
 };
 
 class DemoGL3DView : public BGLView {
@@ -1137,18 +1012,11 @@ public:
         fTrackCount = trackCount;
     }
 
+    // Called from the audio thread
     void SetTrackLevels(const float* levels, int count) {
         // Update audio levels for each track
-        static int debugCount = 0;
         for (int i = 0; i < count && i < (int)fSources.size(); i++) {
             fSources[i].level = levels[i];
-            if (debugCount < 5 && levels[i] > 0.1f) {
-                printf("[VU Debug] Track %d: level=%.3f\n", i, levels[i]);
-            }
-        }
-        if (debugCount < 5) {
-            printf("[VU Debug] Updated %d/%d tracks\n", count, (int)fSources.size());
-            debugCount++;
         }
     }
 
@@ -2249,13 +2117,13 @@ public:
                         audioFormat.sampleRate = fProject.ProjectSampleRate();
                     }
                     const AudioSampleCache* audioCache = WaveformCache::Instance().GetAudioCache(resolvedPath.String(), &audioFormat);
-                    if (audioCache && audioCache->isValid && !audioCache->samples.empty()) {
+                    if (audioCache && audioCache->isValid && !audioCache->IsEmpty()) {
                         sampleRate = audioCache->sampleRate;
 
                         // Only override endTime if it wasn't set from EndPosition
                         if (endSample == 0 || endTime <= startTime) {
                             // Calculate end time from audio file length (stereo samples / 2)
-                            float audioDuration = (audioCache->samples.size() / 2.0f) / audioCache->sampleRate;
+                            float audioDuration = audioCache->GetFrameCount() / audioCache->sampleRate;
                             endTime = startTime + audioDuration;
                         }
                     }
@@ -2612,7 +2480,7 @@ public:
                                         audioFormat.sampleRate = fProject.ProjectSampleRate();
                                     }
                                     const AudioSampleCache* audioCache = WaveformCache::Instance().GetAudioCache(resolvedPath.String(), &audioFormat);
-                                    if (audioCache && audioCache->isValid && !audioCache->samples.empty()) {
+                                    if (audioCache && audioCache->isValid && !audioCache->IsEmpty()) {
                                         // Render waveform for updateBlockRect area
                                         float maxHeight = (laneHeight - 10) / 2.0f;
                                         float centerY = y + laneHeight / 2;
@@ -2755,6 +2623,7 @@ public:
         , fPixelsPerSecond(50.0f)  // Initial zoom
         , fMinPixelsPerSecond(1.0f)  // Will be set by FitToWindow()
         , fPlayheadPosition(0.0f)
+        , fLoadProgress(0)
         , fLoopEnabled(false)
         , fLoopInPoint(0.0f)
         , fLoopOutPoint(0.0f)
@@ -2960,6 +2829,13 @@ public:
         }
         // Always update playhead display, even when paused
         fLanesView->SetPlayheadPosition(fPlayheadPosition);
+
+        // Waveforms fill in while their files load
+        uint32 loadProgress = WaveformCache::Instance().Poll();
+        if (loadProgress != fLoadProgress) {
+            fLoadProgress = loadProgress;
+            fLanesView->Invalidate();
+        }
     }
 
     void ResetPlayhead() {
@@ -3084,6 +2960,7 @@ private:
     float fPixelsPerSecond;
     float fMinPixelsPerSecond;  // Minimum zoom level (set at window creation)
     float fPlayheadPosition;
+    uint32 fLoadProgress;  // WaveformCache::Poll() at the last redraw
 
     // Sync loop region to DemoWindow's audio-thread atomics via BMessage
     void SyncLoopToDemoWindow() {
@@ -3964,6 +3841,7 @@ public:
             delete fSoundPlayer;
             fSoundPlayer = nullptr;
         }
+        PublishMixTable(nullptr);
 
         delete fUpdateRunner;
 
@@ -4279,7 +4157,9 @@ public:
                         fTimelineWindow = nullptr;
                     }
 
-                    // Clean up old project and sound player
+                    // Clean up old project and sound player (the mixer
+                    // lets go of its tracks first)
+                    PublishMixTable(nullptr);
                     if (fProject) {
                         delete fProject;
                         fProject = nullptr;
@@ -4326,7 +4206,8 @@ public:
                             fTimelineWindow = nullptr;  // Will be recreated when user presses T
                         }
 
-                        // Clean up old project
+                        // Clean up old project (the mixer lets go of its tracks first)
+                        PublishMixTable(nullptr);
                         if (fProject) {
                             delete fProject;
                             fProject = nullptr;
@@ -4580,29 +4461,48 @@ public:
     void InitAudioPlayback() {
         if (!fProject) return;
 
-        // Pre-resolve all track paths and pre-cache audio (removes I/O from audio thread)
+        // Pre-resolve all tracks and queue their audio ahead of everything
+        // else (removes I/O, lookups and allocation from the audio thread;
+        // nothing waits)
         float detectedSampleRate = 44100.0f;  // Default fallback
+        bool rateDetected = false;
         int trackCount = fProject->CountTracks();
-        for (int i = 0; i < 64; i++) fResolvedPaths[i] = "";
+        MixTrackTable* table = new MixTrackTable();
+        table->tracks.reserve(trackCount);
 
-        for (int i = 0; i < trackCount && i < 64; i++) {
-            VeniceDAW::Track3DMix* track = fProject->TrackAt(i);
-            if (!track) continue;
-
-            fResolvedPaths[i] = ResolveTrackAudioPath(track);
-            if (fResolvedPaths[i].Length() == 0) continue;
+        for (int i = 0; i < trackCount; i++) {
+            MixTrackSource source;
+            source.track = fProject->TrackAt(i);
+            BString resolvedPath = source.track ? ResolveTrackAudioPath(source.track) : BString();
+            if (resolvedPath.Length() > 0) {
+                // Queue audio and detect sample rate
+                VeniceDAW::AudioFormat3DMix audioFormat = source.track->GetAudioFormat();
+                if (audioFormat.sampleRate == 0 && fProject) {
+                    audioFormat.sampleRate = fProject->ProjectSampleRate();
+                    printf("[InitAudio] Track %d: Using project sample rate: %d Hz\n", i, audioFormat.sampleRate);
+                }
+                source.load = WaveformCache::Instance().RequestLoad(
+                    resolvedPath.String(), &audioFormat, VeniceDAW::AudioLoaderService::kPlayingPriority);
+                source.blockCache = std::make_shared<VeniceDAW::CompressedSampleStore::BlockCache>();
+                if (source.load->GetSampleRate() > 0 && !rateDetected) {
+                    detectedSampleRate = source.load->GetSampleRate();
+                    rateDetected = true;
+                    printf("[3D Audio] Detected sample rate from track %d: %.0f Hz\n", i, detectedSampleRate);
+                }
 
-            // Pre-cache audio and detect sample rate
-            VeniceDAW::AudioFormat3DMix audioFormat = track->GetAudioFormat();
-            if (audioFormat.sampleRate == 0 && fProject) {
-                audioFormat.sampleRate = fProject->ProjectSampleRate();
-                printf("[InitAudio] Track %d: Using project sample rate: %d Hz\n", i, audioFormat.sampleRate);
-            }
-            const AudioSampleCache* audioCache = WaveformCache::Instance().GetAudioCache(fResolvedPaths[i].String(), &audioFormat);
-            if (audioCache && audioCache->isValid && audioCache->sampleRate > 0 && detectedSampleRate == 44100.0f) {
-                detectedSampleRate = audioCache->sampleRate;
-                printf("[3D Audio] Detected sample rate from track %d: %.0f Hz\n", i, detectedSampleRate);
+                if (source.track->LoopEnd() > source.track->LoopStart()) {
+                    printf("[Loop] Track %d: trim=%lld, loop=%lld frames\n", i,
+                           (long long)source.track->LoopStart(), (long long)source.track->LoopEnd());
+                }
             }
+            table->tracks.push_back(source);
+        }
+        table->duration = GetProjectDuration();
+        PublishMixTable(table);
+
+        // No file opened yet: tracks are resampled to the output anyway
+        if (!rateDetected && fProject->ProjectSampleRate() > 0) {
+            detectedSampleRate = fProject->ProjectSampleRate();
         }
 
         // Initialize BSoundPlayer for audio playback
@@ -4724,17 +4624,36 @@ public:
     // Static callback for BSoundPlayer
     static void PlayBufferFunc(void* cookie, void* buffer, size_t size, const media_raw_audio_format& format) {
         DemoWindow* window = (DemoWindow*)cookie;
-        window->MixTracks((float*)buffer, size / sizeof(float) / format.channel_count, format);
+
+        // Pin the published table for this callback: PublishMixTable()
+        // frees a replaced table only once no callback holds it
+        const MixTrackTable* table;
+        do {
+            table = window->fMixTable.load();
+            window->fMixTableInUse.store(table);
+        } while (table != window->fMixTable.load());
+
+        window->MixTracks(table, (float*)buffer, size / sizeof(float) / format.channel_count, format);
+        window->fMixTableInUse.store(nullptr);
+    }
+
+    // Makes table (or nothing, if null) what the audio thread mixes
+    void PublishMixTable(const MixTrackTable* table) {
+        const MixTrackTable* old = fMixTable.exchange(table);
+        while (old && fMixTableInUse.load() == old) {
+            snooze(1000);  // A callback is still mixing it
+        }
+        delete old;
     }
 
     // Mix all tracks with proper sample rate conversion
-    void MixTracks(float* buffer, int32 frameCount, const media_raw_audio_format& format) {
+    void MixTracks(const MixTrackTable* table, float* buffer, int32 frameCount, const media_raw_audio_format& format) {
         // Clear buffer
         memset(buffer, 0, frameCount * format.channel_count * sizeof(float));
 
-        if (!fProject) return;
+        if (!table) return;
 
-        int trackCount = fProject->CountTracks();
+        int trackCount = (int)table->tracks.size();
         if (trackCount == 0) return;
 
         // Calculate current time position using BSoundPlayer's actual sample rate
@@ -4750,6 +4669,10 @@ public:
             }
         }
 
+        // Same position in double for source frame math (float cannot
+        // address individual frames past 2^24 of them)
+        double exactTime = (double)fCurrentFramePosition.load() / format.frame_rate;
+
         // Clear track levels
         memset(fTrackLevels, 0, sizeof(fTrackLevels));
 
@@ -4764,7 +4687,8 @@ public:
 
         // Mix each track
         for (int i = 0; i < trackCount; i++) {
-            VeniceDAW::Track3DMix* track = fProject->TrackAt(i);
+            const MixTrackSource& source = table->tracks[i];
+            VeniceDAW::Track3DMix* track = source.track;
             if (!track) continue;
 
             // Apply mute/solo logic (BeOS 3D Mixer style)
@@ -4776,25 +4700,11 @@ public:
                 if (fAnySoloActive && !fTrackSolo[i]) continue;
             }
 
-            // Use pre-resolved audio path (no filesystem I/O in audio thread)
-            if (i >= 64 || fResolvedPaths[i].Length() == 0) continue;
-            const BString& resolvedPath = fResolvedPaths[i];
-
-            // Get audio cache - use project sample rate if track doesn't have one
-            VeniceDAW::AudioFormat3DMix audioFormat = track->GetAudioFormat();
-            if (audioFormat.sampleRate == 0 && fProject) {
-                audioFormat.sampleRate = fProject->ProjectSampleRate();
-            }
-            const AudioSampleCache* audioCache = WaveformCache::Instance().GetAudioCache(resolvedPath.String(), &audioFormat);
-            if (!audioCache || !audioCache->isValid || audioCache->samples.empty()) continue;
-
-            // Debug: log sample rate info once per track
-            static bool logged[64] = {false};
-            if (!logged[i] && i < 64) {
-                printf("[MixTracks] Track %d: file rate=%.0f Hz, playback rate=%.0f Hz, ratio=%.3f\n",
-                       i, audioCache->sampleRate, format.frame_rate, audioCache->sampleRate / format.frame_rate);
-                logged[i] = true;
-            }
+            // Pre-resolved audio - tracks whose file is still loading stay
+            // silent until it is complete (InitAudioPlayback() queued them)
+            const VeniceDAW::AudioLoadHandle* load = source.load.get();
+            if (!load || !load->IsReady() || load->CountFrames() == 0) continue;
+            float fileRate = load->GetSampleRate();
 
             // Calculate track start time
             // IMPORTANT: StartPosition() is in samples at 22050 Hz reference rate
@@ -4808,19 +4718,10 @@ public:
             // In BeOS format: st_skip is stored in LoopStart, loop_point in LoopEnd
             int64 loopStart = track->LoopStart();    // Trim: where to start in the audio file
             int64 loopEnd = track->LoopEnd();        // Loop point: where to loop back
-            int64 loopLength = loopEnd - loopStart;
-
-            // Debug: log loop info once per track
-            static bool loopLogged[64] = {false};
-            if (!loopLogged[i] && i < 64 && loopLength > 0) {
-                printf("[Loop] Track %d: trim=%.3fs, loop=%.3fs (length=%.3fs)\n",
-                       i, loopStart / audioCache->sampleRate, loopEnd / audioCache->sampleRate,
-                       loopLength / audioCache->sampleRate);
-                loopLogged[i] = true;
-            }
 
-            // Calculate sample rate conversion ratio
-            float sampleRateRatio = audioCache->sampleRate / format.frame_rate;
+            // Band-limited sample rate conversion (shared per file rate)
+            VeniceDAW::DSP::PolyphaseResampler& resampler =
+                ResamplerFor(fileRate, format.frame_rate);
 
             // === 3D SPATIAL AUDIO CALCULATION ===
             // Get track 3D position
@@ -4899,141 +4800,102 @@ public:
             leftGain *= masterVolume * trackVolume * fMasterVolume;
             rightGain *= masterVolume * trackVolume * fMasterVolume;
 
-            // Debug: log spatial parameters periodically
-            static int32 spatialLogTimer = 0;
-            if (i == 0) spatialLogTimer++;
-            if (i == 0 && (spatialLogTimer % 100) == 0) {
-                printf("[3D Spatial] T0: pos(%.1f,%.1f) pan=%.2f dist=%.2f depth=%.2f alpha=%.2f L=%.3f R=%.3f\n",
-                       pos.x, pos.y, pan, distanceGain, depthFactor, spatialAlpha, leftGain, rightGain);
-            }
-
             // Track level calculation (RMS)
             float rmsSum = 0.0f;
             int32 sampleCount = 0;
 
-            // Copy samples from track to output buffer with sample rate conversion and looping
-            // BeOS R6 format: stereo int16 interleaved (L,R,L,R,...)
-            for (int32 frame = 0; frame < frameCount; frame++) {
-                // Calculate source FRAME position (fractional)
-                // Each frame = 2 samples (L+R) in stereo int16 format
-                float srcFramePosition = relativeTime * audioCache->sampleRate + (frame * sampleRateRatio);
-                int64 srcFrame = (int64)srcFramePosition;
-
-                // Apply BeOS-style looping if loop parameters are valid
-                if (loopLength > 0 && loopEnd > loopStart) {
-                    // Add trim offset
-                    srcFrame += loopStart;
-
-                    // Apply modulo looping when we exceed loop end point
-                    if (srcFrame >= loopEnd) {
-                        int64 offsetFromLoopStart = srcFrame - loopStart;
-                        srcFrame = loopStart + (offsetFromLoopStart % loopLength);
-                    }
-                }
-
-                // Convert frame index to sample index (stereo: 2 samples per frame)
-                int64 srcIdx = srcFrame * 2;
-
-                // Safety check: ensure stereo pair is within bounds
-                if (srcIdx < 0 || srcIdx + 1 >= (int64)audioCache->samples.size()) break;
-
-                // Read stereo int16 samples and convert to float (-1.0 to +1.0)
-                float leftSampleFloat = audioCache->samples[srcIdx] * kInt16ToFloat;      // Left channel
-                float rightSampleFloat = audioCache->samples[srcIdx + 1] * kInt16ToFloat;  // Right channel
-
-                // Linear interpolation for smooth sample rate conversion
-                if (srcIdx + 3 < (int64)audioCache->samples.size()) {
-                    float frac = srcFramePosition - (int64)srcFramePosition;
-                    float nextLeftFloat = audioCache->samples[srcIdx + 2] * kInt16ToFloat;
-                    float nextRightFloat = audioCache->samples[srcIdx + 3] * kInt16ToFloat;
-                    leftSampleFloat = leftSampleFloat + frac * (nextLeftFloat - leftSampleFloat);
-                    rightSampleFloat = rightSampleFloat + frac * (nextRightFloat - rightSampleFloat);
+            // Resample the track to the output rate chunk by chunk, with looping.
+            // The ear away from the source hears it ITD frames later.
+            double sourcePosition = (exactTime - trackStartTime) * fileRate;
+            int32 itdDelay = delayLeft > 0 ? delayLeft : delayRight;
+            float resampled[kMixChunkFrames * 2];
+            float delayed[kMixChunkFrames * 2];
+
+            for (int32 chunkStart = 0; chunkStart < frameCount; chunkStart += kMixChunkFrames) {
+                int32 chunkFrames = std::min(kMixChunkFrames, frameCount - chunkStart);
+                double chunkPosition = sourcePosition + chunkStart * resampler.GetRatio();
+
+                int32 validFrames = RenderTrackAudio(resampler, *load, *source.blockCache,
+                                                     chunkPosition, loopStart, loopEnd,
+                                                     resampled, chunkFrames);
+                if (itdDelay > 0 && format.channel_count >= 2) {
+                    RenderTrackAudio(resampler, *load, *source.blockCache, chunkPosition - itdDelay,
+                                     loopStart, loopEnd, delayed, chunkFrames);
                 }
 
-                // Average L+R for RMS calculation
-                float monoSample = (leftSampleFloat + rightSampleFloat) * 0.5f;
-                rmsSum += monoSample * monoSample;
-                sampleCount++;
-
-                // Mix into output with 3D spatial positioning AND ITD delays
-                if (format.channel_count >= 2) {
-                    // === Apply ITD (Interaural Time Difference) ===
-                    // BeOS algorithm from sound_view.cpp lines 4333-4350
-                    // Delayed samples create realistic head-shadow effect
-
-                    // Calculate delayed FRAME indices
-                    // Source left (delayRight>0): right ear is farther, delay right
-                    // Source right (delayLeft>0): left ear is farther, delay left
-                    int64 leftDelayedFrame = srcFrame - delayLeft;    // Left ear delayed by left delay
-                    int64 rightDelayedFrame = srcFrame - delayRight;  // Right ear delayed by right delay
-
-                    // Get left channel sample (with right delay applied)
-                    float finalLeftSample = leftSampleFloat;  // Default to current sample
-                    if (delayRight > 0 && leftDelayedFrame >= 0) {
-                        int64 leftDelayedIdx = leftDelayedFrame * 2;
-                        if (leftDelayedIdx + 1 < (int64)audioCache->samples.size()) {
-                            finalLeftSample = audioCache->samples[leftDelayedIdx] * kInt16ToFloat;
-                        }
-                    }
+                for (int32 n = 0; n < validFrames; n++) {
+                    int32 frame = chunkStart + n;
+
+                    // Stereo float samples (-1.0 to +1.0) at the output rate
+                    float leftSampleFloat = resampled[n * 2];
+                    float rightSampleFloat = resampled[n * 2 + 1];
+
+                    // Average L+R for RMS calculation
+                    float monoSample = (leftSampleFloat + rightSampleFloat) * 0.5f;
+                    rmsSum += monoSample * monoSample;
+                    sampleCount++;
+
+                    // Mix into output with 3D spatial positioning AND ITD delays
+                    if (format.channel_count >= 2) {
+                        // === Apply ITD (Interaural Time Difference) ===
+                        // BeOS algorithm from sound_view.cpp lines 4333-4350
+                        // Source left (delayRight>0): right ear is farther, delay right
+                        // Source right (delayLeft>0): left ear is farther, delay left
+                        float finalLeftSample = delayLeft > 0 ? delayed[n * 2] : leftSampleFloat;
+                        float finalRightSample = delayRight > 0 ? delayed[n * 2 + 1] : rightSampleFloat;
+
+                        // Apply filter chain (multiple filters in cascade) if any filters exist for this track
+                        if (i < 64 && !fTrackFilterChains[i].empty()) {
+                            // Process through all filters in chain sequentially (cascade)
+                            for (size_t filterIdx = 0; filterIdx < fTrackFilterChains[i].size(); filterIdx++) {
+                                FilterInChain& filterInChain = fTrackFilterChains[i][filterIdx];
+
+                                // Initialize filter sample rate on first use
+                                if (filterInChain.filterL.GetSampleRate() != format.frame_rate) {
+                                    filterInChain.filterL.SetSampleRate(format.frame_rate);
+                                    filterInChain.filterR.SetSampleRate(format.frame_rate);
+                                }
 
-                    // Get right channel sample (with left delay applied)
-                    float finalRightSample = rightSampleFloat;  // Default to current sample
-                    if (delayLeft > 0 && rightDelayedFrame >= 0) {
-                        int64 rightDelayedIdx = rightDelayedFrame * 2;
-                        if (rightDelayedIdx + 1 < (int64)audioCache->samples.size()) {
-                            finalRightSample = audioCache->samples[rightDelayedIdx + 1] * kInt16ToFloat;
+                                // Process L/R through independent filter instances (no crosstalk)
+                                finalLeftSample = filterInChain.filterL.Process(finalLeftSample);
+                                finalRightSample = filterInChain.filterR.Process(finalRightSample);
+                            }
                         }
-                    }
-
-                    // Apply filter chain (multiple filters in cascade) if any filters exist for this track
-                    if (i < 64 && !fTrackFilterChains[i].empty()) {
-                        // Process through all filters in chain sequentially (cascade)
-                        for (size_t filterIdx = 0; filterIdx < fTrackFilterChains[i].size(); filterIdx++) {
-                            FilterInChain& filterInChain = fTrackFilterChains[i][filterIdx];
 
+                        // LEGACY: Single filter support (kept for backward compatibility during transition)
+                        // This can be removed once UI fully migrates to filter chains
+                        else if (i < 64 && fFilterEnabled[i]) {
                             // Initialize filter sample rate on first use
-                            if (filterInChain.filterL.GetSampleRate() != format.frame_rate) {
-                                filterInChain.filterL.SetSampleRate(format.frame_rate);
-                                filterInChain.filterR.SetSampleRate(format.frame_rate);
+                            if (fTrackFilters[i].GetSampleRate() != format.frame_rate) {
+                                fTrackFilters[i].SetSampleRate(format.frame_rate);
+                                fTrackFiltersR[i].SetSampleRate(format.frame_rate);
                             }
-
                             // Process L/R through independent filter instances (no crosstalk)
-                            finalLeftSample = filterInChain.filterL.Process(finalLeftSample);
-                            finalRightSample = filterInChain.filterR.Process(finalRightSample);
+                            finalLeftSample = fTrackFilters[i].Process(finalLeftSample);
+                            finalRightSample = fTrackFiltersR[i].Process(finalRightSample);
                         }
-                    }
 
-                    // LEGACY: Single filter support (kept for backward compatibility during transition)
-                    // This can be removed once UI fully migrates to filter chains
-                    else if (i < 64 && fFilterEnabled[i]) {
-                        // Initialize filter sample rate on first use
-                        if (fTrackFilters[i].GetSampleRate() != format.frame_rate) {
-                            fTrackFilters[i].SetSampleRate(format.frame_rate);
-                            fTrackFiltersR[i].SetSampleRate(format.frame_rate);
-                        }
-                        // Process L/R through independent filter instances (no crosstalk)
-                        finalLeftSample = fTrackFilters[i].Process(finalLeftSample);
-                        finalRightSample = fTrackFiltersR[i].Process(finalRightSample);
-                    }
+                        // 3D Spatial mixing: downmix stereo source to mono, then apply spatial panning
+                        float monoSource = (finalLeftSample + finalRightSample) * 0.5f;
 
-                    // 3D Spatial mixing: downmix stereo source to mono, then apply spatial panning
-                    float monoSource = (finalLeftSample + finalRightSample) * 0.5f;
+                        // Apply head shadow low-pass filter for behind-listener sources
+                        // 1-pole IIR: y[n] = y[n-1] + alpha * (x[n] - y[n-1])
+                        // alpha=1.0 = pass-through, alpha→0 = heavy low-pass (muffled)
+                        if (spatialAlpha < 0.99f && i < 64) {
+                            monoSource = fSpatialFilterState[i] + spatialAlpha * (monoSource - fSpatialFilterState[i]);
+                            fSpatialFilterState[i] = monoSource;
+                        }
 
-                    // Apply head shadow low-pass filter for behind-listener sources
-                    // 1-pole IIR: y[n] = y[n-1] + alpha * (x[n] - y[n-1])
-                    // alpha=1.0 = pass-through, alpha→0 = heavy low-pass (muffled)
-                    if (spatialAlpha < 0.99f && i < 64) {
-                        monoSource = fSpatialFilterState[i] + spatialAlpha * (monoSource - fSpatialFilterState[i]);
-                        fSpatialFilterState[i] = monoSource;
+                        buffer[frame * format.channel_count + 0] += monoSource * leftGain;
+                        buffer[frame * format.channel_count + 1] += monoSource * rightGain;
+                    } else {
+                        // Mono output: use average gain (no ITD)
+                        float monoGain = (leftGain + rightGain) * 0.5f;
+                        buffer[frame * format.channel_count + 0] += monoSample * monoGain;
                     }
-
-                    buffer[frame * format.channel_count + 0] += monoSource * leftGain;
-                    buffer[frame * format.channel_count + 1] += monoSource * rightGain;
-                } else {
-                    // Mono output: use average gain (no ITD)
-                    float monoGain = (leftGain + rightGain) * 0.5f;
-                    buffer[frame * format.channel_count + 0] += monoSample * monoGain;
                 }
+
+                if (validFrames < chunkFrames) break;
             }
 
             // Calculate RMS level for this track (0.0 to 1.0)
@@ -5065,14 +4927,6 @@ public:
             float vuScale = trackCount > 0 ? fmin((float)trackCount, 6.0f) : 3.0f;
             fMasterLevelLeft = fmin(leftPeak * vuScale, 1.0f);
             fMasterLevelRight = fmin(rightPeak * vuScale, 1.0f);
-
-            // Debug: log VU meter levels periodically (every ~1 second at 44100 Hz)
-            static int32 vuLogCounter = 0;
-            vuLogCounter++;
-            if (vuLogCounter % (int32)(format.frame_rate) == 0) {
-                printf("[VU Meter] L=%.2f R=%.2f (raw peaks: L=%.3f R=%.3f, scale=%.1fx)\n",
-                       fMasterLevelLeft, fMasterLevelRight, leftPeak, rightPeak, vuScale);
-            }
         }
 
         // Update frame position for next callback
@@ -5080,14 +4934,13 @@ public:
 
         // Auto-loop to start at end of project (prevents infinite silence)
         float endTime = (float)fCurrentFramePosition.load() / format.frame_rate;
-        float projectDuration = GetProjectDuration();
-        if (projectDuration > 0 && endTime > projectDuration + 0.5f) {
+        if (table->duration > 0 && endTime > table->duration + 0.5f) {
             fCurrentFramePosition.store(0);
         }
 
         // Pass track levels to 3D view for visual feedback
         if (fGLView) {
-            fGLView->SetTrackLevels(fTrackLevels, trackCount);
+            fGLView->SetTrackLevels(fTrackLevels, std::min(trackCount, 64));
         }
 
         // NOTE: VU meter and time display updates REMOVED from audio callback
@@ -5095,7 +4948,79 @@ public:
         // These updates should be done from a separate timer thread, not here
     }
 
+    // Converter from a cache rate to the output rate. Rendering keeps no
+    // state between calls, so tracks at the same rate share one; a rate
+    // not seen before takes a free slot (or recycles the last one) and
+    // redesigns its filter in place, without allocating.
+    VeniceDAW::DSP::PolyphaseResampler& ResamplerFor(float sourceRate, float outputRate) {
+        int slot = kMaxResamplerRates - 1;
+        for (int r = 0; r < kMaxResamplerRates; r++) {
+            if (fResamplerRates[r] == sourceRate || fResamplerRates[r] == 0.0f) {
+                slot = r;
+                break;
+            }
+        }
+        fResamplerRates[slot] = sourceRate;
+        fResamplers[slot].SetRates(sourceRate, outputRate);
+        return fResamplers[slot];
+    }
+
+    // Render frames of a track at the output rate from an unlooped source
+    // position (in cache frames), applying the BeOS trim/loop points:
+    // playback starts at loopStart and wraps from loopEnd back to it.
+    // Returns how many frames lie inside the audio; rendering stops at
+    // the end of the cache.
+    int32 RenderTrackAudio(VeniceDAW::DSP::PolyphaseResampler& resampler,
+                           const VeniceDAW::AudioLoadHandle& load,
+                           VeniceDAW::CompressedSampleStore::BlockCache& blockCache, double position,
+                           int64 loopStart, int64 loopEnd, float* output, int32 frames) {
+        size_t sourceFrames = load.CountFrames();
+        const VeniceDAW::CompressedSampleStore* store = load.GetCompressed().get();
+        const VeniceDAW::MappedPCMSource* source = load.GetSource().get();
+        double ratio = resampler.GetRatio();
+        int64 loopLength = loopEnd - loopStart;
+        bool looping = loopLength > 0;
+
+        if (looping) {
+            position += loopStart;
+            if (position >= loopEnd) {
+                position = loopStart + fmod(position - loopStart, (double)loopLength);
+            }
+        }
+
+        int32 done = 0;
+        while (done < frames) {
+            // Never render across the loop point in one run
+            int32 count = frames - done;
+            if (looping) {
+                int32 untilLoop = (int32)ceil((loopEnd - position) / ratio);
+                count = std::min(count, std::max(untilLoop, (int32)1));
+            }
+
+            int32 inside;
+            if (store) {
+                inside = (int32)resampler.RenderFrom(
+                    [store, &blockCache](int64 frame, int16_t* dest, int64 count) {
+                        return store->ReadFrames(frame, dest, count, blockCache);
+                    },
+                    sourceFrames, position, output + done * 2, count);
+            } else {
+                inside = (int32)source->Render(resampler, position, output + done * 2, count);
+            }
+            if (inside < count) return done + inside;
+
+            done += count;
+            position += count * ratio;
+            if (looping && position >= loopEnd) {
+                position = loopStart + fmod(position - loopStart, (double)loopLength);
+            }
+        }
+        return frames;
+    }
+
     virtual bool QuitRequested() override {
+        // Files still loading are not needed any more
+        VeniceDAW::AudioLoaderService::GetInstance().CancelAll();
         be_app->PostMessage(B_QUIT_REQUESTED);
         return true;
     }
@@ -5114,8 +5039,9 @@ private:
     BString fProjectPath;  // Full path to the .3dmix file
     BFilePanel* fOpenPanel;
 
-    // Pre-resolved audio file paths (populated during InitAudioPlayback, used by MixTracks)
-    BString fResolvedPaths[64];
+    // Pre-resolved tracks (built by InitAudioPlayback, mixed by MixTracks)
+    std::atomic<const MixTrackTable*> fMixTable{nullptr};
+    std::atomic<const MixTrackTable*> fMixTableInUse{nullptr};  // Pinned by the audio callback
 
     // Resolve audio file path for a track (searches project directory with multiple extensions)
     BString ResolveTrackAudioPath(VeniceDAW::Track3DMix* track) {
@@ -5192,6 +5118,11 @@ private:
     // Spatial depth filter state per track (1-pole IIR for head shadow effect)
     float fSpatialFilterState[64] = {0};
 
+    // Sample rate converters, one per distinct cache rate (see ResamplerFor)
+    static const int kMaxResamplerRates = 4;
+    VeniceDAW::DSP::PolyphaseResampler fResamplers[kMaxResamplerRates];
+    float fResamplerRates[kMaxResamplerRates] = {0};
+
     // Audio-thread loop region (synced from TimelineWindow)
     std::atomic<bool> fAudioLoopEnabled{false};
     std::atomic<float> fAudioLoopInTime{0.0f};
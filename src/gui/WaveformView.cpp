@@ -5,8 +5,6 @@
 #include "WaveformView.h"
 #include <File.h>
 #include <Path.h>
-#include <MediaFile.h>
-#include <MediaTrack.h>
 #include <stdio.h>
 #include <algorithm>
 #include <cmath>
@@ -22,18 +20,92 @@ WaveformView::WaveformView(BRect frame)
     , fBackgroundColor({30, 30, 30, 255})    // Dark background
     , fWaveformCache(nullptr)
     , fCacheValid(false)
+    , fPeaksFrames(0)
+    , fLoadShown(false)
+    , fLoadRunner(nullptr)
 {
     SetViewColor(B_TRANSPARENT_COLOR);
 }
 
 WaveformView::~WaveformView()
 {
+    StopLoadPolling();
+    if (IsLoading()) {
+        fLoad->Cancel();
+    }
     delete fWaveformCache;
 }
 
 void WaveformView::AttachedToWindow()
 {
     BView::AttachedToWindow();
+
+    // A file may have been loaded before the view had a window
+    if (fLoad && !fLoadShown) {
+        StartLoadPolling();
+    }
+}
+
+void WaveformView::DetachedFromWindow()
+{
+    StopLoadPolling();
+    BView::DetachedFromWindow();
+}
+
+void WaveformView::MessageReceived(BMessage* message)
+{
+    switch (message->what) {
+        case MSG_POLL_LOAD:
+            PollLoad();
+            break;
+
+        default:
+            BView::MessageReceived(message);
+            break;
+    }
+}
+
+void WaveformView::StartLoadPolling()
+{
+    // Own runner rather than Pulse(), which would change the pulse rate
+    // of every view in the window
+    if (fLoadRunner || !Window()) {
+        return;
+    }
+
+    BMessage poll(MSG_POLL_LOAD);
+    fLoadRunner = new BMessageRunner(BMessenger(this), &poll, 50000); // 20 FPS
+}
+
+void WaveformView::StopLoadPolling()
+{
+    delete fLoadRunner;
+    fLoadRunner = nullptr;
+}
+
+void WaveformView::PollLoad()
+{
+    if (!fLoad || fLoadShown) {
+        StopLoadPolling();
+        return;
+    }
+
+    bool done = fLoad->IsDone();
+    if (done || fLoad->CountFramesLoaded() != fPeaksFrames) {
+        // Decoders only estimate the length until they are done
+        if (!HasWaveform() || fLoad->CountFrames() != fPeaks.totalSamples) {
+            GenerateWaveformPeaks();
+        } else {
+            UpdateLoadedPeaks();
+        }
+        fCacheValid = false;
+        Invalidate();
+    }
+
+    fLoadShown = done;
+    if (fLoadShown) {
+        StopLoadPolling();
+    }
 }
 
 void WaveformView::Draw(BRect updateRect)
@@ -47,7 +119,7 @@ void WaveformView::Draw(BRect updateRect)
     if (!HasWaveform()) {
         // No waveform loaded - show placeholder
         SetHighColor(100, 100, 100);
-        BString msg = "No audio loaded";
+        BString msg = IsLoading() ? "Loading audio..." : "No audio loaded";
         float stringWidth = StringWidth(msg.String());
         DrawString(msg.String(),
                    BPoint((bounds.Width() - stringWidth) / 2,
@@ -124,86 +196,48 @@ status_t WaveformView::LoadAudioFile(const entry_ref& ref)
 {
     printf("WaveformView: Loading audio file '%s'\n", ref.name);
 
-    fFilePath.SetTo(ref.name);
+    BPath path(&ref);
+    status_t status = path.InitCheck();
+    if (status != B_OK) {
+        printf("WaveformView: Failed to get path for '%s'\n", ref.name);
+        return status;
+    }
 
-    // Read audio file and generate peaks
-    status_t result = ReadAudioFileData(ref);
-    if (result != B_OK) {
-        printf("WaveformView: Failed to read audio file\n");
-        return result;
+    if (IsLoading()) {
+        fLoad->Cancel();
     }
+    fFilePath.SetTo(ref.name);
+    fPeaks.Clear();
 
-    // Generate peaks for visualization
-    GenerateWaveformPeaks();
+    // Decoded by the loader threads; PollLoad() draws what has arrived
+    fLoad = VeniceDAW::AudioLoaderService::GetInstance().Load(
+        path.Path(), nullptr, VeniceDAW::AudioLoaderService::kVisiblePriority);
+    fPeaksFrames = 0;
+    fLoadShown = false;
+    StartLoadPolling();
 
     fCacheValid = false;
     Invalidate();
-
-    printf("WaveformView: Loaded %d peaks from '%s'\n", fPeaks.peakCount, ref.name);
     return B_OK;
 }
 
-status_t WaveformView::ReadAudioFileData(const entry_ref& ref)
+void WaveformView::GenerateWaveformPeaks()
 {
-    // Use BMediaFile to read audio data
-    BMediaFile mediaFile(&ref);
-    status_t initStatus = mediaFile.InitCheck();
-    if (initStatus != B_OK) {
-        printf("WaveformView: BMediaFile init failed: %s\n", strerror(initStatus));
-        return initStatus;
-    }
-
-    // Find audio track
-    int32 trackCount = mediaFile.CountTracks();
-    BMediaTrack* audioTrack = nullptr;
-
-    for (int32 i = 0; i < trackCount; i++) {
-        BMediaTrack* track = mediaFile.TrackAt(i);
-        if (!track) continue;
-
-        media_format format;
-        status_t status = track->DecodedFormat(&format);
-        if (status == B_OK && format.type == B_MEDIA_RAW_AUDIO) {
-            audioTrack = track;
-
-            // Store audio properties
-            fPeaks.sampleRate = format.u.raw_audio.frame_rate;
-            fPeaks.channels = format.u.raw_audio.channel_count;
-
-            printf("WaveformView: Found audio track - %d channels, %.0f Hz\n",
-                   fPeaks.channels, fPeaks.sampleRate);
-            break;
-        } else {
-            mediaFile.ReleaseTrack(track);
-        }
+    fPeaks.Clear();
+    if (!fLoad || fLoad->GetSampleRate() <= 0.0f) {
+        return;
     }
-
-    if (!audioTrack) {
-        printf("WaveformView: No audio track found\n");
-        return B_ERROR;
+    if (fLoad->GetState() == VeniceDAW::AudioLoadHandle::kFailed) {
+        printf("WaveformView: Failed to read audio file\n");
+        return;
     }
 
-    // Get track duration
-    int64 frameCount = audioTrack->CountFrames();
-    fPeaks.totalSamples = frameCount;
-
-    printf("WaveformView: Audio file has %lld frames\n", frameCount);
-
-    // We'll generate peaks during GenerateWaveformPeaks()
-    // For now, just store the file info
-    mediaFile.ReleaseTrack(audioTrack);
-
-    return B_OK;
-}
-
-void WaveformView::GenerateWaveformPeaks()
-{
-    // Calculate how many peaks we need based on view width
-    int32 viewWidth = (int32)Bounds().Width();
-    if (viewWidth <= 0) viewWidth = 800;  // Default
+    // The loader converts everything to stereo
+    fPeaks.sampleRate = fLoad->GetSampleRate();
+    fPeaks.channels = 2;
+    fPeaks.totalSamples = fLoad->CountFrames();
 
     // Calculate samples per peak based on zoom level
-    float visibleDuration = (fEndFrame - fStartFrame) / fPeaks.sampleRate;
     float samplesPerPixel = fPeaks.sampleRate / fPixelsPerSecond;
 
     fPeaks.samplesPerPeak = (int32)samplesPerPixel;
@@ -213,27 +247,36 @@ void WaveformView::GenerateWaveformPeaks()
     int32 peakCount = (int32)(fPeaks.totalSamples / fPeaks.samplesPerPeak) + 1;
     fPeaks.Allocate(peakCount);
 
-    printf("WaveformView: Generating %d peaks (%d samples per peak)\n",
-           peakCount, fPeaks.samplesPerPeak);
+    fPeaksFrames = 0;
+    UpdateLoadedPeaks();
+}
 
-    // For now, generate simple sine wave preview
-    // In a real implementation, we would read actual audio data
-    for (int32 i = 0; i < fPeaks.peakCount; i++) {
-        // Generate sine wave pattern for demo
-        float t = (float)i / (float)fPeaks.peakCount;
-        float frequency = 440.0f;  // A4 note
-        float phase = t * 2.0f * M_PI * frequency / fPeaks.sampleRate * fPeaks.samplesPerPeak;
+void WaveformView::UpdateLoadedPeaks()
+{
+    // One pyramid query per peak, from the last partly loaded one on
+    int32 first = (int32)(fPeaksFrames / fPeaks.samplesPerPeak);
+    fPeaksFrames = fLoad->CountFramesLoaded();
+    for (int32 i = first; i < fPeaks.peakCount; i++) {
+        int64 start = (int64)i * fPeaks.samplesPerPeak;
+        if (start >= fPeaksFrames) {
+            break;
+        }
 
-        float sineValue = sinf(phase) * 0.8f;
-        fPeaks.minPeaks[i] = sineValue < 0 ? sineValue : 0.0f;
-        fPeaks.maxPeaks[i] = sineValue > 0 ? sineValue : 0.0f;
+        float minValue, maxValue;
+        if (fLoad->GetPeaks(start, start + fPeaks.samplesPerPeak, &minValue, &maxValue)) {
+            fPeaks.minPeaks[i] = std::min(0.0f, minValue);
+            fPeaks.maxPeaks[i] = std::max(0.0f, maxValue);
+        }
     }
-
-    printf("WaveformView: Peak generation complete\n");
 }
 
 void WaveformView::ClearWaveform()
 {
+    StopLoadPolling();
+    if (IsLoading()) {
+        fLoad->Cancel();
+    }
+    fLoad.reset();
     fPeaks.Clear();
     fFilePath = "";
     fCacheValid = false;
@@ -245,7 +288,7 @@ void WaveformView::SetZoom(float pixelsPerSecond)
     fPixelsPerSecond = pixelsPerSecond;
 
     // Regenerate peaks for new zoom level
-    if (HasWaveform()) {
+    if (fLoad) {
         GenerateWaveformPeaks();
     }
 
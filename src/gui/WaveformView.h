@@ -9,9 +9,13 @@
 #include <View.h>
 #include <Bitmap.h>
 #include <Entry.h>
+#include <MessageRunner.h>
 #include <String.h>
+#include <memory>
 #include <vector>
 
+#include "../audio/AudioLoaderService.h"
+
 namespace HaikuDAW {
 
 /*
@@ -73,12 +77,16 @@ public:
 
     virtual void Draw(BRect updateRect) override;
     virtual void AttachedToWindow() override;
+    virtual void DetachedFromWindow() override;
+    virtual void MessageReceived(BMessage* message) override;
 
-    // Waveform data management
+    // Waveform data management. Loading happens in the background; the
+    // waveform fills in as the file is read.
     status_t LoadAudioFile(const entry_ref& ref);
     status_t LoadAudioFile(const char* path);
     void ClearWaveform();
     bool HasWaveform() const { return fPeaks.peakCount > 0; }
+    bool IsLoading() const { return fLoad && !fLoad->IsDone(); }
 
     // Display properties
     void SetZoom(float pixelsPerSecond);
@@ -100,11 +108,13 @@ public:
 
 private:
     void GenerateWaveformPeaks();
+    void UpdateLoadedPeaks();
+    void StartLoadPolling();
+    void StopLoadPolling();
+    void PollLoad();
     void DrawWaveform(BRect bounds);
     void DrawCenterLine(BRect bounds);
 
-    status_t ReadAudioFileData(const entry_ref& ref);
-
     BString fFilePath;
     WaveformPeaks fPeaks;
 
@@ -118,6 +128,16 @@ private:
     // Cached bitmap for performance (optional optimization)
     BBitmap* fWaveformCache;
     bool fCacheValid;
+
+    // Background load
+    std::shared_ptr<VeniceDAW::AudioLoadHandle> fLoad;
+    int64 fPeaksFrames;         // Frames loaded when fPeaks was generated
+    bool fLoadShown;            // Finished load fully drawn
+    BMessageRunner* fLoadRunner;    // Polls the loader while a load is shown
+
+    enum {
+        MSG_POLL_LOAD = 'wvpl'
+    };
 };
 
 } // namespace HaikuDAW
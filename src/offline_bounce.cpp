@@ -0,0 +1,174 @@
+/*
+ * offline_bounce.cpp - VeniceDAW command line mixdown and stem export
+ *
+ * Renders a 3dmix project (Haiku) or a list of audio files (any platform)
+ * through the offline bouncer, faster than realtime on all cores:
+ *
+ *   VeniceDAWBounce -o mix.wav -s stems/ song.3dmix
+ *   VeniceDAWBounce -o mix.wav drums.wav@-1,1,0 bass.raw@1,1,0
+ */
+
+#include "audio/OfflineBouncer.h"
+#include "audio/3dmix/3DMixFormat.h"
+
+#ifdef __HAIKU__
+    #include "audio/3dmix/3DMixParser.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <strings.h>
+
+using namespace VeniceDAW;
+
+static void PrintUsage(const char* program)
+{
+    printf("Usage: %s [options] <project.3dmix | file[@x,y,z] ...>\n\n", program);
+    printf("Options:\n");
+    printf("  -o, --output FILE    Master mix (default: mixdown.wav)\n");
+    printf("  -s, --stems DIR      Also write one stem per track and reverb.wav\n");
+    printf("      --stems-only     Skip the master mix\n");
+    printf("  -r, --rate HZ        Output sample rate (default: project rate)\n");
+    printf("  -j, --jobs N         Render threads (default: one per core)\n");
+    printf("      --send LEVEL     Reverb send of file tracks, 0 to 1 (default: 0)\n");
+    printf("      --no-reverb      Do not render the reverb bus\n");
+    printf("  -h, --help           Show this help\n\n");
+    printf("Audio files are WAV or 16-bit big-endian stereo RAW (3dmix tracks).\n");
+#ifndef __HAIKU__
+    printf("3dmix projects can only be read on Haiku.\n");
+#endif
+}
+
+static bool IsProjectFile(const char* path)
+{
+    const char* dot = strrchr(path, '.');
+    return dot && strcasecmp(dot, ".3dmix") == 0;
+}
+
+// file[@x,y,z]; tracks default to one unit in front of the listener
+static Track3DMix* ParseTrackSpec(const char* spec, float send)
+{
+    std::string path = spec;
+    float x = 0.0f, y = 1.0f, z = 0.0f;
+
+    size_t at = path.rfind('@');
+    if (at != std::string::npos) {
+        if (sscanf(path.c_str() + at + 1, "%f,%f,%f", &x, &y, &z) != 3) {
+            fprintf(stderr, "Bad position in '%s', expected file@x,y,z\n", spec);
+            return nullptr;
+        }
+        path.erase(at);
+    }
+
+    Track3DMix* track = new Track3DMix();
+    track->SetAudioFilePath(path.c_str());
+    const char* leaf = strrchr(path.c_str(), '/');
+    std::string name = leaf ? leaf + 1 : path;
+    name = name.substr(0, name.rfind('.'));
+    track->SetTrackName(name.c_str());
+    track->SetPosition(x, y, z);
+    track->SetReverbLevel(send);
+    return track;
+}
+
+int main(int argc, char** argv)
+{
+    OfflineBouncer::Options options;
+    std::string output = "mixdown.wav";
+    bool stemsOnly = false;
+    float send = 0.0f;
+    std::unique_ptr<Project3DMix> project;
+    std::string baseDirectory;
+    int fileArguments = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) && hasValue) {
+            output = argv[++i];
+        } else if ((strcmp(arg, "-s") == 0 || strcmp(arg, "--stems") == 0) && hasValue) {
+            options.stemDirectory = argv[++i];
+        } else if (strcmp(arg, "--stems-only") == 0) {
+            stemsOnly = true;
+        } else if ((strcmp(arg, "-r") == 0 || strcmp(arg, "--rate") == 0) && hasValue) {
+            options.sampleRate = (float)atof(argv[++i]);
+        } else if ((strcmp(arg, "-j") == 0 || strcmp(arg, "--jobs") == 0) && hasValue) {
+            options.threadCount = atoi(argv[++i]);
+        } else if (strcmp(arg, "--send") == 0 && hasValue) {
+            send = (float)atof(argv[++i]);
+        } else if (strcmp(arg, "--no-reverb") == 0) {
+            options.reverb = false;
+        } else if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (arg[0] == '-') {
+            fprintf(stderr, "Unknown or incomplete option '%s'\n\n", arg);
+            PrintUsage(argv[0]);
+            return 1;
+        } else if (IsProjectFile(arg)) {
+#ifdef __HAIKU__
+            Legacy3DMixLoader loader;
+            if (loader.LoadProject(arg) != B_OK) {
+                fprintf(stderr, "Cannot load '%s': %s\n", arg, loader.GetLastError().String());
+                return 1;
+            }
+            project.reset(loader.DetachProject());
+            const char* slash = strrchr(arg, '/');
+            baseDirectory = slash ? std::string(arg, slash - arg) : ".";
+#else
+            fprintf(stderr, "'%s': 3dmix projects can only be read on Haiku\n", arg);
+            return 1;
+#endif
+            fileArguments++;
+        } else {
+            if (!project) {
+                project.reset(new Project3DMix());
+            }
+            Track3DMix* track = ParseTrackSpec(arg, send);
+            if (!track || !project->AddTrack(track)) {
+                delete track;
+                fprintf(stderr, "Invalid track '%s'\n", arg);
+                return 1;
+            }
+            fileArguments++;
+        }
+    }
+
+    if (!project || fileArguments == 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (stemsOnly && !options.stemDirectory) {
+        fprintf(stderr, "--stems-only needs --stems DIR\n");
+        return 1;
+    }
+    options.masterPath = stemsOnly ? nullptr : output.c_str();
+
+    OfflineBouncer bouncer;
+    if (bouncer.SetProject(project.get(), baseDirectory.empty() ? nullptr : baseDirectory.c_str()) != B_OK) {
+        fprintf(stderr, "No track audio could be loaded\n");
+        return 1;
+    }
+
+    printf("Bouncing %d of %d tracks...\n", (int)bouncer.CountLoadedTracks(),
+           (int)project->CountTracks());
+
+    OfflineBouncer::Stats stats;
+    status_t status = bouncer.Bounce(options, &stats);
+
+    double audioSeconds = stats.framesRendered / (double)stats.sampleRate;
+    printf("Rendered %.2f s of audio at %.0f Hz in %.2f s (%.1fx realtime)\n",
+           audioSeconds, stats.sampleRate, stats.renderSeconds, stats.realtimeFactor);
+    printf("Files written: %u%s%s\n", stats.filesWritten,
+           options.masterPath ? ", master: " : "", options.masterPath ? options.masterPath : "");
+
+    if (status != B_OK) {
+        fprintf(stderr, "Bounce failed (%u write errors)\n", stats.writeErrors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * AdvancedAudioBufferTest.cpp - Contiguous, aligned planar buffer storage
+ *
+ * AdvancedAudioBuffer keeps every channel in one 64-byte-aligned block with
+ * a cache-line padded stride, can share another buffer's storage through
+ * views and can take its storage from an AudioBufferPool. These tests check
+ * the layout for every channel configuration, resizing and copying, that
+ * views process exactly like the frames they cover, that pool-backed
+ * buffers stop allocating once the pool is warm, and time a buffer per
+ * callback against the vector-per-channel layout it replaced.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "../audio/AdvancedAudioProcessor.h"
+
+using namespace VeniceDAW;
+
+static bool IsAligned(const float* data)
+{
+    return reinterpret_cast<uintptr_t>(data) % AdvancedAudioBuffer::kAlignment == 0;
+}
+
+static void Fill(AdvancedAudioBuffer& buffer)
+{
+    for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
+        float* data = buffer.GetChannelData(channel);
+        for (size_t i = 0; i < buffer.frameCount; ++i) {
+            data[i] = static_cast<float>(channel * 100000 + i);
+        }
+    }
+}
+
+static bool HoldsFill(const AdvancedAudioBuffer& buffer, size_t frames)
+{
+    for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
+        const float* data = buffer.GetChannelData(channel);
+        for (size_t i = 0; i < frames; ++i) {
+            if (data[i] != static_cast<float>(channel * 100000 + i)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool IsSilent(const AdvancedAudioBuffer& buffer, size_t from, size_t to)
+{
+    for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
+        const float* data = buffer.GetChannelData(channel);
+        for (size_t i = from; i < to; ++i) {
+            if (data[i] != 0.0f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool TestLayout()
+{
+    std::cout << "\n[TEST] One aligned slab with a padded stride for every layout" << std::endl;
+
+    const ChannelConfiguration configs[] = { kMono, kStereo, kSurround51, kSurround71, kDolbyAtmos };
+    const size_t frameCounts[] = { 1, 64, 441, 512, 1000 };
+
+    int failures = 0;
+    for (ChannelConfiguration config : configs) {
+        for (size_t frames : frameCounts) {
+            AdvancedAudioBuffer buffer(config, frames, 48000.0f);
+            size_t stride = buffer.GetChannelStride();
+            bool ok = buffer.GetChannelCount() == static_cast<size_t>(config)
+                && stride >= frames && stride % AdvancedAudioBuffer::kStrideAlignment == 0
+                && stride < frames + AdvancedAudioBuffer::kStrideAlignment
+                && buffer.GetChannelData(buffer.GetChannelCount()) == nullptr
+                && IsSilent(buffer, 0, frames);
+            for (size_t channel = 0; channel < buffer.GetChannelCount(); ++channel) {
+                ok = ok && IsAligned(buffer.GetChannelData(channel))
+                    && buffer.GetChannelData(channel) == buffer.GetChannelData(0) + channel * stride;
+            }
+            if (!ok) {
+                std::cout << "  Bad layout: " << static_cast<int>(config) << " channels, "
+                          << frames << " frames" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    AdvancedAudioBuffer atmos(kDolbyAtmos, 512, 48000.0f);
+    std::cout << "  16-channel bed of 512 frames: stride " << atmos.GetChannelStride()
+              << ", " << atmos.GetChannelCount() * atmos.GetChannelStride() * sizeof(float) / 1024
+              << " KB in one block" << std::endl;
+
+    bool passed = failures == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestResizeAndCopy()
+{
+    std::cout << "\n[TEST] Resize keeps samples, copies and moves own their storage" << std::endl;
+
+    AdvancedAudioBuffer buffer(kSurround51, 300, 44100.0f);
+    Fill(buffer);
+    const float* before = buffer.GetChannelData(0);
+
+    // Shrinking and growing back within the stride clears the frames in between
+    buffer.Resize(100);
+    buffer.Resize(304);
+    bool inPlace = buffer.GetChannelData(0) == before && HoldsFill(buffer, 100)
+        && IsSilent(buffer, 100, 304);
+
+    // Growing past the stride moves to a larger block
+    buffer.Resize(5000);
+    bool grown = buffer.GetChannelStride() >= 5000 && IsAligned(buffer.GetChannelData(5))
+        && HoldsFill(buffer, 100) && IsSilent(buffer, 100, 5000);
+
+    buffer.Resize(300);
+    Fill(buffer);
+    AdvancedAudioBuffer copy(buffer);
+    copy.GetChannelData(2)[7] = -1.0f;
+    bool copied = HoldsFill(buffer, 300) && copy.GetChannelData(0) != buffer.GetChannelData(0)
+        && copy.GetChannelData(2)[7] == -1.0f && IsAligned(copy.GetChannelData(3));
+
+    const float* storage = buffer.GetChannelData(0);
+    AdvancedAudioBuffer moved(std::move(buffer));
+    AdvancedAudioBuffer assigned(kMono, 16, 44100.0f);
+    assigned = std::move(moved);
+    bool movedOk = assigned.GetChannelData(0) == storage && assigned.GetChannelCount() == 6
+        && HoldsFill(assigned, 300) && moved.frameCount == 0;
+
+    assigned = copy;
+    bool assignedOk = assigned.GetChannelData(0) != copy.GetChannelData(0)
+        && assigned.GetChannelData(2)[7] == -1.0f;
+
+    std::cout << "  In place: " << (inPlace ? "yes" : "no") << ", grown: " << (grown ? "yes" : "no")
+              << ", copy: " << (copied ? "deep" : "shared") << ", move: "
+              << (movedOk && assignedOk ? "ok" : "broken") << std::endl;
+
+    bool passed = inPlace && grown && copied && movedOk && assignedOk;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestViews()
+{
+    std::cout << "\n[TEST] Views share storage and process like the frames they cover" << std::endl;
+
+    AdvancedAudioBuffer buffer(kStereo, 1000, 44100.0f);
+    AdvancedAudioBuffer view = buffer.View(256, 128);
+    view.GetChannelData(1)[3] = 0.5f;
+    bool shared = view.IsView() && buffer.GetChannelData(1)[259] == 0.5f
+        && view.GetChannelStride() == buffer.GetChannelStride() && IsAligned(view.GetChannelData(1));
+
+    AdvancedAudioBuffer tail = buffer.View(900, 500);
+    tail.Resize(2000);
+    bool clamped = tail.frameCount == 100 && buffer.View(2000, 10).frameCount == 0;
+
+    // Equalize a signal as one block, then in blocks of views of another
+    // copy of it; the filters run per sample, so both must match exactly
+    AdvancedAudioBuffer whole(kStereo, 4096, 44100.0f);
+    float* left = whole.GetChannelData(0);
+    float* right = whole.GetChannelData(1);
+    for (size_t i = 0; i < whole.frameCount; ++i) {
+        left[i] = std::sin(0.05f * i);
+        right[i] = 0.3f * std::sin(0.011f * i);
+    }
+    AdvancedAudioBuffer blocks(whole);
+
+    ProfessionalEQ single;
+    ProfessionalEQ chunked;
+    for (ProfessionalEQ* eq : { &single, &chunked }) {
+        eq->Initialize(44100.0f);
+        eq->SetBand(2, 500.0f, 6.0f, 1.5f);
+        eq->SetBandEnabled(2, true);
+        eq->SetBand(6, 8000.0f, -4.0f, 1.0f);
+        eq->SetBandEnabled(6, true);
+    }
+
+    single.ProcessRealtime(whole);
+    const size_t sizes[] = { 64, 333, 1, 1024, 500 };
+    size_t offset = 0;
+    for (size_t i = 0; offset < blocks.frameCount; ++i) {
+        AdvancedAudioBuffer block = blocks.View(offset, sizes[i % 5]);
+        chunked.ProcessRealtime(block);
+        offset += block.frameCount;
+    }
+
+    bool identical = std::memcmp(whole.GetChannelData(0), blocks.GetChannelData(0),
+                                 whole.frameCount * sizeof(float)) == 0
+        && std::memcmp(whole.GetChannelData(1), blocks.GetChannelData(1),
+                       whole.frameCount * sizeof(float)) == 0
+        && whole.GetChannelData(0)[100] != std::sin(0.05f * 100);
+
+    std::cout << "  Shared: " << (shared ? "yes" : "no") << ", clamped: " << (clamped ? "yes" : "no")
+              << ", block-wise EQ " << (identical ? "identical" : "differs") << std::endl;
+
+    bool passed = shared && clamped && identical;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestPoolBacked()
+{
+    std::cout << "\n[TEST] Pool-backed buffers stop allocating once the pool is warm" << std::endl;
+
+    AdvancedAudioProcessor processor;
+    processor.Initialize(48000.0f, 512, kDolbyAtmos);
+
+    AudioBufferPool& pool = AudioBufferPool::GetGlobalPool();
+    uint32 allocationsBefore = pool.GetStats().allocationCount;
+    bool aligned = true;
+    bool pooled = true;
+    for (int callback = 0; callback < 1000; callback++) {
+        AdvancedAudioBuffer buffer(kDolbyAtmos, 512, 48000.0f, pool);
+        pooled = pooled && buffer.IsPoolBacked() && IsSilent(buffer, 0, 512);
+        aligned = aligned && IsAligned(buffer.GetChannelData(15));
+        Fill(buffer);
+        processor.ProcessRealtimeBuffer(buffer);
+    }
+    uint32 allocations = pool.GetStats().allocationCount - allocationsBefore;
+
+    // A pool whose class is exhausted hands out heap storage instead
+    AudioBufferPool small;
+    std::vector<AdvancedAudioBuffer> held;
+    held.reserve(AudioBufferPool::kMaxBuffersPerClass + 1);
+    for (uint32 i = 0; i <= AudioBufferPool::kMaxBuffersPerClass; i++) {
+        held.emplace_back(kStereo, 256, 48000.0f, small);
+    }
+    AdvancedAudioBuffer& overflow = held.back();
+    bool fallback = held.front().IsPoolBacked() && !overflow.IsPoolBacked()
+        && IsAligned(overflow.GetChannelData(1)) && IsSilent(overflow, 0, 256);
+    held.clear();
+    bool returned = small.GetStats().allocatedBuffers == 0;
+
+    std::cout << "  1000 callbacks of 16 x 512 frames: " << allocations << " allocations"
+              << std::endl;
+    std::cout << "  Exhausted pool falls back to the heap: " << (fallback ? "yes" : "no")
+              << ", buffers returned: " << (returned ? "yes" : "no") << std::endl;
+
+    bool passed = pooled && aligned && allocations == 0 && fallback && returned;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestCallbackCost(bool quick)
+{
+    std::cout << "\n[TEST] Buffer per callback: pool-backed slab vs vector per channel" << std::endl;
+
+    const int callbacks = quick ? 20000 : 100000;
+    const size_t frames = 512;
+    AudioBufferPool& pool = AudioBufferPool::GetGlobalPool();
+    pool.Reserve(AdvancedAudioBuffer::StrideFor(frames), kDolbyAtmos, 1);
+
+    // The layout AdvancedAudioBuffer had before
+    float checksum = 0.0f;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < callbacks; i++) {
+        std::vector<std::vector<float>> channels(kDolbyAtmos);
+        for (auto& channel : channels) {
+            channel.resize(frames, 0.0f);
+        }
+        channels[i % kDolbyAtmos][i % frames] = 1.0f;
+        checksum += channels[15][(i * 7) % frames];
+    }
+    auto vectorsDone = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < callbacks; i++) {
+        AdvancedAudioBuffer buffer(kDolbyAtmos, frames, 48000.0f, pool);
+        buffer.GetChannelData(i % kDolbyAtmos)[i % frames] = 1.0f;
+        checksum += buffer.GetChannelData(15)[(i * 7) % frames];
+    }
+    auto poolDone = std::chrono::high_resolution_clock::now();
+
+    double vectorNs = std::chrono::duration<double, std::nano>(vectorsDone - start).count() / callbacks;
+    double poolNs = std::chrono::duration<double, std::nano>(poolDone - vectorsDone).count() / callbacks;
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "  16 x 512 frames: vectors " << vectorNs << " ns, pool slab " << poolNs
+              << " ns per buffer (" << std::setprecision(1) << vectorNs / poolNs << "x)"
+              << (checksum < 0.0f ? " " : "") << std::endl;
+
+    bool passed = poolNs < vectorNs;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║   VeniceDAW Advanced Audio Buffer Tests    ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestLayout()) passed++;
+    total++; if (TestResizeAndCopy()) passed++;
+    total++; if (TestViews()) passed++;
+    total++; if (TestPoolBacked()) passed++;
+    total++; if (TestCallbackCost(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
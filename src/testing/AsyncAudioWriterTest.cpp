@@ -0,0 +1,367 @@
+/*
+ * AsyncAudioWriterTest.cpp - Lock-free ring of the async file writer
+ *
+ * Queues known data through AsyncAudioWriter and reads the WAV files
+ * back: blocking producers lose nothing through a ring much smaller than
+ * the take, a full ring drops whole queue calls and never part of one,
+ * the writer thread sleeps until the high-water mark and then writes
+ * large chunks, and a trickle below the mark still reaches the disk on
+ * the flush timer. Reports the producer's cost per queue call. Recording
+ * writers of AsyncWriterPool write a session's tracks on a couple of
+ * service threads, in large preallocated and synced writes.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <sys/stat.h>
+#include "../audio/AsyncAudioWriter.h"
+
+using namespace VeniceDAW;
+
+static media_format MakeFormat(uint32 format, uint32 channels, float rate = 44100.0f)
+{
+    media_format result;
+    result.type = B_MEDIA_RAW_AUDIO;
+    result.u.raw_audio = media_raw_audio_format::wildcard;
+    result.u.raw_audio.format = format;
+    result.u.raw_audio.channel_count = channels;
+    result.u.raw_audio.frame_rate = rate;
+    result.u.raw_audio.byte_order = B_MEDIA_LITTLE_ENDIAN;
+    return result;
+}
+
+// Bytes unique to their call and position, so a dropped, torn or
+// reordered call shows up in the file
+static void FillCall(std::vector<uint8>& call, uint32 index)
+{
+    for (size_t i = 0; i < call.size(); i++) {
+        call[i] = (uint8)((index * 131 + i * 7 + (i >> 8)) & 0xff);
+    }
+}
+
+static bool ReadWavData(const char* path, std::vector<uint8>& data)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8 header[44];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header)
+              && memcmp(header, "RIFF", 4) == 0 && memcmp(header + 36, "data", 4) == 0;
+    if (ok) {
+        uint32 size = header[40] | header[41] << 8 | header[42] << 16 | (uint32)header[43] << 24;
+        data.resize(size);
+        ok = fread(data.data(), 1, size, file) == size;
+    }
+    fclose(file);
+    return ok;
+}
+
+static bool TestBlockingWritesEverything()
+{
+    std::cout << "\n[TEST] Blocking producer writes every byte through a small ring" << std::endl;
+
+    const char* path = "/tmp/venicedaw_writer_test_blocking.wav";
+    media_format format = MakeFormat(media_raw_audio_format::B_AUDIO_SHORT, 3);
+    const size_t frameBytes = 3 * sizeof(int16);
+
+    AsyncAudioWriter writer;
+    writer.SetBufferDuration(10000);   // The minimum ring: 64 KB
+    writer.SetBlockWhenFull(true);
+    if (writer.StartWriting(path, format) != B_OK) {
+        std::cout << "  Cannot write " << path << std::endl;
+        std::cout << "  Result: FAILED ✗" << std::endl;
+        return false;
+    }
+
+    // 2 MB in calls of 1 to 3000 frames, plus one larger than the ring;
+    // 6-byte frames never line up with the ring's end
+    std::vector<uint8> expected;
+    uint32 seed = 12345;
+    bool allQueued = true;
+    for (uint32 index = 0; expected.size() < 2 * 1024 * 1024; index++) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t frames = index == 100 ? 20000 : 1 + (seed >> 8) % 3000;
+        std::vector<uint8> call(frames * frameBytes);
+        FillCall(call, index);
+        allQueued = allQueued && writer.QueueAudioData(call.data(), call.size(), format) == B_OK;
+        expected.insert(expected.end(), call.begin(), call.end());
+    }
+    status_t status = writer.StopWriting();
+    AsyncAudioWriter::WriterStats stats = writer.GetStats();
+
+    std::vector<uint8> data;
+    bool read = ReadWavData(path, data);
+    bool identical = read && data == expected;
+    remove(path);
+
+    std::cout << "  " << stats.queuedRequests << " calls, " << expected.size() / 1024 << " KB in "
+              << stats.processedRequests << " chunks, " << stats.droppedRequests << " dropped, file "
+              << (identical ? "identical" : "DIFFERENT") << std::endl;
+
+    bool passed = allQueued && status == B_OK && identical && stats.droppedRequests == 0
+                  && stats.totalBytesWritten == expected.size();
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestOverflowDropsWholeCalls()
+{
+    std::cout << "\n[TEST] A full ring drops whole calls, never part of one" << std::endl;
+
+    const char* path = "/tmp/venicedaw_writer_test_overflow.wav";
+    media_format format = MakeFormat(media_raw_audio_format::B_AUDIO_FLOAT, 2);
+    const uint32 kCalls = 400;
+
+    AsyncAudioWriter writer;
+    writer.SetBufferDuration(10000);
+    if (writer.StartWriting(path, format) != B_OK) {
+        std::cout << "  Result: FAILED ✗" << std::endl;
+        return false;
+    }
+
+    // A burst far faster than any disk: 1.6 MB into a 64 KB ring
+    std::vector<uint8> expected;
+    std::vector<uint8> call(512 * 2 * sizeof(float));
+    uint32 accepted = 0;
+    uint32 rejected = 0;
+    for (uint32 index = 0; index < kCalls; index++) {
+        FillCall(call, index);
+        status_t status = writer.QueueAudioData(call.data(), call.size(), format);
+        if (status == B_OK) {
+            accepted++;
+            expected.insert(expected.end(), call.begin(), call.end());
+        } else if (status == B_WOULD_BLOCK) {
+            rejected++;
+        }
+    }
+    writer.StopWriting();
+    AsyncAudioWriter::WriterStats stats = writer.GetStats();
+
+    std::vector<uint8> data;
+    bool identical = ReadWavData(path, data) && data == expected;
+    remove(path);
+
+    std::cout << "  " << accepted << " calls written, " << rejected << " dropped (counted "
+              << stats.droppedRequests << "), file holds exactly the written calls: "
+              << (identical ? "yes" : "NO") << std::endl;
+
+    bool passed = accepted + rejected == kCalls && stats.queuedRequests == accepted
+                  && stats.droppedRequests == rejected && identical;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestLargeChunks(bool quick)
+{
+    std::cout << "\n[TEST] Writer wakes at the high-water mark and writes large chunks" << std::endl;
+
+    const char* path = "/tmp/venicedaw_writer_test_chunks.wav";
+    media_format format = MakeFormat(media_raw_audio_format::B_AUDIO_FLOAT, 2);
+    const uint32 kCalls = quick ? 2000 : 10000;
+    const size_t kFrames = 128;
+
+    // The default ring: 2 seconds, woken every half second of audio
+    AsyncAudioWriter writer;
+    if (writer.StartWriting(path, format) != B_OK) {
+        std::cout << "  Result: FAILED ✗" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8> call(kFrames * 2 * sizeof(float));
+    FillCall(call, 0);
+    double totalNs = 0.0;
+    double worstNs = 0.0;
+    uint32 failures = 0;
+    for (uint32 index = 0; index < kCalls; index++) {
+        auto callStart = std::chrono::high_resolution_clock::now();
+        status_t status = writer.QueueAudioData(call.data(), call.size(), format);
+        auto callEnd = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(callEnd - callStart).count();
+        totalNs += ns;
+        worstNs = std::max(worstNs, ns);
+        if (status != B_OK) {
+            // The disk fell behind: give it a moment like a real callback
+            // period would
+            failures++;
+            snooze(2900);
+        }
+    }
+    writer.StopWriting();
+    AsyncAudioWriter::WriterStats stats = writer.GetStats();
+    remove(path);
+
+    double averageNs = totalNs / kCalls;
+    double callsPerChunk = stats.processedRequests > 0
+        ? (double)stats.queuedRequests / stats.processedRequests : 0.0;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "  " << kCalls << " calls of " << kFrames << " frames: " << averageNs
+              << " ns average, " << worstNs / 1000.0 << " us worst per call" << std::endl;
+    std::cout << "  " << stats.processedRequests << " chunks written, "
+              << std::setprecision(1) << callsPerChunk << " calls each, " << failures
+              << " dropped" << std::endl;
+    std::cout << std::defaultfloat;
+
+    bool passed = stats.queuedRequests + stats.droppedRequests == kCalls && callsPerChunk >= 16.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestTrickleFlush()
+{
+    std::cout << "\n[TEST] A trickle below the high-water mark reaches the disk" << std::endl;
+
+    const char* path = "/tmp/venicedaw_writer_test_trickle.wav";
+    media_format format = MakeFormat(media_raw_audio_format::B_AUDIO_FLOAT, 1);
+
+    AsyncAudioWriter writer;
+    if (writer.StartWriting(path, format) != B_OK) {
+        std::cout << "  Result: FAILED ✗" << std::endl;
+        return false;
+    }
+
+    // Far below a quarter of the 2 second ring
+    std::vector<uint8> call(256 * sizeof(float));
+    FillCall(call, 7);
+    for (int i = 0; i < 4; i++) {
+        writer.QueueAudioData(call.data(), call.size(), format);
+    }
+
+    // Within a few flush intervals, without stopping the writer
+    uint64 written = 0;
+    for (int wait = 0; wait < 50 && written < call.size() * 4; wait++) {
+        snooze(10000);
+        written = writer.GetStats().totalBytesWritten;
+    }
+    writer.StopWriting();
+    remove(path);
+
+    std::cout << "  " << written << "/" << call.size() * 4 << " bytes on disk before stopping" << std::endl;
+
+    bool passed = written == call.size() * 4;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRecordingService(bool quick)
+{
+    std::cout << "\n[TEST] Recording service writes a session's tracks on two threads" << std::endl;
+
+    const uint32 kTracks = quick ? 16 : 24;
+    const uint32 kBlocks = quick ? 200 : 500;   // 128-frame callbacks: 0.6 or 1.5 s
+    const size_t kFrames = 128;
+    media_format format = MakeFormat(media_raw_audio_format::B_AUDIO_FLOAT, 1);
+
+    AsyncWriterPool& pool = AsyncWriterPool::Instance();
+    pool.SetServiceThreadCount(2);
+    pool.SetRecordingPreallocationStep(256 * 1024);
+    pool.SetRecordingSyncPolicy(AsyncAudioWriter::kSyncPeriodic, 100000);
+
+    std::vector<AsyncAudioWriter*> writers;
+    std::vector<std::string> paths;
+    bool started = true;
+    for (uint32 track = 0; track < kTracks && started; track++) {
+        paths.push_back("/tmp/venicedaw_writer_test_track" + std::to_string(track) + ".wav");
+        AsyncAudioWriter* writer = pool.GetRecordingWriter();
+        if (writer) writers.push_back(writer);
+        started = writer && writer->StartWriting(paths.back().c_str(), format) == B_OK;
+    }
+    if (!started) {
+        for (AsyncAudioWriter* writer : writers) pool.ReturnWriter(writer);
+        std::cout << "  Result: FAILED ✗" << std::endl;
+        return false;
+    }
+
+    // One small block per track and callback, paced roughly like live
+    // inputs, so the files grow side by side
+    std::vector<std::vector<uint8>> expected(kTracks);
+    std::vector<uint8> call(kFrames * sizeof(float));
+    uint32 failures = 0;
+    for (uint32 block = 0; block < kBlocks; block++) {
+        for (uint32 track = 0; track < kTracks; track++) {
+            FillCall(call, block * kTracks + track);
+            if (writers[track]->QueueAudioData(call.data(), call.size(), format) == B_OK) {
+                expected[track].insert(expected[track].end(), call.begin(), call.end());
+            } else {
+                failures++;
+            }
+        }
+        if (block % 8 == 7) snooze(20000);
+    }
+    uint32 threads = pool.GetServiceThreads();
+    uint32 served = pool.GetServiceWriters();
+
+    bool stopped = true;
+    uint64 calls = 0;
+    uint64 chunks = 0;
+    uint64 preallocated = 0;
+    uint64 syncs = 0;
+    for (AsyncAudioWriter* writer : writers) {
+        stopped = writer->StopWriting() == B_OK && stopped;
+        AsyncAudioWriter::WriterStats stats = writer->GetStats();
+        calls += stats.queuedRequests;
+        chunks += stats.processedRequests;
+        preallocated += stats.preallocatedBytes;
+        syncs += stats.syncs;
+        pool.ReturnWriter(writer);
+    }
+
+    // Byte-identical, and trimmed back to the data after preallocation
+    uint32 identical = 0;
+    uint32 trimmed = 0;
+    for (uint32 track = 0; track < kTracks; track++) {
+        std::vector<uint8> data;
+        if (ReadWavData(paths[track].c_str(), data) && data == expected[track]) identical++;
+        struct stat info;
+        if (stat(paths[track].c_str(), &info) == 0
+            && (uint64)info.st_size == 44 + expected[track].size()) trimmed++;
+        remove(paths[track].c_str());
+    }
+
+    double callsPerChunk = chunks > 0 ? (double)calls / chunks : 0.0;
+    std::cout << "  " << kTracks << " tracks on " << threads << " service threads, "
+              << identical << " files identical, " << trimmed << " trimmed to their data" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << chunks << " chunks for " << calls << " calls (" << callsPerChunk
+              << " calls each), " << preallocated / 1024 << " KB preallocated, " << syncs
+              << " syncs, " << failures << " dropped" << std::endl;
+    std::cout << std::defaultfloat;
+
+    // The portable writer only preallocates and syncs on Linux
+    bool diskOk = true;
+#if defined(__linux__)
+    diskOk = preallocated > 0 && syncs >= kTracks;
+#endif
+    bool passed = stopped && threads == 2 && served == kTracks && identical == kTracks
+                  && trimmed == kTracks && failures == 0 && callsPerChunk >= 8.0 && diskOk
+                  && pool.GetServiceWriters() == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    VeniceDAW Async Audio Writer Tests      ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestBlockingWritesEverything()) passed++;
+    total++; if (TestOverflowDropsWholeCalls()) passed++;
+    total++; if (TestLargeChunks(quick)) passed++;
+    total++; if (TestTrickleFlush()) passed++;
+    total++; if (TestRecordingService(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
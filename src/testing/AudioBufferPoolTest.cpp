@@ -0,0 +1,366 @@
+/*
+ * AudioBufferPoolTest.cpp - Lock-free size-class buffer pool
+ *
+ * Checks that buffers come back 64-byte aligned and cleared from the
+ * right size class, that warmed-up sizes never allocate, that a full
+ * class refuses requests until a buffer is returned (the writer's
+ * backpressure), and that PoolStats add up. Threads then hammer the pool
+ * with random sizes, each stamping its buffers and checking nobody else
+ * touched them, and the contention benchmark times N producer threads
+ * against the semaphore-and-scan pool it replaced (printed, not checked:
+ * the ratio depends on the machine) while checking no buffer is lost.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include "../audio/AudioBufferPool.h"
+
+using namespace VeniceDAW;
+
+// The pool as it was: one lock around a linear scan for a free entry
+class ScanningPool {
+public:
+    ScanningPool()
+    {
+        const size_t sizes[] = { 256, 512, 1024, 2048, 4096, 8192 };
+        for (size_t frames : sizes) {
+            for (uint32 channels = 1; channels <= 2; channels++) {
+                for (int i = 0; i < 8; i++) {
+                    fEntries.push_back({ new float[frames * channels], frames, channels, false });
+                }
+            }
+        }
+    }
+
+    ~ScanningPool()
+    {
+        for (Entry& entry : fEntries) {
+            delete[] entry.data;
+        }
+    }
+
+    float* Get(size_t frames, uint32 channels)
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        for (Entry& entry : fEntries) {
+            if (!entry.inUse && entry.frames >= frames && entry.channels == channels) {
+                entry.inUse = true;
+                memset(entry.data, 0, frames * channels * sizeof(float));
+                return entry.data;
+            }
+        }
+        return nullptr;
+    }
+
+    void Return(float* data)
+    {
+        std::lock_guard<std::mutex> lock(fLock);
+        for (Entry& entry : fEntries) {
+            if (entry.data == data) {
+                entry.inUse = false;
+                break;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        float* data;
+        size_t frames;
+        uint32 channels;
+        bool inUse;
+    };
+
+    std::mutex fLock;
+    std::vector<Entry> fEntries;
+};
+
+static uint32 NextRandom(uint32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static bool TestAlignmentAndClearing()
+{
+    std::cout << "\n[TEST] Buffers are aligned, cleared and sized from their class" << std::endl;
+
+    AudioBufferPool pool;
+    pool.Warmup();
+
+    bool passed = true;
+    const size_t frames[] = { 1, 100, 256, 300, 1024, 4000, 8192, 20000, 70000 };
+    for (size_t count : frames) {
+        for (uint32 channels = 1; channels <= 2; channels++) {
+            float* first = nullptr;
+            {
+                AudioBuffer buffer = pool.GetBuffer(count, channels);
+                first = buffer.Data();
+                bool aligned = ((uintptr_t)buffer.Data() % AudioBufferPool::kBlockAlignment) == 0;
+                passed = passed && buffer.IsValid() && aligned && buffer.Frames() == count;
+                for (size_t i = 0; i < count * channels; i++) {
+                    buffer.Data()[i] = 1.0f;
+                }
+            }
+
+            // The same block comes back, cleared
+            AudioBuffer again = pool.GetBuffer(count, channels);
+            bool cleared = true;
+            for (size_t i = 0; i < count * channels; i++) {
+                cleared = cleared && again.Data()[i] == 0.0f;
+            }
+            bool reused = count * channels > (AudioBufferPool::kMinClassSamples
+                << (AudioBufferPool::kSizeClassCount - 1)) || again.Data() == first;
+            passed = passed && cleared && reused;
+        }
+    }
+
+    AudioBufferPool::PoolStats stats = pool.GetStats();
+    std::cout << "  " << sizeof(frames) / sizeof(frames[0]) * 2 << " sizes: "
+              << stats.totalBuffers << " buffers, " << stats.allocatedBuffers << " in use, "
+              << stats.allocationCount << " allocations" << std::endl;
+    passed = passed && stats.allocatedBuffers == 0 && stats.availableBuffers == stats.totalBuffers;
+
+    // The size classes of the shared pool sit on their own cache lines too
+    bool globalAligned = ((uintptr_t)&AudioBufferPool::GetGlobalPool() % 64) == 0;
+    std::cout << "  Global pool cache-line aligned: " << (globalAligned ? "yes" : "no") << std::endl;
+    passed = passed && globalAligned;
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestNoAllocationAfterWarmup()
+{
+    std::cout << "\n[TEST] Warmed-up sizes never allocate" << std::endl;
+
+    AudioBufferPool pool;
+    pool.Warmup();
+    pool.Reserve(441, 2, 4);
+    AudioBufferPool::PoolStats before = pool.GetStats();
+
+    const size_t sizes[] = { 256, 441, 512, 1024, 2048, 4096, 8192 };
+    uint32 state = 7;
+    for (int i = 0; i < 100000; i++) {
+        size_t frames = sizes[NextRandom(state) % 7];
+        uint32 channels = 1 + NextRandom(state) % 2;
+        AudioBuffer a = pool.GetBuffer(frames, channels);
+        AudioBuffer b = pool.GetBuffer(frames, channels);
+    }
+    AudioBufferPool::PoolStats after = pool.GetStats();
+
+    uint32 allocations = after.allocationCount - before.allocationCount;
+    uint32 misses = after.missCount - before.missCount;
+    uint32 hits = after.hitCount - before.hitCount;
+    std::cout << "  200000 requests: " << hits << " hits, " << misses << " misses, "
+              << allocations << " allocations" << std::endl;
+
+    bool passed = allocations == 0 && misses == 0 && hits == 200000;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestFullClass()
+{
+    std::cout << "\n[TEST] A full class refuses requests until a buffer comes back" << std::endl;
+
+    AudioBufferPool pool;
+    std::vector<AudioBuffer> held;
+    for (uint32 i = 0; i < AudioBufferPool::kMaxBuffersPerClass; i++) {
+        held.push_back(pool.GetBuffer(1024, 2));
+    }
+    bool allValid = true;
+    for (AudioBuffer& buffer : held) {
+        allValid = allValid && buffer.IsValid();
+    }
+
+    AudioBuffer refused = pool.GetBuffer(1000, 2);
+    AudioBuffer otherClass = pool.GetBuffer(1024, 1);
+    held.pop_back();
+    AudioBuffer returned = pool.GetBuffer(1024, 2);
+
+    AudioBufferPool::PoolStats stats = pool.GetStats();
+    std::cout << "  " << held.size() + 1 << " held, next refused: "
+              << (refused.IsValid() ? "no" : "yes") << ", after a return: "
+              << (returned.IsValid() ? "served" : "refused") << std::endl;
+
+    bool passed = allValid && !refused.IsValid() && otherClass.IsValid() && returned.IsValid()
+        && stats.allocatedBuffers == AudioBufferPool::kMaxBuffersPerClass + 1;
+
+    // Cleanup() frees only what is not in use
+    held.clear();
+    otherClass = AudioBuffer();
+    returned = AudioBuffer();
+    pool.Cleanup();
+    stats = pool.GetStats();
+    passed = passed && stats.totalBuffers == 0 && pool.GetBuffer(1024, 2).IsValid();
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestConcurrentStamps(bool quick)
+{
+    std::cout << "\n[TEST] Concurrent get/return never hands a buffer out twice" << std::endl;
+
+    AudioBufferPool pool;
+    pool.Warmup();
+
+    const int threads = 8;
+    const int iterations = quick ? 20000 : 200000;
+    std::atomic<int> corrupted(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint32 state = 1234 + t;
+            const size_t sizes[] = { 64, 256, 512, 1024, 2048 };
+            for (int i = 0; i < iterations; i++) {
+                size_t frames = sizes[NextRandom(state) % 5];
+                uint32 channels = 1 + NextRandom(state) % 2;
+                AudioBuffer buffer = pool.GetBuffer(frames, channels);
+                if (!buffer.IsValid()) {
+                    continue;
+                }
+                float stamp = (float)(t * iterations + i);
+                size_t samples = frames * channels;
+                buffer.Data()[0] = stamp;
+                buffer.Data()[samples - 1] = stamp;
+                if ((i & 7) == 0) {
+                    std::this_thread::yield();
+                }
+                if (buffer.Data()[0] != stamp || buffer.Data()[samples - 1] != stamp) {
+                    corrupted++;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    AudioBufferPool::PoolStats stats = pool.GetStats();
+    std::cout << "  " << threads << " threads x " << iterations << ": " << corrupted.load()
+              << " corrupted, " << stats.allocatedBuffers << " left in use, "
+              << stats.availableBuffers << "/" << stats.totalBuffers << " available" << std::endl;
+
+    bool passed = corrupted.load() == 0 && stats.allocatedBuffers == 0
+        && stats.availableBuffers == stats.totalBuffers;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+template <typename Cycle>
+static double TimeProducers(int threads, int iterations, Cycle cycle)
+{
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            uint32 state = 99 + t;
+            for (int i = 0; i < iterations; i++) {
+                cycle(state);
+            }
+        });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return threads * (double)iterations / std::max(seconds, 1e-9);
+}
+
+static bool TestContention(bool quick)
+{
+    std::cout << "\n[TEST] Contention: N producer threads" << std::endl;
+
+    AudioBufferPool pool;
+    pool.Warmup();
+    ScanningPool scanning;
+
+    // The writer's pattern: a stereo block held briefly, now and then a
+    // mono one, at callback sizes
+    const size_t sizes[] = { 128, 256, 512 };
+    const int iterations = quick ? 20000 : 200000;
+
+    // Throughput is reported only: it depends on the machine's cores and
+    // load. What must hold is that no buffer is handed out twice or lost.
+    std::atomic<uint32> corrupted(0);
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    for (int threads : threadCounts) {
+        double lockFree = TimeProducers(threads, iterations, [&](uint32& state) {
+            size_t frames = sizes[NextRandom(state) % 3];
+            uint32 channels = (NextRandom(state) & 3) ? 2 : 1;
+            AudioBuffer buffer = pool.GetBuffer(frames, channels);
+            if (buffer.IsValid()) {
+                float stamp = (float)(NextRandom(state) & 0xffffff);
+                buffer.Data()[0] = stamp;
+                if (buffer.Data()[0] != stamp) {
+                    corrupted++;
+                }
+            }
+        });
+        double locked = TimeProducers(threads, iterations, [&](uint32& state) {
+            size_t frames = sizes[NextRandom(state) % 3];
+            uint32 channels = (NextRandom(state) & 3) ? 2 : 1;
+            float* data = scanning.Get(frames, channels);
+            if (data) {
+                data[0] = 1.0f;
+                scanning.Return(data);
+            }
+        });
+
+        std::cout << "  " << threads << " thread" << (threads > 1 ? "s: " : ":  ")
+                  << std::fixed << std::setprecision(2) << lockFree / 1e6 << " M ops/s lock-free, "
+                  << locked / 1e6 << " M ops/s scanning (" << std::setprecision(1)
+                  << lockFree / locked << "x)" << std::endl;
+    }
+
+    AudioBufferPool::PoolStats stats = pool.GetStats();
+    std::cout << "  " << corrupted.load() << " corrupted, " << stats.allocatedBuffers
+              << " left in use, " << stats.availableBuffers << "/" << stats.totalBuffers
+              << " available" << std::endl;
+
+    bool passed = corrupted.load() == 0 && stats.allocatedBuffers == 0
+        && stats.availableBuffers == stats.totalBuffers;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    VeniceDAW Audio Buffer Pool Tests       ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestAlignmentAndClearing()) passed++;
+    total++; if (TestNoAllocationAfterWarmup()) passed++;
+    total++; if (TestFullClass()) passed++;
+    total++; if (TestConcurrentStamps(quick)) passed++;
+    total++; if (TestContention(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,441 @@
+/*
+ * AudioDriverTest.cpp - Headless null and file output drivers
+ *
+ * Drives a deterministic test callback through the null driver in all
+ * three clock modes and through the file driver, checking format
+ * negotiation, that manual runs are bit-exact and repeatable, that the
+ * simulated clock paces buffers like a device and flags late callbacks,
+ * and that the file driver writes exactly the rendered audio. Then
+ * reports free-running callback throughput.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+#include "../audio/AudioOutputDriver.h"
+
+using namespace VeniceDAW;
+
+// Stereo sine with per-channel phase, written in the negotiated format
+struct SineSource {
+    double phase;
+    double increment;
+    uint64 callbacks;
+    int64 sleepMicroseconds;
+
+    explicit SineSource(double frequency = 441.0, double sampleRate = 44100.0)
+        : phase(0.0), increment(2.0 * M_PI * frequency / sampleRate), callbacks(0),
+          sleepMicroseconds(0) {}
+
+    float Next(int channel)
+    {
+        return (float)(0.5 * std::sin(phase + channel * 0.25));
+    }
+};
+
+static void SineCallback(void* cookie, void* buffer, size_t size, const media_raw_audio_format& format)
+{
+    SineSource* source = static_cast<SineSource*>(cookie);
+    size_t frames = size / AudioOutputDriver::FrameSize(format);
+
+    for (size_t i = 0; i < frames; i++) {
+        for (uint32 c = 0; c < format.channel_count; c++) {
+            float sample = source->Next(c);
+            if (format.format == media_raw_audio_format::B_AUDIO_FLOAT) {
+                static_cast<float*>(buffer)[i * format.channel_count + c] = sample;
+            } else {
+                static_cast<int16*>(buffer)[i * format.channel_count + c] = (int16)lrintf(sample * 32767.0f);
+            }
+        }
+        source->phase += source->increment;
+    }
+
+    source->callbacks++;
+    if (source->sleepMicroseconds > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(source->sleepMicroseconds));
+    }
+}
+
+static uint64 Checksum(const void* data, size_t size, uint64 hash)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool TestFormatNegotiation()
+{
+    std::cout << "\n[TEST] Format negotiation fills in wildcards" << std::endl;
+
+    SineSource source;
+    NullOutputDriver driver;
+    driver.SetClockMode(NullOutputDriver::kManual);
+
+    driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+    media_raw_audio_format defaults = driver.Format();
+    bool defaultsOk = defaults.frame_rate == 44100.0f && defaults.channel_count == 2
+                      && defaults.format == media_raw_audio_format::B_AUDIO_FLOAT
+                      && AudioOutputDriver::BufferFrames(defaults) == 512;
+
+    driver.SetSampleRate(48000.0f);
+    driver.SetBufferFrames(128);
+    driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+    media_raw_audio_format configured = driver.Format();
+    bool configuredOk = configured.frame_rate == 48000.0f
+                        && AudioOutputDriver::BufferFrames(configured) == 128
+                        && driver.Latency() == 2666;
+
+    // Explicit requests win; partial frames are cut off
+    media_raw_audio_format request = media_raw_audio_format::wildcard;
+    request.format = media_raw_audio_format::B_AUDIO_SHORT;
+    request.channel_count = 1;
+    request.buffer_size = 1001;
+    driver.Open(request, SineCallback, &source);
+    media_raw_audio_format explicitFormat = driver.Format();
+    bool explicitOk = explicitFormat.format == media_raw_audio_format::B_AUDIO_SHORT
+                      && explicitFormat.channel_count == 1 && explicitFormat.buffer_size == 1000
+                      && AudioOutputDriver::FrameSize(explicitFormat) == 2;
+
+    bool rejectsNull = driver.Open(request, nullptr, &source) == B_BAD_VALUE;
+
+    std::unique_ptr<AudioOutputDriver> byName(CreateAudioOutputDriver("null"));
+    std::unique_ptr<AudioOutputDriver> fileByName(CreateAudioOutputDriver("file", "/dev/null"));
+    std::unique_ptr<AudioOutputDriver> unknown(CreateAudioOutputDriver("bogus"));
+    bool factoryOk = byName && strcmp(byName->Name(), "null") == 0
+                     && fileByName && strcmp(fileByName->Name(), "file") == 0 && !unknown;
+
+    std::cout << "  defaults: " << (defaultsOk ? "ok" : "wrong")
+              << ", configured: " << (configuredOk ? "ok" : "wrong")
+              << ", explicit: " << (explicitOk ? "ok" : "wrong")
+              << ", null callback rejected: " << (rejectsNull ? "yes" : "no")
+              << ", factory: " << (factoryOk ? "ok" : "wrong") << std::endl;
+
+    bool passed = defaultsOk && configuredOk && explicitOk && rejectsNull && factoryOk;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestManualDeterminism()
+{
+    std::cout << "\n[TEST] Manual clock: repeatable, bit-exact runs" << std::endl;
+
+    const uint32 kBuffers = 200;
+    uint64 checksums[2];
+    uint64 frames[2];
+    bool callbacksMatch = true;
+
+    for (int run = 0; run < 2; run++) {
+        SineSource source;
+        NullOutputDriver driver;
+        driver.SetClockMode(NullOutputDriver::kManual);
+        driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+        driver.Start();
+
+        uint64 hash = 14695981039346656037ull;
+        for (uint32 i = 0; i < kBuffers; i++) {
+            driver.Pump();
+            hash = Checksum(driver.LastBuffer(), driver.Format().buffer_size, hash);
+        }
+        driver.Stop();
+
+        checksums[run] = hash;
+        frames[run] = driver.FramesPlayed();
+        NullOutputDriver::Stats stats = driver.GetStats();
+        callbacksMatch = callbacksMatch && stats.callbacks == kBuffers && source.callbacks == kBuffers;
+    }
+
+    std::cout << "  " << kBuffers << " buffers x 2 runs: checksums " << std::hex << checksums[0]
+              << " / " << checksums[1] << std::dec << ", " << frames[0] << " frames" << std::endl;
+
+    bool passed = checksums[0] == checksums[1] && frames[0] == kBuffers * 512ull
+                  && frames[1] == frames[0] && callbacksMatch;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestFreeRunning()
+{
+    std::cout << "\n[TEST] Free-running clock stops at the frame limit" << std::endl;
+
+    const uint64 kLimit = 44100 * 10;   // Ten seconds of audio
+    SineSource source;
+    NullOutputDriver driver;
+    driver.SetFrameLimit(kLimit);
+    driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+
+    auto start = std::chrono::steady_clock::now();
+    driver.Start();
+    driver.WaitForCompletion();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool stopped = !driver.IsRunning();
+    // Pumping is allowed again once the thread has finished
+    bool pumpAfter = driver.Pump(1) == B_OK;
+    uint64 played = driver.FramesPlayed();
+
+    std::cout << "  rendered " << played - 512 << " frames (limit " << kLimit << ") in "
+              << std::fixed << std::setprecision(3) << seconds << " s, "
+              << std::setprecision(0) << driver.SimulatedTime() / 1e6 / seconds << "x realtime"
+              << std::defaultfloat << std::endl;
+
+    bool passed = stopped && pumpAfter && played - 512 <= kLimit && played - 512 > kLimit - 512
+                  && seconds < 10.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestSimulatedClock(bool quick)
+{
+    std::cout << "\n[TEST] Simulated clock paces buffers and flags late callbacks" << std::endl;
+
+    const uint32 kBuffers = quick ? 40 : 100;
+    const size_t kFrames = 256;
+
+    // A cheap callback keeps up with the device
+    SineSource source(441.0, 48000.0);
+    NullOutputDriver driver;
+    driver.SetClockMode(NullOutputDriver::kSimulatedClock);
+    driver.SetSampleRate(48000.0f);
+    driver.SetBufferFrames(kFrames);
+    driver.SetFrameLimit(kBuffers * kFrames);
+    driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+
+    auto start = std::chrono::steady_clock::now();
+    driver.Start();
+    driver.WaitForCompletion();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simulated = driver.SimulatedTime() / 1e6;
+    NullOutputDriver::Stats fast = driver.GetStats();
+
+    // One that takes two periods per buffer misses every deadline
+    SineSource slow(441.0, 48000.0);
+    slow.sleepMicroseconds = driver.Latency() * 2;
+    NullOutputDriver slowDriver;
+    slowDriver.SetClockMode(NullOutputDriver::kSimulatedClock);
+    slowDriver.SetSampleRate(48000.0f);
+    slowDriver.SetBufferFrames(kFrames);
+    slowDriver.SetFrameLimit(10 * kFrames);
+    slowDriver.Open(media_raw_audio_format::wildcard, SineCallback, &slow);
+    slowDriver.Start();
+    slowDriver.WaitForCompletion();
+    NullOutputDriver::Stats late = slowDriver.GetStats();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  " << kBuffers << " x " << kFrames << " frames: " << simulated
+              << " s simulated, " << seconds << " s wall clock, " << fast.lateCallbacks
+              << " late" << std::endl;
+    std::cout << "  slow callback: " << late.lateCallbacks << " of " << late.callbacks
+              << " late" << std::endl;
+    std::cout << std::defaultfloat;
+
+    // The first buffer is due immediately, so the run takes one period
+    // less than the audio it produced; allow for scheduler noise
+    double period = kFrames / 48000.0;
+    bool paced = seconds >= simulated - period * 1.5 && seconds < simulated * 1.5 + 0.05;
+    bool passed = paced && fast.lateCallbacks <= kBuffers / 10
+                  && late.callbacks == 10 && late.lateCallbacks == late.callbacks;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool ReadWav(const char* path, uint16& formatTag, uint16& channels, uint32& rate,
+                    uint16& bits, std::vector<uint8>& data)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8 header[44];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header)
+              && memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0
+              && memcmp(header + 36, "data", 4) == 0;
+    if (ok) {
+        formatTag = header[20] | header[21] << 8;
+        channels = header[22] | header[23] << 8;
+        rate = header[24] | header[25] << 8 | header[26] << 16 | (uint32)header[27] << 24;
+        bits = header[34] | header[35] << 8;
+        uint32 size = header[40] | header[41] << 8 | header[42] << 16 | (uint32)header[43] << 24;
+        data.resize(size);
+        ok = fread(data.data(), 1, size, file) == size;
+    }
+    fclose(file);
+    return ok;
+}
+
+static bool TestFileDriver()
+{
+    std::cout << "\n[TEST] File driver writes exactly the rendered audio" << std::endl;
+
+    const char* floatPath = "/tmp/venicedaw_driver_test_float.wav";
+    const char* shortPath = "/tmp/venicedaw_driver_test_short.wav";
+    const uint32 kBuffers = 100;
+
+    // Reference: the same source through a manual null driver
+    std::vector<uint8> reference;
+    {
+        SineSource source;
+        NullOutputDriver driver;
+        driver.SetClockMode(NullOutputDriver::kManual);
+        driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+        for (uint32 i = 0; i < kBuffers; i++) {
+            driver.Pump();
+            const uint8* buffer = static_cast<const uint8*>(driver.LastBuffer());
+            reference.insert(reference.end(), buffer, buffer + driver.Format().buffer_size);
+        }
+    }
+
+    // Free-running thread with a frame limit, finished by Close()
+    {
+        SineSource source;
+        FileOutputDriver driver(floatPath);
+        driver.SetFrameLimit(kBuffers * 512);
+        driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+        driver.Start();
+        driver.WaitForCompletion();
+        driver.Close();
+    }
+
+    // 16-bit mono, pumped by hand
+    status_t shortStatus;
+    {
+        SineSource source;
+        FileOutputDriver driver(shortPath);
+        driver.SetClockMode(NullOutputDriver::kManual);
+        media_raw_audio_format request = media_raw_audio_format::wildcard;
+        request.format = media_raw_audio_format::B_AUDIO_SHORT;
+        request.channel_count = 1;
+        driver.Open(request, SineCallback, &source);
+        driver.Pump(10);
+        driver.Close();
+        shortStatus = driver.WriteStatus();
+    }
+
+    uint16 tag = 0, channels = 0, bits = 0;
+    uint32 rate = 0;
+    std::vector<uint8> data;
+    bool floatRead = ReadWav(floatPath, tag, channels, rate, bits, data);
+    bool floatOk = floatRead && tag == 3 && channels == 2 && rate == 44100 && bits == 32
+                   && data == reference;
+
+    std::vector<uint8> shortData;
+    bool shortRead = ReadWav(shortPath, tag, channels, rate, bits, shortData);
+    bool shortOk = shortRead && shortStatus == B_OK && tag == 1 && channels == 1 && bits == 16
+                   && shortData.size() == 10 * 512 * 2;
+
+    std::cout << "  float stereo: " << data.size() << " bytes, "
+              << (floatOk ? "identical to the manual render" : "MISMATCH") << std::endl;
+    std::cout << "  int16 mono:   " << shortData.size() << " bytes, "
+              << (shortOk ? "header ok" : "WRONG") << std::endl;
+
+    remove(floatPath);
+    remove(shortPath);
+
+    bool passed = floatOk && shortOk;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// Stands in for a full disk: every third buffer cannot be written
+class FailingOutputDriver : public NullOutputDriver {
+public:
+    FailingOutputDriver() : fBuffers(0) {}
+
+protected:
+    virtual status_t _BufferRendered(const void* buffer, size_t size)
+    {
+        (void)buffer;
+        (void)size;
+        return ++fBuffers % 3 == 0 ? B_IO_ERROR : B_OK;
+    }
+
+private:
+    uint32 fBuffers;
+};
+
+static bool TestWriteFailures()
+{
+    std::cout << "\n[TEST] Buffers the output cannot write are counted" << std::endl;
+
+    SineSource source;
+    FailingOutputDriver driver;
+    driver.SetClockMode(NullOutputDriver::kManual);
+    driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+
+    status_t first = driver.Pump(2);
+    status_t second = driver.Pump(10);
+    NullOutputDriver::Stats stats = driver.GetStats();
+    driver.ResetStats();
+    uint64 afterReset = driver.GetStats().failedWrites;
+    driver.Close();
+
+    std::cout << "  " << stats.callbacks << " buffers, " << stats.failedWrites
+              << " failed writes" << std::endl;
+
+    bool passed = first == B_OK && second == B_IO_ERROR && stats.callbacks == 12
+                  && stats.failedWrites == 4 && afterReset == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static void BenchmarkCallbackThroughput(bool quick)
+{
+    std::cout << "\n[BENCH] Free-running callback throughput" << std::endl;
+
+    const size_t sizes[] = { 64, 256, 1024 };
+    const double seconds = quick ? 30.0 : 300.0;
+
+    for (size_t frames : sizes) {
+        SineSource source;
+        NullOutputDriver driver;
+        driver.SetBufferFrames(frames);
+        driver.SetFrameLimit((uint64)(seconds * 44100.0));
+        driver.Open(media_raw_audio_format::wildcard, SineCallback, &source);
+
+        auto start = std::chrono::steady_clock::now();
+        driver.Start();
+        driver.WaitForCompletion();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        NullOutputDriver::Stats stats = driver.GetStats();
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  " << std::setw(4) << frames << " frames: " << std::setw(8)
+                  << stats.callbacks / wall << " callbacks/s, mean "
+                  << std::setprecision(2) << stats.totalCallbackTime / (double)stats.callbacks
+                  << " us, max " << stats.maxCallbackTime << " us, "
+                  << std::setprecision(0) << driver.SimulatedTime() / 1e6 / wall << "x realtime"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Output Driver Tests             ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestFormatNegotiation()) passed++;
+    total++; if (TestManualDeterminism()) passed++;
+    total++; if (TestFreeRunning()) passed++;
+    total++; if (TestSimulatedClock(quick)) passed++;
+    total++; if (TestFileDriver()) passed++;
+    total++; if (TestWriteFailures()) passed++;
+
+    BenchmarkCallbackThroughput(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,563 @@
+/*
+ * AudioLoaderServiceTest.cpp - Background loading of audio files
+ *
+ * Loads files through a fake decoder whose speed the test controls, so it
+ * can look at a load while it is in progress: the order jobs are picked
+ * in, requests for the same file sharing one load, the waveform peaks of
+ * what has been decoded so far, cancelling before and during a load, a
+ * WAV file going through the mapped path, and the handle answering polls
+ * without waiting while the loaders are busy.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../audio/AudioLoaderService.h"
+#include "../audio/CompressedSampleStore.h"
+#include "../audio/MappedPCMSource.h"
+#include "TestSignals.h"
+
+using namespace VeniceDAW;
+
+static std::string sDirectory;
+
+// Fake files: "fake:<name>:<frames>", or "fake:fail" which does not open
+static std::mutex sOpenLock;
+static std::vector<std::string> sOpened;
+
+// Frames the fake decoders may hand out in total; -1 = no limit
+static std::atomic<int64> sDecodeBudget(-1);
+
+static int16_t Sample(int64 frame, int32 channel)
+{
+    double envelope = 0.3 + 0.7 * std::fabs(std::sin(frame * 0.00013));
+    double value = std::sin(frame * (channel ? 0.021 : 0.017)) * 16000.0 * envelope;
+    return (int16_t)(value + (int32)((frame * 7919 + channel * 104729) % 201) - 100);
+}
+
+class FakeDecoder : public AudioDecoder {
+public:
+    FakeDecoder() : fFrames(0), fPosition(0) {}
+
+    status_t Open(const char* path, float* sampleRate, int64* frames) override
+    {
+        if (strncmp(path, "fake:", 5) != 0 || strcmp(path, "fake:fail") == 0) {
+            return B_ERROR;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sOpenLock);
+            sOpened.push_back(path);
+        }
+        const char* length = strrchr(path, ':');
+        fFrames = atoll(length + 1);
+        *sampleRate = 48000.0f;
+        *frames = fFrames;
+        return B_OK;
+    }
+
+    int64 Decode(int16_t* frames, int64 maxFrames) override
+    {
+        int64 count = std::min(maxFrames, fFrames - fPosition);
+        while (count > 0) {
+            int64 budget = sDecodeBudget.load();
+            if (budget < 0) {
+                break;
+            }
+            if (budget >= count && sDecodeBudget.compare_exchange_weak(budget, budget - count)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        for (int64 i = 0; i < count; i++) {
+            frames[i * 2] = Sample(fPosition + i, 0);
+            frames[i * 2 + 1] = Sample(fPosition + i, 1);
+        }
+        fPosition += count;
+        return count;
+    }
+
+private:
+    int64 fFrames;
+    int64 fPosition;
+};
+
+static void UseFakeDecoder(AudioLoaderService& service)
+{
+    service.SetDecoderFactory([]() { return std::unique_ptr<AudioDecoder>(new FakeDecoder()); });
+}
+
+static std::string FakePath(const char* name, int64 frames)
+{
+    return std::string("fake:") + name + ":" + std::to_string((long long)frames);
+}
+
+static bool WaitUntil(const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 20000; i++) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static bool WaitDone(const std::shared_ptr<AudioLoadHandle>& handle)
+{
+    return WaitUntil([&handle]() { return handle->IsDone(); });
+}
+
+// Min and max of the (L+R)/2 mix, as the peaks are built
+static void ScanPeaks(int64 start, int64 end, float* outMin, float* outMax)
+{
+    *outMin = 1.0f;
+    *outMax = -1.0f;
+    for (int64 i = start; i < end; i++) {
+        float value = (Sample(i, 0) + Sample(i, 1)) * 0.5f / 32768.0f;
+        *outMin = std::min(*outMin, value);
+        *outMax = std::max(*outMax, value);
+    }
+}
+
+static bool TestPriorityOrder()
+{
+    std::cout << "\n[TEST] Loads run highest priority first, then in request order" << std::endl;
+
+    sOpened.clear();
+    sDecodeBudget = -1;
+
+    // Queued before the single loader starts, so the order is the picker's
+    AudioLoaderService service(1);
+    UseFakeDecoder(service);
+
+    std::vector<std::shared_ptr<AudioLoadHandle> > handles;
+    handles.push_back(service.Load(FakePath("background-1", 1000).c_str()));
+    handles.push_back(service.Load(FakePath("visible-1", 1000).c_str(), nullptr,
+                                   AudioLoaderService::kVisiblePriority));
+    handles.push_back(service.Load(FakePath("background-2", 1000).c_str()));
+    handles.push_back(service.Load(FakePath("playing", 1000).c_str(), nullptr,
+                                   AudioLoaderService::kPlayingPriority));
+    handles.push_back(service.Load(FakePath("visible-2", 1000).c_str(), nullptr,
+                                   AudioLoaderService::kVisiblePriority));
+    handles.push_back(service.Load(FakePath("raised", 1000).c_str()));
+    handles[5]->SetPriority(AudioLoaderService::kPlayingPriority);
+
+    service.Start();
+    bool allDone = true;
+    for (const std::shared_ptr<AudioLoadHandle>& handle : handles) {
+        allDone = WaitDone(handle) && handle->IsReady() && allDone;
+    }
+    service.Stop();
+
+    const char* expected[] = { "playing", "raised", "visible-1", "visible-2",
+                               "background-1", "background-2" };
+    bool ordered = sOpened.size() == 6;
+    std::cout << "  Order:";
+    for (size_t i = 0; i < sOpened.size(); i++) {
+        std::string name = sOpened[i].substr(5, sOpened[i].rfind(':') - 5);
+        std::cout << " " << name;
+        ordered = ordered && name == expected[i];
+    }
+    std::cout << std::endl;
+
+    bool passed = allDone && ordered;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestSharedRequests()
+{
+    std::cout << "\n[TEST] Requests for the same file share one load" << std::endl;
+
+    sOpened.clear();
+    sDecodeBudget = -1;
+
+    AudioLoaderService service(2);
+    UseFakeDecoder(service);
+
+    std::string path = FakePath("shared", 50000);
+    std::shared_ptr<AudioLoadHandle> first = service.Load(path.c_str());
+    std::shared_ptr<AudioLoadHandle> second = service.Load(path.c_str(), nullptr,
+                                                           AudioLoaderService::kPlayingPriority);
+    std::shared_ptr<AudioLoadHandle> third = service.Load(path.c_str(), nullptr,
+                                                          AudioLoaderService::kVisiblePriority);
+    bool same = first == second && second == third;
+    bool raised = first->GetPriority() == AudioLoaderService::kPlayingPriority;
+
+    service.Start();
+    bool ready = WaitDone(first) && first->IsReady();
+    std::shared_ptr<AudioLoadHandle> later = service.Load(path.c_str());
+    bool reused = later == first && later->IsReady();
+
+    // A failed file is tried again when asked for again
+    std::shared_ptr<AudioLoadHandle> failed = service.Load("fake:fail");
+    bool failedOnce = WaitDone(failed) && failed->GetState() == AudioLoadHandle::kFailed;
+    std::shared_ptr<AudioLoadHandle> retry = service.Load("fake:fail");
+    bool retried = retry != failed && WaitDone(retry);
+
+    AudioLoaderService::Stats stats = service.GetStats();
+    service.Stop();
+
+    std::cout << "  Same handle: " << (same ? "yes" : "no") << ", priority raised: "
+              << (raised ? "yes" : "no") << ", opened " << sOpened.size()
+              << "x, reused when loaded: " << (reused ? "yes" : "no") << std::endl;
+    std::cout << "  Failed file retried on request: " << (failedOnce && retried ? "yes" : "no")
+              << " (" << stats.completed << " completed, " << stats.failed << " failed)" << std::endl;
+
+    bool passed = same && raised && ready && reused && sOpened.size() == 1 && failedOnce
+        && retried && stats.completed == 1 && stats.failed == 2;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestProgressivePeaks()
+{
+    std::cout << "\n[TEST] Peaks of the decoded part are available while loading" << std::endl;
+
+    const int64 chunk = AudioLoaderService::kChunkFrames;
+    const int64 frames = chunk * 10 + 1234;
+    sDecodeBudget = 0;
+
+    AudioLoaderService service(1);
+    UseFakeDecoder(service);
+    service.Start();
+
+    std::shared_ptr<AudioLoadHandle> handle = service.Load(FakePath("progressive", frames).c_str());
+
+    bool partialExact = true;
+    bool nothingBeyond = true;
+    bool notPublished = true;
+    int32 steps = 0;
+    for (int64 allowed = chunk; allowed < frames; allowed += chunk * 3) {
+        sDecodeBudget += steps == 0 ? chunk : chunk * 3;
+        if (!WaitUntil([&]() { return handle->CountFramesLoaded() >= allowed; })) {
+            partialExact = false;
+            break;
+        }
+
+        int64 loaded = handle->CountFramesLoaded();
+        notPublished = notPublished && handle->GetState() == AudioLoadHandle::kLoading
+            && !handle->GetCompressed() && !handle->GetSource();
+
+        // Whole-bucket queries over the loaded part match a scan
+        for (int64 start = 0; start + 4096 <= loaded; start += 4096 * 3) {
+            float low, high, exactLow, exactHigh;
+            ScanPeaks(start, start + 4096, &exactLow, &exactHigh);
+            if (!handle->GetPeaks(start, start + 4096, &low, &high)
+                || low != exactLow || high != exactHigh) {
+                partialExact = false;
+            }
+        }
+        float low, high;
+        nothingBeyond = nothingBeyond && !handle->GetPeaks(loaded + 64, loaded + 4096, &low, &high);
+        steps++;
+    }
+
+    std::cout << "  " << steps << " partial checks, progress "
+              << std::fixed << std::setprecision(2) << handle->GetProgress()
+              << std::defaultfloat << std::setprecision(6) << " before the last chunks" << std::endl;
+
+    sDecodeBudget = -1;
+    bool ready = WaitDone(handle) && handle->IsReady();
+
+    // The finished load is the decoded audio, losslessly
+    bool exact = ready && handle->GetCompressed() && handle->CountFrames() == frames;
+    if (exact) {
+        std::vector<int16_t> decoded(frames * 2);
+        exact = handle->GetCompressed()->ReadFrames(0, decoded.data(), frames) == frames;
+        for (int64 i = 0; i < frames && exact; i++) {
+            exact = decoded[i * 2] == Sample(i, 0) && decoded[i * 2 + 1] == Sample(i, 1);
+        }
+    }
+    float low, high, exactLow, exactHigh;
+    ScanPeaks(0, frames, &exactLow, &exactHigh);
+    bool fullPeaks = handle->GetPeaks(0, frames, &low, &high) && low == exactLow && high == exactHigh;
+    service.Stop();
+
+    std::cout << "  Partial peaks exact: " << (partialExact ? "yes" : "no")
+              << ", nothing past the loaded part: " << (nothingBeyond ? "yes" : "no")
+              << ", audio held back until ready: " << (notPublished ? "yes" : "no") << std::endl;
+    std::cout << "  Finished: " << (ready ? "ready" : "not ready") << ", samples exact: "
+              << (exact ? "yes" : "no") << ", whole-file peaks exact: "
+              << (fullPeaks ? "yes" : "no") << std::endl;
+
+    bool passed = steps >= 3 && partialExact && nothingBeyond && notPublished && ready && exact
+        && fullPeaks;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestCancel()
+{
+    std::cout << "\n[TEST] Loads can be cancelled while queued and while loading" << std::endl;
+
+    const int64 chunk = AudioLoaderService::kChunkFrames;
+    sOpened.clear();
+    sDecodeBudget = 0;
+
+    AudioLoaderService service(1);
+    UseFakeDecoder(service);
+
+    // Queued: never opened
+    std::shared_ptr<AudioLoadHandle> queued = service.Load(FakePath("queued", chunk * 4).c_str());
+    queued->Cancel();
+    bool queuedCancelled = queued->GetState() == AudioLoadHandle::kCancelled;
+
+    // Released by everyone who asked: dropped as well
+    service.Load(FakePath("abandoned", chunk * 4).c_str());
+
+    std::shared_ptr<AudioLoadHandle> running = service.Load(FakePath("running", chunk * 50).c_str());
+    service.Start();
+
+    sDecodeBudget = chunk * 2;
+    bool started = WaitUntil([&]() { return running->CountFramesLoaded() >= chunk * 2; });
+    running->Cancel();
+    sDecodeBudget = -1;
+    bool runningCancelled = WaitDone(running) && running->GetState() == AudioLoadHandle::kCancelled
+        && !running->GetCompressed() && running->CountFramesLoaded() < chunk * 50;
+
+    // Asking again after a cancel loads the file anew
+    std::shared_ptr<AudioLoadHandle> again = service.Load(FakePath("running", chunk * 50).c_str());
+    bool reloaded = again != running && WaitDone(again) && again->IsReady();
+
+    // Stop() cancels whatever is still pending
+    sDecodeBudget = 0;
+    std::shared_ptr<AudioLoadHandle> pending = service.Load(FakePath("pending", chunk * 4).c_str());
+    std::shared_ptr<AudioLoadHandle> behind = service.Load(FakePath("behind", chunk * 4).c_str());
+    WaitUntil([&]() { return pending->GetState() == AudioLoadHandle::kLoading; });
+    std::thread release([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        sDecodeBudget = -1;
+    });
+    service.Stop();
+    release.join();
+    bool stopped = pending->GetState() == AudioLoadHandle::kCancelled
+        && behind->GetState() == AudioLoadHandle::kCancelled;
+
+    bool neverOpened = true;
+    for (const std::string& path : sOpened) {
+        neverOpened = neverOpened && path.find("queued") == std::string::npos
+            && path.find("abandoned") == std::string::npos
+            && path.find("behind") == std::string::npos;
+    }
+
+    std::cout << "  Queued: " << (queuedCancelled && neverOpened ? "dropped unopened" : "opened")
+              << ", running: " << (started && runningCancelled ? "stopped after "
+                                   + std::to_string((long long)running->CountFramesLoaded()) + " frames"
+                                   : "not stopped") << std::endl;
+    std::cout << "  Reloaded on request: " << (reloaded ? "yes" : "no")
+              << ", Stop() cancelled the rest: " << (stopped ? "yes" : "no") << std::endl;
+
+    bool passed = queuedCancelled && neverOpened && started && runningCancelled && reloaded
+        && stopped;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static std::string WriteWav(const char* name, int64 frames)
+{
+    std::vector<uint8> out;
+    out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+    Put32(out, 36 + frames * 4);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    Put32(out, 16);
+    Put16(out, 1);
+    Put16(out, 2);
+    Put32(out, 44100);
+    Put32(out, 44100 * 4);
+    Put16(out, 4);
+    Put16(out, 16);
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    Put32(out, frames * 4);
+    for (int64 i = 0; i < frames; i++) {
+        Put16(out, (uint16)Sample(i, 0));
+        Put16(out, (uint16)Sample(i, 1));
+    }
+
+    std::string path = sDirectory + "/" + name;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file) {
+        fwrite(out.data(), 1, out.size(), file);
+        fclose(file);
+    }
+    return path;
+}
+
+static bool TestMappedFile()
+{
+    std::cout << "\n[TEST] WAV files are mapped, with peaks from one scan" << std::endl;
+
+    const int64 frames = 300001;
+    std::string path = WriteWav("mapped.wav", frames);
+    sOpened.clear();
+    sDecodeBudget = -1;
+
+    AudioLoaderService service(2);
+    UseFakeDecoder(service);
+    service.Start();
+
+    std::shared_ptr<AudioLoadHandle> handle = service.Load(path.c_str());
+    bool ready = WaitDone(handle) && handle->IsReady();
+    service.Stop();
+
+    const std::shared_ptr<const MappedPCMSource>& source = handle->GetSource();
+    bool mapped = ready && source && !handle->GetCompressed() && sOpened.empty()
+        && handle->CountFrames() == frames && handle->GetSampleRate() == 44100.0f;
+
+    int32 mismatches = 0;
+    const int64 spans[][2] = { { 0, frames }, { 0, 64 * 100 }, { 64 * 1000, 64 * 3000 },
+                               { 64 * 4000, frames } };
+    for (const auto& span : spans) {
+        float low, high, exactLow, exactHigh;
+        ScanPeaks(span[0], span[1], &exactLow, &exactHigh);
+        if (!handle->GetPeaks(span[0], span[1], &low, &high) || low != exactLow || high != exactHigh) {
+            mismatches++;
+        }
+    }
+
+    int16_t pair[2] = { 0, 0 };
+    bool readable = mapped && source->ReadFrames(frames - 1, pair, 1) == 1
+        && pair[0] == Sample(frames - 1, 0) && pair[1] == Sample(frames - 1, 1);
+
+    std::cout << "  " << (mapped ? "Mapped" : "Not mapped") << ", " << handle->CountFrames()
+              << " frames at " << handle->GetSampleRate() << " Hz, decoder used: "
+              << (sOpened.empty() ? "no" : "yes") << ", peak mismatches: " << mismatches << std::endl;
+
+    bool passed = mapped && readable && mismatches == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestNonBlockingPoll(bool quick)
+{
+    std::cout << "\n[TEST] Requests and polls return at once while loaders are busy" << std::endl;
+
+    const int64 frames = quick ? 2000000 : 8000000;
+    const int32 files = 4;
+    sDecodeBudget = 0;   // The gate: both loaders stall inside Decode()
+
+    AudioLoaderService service(2);
+    UseFakeDecoder(service);
+    service.Start();
+
+    // What a UI thread does while the gate is closed: request the files,
+    // then a pulse of state, progress and a screen of peaks. If any of it
+    // waited for a loader, it could only finish once the gate opens.
+    typedef std::chrono::steady_clock Clock;
+    std::vector<std::shared_ptr<AudioLoadHandle> > handles;
+    std::atomic<bool> polled(false);
+    bool loadersBusy = false;
+    bool notReady = true;
+    double maxLoad = 0.0;
+    double maxPoll = 0.0;
+    std::thread ui([&]() {
+        for (int32 i = 0; i < files; i++) {
+            Clock::time_point start = Clock::now();
+            handles.push_back(service.Load(FakePath(("busy-" + std::to_string(i)).c_str(), frames).c_str()));
+            maxLoad = std::max(maxLoad, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        loadersBusy = WaitUntil([&]() {
+            return handles[0]->GetState() == AudioLoadHandle::kLoading
+                && handles[1]->GetState() == AudioLoadHandle::kLoading;
+        });
+        for (const std::shared_ptr<AudioLoadHandle>& handle : handles) {
+            Clock::time_point start = Clock::now();
+            notReady = !handle->IsDone() && notReady;
+            handle->GetProgress();
+            for (int32 x = 0; x < 100; x++) {
+                float low, high;
+                handle->GetPeaks(x * frames / 100, (x + 1) * frames / 100, &low, &high);
+            }
+            maxPoll = std::max(maxPoll, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        polled = true;
+    });
+
+    // Only checked against the gate, never against a clock
+    bool returned = WaitUntil([&]() { return polled.load(); });
+    bool gateClosed = sDecodeBudget.load() == 0;
+    sDecodeBudget = -1;
+    ui.join();
+
+    // Progress moves while the loads run
+    int32 progressSteps = 0;
+    float lastProgress = -1.0f;
+    while (!handles.back()->IsDone()) {
+        float progress = handles.back()->GetProgress();
+        if (progress != lastProgress) {
+            lastProgress = progress;
+            progressSteps++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    bool allReady = true;
+    for (const std::shared_ptr<AudioLoadHandle>& handle : handles) {
+        allReady = WaitDone(handle) && handle->IsReady() && allReady;
+    }
+    AudioLoaderService::Stats stats = service.GetStats();
+    service.Stop();
+
+    std::cout << "  " << files << " files of " << frames << " frames, loaders "
+              << (loadersBusy ? "stalled" : "NOT stalled") << ": requests and polls "
+              << (returned && gateClosed ? "returned" : "WAITED") << ", "
+              << (notReady ? "nothing reported ready" : "reported READY") << std::endl;
+    std::cout << "  Load() max " << std::fixed << std::setprecision(1) << maxLoad
+              << " µs, poll of 100 columns max " << maxPoll << " µs"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+    std::cout << "  " << progressSteps << " progress updates seen, "
+              << stats.framesLoaded << " frames loaded" << std::endl;
+
+    bool passed = loadersBusy && returned && gateClosed && notReady && allReady
+        && progressSteps >= 3 && stats.framesLoaded == (uint64)(frames * files);
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Audio Loader Service Tests      ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    char directory[] = "/tmp/venice-loader-XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::cout << "Cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    sDirectory = directory;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestPriorityOrder()) passed++;
+    total++; if (TestSharedRequests()) passed++;
+    total++; if (TestProgressivePeaks()) passed++;
+    total++; if (TestCancel()) passed++;
+    total++; if (TestMappedFile()) passed++;
+    total++; if (TestNonBlockingPoll(quick)) passed++;
+
+    std::string cleanup = "rm -rf '" + sDirectory + "'";
+    if (system(cleanup.c_str()) != 0) {
+        std::cout << "Could not remove " << sDirectory << std::endl;
+    }
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
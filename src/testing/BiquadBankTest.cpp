@@ -0,0 +1,311 @@
+/*
+ * BiquadBankTest.cpp - Multi-lane SIMD biquad bank vs scalar BiquadFilter
+ *
+ * Checks that DSP::BiquadBank reproduces a cascade of scalar
+ * DSP::BiquadFilter instances for every kernel the CPU supports, with
+ * lane counts that do and do not fill a SIMD group, and measures the
+ * per-sample cost of an 8-band EQ across surround channel layouts.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "../audio/BiquadBank.h"
+
+using namespace VeniceDAW::DSP;
+
+static const float kSampleRate = 48000.0f;
+static const size_t kBands = 8;
+
+class BiquadBankTest {
+public:
+    bool RunAllTests(bool quick) {
+        std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+        std::cout << "║  VeniceDAW Biquad Bank Test Suite          ║" << std::endl;
+        std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= TestMatchesScalarCascade();
+        allPassed &= TestDisabledStages();
+        allPassed &= TestProcessSample();
+        TestThroughput(quick);
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << (allPassed ? "✓ All tests PASSED" : "✗ Some tests FAILED") << std::endl;
+
+        return allPassed;
+    }
+
+private:
+    static std::vector<BiquadBank::OptimizationLevel> AvailableLevels() {
+        std::vector<BiquadBank::OptimizationLevel> levels;
+        BiquadBank probe;
+        for (int level = BiquadBank::OPT_SCALAR; level <= BiquadBank::OPT_AVX; ++level) {
+            probe.SetOptimizationLevel(static_cast<BiquadBank::OptimizationLevel>(level));
+            if (probe.GetOptimizationLevel() == level) {
+                levels.push_back(probe.GetOptimizationLevel());
+            }
+        }
+        return levels;
+    }
+
+    // A typical 8-band EQ whose settings vary a little per lane
+    static void DesignBand(BiquadFilter& filter, size_t band, size_t lane) {
+        static const BiquadFilter::FilterType types[kBands] = {
+            BiquadFilter::HighPass, BiquadFilter::LowShelf, BiquadFilter::Peak, BiquadFilter::Peak,
+            BiquadFilter::Notch, BiquadFilter::Peak, BiquadFilter::HighShelf, BiquadFilter::LowPass
+        };
+        static const float frequencies[kBands] = {40.0f, 150.0f, 400.0f, 1000.0f, 2500.0f, 5000.0f, 9000.0f, 18000.0f};
+        float frequency = std::min(20000.0f, frequencies[band] * (1.0f + 0.03f * lane));
+        float gain = (band % 2 ? 6.0f : -4.5f) + 0.25f * lane;
+        filter.CalculateCoefficients(types[band], kSampleRate, frequency, 0.7f + 0.2f * band, gain);
+    }
+
+    static void FillLane(std::vector<float>& data, size_t lane) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = 0.5f * std::sin(0.031f * i * (lane + 1)) + 0.25f * std::sin(0.0003f * i * i + lane);
+        }
+    }
+
+    bool TestMatchesScalarCascade() {
+        std::cout << "\n[TEST] Bank Matches Scalar Cascade..." << std::endl;
+
+        const size_t laneCounts[] = {1, 2, 6, 8, 11, 16};
+        const size_t frames = 3000;   // Not a multiple of the chunk size
+        bool passed = true;
+
+        for (BiquadBank::OptimizationLevel level : AvailableLevels()) {
+            for (size_t lanes : laneCounts) {
+                BiquadBank bank(lanes, kBands);
+                bank.SetOptimizationLevel(level);
+
+                std::vector<std::array<BiquadFilter, kBands>> reference(lanes);
+                std::vector<std::vector<float>> data(lanes, std::vector<float>(frames));
+                std::vector<std::vector<float>> expected(lanes, std::vector<float>(frames));
+                std::vector<float*> pointers(lanes);
+
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    for (size_t band = 0; band < kBands; ++band) {
+                        DesignBand(reference[lane][band], band, lane);
+                        bank.SetCoefficients(band, lane, reference[lane][band]);
+                    }
+                    FillLane(data[lane], lane);
+                    for (size_t i = 0; i < frames; ++i) {
+                        float sample = data[lane][i];
+                        for (size_t band = 0; band < kBands; ++band) {
+                            sample = reference[lane][band].ProcessSample(sample);
+                        }
+                        expected[lane][i] = sample;
+                    }
+                    pointers[lane] = data[lane].data();
+                }
+
+                // Uneven host block sizes exercise state carried across calls
+                size_t offset = 0;
+                const size_t blockSizes[] = {1, 37, 256, 64, 1000};
+                for (size_t b = 0; offset < frames; ++b) {
+                    size_t n = std::min(blockSizes[b % 5], frames - offset);
+                    std::vector<float*> shifted(lanes);
+                    for (size_t lane = 0; lane < lanes; ++lane) shifted[lane] = pointers[lane] + offset;
+                    bank.Process(shifted.data(), n);
+                    offset += n;
+                }
+
+                // Error relative to the output peak. The bank sums the
+                // terms in a different order, and the low-frequency
+                // high-pass amplifies that rounding to ~1e-4 under
+                // -ffast-math, hence the tolerance.
+                float maxError = 0.0f, peak = 0.0f;
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    for (size_t i = 0; i < frames; ++i) {
+                        maxError = std::max(maxError, std::abs(data[lane][i] - expected[lane][i]));
+                        peak = std::max(peak, std::abs(expected[lane][i]));
+                    }
+                }
+                maxError /= std::max(peak, 1e-6f);
+
+                bool ok = maxError < 1e-3f;
+                passed &= ok;
+                std::cout << "  " << std::setw(6) << bank.GetOptimizationName() << " lanes="
+                          << std::setw(2) << lanes << " max rel. error " << std::scientific
+                          << std::setprecision(2) << maxError << std::fixed << (ok ? "" : "  ✗") << std::endl;
+            }
+        }
+
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestDisabledStages() {
+        std::cout << "\n[TEST] Disabled Stages Are Skipped..." << std::endl;
+
+        const size_t lanes = 5;
+        const size_t frames = 512;
+        BiquadBank bank(lanes, kBands);
+        BiquadFilter peak;
+        peak.CalculateCoefficients(BiquadFilter::Peak, kSampleRate, 1000.0f, 1.0f, 9.0f);
+        for (size_t band = 0; band < kBands; ++band) {
+            bank.SetStageCoefficients(band, peak);
+            bank.SetStageEnabled(band, false);
+        }
+
+        std::vector<std::vector<float>> data(lanes, std::vector<float>(frames));
+        std::vector<float*> pointers(lanes);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            FillLane(data[lane], lane);
+            pointers[lane] = data[lane].data();
+        }
+        std::vector<std::vector<float>> original = data;
+
+        bank.Process(pointers.data(), frames);
+        bool passed = (data == original);
+
+        // One enabled stage equals one scalar filter
+        bank.SetStageEnabled(3, true);
+        bank.Process(pointers.data(), frames);
+        float maxError = 0.0f;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            BiquadFilter reference;
+            reference.CalculateCoefficients(BiquadFilter::Peak, kSampleRate, 1000.0f, 1.0f, 9.0f);
+            for (size_t i = 0; i < frames; ++i) {
+                float expected = reference.ProcessSample(original[lane][i]);
+                maxError = std::max(maxError, std::abs(expected - data[lane][i]));
+            }
+        }
+        passed &= maxError < 1e-5f;
+
+        std::cout << "  All disabled: " << (data.size() == lanes ? "pass-through" : "") << std::endl;
+        std::cout << "  One enabled max error: " << std::scientific << std::setprecision(2)
+                  << maxError << std::fixed << std::endl;
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestProcessSample() {
+        std::cout << "\n[TEST] Per-Sample Path Matches Block Path..." << std::endl;
+
+        const size_t lanes = 3;
+        const size_t frames = 700;
+        BiquadBank blockBank(lanes, kBands);
+        BiquadBank sampleBank(lanes, kBands);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            for (size_t band = 0; band < kBands; ++band) {
+                BiquadFilter filter;
+                DesignBand(filter, band, lane);
+                blockBank.SetCoefficients(band, lane, filter);
+                sampleBank.SetCoefficients(band, lane, filter);
+            }
+        }
+
+        std::vector<std::vector<float>> data(lanes, std::vector<float>(frames));
+        std::vector<float*> pointers(lanes);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            FillLane(data[lane], lane);
+            pointers[lane] = data[lane].data();
+        }
+        std::vector<std::vector<float>> input = data;
+        blockBank.Process(pointers.data(), frames);
+
+        float maxError = 0.0f, peak = 0.0f;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            for (size_t i = 0; i < frames; ++i) {
+                float y = sampleBank.ProcessSample(lane, input[lane][i]);
+                maxError = std::max(maxError, std::abs(y - data[lane][i]));
+                peak = std::max(peak, std::abs(data[lane][i]));
+            }
+        }
+        maxError /= std::max(peak, 1e-6f);
+
+        bool passed = maxError < 1e-3f;
+        std::cout << "  Max rel. error: " << std::scientific << std::setprecision(2) << maxError
+                  << std::fixed << std::endl;
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    void TestThroughput(bool quick) {
+        std::cout << "\n[BENCH] 8-band EQ, ns per channel-sample..." << std::endl;
+        std::cout << std::setw(10) << "channels" << std::setw(10) << "scalar";
+        std::vector<BiquadBank::OptimizationLevel> levels = AvailableLevels();
+        for (BiquadBank::OptimizationLevel level : levels) {
+            BiquadBank probe;
+            probe.SetOptimizationLevel(level);
+            std::cout << std::setw(10) << probe.GetOptimizationName();
+        }
+        std::cout << std::setw(10) << "speedup" << std::endl;
+
+        const size_t channelCounts[] = {2, 6, 8, 16};
+        const size_t block = 256;
+        const size_t totalFrames = quick ? 48000 : 480000;
+
+        for (size_t channels : channelCounts) {
+            std::vector<std::vector<float>> data(channels, std::vector<float>(block));
+            std::vector<float*> pointers(channels);
+            for (size_t c = 0; c < channels; ++c) {
+                FillLane(data[c], c);
+                pointers[c] = data[c].data();
+            }
+
+            // Scalar reference: one filter array per channel, as ProfessionalEQ used to
+            std::vector<std::array<BiquadFilter, kBands>> filters(channels);
+            for (size_t c = 0; c < channels; ++c) {
+                for (size_t band = 0; band < kBands; ++band) DesignBand(filters[c][band], band, c);
+            }
+            volatile float sink = 0.0f;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t done = 0; done < totalFrames; done += block) {
+                for (size_t c = 0; c < channels; ++c) {
+                    float* samples = pointers[c];
+                    for (size_t i = 0; i < block; ++i) {
+                        float sample = samples[i];
+                        for (size_t band = 0; band < kBands; ++band) {
+                            sample = filters[c][band].ProcessSample(sample);
+                        }
+                        samples[i] = sample;
+                    }
+                }
+                sink = sink + pointers[0][0];
+            }
+            double scalarNs = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count() / (totalFrames * channels);
+
+            std::cout << std::setw(10) << channels << std::fixed << std::setprecision(2)
+                      << std::setw(10) << scalarNs;
+
+            double bestNs = scalarNs;
+            for (BiquadBank::OptimizationLevel level : levels) {
+                BiquadBank bank(channels, kBands);
+                bank.SetOptimizationLevel(level);
+                for (size_t c = 0; c < channels; ++c) {
+                    for (size_t band = 0; band < kBands; ++band) bank.SetCoefficients(band, c, filters[c][band]);
+                }
+                start = std::chrono::steady_clock::now();
+                for (size_t done = 0; done < totalFrames; done += block) {
+                    bank.Process(pointers.data(), block);
+                    sink = sink + pointers[0][0];
+                }
+                double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count() / (totalFrames * channels);
+                bestNs = std::min(bestNs, ns);
+                std::cout << std::setw(10) << ns;
+            }
+            std::cout << std::setw(9) << std::setprecision(1) << scalarNs / bestNs << "x" << std::endl;
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    BiquadBankTest tester;
+    bool success = tester.RunAllTests(quick);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+/*
+ * CompressedSampleStoreTest.cpp - Lossless block-compressed sample cache
+ *
+ * Round-trips signals that stress every coding path (silence, tones, noise
+ * that does not compress, full-scale extremes, every block length) and
+ * checks that decoding is exact. Then measures the compression ratio on
+ * music-like material, checks that random reads decode only the blocks
+ * they touch, that resampled playback from the store matches playback
+ * from the int16 vector, that AudioSampleCache round-trips through
+ * Compress() and LoadSamples(), and that decoding is fast enough for
+ * many tracks at once.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "../audio/CompressedSampleStore.h"
+#include "../audio/AudioSampleCache.h"
+#include "../audio/PolyphaseResampler.h"
+#include "TestSignals.h"
+
+using namespace VeniceDAW;
+
+static const int64 kBlockFrames = CompressedSampleStore::kBlockFrames;
+
+static std::vector<int16_t> Decode(const CompressedSampleStore& store)
+{
+    std::vector<int16_t> decoded(store.CountFrames() * 2);
+    CompressedSampleStore::BlockCache cache;
+    store.ReadFrames(0, decoded.data(), store.CountFrames(), cache);
+    return decoded;
+}
+
+static bool TestLosslessRoundTrip()
+{
+    std::cout << "\n[TEST] Every signal and block length decodes exactly" << std::endl;
+
+    struct Signal {
+        const char* name;
+        std::vector<int16_t> samples;
+    };
+    std::vector<Signal> signals;
+
+    const int64 lengths[] = { 1, 3, kBlockFrames - 1, kBlockFrames, kBlockFrames + 1, 50000 };
+    for (int64 frames : lengths) {
+        std::vector<int16_t> silence(frames * 2, 0);
+        std::vector<int16_t> noise(frames * 2);
+        std::vector<int16_t> extremes(frames * 2);
+        std::vector<int16_t> opposite(frames * 2);
+        std::vector<int16_t> sine(frames * 2);
+        for (int64 i = 0; i < frames; i++) {
+            noise[i * 2] = (int16_t)Random();
+            noise[i * 2 + 1] = (int16_t)Random();
+            // Full-scale square and alternation, the worst cases for the
+            // predictors and for side = L - R
+            extremes[i * 2] = (i / 7) % 2 ? 32767 : -32768;
+            extremes[i * 2 + 1] = i % 2 ? -32768 : 32767;
+            opposite[i * 2] = Random() % 3 ? 32767 : -32768;
+            opposite[i * 2 + 1] = (int16_t)(-1 - opposite[i * 2]);
+            sine[i * 2] = Clamp(32767.0 * std::sin(i * 0.01));
+            sine[i * 2 + 1] = Clamp(32767.0 * std::sin(i * 0.01 + 0.5));
+        }
+        signals.push_back({ "silence", silence });
+        signals.push_back({ "noise", noise });
+        signals.push_back({ "extremes", extremes });
+        signals.push_back({ "opposite", opposite });
+        signals.push_back({ "sine", sine });
+        signals.push_back({ "music", MusicLike(frames) });
+    }
+
+    int32 failures = 0;
+    for (const Signal& signal : signals) {
+        int64 frames = signal.samples.size() / 2;
+
+        CompressedSampleStore assigned;
+        assigned.Assign(signal.samples.data(), frames);
+
+        // Appended in uneven pieces, as a decoder delivers them
+        CompressedSampleStore appended;
+        for (int64 frame = 0; frame < frames; ) {
+            int64 count = std::min<int64>(frames - frame, 1 + Random() % 3000);
+            appended.Append(signal.samples.data() + frame * 2, count);
+            frame += count;
+        }
+        appended.Finish();
+
+        if (assigned.CountFrames() != frames || Decode(assigned) != signal.samples
+            || appended.CountFrames() != frames || Decode(appended) != signal.samples) {
+            std::cout << "  Mismatch: " << signal.name << ", " << frames << " frames" << std::endl;
+            failures++;
+        }
+    }
+
+    std::cout << "  " << signals.size() - failures << "/" << signals.size()
+              << " signals round-tripped exactly" << std::endl;
+
+    bool passed = failures == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestCompressionRatio()
+{
+    std::cout << "\n[TEST] Compression ratio" << std::endl;
+
+    const int64 frames = 44100 * 20;
+    std::vector<int16_t> music = MusicLike(frames);
+    std::vector<int16_t> noise(frames * 2);
+    for (int16_t& sample : noise) {
+        sample = (int16_t)Random();
+    }
+    std::vector<int16_t> silence(frames * 2, 0);
+
+    CompressedSampleStore musicStore;
+    CompressedSampleStore noiseStore;
+    CompressedSampleStore silenceStore;
+    musicStore.Assign(music.data(), frames);
+    noiseStore.Assign(noise.data(), frames);
+    silenceStore.Assign(silence.data(), frames);
+
+    double musicRatio = (double)musicStore.GetCompressedBytes() / musicStore.GetUncompressedBytes();
+    double noiseRatio = (double)noiseStore.GetCompressedBytes() / noiseStore.GetUncompressedBytes();
+    double silenceRatio = (double)silenceStore.GetCompressedBytes() / silenceStore.GetUncompressedBytes();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  Music-like: " << musicRatio * 100.0 << "% of int16 ("
+              << musicStore.GetUncompressedBytes() / 1024 << " KB -> "
+              << musicStore.GetCompressedBytes() / 1024 << " KB)" << std::endl;
+    std::cout << "  White noise: " << noiseRatio * 100.0 << "% (stored verbatim)" << std::endl;
+    std::cout << std::setprecision(2)
+              << "  Silence:     " << silenceRatio * 100.0 << "%" << std::endl;
+
+    bool passed = musicRatio < 0.65 && noiseRatio < 1.001 && silenceRatio < 0.01;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRandomAccess()
+{
+    std::cout << "\n[TEST] Random reads decode only the blocks they touch" << std::endl;
+
+    const int64 frames = 300000;
+    std::vector<int16_t> music = MusicLike(frames);
+    CompressedSampleStore store;
+    store.Assign(music.data(), frames);
+
+    // Random reads, some crossing block boundaries, some past the end
+    CompressedSampleStore::BlockCache cache(2);
+    std::vector<int16_t> dest(10000 * 2);
+    int32 failures = 0;
+    for (int32 i = 0; i < 2000; i++) {
+        int64 frame = Random() % (frames + 100);
+        int64 count = 1 + Random() % 10000;
+        int64 expected = std::max<int64>(0, std::min(count, frames - frame));
+        int64 read = store.ReadFrames(frame, dest.data(), count, cache);
+        if (read != expected
+            || (read > 0 && memcmp(dest.data(), music.data() + frame * 2, read * 4) != 0)) {
+            failures++;
+        }
+    }
+
+    // Reading one frame in the middle decodes one block, and a second read
+    // of the same block hits the cache
+    CompressedSampleStore::BlockCache single;
+    int16_t frame[2];
+    store.ReadFrames(150000, frame, 1, single);
+    store.ReadFrames(150001, frame, 1, single);
+    bool singleBlock = single.Misses() == 1 && single.Hits() == 1;
+
+    // Playing through in small chunks decodes every block exactly once
+    CompressedSampleStore::BlockCache playback;
+    for (int64 position = 0; position < frames; position += 256) {
+        store.ReadFrames(position, dest.data(), 256, playback);
+    }
+    bool sequential = (int64)playback.Misses() == store.CountBlocks();
+
+    // Two readers interleaved share the default cache without thrashing
+    CompressedSampleStore::BlockCache shared;
+    for (int64 position = 0; position < frames / 2; position += 512) {
+        store.ReadFrames(position, dest.data(), 512, shared);
+        store.ReadFrames(position + frames / 2, dest.data(), 512, shared);
+    }
+    bool twoReaders = shared.Misses() <= (uint64)store.CountBlocks() + 2;
+
+    std::cout << "  Random reads: " << 2000 - failures << "/2000 exact" << std::endl;
+    std::cout << "  Single frame: " << single.Misses() << " block decoded, "
+              << single.Hits() << " hit" << std::endl;
+    std::cout << "  Sequential:   " << playback.Misses() << " decodes for "
+              << store.CountBlocks() << " blocks" << std::endl;
+    std::cout << "  Two readers:  " << shared.Misses() << " decodes" << std::endl;
+
+    bool passed = failures == 0 && singleBlock && sequential && twoReaders;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRenderMatchesSamples()
+{
+    std::cout << "\n[TEST] Resampled playback from the store matches the int16 vector" << std::endl;
+
+    const int64 frames = 200000;
+    std::vector<int16_t> music = MusicLike(frames);
+    CompressedSampleStore store;
+    store.Assign(music.data(), frames);
+
+    const double outputRates[] = { 44100.0, 48000.0, 22050.0, 96000.0 };
+    const double positions[] = { 0.0, 4095.5, 12345.678, (double)frames - 300.25, (double)frames - 3.5 };
+    const size_t blockSizes[] = { 256, 4096 };
+
+    float maxError = 0.0f;
+    int32 countMismatches = 0;
+    std::vector<float> compressed(4096 * 2);
+    std::vector<float> reference(4096 * 2);
+    CompressedSampleStore::BlockCache cache;
+
+    for (double outputRate : outputRates) {
+        DSP::PolyphaseResampler a(2, DSP::PolyphaseResampler::QUALITY_BALANCED, 4096);
+        DSP::PolyphaseResampler b(2, DSP::PolyphaseResampler::QUALITY_BALANCED, 4096);
+        a.SetRates(44100.0, outputRate);
+        b.SetRates(44100.0, outputRate);
+
+        for (double position : positions) {
+            for (size_t block : blockSizes) {
+                size_t insideCompressed = a.RenderFrom(
+                    [&](int64 frame, int16_t* dest, int64 count) {
+                        return store.ReadFrames(frame, dest, count, cache);
+                    },
+                    frames, position, compressed.data(), block);
+                size_t insideSamples = b.Render(music.data(), frames, position,
+                                                reference.data(), block);
+                if (insideCompressed != insideSamples) {
+                    countMismatches++;
+                }
+                for (size_t i = 0; i < block * 2; i++) {
+                    maxError = std::max(maxError, std::fabs(compressed[i] - reference[i]));
+                }
+            }
+        }
+    }
+
+    std::cout << std::defaultfloat << std::setprecision(6)
+              << "  Max difference: " << maxError << ", frame count mismatches: "
+              << countMismatches << std::endl;
+
+    bool passed = maxError < 1e-5f && countMismatches == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestSampleCacheRoundTrip()
+{
+    std::cout << "\n[TEST] AudioSampleCache compresses, draws and edits losslessly" << std::endl;
+
+    const int64 frames = 100000;
+    AudioSampleCache cache;
+    cache.samples = MusicLike(frames);
+    cache.sampleRate = 44100.0f;
+    cache.isValid = true;
+    std::vector<int16_t> original = cache.samples;
+
+    // Waveform queries before and after compression
+    const int32 kQueries = 64;
+    std::vector<float> before(kQueries * 2);
+    for (int32 i = 0; i < kQueries; i++) {
+        cache.GetSample(i * 0.035f, 0.01f, &before[i * 2], &before[i * 2 + 1]);
+    }
+
+    bool compressed = cache.Compress();
+    bool freed = cache.samples.empty() && cache.samples.capacity() == 0 && cache.compressed;
+    bool sizeKept = cache.GetFrameCount() == frames && !cache.IsEmpty();
+
+    bool sameWaveform = true;
+    for (int32 i = 0; i < kQueries; i++) {
+        float low, high;
+        cache.GetSample(i * 0.035f, 0.01f, &low, &high);
+        sameWaveform = sameWaveform && low == before[i * 2] && high == before[i * 2 + 1];
+    }
+
+    std::vector<int16_t> read(frames * 2);
+    bool sameFrames = cache.ReadFrames(0, read.data(), frames) == frames && read == original;
+
+    // Editing decodes back into samples first
+    bool edited = cache.Reverse() && !cache.compressed && cache.samples.size() == original.size();
+    bool reversed = edited;
+    for (int64 i = 0; reversed && i < frames; i++) {
+        reversed = cache.samples[i * 2] == original[(frames - 1 - i) * 2]
+                   && cache.samples[i * 2 + 1] == original[(frames - 1 - i) * 2 + 1];
+    }
+
+    std::cout << "  Compressed and freed: " << (compressed && freed && sizeKept ? "yes" : "no")
+              << ", waveform identical: " << (sameWaveform ? "yes" : "no")
+              << ", frames identical: " << (sameFrames ? "yes" : "no")
+              << ", reversed after decode: " << (reversed ? "yes" : "no") << std::endl;
+
+    bool passed = compressed && freed && sizeKept && sameWaveform && sameFrames && reversed;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestDecodeSpeed(bool quick)
+{
+    std::cout << "\n[TEST] Decoding speed" << std::endl;
+
+    const int64 frames = 44100 * (quick ? 10 : 60);
+    std::vector<int16_t> music = MusicLike(frames);
+    CompressedSampleStore store;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    store.Assign(music.data(), frames);
+    auto encoded = std::chrono::high_resolution_clock::now();
+
+    std::vector<int16_t> block(kBlockFrames * 2);
+    int64 total = 0;
+    for (int64 i = 0; i < store.CountBlocks(); i++) {
+        total += store.DecodeBlock(i, block.data());
+    }
+    auto decoded = std::chrono::high_resolution_clock::now();
+
+    double audioSeconds = (double)frames / 44100.0;
+    double encodeSeconds = std::chrono::duration<double>(encoded - start).count();
+    double decodeSeconds = std::chrono::duration<double>(decoded - encoded).count();
+    double realtime = audioSeconds / std::max(decodeSeconds, 1e-9);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  " << audioSeconds << " s of stereo audio: encode "
+              << encodeSeconds * 1000.0 << " ms, decode " << decodeSeconds * 1000.0
+              << " ms (" << std::setprecision(0) << realtime << "x realtime)" << std::endl;
+
+    // One core must decode far more tracks than a session plays
+    bool passed = total == frames && realtime > 200.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Compressed Sample Cache Tests   ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestLosslessRoundTrip()) passed++;
+    total++; if (TestCompressionRatio()) passed++;
+    total++; if (TestRandomAccess()) passed++;
+    total++; if (TestRenderMatchesSamples()) passed++;
+    total++; if (TestSampleCacheRoundTrip()) passed++;
+    total++; if (TestDecodeSpeed(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #include <iomanip>
 #include <cmath>
 #include <vector>
+#include <chrono>
 #include "../audio/AdvancedAudioProcessor.h"
 
 #ifndef M_PI
@@ -29,6 +30,8 @@ public:
         allPassed &= TestMakeupGain();
         allPassed &= TestLookaheadLimiting();
         
+        TestThroughput();
+        
         std::cout << "\n=== Test Summary ===" << std::endl;
         std::cout << (allPassed ? "✓ All tests PASSED" : "✗ Some tests FAILED") << std::endl;
         
@@ -513,6 +516,48 @@ private:
         
         return passed;
     }
+    
+    void TestThroughput() {
+        std::cout << "\n[BENCH] Dynamics per channel-sample (stereo, 256-frame blocks)..." << std::endl;
+        
+        struct Setup {
+            const char* name;
+            DynamicsProcessor::Mode mode;
+            bool lookahead;
+        };
+        const Setup setups[] = {
+            {"Compressor", DynamicsProcessor::Mode::COMPRESSOR, false},
+            {"Limiter", DynamicsProcessor::Mode::LIMITER, false},
+            {"Gate", DynamicsProcessor::Mode::GATE, false},
+            {"Lookahead limiter", DynamicsProcessor::Mode::LIMITER, true}
+        };
+        const size_t blockSize = 256;
+        const size_t blocks = 800;
+        
+        for (const Setup& setup : setups) {
+            DynamicsProcessor processor;
+            processor.Initialize(48000.0f);
+            processor.SetBypassed(false);
+            processor.SetMode(setup.mode);
+            processor.SetParameter("threshold", -18.0f);
+            processor.SetParameter("makeup", 3.0f);
+            processor.SetParameter("lookahead_enabled", setup.lookahead ? 1.0f : 0.0f);
+            
+            AdvancedAudioBuffer buffer(kStereo, blockSize, 48000.0f);
+            for (size_t c = 0; c < buffer.GetChannelCount(); ++c) {
+                float* data = buffer.GetChannelData(c);
+                for (size_t i = 0; i < blockSize; ++i) data[i] = 0.5f * std::sin(0.05f * i * (c + 1));
+            }
+            
+            auto start = std::chrono::steady_clock::now();
+            for (size_t block = 0; block < blocks; ++block) processor.Process(buffer);
+            double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            
+            std::cout << "  " << std::left << std::setw(18) << setup.name << std::right
+                      << std::fixed << std::setprecision(2)
+                      << nanos / (blocks * blockSize * buffer.GetChannelCount()) << " ns" << std::endl;
+        }
+    }
 };
 
 int main() {
@@ -0,0 +1,301 @@
+/*
+ * FFTTest.cpp - Accuracy and throughput tests for DSP::FFT
+ *
+ * Compares complex and real transforms of power-of-two and mixed-radix
+ * sizes against a double-precision reference DFT, for every kernel the
+ * CPU supports, checks that executing a plan does not allocate, and
+ * reports transform throughput.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "../audio/FFT.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace VeniceDAW::DSP;
+
+// Counts heap allocations so the test can prove plans execute allocation-free
+static size_t gAllocationCount = 0;
+
+void* operator new(size_t size)
+{
+    ++gAllocationCount;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+class FFTTest {
+public:
+    bool RunAllTests(bool quick) {
+        std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+        std::cout << "║  VeniceDAW FFT Test Suite                  ║" << std::endl;
+        std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+        std::cout << "SSE2: " << (FFT::HasSSE2Support() ? "yes" : "no")
+                  << ", AVX: " << (FFT::HasAVXSupport() ? "yes" : "no") << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= TestSupportedSizes();
+        allPassed &= TestComplexAccuracy();
+        allPassed &= TestRealAccuracy();
+        allPassed &= TestRoundTrip();
+        allPassed &= TestNoAllocation();
+        TestThroughput(quick);
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << (allPassed ? "✓ All tests PASSED" : "✗ Some tests FAILED") << std::endl;
+
+        return allPassed;
+    }
+
+private:
+    static std::vector<FFT::OptimizationLevel> AvailableLevels() {
+        std::vector<FFT::OptimizationLevel> levels;
+        levels.push_back(FFT::OPT_SCALAR);
+        if (FFT::HasSSE2Support()) levels.push_back(FFT::OPT_SSE2);
+        if (FFT::HasAVXSupport()) levels.push_back(FFT::OPT_AVX);
+        return levels;
+    }
+
+    static void FillSignal(std::vector<float>& data, unsigned seed) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = std::sin(0.731f * i + seed) * 0.6f + std::cos(0.0137f * i * i + seed) * 0.3f;
+        }
+    }
+
+    // Reference DFT in double precision; interleaved complex in and out
+    static void ReferenceDFT(const std::vector<float>& in, std::vector<double>& out, size_t n) {
+        out.assign(2 * n, 0.0);
+        for (size_t k = 0; k < n; ++k) {
+            double re = 0.0, im = 0.0;
+            for (size_t t = 0; t < n; ++t) {
+                double angle = -2.0 * M_PI * static_cast<double>((k * t) % n) / n;
+                double c = std::cos(angle), s = std::sin(angle);
+                re += in[2 * t] * c - in[2 * t + 1] * s;
+                im += in[2 * t] * s + in[2 * t + 1] * c;
+            }
+            out[2 * k] = re;
+            out[2 * k + 1] = im;
+        }
+    }
+
+    // Error relative to the reference's RMS magnitude
+    static double RelativeError(const float* result, const std::vector<double>& reference, size_t count) {
+        double errorEnergy = 0.0, refEnergy = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double d = result[i] - reference[i];
+            errorEnergy += d * d;
+            refEnergy += reference[i] * reference[i];
+        }
+        return refEnergy > 0.0 ? std::sqrt(errorEnergy / refEnergy) : std::sqrt(errorEnergy);
+    }
+
+    bool TestSupportedSizes() {
+        std::cout << "\n[TEST] Supported Sizes..." << std::endl;
+
+        bool passed = FFT::IsSupportedSize(1024, FFT::Real)
+                   && FFT::IsSupportedSize(480, FFT::Real)
+                   && FFT::IsSupportedSize(1000, FFT::Complex)
+                   && FFT::IsSupportedSize(15, FFT::Complex)
+                   && !FFT::IsSupportedSize(15, FFT::Real)      // odd
+                   && !FFT::IsSupportedSize(14, FFT::Real)      // half has factor 7
+                   && !FFT::IsSupportedSize(0, FFT::Complex)
+                   && !FFT::IsSupportedSize(77, FFT::Complex);
+
+        // Unsupported plans are inert and produce silence
+        FFT invalid(14, FFT::Real);
+        std::vector<float> input(14, 1.0f), spectrum(invalid.GetSpectrumSize(), 1.0f);
+        invalid.ForwardReal(input.data(), spectrum.data());
+        for (float v : spectrum) passed &= (v == 0.0f);
+        passed &= !invalid.IsValid();
+
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestComplexAccuracy() {
+        std::cout << "\n[TEST] Complex Transform Accuracy..." << std::endl;
+
+        const size_t sizes[] = {1, 2, 3, 5, 8, 12, 15, 60, 64, 100, 240, 1000, 1024, 4096};
+        const double tolerance = 1e-5;
+        bool passed = true;
+
+        for (size_t n : sizes) {
+            std::vector<float> input(2 * n);
+            FillSignal(input, static_cast<unsigned>(n));
+            std::vector<double> reference;
+            ReferenceDFT(input, reference, n);
+
+            FFT fft(n, FFT::Complex);
+            for (FFT::OptimizationLevel level : AvailableLevels()) {
+                fft.SetOptimizationLevel(level);
+                std::vector<float> output(2 * n);
+                fft.Forward(input.data(), output.data());
+                double error = RelativeError(output.data(), reference, 2 * n);
+                bool ok = fft.IsValid() && error < tolerance;
+                passed &= ok;
+                std::cout << "  N=" << std::setw(5) << n << " " << std::setw(6) << fft.GetOptimizationName()
+                          << " rel. error " << std::scientific << std::setprecision(2) << error
+                          << std::fixed << (ok ? "" : "  ✗") << std::endl;
+            }
+        }
+
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestRealAccuracy() {
+        std::cout << "\n[TEST] Real Transform Accuracy..." << std::endl;
+
+        const size_t sizes[] = {2, 16, 30, 120, 480, 1024, 4096};
+        const double tolerance = 1e-5;
+        bool passed = true;
+
+        for (size_t n : sizes) {
+            std::vector<float> real(n);
+            FillSignal(real, static_cast<unsigned>(n) + 7);
+            std::vector<float> complexInput(2 * n, 0.0f);
+            for (size_t i = 0; i < n; ++i) complexInput[2 * i] = real[i];
+            std::vector<double> reference;
+            ReferenceDFT(complexInput, reference, n);
+            reference.resize(n + 2);   // Bins 0..n/2
+
+            FFT fft(n, FFT::Real);
+            for (FFT::OptimizationLevel level : AvailableLevels()) {
+                fft.SetOptimizationLevel(level);
+                std::vector<float> spectrum(fft.GetSpectrumSize());
+                fft.ForwardReal(real.data(), spectrum.data());
+                double error = RelativeError(spectrum.data(), reference, n + 2);
+                bool ok = fft.IsValid() && error < tolerance;
+                passed &= ok;
+                std::cout << "  N=" << std::setw(5) << n << " " << std::setw(6) << fft.GetOptimizationName()
+                          << " rel. error " << std::scientific << std::setprecision(2) << error
+                          << std::fixed << (ok ? "" : "  ✗") << std::endl;
+            }
+        }
+
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestRoundTrip() {
+        std::cout << "\n[TEST] Round Trip (Inverse(Forward(x)) == x)..." << std::endl;
+
+        bool passed = true;
+        const size_t sizes[] = {48, 96, 960, 2048, 4800};
+
+        for (size_t n : sizes) {
+            std::vector<float> real(n), spectrum(n + 2), back(n);
+            FillSignal(real, 3);
+            FFT realFFT(n, FFT::Real);
+            realFFT.ForwardReal(real.data(), spectrum.data());
+            realFFT.InverseReal(spectrum.data(), back.data());
+
+            float maxError = 0.0f;
+            for (size_t i = 0; i < n; ++i) maxError = std::max(maxError, std::abs(back[i] - real[i]));
+
+            // In-place complex round trip
+            std::vector<float> data(2 * n), original;
+            FillSignal(data, 5);
+            original = data;
+            FFT complexFFT(n, FFT::Complex);
+            complexFFT.Forward(data.data(), data.data());
+            complexFFT.Inverse(data.data(), data.data());
+            for (size_t i = 0; i < 2 * n; ++i) maxError = std::max(maxError, std::abs(data[i] - original[i]));
+
+            bool ok = maxError < 1e-5f;
+            passed &= ok;
+            std::cout << "  N=" << std::setw(5) << n << " max error " << std::scientific
+                      << std::setprecision(2) << maxError << std::fixed << (ok ? "" : "  ✗") << std::endl;
+        }
+
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    bool TestNoAllocation() {
+        std::cout << "\n[TEST] Plan Execution Is Allocation-Free..." << std::endl;
+
+        FFT realFFT(1920, FFT::Real);
+        FFT complexFFT(1000, FFT::Complex);
+        std::vector<float> real(1920), spectrum(realFFT.GetSpectrumSize()), complexData(2000);
+        std::vector<float> accumulator(spectrum.size(), 0.0f);
+        FillSignal(real, 1);
+        FillSignal(complexData, 2);
+
+        size_t before = gAllocationCount;
+        for (int i = 0; i < 10; ++i) {
+            realFFT.ForwardReal(real.data(), spectrum.data());
+            FFT::MultiplyAccumulate(spectrum.data(), spectrum.data(), accumulator.data(), spectrum.size() / 2);
+            realFFT.InverseReal(spectrum.data(), real.data());
+            complexFFT.Forward(complexData.data(), complexData.data());
+            complexFFT.Inverse(complexData.data(), complexData.data());
+        }
+        size_t allocations = gAllocationCount - before;
+
+        bool passed = allocations == 0;
+        std::cout << "  Allocations during 50 transforms: " << allocations << std::endl;
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+
+    void TestThroughput(bool quick) {
+        std::cout << "\n[BENCH] Throughput (real forward + inverse)..." << std::endl;
+        std::cout << std::setw(8) << "N" << std::setw(8) << "kernel"
+                  << std::setw(14) << "ns/transform" << std::setw(10) << "MFLOPS" << std::endl;
+
+        const size_t sizes[] = {128, 480, 1024, 2048, 3840, 8192, 16384};
+        const size_t budget = quick ? 4000000 : 40000000;
+
+        for (size_t n : sizes) {
+            FFT fft(n, FFT::Real);
+            std::vector<float> signal(n), spectrum(fft.GetSpectrumSize());
+            FillSignal(signal, 9);
+            size_t iterations = std::max<size_t>(16, budget / n);
+
+            for (FFT::OptimizationLevel level : AvailableLevels()) {
+                fft.SetOptimizationLevel(level);
+                volatile float sink = 0.0f;
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < iterations; ++i) {
+                    fft.ForwardReal(signal.data(), spectrum.data());
+                    fft.InverseReal(spectrum.data(), signal.data());
+                    sink = sink + signal[0];
+                }
+                auto end = std::chrono::steady_clock::now();
+
+                double nanos = std::chrono::duration<double, std::nano>(end - start).count()
+                             / (2.0 * iterations);
+                // Conventional real-FFT flop count: 2.5 N log2 N
+                double mflops = 2.5 * n * std::log2(static_cast<double>(n)) / nanos * 1000.0;
+                std::cout << std::setw(8) << n << std::setw(8) << fft.GetOptimizationName()
+                          << std::fixed << std::setprecision(1)
+                          << std::setw(14) << nanos << std::setw(10) << mflops << std::endl;
+            }
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    FFTTest tester;
+    bool success = tester.RunAllTests(quick);
+
+    return success ? 0 : 1;
+}
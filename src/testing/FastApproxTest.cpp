@@ -0,0 +1,285 @@
+/*
+ * FastApproxTest.cpp - Error bounds and throughput of DSP::FastApprox
+ *
+ * Sweeps every approximation densely over its documented domain against
+ * the double-precision <cmath> result, for both the scalar and the block
+ * (SIMD) entry points, and fails if the error exceeds the bound documented
+ * in FastApprox.h. Then times block evaluation against the std:: calls the
+ * dynamics and clipping code used before.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include "../audio/FastApprox.h"
+
+using namespace VeniceDAW::DSP;
+
+typedef void (*BlockFunction)(const float*, float*, size_t);
+typedef float (*ScalarFunction)(float);
+
+struct ErrorCase {
+    const char* name;
+    ScalarFunction scalar;
+    BlockFunction block;
+    std::function<double(double)> reference;
+    std::vector<float> inputs;
+    bool relative;
+    double bound;
+};
+
+static std::vector<float> Linear(float lo, float hi, size_t count)
+{
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = lo + (hi - lo) * static_cast<float>(i) / static_cast<float>(count - 1);
+    }
+    return values;
+}
+
+static std::vector<float> Logarithmic(float lo, float hi, size_t count)
+{
+    std::vector<float> values(count);
+    double ratio = std::log(static_cast<double>(hi) / lo);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<float>(lo * std::exp(ratio * i / (count - 1)));
+    }
+    return values;
+}
+
+static double MeasureError(const ErrorCase& c, const std::vector<float>& results)
+{
+    double maxError = 0.0;
+    for (size_t i = 0; i < c.inputs.size(); ++i) {
+        double expected = c.reference(c.inputs[i]);
+        double error = std::abs(results[i] - expected);
+        if (c.relative) {
+            error /= std::abs(expected);
+        } else {
+            // Absolute near zero; large results are limited by float
+            // resolution of the result itself, so compare relatively
+            error /= std::max(1.0, std::abs(expected));
+        }
+        maxError = std::max(maxError, error);
+    }
+    return maxError;
+}
+
+static bool TestErrorBounds()
+{
+    std::cout << "\n[TEST] Approximation error bounds (" << FastApprox::GetKernelName()
+              << " block kernel)..." << std::endl;
+
+    const size_t kPoints = 400003;  // Odd so block tails are exercised
+    std::vector<ErrorCase> cases;
+
+    cases.push_back({"Log2", FastApprox::Log2, FastApprox::Log2,
+                     [](double x) { return std::log2(x); },
+                     Logarithmic(1.2e-38f, 3.0e38f, kPoints), false, 3e-7});
+    cases.push_back({"Exp2", FastApprox::Exp2, FastApprox::Exp2,
+                     [](double x) { return std::exp2(x); },
+                     Linear(-126.0f, 127.0f, kPoints), true, 3e-7});
+    cases.push_back({"LinearTodB", FastApprox::LinearTodB, FastApprox::LinearTodB,
+                     [](double x) { return 20.0 * std::log10(x); },
+                     Logarithmic(1e-10f, 1e4f, kPoints), false, 2e-6});
+    cases.push_back({"dBToLinear", FastApprox::dBToLinear, FastApprox::dBToLinear,
+                     [](double x) { return std::pow(10.0, x / 20.0); },
+                     Linear(-140.0f, 40.0f, kPoints), true, 1e-6});
+    cases.push_back({"Tanh", FastApprox::Tanh, FastApprox::Tanh,
+                     [](double x) { return std::tanh(x); },
+                     Linear(-20.0f, 20.0f, kPoints), false, 3e-7});
+    cases.push_back({"Sigmoid", FastApprox::Sigmoid, FastApprox::Sigmoid,
+                     [](double x) { return 1.0 / (1.0 + std::exp(-x)); },
+                     Linear(-40.0f, 40.0f, kPoints), false, 3e-7});
+
+    bool passed = true;
+    std::cout << "  " << std::left << std::setw(12) << "function"
+              << std::right << std::setw(14) << "scalar err"
+              << std::setw(14) << "block err"
+              << std::setw(12) << "bound" << std::endl;
+
+    for (const ErrorCase& c : cases) {
+        std::vector<float> scalarResults(c.inputs.size());
+        for (size_t i = 0; i < c.inputs.size(); ++i) {
+            scalarResults[i] = c.scalar(c.inputs[i]);
+        }
+
+        std::vector<float> blockResults(c.inputs.size());
+        c.block(c.inputs.data(), blockResults.data(), c.inputs.size());
+
+        double scalarError = MeasureError(c, scalarResults);
+        double blockError = MeasureError(c, blockResults);
+        bool ok = scalarError <= c.bound && blockError <= c.bound;
+        passed = passed && ok;
+
+        std::cout << "  " << std::left << std::setw(12) << c.name << std::right
+                  << std::scientific << std::setprecision(2)
+                  << std::setw(14) << scalarError
+                  << std::setw(14) << blockError
+                  << std::setw(12) << c.bound
+                  << (c.relative ? "  rel" : "  abs")
+                  << (ok ? "" : "  <-- exceeds bound") << std::endl;
+    }
+    std::cout << std::defaultfloat;
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestEdgeCases()
+{
+    std::cout << "\n[TEST] Clamping and in-place operation..." << std::endl;
+
+    bool passed = true;
+
+    // Silence maps to the -200 dB floor instead of -inf/NaN
+    float floor = FastApprox::LinearTodB(0.0f);
+    if (!(std::abs(floor + 200.0f) < 1e-3f)) {
+        std::cout << "  LinearTodB(0) = " << floor << ", expected -200" << std::endl;
+        passed = false;
+    }
+    if (!std::isfinite(FastApprox::Log2(-1.0f))) {
+        std::cout << "  Log2(-1) is not finite" << std::endl;
+        passed = false;
+    }
+
+    // Exp2 saturates instead of overflowing to inf or flushing oddly
+    float big = FastApprox::Exp2(1000.0f);
+    float tiny = FastApprox::Exp2(-1000.0f);
+    if (!std::isfinite(big) || tiny < 0.0f || tiny > 1.2e-38f) {
+        std::cout << "  Exp2 clamping failed: " << big << ", " << tiny << std::endl;
+        passed = false;
+    }
+
+    // Tanh saturates to exactly +/-1 at the clamp and is odd
+    if (std::abs(FastApprox::Tanh(50.0f) - 1.0f) > 1e-7f ||
+        std::abs(FastApprox::Tanh(-50.0f) + 1.0f) > 1e-7f ||
+        FastApprox::Tanh(0.0f) != 0.0f) {
+        std::cout << "  Tanh saturation/zero check failed" << std::endl;
+        passed = false;
+    }
+
+    // Block functions may run in place
+    std::vector<float> data = Linear(-60.0f, 12.0f, 37);
+    std::vector<float> expected(data.size());
+    FastApprox::dBToLinear(data.data(), expected.data(), data.size());
+    FastApprox::dBToLinear(data.data(), data.data(), data.size());
+    if (data != expected) {
+        std::cout << "  In-place dBToLinear differs from out-of-place" << std::endl;
+        passed = false;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+template <typename Function>
+static double NanosPerValue(Function function, size_t iterations, size_t count)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           static_cast<double>(iterations * count);
+}
+
+static void BenchmarkThroughput(bool quick)
+{
+    std::cout << "\n[BENCH] Block throughput vs <cmath> (256 values per call)" << std::endl;
+
+    const size_t kCount = 256;
+    const size_t iterations = quick ? 2000 : 20000;
+    std::vector<float> levels = Logarithmic(1e-5f, 2.0f, kCount);
+    std::vector<float> decibels = Linear(-60.0f, 6.0f, kCount);
+    std::vector<float> signal = Linear(-3.0f, 3.0f, kCount);
+    std::vector<float> out(kCount);
+    volatile float sink = 0.0f;
+
+    struct Row {
+        const char* name;
+        double stdNs;
+        double fastNs;
+    };
+    std::vector<Row> rows;
+
+    rows.push_back({"LinearTodB",
+        NanosPerValue([&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = 20.0f * std::log10(levels[i]);
+            sink = sink + out[0];
+        }, iterations, kCount),
+        NanosPerValue([&] {
+            FastApprox::LinearTodB(levels.data(), out.data(), kCount);
+            sink = sink + out[0];
+        }, iterations, kCount)});
+
+    rows.push_back({"dBToLinear",
+        NanosPerValue([&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = std::pow(10.0f, decibels[i] / 20.0f);
+            sink = sink + out[0];
+        }, iterations, kCount),
+        NanosPerValue([&] {
+            FastApprox::dBToLinear(decibels.data(), out.data(), kCount);
+            sink = sink + out[0];
+        }, iterations, kCount)});
+
+    rows.push_back({"Tanh",
+        NanosPerValue([&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = std::tanh(signal[i]);
+            sink = sink + out[0];
+        }, iterations, kCount),
+        NanosPerValue([&] {
+            FastApprox::Tanh(signal.data(), out.data(), kCount);
+            sink = sink + out[0];
+        }, iterations, kCount)});
+
+    rows.push_back({"Sigmoid",
+        NanosPerValue([&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = 1.0f / (1.0f + std::exp(-signal[i]));
+            sink = sink + out[0];
+        }, iterations, kCount),
+        NanosPerValue([&] {
+            FastApprox::Sigmoid(signal.data(), out.data(), kCount);
+            sink = sink + out[0];
+        }, iterations, kCount)});
+
+    std::cout << "  " << std::left << std::setw(12) << "function" << std::right
+              << std::setw(12) << "std ns/v"
+              << std::setw(12) << "fast ns/v"
+              << std::setw(10) << "speedup" << std::endl;
+    for (const Row& row : rows) {
+        std::cout << "  " << std::left << std::setw(12) << row.name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << row.stdNs
+                  << std::setw(12) << row.fastNs
+                  << std::setw(9) << std::setprecision(1) << row.stdNs / row.fastNs << "x"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Fast Approximation Tests        ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestErrorBounds()) passed++;
+    total++; if (TestEdgeCases()) passed++;
+
+    BenchmarkThroughput(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
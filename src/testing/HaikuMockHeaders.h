@@ -20,6 +20,11 @@
 #include <functional>
 #include <vector>
 #include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <climits>
 #include <unistd.h>
 
 // Mock BeAPI types - SOLO per compilazione sviluppo
@@ -28,6 +33,10 @@ typedef int32_t status_t;
 typedef int32_t int32;
 typedef uint32_t uint32;
 typedef uint8_t uint8;
+typedef int16_t int16;
+typedef uint16_t uint16;
+typedef int64_t int64;
+typedef uint64_t uint64;
 typedef int64_t bigtime_t;
 typedef int32_t sem_id;
 typedef long off_t;
@@ -41,32 +50,57 @@ typedef long off_t;
 #define B_ENTRY_NOT_FOUND -2147459069
 #define B_IO_ERROR -2147459074
 #define B_GENERAL_ERROR_BASE -2147483648
+#define B_NO_MEMORY (INT_MIN + 0)
+#define B_BAD_VALUE (INT_MIN + 5)
+#define B_TIMED_OUT (INT_MIN + 9)
+#define B_WOULD_BLOCK (INT_MIN + 11)
+#define B_NO_INIT (INT_MIN + 13)
+#define B_NOT_ALLOWED (INT_MIN + 15)
+#define B_BAD_DATA (INT_MIN + 16)
+#define B_BAD_SEM_ID (INT_MIN + 0x1000)
+#define B_BAD_THREAD_ID (INT_MIN + 0x1100)
+#define B_TIMEOUT 0x8
+#define B_RELATIVE_TIMEOUT 0x8
+#define B_DO_NOT_RESCHEDULE 0x2
 
 // Mock media types and constants
 #define B_MEDIA_RAW_AUDIO 0x1
 #define B_MEDIA_LITTLE_ENDIAN 1
 
-enum media_raw_audio_format {
-    B_AUDIO_UCHAR = 0x11,
-    B_AUDIO_SHORT = 0x2,
-    B_AUDIO_INT = 0x4,
-    B_AUDIO_FLOAT = 0x24
+#define B_MEDIA_BIG_ENDIAN 2
+
+// Same layout and constants as the Media Kit, so output drivers and the
+// BSoundPlayer callback signature work unchanged
+struct media_raw_audio_format {
+    enum {
+        B_AUDIO_FLOAT = 0x24,
+        B_AUDIO_DOUBLE = 0x28,
+        B_AUDIO_INT = 0x4,
+        B_AUDIO_SHORT = 0x2,
+        B_AUDIO_UCHAR = 0x11,
+        B_AUDIO_CHAR = 0x1,
+        B_AUDIO_SIZE_MASK = 0xf
+    };
+
+    float frame_rate;
+    uint32 channel_count;
+    uint32 format;
+    uint32 byte_order;
+    size_t buffer_size;
+
+    static const media_raw_audio_format wildcard;
 };
 
+inline const media_raw_audio_format media_raw_audio_format::wildcard = { 0.0f, 0, 0, 0, 0 };
+
 struct media_format {
     uint32 type;
     union {
-        struct {
-            uint32 format;
-            float frame_rate;
-            uint32 channel_count;
-            uint32 byte_order;
-            size_t buffer_size;
-        } raw_audio;
+        media_raw_audio_format raw_audio;
     } u;
 
     media_format() : type(B_MEDIA_RAW_AUDIO) {
-        u.raw_audio.format = B_AUDIO_SHORT;
+        u.raw_audio.format = media_raw_audio_format::B_AUDIO_SHORT;
         u.raw_audio.frame_rate = 44100;
         u.raw_audio.channel_count = 2;
         u.raw_audio.byte_order = B_MEDIA_LITTLE_ENDIAN;
@@ -237,9 +271,141 @@ public:
 inline thread_id find_thread(const char* name) { return std::hash<std::thread::id>{}(std::this_thread::get_id()); }
 inline status_t set_thread_priority(thread_id thread, int32_t priority) { return B_OK; }
 inline status_t suggest_thread_priority(int32_t priority) { return B_OK; }
-inline thread_id spawn_thread(int32_t (*func)(void*), const char* name, int32_t priority, void* data) { return 1; }
-inline status_t resume_thread(thread_id thread) { return B_OK; }
-inline status_t wait_for_thread(thread_id thread, status_t* result) { return B_OK; }
+// Semaphores and threads are functional (std::thread based), so code
+// built on them - AsyncAudioWriter, the offline bouncer - runs off Haiku
+namespace HaikuMock {
+
+struct Semaphore {
+    std::mutex lock;
+    std::condition_variable condition;
+    int32 count;
+    bool deleted;
+};
+
+struct Thread {
+    int32_t (*function)(void*);
+    void* data;
+    std::thread thread;
+    status_t result;
+};
+
+inline std::mutex& RegistryLock() { static std::mutex lock; return lock; }
+inline std::map<int32, std::shared_ptr<Semaphore> >& Semaphores() { static std::map<int32, std::shared_ptr<Semaphore> > sems; return sems; }
+inline std::map<int32, std::shared_ptr<Thread> >& Threads() { static std::map<int32, std::shared_ptr<Thread> > threads; return threads; }
+inline int32 NextID() { static int32 next = 100; return next++; }
+
+template<typename T>
+std::shared_ptr<T> Find(std::map<int32, std::shared_ptr<T> >& table, int32 id) {
+    std::lock_guard<std::mutex> lock(RegistryLock());
+    auto it = table.find(id);
+    return it != table.end() ? it->second : std::shared_ptr<T>();
+}
+
+} // namespace HaikuMock
+
+inline sem_id create_sem(int32 count, const char* name) {
+    std::shared_ptr<HaikuMock::Semaphore> sem(new HaikuMock::Semaphore());
+    sem->count = count;
+    sem->deleted = false;
+    std::lock_guard<std::mutex> lock(HaikuMock::RegistryLock());
+    sem_id id = HaikuMock::NextID();
+    HaikuMock::Semaphores()[id] = sem;
+    return id;
+}
+
+inline status_t delete_sem(sem_id id) {
+    std::shared_ptr<HaikuMock::Semaphore> sem;
+    {
+        std::lock_guard<std::mutex> lock(HaikuMock::RegistryLock());
+        auto it = HaikuMock::Semaphores().find(id);
+        if (it == HaikuMock::Semaphores().end()) return B_BAD_SEM_ID;
+        sem = it->second;
+        HaikuMock::Semaphores().erase(it);
+    }
+    std::lock_guard<std::mutex> lock(sem->lock);
+    sem->deleted = true;
+    sem->condition.notify_all();
+    return B_OK;
+}
+
+inline status_t acquire_sem_etc(sem_id id, int32 count, uint32 flags, bigtime_t timeout) {
+    std::shared_ptr<HaikuMock::Semaphore> sem = HaikuMock::Find(HaikuMock::Semaphores(), id);
+    if (!sem) return B_BAD_SEM_ID;
+    std::unique_lock<std::mutex> lock(sem->lock);
+    auto ready = [&]() { return sem->deleted || sem->count >= count; };
+    if (flags & B_RELATIVE_TIMEOUT) {
+        if (!sem->condition.wait_for(lock, std::chrono::microseconds(timeout), ready))
+            return timeout <= 0 ? B_WOULD_BLOCK : B_TIMED_OUT;
+    } else {
+        sem->condition.wait(lock, ready);
+    }
+    if (sem->deleted) return B_BAD_SEM_ID;
+    sem->count -= count;
+    return B_OK;
+}
+
+inline status_t acquire_sem(sem_id id) { return acquire_sem_etc(id, 1, 0, 0); }
+
+inline status_t release_sem_etc(sem_id id, int32 count, uint32 flags) {
+    std::shared_ptr<HaikuMock::Semaphore> sem = HaikuMock::Find(HaikuMock::Semaphores(), id);
+    if (!sem) return B_BAD_SEM_ID;
+    std::lock_guard<std::mutex> lock(sem->lock);
+    sem->count += count;
+    sem->condition.notify_all();
+    return B_OK;
+}
+
+inline status_t release_sem(sem_id id) { return release_sem_etc(id, 1, 0); }
+
+inline thread_id spawn_thread(int32_t (*func)(void*), const char* name, int32_t priority, void* data) {
+    std::shared_ptr<HaikuMock::Thread> thread(new HaikuMock::Thread());
+    thread->function = func;
+    thread->data = data;
+    thread->result = B_OK;
+    std::lock_guard<std::mutex> lock(HaikuMock::RegistryLock());
+    thread_id id = HaikuMock::NextID();
+    HaikuMock::Threads()[id] = thread;
+    return id;
+}
+
+inline status_t resume_thread(thread_id id) {
+    std::shared_ptr<HaikuMock::Thread> thread = HaikuMock::Find(HaikuMock::Threads(), id);
+    if (!thread) return B_BAD_THREAD_ID;
+    if (!thread->thread.joinable()) {
+        std::shared_ptr<HaikuMock::Thread> self = thread;
+        thread->thread = std::thread([self]() { self->result = self->function(self->data); });
+    }
+    return B_OK;
+}
+
+inline status_t wait_for_thread(thread_id id, status_t* result) {
+    std::shared_ptr<HaikuMock::Thread> thread;
+    {
+        std::lock_guard<std::mutex> lock(HaikuMock::RegistryLock());
+        auto it = HaikuMock::Threads().find(id);
+        if (it == HaikuMock::Threads().end()) return B_BAD_THREAD_ID;
+        thread = it->second;
+        HaikuMock::Threads().erase(it);
+    }
+    if (thread->thread.joinable()) thread->thread.join();
+    if (result) *result = thread->result;
+    return B_OK;
+}
+
+// std::thread cannot be killed: forget a thread that never ran, detach
+// one that did
+inline status_t kill_thread(thread_id id) {
+    std::shared_ptr<HaikuMock::Thread> thread;
+    {
+        std::lock_guard<std::mutex> lock(HaikuMock::RegistryLock());
+        auto it = HaikuMock::Threads().find(id);
+        if (it == HaikuMock::Threads().end()) return B_BAD_THREAD_ID;
+        thread = it->second;
+        HaikuMock::Threads().erase(it);
+    }
+    if (thread->thread.joinable()) thread->thread.detach();
+    return B_OK;
+}
 inline void snooze(uint64_t microseconds) { std::this_thread::sleep_for(std::chrono::microseconds(microseconds)); }
 
 // Mock team/system info structs
@@ -0,0 +1,611 @@
+/*
+ * MappedPCMSourceTest.cpp - Zero-copy PCM source for WAV, AIFF and RAW
+ *
+ * Writes files in every layout the source maps (WAV 8/16/24/32-bit and
+ * float, AIFF and AIFC big- and little-endian, plain RAW and BeOS track
+ * objects with the "!TRK" header) from known sample values and checks the
+ * header parsing and every conversion against them, at unaligned offsets.
+ * Then checks that rendering through the resampler straight from the
+ * mapping matches rendering the decoded file, that a session of long RAW
+ * tracks opens far faster than loading them into vectors the way the
+ * 3dmix viewer used to, and that playing a file end to end keeps only
+ * the read-ahead window resident, with the stream readers moving it.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "../audio/MappedPCMSource.h"
+#include "../audio/PolyphaseResampler.h"
+#include "../audio/3dmix/3DMixFormat.h"
+#include "TestSignals.h"
+
+using namespace VeniceDAW;
+
+static std::string sDirectory;
+
+// Known sample of frame and channel, in [-32767, 32767]
+static int16_t Value(int64 frame, int32 channel)
+{
+    uint32 x = (uint32)(frame * 2654435761u) ^ (uint32)(channel * 40503u + 17u);
+    x ^= x >> 15;
+    x *= 2246822519u;
+    x ^= x >> 13;
+    return (int16_t)((int32)(x % 65535u) - 32767);
+}
+
+enum SampleType { kPCM, kUnsignedPCM, kFloatPCM };
+
+// Interleaved samples whose top 16 bits are Value(); lower bytes are noise
+static std::vector<uint8> EncodeSamples(int64 frames, int32 channels, int32 bytes,
+                                        bool bigEndian, SampleType type)
+{
+    std::vector<uint8> data;
+    data.reserve(frames * channels * bytes);
+    for (int64 frame = 0; frame < frames; frame++) {
+        for (int32 channel = 0; channel < channels; channel++) {
+            int16_t value = Value(frame, channel);
+            uint8 sample[4];
+            if (type == kFloatPCM) {
+                float f = value / 32767.0f;
+                uint32 bits;
+                memcpy(&bits, &f, sizeof(bits));
+                for (int32 i = 0; i < 4; i++) {
+                    sample[i] = (uint8)(bits >> (bigEndian ? 24 - 8 * i : 8 * i));
+                }
+            } else if (bytes == 1) {
+                sample[0] = (uint8)((value >> 8) + (type == kUnsignedPCM ? 128 : 0));
+            } else {
+                // Most significant first, then reorder
+                uint8 msb[4] = { (uint8)((uint16)value >> 8), (uint8)value,
+                                 (uint8)(frame * 7 + channel), (uint8)(frame * 13) };
+                for (int32 i = 0; i < bytes; i++) {
+                    sample[i] = bigEndian ? msb[i] : msb[bytes - 1 - i];
+                }
+            }
+            data.insert(data.end(), sample, sample + bytes);
+        }
+    }
+    return data;
+}
+
+static int16_t Expected(int64 frame, int32 channel, int32 channels, int32 bytes)
+{
+    int16_t value = Value(frame, channel < channels ? channel : channels - 1);
+    return bytes == 1 ? (int16_t)(value & 0xff00) : value;
+}
+
+static void PutTag(std::vector<uint8>& out, const char* tag)
+{
+    out.insert(out.end(), tag, tag + 4);
+}
+
+static std::string WriteFile(const char* name, const std::vector<uint8>& contents)
+{
+    std::string path = sDirectory + "/" + name;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file) {
+        fwrite(contents.data(), 1, contents.size(), file);
+        fclose(file);
+    }
+    return path;
+}
+
+static std::vector<uint8> MakeWav(uint32 rate, int32 channels, int32 bits, uint16 formatTag,
+                                  const std::vector<uint8>& body)
+{
+    std::vector<uint8> out;
+    PutTag(out, "RIFF");
+    Put32(out, 4 + 8 + 16 + 8 + 6 + 8 + body.size(), false);
+    PutTag(out, "WAVE");
+    PutTag(out, "fmt ");
+    Put32(out, 16, false);
+    Put16(out, formatTag, false);
+    Put16(out, channels, false);
+    Put32(out, rate, false);
+    Put32(out, rate * channels * bits / 8, false);
+    Put16(out, channels * bits / 8, false);
+    Put16(out, bits, false);
+    // A chunk to skip, odd-sized so the padding rule is exercised
+    PutTag(out, "LIST");
+    Put32(out, 5, false);
+    out.insert(out.end(), { 'I', 'N', 'F', 'O', '!', 0 });
+    PutTag(out, "data");
+    Put32(out, body.size(), false);
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+static void PutExtended80(std::vector<uint8>& out, double value)
+{
+    int exponent;
+    double fraction = std::frexp(value, &exponent);     // value = fraction * 2^exponent
+    uint64_t mantissa = (uint64_t)std::ldexp(fraction, 64);
+    Put16(out, (uint16)(exponent - 1 + 16383), true);
+    Put32(out, (uint32)(mantissa >> 32), true);
+    Put32(out, (uint32)mantissa, true);
+}
+
+static std::vector<uint8> MakeAiff(double rate, int32 channels, int32 bits, int64 frames,
+                                   const char* compression, uint32 ssndOffset,
+                                   const std::vector<uint8>& body)
+{
+    std::vector<uint8> chunks;
+    PutTag(chunks, "COMM");
+    Put32(chunks, compression ? 18 + 4 + 2 : 18, true);
+    Put16(chunks, channels, true);
+    Put32(chunks, frames, true);
+    Put16(chunks, bits, true);
+    PutExtended80(chunks, rate);
+    if (compression) {
+        PutTag(chunks, compression);
+        chunks.push_back(0);                            // Empty pascal string, padded
+        chunks.push_back(0);
+    }
+    size_t ssndSize = 8 + ssndOffset + body.size();
+    PutTag(chunks, "SSND");
+    Put32(chunks, ssndSize, true);
+    Put32(chunks, ssndOffset, true);
+    Put32(chunks, 0, true);
+    chunks.insert(chunks.end(), ssndOffset, 0xee);
+    chunks.insert(chunks.end(), body.begin(), body.end());
+    if (ssndSize & 1) {
+        chunks.push_back(0);
+    }
+
+    std::vector<uint8> out;
+    PutTag(out, "FORM");
+    Put32(out, 4 + chunks.size(), true);
+    PutTag(out, compression ? "AIFC" : "AIFF");
+    out.insert(out.end(), chunks.begin(), chunks.end());
+    return out;
+}
+
+// BeOS track object: "!TRK", name, then the rate somewhere in 96 bytes
+static std::vector<uint8> MakeTrackObject(uint32 headerRate, const std::vector<uint8>& body)
+{
+    std::vector<uint8> out(96, 0);
+    memcpy(out.data(), "!TRK", 4);
+    memcpy(out.data() + 8, "Guitar", 6);
+    memcpy(out.data() + 24, "SIMPRAW_", 8);
+    out[40] = headerRate >> 24;
+    out[41] = (headerRate >> 16) & 0xff;
+    out[42] = (headerRate >> 8) & 0xff;
+    out[43] = headerRate & 0xff;
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+static AudioFormat3DMix RawFormat(int32 channels, int32 sampleRate)
+{
+    AudioFormat3DMix format;
+    format.bitDepth = 16;
+    format.channels = channels;
+    format.sampleRate = sampleRate;
+    format.isRawFormat = true;
+    return format;
+}
+
+// All frames, and reads at odd offsets and across the end
+static bool CheckFrames(const MappedPCMSource& source, int64 frames, int32 channels, int32 bytes)
+{
+    std::vector<int16_t> buffer((frames + 64) * 2);
+    if (source.ReadFrames(0, buffer.data(), frames + 64) != frames) {
+        return false;
+    }
+    for (int64 frame = 0; frame < frames; frame++) {
+        for (int32 c = 0; c < 2; c++) {
+            if (buffer[frame * 2 + c] != Expected(frame, c, channels, bytes)) {
+                return false;
+            }
+        }
+    }
+
+    uint32 seed = 99;
+    for (int32 i = 0; i < 200; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int64 start = (seed >> 8) % frames;
+        int64 count = 1 + (seed % 77);
+        int64 got = source.ReadFrames(start, buffer.data(), count);
+        if (got != std::min(count, frames - start)) {
+            return false;
+        }
+        for (int64 frame = 0; frame < got; frame++) {
+            for (int32 c = 0; c < 2; c++) {
+                if (buffer[frame * 2 + c] != Expected(start + frame, c, channels, bytes)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return source.ReadFrames(frames, buffer.data(), 1) == 0;
+}
+
+static bool TestContainers()
+{
+    std::cout << "\n[TEST] WAV, AIFF and RAW headers and sample conversions" << std::endl;
+
+    struct Case {
+        const char* name;
+        std::vector<uint8> contents;
+        const AudioFormat3DMix* rawFormat;
+        MappedPCMSource::Container container;
+        float rate;
+        int32 channels;
+        int32 bytes;
+        int64 frames;
+    };
+
+    const int64 n = 5003;
+    AudioFormat3DMix stereoRaw = RawFormat(2, 48000);
+    AudioFormat3DMix monoRaw = RawFormat(1, 0);
+
+    std::vector<Case> cases = {
+        { "wav-16-stereo.wav", MakeWav(44100, 2, 16, 1, EncodeSamples(n, 2, 2, false, kPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 44100, 2, 2, n },
+        { "wav-16-mono.wav", MakeWav(22050, 1, 16, 1, EncodeSamples(n, 1, 2, false, kPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 22050, 1, 2, n },
+        { "wav-24.wav", MakeWav(48000, 2, 24, 1, EncodeSamples(n, 2, 3, false, kPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 48000, 2, 3, n },
+        { "wav-32.wav", MakeWav(96000, 2, 32, 1, EncodeSamples(n, 2, 4, false, kPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 96000, 2, 4, n },
+        { "wav-8.wav", MakeWav(11025, 1, 8, 1, EncodeSamples(n, 1, 1, false, kUnsignedPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 11025, 1, 1, n },
+        { "wav-float.wav", MakeWav(44100, 2, 32, 3, EncodeSamples(n, 2, 4, false, kFloatPCM)),
+          nullptr, MappedPCMSource::kWaveContainer, 44100, 2, 2, n },
+        { "wav-quad.wav", MakeWav(44100, 4, 16, 1, EncodeSamples(n, 4, 2, false, kPCM)),
+          &stereoRaw, MappedPCMSource::kWaveContainer, 44100, 4, 2, n },
+        { "aiff-16.aiff", MakeAiff(44100, 2, 16, n, nullptr, 0, EncodeSamples(n, 2, 2, true, kPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 44100, 2, 2, n },
+        { "aiff-24-mono.aiff", MakeAiff(48000, 1, 24, n, nullptr, 0, EncodeSamples(n, 1, 3, true, kPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 48000, 1, 3, n },
+        { "aiff-8.aiff", MakeAiff(22050, 2, 8, n, nullptr, 0, EncodeSamples(n, 2, 1, true, kPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 22050, 2, 1, n },
+        { "aiff-unaligned.aiff", MakeAiff(32000, 2, 16, n, nullptr, 3, EncodeSamples(n, 2, 2, true, kPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 32000, 2, 2, n },
+        { "aifc-sowt.aifc", MakeAiff(44100, 2, 16, n, "sowt", 0, EncodeSamples(n, 2, 2, false, kPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 44100, 2, 2, n },
+        { "aifc-fl32.aifc", MakeAiff(88200, 2, 32, n, "fl32", 0, EncodeSamples(n, 2, 4, true, kFloatPCM)),
+          nullptr, MappedPCMSource::kAiffContainer, 88200, 2, 2, n },
+        { "plain.raw", EncodeSamples(n, 2, 2, true, kPCM),
+          &stereoRaw, MappedPCMSource::kRawContainer, 48000, 2, 2, n },
+        { "track.raw", MakeTrackObject(44100, EncodeSamples(n, 2, 2, true, kPCM)),
+          &stereoRaw, MappedPCMSource::kTrackObjectContainer, 22050, 2, 2, n },
+        { "track-mono.raw", MakeTrackObject(96000, EncodeSamples(n, 1, 2, true, kPCM)),
+          &monoRaw, MappedPCMSource::kTrackObjectContainer, 48000, 1, 2, n },
+    };
+
+    int32 failures = 0;
+    for (const Case& test : cases) {
+        std::string path = WriteFile(test.name, test.contents);
+        MappedPCMSource source;
+        status_t status = source.Open(path.c_str(), test.rawFormat);
+
+        bool ok = status == B_OK && source.GetContainer() == test.container
+                  && source.GetSampleRate() == test.rate
+                  && source.CountChannels() == test.channels
+                  && source.CountFrames() == test.frames
+                  && CheckFrames(source, test.frames, test.channels, test.bytes);
+        if (!ok) {
+            std::cout << "  " << test.name << ": status " << status << ", "
+                      << source.CountFrames() << " frames at " << source.GetSampleRate()
+                      << " Hz - wrong" << std::endl;
+            failures++;
+        }
+    }
+
+    // Not audio, and RAW the source cannot play
+    std::string text = WriteFile("notes.txt", std::vector<uint8>(1000, 'x'));
+    AudioFormat3DMix raw24 = RawFormat(2, 44100);
+    raw24.bitDepth = 24;
+    MappedPCMSource source;
+    bool rejects = source.Open(text.c_str(), nullptr) != B_OK
+                   && source.Open(text.c_str(), &raw24) != B_OK
+                   && source.Open((sDirectory + "/missing.wav").c_str(), nullptr) != B_OK
+                   && !source.IsOpen();
+
+    std::cout << "  " << cases.size() - failures << "/" << cases.size()
+              << " layouts decoded exactly, bad files rejected: " << (rejects ? "yes" : "no")
+              << " (kernel: " << MappedPCMSource::GetKernelName() << ")" << std::endl;
+
+    bool passed = failures == 0 && rejects;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRenderMatchesDecoded()
+{
+    std::cout << "\n[TEST] Rendering from the mapping matches the decoded file" << std::endl;
+
+    const int64 frames = 200000;
+    AudioFormat3DMix format = RawFormat(2, 0);
+    std::string path = WriteFile("render.raw",
+                                 MakeTrackObject(44100, EncodeSamples(frames, 2, 2, true, kPCM)));
+
+    MappedPCMSource source;
+    if (source.Open(path.c_str(), &format) != B_OK) {
+        std::cout << "  Result: FAILED ✗ (open)" << std::endl;
+        return false;
+    }
+    std::vector<int16_t> decoded(frames * 2);
+    source.ReadFrames(0, decoded.data(), frames);
+
+    const double outputRates[] = { 44100.0, 48000.0, 22050.0, 16000.0, 96000.0 };
+    const double positions[] = { 0.0, 12345.678, (double)frames - 300.25, (double)frames - 3.5 };
+    const size_t blockSizes[] = { 256, 4096 };
+
+    float maxError = 0.0f;
+    int32 countMismatches = 0;
+    std::vector<float> mapped(4096 * 2);
+    std::vector<float> reference(4096 * 2);
+
+    for (double outputRate : outputRates) {
+        DSP::PolyphaseResampler a(2, DSP::PolyphaseResampler::QUALITY_BALANCED, 4096);
+        DSP::PolyphaseResampler b(2, DSP::PolyphaseResampler::QUALITY_BALANCED, 4096);
+        a.SetRates(source.GetSampleRate(), outputRate);
+        b.SetRates(source.GetSampleRate(), outputRate);
+
+        for (double position : positions) {
+            for (size_t block : blockSizes) {
+                size_t insideMapped = source.Render(a, position, mapped.data(), block);
+                size_t insideDecoded = b.Render(decoded.data(), frames, position,
+                                                reference.data(), block);
+                if (insideMapped != insideDecoded) {
+                    countMismatches++;
+                }
+                for (size_t i = 0; i < block * 2; i++) {
+                    maxError = std::max(maxError, std::fabs(mapped[i] - reference[i]));
+                }
+            }
+        }
+    }
+
+    std::cout << "  Max difference: " << maxError << ", frame count mismatches: "
+              << countMismatches << std::endl;
+
+    bool passed = maxError < 1e-5f && countMismatches == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// How the 3dmix viewer loaded RAW tracks: the whole file into a vector,
+// swapping one frame at a time
+static size_t LegacyLoadRaw(const char* path, std::vector<int16_t>& samples)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 96, SEEK_SET);
+    samples.reserve((size - 96) / 2);
+
+    const int chunkFrames = 131072;
+    std::vector<uint8> chunk(chunkFrames * 4);
+    size_t bytes;
+    while ((bytes = fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+        for (size_t i = 0; i + 4 <= bytes; i += 4) {
+            uint16 left, right;
+            memcpy(&left, &chunk[i], 2);
+            memcpy(&right, &chunk[i + 2], 2);
+            samples.push_back((int16_t)((left >> 8) | (left << 8)));
+            samples.push_back((int16_t)((right >> 8) | (right << 8)));
+        }
+    }
+    fclose(file);
+    return samples.size() / 2;
+}
+
+static bool TestSessionOpen(bool quick)
+{
+    int32 tracks = quick ? 8 : 16;
+    int32 seconds = quick ? 60 : 180;
+    std::cout << "\n[TEST] Opening a session of " << tracks << " RAW tracks of "
+              << seconds << " s" << std::endl;
+
+    // One body written under several names; the frame pattern repeats
+    int64 frames = (int64)seconds * 44100;
+    std::vector<uint8> block = EncodeSamples(44100, 2, 2, true, kPCM);
+    std::vector<std::string> paths;
+    for (int32 t = 0; t < tracks; t++) {
+        char name[32];
+        snprintf(name, sizeof(name), "session-%02d.raw", (int)t);
+        std::string path = sDirectory + "/" + name;
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cout << "  Result: FAILED ✗ (cannot write " << path << ")" << std::endl;
+            return false;
+        }
+        std::vector<uint8> header = MakeTrackObject(88200, std::vector<uint8>());
+        fwrite(header.data(), 1, header.size(), file);
+        for (int32 s = 0; s < seconds; s++) {
+            fwrite(block.data(), 1, block.size(), file);
+        }
+        fclose(file);
+        paths.push_back(path);
+    }
+
+    AudioFormat3DMix format = RawFormat(2, 0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<MappedPCMSource*> sources;
+    int64 mappedFrames = 0;
+    for (const std::string& path : paths) {
+        MappedPCMSource* source = new MappedPCMSource;
+        if (source->Open(path.c_str(), &format) == B_OK) {
+            mappedFrames += source->CountFrames();
+        }
+        sources.push_back(source);
+    }
+    double mappedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    int64 loadedFrames = 0;
+    size_t loadedBytes = 0;
+    for (const std::string& path : paths) {
+        std::vector<int16_t> samples;
+        loadedFrames += LegacyLoadRaw(path.c_str(), samples);
+        loadedBytes += samples.capacity() * sizeof(int16_t);
+    }
+    double loadedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // The session plays the same audio either way
+    bool same = mappedFrames == loadedFrames && mappedFrames == frames * tracks;
+    std::vector<int16_t> check(2);
+    for (MappedPCMSource* source : sources) {
+        int64 frame = frames / 3;
+        same = same && source->ReadFrames(frame, check.data(), 1) == 1
+               && check[0] == Value(frame % 44100, 0) && check[1] == Value(frame % 44100, 1);
+        delete source;
+    }
+    for (const std::string& path : paths) {
+        unlink(path.c_str());
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "  Mapped:        " << mappedMs << " ms ("
+              << mappedMs / tracks << " ms per track)" << std::endl;
+    std::cout << "  Vector load:   " << loadedMs << " ms, "
+              << loadedBytes / (1024 * 1024) << " MB of samples" << std::endl;
+    std::cout << "  Speedup:       " << std::setprecision(0) << loadedMs / std::max(mappedMs, 0.001)
+              << "x" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    bool passed = same && mappedMs * 10.0 < loadedMs && mappedMs < 50.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+#ifdef __linux__
+static size_t ResidentBytes()
+{
+    FILE* file = fopen("/proc/self/statm", "r");
+    long size = 0;
+    long resident = 0;
+    if (file) {
+        if (fscanf(file, "%ld %ld", &size, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(file);
+    }
+    return (size_t)resident * sysconf(_SC_PAGESIZE);
+}
+#endif
+
+static bool TestResidentMemory(bool quick)
+{
+    std::cout << "\n[TEST] Playing a long file keeps only the read-ahead window resident" << std::endl;
+
+#ifndef __linux__
+    (void)quick;
+    std::cout << "  Resident size not measurable on this platform, skipped" << std::endl;
+    std::cout << "  Result: PASSED ✓" << std::endl;
+    return true;
+#else
+    int32 seconds = quick ? 60 : 240;
+    std::vector<uint8> block = EncodeSamples(44100, 2, 2, false, kPCM);
+    std::string path = sDirectory + "/long.wav";
+    std::vector<uint8> header = MakeWav(44100, 2, 16, 1, std::vector<uint8>());
+    size_t dataBytes = block.size() * seconds;
+    // Patch the sizes for the data that follows
+    uint32 riffSize = (uint32)(header.size() - 8 + dataBytes);
+    uint32 dataSize = (uint32)dataBytes;
+    memcpy(&header[4], &riffSize, 4);
+    memcpy(&header[header.size() - 4], &dataSize, 4);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "  Result: FAILED ✗ (cannot write)" << std::endl;
+        return false;
+    }
+    fwrite(header.data(), 1, header.size(), file);
+    for (int32 s = 0; s < seconds; s++) {
+        fwrite(block.data(), 1, block.size(), file);
+    }
+    fclose(file);
+
+    MappedPCMSource source;
+    if (source.Open(path.c_str()) != B_OK) {
+        unlink(path.c_str());
+        std::cout << "  Result: FAILED ✗ (open)" << std::endl;
+        return false;
+    }
+
+    DSP::PolyphaseResampler resampler(2, DSP::PolyphaseResampler::QUALITY_REALTIME, 512);
+    resampler.SetRates(44100.0, 44100.0);
+    std::vector<float> output(512 * 2);
+
+    // Render() leaves the madvise calls to the stream readers; give them
+    // the time a real-time callback period would
+    uint64 readsBefore = StreamingService::GetInstance().GetStats().reads;
+    size_t before = ResidentBytes();
+    size_t peak = 0;
+    double position = 0.0;
+    float sum = 0.0f;
+    while (position < (double)source.CountFrames()) {
+        source.Render(resampler, position, output.data(), 512);
+        for (int32 wait = 0; wait < 1000 && source.IsReadAheadPending(); wait++) {
+            usleep(1000);
+        }
+        sum += output[0];
+        position += 512.0;
+        peak = std::max(peak, ResidentBytes());
+    }
+    size_t growth = peak > before ? peak - before : 0;
+    uint64 advised = StreamingService::GetInstance().GetStats().reads - readsBefore;
+    unlink(path.c_str());
+
+    size_t bound = MappedPCMSource::kReadAheadBytes * 2 + MappedPCMSource::kKeepBehindBytes
+                   + 1024 * 1024;
+    std::cout << "  Played " << source.GetMappedSize() / (1024 * 1024) << " MB, peak resident growth "
+              << growth / 1024 << " KB (bound " << bound / 1024 << " KB), window moved by "
+              << advised << " reader calls" << std::endl;
+
+    bool passed = growth <= bound && advised > 0 && std::isfinite(sum);
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Mapped PCM Source Tests         ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    char directory[] = "/tmp/venice-mapped-XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::cout << "Cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    sDirectory = directory;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestContainers()) passed++;
+    total++; if (TestRenderMatchesDecoded()) passed++;
+    total++; if (TestSessionOpen(quick)) passed++;
+    total++; if (TestResidentMemory(quick)) passed++;
+
+    std::string cleanup = "rm -rf '" + sDirectory + "'";
+    if (system(cleanup.c_str()) != 0) {
+        std::cout << "Could not remove " << sDirectory << std::endl;
+    }
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,344 @@
+/*
+ * OfflineBouncerTest.cpp - Offline mixdown and stem export
+ *
+ * Bounces a small project of generated WAV tracks and reads the files
+ * back: the stems plus the reverb return sum to the master, the files
+ * run on past the content by the reverb's tail, a bounce on several
+ * threads is bit-identical to one on the calling thread, and files that
+ * cannot be written show up in the returned stats.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
+#include "../audio/OfflineBouncer.h"
+#include "../audio/3dmix/3DMixFormat.h"
+#include "TestSignals.h"
+
+using namespace VeniceDAW;
+
+static std::string sDirectory;
+
+static const float kSampleRate = 44100.0f;
+static const float kMasterVolume = 0.8f;
+
+struct TrackSpec {
+    const char* name;
+    int64 frames;
+    int32 start;
+    float volume;
+    float balance;
+    float reverb;
+    float x, y, z;
+};
+
+static const TrackSpec kTracks[] = {
+    { "drums", 30000, 0,    0.9f, -0.3f, 0.3f, -1.0f, 1.0f, 0.0f },
+    { "bass",  44100, 5000, 0.7f,  0.0f, 0.0f,  0.0f, 2.0f, 0.0f },
+    { "keys",  52000, 2000, 0.6f,  0.4f, 0.5f,  1.5f, 1.0f, 0.5f }
+};
+static const int32 kTrackCount = sizeof(kTracks) / sizeof(kTracks[0]);
+
+// 16-bit stereo: a tone per track with some noise, so every stem differs
+static std::string WriteTrack(int32 index)
+{
+    const TrackSpec& spec = kTracks[index];
+    std::vector<uint8> out;
+    out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+    Put32(out, 36 + spec.frames * 4);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    Put32(out, 16);
+    Put16(out, 1);
+    Put16(out, 2);
+    Put32(out, (uint32)kSampleRate);
+    Put32(out, (uint32)kSampleRate * 4);
+    Put16(out, 4);
+    Put16(out, 16);
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    Put32(out, spec.frames * 4);
+
+    uint32 seed = 1234 + index;
+    for (int64 i = 0; i < spec.frames; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        double tone = sin(i * 0.013 * (index + 1)) * 12000.0;
+        int32 noise = (int32)(seed >> 22) - 512;
+        Put16(out, (uint16)(int16)(tone + noise));
+        Put16(out, (uint16)(int16)(tone * 0.5 - noise));
+    }
+
+    std::string path = sDirectory + "/" + spec.name + ".wav";
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file) {
+        fwrite(out.data(), 1, out.size(), file);
+        fclose(file);
+    }
+    return path;
+}
+
+static Project3DMix* MakeProject()
+{
+    Project3DMix* project = new Project3DMix();
+    project->SetMasterVolume(kMasterVolume);
+    for (int32 i = 0; i < kTrackCount; i++) {
+        const TrackSpec& spec = kTracks[i];
+        Track3DMix* track = new Track3DMix();
+        track->SetAudioFilePath(WriteTrack(i).c_str());
+        track->SetTrackName(spec.name);
+        track->SetStartPosition(spec.start);
+        track->SetVolume(spec.volume);
+        track->SetBalance(spec.balance);
+        track->SetReverbLevel(spec.reverb);
+        track->SetPosition(spec.x, spec.y, spec.z);
+        project->AddTrack(track);
+    }
+    return project;
+}
+
+static int64 ContentFrames()
+{
+    int64 frames = 0;
+    for (int32 i = 0; i < kTrackCount; i++) {
+        frames = std::max(frames, kTracks[i].start + kTracks[i].frames);
+    }
+    return frames;
+}
+
+// The float stereo samples of a bounced file
+static bool ReadBounce(const std::string& path, std::vector<float>& samples)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    uint8 header[44];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header)
+              && memcmp(header, "RIFF", 4) == 0 && memcmp(header + 36, "data", 4) == 0
+              && header[20] == 3 && header[22] == 2;
+    if (ok) {
+        uint32 size = header[40] | header[41] << 8 | header[42] << 16 | (uint32)header[43] << 24;
+        samples.resize(size / sizeof(float));
+        ok = fread(samples.data(), sizeof(float), samples.size(), file) == samples.size();
+    }
+    fclose(file);
+    return ok;
+}
+
+static std::string StemPath(const std::string& directory, int32 index)
+{
+    char prefix[16];
+    snprintf(prefix, sizeof(prefix), "/%02d-", (int)index + 1);
+    return directory + prefix + kTracks[index].name + ".wav";
+}
+
+static std::string MakeDirectory(const char* name)
+{
+    std::string path = sDirectory + "/" + name;
+    mkdir(path.c_str(), 0755);
+    return path;
+}
+
+static status_t BounceProject(const Project3DMix* project, const std::string& master,
+                              const char* stems, int32 threads, bool reverb,
+                              OfflineBouncer::Stats* stats)
+{
+    OfflineBouncer bouncer;
+    if (bouncer.SetProject(project) != B_OK || bouncer.CountLoadedTracks() != kTrackCount) {
+        return B_ERROR;
+    }
+
+    OfflineBouncer::Options options;
+    options.masterPath = master.c_str();
+    options.stemDirectory = stems;
+    options.sampleRate = kSampleRate;
+    options.blockFrames = 1024;
+    options.threadCount = threads;
+    options.reverb = reverb;
+    return bouncer.Bounce(options, stats);
+}
+
+static bool TestStemsNullAgainstMaster(const Project3DMix* project)
+{
+    std::cout << "\n[TEST] Stems plus the reverb return sum to the master" << std::endl;
+
+    std::string stems = MakeDirectory("null");
+    std::string master = stems + "/master.wav";
+    OfflineBouncer::Stats stats;
+    status_t status = BounceProject(project, master, stems.c_str(), 1, true, &stats);
+
+    std::vector<float> mix;
+    std::vector<float> reverb;
+    bool read = status == B_OK && ReadBounce(master, mix) && ReadBounce(stems + "/reverb.wav", reverb)
+                && reverb.size() == mix.size();
+
+    // The bouncer's order: stems in track order, then the return, then
+    // the master volume
+    std::vector<float> sum(mix.size(), 0.0f);
+    for (int32 i = 0; i < kTrackCount && read; i++) {
+        std::vector<float> stem;
+        read = ReadBounce(StemPath(stems, i), stem) && stem.size() == mix.size();
+        for (size_t s = 0; read && s < stem.size(); s++) {
+            sum[s] += stem[s];
+        }
+    }
+
+    float maxError = 0.0f;
+    float peak = 0.0f;
+    for (size_t s = 0; read && s < mix.size(); s++) {
+        float expected = (sum[s] + reverb[s]) * kMasterVolume;
+        maxError = std::max(maxError, std::fabs(expected - mix[s]));
+        peak = std::max(peak, std::fabs(mix[s]));
+    }
+
+    std::cout << "  " << stats.filesWritten << " files, " << mix.size() / 2 << " frames, peak "
+              << peak << ", max difference " << maxError << std::endl;
+
+    bool passed = read && peak > 0.01f && stats.filesWritten == (uint32)kTrackCount + 2
+                  && stats.writeErrors == 0
+                  && maxError <= 4.0f * std::numeric_limits<float>::epsilon() * std::max(peak, 1.0f);
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestReverbTail(const Project3DMix* project)
+{
+    std::cout << "\n[TEST] The bounce runs on by the reverb's tail" << std::endl;
+
+    ReverbBus bus;
+    bus.SetSampleRate(kSampleRate);
+    int64 tail = bus.GetReverb().GetTailFrames();
+    int64 content = ContentFrames();
+
+    std::string master = sDirectory + "/tail.wav";
+    OfflineBouncer::Stats wetStats;
+    OfflineBouncer::Stats dryStats;
+    std::vector<float> wet;
+    std::vector<float> dry;
+    bool ok = BounceProject(project, master, nullptr, 1, true, &wetStats) == B_OK
+              && ReadBounce(master, wet)
+              && BounceProject(project, master, nullptr, 1, false, &dryStats) == B_OK
+              && ReadBounce(master, dry);
+
+    // The keys track sends until the content ends, so the whole tail follows
+    int64 wetFrames = wet.size() / 2;
+    int64 dryFrames = dry.size() / 2;
+    float tailPeak = 0.0f;
+    for (size_t s = content * 2; ok && s < wet.size(); s++) {
+        tailPeak = std::max(tailPeak, std::fabs(wet[s]));
+    }
+
+    std::cout << "  Content " << content << " frames, tail " << tail << ": " << wetFrames
+              << " frames with reverb (tail peak " << tailPeak << "), " << dryFrames
+              << " without" << std::endl;
+
+    bool passed = ok && wetFrames == content + tail && wetStats.framesRendered == wetFrames
+                  && dryFrames == content && tailPeak > 0.0f;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestParallelMatchesSerial(const Project3DMix* project)
+{
+    std::cout << "\n[TEST] A parallel bounce is bit-identical to a serial one" << std::endl;
+
+    std::string serial = MakeDirectory("serial");
+    std::string parallel = MakeDirectory("parallel");
+    bool ok = BounceProject(project, serial + "/master.wav", serial.c_str(), 1, true, nullptr) == B_OK
+              && BounceProject(project, parallel + "/master.wav", parallel.c_str(), 4, true, nullptr) == B_OK;
+
+    std::vector<std::string> names = { "/master.wav", "/reverb.wav" };
+    for (int32 i = 0; i < kTrackCount; i++) {
+        names.push_back(StemPath("", i));
+    }
+
+    int32 identical = 0;
+    for (const std::string& name : names) {
+        std::vector<float> a;
+        std::vector<float> b;
+        if (ok && ReadBounce(serial + name, a) && ReadBounce(parallel + name, b) && !a.empty()
+            && a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0) {
+            identical++;
+        }
+    }
+
+    std::cout << "  " << identical << "/" << names.size() << " files identical on 1 and 4 threads"
+              << std::endl;
+
+    bool passed = ok && identical == (int32)names.size();
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestWriteErrors(const Project3DMix* project)
+{
+    std::cout << "\n[TEST] Files that cannot be written are reported" << std::endl;
+
+    // A stem directory that does not exist: no stem file opens
+    std::string missing = sDirectory + "/missing";
+    OfflineBouncer::Stats openStats;
+    status_t openStatus = BounceProject(project, sDirectory + "/open.wav", missing.c_str(), 1,
+                                        true, &openStats);
+    bool openReported = openStatus != B_OK && openStats.writeErrors > 0
+                        && openStats.filesWritten < (uint32)kTrackCount + 2;
+
+    std::cout << "  Missing stem directory: " << (openStatus != B_OK ? "failed" : "SUCCEEDED")
+              << ", " << openStats.writeErrors << " errors, " << openStats.filesWritten
+              << " files written" << std::endl;
+
+    // A device that is always full: the file opens, the writes fail
+    bool fullReported = true;
+#if defined(__linux__)
+    OfflineBouncer::Stats fullStats;
+    status_t fullStatus = BounceProject(project, "/dev/full", nullptr, 1, true, &fullStats);
+    fullReported = fullStatus != B_OK && fullStats.writeErrors > 0 && fullStats.filesWritten == 0;
+
+    std::cout << "  Master on a full disk: " << (fullStatus != B_OK ? "failed" : "SUCCEEDED")
+              << ", " << fullStats.writeErrors << " errors, " << fullStats.filesWritten
+              << " files written" << std::endl;
+#endif
+
+    bool passed = openReported && fullReported;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    VeniceDAW Offline Bouncer Tests         ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    char directory[] = "/tmp/venice-bounce-XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::cout << "Cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    sDirectory = directory;
+
+    Project3DMix* project = MakeProject();
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestStemsNullAgainstMaster(project)) passed++;
+    total++; if (TestReverbTail(project)) passed++;
+    total++; if (TestParallelMatchesSerial(project)) passed++;
+    total++; if (TestWriteErrors(project)) passed++;
+
+    delete project;
+
+    std::string cleanup = "rm -rf '" + sDirectory + "'";
+    if (system(cleanup.c_str()) != 0) {
+        std::cout << "Could not remove " << sDirectory << std::endl;
+    }
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,432 @@
+/*
+ * PhaseVocoderTest.cpp - Streaming pitch and tempo change
+ *
+ * Checks that DSP::PhaseVocoder passes audio through unchanged (only
+ * delayed by its reported latency) at pitch 0 and tempo 1, moves a tone
+ * by the requested interval over the whole -24..+24 semitone range,
+ * changes tempo over 0.25..4x without changing pitch, and runs without
+ * allocating. PitchTimeShifter is checked as an AudioEffect: parameters,
+ * latency reporting, in-place processing. The benchmark reports how many
+ * stereo tracks one core can shift in real time.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <cstdint>
+#include "../audio/AdvancedAudioProcessor.h"
+#include "../audio/PhaseVocoder.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace VeniceDAW;
+
+// Counts heap allocations so the test can prove processing is allocation-free
+static size_t gAllocationCount = 0;
+
+void* operator new(size_t size)
+{
+    ++gAllocationCount;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static const float kSampleRate = 44100.0f;
+
+// Interleaved stereo sine, the right channel a little quieter
+static std::vector<float> Sine(double frequency, size_t frames)
+{
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < frames; i++) {
+        float value = (float)(0.5 * std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+        samples[i * 2] = value;
+        samples[i * 2 + 1] = value * 0.8f;
+    }
+    return samples;
+}
+
+// Frequency of a tone in one channel of interleaved stereo, from the
+// interpolated zero crossings between first and end
+static double MeasureFrequency(const std::vector<float>& samples, size_t first, size_t end)
+{
+    double firstCrossing = -1.0;
+    double lastCrossing = 0.0;
+    int32_t crossings = 0;
+    for (size_t i = first + 1; i < end; i++) {
+        float a = samples[(i - 1) * 2];
+        float b = samples[i * 2];
+        if (a < 0.0f && b >= 0.0f) {
+            double at = (i - 1) + a / (double)(a - b);
+            if (firstCrossing < 0.0) {
+                firstCrossing = at;
+            } else {
+                lastCrossing = at;
+                crossings++;
+            }
+        }
+    }
+    return crossings > 0 ? crossings * kSampleRate / (lastCrossing - firstCrossing) : 0.0;
+}
+
+static double RMS(const std::vector<float>& samples, size_t first, size_t end)
+{
+    double sum = 0.0;
+    for (size_t i = first; i < end; i++) {
+        sum += samples[i * 2] * samples[i * 2];
+    }
+    return std::sqrt(sum / std::max<size_t>(1, end - first));
+}
+
+// Pulls outputFrames frames through the vocoder from input, feeding what
+// it asks for in blocks of blockFrames; returns the input frames consumed
+static size_t Pull(DSP::PhaseVocoder& vocoder, const std::vector<float>& input,
+                   std::vector<float>& output, size_t outputFrames, size_t blockFrames)
+{
+    output.assign(outputFrames * 2, 0.0f);
+    size_t inputFrames = input.size() / 2;
+    size_t read = 0;
+    size_t written = 0;
+    while (written < outputFrames) {
+        size_t count = std::min(blockFrames, outputFrames - written);
+        size_t feed = std::min(std::min(vocoder.GetInputFramesNeeded(count),
+                                        vocoder.GetInputCapacity()), inputFrames - read);
+        size_t taken = feed;
+        size_t done = vocoder.Process(&input[read * 2], taken, &output[written * 2], count);
+        read += taken;
+        written += done;
+        if (done == 0 && read == inputFrames) {
+            break;
+        }
+    }
+    return read;
+}
+
+static bool TestIdentity()
+{
+    std::cout << "\n[TEST] Pitch 0, tempo 1 passes audio through, late by the latency" << std::endl;
+
+    const size_t frames = 44100;
+    std::vector<float> input(frames * 2);
+    uint32_t state = 1;
+    for (size_t i = 0; i < input.size(); i++) {
+        state = state * 1664525u + 1013904223u;
+        float noise = (int32_t)(state >> 8) / 16777216.0f - 0.5f;
+        input[i] = 0.3f * noise + 0.4f * (float)std::sin(i * 0.01);
+    }
+
+    bool passed = true;
+    const size_t blocks[] = { 1, 37, 512, 1000 };
+    for (size_t block : blocks) {
+        DSP::PhaseVocoder vocoder(2);
+        std::vector<float> output(frames * 2, 0.0f);
+        size_t done = 0;
+        while (done < frames) {
+            size_t count = std::min(std::min(block, vocoder.GetHopSize()), frames - done);
+            size_t inputFrames = count;
+            size_t written = vocoder.Process(&input[done * 2], inputFrames, &output[done * 2], count);
+            if (written != count || inputFrames != count) {
+                passed = false;
+                break;
+            }
+            done += count;
+        }
+
+        size_t latency = vocoder.GetLatencyFrames();
+        float maxError = 0.0f;
+        for (size_t i = 0; i < latency * 2; i++) {
+            maxError = std::max(maxError, std::abs(output[i]));
+        }
+        // The first frames after the start fade in under the window
+        for (size_t i = latency + vocoder.GetFrameSize(); i < frames; i++) {
+            for (size_t ch = 0; ch < 2; ch++) {
+                maxError = std::max(maxError, std::abs(output[i * 2 + ch] - input[(i - latency) * 2 + ch]));
+            }
+        }
+
+        std::cout << "  Blocks of " << std::setw(4) << block << ": latency " << latency
+                  << " frames, max error " << std::scientific << std::setprecision(2) << maxError
+                  << std::fixed << std::endl;
+        passed = passed && maxError < 1e-4f;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestPitchAccuracy()
+{
+    std::cout << "\n[TEST] A 440 Hz tone moves by the requested interval" << std::endl;
+
+    const size_t frames = 44100 * 2;
+    std::vector<float> input = Sine(440.0, frames);
+    const float intervals[] = { -24.0f, -12.0f, -5.0f, 3.0f, 7.0f, 12.0f, 24.0f };
+
+    bool passed = true;
+    for (float semitones : intervals) {
+        DSP::PhaseVocoder vocoder(2);
+        vocoder.SetPitch(semitones);
+        std::vector<float> output;
+        Pull(vocoder, input, output, frames, 512);
+
+        size_t first = vocoder.GetLatencyFrames() * 2;
+        double expected = 440.0 * std::pow(2.0, semitones / 12.0);
+        double measured = MeasureFrequency(output, first, frames);
+        double cents = 1200.0 * std::log2(measured / expected);
+        double gain = 20.0 * std::log10(RMS(output, first, frames) / RMS(input, first, frames));
+
+        std::cout << "  " << std::showpos << std::setprecision(0) << semitones << std::noshowpos
+                  << " st: " << std::setprecision(1) << measured << " Hz (expected " << expected
+                  << ", " << std::showpos << cents << " cents), level " << gain << " dB"
+                  << std::noshowpos << std::endl;
+        passed = passed && std::abs(cents) < 10.0 && std::abs(gain) < 3.0;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestTempo()
+{
+    std::cout << "\n[TEST] Tempo changes the input consumed, not the pitch" << std::endl;
+
+    const size_t outputFrames = 44100;
+    std::vector<float> input = Sine(440.0, outputFrames * 4 + 8192);
+    const float tempos[] = { 0.25f, 0.5f, 0.8f, 1.5f, 2.0f, 4.0f };
+
+    bool passed = true;
+    for (float tempo : tempos) {
+        DSP::PhaseVocoder vocoder(2);
+        vocoder.SetTempo(tempo);
+        std::vector<float> output;
+        size_t consumed = Pull(vocoder, input, output, outputFrames, 441);
+
+        // Input buffered ahead of the output is at most a frame and a hop
+        double expectedInput = (outputFrames - vocoder.GetHopSize()) * (double)tempo;
+        double slack = vocoder.GetFrameSize() + vocoder.GetHopSize() * 2.0;
+        size_t first = vocoder.GetLatencyFrames() * 2;
+        double measured = MeasureFrequency(output, first, outputFrames);
+        double cents = 1200.0 * std::log2(measured / 440.0);
+
+        std::cout << "  " << std::setprecision(2) << tempo << "x: " << consumed
+                  << " input frames for " << outputFrames << " out, " << std::setprecision(1)
+                  << measured << " Hz (" << std::showpos << cents << std::noshowpos
+                  << " cents)" << std::endl;
+        passed = passed && std::abs(consumed - expectedInput) <= slack && std::abs(cents) < 10.0;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestEffectInterface()
+{
+    std::cout << "\n[TEST] PitchTimeShifter as an AudioEffect" << std::endl;
+
+    PitchTimeShifter shifter;
+    shifter.Initialize(kSampleRate);
+    size_t latency = shifter.GetLatencySamples();
+
+    // Ranges are clamped
+    shifter.SetParameter("pitch", 30.0f);
+    shifter.SetParameter("tempo", 10.0f);
+    bool clampedHigh = shifter.GetParameter("pitch") == 24.0f && shifter.GetParameter("tempo") == 4.0f;
+    shifter.SetParameter("pitch", -30.0f);
+    shifter.SetParameter("tempo", 0.1f);
+    bool clampedLow = shifter.GetParameter("pitch") == -24.0f && shifter.GetParameter("tempo") == 0.25f;
+
+    // Latency adds up in a processor chain and follows the sample rate
+    AdvancedAudioProcessor processor;
+    processor.Initialize(kSampleRate, 512, kStereo);
+    std::unique_ptr<PitchTimeShifter> chained(new PitchTimeShifter());
+    chained->Initialize(kSampleRate);
+    processor.AddEffect(std::move(chained));
+    bool chainLatency = processor.GetTotalLatency() == latency;
+    PitchTimeShifter highRate;
+    highRate.Initialize(96000.0f);
+    bool scalesWithRate = highRate.GetLatencySamples() - latency == DSP::PhaseVocoder::kDefaultFrameSize;
+
+    // In place, an octave up, whatever the tempo setting
+    shifter.SetParameter("pitch", 12.0f);
+    shifter.SetParameter("tempo", 2.0f);
+    const size_t blockFrames = 300;
+    const size_t blocks = 300;
+    std::vector<float> input = Sine(220.0, blockFrames * blocks);
+    std::vector<float> output(input.size());
+    AdvancedAudioBuffer buffer(kStereo, blockFrames, kSampleRate);
+    for (size_t b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < blockFrames; i++) {
+            buffer.GetChannelData(0)[i] = input[(b * blockFrames + i) * 2];
+            buffer.GetChannelData(1)[i] = input[(b * blockFrames + i) * 2 + 1];
+        }
+        shifter.ProcessRealtime(buffer);
+        for (size_t i = 0; i < blockFrames; i++) {
+            output[(b * blockFrames + i) * 2] = buffer.GetChannelData(0)[i];
+            output[(b * blockFrames + i) * 2 + 1] = buffer.GetChannelData(1)[i];
+        }
+    }
+    double measured = MeasureFrequency(output, latency * 2, blockFrames * blocks);
+    bool shifted = std::abs(measured - 440.0) < 440.0 * 0.006;
+
+    // Bypassed, the buffer is left alone
+    shifter.Bypass(true);
+    AdvancedAudioBuffer untouched(kStereo, blockFrames, kSampleRate);
+    untouched.GetChannelData(0)[10] = 1.0f;
+    shifter.ProcessRealtime(untouched);
+    bool bypassed = untouched.GetChannelData(0)[10] == 1.0f;
+
+    std::cout << "  Latency " << latency << " frames at 44.1 kHz, " << highRate.GetLatencySamples()
+              << " at 96 kHz, chain total " << processor.GetTotalLatency() << std::endl;
+    std::cout << "  Clamped: " << (clampedHigh && clampedLow ? "yes" : "no")
+              << ", 220 Hz +12 st in place: " << std::setprecision(1) << measured << " Hz"
+              << ", bypass: " << (bypassed ? "yes" : "no") << std::endl;
+
+    bool passed = clampedHigh && clampedLow && chainLatency && scalesWithRate && shifted && bypassed;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestLatencyFollowsPitch()
+{
+    std::cout << "\n[TEST] Reported latency is the delay at every pitch" << std::endl;
+
+    // A tone burst; its energy centroid moves by the delay
+    const size_t frames = 256 * 240;
+    const size_t burst = 8192;
+    const size_t start = 16000;
+    std::vector<float> input(frames, 0.0f);
+    for (size_t i = 0; i < burst; i++) {
+        double envelope = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / burst);
+        input[start + i] = (float)(envelope * std::sin(2.0 * M_PI * 440.0 * i / kSampleRate));
+    }
+    auto centroid = [](const std::vector<float>& samples) {
+        double weighted = 0.0;
+        double energy = 0.0;
+        for (size_t i = 0; i < samples.size(); i++) {
+            weighted += samples[i] * samples[i] * i;
+            energy += samples[i] * samples[i];
+        }
+        return weighted / energy;
+    };
+    double inputCentroid = centroid(input);
+
+    bool passed = true;
+    const float intervals[] = { -24.0f, -12.0f, -5.0f, 0.0f, 7.0f, 12.0f, 24.0f };
+    for (float semitones : intervals) {
+        PitchTimeShifter shifter;
+        shifter.Initialize(kSampleRate);
+        shifter.SetPitch(semitones);
+
+        std::vector<float> output(frames);
+        AdvancedAudioBuffer buffer(kMono, 256, kSampleRate);
+        for (size_t offset = 0; offset < frames; offset += 256) {
+            std::copy(&input[offset], &input[offset] + 256, buffer.GetChannelData(0));
+            shifter.ProcessRealtime(buffer);
+            std::copy(buffer.GetChannelData(0), buffer.GetChannelData(0) + 256, &output[offset]);
+        }
+
+        double delay = centroid(output) - inputCentroid;
+        std::cout << "  " << std::showpos << std::setprecision(0) << semitones << std::noshowpos
+                  << " st: delay " << std::setprecision(1) << delay << " frames, reported "
+                  << shifter.GetLatencySamples() << std::endl;
+        passed = passed && std::abs(delay - shifter.GetLatencySamples()) < 16.0;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestNoAllocation()
+{
+    std::cout << "\n[TEST] Processing and parameter changes are allocation-free" << std::endl;
+
+    DSP::PhaseVocoder vocoder(2);
+    std::vector<float> input = Sine(330.0, 44100);
+    std::vector<float> output(2048 * 2);
+
+    size_t before = gAllocationCount;
+    size_t read = 0;
+    for (int32_t block = 0; block < 40; block++) {
+        vocoder.SetPitch(block % 7 - 3.0f);
+        vocoder.SetTempo(0.5f + (block % 5) * 0.5f);
+        size_t count = 512;
+        size_t feed = std::min(vocoder.GetInputFramesNeeded(count), vocoder.GetInputCapacity());
+        feed = std::min(feed, input.size() / 2 - read);
+        vocoder.Process(&input[read * 2], feed, output.data(), count);
+        read += feed;
+        if (read + 8192 > input.size() / 2) {
+            read = 0;
+        }
+    }
+    vocoder.Reset();
+    size_t allocations = gAllocationCount - before;
+
+    bool passed = allocations == 0;
+    std::cout << "  Allocations during 40 blocks: " << allocations << std::endl;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRealtimeCost(bool quick)
+{
+    std::cout << "\n[TEST] Real-time cost per track" << std::endl;
+
+    const size_t frames = 44100 * (quick ? 2 : 10);
+    std::vector<float> input = Sine(440.0, frames * 2 + 8192);
+    std::vector<float> output;
+
+    bool passed = true;
+    const float tempos[] = { 1.0f, 1.25f };
+    for (float tempo : tempos) {
+        DSP::PhaseVocoder vocoder(2);
+        vocoder.SetPitch(3.0f);
+        vocoder.SetTempo(tempo);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Pull(vocoder, input, output, frames, 512);
+        double seconds = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        double tracks = (frames / kSampleRate) / std::max(seconds, 1e-9);
+
+        std::cout << "  Stereo, +3 st at " << std::setprecision(2) << tempo << "x: "
+                  << std::setprecision(0) << tracks << " tracks in real time per core" << std::endl;
+        passed = passed && tracks > 16.0;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Phase Vocoder Tests             ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestIdentity()) passed++;
+    total++; if (TestPitchAccuracy()) passed++;
+    total++; if (TestTempo()) passed++;
+    total++; if (TestEffectInterface()) passed++;
+    total++; if (TestLatencyFollowsPitch()) passed++;
+    total++; if (TestNoAllocation()) passed++;
+    total++; if (TestRealtimeCost(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -3,6 +3,8 @@
 #include <cmath>
 #include <vector>
 #include <complex>
+#include <chrono>
+#include <algorithm>
 #include "../audio/AdvancedAudioProcessor.h"
 #include "../audio/DSPAlgorithms.h"
 
@@ -25,6 +27,8 @@ public:
         allPassed &= TestFullEQChain();
         allPassed &= TestParameterSmoothing();
         allPassed &= TestBypassFunctionality();
+        allPassed &= TestCoefficientRamp();
+        TestSurroundThroughput();
         
         std::cout << "\n=== Test Summary ===" << std::endl;
         std::cout << (allPassed ? "✓ All tests PASSED" : "✗ Some tests FAILED") << std::endl;
@@ -403,6 +407,103 @@ private:
         return passed;
     }
     
+    // Largest sample-to-sample step of a block; a zipper or click shows up
+    // as a step well above what the steady-state sine produces
+    static float MaxStep(const float* data, size_t count, float& previous) {
+        float maxStep = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            maxStep = std::max(maxStep, std::abs(data[i] - previous));
+            previous = data[i];
+        }
+        return maxStep;
+    }
+    
+    bool TestCoefficientRamp() {
+        std::cout << "\n[TEST] Block-Rate Coefficient Ramp..." << std::endl;
+        
+        ProfessionalEQ eq;
+        eq.Initialize(44100.0f);
+        eq.SetBypassed(false);
+        eq.SetBandEnabled(3, true);
+        eq.SetBandType(3, ProfessionalEQ::kPeak);
+        eq.SetBandFrequency(3, 1000.0f);
+        eq.SetBandQ(3, 1.0f);
+        eq.SetBandGain(3, -12.0f);
+        
+        const size_t blockSize = 256;
+        const float amplitude = 0.25f;
+        AdvancedAudioBuffer buffer(kMono, blockSize, 44100.0f);
+        float* data = buffer.GetChannelData(0);
+        size_t phase = 0;
+        float previous = 0.0f;
+        
+        auto processBlock = [&]() {
+            for (size_t i = 0; i < blockSize; ++i, ++phase) {
+                data[i] = amplitude * std::sin(2.0f * M_PI * 1000.0f * phase / 44100.0f);
+            }
+            eq.Process(buffer);
+            return MaxStep(data, blockSize, previous);
+        };
+        
+        for (int block = 0; block < 16; ++block) processBlock();
+        
+        // Jump +24 dB and switch on a second band in the same block
+        eq.SetBandGain(3, 12.0f);
+        eq.SetBandEnabled(5, true);
+        eq.SetBandType(5, ProfessionalEQ::kPeak);
+        eq.SetBandFrequency(5, 4000.0f);
+        eq.SetBandGain(5, 6.0f);
+        float transitionStep = processBlock();
+        
+        float steadyStep = 0.0f;
+        for (int block = 0; block < 16; ++block) steadyStep = std::max(steadyStep, processBlock());
+        
+        float rms = 0.0f;
+        for (size_t i = 0; i < blockSize; ++i) rms += data[i] * data[i];
+        rms = std::sqrt(rms / blockSize);
+        float gain = 20.0f * std::log10(rms / (amplitude / std::sqrt(2.0f)));
+        
+        std::cout << "  Max step during ramp: " << std::fixed << std::setprecision(4) << transitionStep << std::endl;
+        std::cout << "  Max step after ramp:  " << steadyStep << std::endl;
+        std::cout << "  Settled gain at 1kHz: " << std::setprecision(1) << gain << " dB (expected ~12dB)" << std::endl;
+        
+        bool passed = transitionStep <= steadyStep * 1.1f && std::abs(gain - 12.0f) < 1.5f;
+        
+        std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+        return passed;
+    }
+    
+    void TestSurroundThroughput() {
+        std::cout << "\n[BENCH] 8-band EQ per channel-sample..." << std::endl;
+        
+        const ChannelConfiguration configs[] = {kMono, kStereo, kSurround51, kSurround71, kDolbyAtmos};
+        const size_t blockSize = 256;
+        const size_t blocks = 800;
+        
+        for (ChannelConfiguration config : configs) {
+            ProfessionalEQ eq;
+            eq.Initialize(48000.0f);
+            eq.SetBypassed(false);
+            for (size_t band = 0; band < 8; ++band) {
+                eq.SetBand(band, 60.0f * std::pow(2.0f, 1.2f * band), band % 2 ? 4.0f : -3.0f, 1.0f);
+            }
+            
+            AdvancedAudioBuffer buffer(config, blockSize, 48000.0f);
+            for (size_t c = 0; c < buffer.GetChannelCount(); ++c) {
+                float* data = buffer.GetChannelData(c);
+                for (size_t i = 0; i < blockSize; ++i) data[i] = 0.1f * std::sin(0.05f * i * (c + 1));
+            }
+            
+            auto start = std::chrono::steady_clock::now();
+            for (size_t block = 0; block < blocks; ++block) eq.Process(buffer);
+            double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            
+            std::cout << "  " << std::setw(2) << buffer.GetChannelCount() << " channels: "
+                      << std::fixed << std::setprecision(2)
+                      << nanos / (blocks * blockSize * buffer.GetChannelCount()) << " ns" << std::endl;
+        }
+    }
+    
     void PerformFFT(std::vector<std::complex<float>>& data) {
         const size_t N = data.size();
         if (N <= 1) return;
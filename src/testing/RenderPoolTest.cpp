@@ -0,0 +1,376 @@
+/*
+ * RenderPoolTest.cpp - Parallel track rendering worker pool
+ *
+ * Checks that every task of a run executes exactly once however the work
+ * is stolen, that small runs and a stopped pool fall back to the calling
+ * thread, that rendering tracks into private buffers and summing them in
+ * track order gives a bit-identical mix to serial rendering, and that the
+ * pool survives repeated start/stop. Then times 16 to 128 synthetic
+ * tracks (resampled cache playback plus a filter chain) at 256-frame
+ * buffers, serial against parallel, as a share of the real-time budget.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include "../audio/RenderWorkerPool.h"
+#include "../audio/PolyphaseResampler.h"
+
+using namespace VeniceDAW;
+using namespace VeniceDAW::DSP;
+
+static const size_t kBufferFrames = 256;
+static const double kOutputRate = 48000.0;
+
+// ---------------------------------------------------------------------------
+// Exactly-once execution
+
+struct CountingJob {
+    std::vector<std::atomic<int>>* counts;
+    std::vector<int>* spins;
+};
+
+static void CountTask(void* cookie, size_t task)
+{
+    CountingJob* job = static_cast<CountingJob*>(cookie);
+    // Uneven work so lanes finish at different times and get stolen from
+    volatile int sink = 0;
+    for (int i = 0; i < (*job->spins)[task]; ++i) sink = sink + i;
+    (*job->counts)[task].fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool TestEveryTaskOnce()
+{
+    std::cout << "\n[TEST] Every task runs exactly once" << std::endl;
+
+    RenderWorkerPool pool(3);
+    pool.SetParallelThreshold(1);
+    pool.Start();
+
+    const size_t kMaxTasks = 200;
+    std::vector<std::atomic<int>> counts(kMaxTasks);
+    std::vector<int> spins(kMaxTasks);
+    std::mt19937 rng(11);
+    CountingJob job = { &counts, &spins };
+
+    bool passed = true;
+    const int runs = 5000;
+    for (int run = 0; run < runs && passed; ++run) {
+        size_t taskCount = 1 + rng() % kMaxTasks;
+        for (size_t t = 0; t < taskCount; ++t) {
+            counts[t].store(0, std::memory_order_relaxed);
+            spins[t] = (rng() % 8 == 0) ? 2000 : static_cast<int>(rng() % 50);
+        }
+        pool.Run(taskCount, CountTask, &job);
+        for (size_t t = 0; t < taskCount; ++t) {
+            if (counts[t].load(std::memory_order_relaxed) != 1) {
+                std::cout << "  run " << run << " task " << t << " ran "
+                          << counts[t].load() << " times" << std::endl;
+                passed = false;
+                break;
+            }
+        }
+    }
+    pool.Stop();
+
+    std::cout << "  " << runs << " runs, " << pool.GetWorkerCount() << " workers: "
+              << pool.GetParallelRuns() << " parallel, " << pool.GetStolenTasks()
+              << " tasks stolen" << std::endl;
+    if (pool.GetParallelRuns() != static_cast<uint64_t>(runs)) passed = false;
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Single-thread fallback
+
+struct ThreadJob {
+    std::thread::id caller;
+    std::atomic<int> foreign;
+};
+
+static void RecordThreadTask(void* cookie, size_t)
+{
+    ThreadJob* job = static_cast<ThreadJob*>(cookie);
+    if (std::this_thread::get_id() != job->caller) {
+        job->foreign.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static bool TestSerialFallback()
+{
+    std::cout << "\n[TEST] Serial fallback below threshold and when stopped" << std::endl;
+
+    RenderWorkerPool pool(2);
+    pool.SetParallelThreshold(16);
+
+    ThreadJob job;
+    job.caller = std::this_thread::get_id();
+    job.foreign.store(0);
+
+    // Not started: everything on the caller
+    pool.Run(64, RecordThreadTask, &job);
+    bool stoppedSerial = job.foreign.load() == 0 && pool.GetSerialRuns() == 1;
+
+    pool.Start();
+    pool.Run(15, RecordThreadTask, &job);
+    bool smallSerial = job.foreign.load() == 0 && pool.GetSerialRuns() == 2;
+
+    pool.Run(0, RecordThreadTask, &job);
+    pool.Run(16, RecordThreadTask, &job);
+    bool largeParallel = pool.GetParallelRuns() == 1;
+    pool.Stop();
+
+    std::cout << "  stopped pool serial: " << (stoppedSerial ? "yes" : "no")
+              << ", 15 tasks serial: " << (smallSerial ? "yes" : "no")
+              << ", 16 tasks parallel: " << (largeParallel ? "yes" : "no") << std::endl;
+
+    bool passed = stoppedSerial && smallSerial && largeParallel;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic tracks: resampled int16 cache playback and a short filter chain
+
+struct SyntheticTrack {
+    SyntheticTrack(const std::vector<int16_t>& source, double sourceRate, float trackGain,
+                   PolyphaseResampler::Quality quality)
+        : cache(source), resampler(2, quality), position(0.0), gain(trackGain)
+    {
+        resampler.SetRates(sourceRate, kOutputRate);
+        std::memset(state, 0, sizeof(state));
+        std::memset(output, 0, sizeof(output));
+    }
+
+    const std::vector<int16_t>& cache;
+    PolyphaseResampler resampler;
+    double position;
+    float gain;
+    float state[8][2];
+    float output[kBufferFrames * 2];
+};
+
+struct MixJob {
+    std::vector<std::unique_ptr<SyntheticTrack>>* tracks;
+    size_t frames;
+};
+
+static void RenderSyntheticTrack(void* cookie, size_t index)
+{
+    MixJob* job = static_cast<MixJob*>(cookie);
+    SyntheticTrack& track = *(*job->tracks)[index];
+    size_t sourceFrames = track.cache.size() / 2;
+
+    size_t valid = track.resampler.Render(track.cache.data(), sourceFrames, track.position,
+                                          track.output, job->frames);
+    track.position += job->frames * track.resampler.GetRatio();
+    if (valid < job->frames) track.position = 0.0;
+
+    for (size_t i = 0; i < job->frames; ++i) {
+        for (size_t c = 0; c < 2; ++c) {
+            float x = track.output[i * 2 + c];
+            for (size_t s = 0; s < 8; ++s) {
+                track.state[s][c] += (0.35f + 0.05f * s) * (x - track.state[s][c]);
+                x = track.state[s][c] + 0.1f * (x - track.state[s][c]);
+            }
+            track.output[i * 2 + c] = x * track.gain;
+        }
+    }
+}
+
+static std::vector<std::unique_ptr<SyntheticTrack>> MakeTracks(const std::vector<int16_t>& source,
+                                                               size_t count,
+                                                               PolyphaseResampler::Quality quality)
+{
+    static const double kRates[] = {22050.0, 44100.0, 48000.0, 96000.0};
+    std::vector<std::unique_ptr<SyntheticTrack>> tracks;
+    for (size_t i = 0; i < count; ++i) {
+        tracks.emplace_back(new SyntheticTrack(source, kRates[i % 4], 0.5f + 0.01f * i, quality));
+        tracks.back()->position = 997.0 * i;
+    }
+    return tracks;
+}
+
+// Deterministic summation, in track order
+static void SumTracks(const std::vector<std::unique_ptr<SyntheticTrack>>& tracks, float* mix, size_t frames)
+{
+    std::memset(mix, 0, frames * 2 * sizeof(float));
+    for (const auto& track : tracks) {
+        for (size_t i = 0; i < frames * 2; ++i) mix[i] += track->output[i];
+    }
+}
+
+static std::vector<int16_t> MakeSource(size_t frames)
+{
+    std::vector<int16_t> source(frames * 2);
+    std::mt19937 rng(3);
+    for (size_t i = 0; i < frames; ++i) {
+        double tone = 8000.0 * std::sin(0.013 * i) + 4000.0 * std::sin(0.31 * i);
+        source[i * 2] = static_cast<int16_t>(tone + static_cast<int>(rng() % 2000) - 1000);
+        source[i * 2 + 1] = static_cast<int16_t>(-tone + static_cast<int>(rng() % 2000) - 1000);
+    }
+    return source;
+}
+
+static bool TestDeterministicMix()
+{
+    std::cout << "\n[TEST] Parallel mix is bit-identical to serial" << std::endl;
+
+    std::vector<int16_t> source = MakeSource(100000);
+    auto parallelTracks = MakeTracks(source, 64, PolyphaseResampler::QUALITY_BALANCED);
+    auto serialTracks = MakeTracks(source, 64, PolyphaseResampler::QUALITY_BALANCED);
+
+    RenderWorkerPool pool(3);
+    pool.SetParallelThreshold(1);
+    pool.Start();
+
+    std::vector<float> parallelMix(kBufferFrames * 2);
+    std::vector<float> serialMix(kBufferFrames * 2);
+    MixJob parallelJob = { &parallelTracks, kBufferFrames };
+    MixJob serialJob = { &serialTracks, kBufferFrames };
+
+    bool passed = true;
+    int callbacks = 200;
+    for (int cb = 0; cb < callbacks; ++cb) {
+        pool.Run(parallelTracks.size(), RenderSyntheticTrack, &parallelJob);
+        SumTracks(parallelTracks, parallelMix.data(), kBufferFrames);
+
+        for (size_t t = 0; t < serialTracks.size(); ++t) RenderSyntheticTrack(&serialJob, t);
+        SumTracks(serialTracks, serialMix.data(), kBufferFrames);
+
+        if (std::memcmp(parallelMix.data(), serialMix.data(), parallelMix.size() * sizeof(float)) != 0) {
+            std::cout << "  callback " << cb << ": mixes differ" << std::endl;
+            passed = false;
+            break;
+        }
+    }
+    pool.Stop();
+
+    std::cout << "  64 tracks x " << callbacks << " callbacks, " << pool.GetStolenTasks()
+              << " tracks stolen" << std::endl;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Start/stop cycles
+
+static bool TestStartStopCycles()
+{
+    std::cout << "\n[TEST] Repeated start/stop with parked workers" << std::endl;
+
+    const size_t kTasks = 48;
+    std::vector<std::atomic<int>> counts(kTasks);
+    std::vector<int> spins(kTasks, 100);
+    CountingJob job = { &counts, &spins };
+
+    RenderWorkerPool pool(4);
+    pool.SetParallelThreshold(1);
+
+    bool passed = true;
+    for (int cycle = 0; cycle < 20 && passed; ++cycle) {
+        if (!pool.Start()) {
+            passed = false;
+            break;
+        }
+        for (size_t t = 0; t < kTasks; ++t) counts[t].store(0);
+        for (int run = 0; run < 10; ++run) {
+            pool.Run(kTasks, CountTask, &job);
+            // Let the workers give up spinning and park now and then
+            if (run % 3 == 0) std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+        for (size_t t = 0; t < kTasks; ++t) {
+            if (counts[t].load() != 10) passed = false;
+        }
+        pool.Stop();
+    }
+
+    std::cout << "  20 cycles, " << pool.GetParallelRuns() << " parallel runs" << std::endl;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Throughput
+
+static void BenchmarkTrackCounts(bool quick)
+{
+    RenderWorkerPool pool;
+    pool.SetParallelThreshold(1);
+    pool.Start();
+
+    const double budgetUs = kBufferFrames * 1e6 / kOutputRate;
+    std::cout << "\n[BENCH] " << kBufferFrames << "-frame buffers at " << kOutputRate / 1000.0
+              << " kHz (budget " << std::fixed << std::setprecision(0) << budgetUs << " us), "
+              << pool.GetWorkerCount() << " workers + callback thread" << std::endl;
+    std::cout << std::defaultfloat;
+
+    std::vector<int16_t> source = MakeSource(200000);
+    const int callbacks = quick ? 100 : 1000;
+    const size_t trackCounts[] = {16, 32, 64, 128};
+
+    std::cout << "  " << std::setw(7) << "tracks" << std::setw(13) << "serial us"
+              << std::setw(13) << "parallel us" << std::setw(10) << "speedup"
+              << std::setw(12) << "budget %" << std::endl;
+
+    for (size_t count : trackCounts) {
+        auto tracks = MakeTracks(source, count, PolyphaseResampler::QUALITY_HIGHEST);
+        std::vector<float> mix(kBufferFrames * 2);
+        MixJob job = { &tracks, kBufferFrames };
+
+        double timings[2];
+        for (int parallel = 0; parallel < 2; ++parallel) {
+            auto start = std::chrono::steady_clock::now();
+            for (int cb = 0; cb < callbacks; ++cb) {
+                if (parallel) {
+                    pool.Run(tracks.size(), RenderSyntheticTrack, &job);
+                } else {
+                    for (size_t t = 0; t < tracks.size(); ++t) RenderSyntheticTrack(&job, t);
+                }
+                SumTracks(tracks, mix.data(), kBufferFrames);
+            }
+            auto end = std::chrono::steady_clock::now();
+            timings[parallel] = std::chrono::duration<double, std::micro>(end - start).count() / callbacks;
+        }
+
+        std::cout << "  " << std::setw(7) << count << std::fixed << std::setprecision(1)
+                  << std::setw(13) << timings[0] << std::setw(13) << timings[1]
+                  << std::setw(9) << timings[0] / timings[1] << "x"
+                  << std::setw(11) << 100.0 * timings[1] / budgetUs << "%"
+                  << std::defaultfloat << std::endl;
+    }
+    pool.Stop();
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Render Worker Pool Tests        ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestEveryTaskOnce()) passed++;
+    total++; if (TestSerialFallback()) passed++;
+    total++; if (TestDeterministicMix()) passed++;
+    total++; if (TestStartStopCycles()) passed++;
+
+    BenchmarkTrackCounts(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
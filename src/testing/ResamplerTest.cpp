@@ -0,0 +1,413 @@
+/*
+ * ResamplerTest.cpp - Polyphase windowed-sinc resampler
+ *
+ * Converts pure tones between common rates (including the 22.05 kHz of
+ * BeOS 3dmix RAW material against a 48 kHz output) and checks passband
+ * gain, the signal-to-distortion ratio of the result and the rejection of
+ * aliases when downsampling. Checks that streaming in arbitrary block
+ * sizes matches random-access rendering, that time-varying ratios stay
+ * continuous, then times every quality against the linear interpolation
+ * the players used before.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include "../audio/PolyphaseResampler.h"
+
+using namespace VeniceDAW::DSP;
+
+static const double kPi = 3.14159265358979323846;
+static const char* kQualityNames[] = {"realtime", "balanced", "highest"};
+
+static std::vector<float> MakeStereoTones(size_t frames, double rate, double leftHz, double rightHz)
+{
+    std::vector<float> signal(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        signal[i * 2] = static_cast<float>(0.5 * std::sin(2.0 * kPi * leftHz * i / rate));
+        signal[i * 2 + 1] = static_cast<float>(0.5 * std::sin(2.0 * kPi * rightHz * i / rate));
+    }
+    return signal;
+}
+
+// Least-squares fit of a sinusoid at a known frequency to one channel of
+// an interleaved signal. Returns the fitted amplitude; residual is the
+// RMS of everything else (images, aliases, noise).
+static double FitTone(const std::vector<float>& signal, size_t channels, size_t channel,
+                      size_t first, size_t count, double frequency, double rate, double* residual)
+{
+    double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0;
+    for (size_t i = first; i < first + count; ++i) {
+        double w = 2.0 * kPi * frequency * i / rate;
+        double s = std::sin(w), c = std::cos(w), y = signal[i * channels + channel];
+        ss += s * s; sc += s * c; cc += c * c; ys += y * s; yc += y * c;
+    }
+    double det = ss * cc - sc * sc;
+    double a = (ys * cc - yc * sc) / det;
+    double b = (yc * ss - ys * sc) / det;
+
+    double error = 0.0;
+    for (size_t i = first; i < first + count; ++i) {
+        double w = 2.0 * kPi * frequency * i / rate;
+        double e = signal[i * channels + channel] - (a * std::sin(w) + b * std::cos(w));
+        error += e * e;
+    }
+    *residual = std::sqrt(error / count);
+    return std::sqrt(a * a + b * b);
+}
+
+static std::vector<float> ConvertStreaming(PolyphaseResampler& resampler, const std::vector<float>& input,
+                                           size_t outputFrames, std::mt19937* blockSizes)
+{
+    size_t channels = resampler.GetChannelCount();
+    std::vector<float> output(outputFrames * channels, 0.0f);
+    size_t inputFrames = input.size() / channels;
+    size_t read = 0;
+    size_t written = 0;
+
+    while (written < outputFrames) {
+        size_t want = outputFrames - written;
+        if (blockSizes) {
+            want = std::min<size_t>(want, 1 + (*blockSizes)() % 700);
+        }
+        size_t needed = std::min(resampler.GetInputFramesNeeded(want), resampler.GetInputCapacity());
+        needed = std::min(needed, inputFrames - read);
+        size_t taken = needed;
+        size_t produced = resampler.Process(input.data() + read * channels, taken,
+                                            output.data() + written * channels, want);
+        read += taken;
+        written += produced;
+        if (produced == 0 && taken == 0) break;
+    }
+    return output;
+}
+
+static bool TestToneFidelity()
+{
+    std::cout << "\n[TEST] Tone fidelity across rate pairs..." << std::endl;
+
+    struct Case {
+        double inputRate;
+        double outputRate;
+        double frequency;
+        // Minimum signal-to-distortion ratio per quality
+        double minSDR[3];
+    };
+    const Case cases[] = {
+        { 22050.0, 48000.0,   100.0, { 60.0, 75.0, 95.0 } },
+        { 22050.0, 48000.0,  1000.0, { 60.0, 75.0, 95.0 } },
+        { 22050.0, 48000.0,  5000.0, { 60.0, 75.0, 95.0 } },
+        { 22050.0, 48000.0,  8000.0, { 40.0, 60.0, 90.0 } },
+        { 44100.0, 48000.0,  1000.0, { 60.0, 75.0, 95.0 } },
+        { 44100.0, 48000.0, 15000.0, { 40.0, 60.0, 90.0 } },
+        { 48000.0, 44100.0,  1000.0, { 60.0, 75.0, 95.0 } },
+        { 96000.0, 48000.0, 10000.0, { 40.0, 60.0, 90.0 } },
+    };
+    // Passband gain tolerance in dB, up to each quality's passband edge
+    const double kMaxGainError[] = {0.6, 0.25, 0.1};
+
+    bool passed = true;
+    std::cout << "  " << std::setw(14) << "rates" << std::setw(9) << "tone"
+              << std::setw(10) << "quality" << std::setw(11) << "gain dB"
+              << std::setw(10) << "SDR dB" << std::endl;
+
+    for (const Case& c : cases) {
+        for (int q = 0; q < 3; ++q) {
+            PolyphaseResampler resampler(2, static_cast<PolyphaseResampler::Quality>(q));
+            resampler.SetRates(c.inputRate, c.outputRate);
+
+            size_t inputFrames = static_cast<size_t>(c.inputRate);
+            std::vector<float> input = MakeStereoTones(inputFrames, c.inputRate, c.frequency, c.frequency);
+            size_t outputFrames = static_cast<size_t>(c.outputRate * 0.9);
+            std::vector<float> output = ConvertStreaming(resampler, input, outputFrames, nullptr);
+
+            // Skip the start-up transient
+            size_t first = 2000;
+            size_t count = outputFrames - first - 1000;
+            double residual = 0.0;
+            double amplitude = FitTone(output, 2, 0, first, count, c.frequency, c.outputRate, &residual);
+            double gainError = 20.0 * std::log10(amplitude / 0.5);
+            double sdr = 20.0 * std::log10(amplitude / std::sqrt(2.0) / std::max(residual, 1e-12));
+
+            double nyquist = 0.5 * std::min(c.inputRate, c.outputRate);
+            bool inPassband = c.frequency < 0.6 * nyquist;
+            bool ok = sdr >= c.minSDR[q] && (!inPassband || std::abs(gainError) <= kMaxGainError[q]);
+            passed = passed && ok;
+
+            std::cout << "  " << std::setw(6) << std::fixed << std::setprecision(0) << c.inputRate
+                      << "->" << std::setw(6) << c.outputRate
+                      << std::setw(9) << c.frequency
+                      << std::setw(10) << kQualityNames[q]
+                      << std::setprecision(3) << std::setw(11) << gainError
+                      << std::setprecision(1) << std::setw(10) << sdr
+                      << (ok ? "" : "  <-- out of bounds") << std::endl;
+        }
+    }
+
+    std::cout << std::defaultfloat;
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestAliasRejection()
+{
+    std::cout << "\n[TEST] Alias rejection when downsampling 96 kHz -> 44.1 kHz..." << std::endl;
+
+    // A 30 kHz tone has no place at 44.1 kHz and would fold to 14.1 kHz
+    const double kMinRejection[] = {40.0, 60.0, 85.0};
+    bool passed = true;
+
+    for (int q = 0; q < 3; ++q) {
+        PolyphaseResampler resampler(2, static_cast<PolyphaseResampler::Quality>(q));
+        resampler.SetRates(96000.0, 44100.0);
+
+        std::vector<float> input = MakeStereoTones(96000, 96000.0, 30000.0, 30000.0);
+        std::vector<float> output = ConvertStreaming(resampler, input, 40000, nullptr);
+
+        double energy = 0.0;
+        for (size_t i = 2000; i < 39000; ++i) {
+            energy += static_cast<double>(output[i * 2]) * output[i * 2];
+        }
+        double rms = std::sqrt(energy / 37000.0);
+        double rejection = 20.0 * std::log10(0.5 / std::sqrt(2.0) / std::max(rms, 1e-12));
+        bool ok = rejection >= kMinRejection[q];
+        passed = passed && ok;
+
+        std::cout << "  " << std::setw(10) << kQualityNames[q] << ": "
+                  << std::fixed << std::setprecision(1) << rejection << " dB"
+                  << (ok ? "" : "  <-- below bound") << std::endl;
+    }
+    std::cout << std::defaultfloat;
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestStreamingMatchesRender()
+{
+    std::cout << "\n[TEST] Streaming in random blocks vs random-access render..." << std::endl;
+
+    bool passed = true;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> noise(30000 * 2);
+    for (float& v : noise) v = dist(rng);
+    std::vector<int16_t> noise16(noise.size());
+    for (size_t i = 0; i < noise.size(); ++i) noise16[i] = static_cast<int16_t>(noise[i] * 32767.0f);
+
+    const double ratePairs[][2] = {{22050.0, 48000.0}, {44100.0, 48000.0}, {96000.0, 44100.0}};
+    for (const auto& rates : ratePairs) {
+        PolyphaseResampler streaming(2);
+        PolyphaseResampler random(2);
+        streaming.SetRates(rates[0], rates[1]);
+        random.SetRates(rates[0], rates[1]);
+
+        size_t outputFrames = static_cast<size_t>(25000 * rates[1] / rates[0]);
+        std::vector<float> streamed = ConvertStreaming(streaming, noise, outputFrames, &rng);
+
+        // Render in uneven pieces, continuing from the running position
+        std::vector<float> rendered(outputFrames * 2);
+        size_t done = 0;
+        while (done < outputFrames) {
+            size_t count = std::min<size_t>(outputFrames - done, 1 + rng() % 900);
+            double position = done * (rates[0] / rates[1]);
+            random.Render(noise.data(), noise.size() / 2, position, rendered.data() + done * 2, count);
+            done += count;
+        }
+
+        double maxError = 0.0;
+        for (size_t i = 0; i < rendered.size(); ++i) {
+            maxError = std::max(maxError, static_cast<double>(std::abs(rendered[i] - streamed[i])));
+        }
+        if (maxError > 1e-5) {
+            std::cout << "  " << rates[0] << " -> " << rates[1] << ": max difference "
+                      << maxError << std::endl;
+            passed = false;
+        }
+    }
+
+    // int16 sources are scaled to [-1, 1)
+    PolyphaseResampler a(2), b(2);
+    a.SetRates(22050.0, 48000.0);
+    b.SetRates(22050.0, 48000.0);
+    std::vector<float> fromFloat(4000 * 2), fromInt(4000 * 2);
+    a.Render(noise.data(), noise.size() / 2, 100.25, fromFloat.data(), 4000);
+    b.Render(noise16.data(), noise16.size() / 2, 100.25, fromInt.data(), 4000);
+    double maxError = 0.0;
+    for (size_t i = 0; i < fromFloat.size(); ++i) {
+        maxError = std::max(maxError, static_cast<double>(std::abs(fromFloat[i] - fromInt[i])));
+    }
+    if (maxError > 1e-3) {
+        std::cout << "  int16 render differs from float render by " << maxError << std::endl;
+        passed = false;
+    }
+
+    // Render reports where the source ends and pads with silence after it
+    std::vector<float> tail(2000 * 2, 1.0f);
+    size_t inside = a.Render(noise.data(), 500, 0.0, tail.data(), 2000);
+    size_t expectedInside = static_cast<size_t>(std::ceil(500.0 / (22050.0 / 48000.0)));
+    if (inside != expectedInside || tail[1999 * 2] != 0.0f) {
+        std::cout << "  Render end handling: " << inside << " frames inside, expected "
+                  << expectedInside << std::endl;
+        passed = false;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestVaryingRatio()
+{
+    std::cout << "\n[TEST] Time-varying ratio (varispeed sweep)..." << std::endl;
+
+    const double kRate = 48000.0;
+    const double kTone = 440.0;
+    std::vector<float> input = MakeStereoTones(200000, kRate, kTone, kTone);
+
+    PolyphaseResampler resampler(2, PolyphaseResampler::QUALITY_BALANCED, 256);
+    resampler.SetRates(kRate, kRate);
+
+    const size_t kBlock = 64;
+    std::vector<float> output;
+    std::vector<float> block(kBlock * 2);
+    size_t read = 0;
+    double expectedConsumed = 0.0;
+
+    // Sweep 0.7x .. 1.4x and back, changing every block
+    for (size_t n = 0; n < 1500; ++n) {
+        double ratio = 1.05 + 0.35 * std::sin(2.0 * kPi * n / 1500.0);
+        resampler.SetRatio(ratio);
+        expectedConsumed += ratio * kBlock;
+
+        size_t written = 0;
+        while (written < kBlock) {
+            size_t needed = std::min(resampler.GetInputFramesNeeded(kBlock - written),
+                                     resampler.GetInputCapacity());
+            size_t taken = needed;
+            written += resampler.Process(input.data() + read * 2, taken,
+                                         block.data() + written * 2, kBlock - written);
+            read += taken;
+        }
+        output.insert(output.end(), block.begin(), block.end());
+    }
+
+    // The largest step between samples of a 0.5 amplitude tone played at
+    // most 1.4x faster, with a little room for filter ripple
+    double maxStep = 0.5 * 2.0 * kPi * kTone * 1.4 / kRate * 1.05;
+    double worstStep = 0.0;
+    for (size_t i = 4000; i < output.size() / 2; ++i) {
+        worstStep = std::max(worstStep, static_cast<double>(std::abs(output[i * 2] - output[(i - 1) * 2])));
+    }
+
+    // Input consumed must follow the integral of the ratio (to within the
+    // filter lookahead and one frame of slack)
+    double drift = std::abs(static_cast<double>(read) - expectedConsumed);
+
+    bool passed = worstStep <= maxStep && drift <= resampler.GetLatencyFrames() + 2.0;
+    std::cout << "  Max sample step: " << worstStep << " (limit " << maxStep << ")" << std::endl;
+    std::cout << "  Input consumed: " << read << " frames, integral of ratio "
+              << std::fixed << std::setprecision(1) << expectedConsumed << std::endl;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// The interpolation TrackChannel and the 3dmix viewer used before
+static void LinearResample(const int16_t* source, size_t sourceFrames, double position, double ratio,
+                           float* output, size_t outputFrames)
+{
+    float samplePosition = static_cast<float>(position);
+    for (size_t i = 0; i < outputFrames; ++i) {
+        size_t index = static_cast<size_t>(samplePosition);
+        if (index + 1 >= sourceFrames) break;
+        float frac = samplePosition - static_cast<float>(index);
+        for (size_t c = 0; c < 2; ++c) {
+            float a = source[index * 2 + c] * (1.0f / 32768.0f);
+            float b = source[index * 2 + 2 + c] * (1.0f / 32768.0f);
+            output[i * 2 + c] = a + frac * (b - a);
+        }
+        samplePosition += static_cast<float>(ratio);
+    }
+}
+
+static void BenchmarkThroughput(bool quick)
+{
+    std::cout << "\n[BENCH] Stereo int16 cache playback, 512-frame blocks ("
+              << PolyphaseResampler::GetKernelName() << " kernel)" << std::endl;
+
+    const size_t kBlock = 512;
+    const size_t blocks = quick ? 400 : 4000;
+    std::vector<int16_t> source(200000 * 2);
+    std::mt19937 rng(7);
+    for (int16_t& v : source) v = static_cast<int16_t>(rng() % 20000) - 10000;
+    std::vector<float> output(kBlock * 2);
+    volatile float sink = 0.0f;
+
+    const double ratePairs[][2] = {{22050.0, 48000.0}, {44100.0, 48000.0}, {48000.0, 44100.0}, {96000.0, 48000.0}};
+
+    std::cout << "  " << std::setw(10) << "method" << std::setw(8) << "MACs";
+    for (const auto& rates : ratePairs) {
+        std::cout << std::setw(7) << rates[0] / 1000.0 << "k->" << std::setw(2) << rates[1] / 1000.0 << "k";
+    }
+    std::cout << "   (ns/frame)" << std::endl;
+
+    for (int q = -1; q < 3; ++q) {
+        PolyphaseResampler resampler(2, q < 0 ? PolyphaseResampler::QUALITY_REALTIME
+                                              : static_cast<PolyphaseResampler::Quality>(q));
+        std::cout << "  " << std::setw(10) << (q < 0 ? "linear" : kQualityNames[q])
+                  << std::setw(8) << (q < 0 ? 2 : resampler.GetMultiplyAddsPerFrame());
+
+        for (const auto& rates : ratePairs) {
+            double ratio = rates[0] / rates[1];
+            resampler.SetRates(rates[0], rates[1]);
+            double position = 0.0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t b = 0; b < blocks; ++b) {
+                if (position + kBlock * ratio + 64 >= source.size() / 2) position = 0.0;
+                if (q < 0) {
+                    LinearResample(source.data(), source.size() / 2, position, ratio, output.data(), kBlock);
+                } else {
+                    resampler.Render(source.data(), source.size() / 2, position, output.data(), kBlock);
+                }
+                position += kBlock * ratio;
+                sink = sink + output[0];
+            }
+            auto end = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() /
+                        static_cast<double>(blocks * kBlock);
+            std::cout << std::fixed << std::setprecision(1) << std::setw(14) << ns;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Polyphase Resampler Tests       ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestToneFidelity()) passed++;
+    total++; if (TestAliasRejection()) passed++;
+    total++; if (TestStreamingMatchesRender()) passed++;
+    total++; if (TestVaryingRatio()) passed++;
+
+    BenchmarkThroughput(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/*
+ * ReverbBusTest.cpp - Shared send/return reverb bus
+ *
+ * Checks that one bus fed with the scaled sends of several tracks matches
+ * the sum of one reverb per track, that the bus keeps rendering the tail
+ * after the sends stop and then skips silent blocks, and that sends at an
+ * offset or past the block capacity stay in bounds. Then times a 32-track
+ * mix with a reverb per track against a single bus.
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include "../audio/ReverbBus.h"
+
+using namespace VeniceDAW;
+
+static const float kSampleRate = 48000.0f;
+
+static std::vector<float> MakeNoise(size_t frames, unsigned seed)
+{
+    std::vector<float> signal(frames * 2);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (float& s : signal) s = dist(rng);
+    return signal;
+}
+
+static bool TestBusMatchesPerTrackReverbs()
+{
+    std::cout << "\n[TEST] Bus return equals the sum of per-track reverbs" << std::endl;
+
+    const int kTracks = 8;
+    const int kBlock = 256;
+    const int kBlocks = 200;
+
+    std::vector<std::vector<float>> inputs;
+    std::vector<float> levels;
+    for (int t = 0; t < kTracks; ++t) {
+        inputs.push_back(MakeNoise(kBlock * kBlocks, 100 + t));
+        levels.push_back(0.1f + 0.1f * t);
+    }
+
+    ReverbBus bus;
+    bus.SetSampleRate(kSampleRate);
+
+    std::vector<std::unique_ptr<SpatialReverb>> reverbs;
+    for (int t = 0; t < kTracks; ++t) {
+        reverbs.emplace_back(new SpatialReverb());
+        reverbs.back()->SetSampleRate(kSampleRate);
+        reverbs.back()->SetRoomSize(0.7f);
+        reverbs.back()->SetDamping(0.5f);
+    }
+
+    std::vector<float> busOutput(kBlock * 2);
+    std::vector<float> refLeft(kBlock), refRight(kBlock);
+    std::vector<float> sendLeft(kBlock), sendRight(kBlock);
+    double maxError = 0.0;
+    double peak = 0.0;
+
+    for (int b = 0; b < kBlocks; ++b) {
+        std::fill(busOutput.begin(), busOutput.end(), 0.0f);
+        std::fill(refLeft.begin(), refLeft.end(), 0.0f);
+        std::fill(refRight.begin(), refRight.end(), 0.0f);
+
+        bus.BeginBlock(kBlock);
+        for (int t = 0; t < kTracks; ++t) {
+            const float* block = inputs[t].data() + b * kBlock * 2;
+            // Two half-block sends, like TrackChannel's resampling chunks
+            bus.AddSend(0, block, kBlock / 2, levels[t]);
+            bus.AddSend(kBlock / 2, block + kBlock, kBlock / 2, levels[t]);
+
+            for (int i = 0; i < kBlock; ++i) {
+                sendLeft[i] = block[i * 2] * levels[t];
+                sendRight[i] = block[i * 2 + 1] * levels[t];
+            }
+            reverbs[t]->ProcessWet(sendLeft.data(), sendRight.data(), refLeft.data(), refRight.data(), kBlock);
+        }
+        bus.ProcessAndMix(busOutput.data(), kBlock);
+
+        for (int i = 0; i < kBlock; ++i) {
+            maxError = std::max(maxError, (double)std::abs(busOutput[i * 2] - refLeft[i]));
+            maxError = std::max(maxError, (double)std::abs(busOutput[i * 2 + 1] - refRight[i]));
+            peak = std::max(peak, (double)std::abs(refLeft[i]));
+        }
+    }
+
+    double relative = maxError / peak;
+    std::cout << "  " << kTracks << " tracks, " << kBlocks << " blocks: peak " << peak
+              << ", max error " << relative << " of peak (limit 1e-4)" << std::endl;
+
+    bool passed = peak > 0.01 && relative < 1e-4;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestTailAndSilentSkip()
+{
+    std::cout << "\n[TEST] Tail rings out after the sends stop, then blocks are skipped" << std::endl;
+
+    const int kBlock = 256;
+    ReverbBus bus;
+    bus.SetSampleRate(kSampleRate);
+
+    std::vector<float> input = MakeNoise(kBlock, 7);
+    std::vector<float> output(kBlock * 2);
+
+    // One block of send, then silence
+    bus.BeginBlock(kBlock);
+    bus.AddSend(0, input.data(), kBlock, 1.0f);
+    float maxPeak = bus.ProcessAndMix(output.data(), kBlock);
+
+    int tailFrames = bus.GetReverb().GetTailFrames();
+    float lastPeak = 0.0f;
+    int renderedFrames = 0;
+    int blocks = 0;
+    for (; blocks < 2000 && bus.IsActive(); ++blocks) {
+        std::fill(output.begin(), output.end(), 0.0f);
+        bus.BeginBlock(kBlock);
+        lastPeak = bus.ProcessAndMix(output.data(), kBlock);
+        maxPeak = std::max(maxPeak, lastPeak);
+        renderedFrames += kBlock;
+    }
+
+    // Once inactive, blocks cost nothing and add nothing
+    std::fill(output.begin(), output.end(), 0.0f);
+    bus.BeginBlock(kBlock);
+    bool skipped = !bus.IsActive() && bus.ProcessAndMix(output.data(), kBlock) == 0.0f
+                   && output[0] == 0.0f;
+
+    double tailDb = 20.0 * std::log10(std::max(lastPeak, 1e-12f) / maxPeak);
+
+    std::cout << "  tail estimate " << tailFrames << " frames, rendered " << renderedFrames
+              << " frames, last block " << std::fixed << std::setprecision(1) << tailDb
+              << " dB below the peak" << std::defaultfloat << std::endl;
+
+    bool passed = skipped && renderedFrames >= tailFrames - kBlock && tailDb < -60.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestSendBounds()
+{
+    std::cout << "\n[TEST] Sends at offsets and past the block capacity" << std::endl;
+
+    ReverbBus bus;
+    bus.SetSampleRate(kSampleRate);
+    bus.SetMaxBlockFrames(512);
+
+    // A block longer than the capacity renders the first 512 frames only
+    std::vector<float> input = MakeNoise(1024, 9);
+    std::vector<float> output(1024 * 2 + 2, 0.0f);
+    const float kGuard = 12345.0f;
+    output[1024 * 2] = kGuard;
+    output[1024 * 2 + 1] = kGuard;
+
+    bus.BeginBlock(1024);
+    bus.AddSend(0, input.data(), 1024, 1.0f);
+    bus.AddSend(400, input.data(), 1024, 1.0f);
+    bus.AddSend(600, input.data(), 100, 1.0f);   // Entirely past the capacity
+    bus.ProcessAndMix(output.data(), 1024);
+
+    bool untouched = true;
+    for (int i = 512 * 2; i < 1024 * 2; ++i) {
+        if (output[i] != 0.0f) untouched = false;
+    }
+    bool guard = output[1024 * 2] == kGuard && output[1024 * 2 + 1] == kGuard;
+
+    // A zero or negative level adds nothing
+    ReverbBus quiet;
+    quiet.BeginBlock(256);
+    quiet.AddSend(0, input.data(), 256, 0.0f);
+    std::vector<float> silent(256 * 2, 0.0f);
+    float quietPeak = quiet.ProcessAndMix(silent.data(), 256);
+
+    std::cout << "  frames past capacity untouched: " << (untouched ? "yes" : "no")
+              << ", guard intact: " << (guard ? "yes" : "no")
+              << ", zero send silent: " << (quietPeak == 0.0f ? "yes" : "no") << std::endl;
+
+    bool passed = untouched && guard && quietPeak == 0.0f;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static void BenchmarkTrackReverbs(bool quick)
+{
+    const int kTracks = 32;
+    const int kBlock = 256;
+    const int blocks = quick ? 100 : 1000;
+
+    std::cout << "\n[BENCH] " << kTracks << "-track spatial mix, " << kBlock << "-frame blocks" << std::endl;
+
+    std::vector<std::vector<float>> inputs;
+    for (int t = 0; t < kTracks; ++t) inputs.push_back(MakeNoise(kBlock, 200 + t));
+
+    std::vector<std::unique_ptr<SpatialReverb>> reverbs;
+    for (int t = 0; t < kTracks; ++t) {
+        reverbs.emplace_back(new SpatialReverb());
+        reverbs.back()->SetSampleRate(kSampleRate);
+    }
+    ReverbBus bus;
+    bus.SetSampleRate(kSampleRate);
+
+    std::vector<float> left(kBlock), right(kBlock), outLeft(kBlock), outRight(kBlock);
+    std::vector<float> output(kBlock * 2);
+    volatile float sink = 0.0f;
+
+    // Before: the per-track path, one full reverb per track
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; ++b) {
+        for (int t = 0; t < kTracks; ++t) {
+            for (int i = 0; i < kBlock; ++i) {
+                left[i] = inputs[t][i * 2];
+                right[i] = inputs[t][i * 2 + 1];
+            }
+            std::fill(outLeft.begin(), outLeft.end(), 0.0f);
+            std::fill(outRight.begin(), outRight.end(), 0.0f);
+            reverbs[t]->ProcessStereo(left.data(), right.data(), outLeft.data(), outRight.data(), kBlock, 0.5f);
+            sink = sink + outLeft[0];
+        }
+    }
+    double perTrackUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / blocks;
+
+    // After: sends into one bus
+    start = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; ++b) {
+        bus.BeginBlock(kBlock);
+        for (int t = 0; t < kTracks; ++t) bus.AddSend(0, inputs[t].data(), kBlock, 0.5f);
+        bus.ProcessAndMix(output.data(), kBlock);
+        sink = sink + output[0];
+    }
+    double busUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / blocks;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << kTracks << " reverbs: " << std::setw(8) << perTrackUs << " us/block" << std::endl;
+    std::cout << "  1 bus:      " << std::setw(8) << busUs << " us/block  ("
+              << perTrackUs / busUs << "x)" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Reverb Bus Tests                ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestBusMatchesPerTrackReverbs()) passed++;
+    total++; if (TestTailAndSilentSkip()) passed++;
+    total++; if (TestSendBounds()) passed++;
+
+    BenchmarkTrackReverbs(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,481 @@
+/*
+ * SampleConversionTest.cpp - Sample format, layout and ring copy kernels
+ *
+ * SampleConversion converts int16/int24/int32/float samples of either byte
+ * order to and from float, interleaves and deinterleaves channels and
+ * copies into and out of ring buffers. These tests check every kernel
+ * against a plain per-sample reference over lengths and offsets that reach
+ * each vector width and every tail, check the integer round trips and byte
+ * layouts, and time the kernels against the per-sample loops they replace.
+ *
+ * Needs no Haiku headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "../audio/SampleConversion.h"
+
+using namespace VeniceDAW::DSP;
+
+static uint32_t sRandomState = 0x9e3779b9;
+
+static uint32_t Random()
+{
+    sRandomState ^= sRandomState << 13;
+    sRandomState ^= sRandomState >> 17;
+    sRandomState ^= sRandomState << 5;
+    return sRandomState;
+}
+
+// Floats around and beyond full scale, with exact full scale and halfway
+// cases mixed in
+static std::vector<float> TestSignal(size_t count)
+{
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        switch (i % 9) {
+            case 0:  samples[i] = 1.0f; break;
+            case 1:  samples[i] = -1.0f; break;
+            case 2:  samples[i] = (float)((int32_t)(Random() % 2001) - 1000) / 32768.0f + 0.5f / 32768.0f; break;
+            case 3:  samples[i] = ((Random() % 2) ? 1.0f : -1.0f) * (1.0f + (Random() % 1000) / 1000.0f); break;
+            default: samples[i] = ((int32_t)Random()) / 2147483648.0f; break;
+        }
+    }
+    return samples;
+}
+
+// Per-sample reference conversions, written from the definitions
+
+static int64_t ReferenceQuantize(float sample, int bits)
+{
+    double scale = std::ldexp(1.0, bits - 1);
+    double scaled = (double)sample * scale;
+    scaled = std::max(-scale, std::min(scale - 1.0, scaled));
+    return (int64_t)std::nearbyint(scaled);
+}
+
+static void ReferencePut(uint8_t* out, int64_t value, size_t bytes, bool bigEndian)
+{
+    for (size_t b = 0; b < bytes; b++) {
+        uint8_t byte = (uint8_t)((uint64_t)value >> (8 * b));
+        out[bigEndian ? bytes - 1 - b : b] = byte;
+    }
+}
+
+static int64_t ReferenceGet(const uint8_t* in, size_t bytes, bool bigEndian)
+{
+    uint64_t value = 0;
+    for (size_t b = 0; b < bytes; b++) {
+        value |= (uint64_t)in[bigEndian ? bytes - 1 - b : b] << (8 * b);
+    }
+    // Sign-extend
+    int shift = 64 - 8 * (int)bytes;
+    return (int64_t)(value << shift) >> shift;
+}
+
+static const SampleConversion::Encoding kIntegerEncodings[] = {
+    SampleConversion::kInt16, SampleConversion::kInt24, SampleConversion::kInt32
+};
+
+static const char* EncodingName(SampleConversion::Encoding encoding)
+{
+    switch (encoding) {
+        case SampleConversion::kInt16: return "int16";
+        case SampleConversion::kInt24: return "int24";
+        case SampleConversion::kInt32: return "int32";
+        default:                       return "float";
+    }
+}
+
+static bool TestMatchesReference()
+{
+    std::cout << "\n[TEST] Every encoding and byte order matches the per-sample reference" << std::endl;
+
+    const size_t kMaxCount = 67;   // Past two AVX2 int16 blocks, plus tails
+    std::vector<float> signal = TestSignal(kMaxCount + 8);
+    int failures = 0;
+    int checked = 0;
+
+    for (SampleConversion::Encoding encoding : kIntegerEncodings) {
+        size_t bytes = SampleConversion::BytesPerSample(encoding);
+        int bits = (int)bytes * 8;
+        for (int bigEndian = 0; bigEndian < 2; bigEndian++) {
+            for (size_t offset = 0; offset < 3; offset++) {
+                for (size_t count = 0; count <= kMaxCount; count++) {
+                    // Misaligned integer buffers with guard bytes after them
+                    std::vector<uint8_t> packed(offset + count * bytes + 16, 0xa5);
+                    const float* input = signal.data() + offset;
+                    SampleConversion::FromFloat(input, packed.data() + offset, encoding,
+                                                bigEndian != 0, count);
+
+                    bool ok = true;
+                    for (size_t i = 0; i < count && ok; i++) {
+                        int64_t expected = ReferenceQuantize(input[i], bits);
+                        ok = ReferenceGet(packed.data() + offset + i * bytes, bytes, bigEndian != 0) == expected;
+                    }
+                    for (size_t i = offset + count * bytes; i < packed.size(); i++) {
+                        ok = ok && packed[i] == 0xa5;
+                    }
+
+                    std::vector<float> decoded(count + 1, -7.0f);
+                    SampleConversion::ToFloat(packed.data() + offset, encoding, bigEndian != 0,
+                                              decoded.data(), count);
+                    for (size_t i = 0; i < count && ok; i++) {
+                        int64_t value = ReferenceGet(packed.data() + offset + i * bytes, bytes, bigEndian != 0);
+                        ok = decoded[i] == (float)((double)value / std::ldexp(1.0, bits - 1));
+                    }
+                    ok = ok && decoded[count] == -7.0f;
+
+                    checked++;
+                    if (!ok) {
+                        if (failures < 5) {
+                            std::cout << "  Mismatch: " << EncodingName(encoding)
+                                      << (bigEndian ? " BE" : " LE") << ", offset " << offset
+                                      << ", " << count << " samples" << std::endl;
+                        }
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Float in the other byte order is a byte swap
+    for (size_t count = 0; count <= kMaxCount; count++) {
+        std::vector<uint8_t> packed(count * 4);
+        bool bigEndian = !SampleConversion::HostIsBigEndian();
+        SampleConversion::FromFloat(signal.data(), packed.data(), SampleConversion::kFloat32,
+                                    bigEndian, count);
+        std::vector<float> decoded(count);
+        SampleConversion::ToFloat(packed.data(), SampleConversion::kFloat32, bigEndian,
+                                  decoded.data(), count);
+        bool ok = std::memcmp(decoded.data(), signal.data(), count * sizeof(float)) == 0;
+        for (size_t i = 0; i < count && ok; i++) {
+            uint8_t native[4];
+            std::memcpy(native, &signal[i], 4);
+            ok = packed[i * 4] == native[3] && packed[i * 4 + 3] == native[0];
+        }
+        checked++;
+        if (!ok) failures++;
+    }
+
+    std::cout << "  Kernels: " << SampleConversion::GetKernelName() << ", " << checked - failures
+              << "/" << checked << " conversions exact" << std::endl;
+
+    bool passed = failures == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRoundTrips()
+{
+    std::cout << "\n[TEST] Integers survive a round trip through float" << std::endl;
+
+    // Every int16 value, in both byte orders
+    std::vector<int16_t> all(65536);
+    for (size_t i = 0; i < all.size(); i++) {
+        all[i] = (int16_t)(i - 32768);
+    }
+    std::vector<float> floats(all.size());
+    bool int16Exact = true;
+    for (int bigEndian = 0; bigEndian < 2; bigEndian++) {
+        std::vector<uint8_t> packed(all.size() * 2);
+        std::vector<uint8_t> back(all.size() * 2);
+        for (size_t i = 0; i < all.size(); i++) {
+            ReferencePut(&packed[i * 2], all[i], 2, bigEndian != 0);
+        }
+        SampleConversion::ToFloat(packed.data(), SampleConversion::kInt16, bigEndian != 0,
+                                  floats.data(), all.size());
+        SampleConversion::FromFloat(floats.data(), back.data(), SampleConversion::kInt16,
+                                    bigEndian != 0, all.size());
+        int16Exact = int16Exact && packed == back && floats.front() == -1.0f;
+    }
+
+    // int24 extremes and a spread of values; int32 up to 24 significant bits
+    bool int24Exact = true;
+    bool int32Exact = true;
+    for (int bigEndian = 0; bigEndian < 2; bigEndian++) {
+        std::vector<int64_t> values24 = { -8388608, -8388607, -1, 0, 1, 8388606, 8388607 };
+        std::vector<int64_t> values32 = { INT32_MIN, -65536, -256, 0, 256, 65536, 2147483392 };
+        for (int i = 0; i < 1000; i++) {
+            values24.push_back((int32_t)Random() >> 8);
+            values32.push_back((int64_t)((int32_t)Random() >> 8) * 256);
+        }
+        for (int pass = 0; pass < 2; pass++) {
+            const std::vector<int64_t>& values = pass == 0 ? values24 : values32;
+            SampleConversion::Encoding encoding = pass == 0 ? SampleConversion::kInt24
+                                                            : SampleConversion::kInt32;
+            size_t bytes = SampleConversion::BytesPerSample(encoding);
+            std::vector<uint8_t> packed(values.size() * bytes);
+            std::vector<uint8_t> back(values.size() * bytes);
+            for (size_t i = 0; i < values.size(); i++) {
+                ReferencePut(&packed[i * bytes], values[i], bytes, bigEndian != 0);
+            }
+            std::vector<float> decoded(values.size());
+            SampleConversion::ToFloat(packed.data(), encoding, bigEndian != 0, decoded.data(),
+                                      values.size());
+            SampleConversion::FromFloat(decoded.data(), back.data(), encoding, bigEndian != 0,
+                                        values.size());
+            (pass == 0 ? int24Exact : int32Exact) = (pass == 0 ? int24Exact : int32Exact) && packed == back;
+        }
+    }
+
+    // Full scale saturates instead of wrapping
+    const float overs[] = { 1.0f, 3.5f, -1.0f, -3.5f };
+    uint8_t saturated[16];
+    SampleConversion::FromFloat(overs, saturated, SampleConversion::kInt32, false, 4);
+    bool saturates = ReferenceGet(saturated, 4, false) == INT32_MAX
+        && ReferenceGet(saturated + 4, 4, false) == INT32_MAX
+        && ReferenceGet(saturated + 8, 4, false) == INT32_MIN
+        && ReferenceGet(saturated + 12, 4, false) == INT32_MIN;
+
+    std::cout << "  int16 all values: " << (int16Exact ? "exact" : "changed")
+              << ", int24: " << (int24Exact ? "exact" : "changed")
+              << ", int32 (24 significant bits): " << (int32Exact ? "exact" : "changed")
+              << ", int32 full scale: " << (saturates ? "saturates" : "wraps") << std::endl;
+
+    bool passed = int16Exact && int24Exact && int32Exact && saturates;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestInterleave()
+{
+    std::cout << "\n[TEST] Interleave and deinterleave for any channel count" << std::endl;
+
+    const size_t channelCounts[] = { 1, 2, 3, 6, 16 };
+    int failures = 0;
+    for (size_t channels : channelCounts) {
+        for (size_t frames = 0; frames <= 37; frames++) {
+            std::vector<std::vector<float>> planar(channels, std::vector<float>(frames));
+            std::vector<const float*> inputs(channels);
+            for (size_t c = 0; c < channels; c++) {
+                for (size_t i = 0; i < frames; i++) {
+                    planar[c][i] = (float)(c * 1000 + i);
+                }
+                inputs[c] = planar[c].data();
+            }
+
+            std::vector<float> interleaved(frames * channels + 1, -1.0f);
+            SampleConversion::Interleave(inputs.data(), channels, interleaved.data(), frames);
+            bool ok = interleaved.back() == -1.0f;
+            for (size_t i = 0; i < frames && ok; i++) {
+                for (size_t c = 0; c < channels; c++) {
+                    ok = ok && interleaved[i * channels + c] == planar[c][i];
+                }
+            }
+
+            std::vector<std::vector<float>> back(channels, std::vector<float>(frames + 1, -1.0f));
+            std::vector<float*> outputs(channels);
+            for (size_t c = 0; c < channels; c++) {
+                outputs[c] = back[c].data();
+            }
+            SampleConversion::Deinterleave(interleaved.data(), channels, outputs.data(), frames);
+            for (size_t c = 0; c < channels && ok; c++) {
+                ok = std::equal(planar[c].begin(), planar[c].end(), back[c].begin())
+                    && back[c][frames] == -1.0f;
+            }
+            if (!ok) failures++;
+        }
+    }
+
+    // Mono spread over a stereo pair
+    std::vector<float> mono(19);
+    for (size_t i = 0; i < mono.size(); i++) mono[i] = (float)i;
+    const float* pair[2] = { mono.data(), mono.data() };
+    std::vector<float> stereo(mono.size() * 2);
+    SampleConversion::Interleave(pair, 2, stereo.data(), mono.size());
+    bool spread = true;
+    for (size_t i = 0; i < mono.size(); i++) {
+        spread = spread && stereo[i * 2] == mono[i] && stereo[i * 2 + 1] == mono[i];
+    }
+
+    std::cout << "  " << 5 * 38 - failures << "/" << 5 * 38 << " layouts round trip, mono spread "
+              << (spread ? "ok" : "broken") << std::endl;
+
+    bool passed = failures == 0 && spread;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRingCopies()
+{
+    std::cout << "\n[TEST] Ring copies wrap once and return the next position" << std::endl;
+
+    const size_t capacity = 50;
+    const size_t elementSize = 2 * sizeof(float);   // Stereo frames
+    std::vector<float> ring(capacity * 2, 0.0f);
+    int failures = 0;
+    float next = 0.0f;
+
+    size_t writePos = 0;
+    size_t readPos = 0;
+    for (int round = 0; round < 200; round++) {
+        size_t count = Random() % (capacity + 1);
+        std::vector<float> frames(count * 2);
+        for (float& sample : frames) sample = next++;
+
+        size_t expectedPos = (writePos + count) % capacity;
+        size_t newWrite = SampleConversion::WriteRing(ring.data(), capacity, writePos,
+                                                      frames.data(), count, elementSize);
+        std::vector<float> read(count * 2 + 1, -1.0f);
+        size_t newRead = SampleConversion::ReadRing(ring.data(), capacity, readPos,
+                                                    read.data(), count, elementSize);
+        bool ok = newWrite == expectedPos && newRead == expectedPos && read.back() == -1.0f
+            && std::equal(frames.begin(), frames.end(), read.begin());
+        for (size_t i = 0; i < count && ok; i++) {
+            size_t slot = (writePos + i) % capacity;
+            ok = ring[slot * 2] == frames[i * 2] && ring[slot * 2 + 1] == frames[i * 2 + 1];
+        }
+        if (!ok) failures++;
+        writePos = newWrite;
+        readPos = newRead;
+    }
+
+    std::cout << "  " << 200 - failures << "/200 random-length copies correct" << std::endl;
+
+    bool passed = failures == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+template <typename Function>
+static double TimeNs(Function function, int repeats, size_t samples)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        function();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ((double)repeats * samples);
+}
+
+static bool TestThroughput(bool quick)
+{
+    std::cout << "\n[TEST] Kernel throughput against per-sample loops" << std::endl;
+
+    const size_t count = 4096;   // A large callback's worth of stereo samples
+    const int repeats = quick ? 2000 : 10000;
+    std::vector<float> signal = TestSignal(count);
+    std::vector<float> floats(count);
+    std::vector<uint8_t> packed(count * 4);
+    std::vector<float> left(count / 2);
+    std::vector<float> right(count / 2);
+    volatile float sink = 0.0f;
+
+    struct Row {
+        const char* name;
+        double loopNs;
+        double kernelNs;
+        bool mustBeFaster;
+    };
+    std::vector<Row> rows;
+
+    // Only the int16 kernels are vector code in every x86 build (24-bit
+    // needs SSSE3, and a compiler may vectorize the plain deinterleave), so
+    // only they must beat the loops, and only when they are vector code
+    const char* kernel = SampleConversion::GetKernelName();
+    bool vectorized = std::strcmp(kernel, "AVX2") == 0 || std::strcmp(kernel, "SSE2") == 0;
+
+    // float -> int16 LE, clamped and rounded one sample at a time
+    rows.push_back({ "float -> int16",
+        TimeNs([&]() {
+            int16_t* out = reinterpret_cast<int16_t*>(packed.data());
+            for (size_t i = 0; i < count; i++) {
+                float scaled = signal[i] * 32768.0f;
+                if (scaled > 32767.0f) scaled = 32767.0f;
+                if (scaled < -32768.0f) scaled = -32768.0f;
+                out[i] = (int16_t)lrintf(scaled);
+            }
+            sink = sink + packed[7];
+        }, repeats, count),
+        TimeNs([&]() {
+            SampleConversion::FromFloat(signal.data(), packed.data(), SampleConversion::kInt16, false, count);
+            sink = sink + packed[7];
+        }, repeats, count), vectorized });
+
+    // Big-endian int16 -> float, swapping one sample at a time
+    rows.push_back({ "int16 BE -> float",
+        TimeNs([&]() {
+            for (size_t i = 0; i < count; i++) {
+                uint16_t raw = (uint16_t)((packed[i * 2] << 8) | packed[i * 2 + 1]);
+                floats[i] = (int16_t)raw / 32768.0f;
+            }
+            sink = sink + floats[5];
+        }, repeats, count),
+        TimeNs([&]() {
+            SampleConversion::ToFloat(packed.data(), SampleConversion::kInt16, true, floats.data(), count);
+            sink = sink + floats[5];
+        }, repeats, count), vectorized });
+
+    // Packed 24-bit LE -> float
+    SampleConversion::FromFloat(signal.data(), packed.data(), SampleConversion::kInt24, false, count);
+    rows.push_back({ "int24 -> float",
+        TimeNs([&]() {
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t* s = &packed[i * 3];
+                int32_t value = (int32_t)((s[2] << 24) | (s[1] << 16) | (s[0] << 8)) >> 8;
+                floats[i] = value / 8388608.0f;
+            }
+            sink = sink + floats[5];
+        }, repeats, count),
+        TimeNs([&]() {
+            SampleConversion::ToFloat(packed.data(), SampleConversion::kInt24, false, floats.data(), count);
+            sink = sink + floats[5];
+        }, repeats, count), false });
+
+    // Stereo deinterleave
+    float* planar[2] = { left.data(), right.data() };
+    rows.push_back({ "deinterleave",
+        TimeNs([&]() {
+            for (size_t i = 0; i < count / 2; i++) {
+                left[i] = signal[i * 2];
+                right[i] = signal[i * 2 + 1];
+            }
+            sink = sink + left[3];
+        }, repeats, count),
+        TimeNs([&]() {
+            SampleConversion::Deinterleave(signal.data(), 2, planar, count / 2);
+            sink = sink + left[3];
+        }, repeats, count), false });
+
+    bool passed = true;
+    for (const Row& row : rows) {
+        double speedup = row.loopNs / row.kernelNs;
+        std::cout << "  " << std::left << std::setw(18) << row.name << std::right << std::fixed
+                  << std::setprecision(2) << row.loopNs << " ns -> " << row.kernelNs
+                  << " ns per sample (" << std::setprecision(1) << speedup << "x)" << std::endl;
+        if (row.mustBeFaster) {
+            passed = passed && speedup > 1.0;
+        }
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    VeniceDAW Sample Conversion Tests       ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestMatchesReference()) passed++;
+    total++; if (TestRoundTrips()) passed++;
+    total++; if (TestInterleave()) passed++;
+    total++; if (TestRingCopies()) passed++;
+    total++; if (TestThroughput(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
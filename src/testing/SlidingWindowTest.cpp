@@ -0,0 +1,257 @@
+/*
+ * SlidingWindowTest.cpp - Sliding-window peak/RMS detectors
+ *
+ * Checks DSP::SlidingPeakDetector and DSP::SlidingRMSDetector against
+ * brute-force window scans, then benchmarks the peak detector against the
+ * buffer rescan DynamicsProcessor's lookahead limiter used before (one
+ * full pass over the lookahead buffer per sample).
+ *
+ * Only depends on the DSP library, so it builds on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include "../audio/DSPAlgorithms.h"
+
+using namespace VeniceDAW::DSP;
+
+static const float kSampleRate = 48000.0f;
+static const size_t kHostBlock = 256;
+
+// The previous lookahead peak analysis: write into a circular buffer and
+// rescan all of it for every sample
+class RescanPeakDetector {
+public:
+    explicit RescanPeakDetector(size_t windowLength)
+        : fBuffer(std::max<size_t>(1, windowLength), 0.0f), fWritePos(0) {}
+
+    float ProcessSample(float input) {
+        fBuffer[fWritePos] = input;
+        fWritePos = (fWritePos + 1) % fBuffer.size();
+
+        float peak = 0.0f;
+        for (size_t i = 0; i < fBuffer.size(); ++i) {
+            size_t pos = (fWritePos + i) % fBuffer.size();
+            peak = std::max(peak, std::abs(fBuffer[pos]));
+        }
+        return peak;
+    }
+
+    void ProcessBlock(const float* input, float* peaks, size_t numSamples) {
+        for (size_t i = 0; i < numSamples; ++i) {
+            peaks[i] = ProcessSample(input[i]);
+        }
+    }
+
+private:
+    std::vector<float> fBuffer;
+    size_t fWritePos;
+};
+
+static std::vector<float> MakeSignal(size_t length, int kind)
+{
+    std::vector<float> signal(length);
+    std::mt19937 rng(1234 + kind);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < length; ++i) {
+        switch (kind) {
+            case 0: // Noise
+                signal[i] = dist(rng);
+                break;
+            case 1: // Decaying ramp: every sample stays a max candidate (deque worst case)
+                signal[i] = 1.0f - static_cast<float>(i % 3000) / 3000.0f;
+                break;
+            case 2: // Rising ramp: the deque never holds more than one entry
+                signal[i] = static_cast<float>(i % 3000) / 3000.0f;
+                break;
+            default: // Program-like: tone with sparse transients and silence
+                signal[i] = 0.1f * std::sin(0.05f * i);
+                if (i % 997 == 0) signal[i] = (i % 2 ? -0.9f : 0.9f);
+                if ((i / 5000) % 3 == 2) signal[i] = 0.0f;
+                break;
+        }
+    }
+    return signal;
+}
+
+static bool TestPeakMatchesBruteForce()
+{
+    std::cout << "\n[TEST] Peak detector vs brute-force window max..." << std::endl;
+
+    const size_t windows[] = {1, 2, 3, 7, 64, 220, 441, 960};
+    const size_t blockSizes[] = {1, 17, 256};
+    const char* kindNames[] = {"noise", "decay ramp", "rise ramp", "program"};
+    bool passed = true;
+
+    for (int kind = 0; kind < 4; ++kind) {
+        std::vector<float> signal = MakeSignal(20000, kind);
+
+        for (size_t window : windows) {
+            for (size_t block : blockSizes) {
+                SlidingPeakDetector detector(window);
+                std::vector<float> peaks(signal.size());
+                for (size_t offset = 0; offset < signal.size(); offset += block) {
+                    size_t n = std::min(block, signal.size() - offset);
+                    detector.ProcessBlock(signal.data() + offset, peaks.data() + offset, n);
+                }
+
+                size_t mismatches = 0;
+                for (size_t i = 0; i < signal.size(); ++i) {
+                    size_t first = (i + 1 >= window) ? i + 1 - window : 0;
+                    float expected = 0.0f;
+                    for (size_t j = first; j <= i; ++j) {
+                        expected = std::max(expected, std::abs(signal[j]));
+                    }
+                    if (peaks[i] != expected) ++mismatches;
+                }
+
+                if (mismatches > 0) {
+                    std::cout << "  " << kindNames[kind] << ", window " << window
+                              << ", block " << block << ": " << mismatches
+                              << " mismatches" << std::endl;
+                    passed = false;
+                }
+            }
+        }
+    }
+
+    // Reset must behave like a freshly constructed detector
+    std::vector<float> signal = MakeSignal(4000, 0);
+    SlidingPeakDetector reused(100);
+    SlidingPeakDetector fresh(100);
+    std::vector<float> a(signal.size()), b(signal.size());
+    reused.ProcessBlock(signal.data(), a.data(), signal.size());
+    reused.Reset();
+    reused.ProcessBlock(signal.data(), a.data(), signal.size());
+    fresh.ProcessBlock(signal.data(), b.data(), signal.size());
+    if (a != b) {
+        std::cout << "  Reset() does not restore initial state" << std::endl;
+        passed = false;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestRMSMatchesBruteForce()
+{
+    std::cout << "\n[TEST] RMS detector vs brute-force window RMS..." << std::endl;
+
+    const size_t windows[] = {1, 5, 64, 480, 2400};
+    bool passed = true;
+
+    for (int kind = 0; kind < 4; ++kind) {
+        std::vector<float> signal = MakeSignal(30000, kind);
+
+        for (size_t window : windows) {
+            SlidingRMSDetector detector(window);
+            std::vector<float> rms(signal.size());
+            detector.ProcessBlock(signal.data(), rms.data(), signal.size());
+
+            double maxError = 0.0;
+            for (size_t i = 0; i < signal.size(); i += 7) {
+                size_t first = (i + 1 >= window) ? i + 1 - window : 0;
+                double sum = 0.0;
+                for (size_t j = first; j <= i; ++j) {
+                    sum += static_cast<double>(signal[j]) * signal[j];
+                }
+                double expected = std::sqrt(sum / window);
+                maxError = std::max(maxError, std::abs(rms[i] - expected));
+            }
+
+            // Absolute error on a full-scale signal; the periodic exact
+            // resum keeps it at float rounding level
+            if (maxError > 1e-5) {
+                std::cout << "  signal " << kind << ", window " << window
+                          << ": max error " << maxError << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+template <typename Detector>
+static double MeasureNanosPerSample(Detector& detector, const std::vector<float>& input,
+                                    size_t totalSamples)
+{
+    std::vector<float> peaks(kHostBlock);
+    volatile float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0;
+    while (done < totalSamples) {
+        size_t offset = done % (input.size() - kHostBlock);
+        detector.ProcessBlock(input.data() + offset, peaks.data(), kHostBlock);
+        sink = sink + peaks[0];
+        done += kHostBlock;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double nanos = std::chrono::duration<double, std::nano>(end - start).count();
+    return nanos / static_cast<double>(done);
+}
+
+static void BenchmarkLookaheadPeak(bool quick)
+{
+    std::cout << "\n[BENCH] Lookahead peak: buffer rescan vs sliding window ("
+              << kSampleRate << " Hz, " << kHostBlock << "-frame blocks)" << std::endl;
+
+    std::vector<float> input = MakeSignal(static_cast<size_t>(kSampleRate), 3);
+    const float lookaheadMs[] = {1.0f, 2.0f, 5.0f, 10.0f, 20.0f};
+
+    std::cout << std::setw(10) << "lookahead"
+              << std::setw(10) << "window"
+              << std::setw(14) << "rescan ns/s"
+              << std::setw(14) << "sliding ns/s"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (float ms : lookaheadMs) {
+        size_t window = static_cast<size_t>(ms * kSampleRate / 1000.0f);
+        size_t samples = quick ? 24000 : 96000;
+
+        // The rescan is O(window) per sample; keep its run time bounded
+        size_t rescanSamples = std::max<size_t>(kHostBlock * 4, samples * 48 / window);
+
+        RescanPeakDetector rescan(window);
+        SlidingPeakDetector sliding(window);
+        double rescanNs = MeasureNanosPerSample(rescan, input, rescanSamples);
+        double slidingNs = MeasureNanosPerSample(sliding, input, samples * 10);
+
+        std::cout << std::setw(8) << std::fixed << std::setprecision(0) << ms << "ms"
+                  << std::setw(10) << window
+                  << std::setprecision(1)
+                  << std::setw(14) << rescanNs
+                  << std::setw(14) << slidingNs
+                  << std::setw(9) << rescanNs / slidingNs << "x" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Sliding Window Detector Tests   ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestPeakMatchesBruteForce()) passed++;
+    total++; if (TestRMSMatchesBruteForce()) passed++;
+
+    BenchmarkLookaheadPeak(quick);
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,437 @@
+/*
+ * StreamingServiceTest.cpp - Shared stream reader pool
+ *
+ * Feeds simulated streams from the StreamingService: checks that the most
+ * urgent stream is read first, that reads are coalesced into long ones,
+ * that Unregister() waits for a read in flight and that a stream at end of
+ * file does not keep a reader spinning. Then plays 64 streams from a slow
+ * simulated disk (serialized, seek cost per read) through the old
+ * thread-per-stream scheme and through the service, and compares underruns.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include "../audio/StreamingService.h"
+
+using namespace VeniceDAW;
+
+static const double kSampleRate = 44100.0;
+
+// Serialized disk: a seek per read plus transfer time, 4 bytes per frame
+struct SimulatedDisk {
+    std::mutex lock;
+    std::chrono::microseconds seekTime;
+    double bytesPerMicrosecond;
+
+    SimulatedDisk() : seekTime(3000), bytesPerMicrosecond(100.0) {}
+
+    void Read(int64 frames)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::this_thread::sleep_for(seekTime
+            + std::chrono::microseconds((int64)(frames * 4 / bytesPerMicrosecond)));
+    }
+};
+
+// A stream without audio: only the fill level of its ring is tracked
+class FakeStream : public StreamClient {
+public:
+    FakeStream(int64 capacity, int64 buffered, SimulatedDisk* disk = nullptr)
+        : fCapacity(capacity), fBuffered(buffered), fRemaining(-1), fUnderruns(0),
+          fDisk(disk), fReadDelay(0), fInRead(false), fReads(0) {}
+
+    double BufferedSeconds() const override { return fBuffered.load() / kSampleRate; }
+    int64 FreeFrames() const override { return fCapacity - fBuffered.load(); }
+    int32 FillPercent() const override { return (int32)(fBuffered.load() * 100 / fCapacity); }
+    uint32 Underruns() const override { return fUnderruns.load(); }
+
+    int64 ServiceRead(int64 maxFrames) override
+    {
+        fInRead = true;
+        if (fReadDelay.count() > 0) {
+            std::this_thread::sleep_for(fReadDelay);
+        }
+
+        int64 frames = std::min(maxFrames, FreeFrames());
+        if (fRemaining >= 0) {
+            frames = std::min(frames, fRemaining.load());
+            fRemaining -= frames;
+        }
+        if (frames > 0 && fDisk) {
+            fDisk->Read(frames);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(fSizeLock);
+            fReadSizes.push_back(frames);
+        }
+        fBuffered += frames;
+        fReads++;
+        fInRead = false;
+        return frames;
+    }
+
+    // Playback side: returns false on underrun
+    bool Consume(int64 frames)
+    {
+        if (fBuffered.load() < frames) {
+            fUnderruns++;
+            return false;
+        }
+        fBuffered -= frames;
+        return true;
+    }
+
+    std::vector<int64> ReadSizes()
+    {
+        std::lock_guard<std::mutex> guard(fSizeLock);
+        return fReadSizes;
+    }
+
+    int64 fCapacity;
+    std::atomic<int64> fBuffered;
+    std::atomic<int64> fRemaining;      // Frames left in the file, -1 = endless
+    std::atomic<uint32> fUnderruns;
+    SimulatedDisk* fDisk;
+    std::chrono::microseconds fReadDelay;
+    std::atomic<bool> fInRead;
+    std::atomic<uint32> fReads;
+
+    std::mutex fSizeLock;
+    std::vector<int64> fReadSizes;
+};
+
+static bool WaitFor(const std::function<bool()>& condition, int timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Records the order in which the service reads streams
+class OrderedStream : public FakeStream {
+public:
+    OrderedStream(int64 buffered, int index, std::mutex* lock, std::vector<int>* order)
+        : FakeStream(buffered + StreamingService::kCoalesceFrames, buffered),
+          fIndex(index), fLock(lock), fOrder(order) {}
+
+    int64 ServiceRead(int64 maxFrames) override
+    {
+        {
+            std::lock_guard<std::mutex> guard(*fLock);
+            fOrder->push_back(fIndex);
+        }
+        return FakeStream::ServiceRead(maxFrames);
+    }
+
+    int fIndex;
+    std::mutex* fLock;
+    std::vector<int>* fOrder;
+};
+
+static bool TestDeadlineOrder()
+{
+    std::cout << "\n[TEST] Most urgent stream is read first" << std::endl;
+
+    // One reader, streams registered before it starts so all compete at
+    // once; each read fills its stream, so every stream is read once
+    StreamingService service(1);
+    const double levels[] = { 0.5, 0.1, 0.9, 0.3 };
+    const int expected[] = { 1, 3, 0, 2 };
+
+    std::mutex orderLock;
+    std::vector<int> readOrder;
+    std::vector<std::unique_ptr<OrderedStream>> streams;
+    for (int i = 0; i < 4; i++) {
+        streams.emplace_back(new OrderedStream((int64)(levels[i] * kSampleRate), i,
+                                               &orderLock, &readOrder));
+        service.Register(streams.back().get());
+    }
+
+    service.Start();
+    WaitFor([&]() {
+        std::lock_guard<std::mutex> guard(orderLock);
+        return readOrder.size() >= 4;
+    }, 2000);
+    service.Stop();
+
+    std::cout << "  buffered:";
+    for (double level : levels) std::cout << " " << level << "s";
+    std::cout << std::endl << "  read order:";
+    for (int index : readOrder) std::cout << " " << index;
+    std::cout << " (expected 1 3 0 2)" << std::endl;
+
+    bool passed = readOrder.size() == 4
+                  && std::equal(readOrder.begin(), readOrder.end(), expected);
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestCoalescedReads()
+{
+    std::cout << "\n[TEST] Reads are coalesced and telemetry adds up" << std::endl;
+
+    StreamingService service(2);
+    service.Start();
+
+    // 5s buffered of a 10s ring, only a sliver free: not worth a read yet
+    int64 capacity = (int64)(10 * kSampleRate);
+    FakeStream stream(capacity, capacity - 3000);
+    service.Register(&stream);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uint32 earlyReads = stream.fReads.load();
+
+    // Drain to 100000 free frames: one long read plus the rest
+    stream.fBuffered = capacity - 100000;
+    service.Wake();
+    bool filled = WaitFor([&]() { return stream.FreeFrames() == 0; }, 2000);
+
+    StreamTelemetry telemetry;
+    bool hasTelemetry = service.GetTelemetry(&stream, &telemetry);
+    service.Unregister(&stream);
+    service.Stop();
+
+    std::vector<int64> sizes = stream.ReadSizes();
+    std::cout << "  reads with 3000 frames free: " << earlyReads << std::endl;
+    std::cout << "  read sizes:";
+    for (int64 size : sizes) std::cout << " " << size;
+    std::cout << std::endl;
+    std::cout << "  telemetry: " << telemetry.reads << " reads, " << telemetry.framesRead
+              << " frames, fill " << telemetry.fillPercent << "%" << std::endl;
+
+    bool passed = filled && hasTelemetry && earlyReads == 0 && sizes.size() == 2
+                  && sizes[0] == StreamingService::kMaxReadFrames
+                  && sizes[1] == 100000 - StreamingService::kMaxReadFrames
+                  && telemetry.reads == 2 && telemetry.framesRead == 100000
+                  && telemetry.fillPercent == 100;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestUnregisterWaitsForRead()
+{
+    std::cout << "\n[TEST] Unregister waits for the read in flight" << std::endl;
+
+    StreamingService service(1);
+    service.Start();
+
+    FakeStream stream(44100 * 4, 0);
+    stream.fReadDelay = std::chrono::microseconds(50000);
+    service.Register(&stream);
+
+    bool started = WaitFor([&]() { return stream.fInRead.load(); }, 2000);
+    service.Unregister(&stream);
+    bool idle = !stream.fInRead.load();
+    uint32 reads = stream.fReads.load();
+
+    // No more reads after Unregister()
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    bool quiet = stream.fReads.load() == reads && service.CountStreams() == 0;
+    service.Stop();
+
+    std::cout << "  read started: " << (started ? "yes" : "no")
+              << ", finished before Unregister() returned: " << (idle ? "yes" : "no")
+              << ", reads afterwards: " << (stream.fReads.load() - reads) << std::endl;
+
+    bool passed = started && idle && quiet;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestEndOfFileDoesNotSpin()
+{
+    std::cout << "\n[TEST] Stream at end of file leaves the readers idle" << std::endl;
+
+    StreamingService service(2);
+    service.Start();
+
+    FakeStream stream(44100 * 4, 0);
+    stream.fRemaining = 10000;
+    service.Register(&stream);
+
+    WaitFor([&]() { return stream.fRemaining.load() == 0; }, 2000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    uint32 reads = stream.fReads.load();
+
+    // A seek would Wake() the service: the stream is looked at again
+    stream.fRemaining = 5000;
+    service.Wake();
+    bool resumed = WaitFor([&]() { return stream.fRemaining.load() == 0; }, 2000);
+
+    service.Unregister(&stream);
+    service.Stop();
+
+    std::cout << "  reads in 300ms at end of file: " << reads
+              << ", resumed after Wake(): " << (resumed ? "yes" : "no") << std::endl;
+
+    // One read of the file, then at most one empty read per idle timeout
+    bool passed = reads <= 2 + 300 / 20 && resumed && stream.fBuffered.load() == 15000;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// Thread-per-stream scheme the service replaces: a thread per stream
+// reads 2048-frame chunks while there is room and sleeps up to 100ms
+class LegacyStreamThread {
+public:
+    explicit LegacyStreamThread(FakeStream* stream)
+        : fStream(stream), fRunning(true), fThread(&LegacyStreamThread::_Run, this) {}
+
+    ~LegacyStreamThread()
+    {
+        Stop();
+        fThread.join();
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(fLock);
+            fRunning = false;
+        }
+        fWakeup.notify_one();
+    }
+
+    void Wake() { fWakeup.notify_one(); }
+
+private:
+    void _Run()
+    {
+        std::unique_lock<std::mutex> lock(fLock);
+        while (fRunning) {
+            lock.unlock();
+            while (fRunning && fStream->FreeFrames() >= 2048) {
+                fStream->ServiceRead(2048);
+            }
+            lock.lock();
+            fWakeup.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+
+    FakeStream* fStream;
+    std::mutex fLock;
+    std::condition_variable fWakeup;
+    std::atomic<bool> fRunning;
+    std::thread fThread;
+};
+
+// Plays all streams in 10ms periods; the hook runs when a stream is low
+static uint32 Play(std::vector<std::unique_ptr<FakeStream>>& streams, double seconds,
+                   const std::function<void(int)>& onLow)
+{
+    const int64 period = (int64)(kSampleRate / 100);
+    auto next = std::chrono::steady_clock::now();
+    int periods = (int)(seconds * 100);
+
+    for (int p = 0; p < periods; p++) {
+        next += std::chrono::milliseconds(10);
+        std::this_thread::sleep_until(next);
+        for (size_t i = 0; i < streams.size(); i++) {
+            streams[i]->Consume(period);
+            if (streams[i]->fBuffered.load() < streams[i]->fCapacity / 4) {
+                onLow((int)i);
+            }
+        }
+    }
+
+    uint32 underruns = 0;
+    for (auto& stream : streams) {
+        underruns += stream->fUnderruns.load();
+    }
+    return underruns;
+}
+
+static bool TestSlowDiskSession(bool quick)
+{
+    const int kStreams = 64;
+    double seconds = quick ? 3.0 : 6.0;
+    std::cout << "\n[TEST] " << kStreams << " streams from a slow disk ("
+              << seconds << "s, 3ms per seek, 100MB/s)" << std::endl;
+
+    // 4s rings primed with 1s, like a freshly opened file
+    const int64 capacity = (int64)(4 * kSampleRate);
+    const int64 prefill = (int64)kSampleRate;
+
+    SimulatedDisk legacyDisk;
+    std::vector<std::unique_ptr<FakeStream>> legacyStreams;
+    std::vector<std::unique_ptr<LegacyStreamThread>> legacyThreads;
+    for (int i = 0; i < kStreams; i++) {
+        legacyStreams.emplace_back(new FakeStream(capacity, prefill, &legacyDisk));
+    }
+    for (int i = 0; i < kStreams; i++) {
+        legacyThreads.emplace_back(new LegacyStreamThread(legacyStreams[i].get()));
+    }
+    uint32 legacyUnderruns = Play(legacyStreams, seconds,
+                                  [&](int i) { legacyThreads[i]->Wake(); });
+    for (auto& thread : legacyThreads) thread->Stop();
+    legacyThreads.clear();
+
+    uint64 legacyReads = 0;
+    for (auto& stream : legacyStreams) legacyReads += stream->fReads.load();
+
+    SimulatedDisk serviceDisk;
+    StreamingService service;
+    std::vector<std::unique_ptr<FakeStream>> serviceStreams;
+    for (int i = 0; i < kStreams; i++) {
+        serviceStreams.emplace_back(new FakeStream(capacity, prefill, &serviceDisk));
+        service.Register(serviceStreams.back().get());
+    }
+    service.Start();
+    uint32 serviceUnderruns = Play(serviceStreams, seconds, [&](int) { service.Wake(); });
+
+    StreamingService::Stats stats = service.GetStats();
+    int32 minFill = 100;
+    for (auto& stream : serviceStreams) {
+        minFill = std::min(minFill, stream->FillPercent());
+        service.Unregister(stream.get());
+    }
+    service.Stop();
+
+    std::cout << "  thread per stream: " << std::setw(6) << legacyUnderruns << " underrun periods, "
+              << legacyReads << " reads, " << kStreams << " threads" << std::endl;
+    std::cout << "  shared service:    " << std::setw(6) << serviceUnderruns << " underrun periods, "
+              << stats.reads << " reads, " << stats.readers << " threads, lowest fill "
+              << minFill << "%" << std::endl;
+
+    bool passed = serviceUnderruns == 0 && legacyUnderruns >= serviceUnderruns;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Streaming Service Tests         ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestDeadlineOrder()) passed++;
+    total++; if (TestCoalescedReads()) passed++;
+    total++; if (TestUnregisterWaitsForRead()) passed++;
+    total++; if (TestEndOfFileDoesNotSpin()) passed++;
+    total++; if (TestSlowDiskSession(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
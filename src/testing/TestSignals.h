@@ -0,0 +1,73 @@
+/*
+ * TestSignals.h - Deterministic test signals and file writing helpers
+ * shared by the standalone tests
+ *
+ * Header-only; every test program gets its own random state, seeded the
+ * same way, so a test produces the same signals on every run.
+ */
+
+#ifndef TEST_SIGNALS_H
+#define TEST_SIGNALS_H
+
+#ifdef __HAIKU__
+#include <OS.h>
+#else
+#include "HaikuMockHeaders.h"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Xorshift, seeded with 12345
+inline uint32 Random()
+{
+    static uint32 sRandomState = 12345;
+    sRandomState ^= sRandomState << 13;
+    sRandomState ^= sRandomState >> 17;
+    sRandomState ^= sRandomState << 5;
+    return sRandomState;
+}
+
+inline int16_t Clamp(double value)
+{
+    return (int16_t)std::max(-32768.0, std::min(32767.0, std::round(value)));
+}
+
+// Interleaved stereo at 44.1 kHz: chords with a slow envelope, stereo
+// spread and a low noise floor, which compresses about like mastered music
+inline std::vector<int16_t> MusicLike(int64 frames)
+{
+    std::vector<int16_t> samples(frames * 2);
+    const double frequencies[] = { 110.0, 220.5, 329.6, 440.0, 659.3, 1318.5 };
+    for (int64 i = 0; i < frames; i++) {
+        double t = i / 44100.0;
+        double envelope = 0.55 + 0.45 * std::sin(2.0 * M_PI * 0.25 * t);
+        double left = 0.0;
+        double right = 0.0;
+        for (int32 k = 0; k < 6; k++) {
+            double tone = std::sin(2.0 * M_PI * frequencies[k] * t + k) / (k + 1);
+            left += tone * (k % 2 ? 0.6 : 1.0);
+            right += tone * (k % 2 ? 1.0 : 0.7);
+        }
+        double noise = (int32)(Random() % 129) - 64;
+        samples[i * 2] = Clamp(9000.0 * envelope * left + noise);
+        samples[i * 2 + 1] = Clamp(9000.0 * envelope * right + noise * 0.5);
+    }
+    return samples;
+}
+
+// Appends value little-endian, or big-endian for AIFF
+inline void Put16(std::vector<uint8>& out, uint16 value, bool bigEndian = false)
+{
+    out.push_back(bigEndian ? value >> 8 : value & 0xff);
+    out.push_back(bigEndian ? value & 0xff : value >> 8);
+}
+
+inline void Put32(std::vector<uint8>& out, uint32 value, bool bigEndian = false)
+{
+    Put16(out, bigEndian ? value >> 16 : value & 0xffff, bigEndian);
+    Put16(out, bigEndian ? value & 0xffff : value >> 16, bigEndian);
+}
+
+#endif // TEST_SIGNALS_H
@@ -0,0 +1,246 @@
+/*
+ * TimeStretchTest.cpp - FFT similarity search for WSOLA time stretching
+ *
+ * AudioSampleCache::TimeStretch() finds each segment's best match through
+ * an FFT cross-correlation and matches segments in parallel. These tests
+ * run the direct search it replaced side by side with it: the stretched
+ * audio must be the same for music, noise, silence and degenerate
+ * lengths at every ratio, and a full song must stretch quickly enough
+ * for tempo edits to be interactive.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "../audio/AudioSampleCache.h"
+#include "TestSignals.h"
+
+using namespace VeniceDAW;
+
+// The WSOLA loop as it was before the FFT search: a dot product for every
+// offset in the search window
+static std::vector<int16_t> DirectStretch(const std::vector<int16_t>& samples, float sampleRate,
+                                          float ratio)
+{
+    const int channels = 2;
+    const int templateSize = (int)(sampleRate * 0.02f);
+    const int searchWindow = (int)(sampleRate * 0.01f);
+
+    std::vector<float> input(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        input[i] = samples[i] * (1.0f / 32768.0f);
+    }
+
+    int inputFrames = (int)(samples.size() / channels);
+    int outputFrames = (int)(inputFrames / ratio);
+    std::vector<float> output;
+
+    int inputPos = 0;
+    float outputPos = 0.0f;
+    while (inputPos < inputFrames - templateSize && output.size() < (size_t)(outputFrames * channels)) {
+        int searchStart = std::max(0, inputPos - searchWindow);
+        int searchEnd = std::min(inputFrames - templateSize, inputPos + searchWindow);
+
+        float bestCorrelation = -1.0f;
+        int bestMatch = inputPos;
+        for (int testPos = searchStart; testPos <= searchEnd; testPos++) {
+            float correlation = 0.0f;
+            for (int i = 0; i < templateSize; i++) {
+                for (int ch = 0; ch < channels; ch++) {
+                    correlation += input[(inputPos + i) * channels + ch]
+                        * input[(testPos + i) * channels + ch];
+                }
+            }
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestMatch = testPos;
+            }
+        }
+
+        for (int i = 0; i < templateSize * channels; i++) {
+            output.push_back(input[bestMatch * channels + i]);
+        }
+        outputPos += templateSize * ratio;
+        inputPos = (int)outputPos;
+    }
+    output.resize(outputFrames * channels);
+
+    std::vector<int16_t> result(output.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        result[i] = (int16_t)std::max(-32768.0f, std::min(32767.0f, output[i] * 32767.0f));
+    }
+    return result;
+}
+
+static std::vector<int16_t> CacheStretch(const std::vector<int16_t>& samples, float sampleRate,
+                                         float ratio)
+{
+    AudioSampleCache cache;
+    cache.samples = samples;
+    cache.sampleRate = sampleRate;
+    cache.isValid = true;
+    if (!cache.TimeStretch(ratio)) {
+        return std::vector<int16_t>();
+    }
+    return cache.samples;
+}
+
+// Segments (20 ms templates) whose samples differ
+static int32 CountDifferentSegments(const std::vector<int16_t>& a, const std::vector<int16_t>& b,
+                                    int32 templateSize)
+{
+    int32 different = 0;
+    size_t segmentSamples = (size_t)templateSize * 2;
+    for (size_t start = 0; start < a.size(); start += segmentSamples) {
+        size_t end = std::min(start + segmentSamples, a.size());
+        if (!std::equal(a.begin() + start, a.begin() + end, b.begin() + start)) {
+            different++;
+        }
+    }
+    return different;
+}
+
+static bool TestMatchesDirectSearch(bool quick)
+{
+    std::cout << "\n[TEST] FFT search stretches music as the direct search did" << std::endl;
+
+    const int64 frames = 44100 * (quick ? 3 : 10);
+    std::vector<int16_t> music = MusicLike(frames);
+    const float ratios[] = { 0.25f, 0.5f, 0.8f, 1.25f, 2.0f, 4.0f };
+    const int32 templateSize = (int32)(44100.0f * 0.02f);
+
+    bool passed = true;
+    for (float ratio : ratios) {
+        std::vector<int16_t> direct = DirectStretch(music, 44100.0f, ratio);
+        std::vector<int16_t> stretched = CacheStretch(music, 44100.0f, ratio);
+
+        bool sameLength = stretched.size() == direct.size();
+        int32 segments = (int32)((direct.size() / 2 + templateSize - 1) / templateSize);
+        int32 different = sameLength ? CountDifferentSegments(direct, stretched, templateSize) : segments;
+
+        std::cout << "  Ratio " << std::fixed << std::setprecision(2) << ratio << ": "
+                  << stretched.size() / 2 << "/" << direct.size() / 2 << " frames, "
+                  << segments - different << "/" << segments << " segments identical" << std::endl;
+
+        // A near-tie decided differently by float rounding may pick a
+        // neighbouring offset, but never more than the odd segment
+        passed = passed && sameLength && different <= 1 + segments / 200;
+    }
+
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestDegenerateSignals()
+{
+    std::cout << "\n[TEST] Silence, noise and short files stretch as before" << std::endl;
+
+    struct Case {
+        const char* name;
+        std::vector<int16_t> samples;
+        float ratio;
+    };
+    std::vector<Case> cases;
+
+    std::vector<int16_t> noise(44100 * 2);
+    for (int16_t& sample : noise) {
+        sample = (int16_t)Random();
+    }
+    std::vector<int16_t> gaps = MusicLike(44100);
+    for (size_t i = 20000; i < 60000; i++) {
+        gaps[i] = 0;  // Silent stretch in the middle
+    }
+    std::vector<int16_t> leftOnly = MusicLike(22050);
+    for (size_t i = 1; i < leftOnly.size(); i += 2) {
+        leftOnly[i] = 0;
+    }
+
+    cases.push_back({ "silence", std::vector<int16_t>(44100 * 2, 0), 1.5f });
+    cases.push_back({ "noise", noise, 0.7f });
+    cases.push_back({ "gap", gaps, 1.3f });
+    cases.push_back({ "left only", leftOnly, 0.6f });
+    cases.push_back({ "shorter than a template", MusicLike(500), 0.5f });
+    cases.push_back({ "one template", MusicLike(882 + 1), 2.0f });
+    cases.push_back({ "two frames", MusicLike(2), 1.5f });
+
+    int32 failures = 0;
+    for (const Case& test : cases) {
+        std::vector<int16_t> direct = DirectStretch(test.samples, 44100.0f, test.ratio);
+        std::vector<int16_t> stretched = CacheStretch(test.samples, 44100.0f, test.ratio);
+        if (stretched != direct) {
+            std::cout << "  Mismatch: " << test.name << " (" << stretched.size() / 2 << " vs "
+                      << direct.size() / 2 << " frames)" << std::endl;
+            failures++;
+        }
+    }
+
+    std::cout << "  " << cases.size() - failures << "/" << cases.size()
+              << " signals stretched identically" << std::endl;
+
+    bool passed = failures == 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestStretchSpeed(bool quick)
+{
+    std::cout << "\n[TEST] Stretching speed" << std::endl;
+
+    // The direct search is timed on a short excerpt; the FFT search on a
+    // whole song
+    const int64 excerptFrames = 44100 * (quick ? 2 : 5);
+    const int64 songFrames = 44100 * (quick ? 60 : 300);
+    std::vector<int16_t> song = MusicLike(songFrames);
+    std::vector<int16_t> excerpt(song.begin(), song.begin() + excerptFrames * 2);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<int16_t> direct = DirectStretch(excerpt, 44100.0f, 1.25f);
+    auto directDone = std::chrono::high_resolution_clock::now();
+    std::vector<int16_t> fast = CacheStretch(excerpt, 44100.0f, 1.25f);
+    auto fastDone = std::chrono::high_resolution_clock::now();
+    std::vector<int16_t> stretchedSong = CacheStretch(song, 44100.0f, 1.25f);
+    auto songDone = std::chrono::high_resolution_clock::now();
+
+    double directSeconds = std::chrono::duration<double>(directDone - start).count();
+    double fastSeconds = std::chrono::duration<double>(fastDone - directDone).count();
+    double songSeconds = std::chrono::duration<double>(songDone - fastDone).count();
+    double speedup = directSeconds / std::max(fastSeconds, 1e-9);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  " << excerptFrames / 44100.0 << " s excerpt: direct " << directSeconds * 1000.0
+              << " ms, FFT " << fastSeconds * 1000.0 << " ms (" << speedup << "x, "
+              << std::max(1u, std::thread::hardware_concurrency()) << " threads)" << std::endl;
+    std::cout << "  " << songFrames / 44100.0 << " s song: " << songSeconds * 1000.0
+              << " ms" << std::endl;
+
+    // Even one core must be several times faster than the direct search
+    bool passed = !stretchedSong.empty() && speedup > 3.0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║      VeniceDAW Time Stretch Tests          ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestMatchesDirectSearch(quick)) passed++;
+    total++; if (TestDegenerateSignals()) passed++;
+    total++; if (TestStretchSpeed(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}
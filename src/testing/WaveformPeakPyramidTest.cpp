@@ -0,0 +1,361 @@
+/*
+ * WaveformPeakPyramidTest.cpp - Min/max/RMS peak pyramid for waveform drawing
+ *
+ * Checks queries against a brute-force scan of the samples, while the
+ * pyramid is still being appended to in uneven pieces and after it is
+ * finished, for lengths around the bucket sizes. Then checks that
+ * AudioSampleCache keeps its peaks right through edits, that wide
+ * waveform columns come out within a bucket of the exact answer, and that
+ * a view costs the same to draw however long the file is.
+ *
+ * Builds with the mock headers, so it runs on any platform.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "../audio/WaveformPeakPyramid.h"
+#include "../audio/AudioSampleCache.h"
+
+using namespace VeniceDAW;
+
+static const int64 kBase = WaveformPeakPyramid::kBaseFrames;
+
+static uint32 sRandomState = 987654321;
+
+static uint32 Random()
+{
+    sRandomState ^= sRandomState << 13;
+    sRandomState ^= sRandomState >> 17;
+    sRandomState ^= sRandomState << 5;
+    return sRandomState;
+}
+
+// Decaying bursts over noise, so every bucket has its own peaks
+static std::vector<int16_t> TestSignal(int64 frames)
+{
+    std::vector<int16_t> samples(frames * 2);
+    for (int64 i = 0; i < frames; i++) {
+        double envelope = std::exp(-(double)(i % 20000) / 5000.0);
+        double tone = std::sin(i * 0.031) * 20000.0 * envelope;
+        samples[i * 2] = (int16_t)(tone + (int32)(Random() % 2001) - 1000);
+        samples[i * 2 + 1] = (int16_t)(-tone * 0.5 + (int32)(Random() % 2001) - 1000);
+    }
+    return samples;
+}
+
+struct Exact {
+    float min;
+    float max;
+    float rms;
+};
+
+static Exact Scan(const std::vector<int16_t>& samples, int64 start, int64 end)
+{
+    Exact exact = { 1.0f, -1.0f, 0.0f };
+    double sumSquares = 0.0;
+    for (int64 i = start; i < end; i++) {
+        float value = (samples[i * 2] + samples[i * 2 + 1]) * 0.5f / 32768.0f;
+        exact.min = std::min(exact.min, value);
+        exact.max = std::max(exact.max, value);
+        sumSquares += (double)value * value;
+    }
+    exact.rms = end > start ? (float)std::sqrt(sumSquares / (end - start)) : 0.0f;
+    return exact;
+}
+
+// Bucket-aligned queries over the frames appended so far
+static bool CheckQueries(const WaveformPeakPyramid& pyramid, const std::vector<int16_t>& samples,
+                         int64 frames, int32 queries, float* maxRMSError)
+{
+    int64 buckets = (frames + kBase - 1) / kBase;
+    for (int32 q = 0; q < queries; q++) {
+        int64 b0 = Random() % buckets;
+        int64 b1 = b0 + 1 + Random() % (buckets - b0);
+        if (q == 0) {
+            b0 = 0;
+            b1 = buckets;
+        }
+        int64 start = b0 * kBase;
+        int64 end = std::min(b1 * kBase, frames);
+
+        float low, high, rms;
+        if (!pyramid.GetPeaks(start, end, &low, &high, &rms)) {
+            return false;
+        }
+        Exact exact = Scan(samples, start, end);
+        if (low != exact.min || high != exact.max) {
+            return false;
+        }
+        *maxRMSError = std::max(*maxRMSError, std::fabs(rms - exact.rms) / std::max(exact.rms, 1e-6f));
+    }
+    return true;
+}
+
+static bool TestMatchesScan()
+{
+    std::cout << "\n[TEST] Peaks match a full scan, while appending and when finished" << std::endl;
+
+    const int64 lengths[] = { 1, kBase - 1, kBase, kBase + 1, 3 * kBase, 1000, 65536, 100003 };
+    int32 failures = 0;
+    float maxRMSError = 0.0f;
+
+    for (int64 frames : lengths) {
+        std::vector<int16_t> samples = TestSignal(frames);
+        WaveformPeakPyramid pyramid;
+
+        // Query after every piece while the file is still loading
+        for (int64 frame = 0; frame < frames; ) {
+            int64 count = std::min<int64>(frames - frame, 1 + Random() % 7000);
+            pyramid.Append(samples.data() + frame * 2, count);
+            frame += count;
+            if (!CheckQueries(pyramid, samples, frame, 20, &maxRMSError)) {
+                std::cout << "  Mismatch while appending, " << frames << " frames" << std::endl;
+                failures++;
+                break;
+            }
+        }
+
+        pyramid.Finish();
+        if (pyramid.CountFrames() != frames || !pyramid.IsComplete()
+            || !CheckQueries(pyramid, samples, frames, 200, &maxRMSError)) {
+            std::cout << "  Mismatch when finished, " << frames << " frames" << std::endl;
+            failures++;
+        }
+    }
+
+    // Nothing appended, nothing answered
+    WaveformPeakPyramid empty;
+    float low, high;
+    bool emptyRejected = !empty.GetPeaks(0, 100, &low, &high);
+
+    std::cout << "  " << (int32)(sizeof(lengths) / sizeof(lengths[0])) - failures << "/"
+              << sizeof(lengths) / sizeof(lengths[0]) << " lengths exact, max RMS error "
+              << std::scientific << std::setprecision(1) << maxRMSError
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+
+    bool passed = failures == 0 && emptyRejected && maxRMSError < 1e-4f;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestEditsKeepPeaks()
+{
+    std::cout << "\n[TEST] Edits keep the peaks of an AudioSampleCache up to date" << std::endl;
+
+    const int64 frames = 200000;
+    AudioSampleCache cache;
+    cache.samples = TestSignal(frames);
+    cache.sampleRate = 44100.0f;
+    cache.isValid = true;
+    cache.BuildPeaks();
+
+    struct Edit {
+        const char* name;
+        bool (*apply)(AudioSampleCache&);
+    };
+    const Edit edits[] = {
+        { "fade in", [](AudioSampleCache& c) { return c.FadeIn(0.7f); } },
+        { "fade out", [](AudioSampleCache& c) { return c.FadeOut(1.3f, true); } },
+        { "normalize", [](AudioSampleCache& c) { return c.Normalize(0.5f); } },
+        { "reverse", [](AudioSampleCache& c) { return c.Reverse(); } },
+        { "resize", [](AudioSampleCache& c) { return c.Resize(3.0f); } },
+        { "compress", [](AudioSampleCache& c) { return c.Compress(); } }
+    };
+
+    int32 failures = 0;
+    for (const Edit& edit : edits) {
+        if (!edit.apply(cache)) {
+            std::cout << "  " << edit.name << " failed" << std::endl;
+            failures++;
+            continue;
+        }
+
+        std::vector<int16_t> current(cache.GetFrameCount() * 2);
+        cache.ReadFrames(0, current.data(), cache.GetFrameCount());
+        float rmsError = 0.0f;
+        if (cache.peaks.CountFrames() != cache.GetFrameCount()
+            || !CheckQueries(cache.peaks, current, cache.GetFrameCount(), 200, &rmsError)) {
+            std::cout << "  Stale peaks after " << edit.name << std::endl;
+            failures++;
+        }
+    }
+
+    // Caches that never built peaks do not pay for them on edits
+    AudioSampleCache plain;
+    plain.samples = TestSignal(1000);
+    plain.sampleRate = 44100.0f;
+    plain.isValid = true;
+    plain.Reverse();
+    bool untouched = plain.peaks.CountFrames() == 0;
+
+    std::cout << "  " << (int32)(sizeof(edits) / sizeof(edits[0])) - failures << "/"
+              << sizeof(edits) / sizeof(edits[0]) << " edits left exact peaks, unbuilt peaks untouched: "
+              << (untouched ? "yes" : "no") << std::endl;
+
+    bool passed = failures == 0 && untouched;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+static bool TestWaveformColumns()
+{
+    std::cout << "\n[TEST] Waveform columns from the pyramid stay within a bucket of exact" << std::endl;
+
+    const int64 frames = 44100 * 30;
+    AudioSampleCache cache;
+    cache.samples = TestSignal(frames);
+    cache.sampleRate = 44100.0f;
+    cache.isValid = true;
+
+    // Exact answers before peaks exist
+    const float widths[] = { 0.0005f, 0.004f, 0.03f, 0.5f };
+    std::vector<float> exact;
+    for (float width : widths) {
+        for (int32 column = 0; column < 50; column++) {
+            float low, high;
+            cache.GetSample(column * 0.57f, width, &low, &high);
+            exact.push_back(low);
+            exact.push_back(high);
+        }
+    }
+
+    cache.BuildPeaks();
+
+    int32 narrowExact = 0;
+    int32 wideClose = 0;
+    int32 wideColumns = 0;
+    size_t index = 0;
+    for (float width : widths) {
+        for (int32 column = 0; column < 50; column++) {
+            float time = column * 0.57f;
+            float low, high;
+            cache.GetSample(time, width, &low, &high);
+            float exactLow = exact[index++];
+            float exactHigh = exact[index++];
+
+            int64 start = (int64)(time * 44100.0f);
+            int64 end = std::min<int64>((int64)((time + width) * 44100.0f), frames);
+            if (end - start < AudioSampleCache::kPeakQueryFrames) {
+                narrowExact += (low == exactLow && high == exactHigh);
+                continue;
+            }
+
+            // Between the column shrunk and grown by a bucket at each end
+            wideColumns++;
+            Exact inner = Scan(cache.samples, start + kBase, end - kBase);
+            Exact outer = Scan(cache.samples, std::max<int64>(0, start - kBase),
+                               std::min(frames, end + kBase));
+            bool close = low >= std::min(0.0f, outer.min) && low <= std::min(0.0f, inner.min)
+                         && high <= std::max(0.0f, outer.max) && high >= std::max(0.0f, inner.max);
+            wideClose += close;
+        }
+    }
+
+    std::cout << "  Narrow columns exact: " << narrowExact << "/" << 200 - wideColumns
+              << ", wide columns within a bucket: " << wideClose << "/" << wideColumns << std::endl;
+
+    bool passed = narrowExact == 200 - wideColumns && wideClose == wideColumns && wideColumns > 0;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+// Draws pixels columns showing seconds of audio from offset on
+static double DrawSeconds(const AudioSampleCache& cache, float offset, float seconds,
+                          int32 pixels, int32 repeats)
+{
+    float secondsPerPixel = seconds / pixels;
+    float sink = 0.0f;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int32 r = 0; r < repeats; r++) {
+        for (int32 x = 0; x < pixels; x++) {
+            float low, high;
+            cache.GetSample(offset + x * secondsPerPixel, secondsPerPixel, &low, &high);
+            sink += high - low;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    if (sink < 0.0f) {
+        std::cout << "";
+    }
+    return std::chrono::duration<double>(end - start).count() / repeats;
+}
+
+static bool TestDrawCost(bool quick)
+{
+    std::cout << "\n[TEST] Drawing costs the same per zoom level for any file length" << std::endl;
+
+    const int32 kPixels = 1200;
+    const int64 shortFrames = 44100 * 60;
+    const int64 longFrames = 44100 * 60 * (quick ? 10 : 30);
+
+    AudioSampleCache shortCache;
+    shortCache.samples = TestSignal(shortFrames);
+    shortCache.sampleRate = 44100.0f;
+    shortCache.isValid = true;
+
+    AudioSampleCache longCache;
+    longCache.samples.resize(longFrames * 2);
+    for (int64 i = 0; i < longFrames * 2; i++) {
+        longCache.samples[i] = shortCache.samples[i % (shortFrames * 2)];
+    }
+    longCache.sampleRate = 44100.0f;
+    longCache.isValid = true;
+
+    float longSeconds = longCache.GetDuration();
+    double scan = DrawSeconds(longCache, 0.0f, longSeconds, kPixels, 1);
+
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    longCache.BuildPeaks();
+    double build = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - buildStart).count();
+    shortCache.BuildPeaks();
+
+    // The whole long file, and the same minute-wide view in both files
+    double fullDraw = DrawSeconds(longCache, 0.0f, longSeconds, kPixels, 20);
+    double shortDraw = DrawSeconds(shortCache, 0.0f, 60.0f, kPixels, 20);
+    double longDraw = DrawSeconds(longCache, longSeconds / 2.0f, 60.0f, kPixels, 20);
+    double overhead = (double)longCache.peaks.GetMemoryUsage()
+                      / (longCache.samples.size() * sizeof(int16_t));
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "  " << longFrames / 44100 / 60 << " min file, " << kPixels << " columns: scan "
+              << scan * 1000.0 << " ms, pyramid " << fullDraw * 1000.0 << " ms ("
+              << std::setprecision(0) << scan / fullDraw << "x)" << std::endl;
+    std::cout << std::setprecision(3)
+              << "  1 min view: " << shortDraw * 1000.0 << " ms in a 1 min file, "
+              << longDraw * 1000.0 << " ms in the long one" << std::endl;
+    std::cout << "  Build " << build * 1000.0 << " ms, " << longCache.peaks.CountLevels()
+              << " levels, " << std::setprecision(1) << overhead * 100.0 << "% of the samples"
+              << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+
+    bool passed = longDraw < shortDraw * 2.0 && scan / fullDraw > 50.0 && overhead < 0.12;
+    std::cout << "  Result: " << (passed ? "PASSED ✓" : "FAILED ✗") << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  VeniceDAW Waveform Peak Pyramid Tests     ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    int passed = 0;
+    int total = 0;
+
+    total++; if (TestMatchesScan()) passed++;
+    total++; if (TestEditsKeepPeaks()) passed++;
+    total++; if (TestWaveformColumns()) passed++;
+    total++; if (TestDrawCost(quick)) passed++;
+
+    std::cout << "\n" << passed << "/" << total << " tests passed" << std::endl;
+    return passed == total ? 0 : 1;
+}